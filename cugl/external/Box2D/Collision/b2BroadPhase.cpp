@@ -37,9 +37,18 @@ b2BroadPhase::~b2BroadPhase()
 	b2Free(m_pairBuffer);
 }
 
-int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
+// ALTERATION: Static proxies go in the static tree, with the id flagged.
+int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData, bool isStatic)
 {
-	int32 proxyId = m_tree.CreateProxy(aabb, userData);
+	int32 proxyId;
+	if (isStatic)
+	{
+		proxyId = m_staticTree.CreateProxy(aabb, userData) | e_staticProxy;
+	}
+	else
+	{
+		proxyId = m_tree.CreateProxy(aabb, userData);
+	}
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
@@ -49,12 +58,27 @@ void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
 	UnBufferMove(proxyId);
 	--m_proxyCount;
-	m_tree.DestroyProxy(proxyId);
+	if (proxyId & e_staticProxy)
+	{
+		m_staticTree.DestroyProxy(proxyId & ~e_staticProxy);
+	}
+	else
+	{
+		m_tree.DestroyProxy(proxyId);
+	}
 }
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
-	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	bool buffer;
+	if (proxyId & e_staticProxy)
+	{
+		buffer = m_staticTree.MoveProxy(proxyId & ~e_staticProxy, aabb, displacement);
+	}
+	else
+	{
+		buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	}
 	if (buffer)
 	{
 		BufferMove(proxyId);
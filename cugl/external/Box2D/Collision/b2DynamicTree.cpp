@@ -769,6 +769,196 @@ void b2DynamicTree::RebuildBottomUp()
 	Validate();
 }
 
+// ALTERATION: The number of bins per split of the SAH build.
+#define b2_sahBinCount 16
+
+// ALTERATION: A leaf of a bulk build, with a copy of its AABB.
+struct b2TreeBuildLeaf
+{
+	b2AABB aabb;
+	b2Vec2 center;
+	int32 id;
+};
+
+// ALTERATION: Rebuild the tree top down with a binned surface area heuristic.
+void b2DynamicTree::RebuildSAH()
+{
+	if (m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	b2TreeBuildLeaf* leaves = (b2TreeBuildLeaf*)b2Alloc(m_nodeCount * sizeof(b2TreeBuildLeaf));
+	int32 count = 0;
+
+	// Build array of leaves. Free the rest.
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height < 0)
+		{
+			// free node in pool
+			continue;
+		}
+
+		if (m_nodes[i].IsLeaf())
+		{
+			m_nodes[i].parent = b2_nullNode;
+			leaves[count].aabb = m_nodes[i].aabb;
+			leaves[count].center = m_nodes[i].aabb.GetCenter();
+			leaves[count].id = i;
+			++count;
+		}
+		else
+		{
+			FreeNode(i);
+		}
+	}
+
+	m_root = BuildSAH(leaves, count);
+	m_nodes[m_root].parent = b2_nullNode;
+	b2Free(leaves);
+
+	Validate();
+}
+
+// ALTERATION: Each split bins the leaf centers along their longest axis and
+// takes the bin boundary minimizing the SAH cost. Each level of the tree is a
+// linear pass over its leaves, so the whole build is O(n log n).
+int32 b2DynamicTree::BuildSAH(b2TreeBuildLeaf* leaves, int32 count)
+{
+	b2Assert(count > 0);
+	if (count == 1)
+	{
+		return leaves[0].id;
+	}
+
+	// Bound the leaf centers.
+	b2Vec2 lower = leaves[0].center;
+	b2Vec2 upper = lower;
+	for (int32 i = 1; i < count; ++i)
+	{
+		lower = b2Min(lower, leaves[i].center);
+		upper = b2Max(upper, leaves[i].center);
+	}
+
+	b2Vec2 extent = upper - lower;
+	int32 axis = extent.x >= extent.y ? 0 : 1;
+	float32 width = extent(axis);
+
+	// Coincident centers cannot be binned, so split them in half.
+	int32 split = count / 2;
+	if (width > 0.0f)
+	{
+		int32 binCounts[b2_sahBinCount];
+		b2AABB binAABBs[b2_sahBinCount];
+		for (int32 b = 0; b < b2_sahBinCount; ++b)
+		{
+			binCounts[b] = 0;
+		}
+
+		float32 binScale = b2_sahBinCount / width;
+		for (int32 i = 0; i < count; ++i)
+		{
+			int32 b = b2Min(int32((leaves[i].center(axis) - lower(axis)) * binScale), b2_sahBinCount - 1);
+			const b2AABB& aabb = leaves[i].aabb;
+			if (binCounts[b] == 0)
+			{
+				binAABBs[b] = aabb;
+			}
+			else
+			{
+				binAABBs[b].Combine(aabb);
+			}
+			++binCounts[b];
+		}
+
+		// Sweep from the right for the cost of the right side of each split.
+		float32 rightCosts[b2_sahBinCount];
+		b2AABB aabb;
+		int32 n = 0;
+		for (int32 b = b2_sahBinCount - 1; b > 0; --b)
+		{
+			if (binCounts[b] > 0)
+			{
+				if (n == 0)
+				{
+					aabb = binAABBs[b];
+				}
+				else
+				{
+					aabb.Combine(binAABBs[b]);
+				}
+				n += binCounts[b];
+			}
+			rightCosts[b] = n * (n > 0 ? aabb.GetPerimeter() : 0.0f);
+		}
+
+		// Sweep from the left for the cheapest split. The first and last bins
+		// are never empty, so some split has leaves on both sides.
+		float32 minCost = b2_maxFloat;
+		int32 minBin = 0;
+		n = 0;
+		for (int32 b = 0; b < b2_sahBinCount - 1; ++b)
+		{
+			if (binCounts[b] > 0)
+			{
+				if (n == 0)
+				{
+					aabb = binAABBs[b];
+				}
+				else
+				{
+					aabb.Combine(binAABBs[b]);
+				}
+				n += binCounts[b];
+			}
+
+			if (n == 0 || n == count)
+			{
+				continue;
+			}
+
+			float32 cost = n * aabb.GetPerimeter() + rightCosts[b + 1];
+			if (cost < minCost)
+			{
+				minCost = cost;
+				minBin = b;
+			}
+		}
+
+		// Move the leaves left of the split to the front.
+		split = 0;
+		for (int32 i = 0; i < count; ++i)
+		{
+			int32 b = b2Min(int32((leaves[i].center(axis) - lower(axis)) * binScale), b2_sahBinCount - 1);
+			if (b <= minBin)
+			{
+				b2Swap(leaves[i], leaves[split]);
+				++split;
+			}
+		}
+	}
+
+	b2Assert(0 < split && split < count);
+	int32 index1 = BuildSAH(leaves, split);
+	int32 index2 = BuildSAH(leaves + split, count - split);
+
+	int32 parentIndex = AllocateNode();
+	b2TreeNode* parent = m_nodes + parentIndex;
+	b2TreeNode* child1 = m_nodes + index1;
+	b2TreeNode* child2 = m_nodes + index2;
+	parent->child1 = index1;
+	parent->child2 = index2;
+	parent->height = 1 + b2Max(child1->height, child2->height);
+	parent->aabb.Combine(child1->aabb, child2->aabb);
+	parent->parent = b2_nullNode;
+
+	child1->parent = parentIndex;
+	child2->parent = parentIndex;
+
+	return parentIndex;
+}
+
 void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	// Build array of leaves. Free the rest.
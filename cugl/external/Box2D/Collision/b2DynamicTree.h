@@ -24,6 +24,9 @@
 
 #define b2_nullNode (-1)
 
+/// ALTERATION: A leaf of a bulk build, with a copy of its AABB.
+struct b2TreeBuildLeaf;
+
 /// A node in the dynamic tree. The client does not interact with this directly.
 struct b2TreeNode
 {
@@ -118,6 +121,11 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// ALTERATION: Rebuild the tree top down over its current leaves, using a
+	/// binned surface area heuristic (perimeter in 2D). This is O(n log n), so
+	/// it is cheap enough to bulk load a level. Proxy ids are preserved.
+	void RebuildSAH();
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -133,6 +141,9 @@ private:
 
 	int32 Balance(int32 index);
 
+	// ALTERATION: Build the subtree over the given leaves, returning its root.
+	int32 BuildSAH(b2TreeBuildLeaf* leaves, int32 count);
+
 	int32 ComputeHeight() const;
 	int32 ComputeHeight(int32 nodeId) const;
 
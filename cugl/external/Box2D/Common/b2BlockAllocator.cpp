@@ -72,6 +72,9 @@ b2BlockAllocator::b2BlockAllocator()
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
 
+	m_chunkAlloc = NULL;
+	m_chunkContext = NULL;
+
 	if (s_blockSizeLookupInitialized == false)
 	{
 		int32 j = 0;
@@ -99,9 +102,12 @@ b2BlockAllocator::b2BlockAllocator()
 
 b2BlockAllocator::~b2BlockAllocator()
 {
-	for (int32 i = 0; i < m_chunkCount; ++i)
+	if (m_chunkAlloc == NULL)
 	{
-		b2Free(m_chunks[i].blocks);
+		for (int32 i = 0; i < m_chunkCount; ++i)
+		{
+			b2Free(m_chunks[i].blocks);
+		}
 	}
 
 	b2Free(m_chunks);
@@ -141,7 +147,14 @@ void* b2BlockAllocator::Allocate(int32 size)
 		}
 
 		b2Chunk* chunk = m_chunks + m_chunkCount;
-		chunk->blocks = (b2Block*)b2Alloc(b2_chunkSize);
+		if (m_chunkAlloc != NULL)
+		{
+			chunk->blocks = (b2Block*)m_chunkAlloc(b2_chunkSize, m_chunkContext);
+		}
+		else
+		{
+			chunk->blocks = (b2Block*)b2Alloc(b2_chunkSize);
+		}
 #if defined(_DEBUG)
 		memset(chunk->blocks, 0xcd, b2_chunkSize);
 #endif
@@ -216,9 +229,12 @@ void b2BlockAllocator::Free(void* p, int32 size)
 
 void b2BlockAllocator::Clear()
 {
-	for (int32 i = 0; i < m_chunkCount; ++i)
+	if (m_chunkAlloc == NULL)
 	{
-		b2Free(m_chunks[i].blocks);
+		for (int32 i = 0; i < m_chunkCount; ++i)
+		{
+			b2Free(m_chunks[i].blocks);
+		}
 	}
 
 	m_chunkCount = 0;
@@ -226,3 +242,10 @@ void b2BlockAllocator::Clear()
 
 	memset(m_freeLists, 0, sizeof(m_freeLists));
 }
+
+void b2BlockAllocator::SetChunkAllocator(b2ChunkAllocFcn* allocFcn, void* context)
+{
+	b2Assert(m_chunkCount == 0);
+	m_chunkAlloc = allocFcn;
+	m_chunkContext = context;
+}
@@ -38,6 +38,11 @@ const int32 b2_chunkArrayIncrement = 128;
 struct b2Block;
 struct b2Chunk;
 
+/// ALTERATION: A page source for the chunks of a block allocator. The memory
+/// returned must remain valid until the allocator is cleared or destroyed,
+/// and it is never returned with b2Free.
+typedef void* b2ChunkAllocFcn(int32 size, void* context);
+
 /// This is a small object allocator used for allocating small
 /// objects that persist for more than one time step.
 /// See: http://www.codeproject.com/useritems/Small_Block_Allocator.asp
@@ -55,6 +60,14 @@ public:
 
 	void Clear();
 
+	/// ALTERATION: Draw chunks from an external page source (such as an arena)
+	/// instead of b2Alloc. The allocator must be empty. Pass NULL to restore
+	/// the default heap behavior.
+	void SetChunkAllocator(b2ChunkAllocFcn* allocFcn, void* context);
+
+	/// ALTERATION: The number of chunks currently owned by this allocator.
+	int32 GetChunkCount() const { return m_chunkCount; }
+
 private:
 
 	b2Chunk* m_chunks;
@@ -63,6 +76,10 @@ private:
 
 	b2Block* m_freeLists[b2_blockSizes];
 
+	// Alteration to support an external page source
+	b2ChunkAllocFcn* m_chunkAlloc;
+	void* m_chunkContext;
+
 	// Alteration to statify C++ coding standards
 	int32* m_blockSizes;
 	uint8* m_blockSizeLookup;
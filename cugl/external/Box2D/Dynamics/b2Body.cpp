@@ -71,6 +71,9 @@ b2Body::b2Body(const b2BodyDef* bd, b2World* world)
 	m_prev = NULL;
 	m_next = NULL;
 
+	// ALTERATION: Not in the moved list
+	m_moveIndex = -1;
+
 	m_linearVelocity = bd->linearVelocity;
 	m_angularVelocity = bd->angularVelocity;
 
@@ -123,8 +126,14 @@ void b2Body::SetType(b2BodyType type)
 		return;
 	}
 
+	// ALTERATION: Static proxies live in their own tree
+	bool moveProxies = (m_type == b2_staticBody) != (type == b2_staticBody);
+
 	m_type = type;
 
+	// ALTERATION: Report the new type to the world
+	m_world->BufferMove(this);
+
 	ResetMassData();
 
 	if (m_type == b2_staticBody)
@@ -155,6 +164,14 @@ void b2Body::SetType(b2BodyType type)
 	b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 	for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
 	{
+		// ALTERATION: New proxies are already buffered as moved
+		if (moveProxies && f->m_proxyCount > 0)
+		{
+			f->DestroyProxies(broadPhase);
+			f->CreateProxies(broadPhase, m_xf);
+			continue;
+		}
+
 		int32 proxyCount = f->m_proxyCount;
 		for (int32 i = 0; i < proxyCount; ++i)
 		{
@@ -441,6 +458,9 @@ void b2Body::SetTransform(const b2Vec2& position, float32 angle)
 	{
 		f->Synchronize(broadPhase, m_xf, m_xf);
 	}
+
+	// ALTERATION: Report the move to the world
+	m_world->BufferMove(this);
 }
 
 void b2Body::SynchronizeFixtures()
@@ -454,6 +474,9 @@ void b2Body::SynchronizeFixtures()
 	{
 		f->Synchronize(broadPhase, xf1, m_xf);
 	}
+
+	// ALTERATION: Report the move to the world
+	m_world->BufferMove(this);
 }
 
 void b2Body::SetActive(bool flag)
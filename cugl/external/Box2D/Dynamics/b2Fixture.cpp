@@ -130,7 +130,8 @@ void b2Fixture::CreateProxies(b2BroadPhase* broadPhase, const b2Transform& xf)
 	{
 		b2FixtureProxy* proxy = m_proxies + i;
 		m_shape->ComputeAABB(&proxy->aabb, xf, i);
-		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy);
+		// ALTERATION: Static bodies have their own tree
+		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy, m_body->GetType() == b2_staticBody);
 		proxy->fixture = this;
 		proxy->childIndex = i;
 	}
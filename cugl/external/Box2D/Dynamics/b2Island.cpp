@@ -168,10 +168,50 @@ b2Island::b2Island(
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+
+	m_contactIndices = NULL;
+	m_concurrent = false;
+}
+
+// ALTERATION: Concurrent islands borrow their arrays from the world.
+b2Island::b2Island(
+	b2Body** bodies,
+	int32 bodyCount,
+	b2Contact** contacts,
+	const int32* contactIndices,
+	int32 contactCount,
+	b2Position* positions,
+	b2Velocity* velocities,
+	b2StackAllocator* allocator)
+{
+	m_bodyCapacity = bodyCount;
+	m_contactCapacity = contactCount;
+	m_jointCapacity = 0;
+	m_bodyCount = bodyCount;
+	m_contactCount = contactCount;
+	m_jointCount = 0;
+
+	m_allocator = allocator;
+	m_listener = NULL;
+
+	m_bodies = bodies;
+	m_contacts = contacts;
+	m_joints = NULL;
+
+	m_velocities = velocities;
+	m_positions = positions;
+
+	m_contactIndices = contactIndices;
+	m_concurrent = true;
 }
 
 b2Island::~b2Island()
 {
+	if (m_concurrent)
+	{
+		return;
+	}
+
 	// Warning: the order should reverse the constructor order.
 	m_allocator->Free(m_positions);
 	m_allocator->Free(m_velocities);
@@ -197,8 +237,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		float32 w = b->m_angularVelocity;
 
 		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// ALTERATION: Static bodies may be shared with concurrent islands.
+		// Their positions never change, so there is nothing to store.
+		if (m_concurrent == false || b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -239,6 +284,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.indices = m_contactIndices;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
@@ -330,6 +376,10 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (m_concurrent && body->m_type == b2_staticBody)
+		{
+			continue;
+		}
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -375,6 +425,10 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 			for (int32 i = 0; i < m_bodyCount; ++i)
 			{
 				b2Body* b = m_bodies[i];
+				if (m_concurrent && b->m_type == b2_staticBody)
+				{
+					continue;
+				}
 				b->SetAwake(false);
 			}
 		}
@@ -400,6 +454,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.contacts = m_contacts;
 	contactSolverDef.count = m_contactCount;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.indices = NULL;
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
@@ -33,6 +33,7 @@
 #include <Box2D/Common/b2Draw.h>
 #include <Box2D/Common/b2Timer.h>
 #include <new>
+#include <algorithm>
 
 b2World::b2World(const b2Vec2& gravity)
 {
@@ -61,6 +62,17 @@ b2World::b2World(const b2Vec2& gravity)
 	m_contactManager.m_allocator = &m_blockAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
+	m_islandCount = 0;
+	m_toiCount = 0;
+
+	m_moveCapacity = 16;
+	m_moveCount = 0;
+	m_moveBuffer = (b2Body**)b2Alloc(m_moveCapacity * sizeof(b2Body*));
+
+	m_parallelFor = NULL;
+	m_parallelContext = NULL;
+	m_workerAllocators = NULL;
+	m_workerCount = 0;
 }
 
 b2World::~b2World()
@@ -82,6 +94,9 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetParallelSolver(NULL, NULL, 0);
+	b2Free(m_moveBuffer);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -125,6 +140,9 @@ b2Body* b2World::CreateBody(const b2BodyDef* def)
 	m_bodyList = b;
 	++m_bodyCount;
 
+	// ALTERATION: A new body has to be placed
+	BufferMove(b);
+
 	return b;
 }
 
@@ -204,6 +222,9 @@ void b2World::DestroyBody(b2Body* b)
 		m_bodyList = b->m_next;
 	}
 
+	// ALTERATION: Remove from the moved list.
+	UnBufferMove(b);
+
 	--m_bodyCount;
 	b->~b2Body();
 	m_blockAllocator.Free(b, sizeof(b2Body));
@@ -385,6 +406,13 @@ void b2World::SetAllowSleeping(bool flag)
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
+	// ALTERATION: Use the parallel solver if one is attached
+	if (m_workerCount > 1)
+	{
+		SolveParallel(step);
+		return;
+	}
+
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
@@ -527,6 +555,9 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
+		// ALTERATION: Count the islands of the step
+		++m_islandCount;
+
 		b2Profile profile;
 		island.Solve(&profile, step, m_gravity, m_allowSleep);
 		m_profile.solveInit += profile.solveInit;
@@ -862,6 +893,9 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.warmStarting = false;
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
+		// ALTERATION: Count the TOI events of the step
+		++m_toiCount;
+
 		// Reset island flags and synchronize broad-phase proxies.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
 		{
@@ -898,6 +932,10 @@ void b2World::Step(float32 dt, int32 velocityIterations, int32 positionIteration
 {
 	b2Timer stepTimer;
 
+	// ALTERATION: Reset the step counters
+	m_islandCount = 0;
+	m_toiCount = 0;
+
 	// If new fixtures were added, we need to find the new contacts.
 	if (m_flags & e_newFixture)
 	{
@@ -1274,6 +1312,79 @@ float32 b2World::GetTreeQuality() const
 	return m_contactManager.m_broadPhase.GetTreeQuality();
 }
 
+// ALTERATION: Static tree metrics
+int32 b2World::GetStaticTreeHeight() const
+{
+	return m_contactManager.m_broadPhase.GetStaticTreeHeight();
+}
+
+int32 b2World::GetStaticTreeBalance() const
+{
+	return m_contactManager.m_broadPhase.GetStaticTreeBalance();
+}
+
+float32 b2World::GetStaticTreeQuality() const
+{
+	return m_contactManager.m_broadPhase.GetStaticTreeQuality();
+}
+
+// ALTERATION: Bulk build of the static tree
+void b2World::RebuildStaticTree()
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.RebuildStaticTree();
+}
+
+// ALTERATION: The moved list is a buffer like the broad-phase move buffer.
+// Each body knows its position in the buffer, so that it is listed at most
+// once and can be removed in constant time.
+void b2World::BufferMove(b2Body* body)
+{
+	if (body->m_moveIndex != -1)
+	{
+		return;
+	}
+
+	if (m_moveCount == m_moveCapacity)
+	{
+		b2Body** oldBuffer = m_moveBuffer;
+		m_moveCapacity *= 2;
+		m_moveBuffer = (b2Body**)b2Alloc(m_moveCapacity * sizeof(b2Body*));
+		memcpy(m_moveBuffer, oldBuffer, m_moveCount * sizeof(b2Body*));
+		b2Free(oldBuffer);
+	}
+
+	body->m_moveIndex = m_moveCount;
+	m_moveBuffer[m_moveCount] = body;
+	++m_moveCount;
+}
+
+void b2World::UnBufferMove(b2Body* body)
+{
+	if (body->m_moveIndex != -1)
+	{
+		m_moveBuffer[body->m_moveIndex] = NULL;
+		body->m_moveIndex = -1;
+	}
+}
+
+void b2World::ClearMovedBodies()
+{
+	for (int32 i = 0; i < m_moveCount; ++i)
+	{
+		if (m_moveBuffer[i])
+		{
+			m_moveBuffer[i]->m_moveIndex = -1;
+		}
+	}
+	m_moveCount = 0;
+}
+
 void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	b2Assert((m_flags & e_locked) == 0);
@@ -1355,3 +1466,423 @@ void b2World::Dump()
 	b2Log("joints = NULL;\n");
 	b2Log("bodies = NULL;\n");
 }
+
+void b2World::SetBlockAllocatorSource(b2ChunkAllocFcn* allocFcn, void* context)
+{
+	b2Assert(IsLocked() == false);
+	ClearBlockAllocator();
+	m_blockAllocator.SetChunkAllocator(allocFcn, context);
+}
+
+void b2World::ClearBlockAllocator()
+{
+	b2Assert(IsLocked() == false);
+	b2Assert(m_bodyCount == 0 && m_jointCount == 0);
+	b2Assert(m_contactManager.m_contactCount == 0);
+	m_blockAllocator.Clear();
+}
+
+// ALTERATION: An island built for the parallel solver. Islands with joints
+// are solved as soon as they are built, and only kept for reporting.
+struct b2IslandJob
+{
+	int32 bodyOffset;
+	int32 bodyCount;
+	int32 contactOffset;
+	int32 contactCount;
+	bool solved;
+	b2Profile profile;
+};
+
+// ALTERATION: The state shared by every task of a parallel solve.
+struct b2IslandBatch
+{
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
+
+	b2IslandJob* jobs;
+	int32* order;
+
+	b2Body** bodies;
+	b2Contact** contacts;
+	int32* indices;
+	b2Position* positions;
+	b2Velocity* velocities;
+
+	b2StackAllocator* allocators;
+	int32 allocatorCount;
+};
+
+// ALTERATION: Orders island jobs from largest to smallest.
+struct b2IslandJobOrder
+{
+	const b2IslandJob* jobs;
+
+	bool operator()(int32 a, int32 b) const
+	{
+		int32 sizeA = jobs[a].bodyCount + jobs[a].contactCount;
+		int32 sizeB = jobs[b].bodyCount + jobs[b].contactCount;
+		return sizeA > sizeB || (sizeA == sizeB && a < b);
+	}
+};
+
+// ALTERATION: Solves a single joint-free island on a worker thread.
+static void b2SolveIslandTask(int32 index, int32 worker, void* taskContext)
+{
+	b2IslandBatch* batch = (b2IslandBatch*)taskContext;
+	b2Assert(0 <= worker && worker < batch->allocatorCount);
+
+	b2IslandJob* job = batch->jobs + batch->order[index];
+	b2Island island(batch->bodies + job->bodyOffset, job->bodyCount,
+					batch->contacts + job->contactOffset,
+					batch->indices + 2 * job->contactOffset, job->contactCount,
+					batch->positions + job->bodyOffset,
+					batch->velocities + job->bodyOffset,
+					batch->allocators + worker);
+	island.Solve(&job->profile, *batch->step, batch->gravity, batch->allowSleep);
+}
+
+// ALTERATION: Reports the impulses of a solved island. The contact solver
+// stores its impulses in the manifolds, so they can be read back after the
+// solver is gone.
+static void b2ReportIsland(b2ContactListener* listener, b2Contact** contacts, int32 count)
+{
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Contact* c = contacts[i];
+		const b2Manifold* manifold = c->GetManifold();
+
+		b2ContactImpulse impulse;
+		impulse.count = manifold->pointCount;
+		for (int32 j = 0; j < manifold->pointCount; ++j)
+		{
+			impulse.normalImpulses[j] = manifold->points[j].normalImpulse;
+			impulse.tangentImpulses[j] = manifold->points[j].tangentImpulse;
+		}
+
+		listener->PostSolve(c, &impulse);
+	}
+}
+
+void b2World::SetParallelSolver(b2ParallelForFcn* parallelFcn, void* context, int32 workerCount)
+{
+	b2Assert(IsLocked() == false);
+	if (m_workerAllocators)
+	{
+		for (int32 i = 0; i < m_workerCount; ++i)
+		{
+			m_workerAllocators[i].~b2StackAllocator();
+		}
+		b2Free(m_workerAllocators);
+		m_workerAllocators = NULL;
+	}
+
+	if (parallelFcn == NULL || workerCount < 2)
+	{
+		m_parallelFor = NULL;
+		m_parallelContext = NULL;
+		m_workerCount = 0;
+		return;
+	}
+
+	m_parallelFor = parallelFcn;
+	m_parallelContext = context;
+	m_workerCount = workerCount;
+	m_workerAllocators = (b2StackAllocator*)b2Alloc(workerCount * sizeof(b2StackAllocator));
+	for (int32 i = 0; i < workerCount; ++i)
+	{
+		new (m_workerAllocators + i) b2StackAllocator();
+	}
+}
+
+// ALTERATION: Build islands as in Solve, but defer the joint-free ones to the
+// parallel loop. Joints read the island index of their bodies on every
+// iteration, and a static body shared by several islands only keeps the index
+// of the last one built. So islands with joints are solved immediately.
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	m_profile.solveInit = 0.0f;
+	m_profile.solveVelocity = 0.0f;
+	m_profile.solvePosition = 0.0f;
+
+	int32 contactCount = m_contactManager.m_contactCount;
+
+	// Size the island for the worst case. Contacts are reported after
+	// every island is solved, so the island has no listener.
+	b2Island island(m_bodyCount,
+					contactCount,
+					m_jointCount,
+					&m_stackAllocator,
+					NULL);
+
+	// Clear all the island flags.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
+
+	// Storage for the islands. A static body appears once for each
+	// island that touches it, which is at most once per contact.
+	int32 bodyCapacity = m_bodyCount + contactCount;
+	b2IslandJob* jobs = (b2IslandJob*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandJob));
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(contactCount * sizeof(b2Contact*));
+	int32* indices = (int32*)m_stackAllocator.Allocate(2 * contactCount * sizeof(int32));
+	b2Position* positions = (b2Position*)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Position));
+	b2Velocity* velocities = (b2Velocity*)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Velocity));
+	int32 jobCount = 0;
+	int32 taskCount = 0;
+	int32 bodyTotal = 0;
+	int32 contactTotal = 0;
+
+	// Build all awake islands.
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Reset island and stack.
+		island.Clear();
+		int32 stackCount = 0;
+		stack[stackCount++] = seed;
+		seed->m_flags |= b2Body::e_islandFlag;
+
+		// Perform a depth first search (DFS) on the constraint graph.
+		while (stackCount > 0)
+		{
+			// Grab the next body off the stack and add it to the island.
+			b2Body* b = stack[--stackCount];
+			b2Assert(b->IsActive() == true);
+			island.Add(b);
+
+			// Make sure the body is awake.
+			b->SetAwake(true);
+
+			// To keep islands as small as possible, we don't
+			// propagate islands across static bodies.
+			if (b->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			// Search all contacts connected to this body.
+			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			{
+				b2Contact* contact = ce->contact;
+
+				// Has this contact already been added to an island?
+				if (contact->m_flags & b2Contact::e_islandFlag)
+				{
+					continue;
+				}
+
+				// Is this contact solid and touching?
+				if (contact->IsEnabled() == false ||
+					contact->IsTouching() == false)
+				{
+					continue;
+				}
+
+				// Skip sensors.
+				bool sensorA = contact->m_fixtureA->m_isSensor;
+				bool sensorB = contact->m_fixtureB->m_isSensor;
+				if (sensorA || sensorB)
+				{
+					continue;
+				}
+
+				island.Add(contact);
+				contact->m_flags |= b2Contact::e_islandFlag;
+
+				b2Body* other = ce->other;
+
+				// Was the other body already added to this island?
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+
+			// Search all joints connect to this body.
+			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			{
+				if (je->joint->m_islandFlag == true)
+				{
+					continue;
+				}
+
+				b2Body* other = je->other;
+
+				// Don't simulate joints connected to inactive bodies.
+				if (other->IsActive() == false)
+				{
+					continue;
+				}
+
+				island.Add(je->joint);
+				je->joint->m_islandFlag = true;
+
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+		}
+
+		// Record the island, capturing the body indices of each contact
+		// before a later island can renumber a shared static body.
+		b2IslandJob* job = jobs + jobCount++;
+		++m_islandCount;
+		job->bodyOffset = bodyTotal;
+		job->bodyCount = 0;
+		job->contactOffset = contactTotal;
+		job->contactCount = island.m_contactCount;
+		job->solved = island.m_jointCount > 0;
+		for (int32 i = 0; i < island.m_contactCount; ++i)
+		{
+			b2Contact* c = island.m_contacts[i];
+			indices[2 * contactTotal] = c->m_fixtureA->m_body->m_islandIndex;
+			indices[2 * contactTotal + 1] = c->m_fixtureB->m_body->m_islandIndex;
+			contacts[contactTotal++] = c;
+		}
+
+		if (job->solved)
+		{
+			island.Solve(&job->profile, step, m_gravity, m_allowSleep);
+		}
+		else
+		{
+			job->bodyCount = island.m_bodyCount;
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				bodies[bodyTotal++] = island.m_bodies[i];
+			}
+			++taskCount;
+		}
+
+		// Post solve cleanup.
+		for (int32 i = 0; i < island.m_bodyCount; ++i)
+		{
+			// Allow static bodies to participate in other islands.
+			b2Body* b = island.m_bodies[i];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->m_flags &= ~b2Body::e_islandFlag;
+			}
+		}
+	}
+
+	m_stackAllocator.Free(stack);
+
+	if (taskCount > 0)
+	{
+		// Start the largest islands first so that no worker is left
+		// with a large island at the end.
+		int32* order = (int32*)m_stackAllocator.Allocate(taskCount * sizeof(int32));
+		for (int32 i = 0, j = 0; i < jobCount; ++i)
+		{
+			if (jobs[i].solved == false)
+			{
+				order[j++] = i;
+			}
+		}
+		b2IslandJobOrder compare;
+		compare.jobs = jobs;
+		std::sort(order, order + taskCount, compare);
+
+		b2IslandBatch batch;
+		batch.step = &step;
+		batch.gravity = m_gravity;
+		batch.allowSleep = m_allowSleep;
+		batch.jobs = jobs;
+		batch.order = order;
+		batch.bodies = bodies;
+		batch.contacts = contacts;
+		batch.indices = indices;
+		batch.positions = positions;
+		batch.velocities = velocities;
+		batch.allocators = m_workerAllocators;
+		batch.allocatorCount = m_workerCount;
+		m_parallelFor(b2SolveIslandTask, &batch, taskCount, m_parallelContext);
+
+		m_stackAllocator.Free(order);
+	}
+
+	// Merge in the order the islands were built (the serial order).
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < jobCount; ++i)
+	{
+		const b2IslandJob* job = jobs + i;
+		m_profile.solveInit += job->profile.solveInit;
+		m_profile.solveVelocity += job->profile.solveVelocity;
+		m_profile.solvePosition += job->profile.solvePosition;
+		if (listener)
+		{
+			b2ReportIsland(listener, contacts + job->contactOffset, job->contactCount);
+		}
+	}
+
+	m_stackAllocator.Free(velocities);
+	m_stackAllocator.Free(positions);
+	m_stackAllocator.Free(indices);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
+	m_stackAllocator.Free(jobs);
+
+	{
+		b2Timer timer;
+		// Synchronize fixtures, check for out of range bodies.
+		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		{
+			// If a body was not in an island then it did not move.
+			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				continue;
+			}
+
+			if (b->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			// Update fixtures (for broad-phase).
+			b->SynchronizeFixtures();
+		}
+
+		// Look for new contacts.
+		m_contactManager.FindNewContacts();
+		m_profile.broadphase = timer.GetMilliseconds();
+	}
+}
@@ -35,6 +35,14 @@ class b2Draw;
 class b2Fixture;
 class b2Joint;
 
+/// ALTERATION: A single task of a parallel loop. The worker is the index of
+/// the thread running the task, in the range [0, workerCount).
+typedef void b2TaskFcn(int32 index, int32 worker, void* taskContext);
+
+/// ALTERATION: Run task(i, worker, taskContext) once for every i in [0, count),
+/// possibly in parallel, and return only when every task is complete.
+typedef void b2ParallelForFcn(b2TaskFcn* task, void* taskContext, int32 count, void* context);
+
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
 /// management facilities.
@@ -179,6 +187,23 @@ public:
 	/// The minimum is 1.
 	float32 GetTreeQuality() const;
 
+	/// ALTERATION: Get the height of the static tree. The proxies of static
+	/// bodies are kept apart from the dynamic tree.
+	int32 GetStaticTreeHeight() const;
+
+	/// ALTERATION: Get the balance of the static tree.
+	int32 GetStaticTreeBalance() const;
+
+	/// ALTERATION: Get the quality metric of the static tree. The smaller the
+	/// better. The minimum is 1.
+	float32 GetStaticTreeQuality() const;
+
+	/// ALTERATION: Rebuild the static tree in bulk with a binned surface area
+	/// heuristic. Call this after the static bodies of a level are created.
+	/// Static bodies added later are inserted incrementally as usual.
+	/// @warning this should be called outside of a time step.
+	void RebuildStaticTree();
+
 	/// Change the global gravity vector.
 	void SetGravity(const b2Vec2& gravity);
 	
@@ -209,6 +234,48 @@ public:
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+	/// ALTERATION: Draw the pages of the small object allocator from an
+	/// external source (such as an arena). The world must be empty.
+	void SetBlockAllocatorSource(b2ChunkAllocFcn* allocFcn, void* context);
+
+	/// ALTERATION: Release every small object block at once. The world must
+	/// be empty (no bodies or joints).
+	void ClearBlockAllocator();
+
+	/// ALTERATION: Get the small object allocator (for statistics).
+	const b2BlockAllocator& GetBlockAllocator() const;
+
+	/// ALTERATION: Solve independent islands in parallel. Islands are still
+	/// built on the calling thread. Joint-free islands are then handed to the
+	/// parallel loop, each worker using its own stack allocator. Contact
+	/// callbacks are reported afterwards on the calling thread, in the same
+	/// island order as the serial solver, so the results do not depend on the
+	/// number of workers. Islands with joints are solved serially. Pass NULL
+	/// (or fewer than two workers) to restore the serial solver.
+	void SetParallelSolver(b2ParallelForFcn* parallelFcn, void* context, int32 workerCount);
+
+	/// ALTERATION: Get the number of solver workers (0 if the solver is serial).
+	int32 GetSolverWorkerCount() const;
+
+	/// ALTERATION: Get the number of islands solved in the last time step.
+	int32 GetIslandCount() const;
+
+	/// ALTERATION: Get the number of TOI events solved in the last time step.
+	int32 GetTOICount() const;
+
+	/// ALTERATION: Get the bodies that moved since the moved list was last
+	/// cleared. A body is listed (once) when it is created, changes type, is
+	/// moved with SetTransform, or is solved in a time step. Sleeping bodies
+	/// are not solved, so they are only listed if they are moved by hand. A
+	/// destroyed body leaves a NULL entry.
+	b2Body* const* GetMovedBodies() const;
+
+	/// ALTERATION: Get the number of entries in the moved list.
+	int32 GetMovedBodyCount() const;
+
+	/// ALTERATION: Empty the moved list.
+	void ClearMovedBodies();
+
 private:
 
 	// m_flags
@@ -227,6 +294,13 @@ private:
 	void Solve(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	// ALTERATION: The parallel version of Solve
+	void SolveParallel(const b2TimeStep& step);
+
+	// ALTERATION: Add a body to the moved list (if it is not already there)
+	void BufferMove(b2Body* body);
+	void UnBufferMove(b2Body* body);
+
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
@@ -261,6 +335,21 @@ private:
 	bool m_stepComplete;
 
 	b2Profile m_profile;
+
+	// ALTERATION: Counters for the last time step
+	int32 m_islandCount;
+	int32 m_toiCount;
+
+	// ALTERATION: Bodies moved since the list was cleared
+	b2Body** m_moveBuffer;
+	int32 m_moveCapacity;
+	int32 m_moveCount;
+
+	// ALTERATION: Parallel island solver
+	b2ParallelForFcn* m_parallelFor;
+	void* m_parallelContext;
+	b2StackAllocator* m_workerAllocators;
+	int32 m_workerCount;
 };
 
 inline b2Body* b2World::GetBodyList()
@@ -346,9 +435,39 @@ inline const b2ContactManager& b2World::GetContactManager() const
 	return m_contactManager;
 }
 
+inline const b2BlockAllocator& b2World::GetBlockAllocator() const
+{
+	return m_blockAllocator;
+}
+
+inline int32 b2World::GetSolverWorkerCount() const
+{
+	return m_workerCount;
+}
+
 inline const b2Profile& b2World::GetProfile() const
 {
 	return m_profile;
 }
 
+inline int32 b2World::GetIslandCount() const
+{
+	return m_islandCount;
+}
+
+inline int32 b2World::GetTOICount() const
+{
+	return m_toiCount;
+}
+
+inline b2Body* const* b2World::GetMovedBodies() const
+{
+	return m_moveBuffer;
+}
+
+inline int32 b2World::GetMovedBodyCount() const
+{
+	return m_moveCount;
+}
+
 #endif
@@ -33,13 +33,20 @@ struct b2Pair
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
+///
+/// ALTERATION: Static proxies are kept in their own tree, and their ids carry
+/// the e_staticProxy bit. Static proxies never pair with each other, so the
+/// pairs of a moved proxy only need the trees it can collide with. The static
+/// tree can also be rebuilt in bulk once the level is loaded.
 class b2BroadPhase
 {
 public:
 
 	enum
 	{
-		e_nullProxy = -1
+		e_nullProxy = -1,
+		// ALTERATION: Marks the ids of proxies in the static tree
+		e_staticProxy = 0x40000000
 	};
 
 	b2BroadPhase();
@@ -47,7 +54,8 @@ public:
 
 	/// Create a proxy with an initial AABB. Pairs are not reported until
 	/// UpdatePairs is called.
-	int32 CreateProxy(const b2AABB& aabb, void* userData);
+	/// ALTERATION: Static proxies (those of static bodies) go in the static tree.
+	int32 CreateProxy(const b2AABB& aabb, void* userData, bool isStatic = false);
 
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int32 proxyId);
@@ -99,6 +107,19 @@ public:
 	/// Get the quality metric of the embedded tree.
 	float32 GetTreeQuality() const;
 
+	/// ALTERATION: Get the height of the static tree.
+	int32 GetStaticTreeHeight() const;
+
+	/// ALTERATION: Get the balance of the static tree.
+	int32 GetStaticTreeBalance() const;
+
+	/// ALTERATION: Get the quality metric of the static tree.
+	float32 GetStaticTreeQuality() const;
+
+	/// ALTERATION: Rebuild the static tree with a binned SAH build. Call this
+	/// once the static proxies of a level have been created.
+	void RebuildStaticTree();
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -113,8 +134,45 @@ private:
 
 	bool QueryCallback(int32 proxyId);
 
+	// ALTERATION: Forwards the proxies of one tree to a callback, adding the
+	// tree flag to their ids, and remembers whether the callback stopped.
+	template <typename T>
+	struct TreeCallback
+	{
+		T* callback;
+		int32 flag;
+		bool proceed;
+		float32 maxFraction;
+
+		bool QueryCallback(int32 proxyId)
+		{
+			proceed = callback->QueryCallback(proxyId | flag);
+			return proceed;
+		}
+
+		float32 RayCastCallback(const b2RayCastInput& input, int32 proxyId)
+		{
+			float32 value = callback->RayCastCallback(input, proxyId | flag);
+			if (value == 0.0f)
+			{
+				proceed = false;
+			}
+			else if (value > 0.0f)
+			{
+				maxFraction = value;
+			}
+			return value;
+		}
+	};
+
+	// ALTERATION: Get the tree holding a proxy.
+	const b2DynamicTree& GetTree(int32 proxyId) const;
+
 	b2DynamicTree m_tree;
 
+	// ALTERATION: The proxies of static bodies
+	b2DynamicTree m_staticTree;
+
 	int32 m_proxyCount;
 
 	int32* m_moveBuffer;
@@ -144,21 +202,26 @@ inline bool b2PairLessThan(const b2Pair& pair1, const b2Pair& pair2)
 	return false;
 }
 
+inline const b2DynamicTree& b2BroadPhase::GetTree(int32 proxyId) const
+{
+	return (proxyId & e_staticProxy) ? m_staticTree : m_tree;
+}
+
 inline void* b2BroadPhase::GetUserData(int32 proxyId) const
 {
-	return m_tree.GetUserData(proxyId);
+	return GetTree(proxyId).GetUserData(proxyId & ~e_staticProxy);
 }
 
 inline bool b2BroadPhase::TestOverlap(int32 proxyIdA, int32 proxyIdB) const
 {
-	const b2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
-	const b2AABB& aabbB = m_tree.GetFatAABB(proxyIdB);
+	const b2AABB& aabbA = GetFatAABB(proxyIdA);
+	const b2AABB& aabbB = GetFatAABB(proxyIdB);
 	return b2TestOverlap(aabbA, aabbB);
 }
 
 inline const b2AABB& b2BroadPhase::GetFatAABB(int32 proxyId) const
 {
-	return m_tree.GetFatAABB(proxyId);
+	return GetTree(proxyId).GetFatAABB(proxyId & ~e_staticProxy);
 }
 
 inline int32 b2BroadPhase::GetProxyCount() const
@@ -181,6 +244,26 @@ inline float32 b2BroadPhase::GetTreeQuality() const
 	return m_tree.GetAreaRatio();
 }
 
+inline int32 b2BroadPhase::GetStaticTreeHeight() const
+{
+	return m_staticTree.GetHeight();
+}
+
+inline int32 b2BroadPhase::GetStaticTreeBalance() const
+{
+	return m_staticTree.GetMaxBalance();
+}
+
+inline float32 b2BroadPhase::GetStaticTreeQuality() const
+{
+	return m_staticTree.GetAreaRatio();
+}
+
+inline void b2BroadPhase::RebuildStaticTree()
+{
+	m_staticTree.RebuildSAH();
+}
+
 template <typename T>
 void b2BroadPhase::UpdatePairs(T* callback)
 {
@@ -198,10 +281,17 @@ void b2BroadPhase::UpdatePairs(T* callback)
 
 		// We have to query the tree with the fat AABB so that
 		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
+		const b2AABB& fatAABB = GetFatAABB(m_queryProxyId);
 
 		// Query tree, create pairs and add them pair buffer.
 		m_tree.Query(this, fatAABB);
+
+		// ALTERATION: Static proxies never pair with each other.
+		if ((m_queryProxyId & e_staticProxy) == 0)
+		{
+			TreeCallback<b2BroadPhase> wrapper = { this, e_staticProxy, true, 1.0f };
+			m_staticTree.Query(&wrapper, fatAABB);
+		}
 	}
 
 	// Reset move buffer
@@ -215,8 +305,8 @@ void b2BroadPhase::UpdatePairs(T* callback)
 	while (i < m_pairCount)
 	{
 		b2Pair* primaryPair = m_pairBuffer + i;
-		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
-		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
+		void* userDataA = GetUserData(primaryPair->proxyIdA);
+		void* userDataB = GetUserData(primaryPair->proxyIdB);
 
 		callback->AddPair(userDataA, userDataB);
 		++i;
@@ -237,21 +327,39 @@ void b2BroadPhase::UpdatePairs(T* callback)
 	//m_tree.Rebalance(4);
 }
 
+// ALTERATION: Query both trees, unless the callback stops early.
 template <typename T>
 inline void b2BroadPhase::Query(T* callback, const b2AABB& aabb) const
 {
-	m_tree.Query(callback, aabb);
+	TreeCallback<T> wrapper = { callback, 0, true, 1.0f };
+	m_tree.Query(&wrapper, aabb);
+	if (wrapper.proceed)
+	{
+		wrapper.flag = e_staticProxy;
+		m_staticTree.Query(&wrapper, aabb);
+	}
 }
 
+// ALTERATION: Cast against both trees. The second cast is clipped by any
+// hit in the first, exactly as a single tree clips the rest of its cast.
 template <typename T>
 inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) const
 {
-	m_tree.RayCast(callback, input);
+	TreeCallback<T> wrapper = { callback, 0, true, input.maxFraction };
+	m_tree.RayCast(&wrapper, input);
+	if (wrapper.proceed)
+	{
+		b2RayCastInput subInput = input;
+		subInput.maxFraction = wrapper.maxFraction;
+		wrapper.flag = e_staticProxy;
+		m_staticTree.RayCast(&wrapper, subInput);
+	}
 }
 
 inline void b2BroadPhase::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	m_tree.ShiftOrigin(newOrigin);
+	m_staticTree.ShiftOrigin(newOrigin);
 }
 
 #endif
@@ -64,6 +64,10 @@ struct b2ContactSolverDef
 	b2Position* positions;
 	b2Velocity* velocities;
 	b2StackAllocator* allocator;
+
+	/// ALTERATION: The island indices of the two bodies of each contact (two
+	/// per contact). If NULL, the indices are read from the bodies.
+	const int32* indices;
 };
 
 class b2ContactSolver
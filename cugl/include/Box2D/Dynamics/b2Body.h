@@ -437,6 +437,9 @@ private:
 
 	int32 m_islandIndex;
 
+	// ALTERATION: The position in the moved list of the world (or -1)
+	int32 m_moveIndex;
+
 	b2Transform m_xf;		// the body origin transform
 	b2Sweep m_sweep;		// the swept motion for CCD
 
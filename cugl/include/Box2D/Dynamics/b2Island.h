@@ -36,6 +36,16 @@ class b2Island
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
 			b2StackAllocator* allocator, b2ContactListener* listener);
+
+	/// ALTERATION: Create a joint-free island over arrays owned by the caller.
+	/// Such an island may be solved concurrently with other islands: it never
+	/// writes to static bodies, and it does not report to a contact listener.
+	/// The contact indices hold the island indices of the bodies of each contact
+	/// (two per contact).
+	b2Island(b2Body** bodies, int32 bodyCount,
+			b2Contact** contacts, const int32* contactIndices, int32 contactCount,
+			b2Position* positions, b2Velocity* velocities, b2StackAllocator* allocator);
+
 	~b2Island();
 
 	void Clear()
@@ -88,6 +98,10 @@ public:
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	// ALTERATION: Support for the parallel island solver
+	const int32* m_contactIndices;
+	bool m_concurrent;
 };
 
 #endif
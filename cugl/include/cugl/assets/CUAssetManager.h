@@ -493,6 +493,36 @@ public:
     std::shared_ptr<T> get(const char* key) const {
         return get<T>(std::string(key));
     }
+
+    /**
+     * Returns a handle to the asset for the given key.
+     *
+     * The type of the asset is specified by the template parameter T. The
+     * handle is resolved once, and dereferencing it does not hash the key or
+     * search the loaders.  So handles should be preferred over {@link get}
+     * for assets accessed every frame.
+     *
+     * The handle is valid even if the asset is not yet loaded, and follows
+     * the asset if it is unloaded and reloaded.  However, it is tied to the
+     * current loader for T, and so it will not see assets of a loader that
+     * is attached later.
+     *
+     * @param  key  The key to identify the given asset
+     *
+     * @return a handle to the asset for the given key.
+     */
+    template<typename T>
+    AssetHandle<T> getHandle(const std::string& key) const {
+        size_t hash = typeid(T).hash_code();
+        auto it = _handlers.find(hash);
+        if (it == _handlers.end()) {
+            CUAssertLog(false, "No loader assigned for given type");
+            return AssetHandle<T>();
+        }
+        
+        std::shared_ptr<Loader<T>> loader = std::dynamic_pointer_cast<Loader<T>>(it->second);
+        return loader->getHandle(key);
+    }
     
     /**
      * Loads an asset and assigns it to the given key.
@@ -76,6 +76,10 @@ protected:
     using Loader<T>::_assets;
     /** Access the waiting queue in the super class */
     using Loader<T>::_queue;
+    /** Access the asset assignment in the super class */
+    using Loader<T>::store;
+    /** Access the asset removal in the super class */
+    using Loader<T>::eraseAll;
     /** Access the thread pool in the super class */
     using BaseLoader::_loader;
     
@@ -94,7 +98,7 @@ protected:
         if (asset != nullptr) {
             success = asset->materialize();
             if (success) {
-                _assets[key] = asset;
+                store(key, asset);
             }
         }
         
@@ -226,7 +230,7 @@ public:
      * fail.  You must reinitialize the loader to begin loading assets again.
      */
     void dispose() override {
-        _assets.clear();
+        eraseAll();
         _loader = nullptr;
     }
     
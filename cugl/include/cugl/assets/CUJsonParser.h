@@ -0,0 +1,292 @@
+//
+//  CUJsonParser.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a native, single-pass JSON parser for JsonValue.  The
+//  previous pipeline scanned the text once for matching braces, parsed it into
+//  a cJSON tree, and then converted that tree into JsonValue nodes.  This
+//  parser tokenizes the source buffer once and builds the JsonValue tree
+//  directly.  Tokens are read in place from the source buffer, and strings
+//  without escapes are copied straight into their nodes.  Where the platform
+//  supports it (see CU_MATH_VECTOR_SSE and CU_MATH_VECTOR_NEON64), whitespace
+//  and string contents are skipped sixteen bytes at a time.
+//
+//  The nodes of each document are allocated in a single arena.  The arena
+//  lives as long as any node of that document, and is released in one go
+//  when the last node is deleted.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_JSON_PARSER_H__
+#define __CU_JSON_PARSER_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/util/CUArena.h>
+#include <vector>
+#include <string>
+
+/** The smallest arena page for a parsed document */
+#define CU_JSON_PAGE_SIZE       4096
+/** The deepest nesting of arrays and objects (the same limit as cJSON) */
+#define CU_JSON_NESTING_LIMIT   1000
+
+namespace cugl {
+
+class JsonValue;
+
+/**
+ * This class is a single-pass parser from JSON text to a {@link JsonValue}.
+ *
+ * The parser reads the text in place and builds the tree directly, without
+ * any intermediate representation.  It accepts the same language as cJSON,
+ * which was the previous parsing engine.  In particular, numbers are stored
+ * as both a double and a saturated integer, exactly as before.
+ *
+ * Every node below the root is allocated in an arena that belongs to the
+ * parsed document.  The nodes are still ordinary shared pointers, and so the
+ * tree may be edited and shared like any other.  However, the memory of the
+ * document is only returned to the heap once every node in it is deleted.
+ *
+ * A parser may be reused for many documents, but it is not thread safe.
+ * Most applications will never use this class directly, and will instead
+ * use {@link JsonValue#allocWithJson} or {@link JsonReader}.
+ */
+class JsonParser {
+private:
+    /** The start of the text being parsed */
+    const char* _begin;
+    /** The end of the text being parsed */
+    const char* _end;
+    /** The current read position */
+    const char* _cursor;
+    /** The position of a parsing error (nullptr if none) */
+    const char* _error;
+    /** The arena for the nodes of the current document */
+    std::shared_ptr<Arena> _arena;
+    /** The children of the containers currently being parsed */
+    std::vector<std::shared_ptr<JsonValue>> _stack;
+    /** The scratch buffer for strings with escape sequences */
+    std::string _scratch;
+    /** The current nesting depth */
+    int _depth;
+    /** The number of nodes in the last document */
+    size_t _nodes;
+    /** The number of bytes of arena memory used by the last document */
+    size_t _usage;
+    /** The line number of the last error */
+    int _errline;
+    /** The offending line of the last error */
+    std::string _errtext;
+
+#pragma mark Internal Parsing
+    /**
+     * Returns true if the value at the cursor was parsed into node
+     *
+     * @param node  The node to store the value
+     *
+     * @return true if the value at the cursor was parsed into node
+     */
+    bool parseValue(JsonValue* node);
+
+    /**
+     * Returns true if the string at the cursor was parsed into value
+     *
+     * The cursor must be at the opening quote.
+     *
+     * @param value The string to store the result
+     *
+     * @return true if the string at the cursor was parsed into value
+     */
+    bool parseString(std::string& value);
+
+    /**
+     * Returns true if the number at the cursor was parsed into node
+     *
+     * @param node  The node to store the value
+     *
+     * @return true if the number at the cursor was parsed into node
+     */
+    bool parseNumber(JsonValue* node);
+
+    /**
+     * Returns true if the array at the cursor was parsed into node
+     *
+     * The cursor must be at the opening bracket.
+     *
+     * @param node  The node to store the value
+     *
+     * @return true if the array at the cursor was parsed into node
+     */
+    bool parseArray(JsonValue* node);
+
+    /**
+     * Returns true if the object at the cursor was parsed into node
+     *
+     * The cursor must be at the opening brace.
+     *
+     * @param node  The node to store the value
+     *
+     * @return true if the object at the cursor was parsed into node
+     */
+    bool parseObject(JsonValue* node);
+
+    /**
+     * Returns a new child of the given node, allocated in the document arena
+     *
+     * @param parent    The parent node
+     *
+     * @return a new child of the given node, allocated in the document arena
+     */
+    std::shared_ptr<JsonValue> allocChild(JsonValue* parent);
+
+    /**
+     * Records a parsing error at the given position and returns false
+     *
+     * @param pos   The position of the error
+     *
+     * @return false
+     */
+    bool fail(const char* pos);
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates a new parser.
+     *
+     * You must initialize this parser before use.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a parser on
+     * the heap, use one of the static constructors instead.
+     */
+    JsonParser();
+
+    /**
+     * Deletes this parser, releasing all resources.
+     *
+     * Documents parsed by this parser are unaffected.
+     */
+    ~JsonParser() { dispose(); }
+
+    /**
+     * Disposes this parser, releasing all resources.
+     *
+     * Documents parsed by this parser are unaffected.
+     */
+    void dispose();
+
+    /**
+     * Initializes a parser.
+     *
+     * @return true if initialization was successful.
+     */
+    bool init();
+
+    /**
+     * Returns a newly allocated parser.
+     *
+     * @return a newly allocated parser.
+     */
+    static std::shared_ptr<JsonParser> alloc() {
+        std::shared_ptr<JsonParser> result = std::make_shared<JsonParser>();
+        return (result->init() ? result : nullptr);
+    }
+
+#pragma mark Parsing
+    /**
+     * Returns the number of bytes of the first JSON value in the text.
+     *
+     * Parsing stops at the end of the first complete value, and so the text
+     * may continue past it.  The root node is replaced by the parsed value,
+     * and all of its descendants are allocated in a new arena.
+     *
+     * If there is a parsing error, this method returns 0 and records the
+     * location of the error.  See {@link getError}.
+     *
+     * @param root      The node to store the parsed value
+     * @param json      The JSON text
+     * @param length    The number of bytes of text
+     *
+     * @return the number of bytes of the first JSON value in the text.
+     */
+    size_t parse(JsonValue* root, const char* json, size_t length);
+
+    /**
+     * Returns the number of bytes of the first JSON value in the text.
+     *
+     * This method only finds the end of the value, and does not build a tree.
+     * Leading whitespace is included in the result.  Unlike a simple count
+     * of braces, it correctly skips over strings.  If the value is
+     * unterminated, this method returns 0.
+     *
+     * @param json      The JSON text
+     * @param length    The number of bytes of text
+     *
+     * @return the number of bytes of the first JSON value in the text.
+     */
+    static size_t scan(const char* json, size_t length);
+
+#pragma mark Diagnostics
+    /**
+     * Returns true if the last parse failed.
+     *
+     * @return true if the last parse failed.
+     */
+    bool failed() const { return _errline > 0; }
+
+    /**
+     * Returns a description of the last parsing error.
+     *
+     * The description includes the line number and the text of the offending
+     * line.  If the last parse succeeded, this method returns the empty string.
+     *
+     * @return a description of the last parsing error.
+     */
+    std::string getError() const;
+
+    /**
+     * Returns the number of nodes in the last parsed document.
+     *
+     * @return the number of nodes in the last parsed document.
+     */
+    size_t getNodeCount() const { return _nodes; }
+
+    /**
+     * Returns the number of bytes of arena memory used by the last document.
+     *
+     * @return the number of bytes of arena memory used by the last document.
+     */
+    size_t getArenaUsage() const { return _usage; }
+};
+
+}
+
+#endif /* __CU_JSON_PARSER_H__ */
@@ -4,8 +4,8 @@
 //
 //  This module a modern C++ alternative to the cJSON interface for reading
 //  JSON files.  In particular, this gives us better type-checking and memory
-//  management.  With that said, it still uses cJSON as the underlying parsing
-//  engine.
+//  management.  JSON text is parsed in a single pass by JsonParser, which
+//  builds this tree directly.  cJSON is only used to write JSON text.
 //
 //  This class uses our standard shared-pointer architecture.
 //
@@ -62,9 +62,11 @@ namespace cugl {
  * if the node is an object type.  Hence the main usage of this feature is to
  * "cast" object nodes to arrays.
  *
- * This class uses cJSON as the underlying parsing engine.  However, it manages
- * memory automatically so that the user does not need to worry about deleting
- * or allocating memory beyond the initial node itself.
+ * This class uses {@link JsonParser} to parse JSON text, and cJSON to write
+ * it.  It manages memory automatically so that the user does not need to
+ * worry about deleting or allocating memory beyond the initial node itself.
+ * The descendants of a parsed node share a single arena, which is released
+ * when the last of them is deleted.
  */
 class JsonValue {
 public:
@@ -283,7 +285,7 @@ public:
      * @return  true if the JSON node is initialized properly, false otherwise.
      */
     bool initWithJson(const std::string& json) {
-        return initWithJson(json.c_str());
+        return initWithJson(json.c_str(),json.size());
     }
     
     /**
@@ -304,6 +306,26 @@ public:
      */
     bool initWithJson(const char* json);
 
+    /**
+     * Initializes a new JsonValue from the given JSON text.
+     *
+     * This initializer will parse the first JSON value in the text and
+     * construct a full JSON tree for it, if possible. The text does not need
+     * to be null-terminated, and anything after the first value is ignored.
+     * The children are all owned by this node will be deleted when this node
+     * is deleted (provided there are no other references).
+     *
+     * If there is a parsing error, this method will return false.  Detailed
+     * information about the parsing error will be passed to an assert.  Hence
+     * error messages are suppressed if asserts are turned off.
+     *
+     * @param json      The JSON text to parse.
+     * @param length    The number of bytes of text
+     *
+     * @return  true if the JSON node is initialized properly, false otherwise.
+     */
+    bool initWithJson(const char* json, size_t length);
+
     
 #pragma mark -
 #pragma mark Static Constructors
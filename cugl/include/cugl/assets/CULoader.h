@@ -728,6 +728,105 @@ public:
 };
 
 
+#pragma mark -
+#pragma mark Asset Handles
+
+/**
+ * This class is a reference to an asset that is resolved once.
+ *
+ * Looking up an asset by key hashes the key string and probes both the
+ * asset manager and the loader.  That is fine when loading a scene, but is
+ * wasteful in code that runs every frame.  A handle is created once (see
+ * {@link Loader#getHandle} and {@link AssetManager#getHandle}), and then
+ * dereferences in constant time with no hashing.
+ *
+ * A handle refers to a key, not to a specific asset.  If the asset is
+ * unloaded, the handle will return nullptr.  If it is then loaded again,
+ * the handle will return the new asset.  A handle may even be created
+ * before its asset is loaded.
+ *
+ * Handles are cheap to copy (the cost of a shared pointer), and every copy
+ * refers to the same asset.  Like the loaders, handles are not thread-safe,
+ * and should only be used in the main CUGL thread.
+ */
+template <class T>
+class AssetHandle {
+private:
+    /** The asset slot in the loader (shared by every handle to the key) */
+    std::shared_ptr<std::shared_ptr<T>> _slot;
+
+public:
+    /**
+     * Creates a handle that refers to no asset.
+     */
+    AssetHandle() {}
+
+    /**
+     * Creates a handle for the given loader slot.
+     *
+     * This constructor is called by {@link Loader#getHandle}, and should not
+     * be called directly.
+     *
+     * @param slot  The asset slot in the loader
+     */
+    AssetHandle(const std::shared_ptr<std::shared_ptr<T>>& slot) : _slot(slot) {}
+
+    /**
+     * Returns the asset for this handle.
+     *
+     * If the asset is not currently loaded, this method returns nullptr.
+     *
+     * @return the asset for this handle.
+     */
+    const std::shared_ptr<T>& get() const {
+        static const std::shared_ptr<T> none;
+        return _slot == nullptr ? none : *_slot;
+    }
+
+    /**
+     * Returns the asset for this handle.
+     *
+     * If the asset is not currently loaded, this method returns nullptr.
+     *
+     * @return the asset for this handle.
+     */
+    const std::shared_ptr<T>& operator*() const { return get(); }
+
+    /**
+     * Returns a pointer to the asset for this handle.
+     *
+     * The asset must be currently loaded.
+     *
+     * @return a pointer to the asset for this handle.
+     */
+    T* operator->() const {
+        CUAssertLog(isLoaded(), "Asset handle is not loaded");
+        return _slot->get();
+    }
+
+    /**
+     * Returns true if this handle refers to a key of some loader.
+     *
+     * @return true if this handle refers to a key of some loader.
+     */
+    bool isValid() const { return _slot != nullptr; }
+
+    /**
+     * Returns true if the asset for this handle is currently loaded.
+     *
+     * @return true if the asset for this handle is currently loaded.
+     */
+    bool isLoaded() const { return _slot != nullptr && *_slot != nullptr; }
+
+    /**
+     * Returns true if the asset for this handle is currently loaded.
+     *
+     * @return true if the asset for this handle is currently loaded.
+     */
+    explicit operator bool() const { return isLoaded(); }
+};
+
+
 #pragma mark -
 #pragma mark Templated Middle Layer
 
@@ -753,6 +852,63 @@ protected:
     
     /** The assets we are expecting that are not yet loaded */
     std::unordered_set<std::string> _queue;
+    
+    /** The slots referenced by asset handles (kept across unloads) */
+    mutable std::unordered_map<std::string, std::shared_ptr<std::shared_ptr<T>>> _slots;
+
+    /**
+     * Assigns the asset to the given key.
+     *
+     * Loaders must always use this method (and never modify _assets directly),
+     * as it also updates any handles to the key.
+     *
+     * @param key   The key associated with the asset
+     * @param asset The asset to assign
+     */
+    void store(const std::string& key, const std::shared_ptr<T>& asset) {
+        _assets[key] = asset;
+        auto it = _slots.find(key);
+        if (it != _slots.end()) {
+            *(it->second) = asset;
+        }
+    }
+
+    /**
+     * Removes the asset for the given key, returning true if it was present.
+     *
+     * Loaders must always use this method (and never modify _assets directly),
+     * as it also updates any handles to the key.
+     *
+     * @param key   The key associated with the asset
+     *
+     * @return true if the asset was present
+     */
+    bool erase(const std::string& key) {
+        auto it = _assets.find(key);
+        if (it == _assets.end()) {
+            return false;
+        }
+        _assets.erase(it);
+        auto jt = _slots.find(key);
+        if (jt != _slots.end()) {
+            *(jt->second) = nullptr;
+        }
+        return true;
+    }
+
+    /**
+     * Removes all of the assets.
+     *
+     * Loaders must always use this method (and never modify _assets directly),
+     * as it also updates any handles.  The handles remain valid, and will
+     * refer to their assets again if they are reloaded.
+     */
+    void eraseAll() {
+        _assets.clear();
+        for(auto it = _slots.begin(); it != _slots.end(); ++it) {
+            *(it->second) = nullptr;
+        }
+    }
 
     /**
      * Unloads the asset for the given key
@@ -769,12 +925,7 @@ protected:
      * @return true if the asset was successfully unloaded
      */
     bool purge(const std::string& key) override {
-        auto it = _assets.find(key);
-        if (it != _assets.end()) {
-            _assets.erase(it);
-            return true;
-        }
-        return false;
+        return erase(key);
     }
     
     /**
@@ -858,6 +1009,28 @@ public:
      */
     std::shared_ptr<T> operator[](const char* key) const { return get(key); }
     
+    /**
+     * Returns a handle to the asset for the given key.
+     *
+     * The handle is valid even if the asset is not yet loaded, and follows
+     * the asset if it is unloaded and reloaded.  Dereferencing the handle is
+     * much cheaper than calling {@link get}, and so handles should be used
+     * for any asset that is accessed every frame.
+     *
+     * @param key   The key associated with the asset
+     *
+     * @return a handle to the asset for the given key
+     */
+    AssetHandle<T> getHandle(const std::string& key) const {
+        auto it = _slots.find(key);
+        if (it != _slots.end()) {
+            return AssetHandle<T>(it->second);
+        }
+        auto slot = std::make_shared<std::shared_ptr<T>>(get(key));
+        _slots.emplace(key,slot);
+        return AssetHandle<T>(slot);
+    }
+    
 
 #pragma mark Asset Loading
     /**
@@ -891,7 +1064,7 @@ public:
      * are released.
      */
     void unloadAll() override {
-        _assets.clear();
+        eraseAll();
     }
 };
 
@@ -316,7 +316,7 @@ public:
      */
     void dispose() override {
         _manager = nullptr;
-        _assets.clear();
+        eraseAll();
         _loader = nullptr;
         _types.clear();
         _forms.clear();
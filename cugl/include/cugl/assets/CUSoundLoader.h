@@ -166,7 +166,7 @@ public:
      * fail.  You must reinitialize the loader to begin loading assets again.
      */
     void dispose() override {
-        _assets.clear();
+        eraseAll();
         _loader = nullptr;
     }
     
@@ -69,6 +69,7 @@ namespace cugl {
         class AudioMixer;
         class AudioFader;
         class AudioPanner;
+        class AudioDispatcher;
     }
 
     /** AudioQueue for music support */
@@ -143,6 +144,12 @@ private:
     std::vector<std::shared_ptr<audio::AudioFader>>     _covers;
     /** The slot objects for sheduling sounds */
     std::vector<std::shared_ptr<audio::AudioScheduler>> _slots;
+    /** The root of the graph, applying recorded commands at precise frames */
+    std::shared_ptr<audio::AudioDispatcher> _dispatch;
+    /** The idle effect slots (the most recently freed is last) */
+    std::vector<Uint32> _free;
+    /** The newest fader given each effect slot (nullptr if the slot is idle) */
+    std::vector<audio::AudioFader*> _owners;
 
     /** Active music queues */
     std::vector<std::shared_ptr<AudioQueue>> _queues;
@@ -153,9 +160,9 @@ private:
     std::deque<std::string> _evicts;
 
     /** An object pool of faders for individual sound instances */
-    std::deque<std::shared_ptr<audio::AudioFader>>  _fadePool;
-    /** An object pool of panners for panning sound assets */
-    std::deque<std::shared_ptr<audio::AudioPanner>> _panPool;
+    std::vector<std::shared_ptr<audio::AudioFader>>  _fadePool;
+    /** An object pool of panners, each attached to the fader at the same position */
+    std::vector<std::shared_ptr<audio::AudioPanner>> _panPool;
 
     /**
      * Callback function for the sound effects
@@ -222,6 +229,44 @@ private:
      */
     void removeKey(const std::string key);
 
+    /**
+     * Returns a slot to play a new sound effect, or -1 if there is none.
+     *
+     * This method takes the most recently freed slot from the list of idle
+     * slots. If there is none, it takes a slot whose sound is fading out,
+     * provided no newer sound has been given that slot. If there is no such
+     * slot and force is true, it will clear the longest playing sound effect
+     * and return its slot.
+     *
+     * A slot leaves the idle list as soon as it is returned, so a sound that
+     * is queued (or recorded) but not yet playing keeps its slot.  The slot
+     * goes back on the list when the last sound given it is collected.
+     *
+     * @param force Whether to force another sound to stop.
+     *
+     * @return a slot to play a new sound effect, or -1 if there is none.
+     */
+    int acquireSlot(bool force);
+
+    /**
+     * Records the given audio instance to play at the next submit.
+     *
+     * This method is the shared implementation of the two versions of
+     * {@link #recordPlay}.  It reserves a slot and wraps the instance on the
+     * main thread, so that the audio thread only has to start it.
+     *
+     * @param  key      The reference key for the sound effect
+     * @param  instance The audio instance to play
+     * @param  loop     Whether to loop the sound effect continuously
+     * @param  volume   The music volume (relative to the default volume)
+     * @param  force    Whether to force another sound to stop.
+     * @param  offset   The frame offset into the callback that starts it
+     *
+     * @return true if there was an available channel for the sound
+     */
+    bool recordInstance(const std::string key, const std::shared_ptr<audio::AudioNode>& instance,
+                        bool loop, float volume, bool force, Uint32 offset);
+
     /**
      * Returns a playable audio node for a given audio instance
      *
@@ -799,6 +844,100 @@ public:
         return _callback;
     }
 
+#pragma mark -
+#pragma mark Batched Commands
+    /**
+     * Records the given sound to play at the next submit.
+     *
+     * This method is the batched version of {@link #play}.  The slot is chosen
+     * and the sound is wrapped right away, so the key is active as soon as this
+     * method returns.  However, the sound does not start until the audio thread
+     * applies the batch, after the next call to {@link #submit}.  It then starts
+     * exactly offset frames into that audio callback, so sounds with the same
+     * offset start on the same frame.  The main thread only reserves a slot,
+     * attaches the sound to a pooled fader and panner, and writes the command.
+     *
+     * Until the sound starts, {@link #getState} reports it as inactive.
+     *
+     * @param  key      The reference key for the sound effect
+     * @param  sound    The sound effect to play
+     * @param  loop     Whether to loop the sound effect continuously
+     * @param  volume   The music volume (relative to the default asset volume)
+     * @param  force    Whether to force another sound to stop.
+     * @param  offset   The frame offset into the callback that starts it
+     *
+     * @return true if there was an available channel for the sound
+     */
+    bool recordPlay(const std::string key, const std::shared_ptr<Sound>& sound,
+                    bool loop=false, float volume=1.0f, bool force=false, Uint32 offset=0);
+
+    /**
+     * Records the given audio node to play at the next submit.
+     *
+     * This method is the batched version of {@link #play}, and it works like
+     * the sound version of {@link #recordPlay}.
+     *
+     * @param  key      The reference key for the sound effect
+     * @param  graph    The audio graph to play
+     * @param  loop     Whether to loop the sound effect continuously
+     * @param  volume   The music volume (relative to the default instance volume)
+     * @param  force    Whether to force another sound to stop.
+     * @param  offset   The frame offset into the callback that starts it
+     *
+     * @return true if there was an available channel for the sound
+     */
+    bool recordPlay(const std::string key, const std::shared_ptr<audio::AudioNode>& graph,
+                    bool loop=false, float volume=1.0f, bool force=false, Uint32 offset=0);
+
+    /**
+     * Records a command to stop the sound effect for the given key.
+     *
+     * This method is the batched version of {@link #clear}.  The fade-out
+     * starts offset frames into the audio callback after the next call to
+     * {@link #submit}.  If the key does not correspond to an active sound
+     * effect, this method does nothing.
+     *
+     * @param  key      the reference key for the sound effect
+     * @param  fade     the number of seconds to fade out
+     * @param  offset   The frame offset into the callback that applies it
+     */
+    void recordClear(const std::string key, float fade=DEFAULT_FADE, Uint32 offset=0);
+
+    /**
+     * Records a command to set the volume of the sound effect.
+     *
+     * This method is the batched version of {@link #setVolume}.  If the key
+     * does not correspond to an active sound effect, this method does nothing.
+     *
+     * @param  key      the reference key for the sound effect
+     * @param  volume   the volume of the sound effect
+     * @param  offset   The frame offset into the callback that applies it
+     */
+    void recordVolume(const std::string key, float volume, Uint32 offset=0);
+
+    /**
+     * Records a command to set the stereo pan of the sound effect.
+     *
+     * This method is the batched version of {@link #setPanFactor}.  If the key
+     * does not correspond to an active sound effect, this method does nothing.
+     *
+     * @param  key      the reference key for the sound effect
+     * @param  pan      the stereo pan of the sound effect
+     * @param  offset   The frame offset into the callback that applies it
+     */
+    void recordPanFactor(const std::string key, float pan, Uint32 offset=0);
+
+    /**
+     * Submits all recorded commands to the audio thread.
+     *
+     * The audio thread applies the whole batch at the start of its next
+     * callback, each command at its frame offset.  This method should be
+     * called once per animation frame, after the last command of the frame.
+     *
+     * @return the number of commands submitted
+     */
+    Uint32 submit();
+
 #pragma mark -
 #pragma mark Global Management
     /**
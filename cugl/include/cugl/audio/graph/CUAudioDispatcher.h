@@ -0,0 +1,498 @@
+//
+//  CUAudioDispatcher.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an audio node that applies playback commands from the
+//  main thread at sample-accurate positions.  Calling the graph nodes directly
+//  from the main thread publishes every change separately, and each change
+//  takes effect at whatever point the audio thread happens to be in.  This
+//  node instead records the commands in a lock-free ring buffer.  The main
+//  thread submits them once per frame, and the audio thread applies the whole
+//  batch in its next callback.  Plays start at their frame offset inside the
+//  scheduler, and the other commands split the read of the input.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_AUDIO_DISPATCHER_H__
+#define __CU_AUDIO_DISPATCHER_H__
+#include <SDL/SDL.h>
+#include "CUAudioNode.h"
+#include <atomic>
+
+/** The default number of commands a dispatcher can hold */
+#define DEFAULT_DISPATCH_SIZE   1024
+
+namespace cugl {
+
+    /**
+     * The audio graph classes.
+     *
+     * This internal namespace is for the audio graph clases.  It was chosen
+     * to distinguish this graph from other graph class collections, such as the
+     * scene graph collections in {@link scene2}.
+     */
+    namespace audio {
+        /** The graph nodes that the commands act upon */
+        class AudioScheduler;
+        class AudioFader;
+        class AudioPanner;
+
+/**
+ * This class applies batches of playback commands at precise frames.
+ *
+ * This node is a pass-through for its input, typically the mixer at the root
+ * of an audio graph.  The main thread records commands (play, stop, gain and
+ * pan) with a frame offset, and then calls {@link #submit} once per animation
+ * frame.  The audio thread applies the whole batch in its next call to
+ * {@link #read}.  A play is handed to its {@link AudioScheduler} with the
+ * offset as a delay, so a sound played at offset 100 starts exactly 100 frames
+ * into that read, and two sounds with the same offset start on the same frame.
+ * The other commands split the read of the input at their offsets, so only
+ * those cost an extra pass through the graph.  An offset past the end of the
+ * read is applied at the end of that read.
+ *
+ * The commands are stored in a fixed-size ring buffer with a single producer
+ * (the main thread) and a single consumer (the audio thread).  Recording a
+ * command does not publish it, so the audio thread never sees part of a batch.
+ * Submitting a batch is a single atomic store, and it never blocks or
+ * allocates.  The ring holds a reference to every node in a command until the
+ * main thread reuses the entry, so the audio thread never releases the last
+ * reference to a node.
+ *
+ * If the ring is full, a command cannot be recorded and the record method
+ * returns false.  This only happens if the main thread records more commands
+ * than the capacity between two callbacks.
+ *
+ * The audio graph should only be accessed in the main thread.  In addition,
+ * no methods marked as AUDIO THREAD ONLY should ever be accessed by the user.
+ *
+ * This class does not support any actions for the {@link AudioNode#setCallback}.
+ */
+class AudioDispatcher : public AudioNode {
+public:
+    /**
+     * This enum represents the commands that a dispatcher can apply.
+     */
+    enum class Command : int {
+        /** Plays a node on a scheduler, interrupting the active node */
+        PLAY = 0,
+        /** Fades out a node on a scheduler, cancelling any loops */
+        STOP = 1,
+        /** Sets the gain of a node */
+        GAIN = 2,
+        /** Sets an entry of the matrix of a panner */
+        PAN  = 3
+    };
+
+private:
+    /** A recorded command */
+    struct Entry {
+        /** The command type */
+        Command command;
+        /** The frame offset into the read that applies it */
+        Uint32 offset;
+        /** The scheduler for a play or stop */
+        std::shared_ptr<AudioScheduler> slot;
+        /** The node to play, stop, scale or pan */
+        std::shared_ptr<AudioNode> node;
+        /** The loops for a play, or the input channel for a pan */
+        Sint32 index;
+        /** The output channel for a pan */
+        Uint32 channel;
+        /** The fade time for a stop, the gain, or the pan matrix entry */
+        float value;
+    };
+
+    /** The audio input node */
+    std::shared_ptr<AudioNode> _input;
+
+    /** The command ring buffer */
+    Entry* _ring;
+    /** The scratch array to sort a batch by offset (AUDIO THREAD ONLY) */
+    Uint32* _order;
+    /** The ring capacity (a power of two) */
+    Uint32 _capacity;
+    /** The next ring position to record (MAIN THREAD ONLY) */
+    Uint32 _record;
+    /** The ring position after the last submitted command */
+    std::atomic<Uint32> _tail;
+    /** The ring position after the last applied command */
+    std::atomic<Uint32> _head;
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Returns the next ring entry to record, or nullptr if the ring is full
+     *
+     * @param command   The command type
+     * @param offset    The frame offset of the command
+     *
+     * @return the next ring entry to record, or nullptr if the ring is full
+     */
+    Entry* record(Command command, Uint32 offset);
+
+    /**
+     * Applies the given command to the audio graph.
+     *
+     * AUDIO THREAD ONLY: This is an internal method for {@link read}.
+     *
+     * @param entry The command to apply
+     */
+    void apply(const Entry& entry);
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates a degenerate dispatcher with no input and no capacity.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a graph node on
+     * the heap, use one of the static constructors instead.
+     */
+    AudioDispatcher();
+
+    /**
+     * Deletes this dispatcher, disposing of all resources.
+     */
+    ~AudioDispatcher() { dispose(); }
+
+    /**
+     * Initializes the node with default stereo settings
+     *
+     * The number of channels is two, for stereo output.  The sample rate is
+     * the modern standard of 48000 HZ.  The dispatcher can hold
+     * {@link DEFAULT_DISPATCH_SIZE} commands.
+     *
+     * @return true if initialization was successful
+     */
+    virtual bool init() override;
+
+    /**
+     * Initializes the node with the given number of channels and sample rate
+     *
+     * The dispatcher can hold {@link DEFAULT_DISPATCH_SIZE} commands.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     *
+     * @return true if initialization was successful
+     */
+    virtual bool init(Uint8 channels, Uint32 rate) override;
+
+    /**
+     * Initializes the node with the given channels, sample rate and capacity
+     *
+     * The capacity is the number of commands that can be recorded before
+     * the audio thread applies them.  It is rounded up to a power of two.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param capacity  The number of commands the dispatcher can hold
+     *
+     * @return true if initialization was successful
+     */
+    bool init(Uint8 channels, Uint32 rate, Uint32 capacity);
+
+    /**
+     * Initializes a dispatcher for the given input node.
+     *
+     * This node acquires the channels and sample rate of the input.  If
+     * input is nullptr, this method will fail.
+     *
+     * @param input     The audio node to dispatch for
+     * @param capacity  The number of commands the dispatcher can hold
+     *
+     * @return true if initialization was successful
+     */
+    bool init(const std::shared_ptr<AudioNode>& input, Uint32 capacity=DEFAULT_DISPATCH_SIZE);
+
+    /**
+     * Disposes any resources allocated for this dispatcher
+     *
+     * The state of the node is reset to that of an uninitialized constructor.
+     * Unlike the destructor, this method allows the node to be reinitialized.
+     */
+    virtual void dispose() override;
+
+#pragma mark -
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated dispatcher with the default stereo settings
+     *
+     * The number of channels is two, for stereo output.  The sample rate is
+     * the modern standard of 48000 HZ. Any input node must agree with these
+     * settings.
+     *
+     * @return a newly allocated dispatcher with the default stereo settings
+     */
+    static std::shared_ptr<AudioDispatcher> alloc() {
+        std::shared_ptr<AudioDispatcher> result = std::make_shared<AudioDispatcher>();
+        return (result->init() ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated dispatcher with the given channels, rate and capacity
+     *
+     * Any input node must agree with these settings.  The capacity is rounded
+     * up to a power of two.
+     *
+     * @param channels  The number of audio channels
+     * @param rate      The sample rate (frequency) in HZ
+     * @param capacity  The number of commands the dispatcher can hold
+     *
+     * @return a newly allocated dispatcher with the given channels, rate and capacity
+     */
+    static std::shared_ptr<AudioDispatcher> alloc(Uint8 channels, Uint32 rate,
+                                                  Uint32 capacity=DEFAULT_DISPATCH_SIZE) {
+        std::shared_ptr<AudioDispatcher> result = std::make_shared<AudioDispatcher>();
+        return (result->init(channels,rate,capacity) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated dispatcher for the given input node.
+     *
+     * This node acquires the channels and sample rate of the input.  If
+     * input is nullptr, this method will fail.
+     *
+     * @param input     The audio node to dispatch for
+     * @param capacity  The number of commands the dispatcher can hold
+     *
+     * @return a newly allocated dispatcher for the given input node.
+     */
+    static std::shared_ptr<AudioDispatcher> alloc(const std::shared_ptr<AudioNode>& input,
+                                                  Uint32 capacity=DEFAULT_DISPATCH_SIZE) {
+        std::shared_ptr<AudioDispatcher> result = std::make_shared<AudioDispatcher>();
+        return (result->init(input,capacity) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Audio Graph
+    /**
+     * Attaches an audio node to this dispatcher.
+     *
+     * This method will fail if the channels of the audio node do not agree
+     * with this dispatcher.
+     *
+     * @param node  The audio node to dispatch for
+     *
+     * @return true if the attachment was successful
+     */
+    bool attach(const std::shared_ptr<AudioNode>& node);
+
+    /**
+     * Detaches an audio node from this dispatcher.
+     *
+     * If the method succeeds, it returns the audio node that was removed.
+     *
+     * @return  The audio node to detach (or null if failed)
+     */
+    std::shared_ptr<AudioNode> detach();
+
+    /**
+     * Returns the input node of this dispatcher.
+     *
+     * @return the input node of this dispatcher.
+     */
+    std::shared_ptr<AudioNode> getInput() { return _input; }
+
+#pragma mark -
+#pragma mark Command Recording
+    /**
+     * Records a command to play a node on the given scheduler.
+     *
+     * When applied, the node interrupts the active node of the scheduler (see
+     * {@link AudioScheduler#start}).  The loop value works exactly as it does
+     * for {@link AudioScheduler#play}.  The command is not applied until the
+     * next call to {@link #submit}.
+     *
+     * @param slot      The scheduler to play on
+     * @param node      The audio node for playback
+     * @param loops     The number of times to loop the audio
+     * @param offset    The frame offset into the callback that applies it
+     *
+     * @return true if the command was recorded
+     */
+    bool recordPlay(const std::shared_ptr<AudioScheduler>& slot,
+                    const std::shared_ptr<AudioNode>& node, Sint32 loops, Uint32 offset=0);
+
+    /**
+     * Records a command to fade out a node on the given scheduler.
+     *
+     * When applied, the loops of the scheduler are cancelled if the fader is
+     * its active node, and the fader starts a fade-out over the given number
+     * of seconds.  A fade of 0 stops the node at that frame.  The command is
+     * not applied until the next call to {@link #submit}.
+     *
+     * @param slot      The scheduler playing the fader
+     * @param fader     The fader to fade out
+     * @param fade      The number of seconds to fade out
+     * @param offset    The frame offset into the callback that applies it
+     *
+     * @return true if the command was recorded
+     */
+    bool recordStop(const std::shared_ptr<AudioScheduler>& slot,
+                    const std::shared_ptr<AudioFader>& fader, float fade, Uint32 offset=0);
+
+    /**
+     * Records a command to set the gain of a node.
+     *
+     * The command is not applied until the next call to {@link #submit}.
+     *
+     * @param node      The node to scale
+     * @param gain      The new gain of the node
+     * @param offset    The frame offset into the callback that applies it
+     *
+     * @return true if the command was recorded
+     */
+    bool recordGain(const std::shared_ptr<AudioNode>& node, float gain, Uint32 offset=0);
+
+    /**
+     * Records a command to set an entry of the matrix of a panner.
+     *
+     * The entry is the same as for {@link AudioPanner#setPan}. The command is
+     * not applied until the next call to {@link #submit}.
+     *
+     * @param panner    The panner to adjust
+     * @param field     The input channel
+     * @param channel   The output channel
+     * @param value     The amount of the input channel sent to the output channel
+     * @param offset    The frame offset into the callback that applies it
+     *
+     * @return true if the command was recorded
+     */
+    bool recordPan(const std::shared_ptr<AudioPanner>& panner,
+                   Uint32 field, Uint32 channel, float value, Uint32 offset=0);
+
+    /**
+     * Submits all recorded commands to the audio thread.
+     *
+     * The audio thread applies them all in its next callback.  This method is
+     * a single atomic store, so it should be called once per animation frame,
+     * after all of the commands for that frame have been recorded.
+     *
+     * @return the number of commands submitted
+     */
+    Uint32 submit();
+
+    /**
+     * Returns the number of commands that can be recorded right now.
+     *
+     * This is the capacity less any commands that are recorded or submitted,
+     * but not yet applied by the audio thread.
+     *
+     * @return the number of commands that can be recorded right now.
+     */
+    Uint32 getAvailable() const {
+        return _capacity-(_record-_head.load(std::memory_order_acquire));
+    }
+
+    /**
+     * Returns the number of commands recorded but not yet submitted.
+     *
+     * @return the number of commands recorded but not yet submitted.
+     */
+    Uint32 getPending() const {
+        return _record-_tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the ring position after the most recently recorded command.
+     *
+     * Positions count every command ever recorded (modulo 2^32).  Pass this
+     * value to {@link #isApplied} to learn when the audio thread has applied
+     * that command and everything recorded before it.
+     *
+     * @return the ring position after the most recently recorded command.
+     */
+    Uint32 getRecordPosition() const { return _record; }
+
+    /**
+     * Returns true if the audio thread has applied every command before position
+     *
+     * The position is typically a previous value of {@link #getRecordPosition}.
+     *
+     * @param position  The ring position to check
+     *
+     * @return true if the audio thread has applied every command before position
+     */
+    bool isApplied(Uint32 position) const {
+        return (Sint32)(_head.load(std::memory_order_acquire)-position) >= 0;
+    }
+
+#pragma mark -
+#pragma mark Overriden Methods
+    /**
+     * Reads up to the specified number of frames into the given buffer
+     *
+     * AUDIO THREAD ONLY: Users should never access this method directly.
+     * The only exception is when the user needs to create a custom subclass
+     * of this AudioNode.
+     *
+     * The buffer should have enough room to store frames * channels elements.
+     * The channels are interleaved into the output buffer.
+     *
+     * This method applies every submitted command.  Plays are handed to their
+     * scheduler with the offset as a delay.  The other commands split the read
+     * of the input at their offsets.  It always fills the entire buffer, using
+     * silence if there is no input.
+     *
+     * @param buffer    The read buffer to store the results
+     * @param frames    The maximum number of frames to read
+     *
+     * @return the actual number of frames read
+     */
+    virtual Uint32 read(float* buffer, Uint32 frames) override;
+
+    /**
+     * Returns true if this audio node has no more data.
+     *
+     * A dispatcher is completed when its input is completed (or missing).
+     *
+     * @return true if this audio node has no more data.
+     */
+    virtual bool completed() override;
+
+    /**
+     * Resets the read position to the marked position of the audio stream.
+     *
+     * DELEGATED METHOD: This method delegates its call to the input node.  It
+     * returns false if there is no input node or if this method is unsupported.
+     *
+     * @return true if the read position was moved.
+     */
+    virtual bool reset() override;
+};
+    }
+}
+
+#endif /* __CU_AUDIO_DISPATCHER_H__ */
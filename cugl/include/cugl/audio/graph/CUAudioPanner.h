@@ -80,6 +80,8 @@ private:
     std::shared_ptr<AudioNode> _input;
     /** The panning matrix */
     std::atomic<float>* _mapper;
+    /** A snapshot of the panning matrix for each read (AUDIO THREAD ONLY) */
+    float* _matrix;
 
 #pragma mark -
 #pragma mark Constructors
@@ -235,6 +235,12 @@ private:
     std::atomic<Uint32> _overlap;
     /** A buffer to handle the overlap (as necessary) */
     float* _buffer;
+    /** A node waiting to start a fixed number of frames from now */
+    std::shared_ptr<AudioNode> _pending;
+    /** The number of loops for the pending node */
+    Sint32 _pendloops;
+    /** The number of frames until the pending node starts */
+    Uint32 _delay;
 
     /** The queue of all sources waiting to be played next */
     AudioNodeQueue _queue;
@@ -524,7 +530,29 @@ public:
      * @param loop  The number of times to loop the audio
      */
     void setLoops(Sint32 loop);
-    
+
+    /**
+     * Plays the given audio node after a delay, interrupting the active node.
+     *
+     * AUDIO THREAD ONLY: Users should never access this method directly.
+     * It is used by {@link AudioDispatcher} to start a node at a precise
+     * frame of a read.  From the main thread, use {@link #play} instead.
+     *
+     * If the delay is 0, the node starts immediately.  Otherwise, the active
+     * node continues for delay more frames, and the next reads switch over
+     * at exactly that frame.  Only one node can wait at a time, so a second
+     * call before the switch replaces the waiting node.
+     *
+     * The interrupted node (if any) is reported to the callback function.
+     * Any nodes waiting in the queue are unaffected, and will play after
+     * this one.  The loop value works exactly as it does for {@link #play}.
+     *
+     * @param node  The audio node for playback
+     * @param loop  The number of times to loop the audio
+     * @param delay The number of frames to wait before playback
+     */
+    void start(const std::shared_ptr<AudioNode>& node, Sint32 loop = 0, Uint32 delay = 0);
+
     // TODO: Add cross-fade support
 
 
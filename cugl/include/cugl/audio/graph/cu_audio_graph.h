@@ -41,5 +41,6 @@
 #include "CUAudioPanner.h"
 #include "CUAudioSpinner.h"
 #include "CUAudioSynchronizer.h"
+#include "CUAudioDispatcher.h"
 
 #endif /* __CU_AUDIO_GRAPH_PKG_H__ */
@@ -136,4 +136,12 @@ TypeName(const TypeName &); \
 TypeName &operator =(const TypeName &);
 #endif
 
+// Count OpenGL calls in profiling and test builds
+#if defined (CU_GL_HEADLESS) && !defined (CU_GL_RECORD)
+    #define CU_GL_RECORD
+#endif
+#ifdef CU_GL_RECORD
+    #include <cugl/render/CUGLRecorder.h>
+#endif
+
 #endif /* __CU_BASE_H__ */
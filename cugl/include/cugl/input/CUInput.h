@@ -14,6 +14,11 @@
 //  the type id.  When the user requests a device, the type of the device is
 //  hashed to retrieve the singleton.
 //
+//  Pointer devices also keep a short history of timestamped samples.  This
+//  allows the game to "late-latch" input, pumping the event queue one more
+//  time immediately before the physics step, and to reason about when in the
+//  frame an event actually happened.
+//
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -41,15 +46,21 @@
 
 #include <cugl/base/CUBase.h>
 #include <cugl/util/CUTimestamp.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/math/CUVec2.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <typeindex>
+#include <array>
 
 #ifndef UINT32_MAX
 #define UINT32_MAX  (0xffffffff)
 #endif
 
+/** The number of samples kept in the history of a pointer device */
+#define CU_INPUT_HISTORY    32
+
 namespace cugl {
     
 class InputDevice;
@@ -280,6 +291,164 @@ public:
         return false;
     }
 
+#pragma mark Late Latching
+    /**
+     * Processes any pointer events that arrived since the start of the frame.
+     *
+     * Input is normally gathered once, at the start of the animation frame.
+     * An event that arrives while the frame is being updated must wait for the
+     * next frame.  This method pumps the SDL event queue again, and sends any
+     * pending mouse and touch events to the active devices, invoking their
+     * listeners immediately.  All other events are left in the queue for the
+     * next frame.
+     *
+     * The intended use is to call this method immediately before the physics
+     * step, so that the step sees the freshest possible pointer state.  This
+     * method does not clear the device state, so {@link InputDevice#clearState()}
+     * semantics are unchanged.  It must be called from the main thread.
+     *
+     * @return the number of pointer events processed.
+     */
+    static int latch();
+
+};
+
+
+#pragma mark -
+#pragma mark Input History
+/**
+ * This class is a single timestamped sample from a pointer device.
+ *
+ * Samples are recorded by the device as the events are processed, regardless
+ * of whether any listener is attached.  The id is device specific.  For the
+ * {@link Touchscreen} it is the touch id.  For the {@link Mouse} it is the
+ * SDL mouse instance id.
+ */
+class InputSample {
+public:
+    /** The kind of event that produced a sample */
+    enum class Type : int {
+        /** A finger or mouse button went down */
+        PRESS   = 0,
+        /** A finger or mouse moved */
+        MOTION  = 1,
+        /** A finger or mouse button was released */
+        RELEASE = 2
+    };
+
+    /** The kind of event that produced this sample */
+    Type type;
+    /** The device specific identifier of the pointer */
+    Uint64 id;
+    /** The pointer position in screen coordinates */
+    Vec2 position;
+    /** The event time in CUGL time */
+    Timestamp stamp;
+    /** The number of samples recorded by this device before this one */
+    Uint64 sequence;
+};
+
+/**
+ * This class is a fixed size ring buffer of {@link InputSample} objects.
+ *
+ * The history never allocates.  Once full, each new sample overwrites the
+ * oldest one.  Samples are indexed by age, so index 0 is always the newest
+ * sample.  The sequence number of a sample never repeats, so a client can
+ * record {@link getSequence()} and later ask for only the newer samples.
+ */
+class InputHistory {
+private:
+    /** The sample storage */
+    std::array<InputSample,CU_INPUT_HISTORY> _samples;
+    /** The number of samples ever recorded */
+    Uint64 _count;
+
+public:
+    /**
+     * Creates an empty history.
+     */
+    InputHistory() : _count(0) {}
+
+    /**
+     * Records a new sample, overwriting the oldest one if necessary.
+     *
+     * @param type      The kind of event
+     * @param id        The device specific pointer identifier
+     * @param position  The pointer position in screen coordinates
+     * @param stamp     The event time in CUGL time
+     */
+    void push(InputSample::Type type, Uint64 id, const Vec2& position, const Timestamp& stamp) {
+        InputSample& sample = _samples[_count % CU_INPUT_HISTORY];
+        sample.type = type;
+        sample.id = id;
+        sample.position = position;
+        sample.stamp = stamp;
+        sample.sequence = _count++;
+    }
+
+    /**
+     * Returns the number of samples currently available.
+     *
+     * @return the number of samples currently available.
+     */
+    size_t size() const {
+        return (size_t)(_count < CU_INPUT_HISTORY ? _count : CU_INPUT_HISTORY);
+    }
+
+    /**
+     * Returns true if no sample has been recorded.
+     *
+     * @return true if no sample has been recorded.
+     */
+    bool empty() const { return _count == 0; }
+
+    /**
+     * Returns the sequence number the next sample will have.
+     *
+     * This is also the number of samples ever recorded.
+     *
+     * @return the sequence number the next sample will have.
+     */
+    Uint64 getSequence() const { return _count; }
+
+    /**
+     * Returns the sample with the given age.
+     *
+     * Age 0 is the newest sample. The age must be less than {@link size()}.
+     *
+     * @param age   The sample age
+     *
+     * @return the sample with the given age.
+     */
+    const InputSample& get(size_t age) const {
+        CUAssertLog(age < size(), "Sample age %zu is out of range", age);
+        return _samples[(_count-1-age) % CU_INPUT_HISTORY];
+    }
+
+    /**
+     * Returns the newest sample, or nullptr if there is none.
+     *
+     * @return the newest sample, or nullptr if there is none.
+     */
+    const InputSample* latest() const {
+        return _count == 0 ? nullptr : &get(0);
+    }
+
+    /**
+     * Returns the number of available samples newer than the given sequence.
+     *
+     * The samples are those with age 0 up to (but not including) the value
+     * returned.  If the client fell more than {@link CU_INPUT_HISTORY} samples
+     * behind, the oldest samples are lost and only the available ones count.
+     *
+     * @param sequence  A value previously returned by {@link getSequence()}
+     *
+     * @return the number of available samples newer than the given sequence.
+     */
+    size_t since(Uint64 sequence) const {
+        Uint64 newer = (sequence < _count ? _count-sequence : 0);
+        return (size_t)(newer < size() ? newer : size());
+    }
 };
 
 
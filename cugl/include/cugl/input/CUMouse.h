@@ -544,6 +544,8 @@ protected:
 
     /** The amount of wheel movement this animation frame */
     Vec2 _wheelOffset;
+    /** The most recent pointer samples (across all frames) */
+    InputHistory _history;
     
     /** The set of listeners called whenever a mouse is pressed */
     std::unordered_map<Uint32, ButtonListener> _pressListeners;
@@ -670,6 +672,19 @@ public:
      * @return the amount the mouse wheel moved this animation frame.
      */
     Vec2 wheelDirection() const { return _wheelOffset; }
+
+    /**
+     * Returns the most recent timestamped pointer samples.
+     *
+     * Unlike the other polling methods, the history is not tied to the
+     * animation frame.  It holds the last {@link CU_INPUT_HISTORY} button and
+     * motion events, including any processed by {@link Input#latch()}.  Motion
+     * is recorded regardless of the pointer awareness.  Wheel events are not
+     * recorded.
+     *
+     * @return the most recent timestamped pointer samples.
+     */
+    const InputHistory& history() const { return _history; }
     
 #pragma mark Listeners
     /**
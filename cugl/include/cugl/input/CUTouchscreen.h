@@ -187,6 +187,8 @@ protected:
     std::unordered_map<TouchID,Vec2> _previous;
     /** The touch position for the previous animation frame */
     std::unordered_map<TouchID,Vec2> _current;
+    /** The most recent touch samples (across all frames) */
+    InputHistory _history;
     
     /** The set of listeners called whenever a touch begins */
     std::unordered_map<Uint32, ContactListener> _beginListeners;
@@ -305,6 +307,17 @@ public:
      * @return the set of identifiers for the fingers currently held down.
      */
     const std::vector<TouchID> touchSet() const;
+
+    /**
+     * Returns the most recent timestamped touch samples.
+     *
+     * Unlike the other polling methods, the history is not tied to the
+     * animation frame.  It holds the last {@link CU_INPUT_HISTORY} touch
+     * events (of any finger), including any processed by {@link Input#latch()}.
+     *
+     * @return the most recent timestamped touch samples.
+     */
+    const InputHistory& history() const { return _history; }
     
 #pragma mark Listeners
     /**
@@ -68,6 +68,16 @@ namespace  cugl {
  * confine all files to either the asset or the save directory.
  */
 class JsonReader : public TextReader {
+protected:
+    /**
+     * Loads the remainder of the stream into the read buffer.
+     *
+     * The parser needs the JSON text in one contiguous block.  Rather than
+     * refilling the buffer a chunk at a time, this method reads everything
+     * left in the stream with a single read.  Text after the JSON value is
+     * kept in the buffer, so later reads are unaffected.
+     */
+    void load();
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -159,7 +169,8 @@ public:
      *
      * If the first non-whitespace character is a brace, it will advance until
      * it reaches the matching brace, or the end of the file, whichever is first.
-     * If it finds no matching brace, it will fail.
+     * If it finds no matching brace, it will fail.  Braces inside of strings
+     * are ignored.
      *
      * @return the next available JSON string
      */
@@ -168,8 +179,9 @@ public:
     /**
      * Returns a newly allocated JsonValue for the next available JSON string.
      * 
-     * This method uses {@link readJsonString()} to extract the next available
-     * JSON string and constructs a JsonValue from that.
+     * This method parses the JSON value directly from the read buffer, without
+     * extracting it as a string first.  The read head is left just after the
+     * value.
      *
      * If there is a parsing error, this  method will return nullptr.  Detailed
      * information about the parsing error will be passed to an assert.  Hence
@@ -0,0 +1,272 @@
+//
+//  CUSpatialGrid.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a uniform grid for proximity queries on moving
+//  points.  Scanning every entity to find those near a point is quadratic
+//  when every entity asks the question.  This class buckets the points by
+//  grid cell so that a radius or nearest neighbor query only visits the
+//  cells around it.  The cells are hashed into a fixed table, so the grid
+//  has no bounds, and it is stored in two flat arrays so that a rebuild is
+//  a single counting sort.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_SPATIAL_GRID_H__
+#define __CU_SPATIAL_GRID_H__
+
+#include <cugl/math/CUVec2.h>
+#include <vector>
+#include <cfloat>
+
+/** The default width and height of a grid cell */
+#define CU_SPATIAL_GRID_CELL    4.0f
+
+namespace cugl {
+
+/**
+ * This class answers proximity queries on a set of points.
+ *
+ * The points are identified by their position in the vector given to
+ * {@link build}, so they are typically the positions of the entities in a
+ * contiguous array. The grid keeps a copy of the points, not a reference to
+ * them. If the points move (such as after a physics step), or entities are
+ * added or removed, the grid must be built again. A build is linear in the
+ * number of points.
+ *
+ * The grid supports radius queries, nearest neighbor queries and k-nearest
+ * queries. Distance ties are always broken by the lower index, so that a
+ * query gives the same answer as a linear scan in index order. A query that
+ * would visit more cells than there are points falls back to such a scan.
+ *
+ * The cell size should be on the order of the typical query radius. This
+ * class is not thread safe, though it is safe for several threads to query
+ * it at once.
+ */
+class SpatialGrid {
+#pragma mark Values
+private:
+    /** A point in the grid, stored with its cell */
+    struct Item {
+        /** The point position */
+        Vec2 point;
+        /** The cell column */
+        Sint32 x;
+        /** The cell row */
+        Sint32 y;
+        /** The point index */
+        Uint32 index;
+    };
+
+    /** The width and height of a cell */
+    float _cellSize;
+    /** The reciprocal of the cell size */
+    float _cellInverse;
+    /** The first item of each bucket (one extra at the end) */
+    std::vector<Uint32> _buckets;
+    /** The points, sorted by bucket */
+    std::vector<Item> _items;
+    /** The bucket count minus one (the bucket count is a power of two) */
+    Uint32 _mask;
+    /** The smallest cell column holding a point */
+    Sint32 _minX;
+    /** The smallest cell row holding a point */
+    Sint32 _minY;
+    /** The largest cell column holding a point */
+    Sint32 _maxX;
+    /** The largest cell row holding a point */
+    Sint32 _maxY;
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Returns the bucket of the given cell
+     *
+     * @param x The cell column
+     * @param y The cell row
+     *
+     * @return the bucket of the given cell
+     */
+    Uint32 bucket(Sint32 x, Sint32 y) const {
+        return (((Uint32)x*73856093u) ^ ((Uint32)y*19349663u)) & _mask;
+    }
+
+    /**
+     * Returns the cell coordinate of the given position coordinate
+     *
+     * @param value The position coordinate
+     *
+     * @return the cell coordinate of the given position coordinate
+     */
+    Sint32 cell(float value) const;
+
+    /**
+     * Returns the number of rings around the given cell that hold points
+     *
+     * A query centered in this cell need never look past this ring.
+     *
+     * @param x The cell column
+     * @param y The cell row
+     *
+     * @return the number of rings around the given cell that hold points
+     */
+    Sint32 extent(Sint32 x, Sint32 y) const;
+
+    /**
+     * Returns true if a query of the given cell span should scan all points
+     *
+     * @param span  The width (and height) of the query in cells
+     *
+     * @return true if a query of the given cell span should scan all points
+     */
+    bool scans(Sint64 span) const {
+        return span*span > 4*(Sint64)_items.size();
+    }
+
+    /**
+     * Offers every point that may be nearest to the given point to the visitor.
+     *
+     * The cells are visited in rings of increasing distance. The visitor has a
+     * method consider(dist,index), taking the squared distance and index of a
+     * point within radius, and a method done(bound), returning true if no point
+     * at squared distance bound or more can improve the result.
+     *
+     * @param point     The query point
+     * @param radius    The largest distance to consider
+     * @param visitor   The visitor collecting the result
+     */
+    template <typename Visitor>
+    void search(const Vec2 point, float radius, Visitor& visitor) const;
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an empty grid with the default cell size
+     */
+    SpatialGrid() : SpatialGrid(CU_SPATIAL_GRID_CELL) {}
+
+    /**
+     * Creates an empty grid with the given cell size
+     *
+     * @param size  The width and height of a cell
+     */
+    SpatialGrid(float size);
+
+    /**
+     * Deletes this grid, releasing all resources.
+     */
+    ~SpatialGrid() {}
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the width and height of a cell
+     *
+     * @return the width and height of a cell
+     */
+    float getCellSize() const { return _cellSize; }
+
+    /**
+     * Sets the width and height of a cell
+     *
+     * Changing the cell size clears the grid.
+     *
+     * @param size  The width and height of a cell
+     */
+    void setCellSize(float size);
+
+    /**
+     * Returns the number of points in this grid
+     *
+     * @return the number of points in this grid
+     */
+    size_t size() const { return _items.size(); }
+
+#pragma mark -
+#pragma mark Construction
+    /**
+     * Removes all points from this grid
+     */
+    void clear();
+
+    /**
+     * Replaces the points of this grid with the given points
+     *
+     * Every later query refers to a point by its position in this vector.
+     *
+     * @param points    The points to store
+     */
+    void build(const std::vector<Vec2>& points);
+
+#pragma mark -
+#pragma mark Queries
+    /**
+     * Appends the indices of all points within radius of center.
+     *
+     * A point is within radius if its distance to center is strictly less
+     * than radius. The indices are appended in no particular order.
+     *
+     * @param center    The query center
+     * @param radius    The query radius
+     * @param result    The vector to store the indices
+     *
+     * @return the number of indices appended
+     */
+    size_t query(const Vec2 center, float radius, std::vector<Uint32>& result) const;
+
+    /**
+     * Returns the index of the point nearest to the given point.
+     *
+     * Only points strictly within radius are considered. Ties are broken
+     * by the lower index. If there is no such point, this method returns -1.
+     *
+     * @param point     The query point
+     * @param radius    The largest distance to consider
+     *
+     * @return the index of the point nearest to the given point.
+     */
+    Sint32 nearest(const Vec2 point, float radius=FLT_MAX) const;
+
+    /**
+     * Appends the indices of the k points nearest to the given point.
+     *
+     * Only points strictly within radius are considered, so fewer than k
+     * indices may be appended. The indices are appended in order of
+     * increasing distance, with ties broken by the lower index.
+     *
+     * @param point     The query point
+     * @param k         The number of points to find
+     * @param result    The vector to store the indices
+     * @param radius    The largest distance to consider
+     *
+     * @return the number of indices appended
+     */
+    size_t nearest(const Vec2 point, size_t k, std::vector<Uint32>& result, float radius=FLT_MAX) const;
+};
+
+}
+
+#endif /* __CU_SPATIAL_GRID_H__ */
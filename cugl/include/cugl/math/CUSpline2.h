@@ -113,6 +113,14 @@ private:
      */
     bool _closed;
     
+    /**
+     * The version of the control points.
+     *
+     * This changes whenever the spline is modified, so that approximations
+     * of the spline may be cached.
+     */
+    Uint64 _version;
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -122,7 +130,7 @@ public:
      *
      * This is a degenerate spline with no control points; it is open.
      */
-    Spline2() : _size(0), _closed(false) {   }
+    Spline2() : _size(0), _closed(false), _version(nextVersion()) {   }
     
     /**
      * Creates a degenerate spline of one point
@@ -214,7 +222,8 @@ public:
      * @param  spline   The spline to take from
      */
     Spline2(Spline2&& spline) : _size(spline._size), _closed(spline._closed),
-        _points(std::move(spline._points)), _smooth(std::move(spline._smooth)) {}
+        _points(std::move(spline._points)), _smooth(std::move(spline._smooth)),
+        _version(nextVersion()) { spline._version = nextVersion(); }
     
     /**
      * Deletes this spline, releasing all resources
@@ -243,6 +252,7 @@ public:
         _size = spline._size; _closed = spline._closed;
         _points = std::move(spline._points);
         _smooth = std::move(spline._smooth);
+        _version = nextVersion(); spline._version = nextVersion();
         return *this;
     }
     
@@ -371,6 +381,17 @@ public:
      */
     bool isClosed() const { return _closed; }
     
+    /**
+     * Returns the version of this spline.
+     *
+     * The version changes whenever the spline is modified. No two spline
+     * states share a version, even across different splines, so a cached
+     * approximation is valid as long as the version is unchanged.
+     *
+     * @return the version of this spline
+     */
+    Uint64 getVersion() const { return _version; }
+    
     /**
      * Sets whether the spline is closed.
      *
@@ -668,6 +689,7 @@ public:
     void clear() {
         _points.clear(); _smooth.clear();
         _closed = false; _size = 0;
+        _version = nextVersion();
     }
     
 #pragma mark -
@@ -736,6 +758,17 @@ public:
 #pragma mark -
 #pragma mark Internal Helpers
 protected:
+    /**
+     * Returns a version number never returned before.
+     *
+     * Versions are shared by all splines, so no two spline states ever have
+     * the same version, even across different splines. This method is thread
+     * safe.
+     *
+     * @return a version number never returned before.
+     */
+    static Uint64 nextVersion();
+    
     /**
      * Returns the spline point for parameter tp.
      *
@@ -875,6 +908,7 @@ protected:
     Vec2 getProjectionFast(const Vec2 point, int segment) const;
   
     friend class PolySplineFactory;
+    friend class SplineFlattener;
 };
 
 }
@@ -48,6 +48,7 @@
 #include "CUFrustum.h"
 #include "CUEasingFunction.h"
 #include "CUEasingBezier.h"
+#include "CUSpatialGrid.h"
 
 // And sublibraries
 #include "polygon/cu_polygon.h"
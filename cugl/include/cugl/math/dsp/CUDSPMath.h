@@ -165,6 +165,110 @@ public:
      */
     static size_t slide_add(float* input1, float* input2, float start, float end, float* output, size_t size);
 
+#pragma mark Ramp Methods
+    /**
+     * Scales an interleaved input signal by a gain ramp, storing the result in output
+     *
+     * Unlike {@link slide}, the gain changes per frame, not per element, so
+     * every channel of a frame is scaled by the same amount.  The gain for
+     * frame k is start+k*step.  So a fade-in over n frames has step 1/n, and a
+     * fade-out has step -1/n.  The caller computes the increment once, and
+     * there is no division in the loop.
+     *
+     * The vectorized version requires that the number of channels divide 4
+     * (e.g. mono, stereo or quadraphonic).  Other layouts use the scalar loop.
+     *
+     * It is safe for output to be the same as the input buffer.
+     *
+     * @param input     The input buffer
+     * @param channels  The number of interleaved channels
+     * @param start     The gain for the first frame
+     * @param step      The gain increment per frame
+     * @param output    The output buffer
+     * @param frames    The number of frames to process
+     *
+     * @return the number of frames successfully processed
+     */
+    static size_t ramp(const float* input, Uint32 channels, float start, float step,
+                       float* output, size_t frames);
+
+    /**
+     * Linearly crossfades two interleaved input signals, storing the result in output
+     *
+     * The gain g for frame k is start+k*step.  The first input is scaled by g
+     * and the second by 1-g.  So a fade from input1 to input2 over n frames
+     * has start 1 and step -1/n.  Every channel of a frame has the same gain.
+     *
+     * The vectorized version requires that the number of channels divide 4.
+     * Other layouts use the scalar loop.
+     *
+     * It is safe for output to be the same as one of the two input buffers.
+     *
+     * @param input1    The first input buffer
+     * @param input2    The second input buffer
+     * @param channels  The number of interleaved channels
+     * @param start     The gain of input1 for the first frame
+     * @param step      The gain increment per frame
+     * @param output    The output buffer
+     * @param frames    The number of frames to process
+     *
+     * @return the number of frames successfully processed
+     */
+    static size_t crossfade(const float* input1, const float* input2, Uint32 channels,
+                            float start, float step, float* output, size_t frames);
+
+    /**
+     * Crossfades two interleaved input signals at equal power, storing the result in output
+     *
+     * This is the same as {@link crossfade}, except that input1 is scaled by
+     * sqrt(g) and input2 by sqrt(1-g).  The squares of the gains sum to 1, so
+     * two uncorrelated signals keep a constant loudness through the fade.
+     * The value g is clamped to [0,1].
+     *
+     * The vectorized version requires that the number of channels divide 4.
+     * Other layouts use the scalar loop.
+     *
+     * It is safe for output to be the same as one of the two input buffers.
+     *
+     * @param input1    The first input buffer
+     * @param input2    The second input buffer
+     * @param channels  The number of interleaved channels
+     * @param start     The value g for the first frame
+     * @param step      The increment of g per frame
+     * @param output    The output buffer
+     * @param frames    The number of frames to process
+     *
+     * @return the number of frames successfully processed
+     */
+    static size_t crossfade_power(const float* input1, const float* input2, Uint32 channels,
+                                  float start, float step, float* output, size_t frames);
+
+#pragma mark Channel Methods
+    /**
+     * Maps an interleaved input signal onto new channels, storing the result in output
+     *
+     * The matrix is field x channels, in row-major order.  Output channel j of
+     * a frame is the sum over input channels i of the input times the value
+     * matrix[i*channels+j].
+     *
+     * The vectorized version supports mono and stereo input to stereo output,
+     * the only layouts that the audio engine uses.  Other layouts use the
+     * scalar loop.
+     *
+     * It is NOT safe for output to be the same as the input buffer.
+     *
+     * @param input     The input buffer
+     * @param field     The number of input channels
+     * @param matrix    The field x channels pan matrix
+     * @param channels  The number of output channels
+     * @param output    The output buffer
+     * @param frames    The number of frames to process
+     *
+     * @return the number of frames successfully processed
+     */
+    static size_t pan(const float* input, Uint32 field, const float* matrix, Uint32 channels,
+                      float* output, size_t frames);
+
 #pragma mark Clamp Methods
     /**
      * Hard clamps the data stream to the range [min,max]
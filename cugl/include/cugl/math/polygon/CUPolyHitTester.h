@@ -0,0 +1,340 @@
+//
+//  CUPolyHitTester.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a batch point-in-polygon tester.  Poly2::contains
+//  tests one point at a time, walking the polygon edges (or triangles) on
+//  every call.  This class flattens the edges of one or more polygons into a
+//  precomputed table, stored as structure-of-arrays so that the crossing test
+//  runs four edges (or four points) at a time with SSE or Neon.  Polygons with
+//  many edges are also split into horizontal slabs, so that a point is only
+//  tested against the edges that can cross its ray.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_POLY_HIT_TESTER_H__
+#define __CU_POLY_HIT_TESTER_H__
+
+#include <cugl/math/CUPoly2.h>
+#include <cugl/math/CUVec2.h>
+#include <vector>
+
+/** The default number of edges at which a polygon is split into slabs */
+#define CU_HIT_GRID_THRESHOLD   32
+
+namespace cugl {
+
+/**
+ * This class tests points for containment in a set of polygons.
+ *
+ * Each polygon added to this tester is flattened into an edge table. Tests
+ * use the same even-odd crossing rule as {@link Poly2#contains}, and agree
+ * with it except for points within rounding error of the boundary. SOLID
+ * polygons are tested with the edges of their triangulation (interior edges
+ * cancel out under the even-odd rule), so a mesh without overlapping
+ * triangles gives the same answer as the barycentric test. The boundary of
+ * every polygon must be closed, as is the case for any outline.
+ *
+ * The tester supports two batch queries: many points against one polygon,
+ * and one point against many polygons. The first tests four points at once,
+ * while the second rejects polygons four bounding boxes at a time. A polygon
+ * with at least {@link getGridThreshold} edges is divided into horizontal
+ * slabs, each holding the edges that overlap it. A point then only checks
+ * the edges of its slab.
+ *
+ * The tester keeps a copy of the edges, not a reference to the polygons. If
+ * a polygon changes, it must be added again. This class is not thread safe,
+ * though it is safe for several threads to query it at once.
+ */
+class PolyHitTester {
+#pragma mark Values
+private:
+    /** The edges (or slab) of a single polygon */
+    struct Shape {
+        /** The position of the first edge in the table */
+        Uint32 start;
+        /** The number of edges in the table (padded to a multiple of 4) */
+        Uint32 count;
+        /** The position of the first slab (if the shape has slabs) */
+        Uint32 slab;
+        /** The number of slabs (0 if the shape is not split) */
+        Uint32 slabs;
+        /** The bottom of the shape bounding box */
+        float bottom;
+        /** The number of slabs per unit of height */
+        float density;
+    };
+
+    /** A range of edges in the table */
+    struct Range {
+        /** The position of the first edge in the table */
+        Uint32 start;
+        /** The number of edges in the table (padded to a multiple of 4) */
+        Uint32 count;
+    };
+
+    /** The minimum y-coordinate of each edge */
+    std::vector<float> _ymin;
+    /** The maximum y-coordinate of each edge */
+    std::vector<float> _ymax;
+    /** The x-coordinate of the first edge vertex */
+    std::vector<float> _x1;
+    /** The y-coordinate of the first edge vertex */
+    std::vector<float> _y1;
+    /** The inverse slope (dx/dy) of each edge */
+    std::vector<float> _slope;
+
+    /** The shapes, in the order added */
+    std::vector<Shape> _shapes;
+    /** The slabs of all split shapes */
+    std::vector<Range> _slabs;
+
+    /** The minimum x-coordinate of each shape (padded to a multiple of 4) */
+    std::vector<float> _minx;
+    /** The minimum y-coordinate of each shape (padded to a multiple of 4) */
+    std::vector<float> _miny;
+    /** The maximum x-coordinate of each shape (padded to a multiple of 4) */
+    std::vector<float> _maxx;
+    /** The maximum y-coordinate of each shape (padded to a multiple of 4) */
+    std::vector<float> _maxy;
+
+    /** The number of edges at which a shape is split into slabs */
+    Uint32 _threshold;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a tester with no polygons.
+     */
+    PolyHitTester() : _threshold(CU_HIT_GRID_THRESHOLD) {}
+
+    /**
+     * Creates a tester with the given polygon.
+     *
+     * The polygon will have index 0. The edges are copied, and the tester
+     * does not retain any references to the original data.
+     *
+     * @param poly  The polygon to test against
+     */
+    PolyHitTester(const Poly2& poly) : _threshold(CU_HIT_GRID_THRESHOLD) { add(poly); }
+
+    /**
+     * Deletes this tester, releasing all resources.
+     */
+    ~PolyHitTester() {}
+
+#pragma mark -
+#pragma mark Initialization
+    /**
+     * Sets this tester to contain only the given polygon.
+     *
+     * The polygon will have index 0. The edges are copied, and the tester
+     * does not retain any references to the original data.
+     *
+     * @param poly  The polygon to test against
+     */
+    void set(const Poly2& poly) {
+        clear();
+        add(poly);
+    }
+
+    /**
+     * Adds the given polygon to this tester, returning its index.
+     *
+     * Indices are assigned in the order that polygons are added, starting at
+     * 0. The edges are copied, and the tester does not retain any references
+     * to the original data. A polygon with POINTS geometry has no edges,
+     * and so never contains a point.
+     *
+     * @param poly  The polygon to test against
+     *
+     * @return the index of the polygon in this tester
+     */
+    Uint32 add(const Poly2& poly);
+
+    /**
+     * Removes all polygons from this tester.
+     *
+     * The grid threshold is unchanged.
+     */
+    void clear();
+
+    /**
+     * Returns the number of polygons in this tester.
+     *
+     * @return the number of polygons in this tester.
+     */
+    size_t size() const { return _shapes.size(); }
+
+    /**
+     * Returns the number of edges at which a polygon is split into slabs.
+     *
+     * @return the number of edges at which a polygon is split into slabs.
+     */
+    Uint32 getGridThreshold() const { return _threshold; }
+
+    /**
+     * Sets the number of edges at which a polygon is split into slabs.
+     *
+     * This only affects polygons added after the call. A value of 0 turns
+     * off slabs entirely.
+     *
+     * @param edges The number of edges at which a polygon is split
+     */
+    void setGridThreshold(Uint32 edges) { _threshold = edges; }
+
+#pragma mark -
+#pragma mark Queries
+    /**
+     * Returns true if the given polygon contains the point.
+     *
+     * @param index The polygon index
+     * @param point The point to test
+     *
+     * @return true if the given polygon contains the point.
+     */
+    bool contains(Uint32 index, const Vec2 point) const;
+
+    /**
+     * Tests each point for containment in the given polygon.
+     *
+     * The results array must have room for count values. Each value is 1 if
+     * the point is in the polygon and 0 otherwise.
+     *
+     * @param index     The polygon index
+     * @param points    The points to test
+     * @param count     The number of points
+     * @param results   The array to store the results
+     *
+     * @return the number of points in the polygon
+     */
+    size_t contains(Uint32 index, const Vec2* points, size_t count, Uint8* results) const;
+
+    /**
+     * Tests each point for containment in the given polygon.
+     *
+     * The results vector is resized to match the points. Each value is 1 if
+     * the point is in the polygon and 0 otherwise.
+     *
+     * @param index     The polygon index
+     * @param points    The points to test
+     * @param results   The vector to store the results
+     *
+     * @return the number of points in the polygon
+     */
+    size_t contains(Uint32 index, const std::vector<Vec2>& points, std::vector<Uint8>& results) const {
+        results.resize(points.size());
+        return contains(index, points.data(), points.size(), results.data());
+    }
+
+    /**
+     * Returns the index of the first polygon containing the point.
+     *
+     * If no polygon contains the point, this method returns -1.
+     *
+     * @param point The point to test
+     *
+     * @return the index of the first polygon containing the point.
+     */
+    Sint32 find(const Vec2 point) const;
+
+    /**
+     * Appends the index of every polygon containing the point.
+     *
+     * The indices are appended in increasing order. The vector is not
+     * cleared first.
+     *
+     * @param point     The point to test
+     * @param indices   The vector to store the indices
+     *
+     * @return the number of polygons containing the point
+     */
+    size_t findAll(const Vec2 point, std::vector<Uint32>& indices) const;
+
+private:
+    /**
+     * Appends an edge to the edge table.
+     *
+     * Horizontal edges are skipped, as they can never cross a ray.
+     *
+     * @param v1    The first edge vertex
+     * @param v2    The second edge vertex
+     */
+    void pushEdge(const Vec2 v1, const Vec2 v2);
+
+    /**
+     * Pads the edge table with empty edges to a multiple of 4.
+     *
+     * Empty edges have an empty y-range, and so never cross a ray.
+     */
+    void padEdges();
+
+    /**
+     * Splits the edges of the given shape into slabs.
+     *
+     * The slab edges are copies appended to the end of the edge table.
+     *
+     * @param shape The shape to split
+     * @param top   The top of the shape bounding box
+     */
+    void makeSlabs(Shape& shape, float top);
+
+    /**
+     * Returns the edges of the shape that can cross a ray at height y.
+     *
+     * @param shape The shape to test
+     * @param y     The ray height
+     *
+     * @return the edges of the shape that can cross a ray at height y.
+     */
+    Range getEdges(const Shape& shape, float y) const;
+
+    /**
+     * Returns true if the point crosses an odd number of edges in the range.
+     *
+     * @param range The edges to test
+     * @param x     The x-coordinate of the point
+     * @param y     The y-coordinate of the point
+     *
+     * @return true if the point crosses an odd number of edges in the range.
+     */
+    bool crosses(const Range& range, float x, float y) const;
+
+    /**
+     * Tests four points against all edges in the range.
+     *
+     * The results are stored in the first four values of results.
+     *
+     * @param range     The edges to test
+     * @param points    The four points to test
+     * @param results   The array to store the results
+     */
+    void crosses4(const Range& range, const Vec2* points, Uint8* results) const;
+};
+
+}
+
+#endif /* __CU_POLY_HIT_TESTER_H__ */
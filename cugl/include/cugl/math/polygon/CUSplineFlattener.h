@@ -0,0 +1,304 @@
+//
+//  CUSplineFlattener.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a lightweight alternative to PolySplineFactory for turning a
+//  spline into a polyline.  Instead of recursive subdivision, each bezier is
+//  sampled uniformly with forward differencing, and the number of samples is
+//  bounded in advance by Wang's formula.  All points are written into buffers
+//  that are reused between calculations, and the result is cached until the
+//  spline changes.  The flattened polyline also supports nearest point queries
+//  through a bounding volume hierarchy over its segments.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_SPLINE_FLATTENER_H__
+#define __CU_SPLINE_FLATTENER_H__
+
+#include <cugl/math/CUSpline2.h>
+#include <cugl/math/CUPoly2.h>
+#include <cugl/math/CUVec2.h>
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is a factory for producing polylines from a Spline2.
+ *
+ * Each bezier segment is divided into n equal parameter steps, where n is
+ * computed with Wang's formula. This guarantees that the polyline is within
+ * the tolerance of the true curve, without any recursion or intermediate
+ * buffers. Straight segments (such as those with degenerate tangents) are
+ * never subdivided. The points are then evaluated with forward differencing,
+ * which takes three vector additions per point.
+ *
+ * As with all factories, the methods are broken up into three phases:
+ * initialization, calculation, and materialization.  To use the factory, you
+ * first set the spline with the initialization methods.  You then call the
+ * calculation method.  Finally, you use the materialization methods to access
+ * the data in several different ways.
+ *
+ * Unlike the other factories, the calculation is cached. Calling calculate
+ * again does nothing unless the spline (as determined by its version) or the
+ * tolerance have changed. Hence it is safe to call calculate every frame.
+ *
+ * This factory keeps a pointer to the spline, and it is unsafe to modify the
+ * spline while the calculation is ongoing.
+ */
+class SplineFlattener {
+#pragma mark Values
+private:
+    /** A node in the segment hierarchy */
+    struct Node {
+        /** The minimum x-coordinate of the node bounds */
+        float minx;
+        /** The minimum y-coordinate of the node bounds */
+        float miny;
+        /** The maximum x-coordinate of the node bounds */
+        float maxx;
+        /** The maximum y-coordinate of the node bounds */
+        float maxy;
+        /** The first segment (if a leaf) or the right child (otherwise) */
+        Uint32 index;
+        /** The number of segments (0 if not a leaf) */
+        Uint32 count;
+    };
+
+    /** A pointer to the spline data */
+    const Spline2* _spline;
+    /** The spline version of the cached calculation */
+    Uint64 _version;
+    /** The tolerance of the cached calculation */
+    float _tolerance;
+    /** The polyline vertices (the last is the first if closed) */
+    std::vector<Vec2> _points;
+    /** The spline parameter of each vertex */
+    std::vector<float> _params;
+    /** The number of steps for each bezier segment */
+    std::vector<Uint32> _steps;
+    /** The segment hierarchy (the root is the first node) */
+    std::vector<Node> _nodes;
+    /** Whether the approximation curve is closed */
+    bool _closed;
+    /** Whether or not the calculation has been run */
+    bool _calculated;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a spline flattener with no spline data.
+     */
+    SplineFlattener() : _spline(nullptr), _version(0), _tolerance(0), _closed(false), _calculated(false) {}
+
+    /**
+     * Creates a spline flattener with the given spline as its initial data.
+     *
+     * @param spline    The spline to approximate
+     */
+    SplineFlattener(const Spline2* spline) : SplineFlattener() { set(spline); }
+
+    /**
+     * Deletes this spline flattener, releasing all resources.
+     */
+    ~SplineFlattener() {}
+
+#pragma mark -
+#pragma mark Initialization
+    /**
+     * Sets the given spline as the data for this flattener.
+     *
+     * The cached calculation is kept if this is the same spline as before.
+     * It is only recomputed if the spline version changes.
+     *
+     * @param spline    The spline to approximate
+     */
+    void set(const Spline2* spline) {
+        if (_spline != spline) {
+            _spline = spline;
+            _calculated = false;
+        }
+    }
+
+    /**
+     * Clears all internal data, including the cache.
+     *
+     * The spline is kept, so the calculation may be run again. The buffers
+     * keep their capacity for the next calculation.
+     */
+    void reset() {
+        _points.clear();
+        _params.clear();
+        _nodes.clear();
+        _calculated = false;
+    }
+
+    /**
+     * Clears all internal data, including the spline data.
+     */
+    void clear() {
+        reset();
+        _spline = nullptr;
+    }
+
+#pragma mark -
+#pragma mark Calculation
+    /**
+     * Returns the number of steps needed to flatten a single bezier.
+     *
+     * This is Wang's formula for cubic beziers. If the bezier is divided into
+     * this many equal parameter steps, every point on the curve is within
+     * tolerance of the polyline. The result is at least 1.
+     *
+     * @param p         The four control points of the bezier
+     * @param tolerance The maximum distance from the polyline to the curve
+     *
+     * @return the number of steps needed to flatten a single bezier.
+     */
+    static Uint32 getSteps(const Vec2* p, float tolerance);
+
+    /**
+     * Flattens the current spline into a polyline.
+     *
+     * Each bezier is sampled at the number of steps given by {@link getSteps}.
+     * If neither the spline nor the tolerance have changed since the last
+     * call, this method does nothing and returns false.
+     *
+     * The calculation uses a reference to the spline; it does not copy it.
+     * Hence this method is not thread-safe.
+     *
+     * @param tolerance The maximum distance from the polyline to the curve
+     *
+     * @return true if the polyline was recomputed
+     */
+    bool calculate(float tolerance);
+
+    /**
+     * Returns true if the cached polyline matches the current spline.
+     *
+     * @return true if the cached polyline matches the current spline.
+     */
+    bool isCalculated() const {
+        return _calculated && _spline && _spline->getVersion() == _version;
+    }
+
+#pragma mark -
+#pragma mark Materialization
+    /**
+     * Returns the vertices of the polyline.
+     *
+     * If the spline is closed, the last vertex is the same as the first.
+     *
+     * @return the vertices of the polyline.
+     */
+    const std::vector<Vec2>& getPoints() const { return _points; }
+
+    /**
+     * Returns the spline parameter of each polyline vertex.
+     *
+     * @return the spline parameter of each polyline vertex.
+     */
+    const std::vector<float>& getParameters() const { return _params; }
+
+    /**
+     * Returns a new polygon approximating this spline.
+     *
+     * The Poly2 indices will define a path traversing the vertices of the
+     * polygon, exactly as {@link PolySplineFactory#getPath}. The indices
+     * will define a closed path if the spline is itself closed, and an
+     * open path otherwise.
+     *
+     * @return a new polygon approximating this spline.
+     */
+    Poly2 getPath() const;
+
+    /**
+     * Stores vertex information approximating this spline in the buffer.
+     *
+     * The Poly2 indices will define a path traversing the vertices of the
+     * polygon, exactly as {@link PolySplineFactory#getPath}.
+     *
+     * The vertices (and indices) will be appended to the the Poly2 if it is
+     * not empty. You should clear the Poly2 first if you do not want to
+     * preserve the original data.
+     *
+     * @param buffer    The buffer to store the vertex data
+     *
+     * @return a reference to the buffer for chaining.
+     */
+    Poly2* getPath(Poly2* buffer) const;
+
+#pragma mark -
+#pragma mark Nearest Point
+    /**
+     * Returns the nearest point on the polyline to the given point.
+     *
+     * The result is within the calculation tolerance of the nearest point on
+     * the spline. If param is not null, it stores the spline parameter of the
+     * result, interpolated from the vertex parameters.
+     *
+     * The query uses the segment hierarchy, so it is logarithmic in the size
+     * of the polyline for most inputs.
+     *
+     * @param point The point to project
+     * @param param Pointer to store the spline parameter (may be null)
+     *
+     * @return the nearest point on the polyline to the given point.
+     */
+    Vec2 nearestPoint(const Vec2 point, float* param=nullptr) const;
+
+    /**
+     * Returns the spline parameter of the nearest point to the given point.
+     *
+     * This is a fast, approximate version of {@link Spline2#nearestParameter}.
+     *
+     * @param point The point to project
+     *
+     * @return the spline parameter of the nearest point to the given point.
+     */
+    float nearestParameter(const Vec2 point) const {
+        float result = -1;
+        nearestPoint(point,&result);
+        return result;
+    }
+
+private:
+    /**
+     * Builds the segment hierarchy for the given range of segments.
+     *
+     * The nodes are stored in depth-first order, so the left child of a node
+     * immediately follows it.
+     *
+     * @param start The first segment
+     * @param count The number of segments
+     *
+     * @return the index of the new node
+     */
+    Uint32 buildNodes(Uint32 start, Uint32 count);
+};
+
+}
+
+#endif /* __CU_SPLINE_FLATTENER_H__ */
@@ -31,9 +31,11 @@
 #include "CUPolyEnums.h"
 #include "CUPolyFactory.h"
 #include "CUPolySplineFactory.h"
+#include "CUSplineFlattener.h"
 #include "CUSimpleExtruder.h"
 #include "CUComplexExtruder.h"
 #include "CUSimpleTriangulator.h"
+#include "CUPolyHitTester.h"
 #include "CUComplexTriangulator.h"
 #include "CUPathSmoother.h"
 
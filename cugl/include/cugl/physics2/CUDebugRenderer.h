@@ -0,0 +1,482 @@
+//
+//  CUDebugRenderer.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an immediate-mode wireframe renderer for a Box2D world.
+//  The debug wireframes of an Obstacle are scene graph nodes, one per obstacle
+//  (and more for obstacles with several fixtures). That is fine for a handful
+//  of obstacles, but on large levels the cost of traversing and drawing all of
+//  those nodes dominates the frame. This class instead reads the fixtures
+//  straight from the world each frame, culls them with the broadphase, and
+//  gathers every outline into a single mesh that is drawn with one call to
+//  SpriteBatch::outline.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_DEBUG_RENDERER_H__
+#define __CU_DEBUG_RENDERER_H__
+
+#include <Box2D/Dynamics/b2World.h>
+#include <cugl/render/CUMesh.h>
+#include <cugl/render/CUSpriteVertex.h>
+#include <cugl/render/CUSpriteBatch.h>
+#include <cugl/math/CUColor4.h>
+#include <cugl/math/CURect.h>
+#include <vector>
+
+/** The default number of segments in a debug circle */
+#define DEBUG_CIRCLE_SEGMENTS   16
+/** The default size (in physics units) of a contact point marker */
+#define DEBUG_CONTACT_SIZE      0.1f
+
+namespace cugl {
+    /**
+     * The classes to represent 2-d physics.
+     *
+     * This namespace was chosen to future-proof the game engine. We will
+     * eventually want to add a 3-d physics engine as well, and this namespace
+     * will prevent any collisions with those scene graph nodes.
+     */
+    namespace physics2 {
+
+#pragma mark -
+#pragma mark Debug Renderer
+/**
+ * An immediate-mode wireframe renderer for a Box2D world.
+ *
+ * Each call to {@link update} queries the world broadphase for the proxies
+ * overlapping the view, and appends the outline of each proxy to a single
+ * GL_LINES mesh. Fixtures outside of the view are never visited. Circles
+ * are instances of a precomputed unit circle, while polygons, edges and
+ * chains are transformed directly from their shape vertices. The mesh is
+ * then drawn by {@link draw} with a single outline call, so the cost of
+ * debug mode is one pass over the visible fixtures, no matter how many
+ * obstacles there are.
+ *
+ * Fixtures are colored by their body state: static, kinematic, dynamic
+ * (awake) and sleeping. Sensors have their own color. The renderer can also
+ * show the fixture bounding boxes, the fat bounding boxes of the broadphase
+ * proxies, and the points and normals of the touching contacts.
+ *
+ * The mesh is in physics coordinates. The transform passed to {@link draw}
+ * should map these coordinates to the world coordinates of the sprite batch.
+ */
+class DebugRenderer {
+private:
+    /** The broadphase query callback (defined in the implementation) */
+    struct Query;
+
+protected:
+    /** The wireframe mesh (in physics coordinates) */
+    Mesh<SpriteVertex2> _mesh;
+    /** The vertices of the unit circle */
+    std::vector<Vec2> _circle;
+
+    /** Whether to draw the fixture outlines */
+    bool _shapes;
+    /** Whether to draw the fixture bounding boxes */
+    bool _aabbs;
+    /** Whether to draw the touching contacts */
+    bool _contacts;
+    /** Whether to draw the broadphase proxies */
+    bool _proxies;
+
+    /** The color of a fixture on a static body */
+    Color4 _staticColor;
+    /** The color of a fixture on a kinematic body */
+    Color4 _kinematicColor;
+    /** The color of a fixture on an awake dynamic body */
+    Color4 _dynamicColor;
+    /** The color of a fixture on a sleeping body */
+    Color4 _sleepColor;
+    /** The color of a sensor fixture */
+    Color4 _sensorColor;
+    /** The color of a fixture bounding box */
+    Color4 _aabbColor;
+    /** The color of a broadphase proxy */
+    Color4 _proxyColor;
+    /** The color of a contact point */
+    Color4 _contactColor;
+
+    /** The number of proxies in the last update */
+    size_t _proxyCount;
+    /** The number of contact points in the last update */
+    size_t _contactCount;
+
+#pragma mark -
+#pragma mark Mesh Internals
+    /**
+     * Appends a line segment to the mesh
+     *
+     * @param a     The start of the segment
+     * @param b     The end of the segment
+     * @param color The segment color
+     */
+    void pushLine(const b2Vec2& a, const b2Vec2& b, const Vec4& color);
+
+    /**
+     * Appends a closed polyline to the mesh
+     *
+     * @param verts The polyline vertices
+     * @param count The number of vertices
+     * @param xf    The transform to apply to the vertices
+     * @param color The polyline color
+     */
+    void pushLoop(const b2Vec2* verts, int32 count, const b2Transform& xf, const Vec4& color);
+
+    /**
+     * Appends an instance of the unit circle to the mesh
+     *
+     * The circle includes a radius segment along the body x-axis, so that
+     * the rotation of the body is visible.
+     *
+     * @param center    The circle center
+     * @param radius    The circle radius
+     * @param axis      The body x-axis
+     * @param color     The circle color
+     */
+    void pushCircle(const b2Vec2& center, float radius, const b2Vec2& axis, const Vec4& color);
+
+    /**
+     * Appends a bounding box to the mesh
+     *
+     * @param box   The bounding box
+     * @param color The box color
+     */
+    void pushBox(const b2AABB& box, const Vec4& color);
+
+    /**
+     * Appends the outline of a single fixture child to the mesh
+     *
+     * Chains are drawn one child edge at a time, since each child has its
+     * own proxy in the broadphase.
+     *
+     * @param fixture   The fixture to outline
+     * @param child     The child index
+     */
+    void pushFixture(const b2Fixture* fixture, int32 child);
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates a new debug renderer with the default values.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    DebugRenderer();
+
+    /**
+     * Deletes this debug renderer, disposing all resources
+     */
+    ~DebugRenderer() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this renderer.
+     *
+     * A disposed renderer can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a new debug renderer with the default circle segments.
+     *
+     * @return true if the renderer is initialized properly, false otherwise.
+     */
+    bool init() { return init(DEBUG_CIRCLE_SEGMENTS); }
+
+    /**
+     * Initializes a new debug renderer with the given circle segments.
+     *
+     * Every circle fixture is drawn with this many segments.
+     *
+     * @param segments  The number of segments in a circle
+     *
+     * @return true if the renderer is initialized properly, false otherwise.
+     */
+    bool init(Uint32 segments);
+
+    /**
+     * Returns a newly allocated debug renderer with the default circle segments.
+     *
+     * @return a newly allocated debug renderer with the default circle segments.
+     */
+    static std::shared_ptr<DebugRenderer> alloc() {
+        std::shared_ptr<DebugRenderer> result = std::make_shared<DebugRenderer>();
+        return (result->init() ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated debug renderer with the given circle segments.
+     *
+     * Every circle fixture is drawn with this many segments.
+     *
+     * @param segments  The number of segments in a circle
+     *
+     * @return a newly allocated debug renderer with the given circle segments.
+     */
+    static std::shared_ptr<DebugRenderer> alloc(Uint32 segments) {
+        std::shared_ptr<DebugRenderer> result = std::make_shared<DebugRenderer>();
+        return (result->init(segments) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Toggles
+    /**
+     * Returns true if this renderer draws the fixture outlines.
+     *
+     * @return true if this renderer draws the fixture outlines.
+     */
+    bool getShapesVisible() const { return _shapes; }
+
+    /**
+     * Sets whether this renderer draws the fixture outlines.
+     *
+     * @param value Whether this renderer draws the fixture outlines.
+     */
+    void setShapesVisible(bool value) { _shapes = value; }
+
+    /**
+     * Returns true if this renderer draws the fixture bounding boxes.
+     *
+     * @return true if this renderer draws the fixture bounding boxes.
+     */
+    bool getAABBsVisible() const { return _aabbs; }
+
+    /**
+     * Sets whether this renderer draws the fixture bounding boxes.
+     *
+     * @param value Whether this renderer draws the fixture bounding boxes.
+     */
+    void setAABBsVisible(bool value) { _aabbs = value; }
+
+    /**
+     * Returns true if this renderer draws the touching contacts.
+     *
+     * @return true if this renderer draws the touching contacts.
+     */
+    bool getContactsVisible() const { return _contacts; }
+
+    /**
+     * Sets whether this renderer draws the touching contacts.
+     *
+     * Each contact point is drawn as a cross, with a segment along the
+     * contact normal.
+     *
+     * @param value Whether this renderer draws the touching contacts.
+     */
+    void setContactsVisible(bool value) { _contacts = value; }
+
+    /**
+     * Returns true if this renderer draws the broadphase proxies.
+     *
+     * @return true if this renderer draws the broadphase proxies.
+     */
+    bool getProxiesVisible() const { return _proxies; }
+
+    /**
+     * Sets whether this renderer draws the broadphase proxies.
+     *
+     * A proxy is drawn as its fat bounding box in the broadphase tree.
+     *
+     * @param value Whether this renderer draws the broadphase proxies.
+     */
+    void setProxiesVisible(bool value) { _proxies = value; }
+
+#pragma mark -
+#pragma mark Colors
+    /**
+     * Returns the color of a fixture on a static body.
+     *
+     * @return the color of a fixture on a static body.
+     */
+    Color4 getStaticColor() const { return _staticColor; }
+
+    /**
+     * Sets the color of a fixture on a static body.
+     *
+     * @param color The color of a fixture on a static body.
+     */
+    void setStaticColor(Color4 color) { _staticColor = color; }
+
+    /**
+     * Returns the color of a fixture on a kinematic body.
+     *
+     * @return the color of a fixture on a kinematic body.
+     */
+    Color4 getKinematicColor() const { return _kinematicColor; }
+
+    /**
+     * Sets the color of a fixture on a kinematic body.
+     *
+     * @param color The color of a fixture on a kinematic body.
+     */
+    void setKinematicColor(Color4 color) { _kinematicColor = color; }
+
+    /**
+     * Returns the color of a fixture on an awake dynamic body.
+     *
+     * @return the color of a fixture on an awake dynamic body.
+     */
+    Color4 getDynamicColor() const { return _dynamicColor; }
+
+    /**
+     * Sets the color of a fixture on an awake dynamic body.
+     *
+     * @param color The color of a fixture on an awake dynamic body.
+     */
+    void setDynamicColor(Color4 color) { _dynamicColor = color; }
+
+    /**
+     * Returns the color of a fixture on a sleeping body.
+     *
+     * @return the color of a fixture on a sleeping body.
+     */
+    Color4 getSleepColor() const { return _sleepColor; }
+
+    /**
+     * Sets the color of a fixture on a sleeping body.
+     *
+     * @param color The color of a fixture on a sleeping body.
+     */
+    void setSleepColor(Color4 color) { _sleepColor = color; }
+
+    /**
+     * Returns the color of a sensor fixture.
+     *
+     * @return the color of a sensor fixture.
+     */
+    Color4 getSensorColor() const { return _sensorColor; }
+
+    /**
+     * Sets the color of a sensor fixture.
+     *
+     * @param color The color of a sensor fixture.
+     */
+    void setSensorColor(Color4 color) { _sensorColor = color; }
+
+    /**
+     * Returns the color of a fixture bounding box.
+     *
+     * @return the color of a fixture bounding box.
+     */
+    Color4 getAABBColor() const { return _aabbColor; }
+
+    /**
+     * Sets the color of a fixture bounding box.
+     *
+     * @param color The color of a fixture bounding box.
+     */
+    void setAABBColor(Color4 color) { _aabbColor = color; }
+
+    /**
+     * Returns the color of a broadphase proxy.
+     *
+     * @return the color of a broadphase proxy.
+     */
+    Color4 getProxyColor() const { return _proxyColor; }
+
+    /**
+     * Sets the color of a broadphase proxy.
+     *
+     * @param color The color of a broadphase proxy.
+     */
+    void setProxyColor(Color4 color) { _proxyColor = color; }
+
+    /**
+     * Returns the color of a contact point.
+     *
+     * @return the color of a contact point.
+     */
+    Color4 getContactColor() const { return _contactColor; }
+
+    /**
+     * Sets the color of a contact point.
+     *
+     * @param color The color of a contact point.
+     */
+    void setContactColor(Color4 color) { _contactColor = color; }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Rebuilds the wireframe mesh for the given world.
+     *
+     * Only the proxies whose fat bounding boxes overlap the bounds are drawn.
+     * The bounds are in physics coordinates, and are typically the camera
+     * view mapped into the world.
+     *
+     * @param world     The Box2D world
+     * @param bounds    The visible region in physics coordinates
+     */
+    void update(const b2World* world, const Rect& bounds);
+
+    /**
+     * Draws the wireframe mesh with the given sprite batch.
+     *
+     * The mesh is drawn with a single outline call, using the blank texture.
+     * The sprite batch must be active (e.g. between calls to begin and end).
+     * This method changes the texture, color and gradient of the batch.
+     *
+     * @param batch     The sprite batch
+     * @param transform The transform from physics to world coordinates
+     */
+    void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform);
+
+    /**
+     * Returns the wireframe mesh from the last update.
+     *
+     * @return the wireframe mesh from the last update.
+     */
+    const Mesh<SpriteVertex2>& getMesh() const { return _mesh; }
+
+    /**
+     * Returns the number of broadphase proxies drawn in the last update.
+     *
+     * @return the number of broadphase proxies drawn in the last update.
+     */
+    size_t getProxyCount() const { return _proxyCount; }
+
+    /**
+     * Returns the number of contact points drawn in the last update.
+     *
+     * @return the number of contact points drawn in the last update.
+     */
+    size_t getContactCount() const { return _contactCount; }
+};
+
+    }
+}
+
+#endif /* __CU_DEBUG_RENDERER_H__ */
@@ -46,11 +46,19 @@
 #define __CU_PHYSICS_WORLD_H__
 
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <cugl/math/cu_math.h>
 class b2World;
 
 namespace cugl {
+
+// Forward declaration of the level arena
+class Arena;
+// Forward declaration of the thread pool
+class ThreadPool;
+
     /**
      * The classes to represent 2-d physics.
      *
@@ -69,6 +77,73 @@ class Obstacle;
 #define DEFAULT_WORLD_VELOC 6
 /** Default number of position iterations for the constrain solvers */
 #define DEFAULT_WORLD_POSIT 2
+/** Default number of steps in the telemetry history */
+#define DEFAULT_WORLD_HISTORY   600
+/** Default number of obstacles in the hot obstacle list */
+#define DEFAULT_WORLD_HOTLIST   8
+
+
+#pragma mark -
+#pragma mark Physics Telemetry
+/**
+ * The telemetry of a single physics step.
+ *
+ * The times are copied from the Box2D profile of the step, and are in
+ * milliseconds. The solve time includes the three solver phases, and the
+ * broadphase time is the part of the solve spent updating the broadphase.
+ * Only dynamic and kinematic bodies are counted as awake or asleep.
+ */
+struct PhysicsStats {
+    /** The number of steps recorded before this one */
+    Uint64 index;
+    /** The length of the step in seconds */
+    float dt;
+    /** The time for the entire step */
+    float stepTime;
+    /** The time to update the contacts */
+    float collideTime;
+    /** The time to solve the islands */
+    float solveTime;
+    /** The time to initialize the island solvers */
+    float solveInitTime;
+    /** The time to solve the velocity constraints */
+    float solveVelocityTime;
+    /** The time to solve the position constraints */
+    float solvePositionTime;
+    /** The time to update the broadphase after solving */
+    float broadphaseTime;
+    /** The time to solve the time of impact events */
+    float solveTOITime;
+    /** The number of awake (non-static) bodies */
+    int awakeBodies;
+    /** The number of sleeping (non-static) bodies */
+    int sleepingBodies;
+    /** The number of static bodies */
+    int staticBodies;
+    /** The number of contacts (pairs with overlapping bounding boxes) */
+    int contacts;
+    /** The number of contacts that are touching */
+    int touchingContacts;
+    /** The number of broadphase proxies */
+    int proxies;
+    /** The number of islands solved */
+    int islands;
+    /** The number of time of impact events solved */
+    int toiEvents;
+};
+
+/**
+ * An obstacle and its number of touching contacts.
+ *
+ * The obstacle is a weak reference, as it may be removed from the world
+ * before the list is read.
+ */
+struct ObstacleContacts {
+    /** The obstacle */
+    std::weak_ptr<Obstacle> obstacle;
+    /** The number of touching contacts of the obstacle body */
+    int contacts;
+};
 
 
 #pragma mark -
@@ -106,6 +181,47 @@ protected:
     /** The boundary of the world */
     Rect _bounds;
     
+    /** The (optional) arena backing the Box2D small object allocator */
+    std::shared_ptr<Arena> _arena;
+    /** The (optional) thread pool for solving islands in parallel */
+    std::shared_ptr<ThreadPool> _solverpool;
+    
+    /** Whether to record telemetry after each step */
+    bool _telemetry;
+    /** The telemetry of the most recent steps (a ring buffer) */
+    std::vector<PhysicsStats> _history;
+    /** The position of the oldest step in the history */
+    size_t _historyStart;
+    /** The maximum number of steps in the history */
+    size_t _historyCapacity;
+    /** The number of steps recorded */
+    Uint64 _historySteps;
+    /** The obstacles with the most touching contacts after the last step */
+    std::vector<ObstacleContacts> _hotlist;
+    /** The maximum number of obstacles in the hot list */
+    size_t _hotlistLimit;
+    /** The contact count and position of each obstacle (scratch space) */
+    std::vector<std::pair<int,size_t>> _hotranks;
+    
+    /** Whether to only update the obstacles that changed in a step */
+    bool _sleepAware;
+    /** Whether the partitions must be rebuilt before the next update */
+    bool _repartition;
+    /** The positions of the static obstacles */
+    std::vector<size_t> _statics;
+    /** The positions of the kinematic obstacles */
+    std::vector<size_t> _kinematics;
+    /** The positions of the dynamic obstacles */
+    std::vector<size_t> _dynamics;
+    /** The positions of the compound obstacles (updated every step) */
+    std::vector<size_t> _compounds;
+    /** The body type of each obstacle when the partitions were built */
+    std::vector<b2BodyType> _bodytypes;
+    /** The position of each single-body obstacle */
+    std::unordered_map<const Obstacle*,size_t> _positions;
+    /** The positions of the obstacles to update this step (scratch space) */
+    std::vector<size_t> _changed;
+    
     /** Whether or not to activate the collision listener */
     bool _collide;
     /** Whether or not to activate the filter listener */
@@ -113,6 +229,34 @@ protected:
     /** Whether or not to activate the destruction listener */
     bool _destroy;
     
+    /**
+     * Records the telemetry of the step just taken.
+     *
+     * This method adds a step to the history, replacing the oldest one if
+     * the history is full, and ranks the obstacles for the hot list.
+     *
+     * @param dt    The length of the step in seconds
+     */
+    void recordTelemetry(float dt);
+    
+    /**
+     * Rebuilds the static, kinematic and dynamic partitions.
+     *
+     * Compound obstacles, whose bodies do not map back to them, are kept
+     * in a partition of their own.
+     */
+    void partitionObstacles();
+    
+    /**
+     * Updates the obstacles that changed in the step just taken.
+     *
+     * An obstacle changed if Box2D reports its body as moved, or if its
+     * fixtures must be rebuilt. Compound obstacles are always updated.
+     *
+     * @param dt    Number of seconds since last animation frame
+     */
+    void updateChanged(float dt);
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -245,6 +389,33 @@ public:
      */
     void setLockStep(bool flag) { _lockstep = flag; }
     
+    /**
+     * Returns true if each step only updates the obstacles that changed.
+     *
+     * @return true if each step only updates the obstacles that changed.
+     */
+    bool isSleepAware() const { return _sleepAware; }
+    
+    /**
+     * Sets whether each step only updates the obstacles that changed.
+     *
+     * After a step, the world calls {@link Obstacle#update} so that the
+     * obstacles can rebuild their fixtures and move their scene nodes. A
+     * sleep-aware world (the default) only updates an obstacle if its body
+     * was solved in the step (so it was awake), if it was moved, retyped or
+     * created since the last step, or if its fixtures must be rebuilt (such
+     * as a static button that changes height). Compound obstacles are updated
+     * every step. In a level of mostly static obstacles, this skips almost
+     * all of them.
+     *
+     * In return, an obstacle must not depend on being updated every step.
+     * In particular, a listener is only called when its obstacle changes.
+     * Setting this to false updates every obstacle after every step.
+     *
+     * @param flag  Whether each step only updates the obstacles that changed
+     */
+    void setSleepAware(bool flag) { _sleepAware = flag; }
+    
     /** 
      * Returns the amount of time for a single engine step.
      *
@@ -324,6 +495,9 @@ public:
      * physics.  The primary method is the step() method in world.  This implementation
      * works for all applications and should not need to be overwritten.
      *
+     * After the step, only the obstacles that changed are updated, unless
+     * this world is not sleep-aware (see {@link setSleepAware}).
+     *
      * @param dt Number of seconds since last animation frame
      */
     void update(float dt);
@@ -347,6 +521,195 @@ public:
     bool inBounds(Obstacle* obj);
     
     
+#pragma mark -
+#pragma mark Telemetry
+    /**
+     * Returns true if this world records telemetry after each step.
+     *
+     * @return true if this world records telemetry after each step.
+     */
+    bool isTelemetryEnabled() const { return _telemetry; }
+    
+    /**
+     * Sets whether this world records telemetry after each step.
+     *
+     * The telemetry of a step is a {@link PhysicsStats} object. In addition,
+     * the world ranks the obstacles by their number of touching contacts,
+     * which is available from {@link getHotObstacles}. Counting the bodies
+     * and contacts visits every one of them, so this should only be enabled
+     * for debugging. When it is disabled (the default), a step does no extra
+     * work at all.
+     *
+     * Disabling telemetry does not erase the history.
+     *
+     * @param flag  Whether this world records telemetry after each step
+     */
+    void setTelemetryEnabled(bool flag) { _telemetry = flag; }
+    
+    /**
+     * Returns the maximum number of steps in the telemetry history.
+     *
+     * @return the maximum number of steps in the telemetry history.
+     */
+    size_t getTelemetryCapacity() const { return _historyCapacity; }
+    
+    /**
+     * Sets the maximum number of steps in the telemetry history.
+     *
+     * Once the history is full, each step replaces the oldest one. Changing
+     * the capacity erases the history.
+     *
+     * @param capacity  The maximum number of steps in the telemetry history
+     */
+    void setTelemetryCapacity(size_t capacity);
+    
+    /**
+     * Returns the number of steps in the telemetry history.
+     *
+     * @return the number of steps in the telemetry history.
+     */
+    size_t getTelemetryCount() const { return _history.size(); }
+    
+    /**
+     * Returns the telemetry of a step in the history.
+     *
+     * The steps are ordered from oldest (0) to newest. The reference is only
+     * valid until the next step.
+     *
+     * @param index The position of the step in the history
+     *
+     * @return the telemetry of a step in the history.
+     */
+    const PhysicsStats& getTelemetry(size_t index) const;
+    
+    /**
+     * Returns the obstacles with the most touching contacts after the last step.
+     *
+     * The obstacles are ranked from most to fewest contacts, with ties broken
+     * by the order they were added to the world. Obstacles without contacts
+     * are never listed. This list is only updated when telemetry is enabled.
+     *
+     * @return the obstacles with the most touching contacts after the last step.
+     */
+    const std::vector<ObstacleContacts>& getHotObstacles() const { return _hotlist; }
+    
+    /**
+     * Returns the maximum number of obstacles in the hot list.
+     *
+     * @return the maximum number of obstacles in the hot list.
+     */
+    size_t getHotObstacleLimit() const { return _hotlistLimit; }
+    
+    /**
+     * Sets the maximum number of obstacles in the hot list.
+     *
+     * The change takes effect at the next step.
+     *
+     * @param limit The maximum number of obstacles in the hot list.
+     */
+    void setHotObstacleLimit(size_t limit) { _hotlistLimit = limit; }
+    
+    /**
+     * Erases the telemetry history and the hot list.
+     */
+    void clearTelemetry();
+    
+    /**
+     * Returns the telemetry history as comma separated values.
+     *
+     * The first line is a header naming the columns, which are the fields of
+     * {@link PhysicsStats} in order. Each step in the history is a line after
+     * that, from oldest to newest.
+     *
+     * @return the telemetry history as comma separated values.
+     */
+    std::string getTelemetryCSV() const;
+    
+    
+#pragma mark -
+#pragma mark Memory Management
+    /**
+     * Returns the arena backing this world (if any).
+     *
+     * When a world has an arena, the Box2D small object allocator (bodies,
+     * fixtures, contacts and joints) draws its pages from the arena instead
+     * of the heap. Obstacles that share the lifetime of the world, such as
+     * the tiles of a level, may also allocate their shape data from it.
+     *
+     * @return the arena backing this world (if any).
+     */
+    const std::shared_ptr<Arena>& getArena() const { return _arena; }
+    
+    /**
+     * Sets the arena backing this world.
+     *
+     * When a world has an arena, the Box2D small object allocator (bodies,
+     * fixtures, contacts and joints) draws its pages from the arena instead
+     * of the heap. A call to {@link clear()} then releases all of that memory
+     * at once by resetting the arena, invalidating anything else that was
+     * allocated from it.  Hence the arena should be dedicated to the objects
+     * in this world.
+     *
+     * This method may only be called when the world is empty. Setting the
+     * arena to nullptr restores the default heap allocation.
+     *
+     * @param arena The arena backing this world
+     */
+    void setArena(const std::shared_ptr<Arena>& arena);
+    
+    
+#pragma mark -
+#pragma mark Parallel Solver
+    /**
+     * Returns the thread pool used to solve islands in parallel (if any).
+     *
+     * @return the thread pool used to solve islands in parallel (if any).
+     */
+    const std::shared_ptr<ThreadPool>& getSolverPool() const { return _solverpool; }
+    
+    /**
+     * Sets the thread pool used to solve islands in parallel.
+     *
+     * An island is a group of obstacles that touch (or are joined) to each
+     * other. Islands do not interact during a step, so they can be solved at
+     * the same time.  With a solver pool, each step still finds the islands on
+     * the calling thread, but then spreads the joint-free islands across the
+     * pool (plus the calling thread).  Islands with joints are solved on the
+     * calling thread.
+     *
+     * The results are identical to the serial solver, regardless of the
+     * number of threads.  In particular, all collision callbacks are still
+     * invoked on the calling thread, in the same order.
+     *
+     * The pool should be dedicated to physics, as every step waits on its
+     * workers.  Setting the pool to nullptr restores the serial solver. This
+     * method may not be called during a step.
+     *
+     * @param pool  The thread pool used to solve islands in parallel
+     */
+    void setSolverPool(const std::shared_ptr<ThreadPool>& pool);
+    
+    
+#pragma mark -
+#pragma mark Broadphase
+    /**
+     * Rebuilds the broadphase tree of the static obstacles in bulk.
+     *
+     * The broadphase keeps static obstacles in their own tree, so that only
+     * moving obstacles are tested against them.  That tree is normally built
+     * one obstacle at a time, and its shape depends on the insertion order.
+     * This method rebuilds it top down with a surface area heuristic, which
+     * gives a much tighter tree.  It should be called once every static
+     * obstacle in a level has been added.  Static obstacles added later are
+     * inserted incrementally as before.
+     *
+     * The quality of the tree is available from {@link getWorld()}, through
+     * GetStaticTreeHeight and GetStaticTreeQuality. This method may not be
+     * called during a step.
+     */
+    void rebuildStaticTree();
+    
+    
 #pragma mark -
 #pragma mark Object Management
     /**
@@ -407,6 +770,9 @@ public:
      *
      * This method is different from {@link dispose()} in that the world can
      * still receive new objects.
+     *
+     * If this world has an arena, this method will also reset that arena,
+     * releasing all Box2D memory (and any other arena allocations) at once.
      */
     void clear();
 
@@ -50,6 +50,9 @@
 #include <cugl/math/CUPoly2.h>
 
 namespace cugl {
+    /** Forward reference to the level arena */
+    class Arena;
+
     /**
      * The classes to represent 2-d physics.
      *
@@ -80,6 +83,10 @@ protected:
     Vec2 _anchor;
     /** In case the number of polygons changes */
     int _fixCount;
+    /** The (optional) arena providing the shape and fixture arrays */
+    std::shared_ptr<Arena> _arena;
+    /** The arena generation when the shape arrays were allocated */
+    Uint32 _generation;
     
     
 #pragma mark -
@@ -109,6 +116,14 @@ protected:
      */
     void resetShapes();
     
+    /**
+     * Releases the shape and fixture arrays of this polygon.
+     *
+     * Arrays allocated from an arena are simply dropped, as they are
+     * reclaimed when the arena is reset.
+     */
+    void releaseShapes();
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -119,7 +134,8 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
      * the heap, use one of the static constructors instead.
      */
-    PolygonObstacle(void) : SimpleObstacle(), _shapes(nullptr), _geoms(nullptr) { }
+    PolygonObstacle(void) : SimpleObstacle(), _shapes(nullptr), _geoms(nullptr),
+    _fixCount(0), _generation(0) { }
     
     /**
      * Deletes this physics object and all of its resources.
@@ -316,6 +332,34 @@ public:
     void setPolygon(const Poly2& value);
     
     
+#pragma mark -
+#pragma mark Memory Management
+    /**
+     * Returns the arena providing the shape arrays of this polygon.
+     *
+     * If this value is nullptr, the shapes are allocated on the heap.
+     *
+     * @return the arena providing the shape arrays of this polygon.
+     */
+    const std::shared_ptr<Arena>& getArena() const { return _arena; }
+    
+    /**
+     * Sets the arena providing the shape arrays of this polygon.
+     *
+     * Polygons that share the lifetime of a level (e.g. level geometry)
+     * can take their triangle shapes and fixture caches from the level
+     * arena instead of the heap.  This avoids a pair of heap allocations
+     * per polygon every time the level is rebuilt.
+     *
+     * This method must be called before the polygon is initialized.  The
+     * arena must not be reset until this obstacle is removed from the world,
+     * as that invalidates the shapes.
+     *
+     * @param arena The arena providing the shape arrays of this polygon
+     */
+    void setArena(const std::shared_ptr<Arena>& arena);
+    
+    
 #pragma mark -
 #pragma mark Physics Methods
     
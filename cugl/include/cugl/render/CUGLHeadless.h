@@ -0,0 +1,201 @@
+//
+//  CUGLHeadless.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a stub OpenGL backend for headless tests.  When the
+//  engine is built with CU_GL_HEADLESS defined, every OpenGL call made by the
+//  engine is routed to a function in this module instead of the driver.  The
+//  stub hands out fake object names and sync objects, keeps just enough state
+//  to answer the queries made by the render layer, and introspects shaders by
+//  reading their source.  Nothing is ever drawn.
+//
+//  A headless build always records (CU_GL_HEADLESS implies CU_GL_RECORD), so
+//  the calls are counted by GLRecorder exactly as in a recording build.  This
+//  allows the call counts of a frame to be checked on a machine with no GPU
+//  and no display (such as a build server using the SDL dummy video driver).
+//
+//  These functions are not meant to be called directly.  They are reached
+//  through the macros in CUGLRecorder.h.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_GL_HEADLESS_H__
+#define __CU_GL_HEADLESS_H__
+#include <cugl/base/CUBase.h>
+
+namespace cugl {
+
+/**
+ * The stub OpenGL backend used by headless builds.
+ *
+ * Each function has the name and signature of the OpenGL function that it
+ * replaces.  Object names are positive and never reused, sync objects are
+ * always signaled, and shaders always compile and link.  The active
+ * attributes, uniforms and uniform blocks of a program are read from the
+ * declarations in its shader sources, with block sizes computed using the
+ * std140 layout rules.  Buffers keep a copy of their storage, so that mapped
+ * ranges may be written to.  Error polls always return GL_NO_ERROR.
+ *
+ * Like OpenGL itself, this backend is not thread safe, and should only be
+ * used from the rendering thread.
+ */
+namespace headless {
+
+#pragma mark State
+void glEnable(GLenum cap);
+void glDisable(GLenum cap);
+void glDepthFunc(GLenum func);
+void glDepthMask(GLboolean flag);
+void glBlendFunc(GLenum sfactor, GLenum dfactor);
+void glBlendEquation(GLenum mode);
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void glClear(GLbitfield mask);
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+GLenum glGetError();
+void glGetIntegerv(GLenum pname, GLint* data);
+void glGetIntegeri_v(GLenum target, GLuint index, GLint* data);
+const GLubyte* glGetString(GLenum name);
+
+#pragma mark Buffers
+void glGenBuffers(GLsizei n, GLuint* buffers);
+void glDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+GLboolean glUnmapBuffer(GLenum target);
+void glGenVertexArrays(GLsizei n, GLuint* arrays);
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glBindVertexArray(GLuint array);
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                           GLsizei stride, const void* pointer);
+void glEnableVertexAttribArray(GLuint index);
+void glDisableVertexAttribArray(GLuint index);
+
+#pragma mark Drawing
+void glDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+                             GLsizei instancecount);
+GLsync glFenceSync(GLenum condition, GLbitfield flags);
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void glDeleteSync(GLsync sync);
+
+#pragma mark Textures
+void glGenTextures(GLsizei n, GLuint* textures);
+void glDeleteTextures(GLsizei n, const GLuint* textures);
+void glActiveTexture(GLenum texture);
+void glBindTexture(GLenum target, GLuint texture);
+void glTexParameteri(GLenum target, GLenum pname, GLint param);
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                  GLint border, GLenum format, GLenum type, const void* pixels);
+void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels);
+void glGenerateMipmap(GLenum target);
+
+#pragma mark Framebuffers
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers);
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+void glBindFramebuffer(GLenum target, GLuint framebuffer);
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget,
+                            GLuint texture, GLint level);
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget,
+                               GLuint renderbuffer);
+GLenum glCheckFramebufferStatus(GLenum target);
+void glDrawBuffers(GLsizei n, const GLenum* bufs);
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers);
+void glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer);
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+
+#pragma mark Shaders
+GLuint glCreateShader(GLenum type);
+void glDeleteShader(GLuint shader);
+GLboolean glIsShader(GLuint shader);
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+void glCompileShader(GLuint shader);
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+GLuint glCreateProgram();
+GLboolean glIsProgram(GLuint program);
+void glAttachShader(GLuint program, GLuint shader);
+void glLinkProgram(GLuint program);
+void glUseProgram(GLuint program);
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length,
+                       GLint* size, GLenum* type, GLchar* name);
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length,
+                        GLint* size, GLenum* type, GLchar* name);
+void glGetActiveUniformBlockName(GLuint program, GLuint index, GLsizei bufSize,
+                                 GLsizei* length, GLchar* name);
+void glGetActiveUniformBlockiv(GLuint program, GLuint index, GLenum pname, GLint* params);
+GLint glGetAttribLocation(GLuint program, const GLchar* name);
+GLint glGetUniformLocation(GLuint program, const GLchar* name);
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* name);
+GLint glGetFragDataLocation(GLuint program, const GLchar* name);
+void glUniformBlockBinding(GLuint program, GLuint index, GLuint binding);
+
+#pragma mark Uniforms
+void glUniform1i(GLint location, GLint v0);
+void glUniform1iv(GLint location, GLsizei count, const GLint* value);
+void glUniform1ui(GLint location, GLuint v0);
+void glUniform1uiv(GLint location, GLsizei count, const GLuint* value);
+void glUniform1f(GLint location, GLfloat v0);
+void glUniform1fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniform2i(GLint location, GLint v0, GLint v1);
+void glUniform2iv(GLint location, GLsizei count, const GLint* value);
+void glUniform2ui(GLint location, GLuint v0, GLuint v1);
+void glUniform2uiv(GLint location, GLsizei count, const GLuint* value);
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void glUniform2fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniform3i(GLint location, GLint v0, GLint v1, GLint v2);
+void glUniform3iv(GLint location, GLsizei count, const GLint* value);
+void glUniform3ui(GLint location, GLuint v0, GLuint v1, GLuint v2);
+void glUniform3uiv(GLint location, GLsizei count, const GLuint* value);
+void glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+void glUniform3fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3);
+void glUniform4iv(GLint location, GLsizei count, const GLint* value);
+void glUniform4ui(GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3);
+void glUniform4uiv(GLint location, GLsizei count, const GLuint* value);
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glUniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glGetUniformfv(GLuint program, GLint location, GLfloat* params);
+void glGetUniformiv(GLuint program, GLint location, GLint* params);
+void glGetUniformuiv(GLuint program, GLint location, GLuint* params);
+
+}
+
+}
+
+#endif /* __CU_GL_HEADLESS_H__ */
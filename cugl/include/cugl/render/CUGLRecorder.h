@@ -0,0 +1,444 @@
+//
+//  CUGLRecorder.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a recording shim for OpenGL.  When the engine is
+//  built with CU_GL_RECORD defined, the OpenGL calls made by the render layer
+//  are routed through counting macros before they reach the driver.  This
+//  allows tests and profiling builds to measure exactly how many state
+//  changes, uniform updates, buffer uploads and draw calls a frame issues.
+//  When CU_GL_RECORD is not defined, this module adds no cost whatsoever.
+//
+//  The recorder is only a counter.  Every call is still forwarded to the
+//  active OpenGL context, so it must be used with a valid context (such as
+//  the one created by the test harness).  The exception is a build with
+//  CU_GL_HEADLESS defined, which forwards every call to the stub backend in
+//  CUGLHeadless.h instead.
+//
+//  This class is a static singleton, and has no constructors.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_GL_RECORDER_H__
+#define __CU_GL_RECORDER_H__
+#include <cugl/base/CUBase.h>
+#include <string>
+
+namespace cugl {
+
+/**
+ * A static recorder that counts OpenGL calls by category.
+ *
+ * The counts are only collected when the engine (and the game) are built
+ * with CU_GL_RECORD defined.  In that case {@link CUBase.h} includes this
+ * header after the OpenGL headers, and the calls listed in {@link Call} are
+ * replaced by macros that count the call and then forward it to OpenGL.
+ * Otherwise, the counts remain zero.
+ *
+ * To measure a single frame, call {@link reset} before drawing it, and read
+ * the counts afterwards.  Like OpenGL itself, this class is not thread safe,
+ * and should only be used from the rendering thread.
+ *
+ * The recorder does not stub out OpenGL by itself.  Every recorded call is
+ * still forwarded to the driver, so a recording build needs a current OpenGL
+ * context exactly like a normal build.  To count calls without a context
+ * (such as in a headless test), build with CU_GL_HEADLESS instead.  That
+ * implies CU_GL_RECORD, and forwards every OpenGL call made by the engine to
+ * the stub functions in {@link headless}.
+ *
+ * Recording is not supported on Windows, where the OpenGL entry points are
+ * already macros defined by GLEW.
+ */
+class GLRecorder {
+public:
+    /** The categories of recorded OpenGL calls */
+    enum class Call : int {
+        /** Program binds */
+        USE_PROGRAM = 0,
+        /** Vertex array binds */
+        BIND_VERTEX_ARRAY,
+        /** Buffer binds (including indexed binds) */
+        BIND_BUFFER,
+        /** Buffer uploads (full, partial or mapped) */
+        BUFFER_DATA,
+        /** Draw calls */
+        DRAW,
+        /** Texture unit changes */
+        ACTIVE_TEXTURE,
+        /** Texture binds */
+        BIND_TEXTURE,
+        /** Blend state changes */
+        BLEND,
+        /** Capability and depth state changes */
+        CAPABILITY,
+        /** Uniform updates (all glUniform variants) */
+        UNIFORM,
+        /** Uniform block binds */
+        UNIFORM_BLOCK,
+        /** Vertex attribute setup */
+        ATTRIBUTE,
+        /** Lookups of variables by name */
+        LOOKUP,
+        /** State queries */
+        QUERY,
+        /** Error polls */
+        GET_ERROR,
+        /** Framebuffer binds, viewports, and clears */
+        FRAMEBUFFER,
+        /** Fence creation, waits and deletion */
+        SYNC,
+        /** The number of call categories */
+        COUNT
+    };
+
+private:
+    /** The number of calls in each category since the last reset */
+    static Uint32 _counts[(int)Call::COUNT];
+
+public:
+#pragma mark Recording
+    /**
+     * Records a call in the given category.
+     *
+     * This method is called by the recording macros, and should not be
+     * called directly.
+     *
+     * @param call  The call category
+     */
+    static void record(Call call) { _counts[(int)call]++; }
+
+    /**
+     * Resets all of the counts to zero.
+     *
+     * This is typically called at the start of a frame.
+     */
+    static void reset();
+
+    /**
+     * Returns true if this build records OpenGL calls.
+     *
+     * @return true if this build records OpenGL calls.
+     */
+    static bool isRecording() {
+#ifdef CU_GL_RECORD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Returns true if this build replaces OpenGL with the headless stub.
+     *
+     * A headless build never needs an OpenGL context, and never draws.
+     *
+     * @return true if this build replaces OpenGL with the headless stub.
+     */
+    static bool isHeadless() {
+#ifdef CU_GL_HEADLESS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#pragma mark Counts
+    /**
+     * Returns the number of calls in the given category since the last reset.
+     *
+     * @param call  The call category
+     *
+     * @return the number of calls in the given category since the last reset.
+     */
+    static Uint32 getCount(Call call) { return _counts[(int)call]; }
+
+    /**
+     * Returns the number of recorded calls since the last reset.
+     *
+     * @return the number of recorded calls since the last reset.
+     */
+    static Uint32 getTotal();
+
+    /**
+     * Returns a short name for the given call category.
+     *
+     * @param call  The call category
+     *
+     * @return a short name for the given call category.
+     */
+    static const char* getName(Call call);
+
+    /**
+     * Returns a summary of the nonzero counts for logging.
+     *
+     * @return a summary of the nonzero counts for logging.
+     */
+    static std::string toString();
+};
+
+}
+
+#pragma mark -
+#pragma mark Recording Macros
+// The headless backend defines the OpenGL names itself, and so skips the macros
+#if defined (CU_GL_RECORD) && !defined (CU_GL_HEADLESS_SOURCE)
+#if defined (__WINDOWS__)
+    #error CU_GL_RECORD is not supported with GLEW
+#endif
+// The parentheses around each name suppress any further macro expansion
+#ifdef CU_GL_HEADLESS
+    #include <cugl/render/CUGLHeadless.h>
+    #define CU_GL_CALL(name) (cugl::headless::name)
+#else
+    #define CU_GL_CALL(name) (name)
+#endif
+#undef  glUseProgram
+#define glUseProgram(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::USE_PROGRAM), CU_GL_CALL(glUseProgram)(__VA_ARGS__))
+#undef  glBindVertexArray
+#define glBindVertexArray(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BIND_VERTEX_ARRAY), CU_GL_CALL(glBindVertexArray)(__VA_ARGS__))
+#undef  glBindBuffer
+#define glBindBuffer(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BIND_BUFFER), CU_GL_CALL(glBindBuffer)(__VA_ARGS__))
+#undef  glBindBufferBase
+#define glBindBufferBase(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BIND_BUFFER), CU_GL_CALL(glBindBufferBase)(__VA_ARGS__))
+#undef  glBindBufferRange
+#define glBindBufferRange(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BIND_BUFFER), CU_GL_CALL(glBindBufferRange)(__VA_ARGS__))
+#undef  glBufferData
+#define glBufferData(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BUFFER_DATA), CU_GL_CALL(glBufferData)(__VA_ARGS__))
+#undef  glBufferSubData
+#define glBufferSubData(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BUFFER_DATA), CU_GL_CALL(glBufferSubData)(__VA_ARGS__))
+#undef  glMapBufferRange
+#define glMapBufferRange(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BUFFER_DATA), CU_GL_CALL(glMapBufferRange)(__VA_ARGS__))
+#undef  glUnmapBuffer
+#define glUnmapBuffer(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BUFFER_DATA), CU_GL_CALL(glUnmapBuffer)(__VA_ARGS__))
+#undef  glDrawElements
+#define glDrawElements(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::DRAW), CU_GL_CALL(glDrawElements)(__VA_ARGS__))
+#undef  glDrawElementsInstanced
+#define glDrawElementsInstanced(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::DRAW), CU_GL_CALL(glDrawElementsInstanced)(__VA_ARGS__))
+#undef  glDrawArrays
+#define glDrawArrays(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::DRAW), CU_GL_CALL(glDrawArrays)(__VA_ARGS__))
+#undef  glActiveTexture
+#define glActiveTexture(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::ACTIVE_TEXTURE), CU_GL_CALL(glActiveTexture)(__VA_ARGS__))
+#undef  glBindTexture
+#define glBindTexture(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BIND_TEXTURE), CU_GL_CALL(glBindTexture)(__VA_ARGS__))
+#undef  glBlendFunc
+#define glBlendFunc(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BLEND), CU_GL_CALL(glBlendFunc)(__VA_ARGS__))
+#undef  glBlendEquation
+#define glBlendEquation(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::BLEND), CU_GL_CALL(glBlendEquation)(__VA_ARGS__))
+#undef  glEnable
+#define glEnable(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::CAPABILITY), CU_GL_CALL(glEnable)(__VA_ARGS__))
+#undef  glDisable
+#define glDisable(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::CAPABILITY), CU_GL_CALL(glDisable)(__VA_ARGS__))
+#undef  glDepthFunc
+#define glDepthFunc(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::CAPABILITY), CU_GL_CALL(glDepthFunc)(__VA_ARGS__))
+#undef  glUniform1i
+#define glUniform1i(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform1i)(__VA_ARGS__))
+#undef  glUniform1iv
+#define glUniform1iv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform1iv)(__VA_ARGS__))
+#undef  glUniform1ui
+#define glUniform1ui(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform1ui)(__VA_ARGS__))
+#undef  glUniform1uiv
+#define glUniform1uiv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform1uiv)(__VA_ARGS__))
+#undef  glUniform1f
+#define glUniform1f(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform1f)(__VA_ARGS__))
+#undef  glUniform1fv
+#define glUniform1fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform1fv)(__VA_ARGS__))
+#undef  glUniform2i
+#define glUniform2i(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform2i)(__VA_ARGS__))
+#undef  glUniform2iv
+#define glUniform2iv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform2iv)(__VA_ARGS__))
+#undef  glUniform2ui
+#define glUniform2ui(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform2ui)(__VA_ARGS__))
+#undef  glUniform2uiv
+#define glUniform2uiv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform2uiv)(__VA_ARGS__))
+#undef  glUniform2f
+#define glUniform2f(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform2f)(__VA_ARGS__))
+#undef  glUniform2fv
+#define glUniform2fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform2fv)(__VA_ARGS__))
+#undef  glUniform3i
+#define glUniform3i(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform3i)(__VA_ARGS__))
+#undef  glUniform3iv
+#define glUniform3iv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform3iv)(__VA_ARGS__))
+#undef  glUniform3ui
+#define glUniform3ui(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform3ui)(__VA_ARGS__))
+#undef  glUniform3uiv
+#define glUniform3uiv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform3uiv)(__VA_ARGS__))
+#undef  glUniform3f
+#define glUniform3f(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform3f)(__VA_ARGS__))
+#undef  glUniform3fv
+#define glUniform3fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform3fv)(__VA_ARGS__))
+#undef  glUniform4i
+#define glUniform4i(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform4i)(__VA_ARGS__))
+#undef  glUniform4iv
+#define glUniform4iv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform4iv)(__VA_ARGS__))
+#undef  glUniform4ui
+#define glUniform4ui(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform4ui)(__VA_ARGS__))
+#undef  glUniform4uiv
+#define glUniform4uiv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform4uiv)(__VA_ARGS__))
+#undef  glUniform4f
+#define glUniform4f(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform4f)(__VA_ARGS__))
+#undef  glUniform4fv
+#define glUniform4fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniform4fv)(__VA_ARGS__))
+#undef  glUniformMatrix2fv
+#define glUniformMatrix2fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix2fv)(__VA_ARGS__))
+#undef  glUniformMatrix3fv
+#define glUniformMatrix3fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix3fv)(__VA_ARGS__))
+#undef  glUniformMatrix4fv
+#define glUniformMatrix4fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix4fv)(__VA_ARGS__))
+#undef  glUniformMatrix2x3fv
+#define glUniformMatrix2x3fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix2x3fv)(__VA_ARGS__))
+#undef  glUniformMatrix3x2fv
+#define glUniformMatrix3x2fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix3x2fv)(__VA_ARGS__))
+#undef  glUniformMatrix2x4fv
+#define glUniformMatrix2x4fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix2x4fv)(__VA_ARGS__))
+#undef  glUniformMatrix4x2fv
+#define glUniformMatrix4x2fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix4x2fv)(__VA_ARGS__))
+#undef  glUniformMatrix3x4fv
+#define glUniformMatrix3x4fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix3x4fv)(__VA_ARGS__))
+#undef  glUniformMatrix4x3fv
+#define glUniformMatrix4x3fv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM), CU_GL_CALL(glUniformMatrix4x3fv)(__VA_ARGS__))
+#undef  glUniformBlockBinding
+#define glUniformBlockBinding(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::UNIFORM_BLOCK), CU_GL_CALL(glUniformBlockBinding)(__VA_ARGS__))
+#undef  glVertexAttribPointer
+#define glVertexAttribPointer(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::ATTRIBUTE), CU_GL_CALL(glVertexAttribPointer)(__VA_ARGS__))
+#undef  glEnableVertexAttribArray
+#define glEnableVertexAttribArray(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::ATTRIBUTE), CU_GL_CALL(glEnableVertexAttribArray)(__VA_ARGS__))
+#undef  glDisableVertexAttribArray
+#define glDisableVertexAttribArray(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::ATTRIBUTE), CU_GL_CALL(glDisableVertexAttribArray)(__VA_ARGS__))
+#undef  glGetUniformLocation
+#define glGetUniformLocation(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::LOOKUP), CU_GL_CALL(glGetUniformLocation)(__VA_ARGS__))
+#undef  glGetAttribLocation
+#define glGetAttribLocation(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::LOOKUP), CU_GL_CALL(glGetAttribLocation)(__VA_ARGS__))
+#undef  glGetUniformBlockIndex
+#define glGetUniformBlockIndex(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::LOOKUP), CU_GL_CALL(glGetUniformBlockIndex)(__VA_ARGS__))
+#undef  glGetIntegerv
+#define glGetIntegerv(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::QUERY), CU_GL_CALL(glGetIntegerv)(__VA_ARGS__))
+#undef  glGetIntegeri_v
+#define glGetIntegeri_v(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::QUERY), CU_GL_CALL(glGetIntegeri_v)(__VA_ARGS__))
+#undef  glGetError
+#define glGetError(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::GET_ERROR), CU_GL_CALL(glGetError)(__VA_ARGS__))
+#undef  glBindFramebuffer
+#define glBindFramebuffer(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::FRAMEBUFFER), CU_GL_CALL(glBindFramebuffer)(__VA_ARGS__))
+#undef  glViewport
+#define glViewport(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::FRAMEBUFFER), CU_GL_CALL(glViewport)(__VA_ARGS__))
+#undef  glClear
+#define glClear(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::FRAMEBUFFER), CU_GL_CALL(glClear)(__VA_ARGS__))
+#undef  glClearColor
+#define glClearColor(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::FRAMEBUFFER), CU_GL_CALL(glClearColor)(__VA_ARGS__))
+#undef  glFenceSync
+#define glFenceSync(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::SYNC), CU_GL_CALL(glFenceSync)(__VA_ARGS__))
+#undef  glClientWaitSync
+#define glClientWaitSync(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::SYNC), CU_GL_CALL(glClientWaitSync)(__VA_ARGS__))
+#undef  glDeleteSync
+#define glDeleteSync(...) (cugl::GLRecorder::record(cugl::GLRecorder::Call::SYNC), CU_GL_CALL(glDeleteSync)(__VA_ARGS__))
+
+// The remaining calls are not counted, but a headless build must still stub them
+#ifdef CU_GL_HEADLESS
+#undef  glDepthMask
+#define glDepthMask(...) CU_GL_CALL(glDepthMask)(__VA_ARGS__)
+#undef  glGetString
+#define glGetString(...) CU_GL_CALL(glGetString)(__VA_ARGS__)
+#undef  glGenBuffers
+#define glGenBuffers(...) CU_GL_CALL(glGenBuffers)(__VA_ARGS__)
+#undef  glDeleteBuffers
+#define glDeleteBuffers(...) CU_GL_CALL(glDeleteBuffers)(__VA_ARGS__)
+#undef  glGenVertexArrays
+#define glGenVertexArrays(...) CU_GL_CALL(glGenVertexArrays)(__VA_ARGS__)
+#undef  glDeleteVertexArrays
+#define glDeleteVertexArrays(...) CU_GL_CALL(glDeleteVertexArrays)(__VA_ARGS__)
+#undef  glGenTextures
+#define glGenTextures(...) CU_GL_CALL(glGenTextures)(__VA_ARGS__)
+#undef  glDeleteTextures
+#define glDeleteTextures(...) CU_GL_CALL(glDeleteTextures)(__VA_ARGS__)
+#undef  glTexParameteri
+#define glTexParameteri(...) CU_GL_CALL(glTexParameteri)(__VA_ARGS__)
+#undef  glTexImage2D
+#define glTexImage2D(...) CU_GL_CALL(glTexImage2D)(__VA_ARGS__)
+#undef  glGetTexImage
+#define glGetTexImage(...) CU_GL_CALL(glGetTexImage)(__VA_ARGS__)
+#undef  glGenerateMipmap
+#define glGenerateMipmap(...) CU_GL_CALL(glGenerateMipmap)(__VA_ARGS__)
+#undef  glGenFramebuffers
+#define glGenFramebuffers(...) CU_GL_CALL(glGenFramebuffers)(__VA_ARGS__)
+#undef  glDeleteFramebuffers
+#define glDeleteFramebuffers(...) CU_GL_CALL(glDeleteFramebuffers)(__VA_ARGS__)
+#undef  glFramebufferTexture2D
+#define glFramebufferTexture2D(...) CU_GL_CALL(glFramebufferTexture2D)(__VA_ARGS__)
+#undef  glFramebufferRenderbuffer
+#define glFramebufferRenderbuffer(...) CU_GL_CALL(glFramebufferRenderbuffer)(__VA_ARGS__)
+#undef  glCheckFramebufferStatus
+#define glCheckFramebufferStatus(...) CU_GL_CALL(glCheckFramebufferStatus)(__VA_ARGS__)
+#undef  glDrawBuffers
+#define glDrawBuffers(...) CU_GL_CALL(glDrawBuffers)(__VA_ARGS__)
+#undef  glGenRenderbuffers
+#define glGenRenderbuffers(...) CU_GL_CALL(glGenRenderbuffers)(__VA_ARGS__)
+#undef  glDeleteRenderbuffers
+#define glDeleteRenderbuffers(...) CU_GL_CALL(glDeleteRenderbuffers)(__VA_ARGS__)
+#undef  glBindRenderbuffer
+#define glBindRenderbuffer(...) CU_GL_CALL(glBindRenderbuffer)(__VA_ARGS__)
+#undef  glRenderbufferStorage
+#define glRenderbufferStorage(...) CU_GL_CALL(glRenderbufferStorage)(__VA_ARGS__)
+#undef  glCreateShader
+#define glCreateShader(...) CU_GL_CALL(glCreateShader)(__VA_ARGS__)
+#undef  glDeleteShader
+#define glDeleteShader(...) CU_GL_CALL(glDeleteShader)(__VA_ARGS__)
+#undef  glIsShader
+#define glIsShader(...) CU_GL_CALL(glIsShader)(__VA_ARGS__)
+#undef  glShaderSource
+#define glShaderSource(...) CU_GL_CALL(glShaderSource)(__VA_ARGS__)
+#undef  glCompileShader
+#define glCompileShader(...) CU_GL_CALL(glCompileShader)(__VA_ARGS__)
+#undef  glGetShaderiv
+#define glGetShaderiv(...) CU_GL_CALL(glGetShaderiv)(__VA_ARGS__)
+#undef  glGetShaderInfoLog
+#define glGetShaderInfoLog(...) CU_GL_CALL(glGetShaderInfoLog)(__VA_ARGS__)
+#undef  glCreateProgram
+#define glCreateProgram(...) CU_GL_CALL(glCreateProgram)(__VA_ARGS__)
+#undef  glIsProgram
+#define glIsProgram(...) CU_GL_CALL(glIsProgram)(__VA_ARGS__)
+#undef  glAttachShader
+#define glAttachShader(...) CU_GL_CALL(glAttachShader)(__VA_ARGS__)
+#undef  glLinkProgram
+#define glLinkProgram(...) CU_GL_CALL(glLinkProgram)(__VA_ARGS__)
+#undef  glGetProgramiv
+#define glGetProgramiv(...) CU_GL_CALL(glGetProgramiv)(__VA_ARGS__)
+#undef  glGetProgramInfoLog
+#define glGetProgramInfoLog(...) CU_GL_CALL(glGetProgramInfoLog)(__VA_ARGS__)
+#undef  glGetActiveAttrib
+#define glGetActiveAttrib(...) CU_GL_CALL(glGetActiveAttrib)(__VA_ARGS__)
+#undef  glGetActiveUniform
+#define glGetActiveUniform(...) CU_GL_CALL(glGetActiveUniform)(__VA_ARGS__)
+#undef  glGetActiveUniformBlockName
+#define glGetActiveUniformBlockName(...) CU_GL_CALL(glGetActiveUniformBlockName)(__VA_ARGS__)
+#undef  glGetActiveUniformBlockiv
+#define glGetActiveUniformBlockiv(...) CU_GL_CALL(glGetActiveUniformBlockiv)(__VA_ARGS__)
+#undef  glGetFragDataLocation
+#define glGetFragDataLocation(...) CU_GL_CALL(glGetFragDataLocation)(__VA_ARGS__)
+#undef  glGetUniformfv
+#define glGetUniformfv(...) CU_GL_CALL(glGetUniformfv)(__VA_ARGS__)
+#undef  glGetUniformiv
+#define glGetUniformiv(...) CU_GL_CALL(glGetUniformiv)(__VA_ARGS__)
+#undef  glGetUniformuiv
+#define glGetUniformuiv(...) CU_GL_CALL(glGetUniformuiv)(__VA_ARGS__)
+#endif
+#endif
+
+#endif /* __CU_GL_RECORDER_H__ */
@@ -118,6 +118,84 @@ namespace cugl {
  * query methods.
  */
 class Shader {
+#pragma mark Handles
+public:
+    /**
+     * A uniform variable resolved at link time.
+     *
+     * A handle stores the program offset of a uniform along with its type
+     * and size.  It converts to the program offset, and so it may be passed
+     * to any uniform setter that takes a location.  This avoids looking up
+     * the uniform by name every time that it is set.
+     *
+     * A handle for a uniform that is not in the shader has location -1.
+     * Setting such a uniform is silently ignored by OpenGL.
+     */
+    struct Uniform {
+        /** The program offset of the uniform (-1 if missing) */
+        GLint  location;
+        /** The type of the uniform (GL_FALSE if missing) */
+        GLenum type;
+        /** The array size of the uniform (0 if missing) */
+        GLint  size;
+
+        /**
+         * Creates a handle for a missing uniform.
+         */
+        Uniform() : location(-1), type(GL_FALSE), size(0) {}
+
+        /**
+         * Returns true if this handle refers to an active uniform.
+         *
+         * @return true if this handle refers to an active uniform.
+         */
+        bool isValid() const { return location >= 0; }
+
+        /**
+         * Returns the program offset of this uniform.
+         *
+         * @return the program offset of this uniform.
+         */
+        operator GLint() const { return location; }
+    };
+
+    /**
+     * An attribute variable resolved at link time.
+     *
+     * A handle stores the program offset of an attribute along with its type
+     * and size.  It converts to the program offset, and so it may be passed
+     * directly to the OpenGL attribute functions.
+     *
+     * A handle for an attribute that is not in the shader has location -1.
+     */
+    struct Attribute {
+        /** The program offset of the attribute (-1 if missing) */
+        GLint  location;
+        /** The type of the attribute (GL_FALSE if missing) */
+        GLenum type;
+        /** The array size of the attribute (0 if missing) */
+        GLint  size;
+
+        /**
+         * Creates a handle for a missing attribute.
+         */
+        Attribute() : location(-1), type(GL_FALSE), size(0) {}
+
+        /**
+         * Returns true if this handle refers to an active attribute.
+         *
+         * @return true if this handle refers to an active attribute.
+         */
+        bool isValid() const { return location >= 0; }
+
+        /**
+         * Returns the program offset of this attribute.
+         *
+         * @return the program offset of this attribute.
+         */
+        operator GLint() const { return location; }
+    };
+
 #pragma mark Values
 protected:
     /** The OpenGL program for this shader */
@@ -136,16 +214,22 @@ protected:
     std::unordered_map<GLint, std::string>  _attribnames;
     /** The attribute locations of this shader */
     std::unordered_map<std::string, GLint>  _attribsizes;
+    /** The attribute program offsets, resolved at link time */
+    std::unordered_map<std::string, GLint>  _attriblocs;
     /** The uniform locations of this shader */
     std::unordered_map<std::string, GLenum> _uniformtypes;
     /** The uniform variable names for this shader (includes samplers) */
     std::unordered_map<GLint,std::string>   _uniformnames;
     /** The uniform locations of this shader (includes samplers) */
     std::unordered_map<std::string, GLint>  _uniformsizes;
+    /** The uniform program offsets, resolved at link time (includes samplers) */
+    std::unordered_map<std::string, GLint>  _uniformlocs;
     /** The uniform block variable names for this shader */
     std::unordered_map<GLint,std::string>   _uniblocknames;
     /** The uniform block locations of this shader */
     std::unordered_map<std::string, GLint>  _uniblocksizes;
+    /** The uniform block indices, resolved at link time */
+    std::unordered_map<std::string, GLuint> _uniblockindices;
     /** Mappings of uniforms to a uniform block */
     std::unordered_map<GLint, GLint>        _uniblockfields;
 
@@ -208,6 +292,17 @@ private:
      */
     void cacheUniforms();
     
+    /**
+     * Returns the index of the given uniform block
+     *
+     * If name is not a valid uniform block, this method returns GL_INVALID_INDEX.
+     *
+     * @param name  The uniform block name
+     *
+     * @return the index of the given uniform block
+     */
+    GLuint getUniformBlockIndex(const std::string& name) const;
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -343,7 +438,9 @@ public:
     /**
      * Returns the program offset of the given attribute
      *
-     * If name is not a valid attribute, this method returns -1.
+     * The offset is cached when the shader is linked, so this method does
+     * not query OpenGL. If name is not a valid attribute, this method
+     * returns -1.
      *
      * @param name  The attribute variable name
      *
@@ -351,6 +448,19 @@ public:
      */
     GLint getAttributeLocation(const std::string name) const;
     
+    /**
+     * Returns a handle to the given attribute
+     *
+     * The handle is resolved when the shader is linked, and remains valid
+     * for the lifetime of this shader. If name is not a valid attribute, the
+     * handle has location -1.
+     *
+     * @param name  The attribute variable name
+     *
+     * @return a handle to the given attribute
+     */
+    Attribute getAttributeHandle(const std::string name) const;
+    
     /**
      * Returns the size (in bytes) of the given attribute
      *
@@ -409,6 +519,8 @@ public:
     /**
      * Returns the program offset of the given uniform
      *
+     * The offset is cached when the shader is linked, so this method does
+     * not query OpenGL (except for individual elements of an array uniform).
      * If name is not a valid uniform, this method returns -1.
      *
      * @param name  The uniform variable name
@@ -417,6 +529,21 @@ public:
      */
     GLint getUniformLocation(const std::string name) const;
 
+    /**
+     * Returns a handle to the given uniform
+     *
+     * The handle is resolved when the shader is linked, and remains valid
+     * for the lifetime of this shader.  Classes that set the same uniform
+     * every frame should acquire a handle once and pass it to the setters
+     * instead of the name. If name is not a valid uniform, the handle has
+     * location -1.
+     *
+     * @param name  The uniform variable name
+     *
+     * @return a handle to the given uniform
+     */
+    Uniform getUniformHandle(const std::string name) const;
+
     /**
      * Returns the size (in bytes) of the given uniform
      *
@@ -50,6 +50,7 @@
 #include <vector>
 #include "CUSpriteVertex.h"
 #include "CUMesh.h"
+#include "CUShader.h"
 #include <cugl/math/CUMathBase.h>
 #include <cugl/math/CUMat4.h>
 #include <cugl/math/CUColor4.h>
@@ -62,7 +63,6 @@ namespace cugl {
 /** Forward references */
 class VertexBuffer;
 class UniformBuffer;
-class Shader;
 class Affine2;
 class Texture;
 class Gradient;
@@ -181,6 +181,12 @@ private:
     std::shared_ptr<VertexBuffer>  _vertbuff;
     /** The vertex buffer for this sprite batch */
     std::shared_ptr<UniformBuffer> _unifbuff;
+    /** The draw type uniform of the shader */
+    Shader::Uniform _uType;
+    /** The perspective uniform of the shader */
+    Shader::Uniform _uPerspective;
+    /** The blur offset uniform of the shader */
+    Shader::Uniform _uBlur;
     
     /** The sprite batch vertex mesh */
     SpriteVertex3* _vertData;
@@ -482,6 +488,27 @@ public:
      */
     unsigned int getCallsMade() const { return _callTotal; }
 
+    /**
+     * Returns the number of bytes of vertex data uploaded in the latest pass (so far).
+     *
+     * This includes both vertices and indices.  This value will be reset to 0
+     * whenever begin() is called.
+     *
+     * @return the number of bytes of vertex data uploaded in the latest pass (so far).
+     */
+    Uint64 getBytesUploaded() const;
+
+    /**
+     * Returns the number of vertex buffer allocations in the latest pass (so far).
+     *
+     * A sprite batch streams its vertices into a ring that is allocated once,
+     * so this value should always be 0.  It will be reset to 0 whenever
+     * begin() is called.
+     *
+     * @return the number of vertex buffer allocations in the latest pass (so far).
+     */
+    Uint32 getBufferReallocations() const;
+
     /**
      * Sets the shader for this sprite batch
      *
@@ -1083,6 +1110,77 @@ public:
      * @param tint      Whether to tint with the active color
      */
     void fill(const Mesh<SpriteVertex2>& mesh, const Mat4& transform, bool tint = true);
+
+    /**
+     * Fills the given mesh with the current texture, offsetting its texture coordinates.
+     *
+     * This method is identical to {@link fill(const Mesh<SpriteVertex2>&, const Mat4&, bool)}
+     * except that texoffset is added to the texture coordinates of every vertex
+     * as it is copied into the vertex buffer. The mesh itself is not modified.
+     * This allows a sprite sheet to select its frame per draw, without any
+     * changes to its geometry. As the offset is baked into the vertices, it
+     * does not break the batch the way a uniform would.
+     *
+     * @param mesh      The sprite mesh
+     * @param transform The coordinate transform
+     * @param texoffset The offset to add to each texture coordinate
+     * @param tint      Whether to tint with the active color
+     */
+    void fill(const Mesh<SpriteVertex2>& mesh, const Mat4& transform, const Vec2 texoffset, bool tint = true);
+
+    /**
+     * Fills the given mesh with the current texture and/or gradient.
+     *
+     * This method is identical to {@link fill(const Mesh<SpriteVertex2>&, const Mat4&, bool)}
+     * except that the transform is a 2d affine map. Each vertex is then
+     * transformed with 4 multiplies instead of a full matrix product, and
+     * given the current depth. This is the fast path for a planar scene graph.
+     *
+     * @param mesh      The sprite mesh
+     * @param transform The coordinate transform
+     * @param tint      Whether to tint with the active color
+     */
+    void fill(const Mesh<SpriteVertex2>& mesh, const Affine2& transform, bool tint = true);
+
+    /**
+     * Fills the given mesh with the current texture, offsetting its texture coordinates.
+     *
+     * This method is identical to {@link fill(const Mesh<SpriteVertex2>&, const Mat4&, const Vec2, bool)}
+     * except that the transform is a 2d affine map. Each vertex is then
+     * transformed with 4 multiplies instead of a full matrix product, and
+     * given the current depth. This is the fast path for a planar scene graph.
+     *
+     * @param mesh      The sprite mesh
+     * @param transform The coordinate transform
+     * @param texoffset The offset to add to each texture coordinate
+     * @param tint      Whether to tint with the active color
+     */
+    void fill(const Mesh<SpriteVertex2>& mesh, const Affine2& transform, const Vec2 texoffset, bool tint = true);
+
+    /**
+     * Fills a copy of the given mesh for each instance with the current texture.
+     *
+     * Each copy is scaled and rotated about the pivot, and then moved so that
+     * the pivot is at the instance position (as if the mesh were a child node
+     * with the pivot as its anchor). The copies are then transformed by the
+     * given transform. The mesh vertices use their own color values, multiplied
+     * by the instance color. If tint is true, these values are also tinted by
+     * the current active color.
+     *
+     * All of the copies are expanded into the vertex buffer in one pass, with
+     * the transform folded into a 2d affine map per instance. This is much
+     * cheaper than filling the mesh once per instance. The mesh must fit in
+     * the vertex buffer.
+     *
+     * @param mesh      The sprite mesh
+     * @param instances The instance placements
+     * @param count     The number of instances
+     * @param pivot     The point of the mesh placed at each instance position
+     * @param transform The coordinate transform
+     * @param tint      Whether to tint with the active color
+     */
+    void fill(const Mesh<SpriteVertex2>& mesh, const SpriteInstance* instances, size_t count,
+              const Vec2 pivot, const Mat4& transform, bool tint = true);
     
     /**
      * Fills the given mesh with the current texture and/or gradient.
@@ -1341,6 +1439,20 @@ public:
      * @param tint      Whether to tint with the active color
      */
     void outline(const Mesh<SpriteVertex2>& mesh, const Mat4& transform, bool tint = true);
+
+    /**
+     * Outlines the given mesh with the current texture and/or gradient.
+     *
+     * This method is identical to {@link outline(const Mesh<SpriteVertex2>&, const Mat4&, bool)}
+     * except that the transform is a 2d affine map. Each vertex is then
+     * transformed with 4 multiplies instead of a full matrix product, and
+     * given the current depth. This is the fast path for a planar scene graph.
+     *
+     * @param mesh      The sprite mesh
+     * @param transform The coordinate transform
+     * @param tint      Whether to tint with the active color
+     */
+    void outline(const Mesh<SpriteVertex2>& mesh, const Affine2& transform, bool tint = true);
     
     /**
      * Outlines the given mesh with the current texture and/or gradient.
@@ -2046,13 +2158,15 @@ private:
      * If depth testing is on, all vertices will use the current sprite
      * batch depth.
      *
-     * @param mesh  The mesh to add to the buffer
-     * @param mat   The transform to apply to the vertices
-     * @param tint  Whether to tint with the active color
+     * @param mesh      The mesh to add to the buffer
+     * @param mat       The transform to apply to the vertices
+     * @param tint      Whether to tint with the active color
+     * @param texoffset The offset to add to each texture coordinate
      *
      * @return the number of vertices added to the drawing buffer.
      */
-    unsigned int prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint = true);
+    unsigned int prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint = true,
+                         const Vec2 texoffset = Vec2::ZERO);
 
     /**
      * Returns the number of vertices added to the drawing buffer.
@@ -2066,13 +2180,58 @@ private:
      * If depth testing is on, all vertices will use the current sprite
      * batch depth.
      *
-     * @param mesh  The mesh to add to the buffer
-     * @param mat   The transform to apply to the vertices
-     * @param tint  Whether to tint with the active color
+     * @param mesh      The mesh to add to the buffer
+     * @param mat       The transform to apply to the vertices
+     * @param tint      Whether to tint with the active color
+     * @param texoffset The offset to add to each texture coordinate
+     *
+     * @return the number of vertices added to the drawing buffer.
+     */
+    unsigned int chunkify(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint = true,
+                          const Vec2 texoffset = Vec2::ZERO);
+
+    /**
+     * Returns the number of vertices added to the drawing buffer.
+     *
+     * This method adds the given mesh (both vertices and indices) to the
+     * vertex buffer, but does not draw it.  It is the 2d fast path of the
+     * matrix version, transforming each vertex by an affine map. All
+     * vertices use the current sprite batch depth.
+     *
+     * If the mesh is too large to fit in the buffer, it is drawn in chunks
+     * with the matrix version.
+     *
+     * @param mesh      The mesh to add to the buffer
+     * @param mat       The transform to apply to the vertices
+     * @param tint      Whether to tint with the active color
+     * @param texoffset The offset to add to each texture coordinate
+     *
+     * @return the number of vertices added to the drawing buffer.
+     */
+    unsigned int prepare(const Mesh<SpriteVertex2>& mesh, const Affine2& mat, bool tint = true,
+                         const Vec2 texoffset = Vec2::ZERO);
+
+    /**
+     * Returns the number of vertices added to the drawing buffer.
+     *
+     * This method adds a copy of the given mesh (both vertices and indices)
+     * for each instance to the vertex buffer, but does not draw it. It will
+     * automatically flush between copies if the buffer is full.
+     *
+     * If depth testing is on, all vertices will use the current sprite
+     * batch depth.
+     *
+     * @param mesh      The mesh to add to the buffer
+     * @param instances The instance placements
+     * @param count     The number of instances
+     * @param pivot     The point of the mesh placed at each instance position
+     * @param mat       The transform to apply to the vertices
+     * @param tint      Whether to tint with the active color
      *
      * @return the number of vertices added to the drawing buffer.
      */
-    unsigned int chunkify(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint = true);
+    unsigned int prepare(const Mesh<SpriteVertex2>& mesh, const SpriteInstance* instances, size_t count,
+                         const Vec2 pivot, const Mat4& mat, bool tint);
     
     /**
      * Returns the number of vertices added to the drawing buffer.
@@ -97,6 +97,26 @@ public:
     static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(SpriteVertex2, texcoord);  }
 };
 
+/**
+ * This class/struct is the placement of one copy of an instanced sprite.
+ *
+ * The class is intended to be used as a struct.  A {@link SpriteBatch} can
+ * fill many copies of the same mesh in a single call, one for each instance.
+ * Each copy is scaled and rotated about a common pivot, and then moved to
+ * the instance position.  The instance color multiplies the vertex colors.
+ */
+class SpriteInstance {
+public:
+    /** The instance position */
+    cugl::Vec2    position;
+    /** The uniform scale of the instance */
+    float         scale;
+    /** The counter-clockwise rotation of the instance in radians */
+    float         angle;
+    /** The instance color */
+    cugl::Vec4    color;
+};
+
 }
 
 #endif /* __CU_VERTEX_H__ */
@@ -46,10 +46,13 @@
 #define __CU_VERTEX_BUFFER_H__
 
 #include <string>
+#include <vector>
 #include <unordered_map>
 #include <cugl/math/CUMathBase.h>
 #include <cugl/math/CUMat4.h>
 
+/** The default number of regions in a streaming vertex buffer */
+#define CU_STREAM_REGIONS   3
 
 namespace cugl {
 
@@ -99,6 +102,28 @@ private:
         GLsizeiptr offset;
     };
     
+    /**
+     * A data type for keeping track of a streaming ring.
+     *
+     * A ring is a buffer allocated once and written front to back.  It is
+     * split into regions, and each region is guarded by a fence once the
+     * writes move past it.  A region is only reused once its fence shows
+     * that the GPU is done with it.
+     */
+    class RingData {
+    public:
+        /** The buffer target (GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER) */
+        GLenum target;
+        /** The capacity of the ring in bytes */
+        GLsizeiptr capacity;
+        /** The next free byte of the ring */
+        GLsizeiptr head;
+        /** The first region written since the last fence */
+        Uint32 pending;
+        /** The fence for each region (nullptr if the region is free) */
+        std::vector<GLsync> fences;
+    };
+    
     /** The data stride of this buffer (0 if there is only one attribute) */
     GLsizei _stride;
 
@@ -117,6 +142,58 @@ private:
     /** The settings for each attribute */
     std::unordered_map<std::string, AttribData> _attributes;
     
+    /** The number of regions in each ring (0 if not streaming) */
+    Uint32 _regions;
+    /** The streaming ring for the vertex buffer */
+    RingData _vertRing;
+    /** The streaming ring for the index buffer */
+    RingData _indxRing;
+    /** Whether to stream with unsynchronized buffer mapping */
+    bool _mapping;
+    /** Scratch space to offset indices when not mapping */
+    std::vector<GLuint> _scratch;
+    
+    /** The number of bytes uploaded since the last reset */
+    Uint64 _bytesUploaded;
+    /** The number of buffer (re)allocations since the last reset */
+    Uint32 _reallocations;
+    /** The number of times a ring wrapped since the last reset */
+    Uint32 _wraps;
+    /** The number of times the CPU waited on the GPU since the last reset */
+    Uint32 _stalls;
+    
+    /**
+     * Returns the byte offset of a new block in the given ring.
+     *
+     * This method places fences on every region behind the new block, and
+     * waits for the GPU to release any region that the block overlaps.
+     * If the block does not fit at the end of the ring, it wraps around to
+     * the start.
+     *
+     * @param ring  The streaming ring
+     * @param size  The size of the block in bytes
+     * @param align The alignment of the block in bytes
+     *
+     * @return the byte offset of a new block in the given ring.
+     */
+    GLsizeiptr reserve(RingData& ring, GLsizeiptr size, GLsizeiptr align);
+    
+    /**
+     * Places a fence on the given regions of the ring
+     *
+     * @param ring  The streaming ring
+     * @param start The first region to fence
+     * @param end   The region after the last one to fence
+     */
+    void fence(RingData& ring, Uint32 start, Uint32 end);
+    
+    /**
+     * Deletes all fences of the given ring
+     *
+     * @param ring  The streaming ring
+     */
+    void clear(RingData& ring);
+    
 public:
 #pragma mark Constructors
     /**
@@ -174,6 +251,59 @@ public:
         std::shared_ptr<VertexBuffer> result = std::make_shared<VertexBuffer>();
         return (result->init(stride) ? result : nullptr);
     }
+    
+    /**
+     * Initializes this vertex buffer as a streaming ring with the given stride.
+     *
+     * A streaming vertex buffer allocates its vertex and index buffers once,
+     * with room for the given number of regions.  Each region holds the given
+     * number of vertices and indices.  Data is then added with the methods
+     * {@link streamVertexData} and {@link streamIndexData}, which write each
+     * block after the last one and return its offset.  Nothing is ever
+     * reallocated, and a region is only overwritten once the GPU has finished
+     * drawing from it.  Regions are typically sized to a single batch, so
+     * that several batches (or frames) may be in flight at once.
+     *
+     * A streaming buffer must not be used with {@link loadVertexData} or
+     * {@link loadIndexData}.
+     *
+     * @param stride    The size of a single piece of vertex data.
+     * @param vertices  The number of vertices in each region
+     * @param indices   The number of indices in each region
+     * @param regions   The number of regions
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithStream(GLsizei stride, GLsizei vertices, GLsizei indices,
+                        Uint32 regions=CU_STREAM_REGIONS);
+    
+    /**
+     * Returns a new streaming vertex buffer with the given stride.
+     *
+     * A streaming vertex buffer allocates its vertex and index buffers once,
+     * with room for the given number of regions.  Each region holds the given
+     * number of vertices and indices.  Data is then added with the methods
+     * {@link streamVertexData} and {@link streamIndexData}, which write each
+     * block after the last one and return its offset.  Nothing is ever
+     * reallocated, and a region is only overwritten once the GPU has finished
+     * drawing from it.  Regions are typically sized to a single batch, so
+     * that several batches (or frames) may be in flight at once.
+     *
+     * A streaming buffer must not be used with {@link loadVertexData} or
+     * {@link loadIndexData}.
+     *
+     * @param stride    The size of a single piece of vertex data.
+     * @param vertices  The number of vertices in each region
+     * @param indices   The number of indices in each region
+     * @param regions   The number of regions
+     *
+     * @return a new streaming vertex buffer with the given stride.
+     */
+    static std::shared_ptr<VertexBuffer> allocWithStream(GLsizei stride, GLsizei vertices, GLsizei indices,
+                                                         Uint32 regions=CU_STREAM_REGIONS) {
+        std::shared_ptr<VertexBuffer> result = std::make_shared<VertexBuffer>();
+        return (result->initWithStream(stride,vertices,indices,regions) ? result : nullptr);
+    }
 
 
 #pragma mark -
@@ -307,6 +437,121 @@ public:
      */
     void loadIndexData(const void * data, GLsizei size, GLenum usage=GL_STREAM_DRAW);
     
+#pragma mark -
+#pragma mark Streaming
+    /**
+     * Returns true if this vertex buffer is a streaming ring.
+     *
+     * @return true if this vertex buffer is a streaming ring.
+     */
+    bool isStreaming() const { return _regions > 0; }
+    
+    /**
+     * Returns the index of the first vertex after streaming the given data.
+     *
+     * The vertices are written after those of the previous call, wrapping
+     * around to the start of the ring when necessary.  The result is the
+     * position of the first vertex in the ring, which must be added to the
+     * indices that refer to these vertices (see {@link streamIndexData}).
+     *
+     * The number of vertices may not exceed the size of the ring.  This
+     * method will only succeed if this buffer is actively bound.
+     *
+     * @param data  The data to stream
+     * @param size  The number of vertices to stream
+     *
+     * @return the index of the first vertex after streaming the given data.
+     */
+    GLsizei streamVertexData(const void * data, GLsizei size);
+    
+    /**
+     * Returns the position of the first index after streaming the given data.
+     *
+     * The indices are written after those of the previous call, wrapping
+     * around to the start of the ring when necessary.  Each index is offset
+     * by base as it is written, so that it refers to vertices streamed by
+     * {@link streamVertexData}.  The result should be added to the offset
+     * of any draw call using these indices.
+     *
+     * The number of indices may not exceed the size of the ring.  This
+     * method will only succeed if this buffer is actively bound.
+     *
+     * @param data  The indices to stream
+     * @param size  The number of indices to stream
+     * @param base  The position of the first vertex
+     *
+     * @return the position of the first index after streaming the given data.
+     */
+    GLsizei streamIndexData(const GLuint * data, GLsizei size, GLuint base=0);
+    
+    /**
+     * Sets whether to stream with unsynchronized buffer mapping.
+     *
+     * If true, blocks are written with glMapBufferRange, skipping the
+     * driver synchronization (the ring fences make this safe).  Otherwise,
+     * blocks are written with glBufferSubData.  Mapping is on by default,
+     * but is turned off automatically if the driver refuses to map.
+     *
+     * @param value Whether to stream with unsynchronized buffer mapping.
+     */
+    void setMapping(bool value) { _mapping = value; }
+    
+    /**
+     * Returns true if this buffer streams with unsynchronized buffer mapping.
+     *
+     * @return true if this buffer streams with unsynchronized buffer mapping.
+     */
+    bool isMapping() const { return _mapping; }
+    
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the number of bytes uploaded since the last reset.
+     *
+     * This includes both vertices and indices.
+     *
+     * @return the number of bytes uploaded since the last reset.
+     */
+    Uint64 getBytesUploaded() const { return _bytesUploaded; }
+
+    /**
+     * Returns the number of buffer (re)allocations since the last reset.
+     *
+     * Every call to {@link loadVertexData} or {@link loadIndexData} allocates
+     * new storage for the buffer.  A streaming buffer only allocates storage
+     * when it is initialized.
+     *
+     * @return the number of buffer (re)allocations since the last reset.
+     */
+    Uint32 getReallocations() const { return _reallocations; }
+
+    /**
+     * Returns the number of times a ring wrapped since the last reset.
+     *
+     * @return the number of times a ring wrapped since the last reset.
+     */
+    Uint32 getWraps() const { return _wraps; }
+
+    /**
+     * Returns the number of times the CPU waited on the GPU since the last reset.
+     *
+     * A stall happens when a streaming ring wraps onto a region that the GPU
+     * is still drawing from.  If this happens often, the ring needs more
+     * regions.
+     *
+     * @return the number of times the CPU waited on the GPU since the last reset.
+     */
+    Uint32 getStalls() const { return _stalls; }
+
+    /**
+     * Resets all of the statistics to zero.
+     *
+     * This is typically called at the start of a frame.
+     */
+    void resetStats();
+    
+#pragma mark -
+#pragma mark Drawing
     /**
      * Draws to the active framebuffer using this vertex buffer
      *
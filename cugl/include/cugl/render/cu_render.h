@@ -37,6 +37,7 @@
 #include "CUShader.h"
 #include "CUUniformBuffer.h"
 #include "CURenderTarget.h"
+#include "CUGLRecorder.h"
 #include "CUSpriteBatch.h"
 #include "CUCamera.h"
 #include "CUOrthographicCamera.h"
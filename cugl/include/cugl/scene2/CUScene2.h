@@ -91,6 +91,8 @@ protected:
 
     /** Whether or note this scene is still active */
     bool _active;
+    /** Whether to combine node transforms as 2d affine maps */
+    bool _planar;
 
 #pragma mark -
 #pragma mark Constructors
@@ -329,6 +331,33 @@ public:
      */
     void setColor(Color4 color) { _color = color; }
     
+    /**
+     * Returns true if this scene renders with 2d transforms.
+     *
+     * See {@link setPlanar} for details.
+     *
+     * @return true if this scene renders with 2d transforms.
+     */
+    bool isPlanar() const { return _planar; }
+
+    /**
+     * Sets whether this scene renders with 2d transforms.
+     *
+     * If true, the scene graph is traversed with {@link Affine2} maps rather
+     * than 4x4 matrices, and the nodes that support it submit their vertices
+     * with those maps. The camera is still applied as a matrix by the sprite
+     * batch. This is much cheaper for a large graph, and gives the same
+     * picture unless a node has an alternate transform out of the plane (in
+     * which case that subtree falls back to matrices on its own).
+     *
+     * A custom node overriding the matrix version of draw must also override
+     * the affine version if its base class does. See {@link SceneNode#draw}.
+     * This value is false by default.
+     *
+     * @param value Whether this scene renders with 2d transforms.
+     */
+    void setPlanar(bool value) { _planar = value; }
+
     /**
      * Returns a string representation of this scene for debugging purposes.
      *
@@ -34,9 +34,11 @@
 #include "graph/CUTexturedNode.h"
 #include "graph/CUPolygonNode.h"
 #include "graph/CUWireNode.h"
+#include "graph/CUInstanceNode.h"
 #include "graph/CUPathNode.h"
 #include "graph/CUAnimationNode.h"
 #include "graph/CUAnimationNode.h"
+#include "graph/CUAnimationClock.h"
 #include "ui/CUButton.h"
 #include "ui/CULabel.h"
 #include "ui/CUProgressBar.h"
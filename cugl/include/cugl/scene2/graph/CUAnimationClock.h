@@ -0,0 +1,290 @@
+//
+//  CUAnimationClock.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a central clock for sprite sheet animation.  Rather
+//  than having every AnimationNode count frames in its own draw method, the
+//  nodes register a track with a shared clock.  The clock stores the tracks
+//  contiguously and advances all of them in a single pass once per frame.
+//  Because an AnimationNode picks its frame with a texture offset at draw
+//  time, advancing a track never touches any geometry.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_ANIMATION_CLOCK_H__
+#define __CU_ANIMATION_CLOCK_H__
+
+#include <cugl/base/CUBase.h>
+#include <vector>
+
+namespace cugl {
+
+    /**
+     * The classes to construct an 2-d scene graph.
+     *
+     * This namespace was chosen to future-proof the game engine. We will
+     * eventually want to add 3-d scene graphs as well, and this namespace
+     * will prevent any collisions with those scene graph nodes.
+     */
+    namespace scene2 {
+
+class AnimationNode;
+
+#pragma mark -
+#pragma mark AnimationClock
+/**
+ * A central clock that advances sprite sheet animations in one pass.
+ *
+ * Each {@link AnimationNode} attached to a clock owns a single track.  A track
+ * plays a range of frames at a fixed rate (in clock ticks per frame), either
+ * looping, bouncing back and forth, or playing once and stopping.  The tracks
+ * are stored in a contiguous array, and {@link update} advances every playing
+ * track at once.  The clock is meant to be ticked once per animation frame.
+ *
+ * A frame advances on the first tick after a track starts playing, and then
+ * once every interval ticks.  This matches the frame counters that animation
+ * nodes have traditionally kept in their draw methods.
+ *
+ * The clock does not own its nodes.  A node removes its track when it is
+ * disposed, and so you should never register a node by hand.  Instead, use
+ * {@link AnimationNode#setClock} and {@link AnimationNode#play}.
+ *
+ * This class is not thread safe.
+ */
+class AnimationClock {
+public:
+    /** The playback mode of a track */
+    enum class Mode : int {
+        /** Return to the first frame after the last one */
+        LOOP   = 0,
+        /** Stop (and mark the track finished) at the last frame */
+        ONCE   = 1,
+        /** Reverse direction at either end of the range */
+        BOUNCE = 2
+    };
+
+    /** The key for a missing track */
+    static const Uint32 INVALID_KEY = (Uint32)-1;
+
+protected:
+    /** A single animation track */
+    struct Track {
+        /** The animated node */
+        AnimationNode* node;
+        /** The key identifying this track */
+        Uint32 key;
+        /** The first frame of the range */
+        int first;
+        /** The last frame of the range (inclusive) */
+        int last;
+        /** The direction of play (+1 or -1) */
+        int step;
+        /** The number of ticks between frames */
+        Uint32 interval;
+        /** The ticks until the next frame */
+        Uint32 counter;
+        /** The playback mode */
+        Mode mode;
+        /** Whether this track is advancing */
+        bool playing;
+        /** Whether a ONCE track reached its last frame */
+        bool finished;
+    };
+
+    /** The tracks, stored contiguously */
+    std::vector<Track> _tracks;
+    /** For each key, the index of its track (or INVALID_KEY if unused) */
+    std::vector<Uint32> _slots;
+    /** The keys available for reuse */
+    std::vector<Uint32> _freekeys;
+    /** The number of ticks since this clock was initialized */
+    Uint64 _ticks;
+
+    /**
+     * Returns the track for the given key.
+     *
+     * @param key   The track key
+     *
+     * @return the track for the given key.
+     */
+    Track& getTrack(Uint32 key);
+
+    /**
+     * Returns the track for the given key.
+     *
+     * @param key   The track key
+     *
+     * @return the track for the given key.
+     */
+    const Track& getTrack(Uint32 key) const;
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates a clock with no tracks.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a clock on
+     * the heap, use one of the static constructors instead.
+     */
+    AnimationClock();
+
+    /**
+     * Deletes this clock, releasing all resources.
+     */
+    ~AnimationClock() { dispose(); }
+
+    /**
+     * Disposes this clock, releasing all resources.
+     *
+     * All of the tracks are removed.  You should detach every node from the
+     * clock before disposing it.
+     */
+    void dispose();
+
+    /**
+     * Initializes a clock with room for the given number of tracks.
+     *
+     * The clock will grow beyond this capacity if necessary.
+     *
+     * @param capacity  The number of tracks to reserve
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(size_t capacity=0);
+
+    /**
+     * Returns a newly allocated clock with room for the given number of tracks.
+     *
+     * The clock will grow beyond this capacity if necessary.
+     *
+     * @param capacity  The number of tracks to reserve
+     *
+     * @return a newly allocated clock with room for the given number of tracks.
+     */
+    static std::shared_ptr<AnimationClock> alloc(size_t capacity=0) {
+        std::shared_ptr<AnimationClock> result = std::make_shared<AnimationClock>();
+        return (result->init(capacity) ? result : nullptr);
+    }
+
+#pragma mark Tracks
+    /**
+     * Returns the key of a new (stopped) track for the given node.
+     *
+     * This method is called by {@link AnimationNode#setClock}, and should not
+     * be called directly.
+     *
+     * @param node  The node to animate
+     *
+     * @return the key of a new (stopped) track for the given node.
+     */
+    Uint32 add(AnimationNode* node);
+
+    /**
+     * Removes the track with the given key.
+     *
+     * This method is called when an {@link AnimationNode} is disposed, and
+     * should not be called directly.
+     *
+     * @param key   The track key
+     */
+    void remove(Uint32 key);
+
+    /**
+     * Starts playing the given track.
+     *
+     * The track starts from the current frame of its node, clamped to the
+     * range.  A BOUNCE track starting at the last frame plays backwards.
+     *
+     * @param key       The track key
+     * @param first     The first frame of the range
+     * @param last      The last frame of the range (inclusive)
+     * @param interval  The number of ticks between frames
+     * @param mode      The playback mode
+     */
+    void play(Uint32 key, int first, int last, Uint32 interval, Mode mode);
+
+    /**
+     * Stops the given track, leaving its node at the current frame.
+     *
+     * @param key   The track key
+     */
+    void stop(Uint32 key);
+
+    /**
+     * Returns true if the given track is advancing.
+     *
+     * @param key   The track key
+     *
+     * @return true if the given track is advancing.
+     */
+    bool isPlaying(Uint32 key) const { return getTrack(key).playing; }
+
+    /**
+     * Returns true if the given ONCE track has reached its last frame.
+     *
+     * @param key   The track key
+     *
+     * @return true if the given ONCE track has reached its last frame.
+     */
+    bool isFinished(Uint32 key) const { return getTrack(key).finished; }
+
+    /**
+     * Returns the number of tracks on this clock.
+     *
+     * @return the number of tracks on this clock.
+     */
+    size_t size() const { return _tracks.size(); }
+
+    /**
+     * Returns the number of ticks since this clock was initialized.
+     *
+     * @return the number of ticks since this clock was initialized.
+     */
+    Uint64 getTicks() const { return _ticks; }
+
+#pragma mark Animation
+    /**
+     * Advances every playing track by the given number of ticks.
+     *
+     * This is a single pass over the track array.  A node is only told to
+     * change frame if its frame actually changes.
+     *
+     * @param ticks The number of ticks to advance
+     */
+    void update(Uint32 ticks=1);
+};
+
+    }
+}
+
+#endif /* __CU_ANIMATION_CLOCK_H__ */
@@ -45,6 +45,7 @@
 #define __CU_ANIMATION_NODE_H__
 
 #include <cugl/scene2/graph/CUPolygonNode.h>
+#include <cugl/scene2/graph/CUAnimationClock.h>
 #include <cugl/math/CURect.h>
 #include <cugl/render/CUTexture.h>
 
@@ -82,6 +83,12 @@ namespace cugl {
  * and height.  Setting the polygon to a triangle with vertices (0,0), 
  * (width/2, height), and (width,height) is okay.  However, the vertices (0,0), 
  * (width, 2*height), and (2*width, height) are not okay.
+ *
+ * The mesh for this node is only built once.  Changing the frame simply
+ * records a texture offset, which is applied as the mesh is copied into the
+ * {@link SpriteBatch}.  Hence changing frames never touches any geometry,
+ * and animation nodes sharing a texture still batch together.  To advance
+ * many animations at once, attach the nodes to an {@link AnimationClock}.
  */
 class AnimationNode : public PolygonNode {
 protected:
@@ -93,6 +100,12 @@ protected:
     int _frame;
     /** The size of a single animation frame (different from active polygon) */
     Rect _bounds;
+    /** The frame origin that the mesh texture coordinates were built for */
+    Vec2 _base;
+    /** The clock advancing this animation (may be null) */
+    std::shared_ptr<AnimationClock> _clock;
+    /** The key of this node's track on the clock */
+    Uint32 _track;
    
 #pragma mark -
 #pragma mark Constructors
@@ -116,6 +129,16 @@ public:
      */
     ~AnimationNode() { dispose(); }
 
+    /**
+     * Disposes all of the resources used by this node.
+     *
+     * A disposed Node can be safely reinitialized. Any children owned by this
+     * node will be released.  They will be deleted if no other object owns them.
+     *
+     * This method also removes this node from its animation clock.
+     */
+    virtual void dispose() override;
+
     /**
      * Initializes the film strip with the given texture.
      *
@@ -282,7 +305,98 @@ public:
      * @param frame the index to make the active frame
      */
     void setFrame(int frame);
- 
+
+#pragma mark -
+#pragma mark Animation Clock
+    /**
+     * Returns the clock advancing this animation.
+     *
+     * @return the clock advancing this animation.
+     */
+    const std::shared_ptr<AnimationClock>& getClock() const { return _clock; }
+
+    /**
+     * Sets the clock advancing this animation.
+     *
+     * The node is removed from any previous clock.  Its track on the new
+     * clock is stopped until {@link play} is called.  Subclasses may
+     * override this method to attach child nodes or to start a default
+     * animation.
+     *
+     * @param clock The clock advancing this animation (may be null)
+     */
+    virtual void setClock(const std::shared_ptr<AnimationClock>& clock);
+
+    /**
+     * Plays the given range of frames on the animation clock.
+     *
+     * The animation starts at the current frame, clamped to the range.  The
+     * node must have a clock.
+     *
+     * @param first     The first frame of the range
+     * @param last      The last frame of the range (inclusive)
+     * @param interval  The number of clock ticks between frames
+     * @param mode      The playback mode
+     */
+    void play(int first, int last, Uint32 interval,
+              AnimationClock::Mode mode = AnimationClock::Mode::LOOP);
+
+    /**
+     * Stops this animation, leaving it at the current frame.
+     *
+     * This method does nothing if the node has no clock.
+     */
+    void stop();
+
+    /**
+     * Returns true if this animation is advancing on its clock.
+     *
+     * @return true if this animation is advancing on its clock.
+     */
+    bool isPlaying() const {
+        return _clock != nullptr && _clock->isPlaying(_track);
+    }
+
+    /**
+     * Returns true if this animation played once to its last frame.
+     *
+     * @return true if this animation played once to its last frame.
+     */
+    bool isFinished() const {
+        return _clock != nullptr && _clock->isFinished(_track);
+    }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws this Node via the given SpriteBatch.
+     *
+     * This method only worries about drawing the current node.  It does not
+     * attempt to render the children.
+     *
+     * This method draws the mesh built for the original frame, and selects
+     * the active frame with a texture offset.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch,
+                      const Mat4& transform, Color4 tint) override;
+
+    /**
+     * Draws this Node via the given SpriteBatch with a 2d transform.
+     *
+     * This is the fast path used by a planar scene graph. It is identical
+     * to the matrix version, except that the vertices are transformed by
+     * the affine map directly.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) override;
+
 };
     }
 }
@@ -0,0 +1,349 @@
+//
+//  CUInstanceNode.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a scene graph node that draws many copies of a single
+//  sprite.  Drawing a PolygonNode once per copy, with a fresh transform and
+//  color each time, sends every copy through the full sprite batch prepare
+//  path.  This node instead keeps an array of instance records (position,
+//  scale, rotation and color) and hands them to the sprite batch in a single
+//  call, which expands them into the vertex buffer in one pass.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_INSTANCE_NODE_H__
+#define __CU_INSTANCE_NODE_H__
+
+#include <cugl/scene2/graph/CUSceneNode.h>
+#include <cugl/render/CUMesh.h>
+#include <cugl/render/CUSpriteVertex.h>
+#include <cugl/render/CUTexture.h>
+#include <vector>
+
+namespace cugl {
+
+    /**
+     * The classes to construct an 2-d scene graph.
+     *
+     * This namespace was chosen to future-proof the game engine. We will
+     * eventually want to add 3-d scene graphs as well, and this namespace
+     * will prevent any collisions with those scene graph nodes.
+     */
+    namespace scene2 {
+
+#pragma mark -
+#pragma mark InstanceNode
+/**
+ * This is a scene graph node that draws many copies of one texture region.
+ *
+ * Each copy is described by a {@link SpriteInstance}. The region is scaled
+ * and rotated about its pivot, and the pivot is then placed at the instance
+ * position in the coordinate space of this node. So a copy looks exactly
+ * like a {@link PolygonNode} child with the region as its texture, the pivot
+ * as its anchor, and the instance position, scale and angle. The instance
+ * color multiplies the tint of this node.
+ *
+ * All of the copies are drawn with a single call to the sprite batch, which
+ * expands them into its vertex buffer in one pass. This is much cheaper than
+ * a child node per copy, or a node drawn once per copy, and it never breaks
+ * the batch.
+ *
+ * The content size of this node is unrelated to its instances. By default
+ * it is empty, so that the node transform is just its position, angle and
+ * scale.
+ */
+class InstanceNode : public SceneNode {
+#pragma mark Values
+protected:
+    /** The texture of the copies */
+    std::shared_ptr<Texture> _texture;
+    /** The texture region of the copies, in texture pixels */
+    Rect _region;
+    /** The pivot of the copies, relative to the region size */
+    Vec2 _pivot;
+    /** The region quad, in region pixels */
+    Mesh<SpriteVertex2> _mesh;
+    /** The copies to draw */
+    std::vector<SpriteInstance> _instances;
+
+    /** The blending equation for the copies */
+    GLenum _blendEquation;
+    /** The source factor for the blend function */
+    GLenum _srcFactor;
+    /** The destination factor for the blend function */
+    GLenum _dstFactor;
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Builds the region quad from the texture and region.
+     */
+    void updateMesh();
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an empty node with no instances.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a node on
+     * the heap, use one of the static constructors instead.
+     */
+    InstanceNode();
+
+    /**
+     * Deletes this node, releasing all resources.
+     */
+    ~InstanceNode() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this node.
+     *
+     * A disposed node can be safely reinitialized. Any children owned by
+     * this node will be released. They will be deleted if no other object
+     * owns them.
+     */
+    virtual void dispose() override;
+
+    /**
+     * Initializes a node drawing copies of the given texture.
+     *
+     * The region is the entire texture, and the pivot is its center.
+     *
+     * @param texture   The texture of the copies
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithTexture(const std::shared_ptr<Texture>& texture) {
+        return initWithTexture(texture, texture == nullptr ? Rect::ZERO :
+                               Rect(Vec2::ZERO,texture->getSize()));
+    }
+
+    /**
+     * Initializes a node drawing copies of the given texture region.
+     *
+     * The region is in texture pixels, with the origin at the bottom left
+     * corner of the texture. The pivot is the center of the region.
+     *
+     * @param texture   The texture of the copies
+     * @param region    The texture region of the copies
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithTexture(const std::shared_ptr<Texture>& texture, const Rect region);
+
+    /**
+     * Returns a newly allocated node drawing copies of the given texture.
+     *
+     * The region is the entire texture, and the pivot is its center.
+     *
+     * @param texture   The texture of the copies
+     *
+     * @return a newly allocated node drawing copies of the given texture.
+     */
+    static std::shared_ptr<InstanceNode> allocWithTexture(const std::shared_ptr<Texture>& texture) {
+        std::shared_ptr<InstanceNode> node = std::make_shared<InstanceNode>();
+        return (node->initWithTexture(texture) ? node : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated node drawing copies of the given texture region.
+     *
+     * The region is in texture pixels, with the origin at the bottom left
+     * corner of the texture. The pivot is the center of the region.
+     *
+     * @param texture   The texture of the copies
+     * @param region    The texture region of the copies
+     *
+     * @return a newly allocated node drawing copies of the given texture region.
+     */
+    static std::shared_ptr<InstanceNode> allocWithTexture(const std::shared_ptr<Texture>& texture,
+                                                          const Rect region) {
+        std::shared_ptr<InstanceNode> node = std::make_shared<InstanceNode>();
+        return (node->initWithTexture(texture,region) ? node : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the texture of the copies.
+     *
+     * @return the texture of the copies.
+     */
+    const std::shared_ptr<Texture>& getTexture() const { return _texture; }
+
+    /**
+     * Sets the texture of the copies.
+     *
+     * The region is reset to the entire texture.
+     *
+     * @param texture   The texture of the copies
+     */
+    void setTexture(const std::shared_ptr<Texture>& texture);
+
+    /**
+     * Returns the texture region of the copies, in texture pixels.
+     *
+     * @return the texture region of the copies, in texture pixels.
+     */
+    const Rect& getRegion() const { return _region; }
+
+    /**
+     * Sets the texture region of the copies, in texture pixels.
+     *
+     * The origin is at the bottom left corner of the texture.
+     *
+     * @param region    The texture region of the copies
+     */
+    void setRegion(const Rect region);
+
+    /**
+     * Returns the pivot of the copies, relative to the region size.
+     *
+     * The pivot is where each copy is scaled and rotated about, and it is
+     * placed at the instance position. It works like an anchor, with (0,0)
+     * the bottom left corner of the region and (1,1) the top right.
+     *
+     * @return the pivot of the copies, relative to the region size.
+     */
+    const Vec2& getPivot() const { return _pivot; }
+
+    /**
+     * Sets the pivot of the copies, relative to the region size.
+     *
+     * The pivot is where each copy is scaled and rotated about, and it is
+     * placed at the instance position. It works like an anchor, with (0,0)
+     * the bottom left corner of the region and (1,1) the top right.
+     *
+     * @param pivot     The pivot of the copies
+     */
+    void setPivot(const Vec2 pivot) { _pivot = pivot; }
+
+    /**
+     * Sets the blending function for the copies.
+     *
+     * This works exactly like {@link TexturedNode#setBlendFunc}.
+     *
+     * @param srcFactor Specifies how the source blending factors are computed
+     * @param dstFactor Specifies how the destination blending factors are computed.
+     */
+    void setBlendFunc(GLenum srcFactor, GLenum dstFactor) { _srcFactor = srcFactor; _dstFactor = dstFactor; }
+
+    /**
+     * Sets the blending equation for the copies.
+     *
+     * This works exactly like {@link TexturedNode#setBlendEquation}.
+     *
+     * @param equation  Specifies how source and destination colors are combined
+     */
+    void setBlendEquation(GLenum equation) { _blendEquation = equation; }
+
+#pragma mark -
+#pragma mark Instances
+    /**
+     * Returns the number of copies to draw.
+     *
+     * @return the number of copies to draw.
+     */
+    size_t getInstanceCount() const { return _instances.size(); }
+
+    /**
+     * Returns the copy at the given index.
+     *
+     * The copy may be modified in place, and the change is drawn next frame.
+     *
+     * @param index The copy index
+     *
+     * @return the copy at the given index.
+     */
+    SpriteInstance& getInstance(size_t index) { return _instances[index]; }
+
+    /**
+     * Returns the copies to draw.
+     *
+     * @return the copies to draw.
+     */
+    const std::vector<SpriteInstance>& getInstances() const { return _instances; }
+
+    /**
+     * Sets the copies to draw.
+     *
+     * @param instances The copies to draw
+     */
+    void setInstances(const std::vector<SpriteInstance>& instances) { _instances = instances; }
+
+    /**
+     * Adds a copy to draw.
+     *
+     * @param instance  The copy to draw
+     */
+    void addInstance(const SpriteInstance& instance) { _instances.push_back(instance); }
+
+    /**
+     * Adds a copy to draw at the given position.
+     *
+     * @param position  The position of the copy pivot
+     * @param scale     The uniform scale of the copy
+     * @param angle     The counter-clockwise rotation of the copy in radians
+     * @param color     The color of the copy
+     */
+    void addInstance(const Vec2 position, float scale=1.0f, float angle=0.0f,
+                     const Color4f color=Color4f::WHITE);
+
+    /**
+     * Removes all copies from this node.
+     */
+    void clearInstances() { _instances.clear(); }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws this node via the given SpriteBatch.
+     *
+     * All of the copies are drawn with a single call to the sprite batch.
+     * This method only worries about drawing the current node. It does not
+     * attempt to render the children.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch,
+                      const Mat4& transform, Color4 tint) override;
+
+};
+
+    }
+}
+
+#endif /* __CU_INSTANCE_NODE_H__ */
@@ -186,6 +186,10 @@ protected:
     Scene2* _graph;
     /** A layout manager for complex scene graphs */
     std::shared_ptr<Layout> _layout;
+    /** Whether the layout manager must rearrange the children again */
+    bool _layoutDirty;
+    /** Whether some descendant of this node has a dirty layout */
+    bool _layoutPending;
 
     /** The (current) child offset of this node (-1 if root) */
     int _childOffset;
@@ -597,6 +601,9 @@ public:
     void setName(const std::string& name) {
         _name = name;
         _hashOfName = std::hash<std::string>()(_name);
+        if (_parent != nullptr) {
+            _parent->invalidateLayout();
+        }
     }
 
     /**
@@ -1891,6 +1898,25 @@ public:
         render(batch,Mat4::IDENTITY,Color4::WHITE);
     }
 
+    /**
+     * Draws this Node and all of its children with the given SpriteBatch.
+     *
+     * This is the 2d fast path of render(shared_ptr<SpriteBatch>,const Mat4&,Color4).
+     * Because a scene graph is planar, the node transforms are combined as
+     * {@link Affine2} maps (6 floats) instead of full 4x4 matrices, and are
+     * passed to draw(shared_ptr<SpriteBatch>,const Affine2&,Color4). The only
+     * 4x4 matrix left is the camera, which is applied by the sprite batch.
+     *
+     * If this node has an alternate transform that is not planar (e.g. it
+     * tilts the node out of the plane), this node and its children are drawn
+     * with the matrix path instead.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void render(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint);
+
     /**
      * Draws this Node via the given SpriteBatch.
      *
@@ -1915,6 +1941,28 @@ public:
      * @param tint      The tint to blend with the Node color.
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {}
+
+    /**
+     * Draws this Node via the given SpriteBatch with a 2d transform.
+     *
+     * This method is called by render(shared_ptr<SpriteBatch>,const Affine2&,Color4).
+     * By default it converts the transform to a matrix and calls the method
+     * draw(shared_ptr<SpriteBatch>,const Mat4&,Color4), so custom drawing code
+     * works in both paths. Override it to submit vertices with the 2d map
+     * directly.
+     *
+     * If you subclass a node that overrides this method (such as a
+     * {@link PolygonNode}) and override the matrix version with custom
+     * drawing code, you must override this version as well. Otherwise the
+     * custom code is skipped by the 2d path.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) {
+        draw(batch,Mat4(transform),tint);
+    }
     
     
 #pragma mark -
@@ -1941,12 +1989,13 @@ public:
      * elements.  Therefore, we do allow the addition of an optional layout
      * manager.
      *
-     * Changing the layout manager does not reperform layout.  You must call
-     * {@link doLayout()} to do this.
+     * Changing the layout manager does not reperform layout.  It only marks
+     * the layout as dirty.  You must call {@link doLayout()} or
+     * {@link updateLayout()} to do this.
      *
      * @param layout	The layout manager for this node
      */
-    void setLayout(const std::shared_ptr<Layout>& layout) { _layout = layout; }
+    void setLayout(const std::shared_ptr<Layout>& layout);
     
     /**
      * Arranges the child of this node using the layout manager.
@@ -1954,12 +2003,56 @@ public:
      * This process occurs recursively and top-down. A layout manager may end
      * up resizing the children.  That is why the parent must finish its layout
      * before we can apply a layout manager to the children.
+     *
+     * This method lays out the entire subtree, whether or not it is dirty.
+     * Use {@link updateLayout()} to only lay out the parts that changed.
      */
     virtual void doLayout();
+    
+    /**
+     * Arranges the dirty parts of the subtree rooted at this node.
+     *
+     * This is an incremental version of {@link doLayout()}.  A node is only
+     * laid out again if it is dirty, and the method only descends into those
+     * children that are dirty or have dirty descendants.  A node is marked
+     * dirty when its content size changes, when its children are added,
+     * removed or renamed, and when its layout manager changes.
+     *
+     * The method {@link setContentSize} calls this method automatically on
+     * nodes with a layout manager, so it is rarely necessary to call it
+     * directly.  However, a changed child size only marks the parent dirty;
+     * it does not lay out the parent.
+     */
+    void updateLayout();
+    
+    /**
+     * Returns true if the layout manager must rearrange the children again.
+     *
+     * @return true if the layout manager must rearrange the children again.
+     */
+    bool isLayoutDirty() const { return _layoutDirty; }
+    
+    /**
+     * Marks the layout of this node as dirty.
+     *
+     * The next call to {@link updateLayout()} on this node or any of its
+     * ancestors will rearrange the children of this node.  You should call
+     * this method if you change the layout information of the layout manager
+     * after it has been attached.
+     */
+    void setLayoutDirty();
 
 private:
 #pragma mark -
 #pragma mark Internal Helpers
+    /**
+     * Records that the children of this node have changed.
+     *
+     * This forces the layout manager to resolve the children again, and
+     * marks the layout as dirty.
+     */
+    void invalidateLayout();
+    
     /**
      * Sets whether the children of this node needs resorting.
      *
@@ -420,6 +420,19 @@ public:
      * @param tint      The tint to blend with the Node color.
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
+
+    /**
+     * Draws this Node via the given SpriteBatch with a 2d transform.
+     *
+     * This is the fast path used by a planar scene graph. It is identical
+     * to the matrix version, except that the vertices are transformed by
+     * the affine map directly.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) override;
     
 
 private:
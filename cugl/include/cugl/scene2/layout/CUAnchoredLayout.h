@@ -47,6 +47,7 @@
 #define __CU_ANCHORED_LAYOUT_H__
 #include <cugl/scene2/layout/CULayout.h>
 #include <unordered_map>
+#include <vector>
 
 namespace  cugl {
     /**
@@ -96,6 +97,19 @@ protected:
     
     /** The map of keys to layout information */
     std::unordered_map<std::string,Entry> _entries;
+    /** The registered children of the bound node */
+    std::vector<std::pair<SceneNode*,Entry>> _resolved;
+    
+    /**
+     * Resolves the registered children of the given node.
+     *
+     * This method looks up the children by name and caches references to
+     * them along with their layout information.  Subsequent layouts of the
+     * same node use these references until the layout is invalidated.
+     *
+     * @param node  The scene graph node to resolve
+     */
+    void resolve(SceneNode* node);
     
 #pragma mark -
 #pragma mark Constructors
@@ -130,7 +144,11 @@ public:
      *
      * A disposed layout manager can be safely reinitialized.
      */
-    virtual void dispose() override { _entries.clear(); }
+    virtual void dispose() override {
+        _entries.clear();
+        _resolved.clear();
+        _bound = nullptr;
+    }
 
     /**
      * Returns a newly allocated layout manager.
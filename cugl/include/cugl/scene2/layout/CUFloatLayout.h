@@ -224,6 +224,9 @@ protected:
     /** The map of keys to layout information */
     std::unordered_map<std::string,Entry> _entries;
     
+    /** The registered children of the bound node, in priority order */
+    std::vector<std::pair<SceneNode*,Entry>> _resolved;
+    
     /** Whether the layout is horizontal or vertical */
     bool _horizontal;
     /** The layout aligment */
@@ -259,6 +262,18 @@ protected:
      * queue to match the current layout values.
      */
     void prioritize();
+    
+    /**
+     * Resolves the registered children of the given node.
+     *
+     * This method looks up the children by name, in priority order, and caches
+     * references to them along with their layout information.  Subsequent
+     * layouts of the same node use these references until the layout is
+     * invalidated.
+     *
+     * @param node  The scene graph node to resolve
+     */
+    void resolve(SceneNode* node);
 
     
 #pragma mark Constructors
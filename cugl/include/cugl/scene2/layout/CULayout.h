@@ -62,11 +62,21 @@ namespace  cugl {
  * All layout managers extend this class, providing implementations for
  * the {@link add}, {@link remove}, and {@link layout} methods.
  *
+ * Names are only looked up when a layout manager is first applied to a node.
+ * The manager then keeps direct references to the registered children until
+ * it is invalidated.  The {@link SceneNode} class invalidates its layout
+ * manager whenever a child is added, removed, or renamed, so this is never
+ * necessary unless you modify the children of a node behind its back.
+ *
  * Several layout managers, such as {@link AnchoredLayout} and {@link GridLayout}
  * make use of anchors.  Therefore, we provide support for them in this class
  * in order to consolidate code.
  */
 class Layout {
+protected:
+    /** The node whose children are resolved (nullptr if they must be resolved again) */
+    SceneNode* _bound;
+
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -121,7 +131,7 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
      * the heap, use one of the static constructors instead.
      */
-    Layout() {}
+    Layout() : _bound(nullptr) {}
     
     /**
      * Deletes this layout manager, disposing of all resources.
@@ -213,6 +223,16 @@ public:
      */
     virtual void layout(SceneNode* node) {}
     
+    /**
+     * Forces this layout manager to resolve the children by name again.
+     *
+     * A layout manager looks up the children of a node by name only on the
+     * first layout.  Afterwards it refers to them directly.  This method is
+     * called by {@link SceneNode} whenever the children of a node change.
+     * Adding or removing layout information also invalidates the layout.
+     */
+    void invalidate() { _bound = nullptr; }
+    
 #pragma mark Layout Helpers
     /**
      * Returns the anchor for the given text values
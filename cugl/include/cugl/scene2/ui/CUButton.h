@@ -50,6 +50,7 @@
 #include <cugl/scene2/graph/CUSceneNode.h>
 #include <cugl/scene2/graph/CUPolygonNode.h>
 #include <cugl/math/CUColor4.h>
+#include <cugl/math/polygon/CUPolyHitTester.h>
 #include <unordered_map>
 #include <vector>
 
@@ -136,6 +137,8 @@ protected:
 
     /** The button bounds (for rounder buttons) */
     Poly2 _bounds;
+    /** The edge table of the button bounds (rebuilt when they change) */
+    PolyHitTester _hitTester;
 
     /** Whether the button is actively checking for state changes */
     bool _active;
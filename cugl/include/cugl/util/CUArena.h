@@ -0,0 +1,310 @@
+//
+//  CUArena.h
+//  Cornell University Game Library (CUGL)
+//
+//  This header provides a region (arena) allocator.  An arena hands out memory
+//  by bumping a pointer through a list of large pages.  Individual allocations
+//  are never freed.  Instead, the entire arena is rewound at once, which makes
+//  it ideal for data that shares a single lifetime, such as the contents of a
+//  game level.  Rewinding the arena keeps the pages, so a level that is reset
+//  or reloaded does not touch the system heap at all.
+//
+//  Because the arena never runs destructors, it should only be used for plain
+//  data, or for objects whose destructors have no side effects.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_ARENA_H__
+#define __CU_ARENA_H__
+#include <cugl/base/CUBase.h>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/** The default page size of an arena (256 KB) */
+#define CU_ARENA_PAGE_SIZE  262144
+
+namespace cugl {
+
+#pragma mark -
+#pragma mark Arena
+/**
+ * A region allocator for data that shares a single lifetime.
+ *
+ * An arena allocates memory by advancing a cursor through a list of pages.
+ * There is no way to free an individual allocation.  Instead, a call to
+ * {@link reset()} rewinds the cursor to the start of the first page, releasing
+ * everything allocated so far in constant time.  The pages themselves are kept,
+ * so an arena that is repeatedly filled and reset (such as one per game level)
+ * will stop allocating from the system heap after the first pass.
+ *
+ * Requests larger than a page get a dedicated page of their own.  Those pages
+ * are also kept on reset, and are reused by later requests that fit.
+ *
+ * The arena never calls destructors.  It is safe for plain data and for types
+ * whose destructors have no side effects (e.g. Box2D shapes).  Objects that
+ * own heap memory must not be allocated here.
+ *
+ * Every reset increments the arena generation.  Clients that cache arena
+ * memory can compare against {@link getGeneration()} to detect stale pointers.
+ *
+ * This class is not thread safe.
+ */
+class Arena {
+protected:
+    /** A single page of arena memory */
+    struct Page {
+        /** The page memory */
+        Uint8* data;
+        /** The page capacity in bytes */
+        size_t size;
+    };
+
+    /** The pages owned by this arena (in allocation order) */
+    std::vector<Page> _pages;
+    /** The index of the page currently being filled */
+    size_t _current;
+    /** The first free byte in the current page */
+    size_t _offset;
+    /** The default page size */
+    size_t _pagesize;
+    /** The number of times this arena has been reset */
+    Uint32 _generation;
+
+    /** The number of allocations since the last reset */
+    size_t _allocations;
+    /** The number of system heap allocations over the lifetime of this arena */
+    size_t _heapcalls;
+    /** The number of bytes handed out since the last reset */
+    size_t _usage;
+    /** The memory high water mark */
+    size_t _peaksize;
+
+    /**
+     * Returns true if the current page can fit the request.
+     *
+     * If this method returns true, then _offset is advanced to the aligned
+     * address for the request.
+     *
+     * @param size  The number of bytes requested
+     * @param align The alignment of the request
+     *
+     * @return true if the current page can fit the request.
+     */
+    bool fits(size_t size, size_t align);
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates a new arena with no pages.
+     *
+     * You must initialize this arena before use.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an arena on
+     * the heap, use one of the static constructors instead.
+     */
+    Arena();
+
+    /**
+     * Deletes this arena, releasing all memory.
+     *
+     * An arena is the owner of all memory it allocates. Any object allocated
+     * by this arena will be unsafe to access.
+     */
+    ~Arena() { dispose(); }
+
+    /**
+     * Disposes this arena, releasing all memory.
+     *
+     * A disposed arena can be safely reinitialized. However, an arena is the
+     * owner of all memory it allocates. Any object allocated by this arena
+     * will be unsafe to access.
+     */
+    void dispose();
+
+    /**
+     * Initializes an arena with the given page size.
+     *
+     * The first page is allocated immediately.
+     *
+     * @param pagesize  The default page size in bytes
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(size_t pagesize=CU_ARENA_PAGE_SIZE);
+
+    /**
+     * Returns a newly allocated arena with the given page size.
+     *
+     * The first page is allocated immediately.
+     *
+     * @param pagesize  The default page size in bytes
+     *
+     * @return a newly allocated arena with the given page size.
+     */
+    static std::shared_ptr<Arena> alloc(size_t pagesize=CU_ARENA_PAGE_SIZE) {
+        std::shared_ptr<Arena> result = std::make_shared<Arena>();
+        return (result->init(pagesize) ? result : nullptr);
+    }
+
+#pragma mark Accessors
+    /**
+     * Returns the default page size of this arena.
+     *
+     * @return the default page size of this arena.
+     */
+    size_t getPageSize() const { return _pagesize; }
+
+    /**
+     * Returns the number of pages owned by this arena.
+     *
+     * This includes any dedicated pages for oversized requests.
+     *
+     * @return the number of pages owned by this arena.
+     */
+    size_t getPageCount() const { return _pages.size(); }
+
+    /**
+     * Returns the number of bytes allocated since the last reset.
+     *
+     * This value does not include alignment padding.
+     *
+     * @return the number of bytes allocated since the last reset.
+     */
+    size_t getUsage() const { return _usage; }
+
+    /**
+     * Returns the maximum usage value at any given time in this object's lifecycle.
+     *
+     * @return the maximum usage value at any given time in this object's lifecycle.
+     */
+    size_t getPeakUsage() const { return _peaksize; }
+
+    /**
+     * Returns the number of allocations since the last reset.
+     *
+     * @return the number of allocations since the last reset.
+     */
+    size_t getAllocations() const { return _allocations; }
+
+    /**
+     * Returns the number of system heap allocations made by this arena.
+     *
+     * This is a lifetime count.  It is the number of pages ever requested
+     * from the heap, and is not affected by {@link reset()}.
+     *
+     * @return the number of system heap allocations made by this arena.
+     */
+    size_t getHeapAllocations() const { return _heapcalls; }
+
+    /**
+     * Returns the number of times this arena has been reset.
+     *
+     * Memory allocated in an earlier generation is no longer valid.
+     *
+     * @return the number of times this arena has been reset.
+     */
+    Uint32 getGeneration() const { return _generation; }
+
+    /**
+     * Returns true if the given pointer lies in a page of this arena.
+     *
+     * This is a debugging method, and is linear in the number of pages.
+     *
+     * @param ptr   The pointer to test
+     *
+     * @return true if the given pointer lies in a page of this arena.
+     */
+    bool owns(const void* ptr) const;
+
+#pragma mark Memory Management
+    /**
+     * Returns a pointer to size bytes of memory with the given alignment.
+     *
+     * The memory is uninitialized.  It remains valid until the next call to
+     * {@link reset()} or {@link dispose()}.  This method only returns nullptr
+     * if the system heap is exhausted.
+     *
+     * @param size  The number of bytes requested
+     * @param align The alignment of the request (a power of two)
+     *
+     * @return a pointer to size bytes of memory with the given alignment.
+     */
+    void* malloc(size_t size, size_t align=alignof(std::max_align_t));
+
+    /**
+     * Returns a default-constructed array of the given type.
+     *
+     * The array remains valid until the next call to {@link reset()} or
+     * {@link dispose()}. No destructors are ever called on the elements.
+     *
+     * @param count The number of elements in the array
+     *
+     * @return a default-constructed array of the given type.
+     */
+    template <typename T>
+    T* allocArray(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        T* result = (T*)malloc(count*sizeof(T),alignof(T));
+        if (result != nullptr) {
+            for(size_t ii = 0; ii < count; ii++) {
+                new (result+ii) T();
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Releases every allocation in constant time.
+     *
+     * This method rewinds the arena to the start of its first page.  The pages
+     * are kept so that later allocations do not need the system heap. It also
+     * increments the generation of this arena.
+     */
+    void reset();
+
+    /**
+     * Releases every allocation and returns all but the first page to the heap.
+     *
+     * This is the method to use when the arena has grown much larger than its
+     * typical working set (e.g. after a very large level).  Like {@link reset()},
+     * it increments the generation of this arena.
+     */
+    void trim();
+};
+
+}
+
+#endif /* __CU_ARENA_H__ */
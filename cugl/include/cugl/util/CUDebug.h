@@ -219,6 +219,44 @@ namespace cugl {
 #   error Unknown assertion level.
 #endif
 
+/**
+ * @def CU_GL_VALIDATE
+ *
+ * Whether to poll OpenGL for errors after render operations.
+ *
+ * Reading the OpenGL error flag forces the driver to synchronize with the
+ * GPU, which stalls the pipeline.  So it is only done in validation builds.
+ * By default these are the builds with active asserts (SDL_ASSERT_LEVEL 2
+ * or higher), but the value may be overridden by defining it as 0 or 1.
+ */
+#ifndef CU_GL_VALIDATE
+#   if SDL_ASSERT_LEVEL >= 2
+#       define CU_GL_VALIDATE 1
+#   else
+#       define CU_GL_VALIDATE 0
+#   endif
+#endif
+
+/**
+ * @def CUAssertGLError(tag)
+ *
+ * Asserts that there is no pending OpenGL error, halting otherwise.
+ *
+ * The error (if any) is written to the error log prefixed by the given tag.
+ * Unlike a normal assert, this macro does not even query the error flag
+ * unless CU_GL_VALIDATE is set.
+ *
+ * @param tag   A string identifying the caller
+ */
+#if CU_GL_VALIDATE
+#   define CUAssertGLError(tag) do { \
+        GLenum __gl_error = glGetError(); \
+        CUAssertLog(__gl_error == GL_NO_ERROR, "%s: %s", tag, cugl::gl_error_name(__gl_error).c_str()); \
+    } while (0)
+#else
+#   define CUAssertGLError(tag) do { } while (0)
+#endif
+
 /**
  * Returns a string description of an OpenGL error type
  *
@@ -220,6 +220,38 @@ public:
      * @return whether the thread pool has been shut down.
      */
     bool isShutdown() const { return _workers.size() == _complete; }
+    
+    /**
+     * Returns the number of worker threads in this pool.
+     *
+     * @return the number of worker threads in this pool.
+     */
+    int getThreadCount() const { return (int)_workers.size(); }
+    
+    
+#pragma mark Parallel Loops
+    /**
+     * Runs the given function once for every index in [0,count).
+     *
+     * Unlike {@link addTask}, this method blocks until every index has been
+     * processed.  The calling thread takes part in the loop, and each worker
+     * thread joins it as soon as it is free.  Participants claim one index at
+     * a time, so a thread that finishes early simply picks up the remaining
+     * work.  For the best balance, order the work from largest to smallest.
+     *
+     * The function is passed the loop index and the participant number. The
+     * participant number is in the range [0,getThreadCount()], with 0 always
+     * the calling thread.  It can be used to index per-thread scratch data.
+     *
+     * As the calling thread takes part, this method never deadlocks, even if
+     * the workers are busy with other tasks.  In that case, the loop simply
+     * runs on the calling thread.  This method must not be called from a task
+     * of this pool.
+     *
+     * @param count     The number of loop indices
+     * @param body      The loop body, taking the index and participant number
+     */
+    void parallelFor(int count, const std::function<void(int index, int worker)>& body);
   
 private:  
     /** Copying is only allowed via shared pointer. */
@@ -36,5 +36,6 @@
 #include "CUFreeList.h"
 #include "CUGreedyFreeList.h"
 #include "CUThreadPool.h"
+#include "CUArena.h"
 
 #endif /* __CU_UTIL_PKG_H__ */
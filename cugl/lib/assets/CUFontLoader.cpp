@@ -134,7 +134,7 @@ void FontLoader::materialize(const std::string& key, const std::shared_ptr<Font>
     
     bool success = false;
     if (font != nullptr) {
-        _assets[key] = font;
+        store(key, font);
         success = true;
     }
     
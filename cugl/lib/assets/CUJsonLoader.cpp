@@ -68,7 +68,7 @@ void JsonLoader::materialize(const std::string& key, const std::shared_ptr<JsonV
                               LoaderCallback callback) {
     bool success = false;
     if (json != nullptr) {
-        _assets[key] = json;
+        store(key, json);
         success = true;
     }
     
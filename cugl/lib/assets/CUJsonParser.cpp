@@ -0,0 +1,758 @@
+//
+//  CUJsonParser.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a native, single-pass JSON parser for JsonValue.  The
+//  previous pipeline scanned the text once for matching braces, parsed it into
+//  a cJSON tree, and then converted that tree into JsonValue nodes.  This
+//  parser tokenizes the source buffer once and builds the JsonValue tree
+//  directly.  Tokens are read in place from the source buffer, and strings
+//  without escapes are copied straight into their nodes.  Where the platform
+//  supports it (see CU_MATH_VECTOR_SSE and CU_MATH_VECTOR_NEON64), whitespace
+//  and string contents are skipped sixteen bytes at a time.
+//
+//  The nodes of each document are allocated in a single arena.  The arena
+//  lives as long as any node of that document, and is released in one go
+//  when the last node is deleted.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/assets/CUJsonParser.h>
+#include <cugl/assets/CUJsonValue.h>
+#include <cugl/math/CUMathBase.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+using namespace cugl;
+
+#pragma mark -
+#pragma mark Arena Allocation
+/**
+ * An allocator placing shared nodes (and their control blocks) in an arena.
+ *
+ * Every copy of the allocator holds a reference to the arena.  As a copy
+ * lives in the control block of each node, the arena is kept alive until
+ * the last node of the document is deleted.  Deallocation does nothing, as
+ * the arena is released as a whole.
+ */
+namespace {
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    /** The document arena */
+    std::shared_ptr<Arena> arena;
+
+    ArenaAllocator(const std::shared_ptr<Arena>& arena) : arena(arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        void* result = arena->malloc(count*sizeof(T),alignof(T));
+        if (result == nullptr) {
+            throw std::bad_alloc();
+        }
+        return (T*)result;
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+}
+
+
+#pragma mark -
+#pragma mark Scanning
+/**
+ * Returns the first position at or after pos that is not whitespace.
+ *
+ * Like cJSON, any byte with value at most 32 (a space) is whitespace.
+ *
+ * @param pos   The start of the text to scan
+ * @param end   The end of the text
+ *
+ * @return the first position at or after pos that is not whitespace.
+ */
+static const char* skip_space(const char* pos, const char* end) {
+    // Pretty-printed files have short runs, so check the next byte first
+    if (pos < end && (unsigned char)*pos > 32) {
+        return pos;
+    }
+#if defined CU_MATH_VECTOR_SSE
+    const __m128i limit = _mm_set1_epi8(32);
+    while (pos+16 <= end) {
+        __m128i data = _mm_loadu_si128((const __m128i*)pos);
+        int space = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(data,limit),limit));
+        if (space != 0xffff) {
+            return pos+__builtin_ctz(~space);
+        }
+        pos += 16;
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    const uint8x16_t limit = vdupq_n_u8(32);
+    while (pos+16 <= end) {
+        uint8x16_t space = vcleq_u8(vld1q_u8((const uint8_t*)pos),limit);
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(space),4)),0);
+        if (mask != ~0ULL) {
+            return pos+(__builtin_ctzll(~mask) >> 2);
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < end && (unsigned char)*pos <= 32) {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * Returns the first position at or after pos holding one of the given bytes.
+ *
+ * If there is no such byte, this function returns end.
+ *
+ * @param pos   The start of the text to scan
+ * @param end   The end of the text
+ * @param a     The first byte to look for
+ * @param b     The second byte to look for
+ * @param c     The third byte to look for
+ *
+ * @return the first position at or after pos holding one of the given bytes.
+ */
+static const char* scan_for(const char* pos, const char* end, char a, char b, char c) {
+#if defined CU_MATH_VECTOR_SSE
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+    while (pos+16 <= end) {
+        __m128i data = _mm_loadu_si128((const __m128i*)pos);
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(data,va),
+                                    _mm_or_si128(_mm_cmpeq_epi8(data,vb),_mm_cmpeq_epi8(data,vc)));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) {
+            return pos+__builtin_ctz(mask);
+        }
+        pos += 16;
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    const uint8x16_t va = vdupq_n_u8((uint8_t)a);
+    const uint8x16_t vb = vdupq_n_u8((uint8_t)b);
+    const uint8x16_t vc = vdupq_n_u8((uint8_t)c);
+    while (pos+16 <= end) {
+        uint8x16_t data = vld1q_u8((const uint8_t*)pos);
+        uint8x16_t hits = vorrq_u8(vceqq_u8(data,va),vorrq_u8(vceqq_u8(data,vb),vceqq_u8(data,vc)));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits),4)),0);
+        if (mask) {
+            return pos+(__builtin_ctzll(mask) >> 2);
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < end && *pos != a && *pos != b && *pos != c) {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * Returns the position of the closing quote of the string at pos
+ *
+ * If the string is unterminated, this function returns end.
+ *
+ * @param pos   The opening quote of the string
+ * @param end   The end of the text
+ *
+ * @return the position of the closing quote of the string at pos
+ */
+static const char* skip_string(const char* pos, const char* end) {
+    pos = scan_for(pos+1,end,'"','\\','"');
+    while (pos < end && *pos == '\\') {
+        pos = (end-pos > 2 ? scan_for(pos+2,end,'"','\\','"') : end);
+    }
+    return pos;
+}
+
+/**
+ * Returns the value of the four hexadecimal digits at pos, or -1 if invalid
+ *
+ * @param pos   The start of the digits
+ *
+ * @return the value of the four hexadecimal digits at pos, or -1 if invalid
+ */
+static long parse_hex4(const char* pos) {
+    long result = 0;
+    for(int ii = 0; ii < 4; ii++) {
+        char c = pos[ii];
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= c-'0';
+        } else if (c >= 'a' && c <= 'f') {
+            result |= c-'a'+10;
+        } else if (c >= 'A' && c <= 'F') {
+            result |= c-'A'+10;
+        } else {
+            return -1;
+        }
+    }
+    return result;
+}
+
+/**
+ * Appends the UTF-8 encoding of the given code point
+ *
+ * @param value The string to append to
+ * @param code  The code point to encode
+ */
+static void append_utf8(std::string& value, unsigned long code) {
+    if (code < 0x80) {
+        value.push_back((char)code);
+    } else if (code < 0x800) {
+        value.push_back((char)(0xC0 | (code >> 6)));
+        value.push_back((char)(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        value.push_back((char)(0xE0 | (code >> 12)));
+        value.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+        value.push_back((char)(0x80 | (code & 0x3F)));
+    } else {
+        value.push_back((char)(0xF0 | (code >> 18)));
+        value.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+        value.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+        value.push_back((char)(0x80 | (code & 0x3F)));
+    }
+}
+
+/**
+ * Returns true if c may appear in a number (the same set as cJSON)
+ *
+ * @param c The character to test
+ *
+ * @return true if c may appear in a number
+ */
+static inline bool is_number_char(char c) {
+    return (c >= '0' && c <= '9') || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.';
+}
+
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a new parser.
+ *
+ * You must initialize this parser before use.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a parser on
+ * the heap, use one of the static constructors instead.
+ */
+JsonParser::JsonParser() :
+_begin(nullptr),
+_end(nullptr),
+_cursor(nullptr),
+_error(nullptr),
+_depth(0),
+_nodes(0),
+_usage(0),
+_errline(0) {
+}
+
+/**
+ * Disposes this parser, releasing all resources.
+ *
+ * Documents parsed by this parser are unaffected.
+ */
+void JsonParser::dispose() {
+    _stack.clear();
+    _scratch.clear();
+    _arena = nullptr;
+    _begin = _end = _cursor = _error = nullptr;
+    _errtext.clear();
+    _errline = 0;
+}
+
+/**
+ * Initializes a parser.
+ *
+ * @return true if initialization was successful.
+ */
+bool JsonParser::init() {
+    _stack.reserve(64);
+    return true;
+}
+
+
+#pragma mark -
+#pragma mark Parsing
+/**
+ * Returns the number of bytes of the first JSON value in the text.
+ *
+ * Parsing stops at the end of the first complete value, and so the text
+ * may continue past it.  The root node is replaced by the parsed value,
+ * and all of its descendants are allocated in a new arena.
+ *
+ * If there is a parsing error, this method returns 0 and records the
+ * location of the error.  See {@link getError}.
+ *
+ * @param root      The node to store the parsed value
+ * @param json      The JSON text
+ * @param length    The number of bytes of text
+ *
+ * @return the number of bytes of the first JSON value in the text.
+ */
+size_t JsonParser::parse(JsonValue* root, const char* json, size_t length) {
+    CUAssertLog(root != nullptr, "Cannot parse into a null node");
+    _begin  = json;
+    _end    = json+length;
+    _cursor = skip_space(json,_end);
+    _error  = nullptr;
+    _errline = 0;
+    _errtext.clear();
+    _depth = 0;
+    _nodes = 1;
+    _usage = 0;
+
+    // Roughly the size of the nodes in a pretty-printed document
+    _arena = Arena::alloc(std::max((size_t)CU_JSON_PAGE_SIZE,4*length));
+    bool success = _arena != nullptr && parseValue(root);
+    if (_arena != nullptr) {
+        _usage = _arena->getUsage();
+    }
+
+    // The nodes now own the arena
+    _arena = nullptr;
+    _stack.clear();
+    if (!success) {
+        root->_children.clear();
+        _nodes = 0;
+        return 0;
+    }
+    return (size_t)(_cursor-_begin);
+}
+
+/**
+ * Returns the number of bytes of the first JSON value in the text.
+ *
+ * This method only finds the end of the value, and does not build a tree.
+ * Leading whitespace is included in the result.  Unlike a simple count
+ * of braces, it correctly skips over strings.  If the value is
+ * unterminated, this method returns 0.
+ *
+ * @param json      The JSON text
+ * @param length    The number of bytes of text
+ *
+ * @return the number of bytes of the first JSON value in the text.
+ */
+size_t JsonParser::scan(const char* json, size_t length) {
+    const char* end = json+length;
+    const char* pos = skip_space(json,end);
+    if (pos == end) {
+        return 0;
+    } else if (*pos == '"') {
+        pos = skip_string(pos,end);
+        return (pos < end ? (size_t)(pos+1-json) : 0);
+    } else if (*pos != '{' && *pos != '[') {
+        // Scalars end at the next structural character or whitespace
+        while (pos < end && (unsigned char)*pos > 32 && *pos != ',' && *pos != ']' && *pos != '}') {
+            pos++;
+        }
+        return (size_t)(pos-json);
+    }
+
+    // Only the outermost kind of bracket matters for well-formed text
+    char open  = *pos;
+    char close = (open == '{' ? '}' : ']');
+    int depth = 0;
+    while (pos < end) {
+        pos = scan_for(pos,end,'"',open,close);
+        if (pos == end) {
+            break;
+        } else if (*pos == '"') {
+            pos = skip_string(pos,end);
+            if (pos == end) {
+                break;
+            }
+        } else if (*pos == open) {
+            depth++;
+        } else if (--depth == 0) {
+            return (size_t)(pos+1-json);
+        }
+        pos++;
+    }
+    return 0;
+}
+
+/**
+ * Returns a new child of the given node, allocated in the document arena
+ *
+ * @param parent    The parent node
+ *
+ * @return a new child of the given node, allocated in the document arena
+ */
+std::shared_ptr<JsonValue> JsonParser::allocChild(JsonValue* parent) {
+    std::shared_ptr<JsonValue> child = std::allocate_shared<JsonValue>(ArenaAllocator<JsonValue>(_arena));
+    child->_parent = parent;
+    _nodes++;
+    return child;
+}
+
+/**
+ * Records a parsing error at the given position and returns false
+ *
+ * @param pos   The position of the error
+ *
+ * @return false
+ */
+bool JsonParser::fail(const char* pos) {
+    if (_error != nullptr) {
+        return false;
+    }
+    _error = std::min(pos,_end);
+    _errline = 1;
+    for(const char* curr = _begin; curr < _error; curr++) {
+        if (*curr == '\n') {
+            _errline++;
+        }
+    }
+    const char* stop = _error;
+    while (stop < _end && *stop && *stop != '\n') {
+        stop++;
+    }
+    _errtext.assign(_error,stop-_error);
+    return false;
+}
+
+/**
+ * Returns true if the value at the cursor was parsed into node
+ *
+ * @param node  The node to store the value
+ *
+ * @return true if the value at the cursor was parsed into node
+ */
+bool JsonParser::parseValue(JsonValue* node) {
+    if (_cursor >= _end) {
+        return fail(_cursor);
+    }
+
+    switch (*_cursor) {
+        case '{':
+            return parseObject(node);
+        case '[':
+            return parseArray(node);
+        case '"':
+            node->_type = JsonValue::Type::StringType;
+            return parseString(node->_stringValue);
+        case 'n':
+            if (_end-_cursor >= 4 && std::strncmp(_cursor,"null",4) == 0) {
+                node->_type = JsonValue::Type::NullType;
+                _cursor += 4;
+                return true;
+            }
+            return fail(_cursor);
+        case 't':
+            if (_end-_cursor >= 4 && std::strncmp(_cursor,"true",4) == 0) {
+                node->_type = JsonValue::Type::BoolType;
+                node->_longValue = 1;
+                _cursor += 4;
+                return true;
+            }
+            return fail(_cursor);
+        case 'f':
+            if (_end-_cursor >= 5 && std::strncmp(_cursor,"false",5) == 0) {
+                node->_type = JsonValue::Type::BoolType;
+                node->_longValue = 0;
+                _cursor += 5;
+                return true;
+            }
+            return fail(_cursor);
+        default:
+            if (*_cursor == '-' || (*_cursor >= '0' && *_cursor <= '9')) {
+                return parseNumber(node);
+            }
+            break;
+    }
+    return fail(_cursor);
+}
+
+/**
+ * Returns true if the string at the cursor was parsed into value
+ *
+ * The cursor must be at the opening quote.
+ *
+ * @param value The string to store the result
+ *
+ * @return true if the string at the cursor was parsed into value
+ */
+bool JsonParser::parseString(std::string& value) {
+    const char* start = _cursor+1;
+    const char* pos = scan_for(start,_end,'"','\\','"');
+    if (pos == _end) {
+        return fail(_cursor);
+    } else if (*pos == '"') {
+        // The common case: copy straight from the source
+        value.assign(start,pos-start);
+        _cursor = pos+1;
+        return true;
+    }
+
+    _scratch.assign(start,pos-start);
+    while (pos < _end && *pos == '\\') {
+        if (pos+1 >= _end) {
+            return fail(_cursor);
+        }
+        switch (pos[1]) {
+            case 'b': _scratch.push_back('\b'); pos += 2; break;
+            case 'f': _scratch.push_back('\f'); pos += 2; break;
+            case 'n': _scratch.push_back('\n'); pos += 2; break;
+            case 'r': _scratch.push_back('\r'); pos += 2; break;
+            case 't': _scratch.push_back('\t'); pos += 2; break;
+            case '"':
+            case '\\':
+            case '/':
+                _scratch.push_back(pos[1]);
+                pos += 2;
+                break;
+            case 'u':
+            {
+                long code = (_end-pos >= 6 ? parse_hex4(pos+2) : -1);
+                if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF)) {
+                    return fail(_cursor);
+                }
+                pos += 6;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // A UTF-16 surrogate pair
+                    long low = (_end-pos >= 6 && pos[0] == '\\' && pos[1] == 'u' ? parse_hex4(pos+2) : -1);
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return fail(_cursor);
+                    }
+                    code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+                    pos += 6;
+                }
+                append_utf8(_scratch,(unsigned long)code);
+                break;
+            }
+            default:
+                return fail(_cursor);
+        }
+
+        const char* next = scan_for(pos,_end,'"','\\','"');
+        _scratch.append(pos,next-pos);
+        pos = next;
+    }
+    if (pos == _end) {
+        return fail(_cursor);
+    }
+    value = _scratch;
+    _cursor = pos+1;
+    return true;
+}
+
+/**
+ * Returns true if the number at the cursor was parsed into node
+ *
+ * @param node  The node to store the value
+ *
+ * @return true if the number at the cursor was parsed into node
+ */
+bool JsonParser::parseNumber(JsonValue* node) {
+    const char* start = _cursor;
+    const char* pos = start;
+    bool integral = true;
+    while (pos < _end && is_number_char(*pos)) {
+        integral = integral && ((*pos >= '0' && *pos <= '9') || (*pos == '-' && pos == start));
+        pos++;
+    }
+
+    double number = 0;
+    size_t digits = pos-start-(*start == '-' ? 1 : 0);
+    if (integral && digits > 0 && digits <= 15) {
+        // Exact, and much faster than strtod
+        long long value = 0;
+        for(const char* curr = (*start == '-' ? start+1 : start); curr < pos; curr++) {
+            value = 10*value+(*curr-'0');
+        }
+        number = (double)(*start == '-' ? -value : value);
+    } else {
+        char buffer[64];
+        size_t length = std::min((size_t)(pos-start),sizeof(buffer)-1);
+        std::memcpy(buffer,start,length);
+        buffer[length] = 0;
+        char* last = nullptr;
+        number = std::strtod(buffer,&last);
+        if (last == buffer) {
+            return fail(start);
+        }
+        pos = start+(last-buffer);
+    }
+
+    // Saturate the integer value exactly like cJSON
+    node->_type = JsonValue::Type::NumberType;
+    node->_doubleValue = number;
+    if (number >= INT_MAX) {
+        node->_longValue = INT_MAX;
+    } else if (number <= (double)INT_MIN) {
+        node->_longValue = INT_MIN;
+    } else {
+        node->_longValue = (int)number;
+    }
+    _cursor = pos;
+    return true;
+}
+
+/**
+ * Returns true if the array at the cursor was parsed into node
+ *
+ * The cursor must be at the opening bracket.
+ *
+ * @param node  The node to store the value
+ *
+ * @return true if the array at the cursor was parsed into node
+ */
+bool JsonParser::parseArray(JsonValue* node) {
+    if (++_depth > CU_JSON_NESTING_LIMIT) {
+        return fail(_cursor);
+    }
+    node->_type = JsonValue::Type::ArrayType;
+    size_t mark = _stack.size();
+
+    _cursor = skip_space(_cursor+1,_end);
+    if (_cursor < _end && *_cursor == ']') {
+        _cursor++;
+        _depth--;
+        return true;
+    }
+
+    while (_cursor < _end) {
+        std::shared_ptr<JsonValue> child = allocChild(node);
+        if (!parseValue(child.get())) {
+            return false;
+        }
+        _stack.push_back(child);
+
+        _cursor = skip_space(_cursor,_end);
+        if (_cursor < _end && *_cursor == ',') {
+            _cursor = skip_space(_cursor+1,_end);
+        } else if (_cursor < _end && *_cursor == ']') {
+            _cursor++;
+            node->_children.assign(_stack.begin()+mark,_stack.end());
+            _stack.resize(mark);
+            _depth--;
+            return true;
+        } else {
+            return fail(_cursor);
+        }
+    }
+    return fail(_cursor);
+}
+
+/**
+ * Returns true if the object at the cursor was parsed into node
+ *
+ * The cursor must be at the opening brace.
+ *
+ * @param node  The node to store the value
+ *
+ * @return true if the object at the cursor was parsed into node
+ */
+bool JsonParser::parseObject(JsonValue* node) {
+    if (++_depth > CU_JSON_NESTING_LIMIT) {
+        return fail(_cursor);
+    }
+    node->_type = JsonValue::Type::ObjectType;
+    size_t mark = _stack.size();
+
+    _cursor = skip_space(_cursor+1,_end);
+    if (_cursor < _end && *_cursor == '}') {
+        _cursor++;
+        _depth--;
+        return true;
+    }
+
+    while (_cursor < _end) {
+        if (*_cursor != '"') {
+            return fail(_cursor);
+        }
+        std::shared_ptr<JsonValue> child = allocChild(node);
+        if (!parseString(child->_key)) {
+            return false;
+        }
+
+        _cursor = skip_space(_cursor,_end);
+        if (_cursor >= _end || *_cursor != ':') {
+            return fail(_cursor);
+        }
+        _cursor = skip_space(_cursor+1,_end);
+        if (!parseValue(child.get())) {
+            return false;
+        }
+        _stack.push_back(child);
+
+        _cursor = skip_space(_cursor,_end);
+        if (_cursor < _end && *_cursor == ',') {
+            _cursor = skip_space(_cursor+1,_end);
+        } else if (_cursor < _end && *_cursor == '}') {
+            _cursor++;
+            node->_children.assign(_stack.begin()+mark,_stack.end());
+            _stack.resize(mark);
+            _depth--;
+            return true;
+        } else {
+            return fail(_cursor);
+        }
+    }
+    return fail(_cursor);
+}
+
+
+#pragma mark -
+#pragma mark Diagnostics
+/**
+ * Returns a description of the last parsing error.
+ *
+ * The description includes the line number and the text of the offending
+ * line.  If the last parse succeeded, this method returns the empty string.
+ *
+ * @return a description of the last parsing error.
+ */
+std::string JsonParser::getError() const {
+    if (_errline == 0) {
+        return "";
+    }
+    return "Invalid token at line "+std::to_string(_errline)+":\n  "+_errtext;
+}
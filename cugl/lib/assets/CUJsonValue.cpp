@@ -4,8 +4,8 @@
 //
 //  This module a modern C++ alternative to the cJSON interface for reading
 //  JSON files.  In particular, this gives us better type-checking and memory
-//  management.  With that said, it still uses cJSON as the underlying parsing
-//  engine.
+//  management.  JSON text is parsed in a single pass by JsonParser, which
+//  builds this tree directly.  cJSON is only used to write JSON text.
 //
 //  This class uses our standard shared-pointer architecture.
 //
@@ -42,47 +42,13 @@
 //  Version: 1/7/18
 //
 #include <cugl/assets/CUJsonValue.h>
+#include <cugl/assets/CUJsonParser.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUStrings.h>
+#include <cstring>
 
 using namespace cugl;
 
-/**
- * Returns the line of JSON with the offending error.
- *
- * Error messages in this library correspond to the tail of the JSON after the error is encounterd.  These
- * can be hard to read if the error happens early.  This function truncates the error to only include the
- * first line of the error.  It also indicates (via the reference variable) the line on which the error occurred.
- *
- * @param data      The JSON value being parsed
- * @param error     The tail of the JSON after encountering an error
- * @param lineno    The variable to store the line number
- *
- * @return the line of JSON with the offending error.
- */
-std::string isolate_error(const char* data, const char* error, int& lineno) {
-    lineno = 1;
-    const char* pos = data;
-    while (pos != error) {
-        if (*pos == '\n') {
-            lineno++;
-        }
-        pos++;
-    }
-    size_t len = 0;
-    bool goon = true;
-    pos = error;
-    while (*pos && goon) {
-        if (*pos == '\n') {
-            goon = false;
-        } else {
-            len++;
-        }
-        pos++;
-    }
-    return std::string(error,len);
-}
-
 #pragma mark -
 #pragma mark JSON Conversions
 /**
@@ -400,20 +366,34 @@ bool JsonValue::init(double value) {
  * @return  true if the JSON node is initialized properly, false otherwise.
  */
 bool JsonValue::initWithJson(const char* json) {
-    const char *error = NULL;
-    cJSON* node = cJSON_ParseWithOpts(json, &error, 0);
-    if (node) {
-        toJsonValue(this,node);
-        cJSON_Delete(node);
+    return initWithJson(json,std::strlen(json));
+}
+
+/**
+ * Initializes a new JsonValue from the given JSON text.
+ *
+ * This initializer will parse the first JSON value in the text and
+ * construct a full JSON tree for it, if possible. The text does not need
+ * to be null-terminated, and anything after the first value is ignored.
+ * The children are all owned by this node will be deleted when this node
+ * is deleted (provided there are no other references).
+ *
+ * If there is a parsing error, this method will return false.  Detailed
+ * information about the parsing error will be passed to an assert.  Hence
+ * error messages are suppressed if asserts are turned off.
+ *
+ * @param json      The JSON text to parse.
+ * @param length    The number of bytes of text
+ *
+ * @return  true if the JSON node is initialized properly, false otherwise.
+ */
+bool JsonValue::initWithJson(const char* json, size_t length) {
+    JsonParser parser;
+    parser.init();
+    if (parser.parse(this,json,length)) {
         return true;
     }
-    if (error) {
-        int line = 0;
-        std::string source = isolate_error(json,error,line);
-        CUAssertLog(false, "Invalid token at line %d:\n  %s",line,source.c_str());
-    } else {
-        CUAssertLog(false, "Invalid JSON");
-    }
+    CUAssertLog(false, "%s", parser.getError().c_str());
     return false; // If asserts turned off
 }
 
@@ -512,7 +512,7 @@ bool Scene2Loader::purge(const std::shared_ptr<JsonValue>& json) {
  * @return true if the node was successfully attached
  */
 bool Scene2Loader::attach(const std::string& key, const std::shared_ptr<scene2::SceneNode>& node) {
-    _assets[key] = node;
+    store(key, node);
     bool success = true;
     for(int ii = 0; ii < node->getChildren().size(); ii++) {
         std::shared_ptr<scene2::SceneNode> item = node->getChild(ii);
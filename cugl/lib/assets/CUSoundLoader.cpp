@@ -94,7 +94,7 @@ void SoundLoader::materialize(const std::string& key, const std::shared_ptr<Soun
                               LoaderCallback callback) {
     bool success = false;
     if (sound != nullptr) {
-        _assets[key] = sound;
+        store(key, sound);
         success = true;
     }
     
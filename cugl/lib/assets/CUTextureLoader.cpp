@@ -204,7 +204,7 @@ void TextureLoader::materialize(const std::string& key, SDL_Surface* surface, Lo
     
     bool success = false;
     if (texture != nullptr) {
-        _assets[key] = texture;
+        store(key, texture);
         texture->bind();
         if (_mipmaps) { texture->buildMipMaps(); }
         texture->setMinFilter(_minfilter);
@@ -262,7 +262,7 @@ void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surf
         GLuint wrapT = decodeWrap(json->getString("wrapT",UNKNOWN_WRAP));
         bool mipmaps = json->getBool("mipmaps",false);
 
-        _assets[key] = texture;
+        store(key, texture);
         texture->bind();
         if (mipmaps) { texture->buildMipMaps(); }
         texture->setMinFilter(minflt);
@@ -311,7 +311,7 @@ bool TextureLoader::read(const std::string& key, const std::string& source, Load
         std::shared_ptr<Texture> texture = Texture::allocWithFile(source);
         success = (texture != nullptr);
         if (success) { 
-			_assets[key] = texture;
+			store(key, texture);
 		}
         _queue.erase(key);
     } else {
@@ -380,7 +380,7 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
         std::shared_ptr<Texture> texture = Texture::allocWithFile(source);
         success = (texture != nullptr);
         if (success) { 
-			_assets[key] = texture;
+			store(key, texture);
 		}
         _queue.erase(key);
     } else {
@@ -433,11 +433,9 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
  */
 bool TextureLoader::purge(const std::shared_ptr<JsonValue>& json) {
     std::string key = json->key();
-    auto it = _assets.find(key);
-    if (it == _assets.end()) {
+    if (!erase(key)) {
         return false;
     }
-    _assets.erase(it);
     
     JsonValue* child = json->get("atlas").get();
     bool success = true;
@@ -445,11 +443,7 @@ bool TextureLoader::purge(const std::shared_ptr<JsonValue>& json) {
         for(int ii = 0; ii < child->size(); ii++) {
             JsonValue* item = child->get(ii).get();
             std::string name = key+"_"+item->key();
-            auto jt = _assets.find(name);
-            success = (jt != _assets.end()) && success;
-            if (jt != _assets.end()) {
-                _assets.erase(jt);
-            }
+            success = erase(name) && success;
         }
     }
     
@@ -479,8 +473,8 @@ void TextureLoader::parseAtlas(const std::shared_ptr<JsonValue>& json, const std
             std::string name = key+"_"+item->key();
             std::vector<int> values = item->asIntArray();
             CUAssertLog(values.size() == 4, "Atlas dimensions are incorrect: %d",(Uint32)values.size());
-            _assets[name] = texture->getSubTexture(values[0]/size.width, values[2]/size.width,
-                                                   values[1]/size.height,values[3]/size.height);
+            store(name, texture->getSubTexture(values[0]/size.width, values[2]/size.width,
+                                                   values[1]/size.height,values[3]/size.height));
         }
     }
 }
@@ -68,7 +68,7 @@ void WidgetLoader::materialize(const std::string& key, const std::shared_ptr<Wid
                               LoaderCallback callback) {
     bool success = false;
     if (widget != nullptr) {
-        _assets[key] = widget;
+        store(key, widget);
 		std::shared_ptr<JsonValue> json = widget->getJson()->get("dependencies");
 		if (json != nullptr) {
 			for (int ii = 0; ii < json->size(); ii++) {
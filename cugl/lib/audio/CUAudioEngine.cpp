@@ -46,6 +46,34 @@ using namespace cugl::audio;
 /** Reference to the sound engine singleton */
 AudioEngine* AudioEngine::_gEngine = nullptr;
 
+/**
+ * Computes the panner matrix for a stereo pan factor.
+ *
+ * The matrix has an entry for each input (field) channel and the first two
+ * output channels, so entry (field,channel) is matrix[2*field+channel]. Only
+ * the first 2*field entries are set.
+ *
+ * @param field     The number of input channels (1 or 2)
+ * @param pan       The stereo pan factor (-1 to 1)
+ * @param matrix    The array to store the matrix
+ */
+static void panMatrix(Uint32 field, float pan, float* matrix) {
+    if (field == 1) {
+        matrix[0] = 0.5-pan/2.0;
+        matrix[1] = 0.5+pan/2.0;
+    } else if (pan <= 0) {
+        matrix[0] = 1;
+        matrix[1] = 0;
+        matrix[2] = -pan;
+        matrix[3] = 1+pan;
+    } else {
+        matrix[0] = 1-pan;
+        matrix[1] = pan;
+        matrix[2] = 0;
+        matrix[3] = 1;
+    }
+}
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -58,6 +86,7 @@ _capacity(0),
 _primary(false) {
     _output = nullptr;
     _mixer  = nullptr;
+    _dispatch = nullptr;
 }
 
 /**
@@ -81,6 +110,7 @@ bool AudioEngine::init(const std::shared_ptr<AudioOutput>& device, Uint32 slots)
     _capacity = slots;
     _output = device;
     _mixer  = AudioMixer::alloc(_capacity+1,_output->getChannels(),_output->getRate());
+    _owners.assign(_capacity,nullptr);
     
     for(int ii = 0; ii <= _capacity; ii++) {
         std::shared_ptr<AudioScheduler> channel;
@@ -109,13 +139,24 @@ bool AudioEngine::init(const std::shared_ptr<AudioOutput>& device, Uint32 slots)
         }
     }
     
+    // Slot 0 is handed out first
+    for(Uint32 ii = _capacity; ii > 0; ii--) {
+        _free.push_back(ii-1);
+    }
+    
     // Pool needs a fader and panner for 2 times the number of slots
+    // They are attached now so that wrapping a sound only attaches the sound
     for(int ii = 0; ii < 2*_capacity; ii++) {
-        _fadePool.push_back(AudioFader::alloc(_mixer->getChannels(),_mixer->getRate()));
-        _panPool.push_back(AudioPanner::alloc(_mixer->getChannels(),2,_mixer->getRate()));
+        std::shared_ptr<AudioPanner> panner = AudioPanner::alloc(_mixer->getChannels(),2,_mixer->getRate());
+        _fadePool.push_back(AudioFader::alloc(panner));
+        _panPool.push_back(panner);
     }
+    // Pools are used from the back, and the graph reads best in allocation order
+    std::reverse(_fadePool.begin(),_fadePool.end());
+    std::reverse(_panPool.begin(),_panPool.end());
     
-    _output->attach(_mixer);
+    _dispatch = AudioDispatcher::alloc(_mixer);
+    _output->attach(_dispatch);
     return true;
 }
 
@@ -143,6 +184,9 @@ void AudioEngine::dispose() {
         
 		_output = nullptr;
         _mixer = nullptr;
+        _dispatch = nullptr;
+        _free.clear();
+        _owners.clear();
         
         _queues.clear();
 		_actives.clear();
@@ -173,6 +217,56 @@ void AudioEngine::removeKey(const std::string key) {
     }
 }
 
+/**
+ * Returns a slot to play a new sound effect, or -1 if there is none.
+ *
+ * This method takes the most recently freed slot from the list of idle
+ * slots. If there is none, it takes a slot whose sound is fading out,
+ * provided no newer sound has been given that slot. If there is no such
+ * slot and force is true, it will clear the longest playing sound effect
+ * and return its slot.
+ *
+ * A slot leaves the idle list as soon as it is returned, so a sound that
+ * is queued (or recorded) but not yet playing keeps its slot.  The slot
+ * goes back on the list when the last sound given it is collected.
+ *
+ * @param force Whether to force another sound to stop.
+ *
+ * @return a slot to play a new sound effect, or -1 if there is none.
+ */
+int AudioEngine::acquireSlot(bool force) {
+    if (!_free.empty()) {
+        int audioID = _free.back();
+        _free.pop_back();
+        return audioID;
+    }
+    
+    // Try again for soon to be deleted.
+    int audioID = -1;
+    for(auto it = _actives.begin(); audioID == -1 && it != _actives.end(); ++it) {
+        if (it->second->isFadeOut() && _owners[it->second->getTag()] == it->second.get()) {
+            audioID = it->second->getTag();
+        }
+    }
+    
+    if (audioID == -1) {
+        if (force) {
+            for(auto it = _evicts.begin(); audioID == -1 && it != _evicts.end(); ++it) {
+                std::shared_ptr<AudioFader> fader = _actives[*it];
+                if (_owners[fader->getTag()] == fader.get()) {
+                    audioID = fader->getTag();
+                    clear(*it);
+                }
+            }
+        }
+        if (audioID == -1) {
+            // Fail if nothing available
+            CULogError("No available sound channels");
+        }
+    }
+    return audioID;
+}
+
 /**
  * Returns a playable audio node for a given audio instance
  *
@@ -193,23 +287,19 @@ void AudioEngine::removeKey(const std::string key) {
  */
 std::shared_ptr<audio::AudioFader> AudioEngine::wrapInstance(const std::shared_ptr<audio::AudioNode>& instance) {
     std::shared_ptr<AudioFader> fader = nullptr;
-    if (_fadePool.empty()) {
-        fader = AudioFader::alloc(_mixer->getChannels(),_mixer->getRate());
-    } else {
-        fader = _fadePool.front();
-        _fadePool.pop_front();
-    }
     std::shared_ptr<AudioPanner> panner = nullptr;
-    if (_panPool.empty()) {
+    if (_fadePool.empty()) {
         panner = AudioPanner::alloc(_mixer->getChannels(),instance->getChannels(),_mixer->getRate());
+        fader = AudioFader::alloc(panner);
     } else {
-        panner = _panPool.front();
+        fader = _fadePool.back();
+        panner = _panPool.back();
         if (panner->getField() != instance->getChannels()) {
             panner->setField(instance->getChannels());
         }
-        _panPool.pop_front();
+        _fadePool.pop_back();
+        _panPool.pop_back();
     }
-    fader->attach(panner);
     
     // Add a resampler if we have rate issues
     if (instance->getRate() == panner->getRate()) {
@@ -276,11 +366,11 @@ std::shared_ptr<audio::AudioNode> AudioEngine::disposeWrapper(const std::shared_
                 sampler->reset();
             }
 
-            fader->detach();
-            fader->fadeOut(-1);
-            fader->reset();
+            // The panner stays attached for the next sound
             panner->detach();
             panner->reset();
+            fader->fadeOut(-1);
+            fader->reset();
             
             _fadePool.push_back(fader);
             _panPool.push_back(panner);
@@ -305,6 +395,12 @@ std::shared_ptr<audio::AudioNode> AudioEngine::disposeWrapper(const std::shared_
  */
 void AudioEngine::gcollect(const std::shared_ptr<audio::AudioNode>& sound, bool status) {
     std::string key = sound->getName();
+    // The slot is idle unless a newer sound was given it
+    Uint32 slot = sound->getTag();
+    if (slot < _owners.size() && _owners[slot] == sound.get()) {
+        _owners[slot] = nullptr;
+        _free.push_back(slot);
+    }
     disposeWrapper(sound);
     removeKey(key);
     if (_callback) {
@@ -581,34 +677,9 @@ bool AudioEngine::play(const std::string key, const std::shared_ptr<Sound>& soun
         }
     }
     
-    // Find an empty scheduler
-    int audioID = -1;
-    for(auto it = _slots.begin()+1; audioID == -1 && it != _slots.end(); ++it) {
-        if (!(*it)->isPlaying()) {
-            audioID = (*it)->getTag();
-        }
-    }
-    
-    // Try again for soon to be deleted.
-    for(auto it = _actives.begin(); audioID == -1 && it != _actives.end(); ++it) {
-        if (it->second->isFadeOut()) {
-            Uint32 tag = it->second->getTag();
-            if (!_slots[tag]->getTailSize()) {
-                audioID = tag;
-            }
-        }
-    }
-    
+    int audioID = acquireSlot(force);
     if (audioID == -1) {
-        if (force) {
-            std::string altkey = _evicts.front();
-            audioID = _actives[altkey]->getTag();
-            clear(altkey);
-        } else {
-            // Fail if nothing available
-            CULogError("No available sound channels");
-            return false;
-        }
+        return false;
     }
     
     std::shared_ptr<audio::AudioNode> player = sound->createNode();
@@ -618,6 +689,7 @@ bool AudioEngine::play(const std::string key, const std::shared_ptr<Sound>& soun
     fader->setGain(volume);
     fader->setTag(audioID);
     fader->setName(key);
+    _owners[audioID] = fader.get();
     _slots[audioID]->play(fader, loop ? -1 : 0);
     _actives.emplace(key,fader);
     _evicts.push_back(key);
@@ -670,40 +742,16 @@ bool AudioEngine::play(const std::string key, const std::shared_ptr<audio::Audio
         }
     }
     
-    // Find an empty scheduler
-    int audioID = -1;
-    for(auto it = _slots.begin()+1; audioID == -1 && it != _slots.end(); ++it) {
-        if (!(*it)->isPlaying()) {
-            audioID = (*it)->getTag();
-        }
-    }
-    
-    // Try again for soon to be deleted.
-    for(auto it = _actives.begin(); audioID == -1 && it != _actives.end(); ++it) {
-        if (it->second->isFadeOut()) {
-            Uint32 tag = it->second->getTag();
-            if (!_slots[tag]->getTailSize()) {
-                audioID = tag;
-            }
-        }
-    }
-    
+    int audioID = acquireSlot(force);
     if (audioID == -1) {
-        if (force) {
-            std::string altkey = _evicts.front();
-            audioID = _actives[altkey]->getTag();
-            clear(altkey);
-        } else {
-            // Fail if nothing available
-            CULogError("No available sound channels");
-            return false;
-        }
+        return false;
     }
 
     std::shared_ptr<AudioFader> fader = wrapInstance(graph);
     fader->setGain(volume);
     fader->setTag(audioID);
     fader->setName(key);
+    _owners[audioID] = fader.get();
     _slots[audioID]->play(fader, loop ? -1 : 0);
     _actives.emplace(key,fader);
     _evicts.push_back(key);
@@ -821,8 +869,8 @@ void AudioEngine::setLoop(const std::string key, bool loop) {
 float AudioEngine::getVolume(const std::string key) const {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
     if (_actives.find(key) != _actives.end()) {
-        Uint32 tag = _actives.at(key)->getTag();
-        std::shared_ptr<AudioNode> node = _slots[tag]->getCurrent();
+        // The fader, even if a recorded play has not reached the slot yet
+        std::shared_ptr<AudioNode> node = _actives.at(key);
         return node->getGain();
     }
     return 0;
@@ -846,8 +894,8 @@ float AudioEngine::getVolume(const std::string key) const {
 void AudioEngine::setVolume(const std::string key, float volume) {
     CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
     if (_actives.find(key) != _actives.end()) {
-        Uint32 tag = _actives.at(key)->getTag();
-        std::shared_ptr<AudioNode> node = _slots[tag]->getCurrent();
+        // The fader, even if a recorded play has not reached the slot yet
+        std::shared_ptr<AudioNode> node = _actives.at(key);
         node->setGain(volume);
     }
 }
@@ -911,21 +959,12 @@ void AudioEngine::setPanFactor(const std::string key, float pan) {
     if (_actives.find(key) != _actives.end()) {
         std::shared_ptr<AudioFader> fader = _actives.at(key);
         std::shared_ptr<AudioPanner> panner = std::dynamic_pointer_cast<AudioPanner>(fader->getInput());
-        if (panner->getField() == 1) {
-            panner->setPan(0,0,0.5-pan/2.0);
-            panner->setPan(0,1,0.5+pan/2.0);
-        } else {
-            if (pan <= 0) {
-                panner->setPan(0,0,1);
-                panner->setPan(0,1,0);
-                panner->setPan(1,0,-pan);
-                panner->setPan(1,1,1+pan);
-            } else {
-                panner->setPan(1,1,1);
-                panner->setPan(1,0,0);
-                panner->setPan(0,0,1-pan);
-                panner->setPan(0,1,pan);
-            }
+        float matrix[4];
+        Uint32 field = std::min(panner->getField(),(Uint32)2);
+        panMatrix(field,pan,matrix);
+        for(Uint32 ii = 0; ii < field; ii++) {
+            panner->setPan(ii,0,matrix[2*ii]);
+            panner->setPan(ii,1,matrix[2*ii+1]);
         }
     }
 }
@@ -1127,6 +1166,196 @@ void AudioEngine::resume(std::string key) {
 }
 
 
+#pragma mark -
+#pragma mark Batched Commands
+/**
+ * Records the given audio instance to play at the next submit.
+ *
+ * This method is the shared implementation of the two versions of
+ * {@link #recordPlay}.  It reserves a slot and wraps the instance on the
+ * main thread, so that the audio thread only has to start it.
+ *
+ * @param  key      The reference key for the sound effect
+ * @param  instance The audio instance to play
+ * @param  loop     Whether to loop the sound effect continuously
+ * @param  volume   The music volume (relative to the default volume)
+ * @param  force    Whether to force another sound to stop.
+ * @param  offset   The frame offset into the callback that starts it
+ *
+ * @return true if there was an available channel for the sound
+ */
+bool AudioEngine::recordInstance(const std::string key, const std::shared_ptr<audio::AudioNode>& instance,
+                                 bool loop, float volume, bool force, Uint32 offset) {
+    // A forced replacement needs a second command for the stop
+    if (_dispatch->getAvailable() < 2) {
+        CULogError("Audio command buffer is full");
+        return false;
+    }
+
+    if (isActive(key)) {
+        if (force) {
+            recordClear(key,0,offset);
+            removeKey(key);
+        } else {
+            CULogError("Sound effect key is in use");
+            return false;
+        }
+    }
+
+    int audioID = acquireSlot(force);
+    if (audioID == -1) {
+        return false;
+    }
+
+    std::shared_ptr<AudioFader> fader = wrapInstance(instance);
+    fader->setGain(volume);
+    fader->setTag(audioID);
+    fader->setName(key);
+    _owners[audioID] = fader.get();
+    _dispatch->recordPlay(_slots[audioID], fader, loop ? -1 : 0, offset);
+    _actives.emplace(key,fader);
+    _evicts.push_back(key);
+    return true;
+}
+
+/**
+ * Records the given sound to play at the next submit.
+ *
+ * This method is the batched version of {@link #play}.  The slot is chosen
+ * and the sound is wrapped right away, so the key is active as soon as this
+ * method returns.  However, the sound does not start until the audio thread
+ * applies the batch, after the next call to {@link #submit}.  It then starts
+ * exactly offset frames into that audio callback, so sounds with the same
+ * offset start on the same frame.  The main thread only reserves a slot,
+ * attaches the sound to a pooled fader and panner, and writes the command.
+ *
+ * Until the sound starts, {@link #getState} reports it as inactive.
+ *
+ * @param  key      The reference key for the sound effect
+ * @param  sound    The sound effect to play
+ * @param  loop     Whether to loop the sound effect continuously
+ * @param  volume   The music volume (relative to the default asset volume)
+ * @param  force    Whether to force another sound to stop.
+ * @param  offset   The frame offset into the callback that starts it
+ *
+ * @return true if there was an available channel for the sound
+ */
+bool AudioEngine::recordPlay(const std::string key, const std::shared_ptr<Sound>& sound,
+                             bool loop, float volume, bool force, Uint32 offset) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    std::shared_ptr<audio::AudioNode> player = sound->createNode();
+    player->setName("__engine_playback__");
+    return recordInstance(key,player,loop,volume,force,offset);
+}
+
+/**
+ * Records the given audio node to play at the next submit.
+ *
+ * This method is the batched version of {@link #play}, and it works like
+ * the sound version of {@link #recordPlay}.
+ *
+ * @param  key      The reference key for the sound effect
+ * @param  graph    The audio graph to play
+ * @param  loop     Whether to loop the sound effect continuously
+ * @param  volume   The music volume (relative to the default instance volume)
+ * @param  force    Whether to force another sound to stop.
+ * @param  offset   The frame offset into the callback that starts it
+ *
+ * @return true if there was an available channel for the sound
+ */
+bool AudioEngine::recordPlay(const std::string key, const std::shared_ptr<audio::AudioNode>& graph,
+                             bool loop, float volume, bool force, Uint32 offset) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    CUAssertLog(graph->getName() != "__engine_playback__",  "Audio node uses reserved name '__engine_playback__'");
+    CUAssertLog(graph->getName() != "__engine_resampler__", "Audio node uses reserved name '__engine_resampler__'");
+    return recordInstance(key,graph,loop,volume,force,offset);
+}
+
+/**
+ * Records a command to stop the sound effect for the given key.
+ *
+ * This method is the batched version of {@link #clear}.  The fade-out
+ * starts offset frames into the audio callback after the next call to
+ * {@link #submit}.  If the key does not correspond to an active sound
+ * effect, this method does nothing.
+ *
+ * @param  key      the reference key for the sound effect
+ * @param  fade     the number of seconds to fade out
+ * @param  offset   The frame offset into the callback that applies it
+ */
+void AudioEngine::recordClear(const std::string key, float fade, Uint32 offset) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    if (_actives.find(key) != _actives.end()) {
+        std::shared_ptr<AudioFader> node = _actives.at(key);
+        if (!_dispatch->recordStop(_slots[node->getTag()], node, fade, offset)) {
+            CULogError("Audio command buffer is full");
+        }
+    }
+}
+
+/**
+ * Records a command to set the volume of the sound effect.
+ *
+ * This method is the batched version of {@link #setVolume}.  If the key
+ * does not correspond to an active sound effect, this method does nothing.
+ *
+ * @param  key      the reference key for the sound effect
+ * @param  volume   the volume of the sound effect
+ * @param  offset   The frame offset into the callback that applies it
+ */
+void AudioEngine::recordVolume(const std::string key, float volume, Uint32 offset) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    if (_actives.find(key) != _actives.end()) {
+        if (!_dispatch->recordGain(_actives.at(key), volume, offset)) {
+            CULogError("Audio command buffer is full");
+        }
+    }
+}
+
+/**
+ * Records a command to set the stereo pan of the sound effect.
+ *
+ * This method is the batched version of {@link #setPanFactor}.  If the key
+ * does not correspond to an active sound effect, this method does nothing.
+ *
+ * @param  key      the reference key for the sound effect
+ * @param  pan      the stereo pan of the sound effect
+ * @param  offset   The frame offset into the callback that applies it
+ */
+void AudioEngine::recordPanFactor(const std::string key, float pan, Uint32 offset) {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    CUAssertLog(pan >= -1 && pan <= 1, "Pan value %f is out of range",pan);
+    if (_actives.find(key) != _actives.end()) {
+        std::shared_ptr<AudioFader> fader = _actives.at(key);
+        std::shared_ptr<AudioPanner> panner = std::dynamic_pointer_cast<AudioPanner>(fader->getInput());
+        float matrix[4];
+        Uint32 field = std::min(panner->getField(),(Uint32)2);
+        if (_dispatch->getAvailable() < 2*field) {
+            CULogError("Audio command buffer is full");
+            return;
+        }
+        panMatrix(field,pan,matrix);
+        for(Uint32 ii = 0; ii < field; ii++) {
+            _dispatch->recordPan(panner, ii, 0, matrix[2*ii], offset);
+            _dispatch->recordPan(panner, ii, 1, matrix[2*ii+1], offset);
+        }
+    }
+}
+
+/**
+ * Submits all recorded commands to the audio thread.
+ *
+ * The audio thread applies the whole batch at the start of its next
+ * callback, each command at its frame offset.  This method should be
+ * called once per animation frame, after the last command of the frame.
+ *
+ * @return the number of commands submitted
+ */
+Uint32 AudioEngine::submit() {
+    CUAssertLog(_output != nullptr, "Attempt to use an unintiatialized audio engine");
+    return _dispatch->submit();
+}
+
 #pragma mark -
 #pragma mark Global Management
 /**
@@ -0,0 +1,506 @@
+//
+//  CUAudioDispatcher.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an audio node that applies playback commands from the
+//  main thread at sample-accurate positions.  Calling the graph nodes directly
+//  from the main thread publishes every change separately, and each change
+//  takes effect at whatever point the audio thread happens to be in.  This
+//  node instead records the commands in a lock-free ring buffer.  The main
+//  thread submits them once per frame, and the audio thread applies the whole
+//  batch in its next callback.  Plays start at their frame offset inside the
+//  scheduler, and the other commands split the read of the input.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/audio/graph/CUAudioDispatcher.h>
+#include <cugl/audio/graph/CUAudioScheduler.h>
+#include <cugl/audio/graph/CUAudioFader.h>
+#include <cugl/audio/graph/CUAudioPanner.h>
+#include <cugl/math/dsp/CUDSPMath.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace cugl::audio;
+
+#pragma mark Constructors
+/**
+ * Creates a degenerate dispatcher with no input and no capacity.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a graph node on
+ * the heap, use one of the static constructors instead.
+ */
+AudioDispatcher::AudioDispatcher() :
+_input(nullptr),
+_ring(nullptr),
+_order(nullptr),
+_capacity(0),
+_record(0),
+_tail(0),
+_head(0) {
+    _classname = "AudioDispatcher";
+}
+
+/**
+ * Initializes the node with default stereo settings
+ *
+ * The number of channels is two, for stereo output.  The sample rate is
+ * the modern standard of 48000 HZ.  The dispatcher can hold
+ * {@link DEFAULT_DISPATCH_SIZE} commands.
+ *
+ * @return true if initialization was successful
+ */
+bool AudioDispatcher::init() {
+    return init(DEFAULT_CHANNELS,DEFAULT_SAMPLING,DEFAULT_DISPATCH_SIZE);
+}
+
+/**
+ * Initializes the node with the given number of channels and sample rate
+ *
+ * The dispatcher can hold {@link DEFAULT_DISPATCH_SIZE} commands.
+ *
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ *
+ * @return true if initialization was successful
+ */
+bool AudioDispatcher::init(Uint8 channels, Uint32 rate) {
+    return init(channels,rate,DEFAULT_DISPATCH_SIZE);
+}
+
+/**
+ * Initializes the node with the given channels, sample rate and capacity
+ *
+ * The capacity is the number of commands that can be recorded before
+ * the audio thread applies them.  It is rounded up to a power of two.
+ *
+ * @param channels  The number of audio channels
+ * @param rate      The sample rate (frequency) in HZ
+ * @param capacity  The number of commands the dispatcher can hold
+ *
+ * @return true if initialization was successful
+ */
+bool AudioDispatcher::init(Uint8 channels, Uint32 rate, Uint32 capacity) {
+    CUAssertLog(capacity > 0, "Dispatcher capacity must be positive");
+    if (!AudioNode::init(channels,rate)) {
+        return false;
+    }
+
+    _capacity = 1;
+    while (_capacity < capacity) {
+        _capacity *= 2;
+    }
+    _ring  = new Entry[_capacity];
+    _order = new Uint32[_capacity];
+    _record = 0;
+    _tail.store(0,std::memory_order_relaxed);
+    _head.store(0,std::memory_order_relaxed);
+    _input = nullptr;
+    return true;
+}
+
+/**
+ * Initializes a dispatcher for the given input node.
+ *
+ * This node acquires the channels and sample rate of the input.  If
+ * input is nullptr, this method will fail.
+ *
+ * @param input     The audio node to dispatch for
+ * @param capacity  The number of commands the dispatcher can hold
+ *
+ * @return true if initialization was successful
+ */
+bool AudioDispatcher::init(const std::shared_ptr<AudioNode>& input, Uint32 capacity) {
+    if (input && init(input->getChannels(),input->getRate(),capacity)) {
+        _input = input;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Disposes any resources allocated for this dispatcher
+ *
+ * The state of the node is reset to that of an uninitialized constructor.
+ * Unlike the destructor, this method allows the node to be reinitialized.
+ */
+void AudioDispatcher::dispose() {
+    if (_booted) {
+        AudioNode::dispose();
+        _input = nullptr;
+        delete[] _ring;
+        delete[] _order;
+        _ring  = nullptr;
+        _order = nullptr;
+        _capacity = 0;
+        _record = 0;
+        _tail.store(0,std::memory_order_relaxed);
+        _head.store(0,std::memory_order_relaxed);
+    }
+}
+
+#pragma mark -
+#pragma mark Audio Graph
+/**
+ * Attaches an audio node to this dispatcher.
+ *
+ * This method will fail if the channels of the audio node do not agree
+ * with this dispatcher.
+ *
+ * @param node  The audio node to dispatch for
+ *
+ * @return true if the attachment was successful
+ */
+bool AudioDispatcher::attach(const std::shared_ptr<AudioNode>& node) {
+    if (!_booted) {
+        CUAssertLog(_booted, "Cannot attach to an uninitialized audio node");
+        return false;
+    } else if (node == nullptr) {
+        detach();
+        return true;
+    } else if (node->getChannels() != _channels) {
+        CUAssertLog(false,"Input node has wrong number of channels: %d", node->getChannels());
+        return false;
+    } else if (node->getRate() != _sampling) {
+        CUAssertLog(false,"Input node has wrong sample rate: %d", node->getRate());
+        return false;
+    }
+
+    std::atomic_exchange_explicit(&_input,node,std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * Detaches an audio node from this dispatcher.
+ *
+ * If the method succeeds, it returns the audio node that was removed.
+ *
+ * @return  The audio node to detach (or null if failed)
+ */
+std::shared_ptr<AudioNode> AudioDispatcher::detach() {
+    if (!_booted) {
+        CUAssertLog(_booted, "Cannot detach from an uninitialized audio node");
+        return nullptr;
+    }
+
+    std::shared_ptr<AudioNode> result = std::atomic_exchange_explicit(&_input,{},std::memory_order_relaxed);
+    return result;
+}
+
+#pragma mark -
+#pragma mark Command Recording
+/**
+ * Returns the next ring entry to record, or nullptr if the ring is full
+ *
+ * @param command   The command type
+ * @param offset    The frame offset of the command
+ *
+ * @return the next ring entry to record, or nullptr if the ring is full
+ */
+AudioDispatcher::Entry* AudioDispatcher::record(Command command, Uint32 offset) {
+    if (_record-_head.load(std::memory_order_acquire) >= _capacity) {
+        return nullptr;
+    }
+    Entry* entry = _ring+(_record & (_capacity-1));
+    _record++;
+    entry->command = command;
+    entry->offset  = offset;
+    return entry;
+}
+
+/**
+ * Records a command to play a node on the given scheduler.
+ *
+ * When applied, the node interrupts the active node of the scheduler (see
+ * {@link AudioScheduler#start}).  The loop value works exactly as it does
+ * for {@link AudioScheduler#play}.  The command is not applied until the
+ * next call to {@link #submit}.
+ *
+ * @param slot      The scheduler to play on
+ * @param node      The audio node for playback
+ * @param loops     The number of times to loop the audio
+ * @param offset    The frame offset into the callback that applies it
+ *
+ * @return true if the command was recorded
+ */
+bool AudioDispatcher::recordPlay(const std::shared_ptr<AudioScheduler>& slot,
+                                 const std::shared_ptr<AudioNode>& node, Sint32 loops, Uint32 offset) {
+    Entry* entry = record(Command::PLAY,offset);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->slot  = slot;
+    entry->node  = node;
+    entry->index = loops;
+    return true;
+}
+
+/**
+ * Records a command to fade out a node on the given scheduler.
+ *
+ * When applied, the loops of the scheduler are cancelled if the fader is
+ * its active node, and the fader starts a fade-out over the given number
+ * of seconds.  A fade of 0 stops the node at that frame.  The command is
+ * not applied until the next call to {@link #submit}.
+ *
+ * @param slot      The scheduler playing the fader
+ * @param fader     The fader to fade out
+ * @param fade      The number of seconds to fade out
+ * @param offset    The frame offset into the callback that applies it
+ *
+ * @return true if the command was recorded
+ */
+bool AudioDispatcher::recordStop(const std::shared_ptr<AudioScheduler>& slot,
+                                 const std::shared_ptr<AudioFader>& fader, float fade, Uint32 offset) {
+    Entry* entry = record(Command::STOP,offset);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->slot  = slot;
+    entry->node  = fader;
+    entry->value = fade;
+    return true;
+}
+
+/**
+ * Records a command to set the gain of a node.
+ *
+ * The command is not applied until the next call to {@link #submit}.
+ *
+ * @param node      The node to scale
+ * @param gain      The new gain of the node
+ * @param offset    The frame offset into the callback that applies it
+ *
+ * @return true if the command was recorded
+ */
+bool AudioDispatcher::recordGain(const std::shared_ptr<AudioNode>& node, float gain, Uint32 offset) {
+    Entry* entry = record(Command::GAIN,offset);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->slot  = nullptr;
+    entry->node  = node;
+    entry->value = gain;
+    return true;
+}
+
+/**
+ * Records a command to set an entry of the matrix of a panner.
+ *
+ * The entry is the same as for {@link AudioPanner#setPan}. The command is
+ * not applied until the next call to {@link #submit}.
+ *
+ * @param panner    The panner to adjust
+ * @param field     The input channel
+ * @param channel   The output channel
+ * @param value     The amount of the input channel sent to the output channel
+ * @param offset    The frame offset into the callback that applies it
+ *
+ * @return true if the command was recorded
+ */
+bool AudioDispatcher::recordPan(const std::shared_ptr<AudioPanner>& panner,
+                                Uint32 field, Uint32 channel, float value, Uint32 offset) {
+    Entry* entry = record(Command::PAN,offset);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->slot    = nullptr;
+    entry->node    = panner;
+    entry->index   = field;
+    entry->channel = channel;
+    entry->value   = value;
+    return true;
+}
+
+/**
+ * Submits all recorded commands to the audio thread.
+ *
+ * The audio thread applies them all in its next callback.  This method is
+ * a single atomic store, so it should be called once per animation frame,
+ * after all of the commands for that frame have been recorded.
+ *
+ * @return the number of commands submitted
+ */
+Uint32 AudioDispatcher::submit() {
+    Uint32 size = _record-_tail.load(std::memory_order_relaxed);
+    if (size) {
+        _tail.store(_record,std::memory_order_release);
+    }
+    return size;
+}
+
+#pragma mark -
+#pragma mark Overriden Methods
+/**
+ * Applies the given command to the audio graph.
+ *
+ * AUDIO THREAD ONLY: This is an internal method for {@link read}.
+ *
+ * @param entry The command to apply
+ */
+void AudioDispatcher::apply(const Entry& entry) {
+    switch (entry.command) {
+        case Command::PLAY:
+            // Plays are handled by the scheduler delay in read
+            break;
+        case Command::STOP:
+            if (entry.slot->getCurrent() == entry.node) {
+                entry.slot->setLoops(0);
+            }
+            // A fade-out of 0 would cancel the fade, so stop within a frame
+            static_cast<AudioFader*>(entry.node.get())->fadeOut(std::max((double)entry.value,1.5/_sampling));
+            break;
+        case Command::GAIN:
+            entry.node->setGain(entry.value);
+            break;
+        case Command::PAN:
+            static_cast<AudioPanner*>(entry.node.get())->setPan(entry.index,entry.channel,entry.value);
+            break;
+    }
+}
+
+/**
+ * Reads up to the specified number of frames into the given buffer
+ *
+ * AUDIO THREAD ONLY: Users should never access this method directly.
+ * The only exception is when the user needs to create a custom subclass
+ * of this AudioNode.
+ *
+ * The buffer should have enough room to store frames * channels elements.
+ * The channels are interleaved into the output buffer.
+ *
+ * This method applies every submitted command.  Plays are handed to their
+ * scheduler with the offset as a delay.  The other commands split the read
+ * of the input at their offsets.  It always fills the entire buffer, using
+ * silence if there is no input.
+ *
+ * @param buffer    The read buffer to store the results
+ * @param frames    The maximum number of frames to read
+ *
+ * @return the actual number of frames read
+ */
+Uint32 AudioDispatcher::read(float* buffer, Uint32 frames) {
+    std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
+    Uint32 mask = _capacity-1;
+    Uint32 head = _head.load(std::memory_order_relaxed);
+    Uint32 tail = _tail.load(std::memory_order_acquire);
+    Uint32 size = tail-head;
+
+    // Plays are delayed inside their scheduler, so they never split the read.
+    // Order everything else by offset. Insertion sort is stable, allocation
+    // free, and linear when the commands were recorded in order.
+    Uint32 count = 0;
+    for(Uint32 ii = 0; ii < size; ii++) {
+        Uint32 pos = head+ii;
+        const Entry& entry = _ring[pos & mask];
+        if (entry.command == Command::PLAY) {
+            entry.slot->start(entry.node,entry.index,std::min(entry.offset,frames));
+            continue;
+        }
+        Uint32 jj = count++;
+        while (jj > 0 && _ring[_order[jj-1] & mask].offset > entry.offset) {
+            _order[jj] = _order[jj-1];
+            jj--;
+        }
+        _order[jj] = pos;
+    }
+
+    bool paused = _paused.load(std::memory_order_relaxed);
+    Uint32 next = 0;
+    Uint32 amt  = 0;
+    while (amt < frames) {
+        while (next < count && _ring[_order[next] & mask].offset <= amt) {
+            apply(_ring[_order[next] & mask]);
+            next++;
+        }
+
+        Uint32 stop = frames;
+        if (next < count) {
+            stop = std::min(frames,_ring[_order[next] & mask].offset);
+        }
+
+        float* output = buffer+amt*_channels;
+        Uint32 got = 0;
+        if (input != nullptr && !paused) {
+            got = input->read(output,stop-amt);
+        }
+        if (got < stop-amt) {
+            std::memset(output+got*_channels,0,(stop-amt-got)*_channels*sizeof(float));
+        }
+        amt = stop;
+    }
+
+    // Offsets past the end of this read
+    while (next < count) {
+        apply(_ring[_order[next] & mask]);
+        next++;
+    }
+    if (size) {
+        _head.store(tail,std::memory_order_release);
+    }
+
+    float gain = _ndgain.load(std::memory_order_relaxed);
+    if (gain != 1) {
+        dsp::DSPMath::scale(buffer,gain,buffer,frames*_channels);
+    }
+    return frames;
+}
+
+/**
+ * Returns true if this audio node has no more data.
+ *
+ * A dispatcher is completed when its input is completed (or missing).
+ *
+ * @return true if this audio node has no more data.
+ */
+bool AudioDispatcher::completed() {
+    std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
+    return (input == nullptr || input->completed());
+}
+
+/**
+ * Resets the read position to the marked position of the audio stream.
+ *
+ * DELEGATED METHOD: This method delegates its call to the input node.  It
+ * returns false if there is no input node or if this method is unsupported.
+ *
+ * @return true if the read position was moved.
+ */
+bool AudioDispatcher::reset() {
+    std::shared_ptr<AudioNode> input = std::atomic_load_explicit(&_input,std::memory_order_relaxed);
+    if (input) {
+        return input->reset();
+    }
+    return false;
+}
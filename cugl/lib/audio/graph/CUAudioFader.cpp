@@ -365,9 +365,9 @@ bool AudioFader::isFadePause() {
 Uint32 AudioFader::doFadeIn(float* buffer, Uint32 frames) {
     if (_inmark >= 0) {
         Uint32 left = std::min(frames,(Uint32)(_inmark-_fadein));
-        float start = (float)_fadein/(float)_inmark;
-        float ends  = (float)(left+_fadein)/(float)_inmark;
-        dsp::DSPMath::slide(buffer,start,ends,buffer,left*_channels);
+        float step  = 1.0f/(float)_inmark;
+        float start = (float)_fadein*step;
+        dsp::DSPMath::ramp(buffer,_channels,start,step,buffer,left);
         _fadein += left;
         if (_fadein >= _inmark) {
             _inmark = -1;
@@ -403,9 +403,9 @@ Uint32 AudioFader::doFadeOut(float* buffer, Uint32 frames) {
     Sint32 amt = frames;
     if (_outmark >= 0) {
         Sint32 left = std::max(std::min(amt,(Sint32)(_outmark-_fadeout)),0);
-        float start = (float)(_outmark-_fadeout)/(float)_outmark;
-        float ends  = (float)(_outmark-left-_fadeout)/(float)_outmark;
-        dsp::DSPMath::slide(buffer,start,ends,buffer,left*_channels);
+        float step  = 1.0f/(float)_outmark;
+        float start = (float)(_outmark-_fadeout)*step;
+        dsp::DSPMath::ramp(buffer,_channels,start,-step,buffer,left);
         _fadeout += left;
         if (_fadeout >= _outmark) {
             _outmark = -1;
@@ -448,9 +448,9 @@ Uint32 AudioFader::doFadePause(float* buffer, Uint32 frames) {
     if (_dipmark >= 0) {
         if (_diphalf) {
             Uint32 left = std::min(amt,(Uint32)std::max((Sint32)(_dipmark+_dipstop-_fadedip),(Sint32)0));
-            float start = (float)(_fadedip-_dipmark)/(float)_dipstop;
-            float ends  = (float)(left+_fadedip-_dipmark)/(float)_dipstop;
-            dsp::DSPMath::slide(buffer,start,ends,buffer,left*_channels);
+            float step  = 1.0f/(float)_dipstop;
+            float start = (float)(_fadedip-_dipmark)*step;
+            dsp::DSPMath::ramp(buffer,_channels,start,step,buffer,left);
             _fadedip += left;
             if (_fadedip >= _dipmark+_dipstop) {
                 _dipmark = -1;
@@ -460,9 +460,9 @@ Uint32 AudioFader::doFadePause(float* buffer, Uint32 frames) {
             }
         } else {
             Uint32 left = std::min(amt,(Uint32)std::max((Sint32)(_dipmark-_fadedip),(Sint32)0));
-            float start = (float)(_dipmark-_fadedip)/(float)_dipmark;
-            float ends  = (float)(_dipmark-left-_fadedip)/(float)_dipmark;
-            dsp::DSPMath::slide(buffer,start,ends,buffer,left*_channels);
+            float step  = 1.0f/(float)_dipmark;
+            float start = (float)(_dipmark-_fadedip)*step;
+            dsp::DSPMath::ramp(buffer,_channels,start,-step,buffer,left);
             _fadedip += left;
             if (_fadedip >= _dipmark) {
                 _paused.store(true,std::memory_order_relaxed);
@@ -33,6 +33,7 @@
 //
 #include <cugl/audio/graph/CUAudioPanner.h>
 #include <cugl/audio/CUAudioDevices.h>
+#include <cugl/math/dsp/CUDSPMath.h>
 #include <cugl/util/CUDebug.h>
 #include <cmath>
 
@@ -49,7 +50,8 @@ using namespace cugl::audio;
  */
 AudioPanner::AudioPanner() : AudioNode(),
 _field(0),
-_mapper(nullptr) {
+_mapper(nullptr),
+_matrix(nullptr) {
     _input = nullptr;
     _classname = "AudioPanner";
 }
@@ -120,6 +122,9 @@ void AudioPanner::dispose() {
     if (_booted) {
         AudioNode::dispose();
         delete[] _mapper;
+        delete[] _matrix;
+        _mapper = nullptr;
+        _matrix = nullptr;
         free(_buffer);
         _buffer = nullptr;
         _capacity = 0;
@@ -196,8 +201,11 @@ bool AudioPanner::setField(Uint8 field) {
         return false;
     }
     
+    delete[] _mapper;
+    delete[] _matrix;
     _field  = field;
     _mapper = new std::atomic<float>[field*_channels];
+    _matrix = new float[field*_channels];
     for(int ii = 0; ii < field; ii++) {
         for(int jj = 0; jj < _channels; jj++) {
             if (ii == jj) {
@@ -283,22 +291,14 @@ Uint32 AudioPanner::read(float* buffer, Uint32 frames) {
         std::memset(buffer,0,frames*_channels*sizeof(float));
     } else {
         frames = std::min(frames,_capacity);
-        std::memset(buffer,0,frames*_channels*sizeof(float));
         Uint32 amt = input->read(_buffer, frames);
-        for(int ii = 0; ii < _field; ii++) {
-            for(int jj = 0; jj < _channels; jj++) {
-                float percent =  _mapper[ii*_channels+jj].load(std::memory_order_relaxed);
-                if (percent > 0) {
-                    float* output = buffer+jj;
-                    float* input  = _buffer+ii;
-                    Uint32 tmp = amt;
-                    while (tmp--) {
-                        *output += *input*percent;
-                        output += _channels;
-                        input += _field;
-                    }
-                }
-            }
+        Uint32 size = _field*_channels;
+        for(Uint32 ii = 0; ii < size; ii++) {
+            _matrix[ii] = std::max(_mapper[ii].load(std::memory_order_relaxed),0.0f);
+        }
+        dsp::DSPMath::pan(_buffer,_field,_matrix,_channels,buffer,amt);
+        if (amt < frames) {
+            std::memset(buffer+amt*_channels,0,(frames-amt)*_channels*sizeof(float));
         }
         return amt;
     }
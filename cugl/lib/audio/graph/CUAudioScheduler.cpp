@@ -188,11 +188,13 @@ void AudioNodeQueue::clear() {
  */
 AudioScheduler::AudioScheduler() : AudioNode(),
 _previous(nullptr),
-_buffer(nullptr),
 _loops(0),
+_overlap(0),
+_buffer(nullptr),
+_pendloops(0),
+_delay(0),
 _qsize(0),
 _qskip(0),
-_overlap(0),
 _mempos(-1) {
     _classname = "AudioScheduler";
 }
@@ -269,6 +271,9 @@ void AudioScheduler::dispose() {
         _mempos = 0;
         _current  = nullptr;
         _previous = nullptr;
+        _pending  = nullptr;
+        _pendloops = 0;
+        _delay = 0;
     }
 }
 
@@ -548,6 +553,58 @@ void AudioScheduler::setLoops(Sint32 loop) {
     _loops.store(loop,std::memory_order_relaxed);
 }
 
+/**
+ * Plays the given audio node after a delay, interrupting the active node.
+ *
+ * AUDIO THREAD ONLY: Users should never access this method directly.
+ * It is used by {@link AudioDispatcher} to start a node at a precise
+ * frame of a read.  From the main thread, use {@link #play} instead.
+ *
+ * If the delay is 0, the node starts immediately.  Otherwise, the active
+ * node continues for delay more frames, and the next reads switch over
+ * at exactly that frame.  Only one node can wait at a time, so a second
+ * call before the switch replaces the waiting node.
+ *
+ * The interrupted node (if any) is reported to the callback function.
+ * Any nodes waiting in the queue are unaffected, and will play after
+ * this one.  The loop value works exactly as it does for {@link #play}.
+ *
+ * @param node  The audio node for playback
+ * @param loop  The number of times to loop the audio
+ * @param delay The number of frames to wait before playback
+ */
+void AudioScheduler::start(const std::shared_ptr<AudioNode>& node, Sint32 loop, Uint32 delay) {
+    if (node->getChannels() != _channels) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+                     "AudioNode has the wrong number of channels: %d",
+                     node->getChannels());
+        return;
+    } else if (node->getRate() != _sampling) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+                     "AudioNode has the wrong frequency: %d",
+                     node->getRate());
+        return;
+    }
+
+    if (_pending != nullptr && _calling.load(std::memory_order_relaxed)) {
+        notify(_pending,Action::INTERRUPT);
+    }
+    if (delay > 0) {
+        _pending = node;
+        _pendloops = loop;
+        _delay = delay;
+        return;
+    }
+
+    _pending = nullptr;
+    _delay = 0;
+    if (_current != nullptr && _calling.load(std::memory_order_relaxed)) {
+        notify(_current,Action::INTERRUPT);
+    }
+    _current = node;
+    _loops.store(loop,std::memory_order_relaxed);
+}
+
 #pragma mark Overriden Methods
 /**
  * Reads up to the specified number of frames into the given buffer
@@ -573,6 +630,24 @@ Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
         return frames;
     }
     
+    if (_pending != nullptr) {
+        // Split the read at the frame where the pending node starts
+        std::shared_ptr<AudioNode> pending = _pending;
+        _pending = nullptr;
+        Uint32 lead = std::min(_delay,frames);
+        read(buffer,lead);
+        _delay -= lead;
+        if (_delay > 0) {
+            _pending = pending;
+        } else {
+            start(pending,_pendloops);
+            if (lead < frames) {
+                read(buffer+lead*_channels,frames-lead);
+            }
+        }
+        return frames;
+    }
+    
     _polling.store(true);
     Uint32 skip = _qskip.exchange(0);
     
@@ -600,19 +675,12 @@ Uint32 AudioScheduler::read(float* buffer, Uint32 frames) {
             }
             amt += goal;
             
-            // Now mix
-            real = goal*_channels;
+            // Now mix (previous falls to zero after step frames)
             Uint32 step = std::min((Uint32)remain,overlap);
-            while (real--) {
-                float factor = (float)(step)/overlap;
-                *output = *input*factor+*output*(1-factor);
-                output++;
-                input++;
-                if (real % _channels == 0 && step > 0) {
-                    step--;
-                }
-            }
-\
+            float slope = 1.0f/overlap;
+            dsp::DSPMath::crossfade(input,output,_channels,step*slope,-slope,
+                                    output,std::min(goal,step));
+
             // And shift if we are done.
             if (goal >= remain) {
                 if (_calling.load(std::memory_order_relaxed)) {
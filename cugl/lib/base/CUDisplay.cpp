@@ -107,12 +107,17 @@ bool Display::init(std::string title, Rect bounds, Uint32 flags) {
         return false;
     }
     
+#ifdef CU_GL_HEADLESS
+    // The headless backend does not need an OpenGL window
+    Uint32 sdlflags = SDL_WINDOW_HIDDEN;
+#else
     // We have to set the OpenGL prefs BEFORE creating window
     if (!prepareOpenGL(flags & INIT_MULTISAMPLED)) {
         return false;
     }
 
     Uint32 sdlflags = SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL;
+#endif
     if (flags & INIT_HIGH_DPI) {
         sdlflags |= SDL_WINDOW_ALLOW_HIGHDPI;
     }
@@ -530,12 +535,14 @@ bool Display::initOpenGL(bool multisample) {
     }
 #endif
     
-    // Create the OpenGL context
+    // Create the OpenGL context (unless it is stubbed out)
+#ifndef CU_GL_HEADLESS
     _glContext = SDL_GL_CreateContext( _window );
     if( _glContext == NULL )  {
         CULogError("Could not create OpenGL context: %s", SDL_GetError() );
         return false;
     }
+#endif
     
     // Multisampling support
 #if CU_GL_PLATFORM != CU_GL_OPENGLES
@@ -567,7 +574,9 @@ bool Display::initOpenGL(bool multisample) {
  * necessary
  */
 void Display::refresh() {
+#ifndef CU_GL_HEADLESS
     SDL_GL_SwapWindow(_window);
+#endif
     Orientation oldDisplay = _displayOrientation;
     Orientation oldDevice  = _deviceOrientation;
     _displayOrientation = DisplayOrientation(true);
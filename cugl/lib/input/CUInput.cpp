@@ -183,6 +183,62 @@ bool Input::update(SDL_Event event) {
     return result;
 }
 
+#pragma mark -
+#pragma mark Late Latching
+/** The number of events read from SDL at a time when latching */
+#define LATCH_BATCH 16
+
+/**
+ * Processes any pointer events that arrived since the start of the frame.
+ *
+ * Input is normally gathered once, at the start of the animation frame.
+ * An event that arrives while the frame is being updated must wait for the
+ * next frame.  This method pumps the SDL event queue again, and sends any
+ * pending mouse and touch events to the active devices, invoking their
+ * listeners immediately.  All other events are left in the queue for the
+ * next frame.
+ *
+ * The intended use is to call this method immediately before the physics
+ * step, so that the step sees the freshest possible pointer state.  This
+ * method does not clear the device state, so {@link InputDevice#clearState()}
+ * semantics are unchanged.  It must be called from the main thread.
+ *
+ * @return the number of pointer events processed.
+ */
+int Input::latch() {
+    if (!_singleton) { return 0; }
+
+    // Each range is contiguous in SDL_EventType
+    static const Uint32 ranges[2][2] = {
+        { SDL_MOUSEMOTION, SDL_MOUSEWHEEL },
+        { SDL_FINGERDOWN,  SDL_FINGERMOTION }
+    };
+
+    SDL_PumpEvents();
+    SDL_Event events[LATCH_BATCH];
+    int total = 0;
+    for(int ii = 0; ii < 2; ii++) {
+        // Leave the events alone if no device wants them
+        bool subscribed = false;
+        for(Uint32 type = ranges[ii][0]; !subscribed && type <= ranges[ii][1]; type++) {
+            subscribed = _singleton->_subscribers.find(type) != _singleton->_subscribers.end();
+        }
+        if (!subscribed) {
+            continue;
+        }
+
+        int count = 0;
+        do {
+            count = SDL_PeepEvents(events, LATCH_BATCH, SDL_GETEVENT, ranges[ii][0], ranges[ii][1]);
+            for(int jj = 0; jj < count; jj++) {
+                _singleton->update(events[jj]);
+            }
+            total += (count > 0 ? count : 0);
+        } while (count == LATCH_BATCH);
+    }
+    return total;
+}
+
 #pragma mark -
 #pragma mark Internal Helpers
 /**
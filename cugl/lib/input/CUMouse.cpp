@@ -431,6 +431,7 @@ bool Mouse::updateState(const SDL_Event& event, const Timestamp& stamp) {
 				MouseEvent mevent(SDL_BUTTON(event.button.button), Vec2((float)event.button.x, (float)event.button.y), stamp);
                 _currPoint  = mevent.position;
                 _currState -= mevent.buttons;
+                _history.push(InputSample::Type::RELEASE,event.button.which,mevent.position,stamp);
                 for(auto it = _releaseListeners.begin(); it != _releaseListeners.end(); ++it) {
                     it->second(mevent,event.button.clicks,it->first == _focus);
                 }
@@ -441,6 +442,7 @@ bool Mouse::updateState(const SDL_Event& event, const Timestamp& stamp) {
                 MouseEvent mevent(SDL_BUTTON(event.button.button),Vec2((float)event.button.x, (float)event.button.y),stamp);
                 _currPoint  = mevent.position;
                 _currState |= mevent.buttons;
+                _history.push(InputSample::Type::PRESS,event.button.which,mevent.position,stamp);
                 for(auto it = _pressListeners.begin(); it != _pressListeners.end(); ++it) {
                     it->second(mevent,event.button.clicks,it->first == _focus);
                 }
@@ -448,6 +450,8 @@ bool Mouse::updateState(const SDL_Event& event, const Timestamp& stamp) {
             break;
         case SDL_MOUSEMOTION:
             if (event.motion.which != SDL_TOUCH_MOUSEID) {
+                _history.push(InputSample::Type::MOTION,event.motion.which,
+                              Vec2((float)event.motion.x, (float)event.motion.y),stamp);
                 if (_awareness == PointerAwareness::DRAG && event.motion.state > 0) {
                     MouseEvent mevent(SDL_BUTTON(event.button.button),Vec2((float)event.button.x, (float)event.button.y),stamp);
                     Vec2 previous((float)(event.motion.x-event.motion.xrel),(float)(event.motion.y-event.motion.yrel));
@@ -349,6 +349,7 @@ bool Touchscreen::updateState(const SDL_Event& event, const Timestamp& stamp) {
             tevent.position *= Application::get()->getDisplayBounds().size;
             tevent.position += Application::get()->getDisplayBounds().origin;
             _current[tevent.touch] = tevent.position;
+            _history.push(InputSample::Type::PRESS,(Uint64)tevent.touch,tevent.position,stamp);
             for(auto it = _beginListeners.begin(); it != _beginListeners.end(); ++it) {
                 it->second(tevent,it->first == _focus);
             }
@@ -362,6 +363,7 @@ bool Touchscreen::updateState(const SDL_Event& event, const Timestamp& stamp) {
             tevent.position *= Application::get()->getDisplayBounds().size;
             tevent.position += Application::get()->getDisplayBounds().origin;
             _current.erase(tevent.touch);
+            _history.push(InputSample::Type::RELEASE,(Uint64)tevent.touch,tevent.position,stamp);
             for(auto it = _finishListeners.begin(); it != _finishListeners.end(); ++it) {
                 it->second(tevent,it->first == _focus);
             }
@@ -381,6 +383,7 @@ bool Touchscreen::updateState(const SDL_Event& event, const Timestamp& stamp) {
             previous += origin;
 
             _current[tevent.touch] = tevent.position;
+            _history.push(InputSample::Type::MOTION,(Uint64)tevent.touch,tevent.position,stamp);
             for(auto it = _moveListeners.begin(); it != _moveListeners.end(); ++it) {
                 it->second(tevent,previous,it->first == _focus);
             }
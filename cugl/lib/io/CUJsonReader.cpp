@@ -47,10 +47,46 @@
 //  Version: 11/28/16
 //
 #include <cugl/io/CUJsonReader.h>
+#include <cugl/assets/CUJsonParser.h>
 #include <cugl/util/CUDebug.h>
 
 using namespace cugl;
 
+/**
+ * Loads the remainder of the stream into the read buffer.
+ *
+ * The parser needs the JSON text in one contiguous block.  Rather than
+ * refilling the buffer a chunk at a time, this method reads everything
+ * left in the stream with a single read.  Text after the JSON value is
+ * kept in the buffer, so later reads are unaffected.
+ */
+void JsonReader::load() {
+    if (_bufoff > 0) {
+        _sbuffer.erase(_sbuffer.begin(), _sbuffer.begin() + _bufoff);
+    }
+    _bufoff = 0;
+    if (!_stream) {
+        return;
+    }
+
+    if (_ssize >= 0) {
+        if (_scursor < _ssize) {
+            size_t offset = _sbuffer.size();
+            _sbuffer.resize(offset+(size_t)(_ssize-_scursor));
+            size_t amt = SDL_RWread(_stream, &_sbuffer[offset], 1, (size_t)(_ssize-_scursor));
+            _sbuffer.resize(offset+amt);
+            _scursor += amt;
+        }
+    } else {
+        // Streams of unknown size are read a chunk at a time
+        size_t amt = 0;
+        do {
+            amt = SDL_RWread(_stream, _cbuffer, 1, _capacity);
+            _sbuffer.append(_cbuffer,amt);
+        } while (amt > 0);
+    }
+}
+
 /**
  * Returns the next available JSON string
  *
@@ -60,48 +96,36 @@ using namespace cugl;
  *
  * If the first non-whitespace character is a brace, it will advance until
  * it reaches the matching brace, or the end of the file, whichever is first.
- * If it finds no matching brace, it will fail.
+ * If it finds no matching brace, it will fail.  Braces inside of strings
+ * are ignored.
  *
  * @return the next available JSON string
  */
 std::string JsonReader::readJsonString() {
     CUAssertLog(ready(), "Attempt to read a finished stream");
     skip();
+    load();
     
     // Make sure first character a bracket
     CUAssertLog(_sbuffer[_bufoff] == '{', "JSON is missing initial {");
     
-    int depth = 0;
-    std::string data;
-    // Go until close brace.
-    while (ready()) {
-        fill();
-        int pos = 0;
-        for(auto it = _sbuffer.begin()+_bufoff; it != _sbuffer.end(); ++it) {
-            if (*it == '{') {
-                depth++;
-            } else if (*it == '}') {
-                depth--;
-            }
-            if (depth == 0) {
-                data.append(_sbuffer.begin()+_bufoff,it+1);
-                _bufoff += pos+1;
-                return data;
-            }
-            pos++;
-        }
-        data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-        _bufoff =  (int)_sbuffer.size();
+    size_t length = JsonParser::scan(_sbuffer.data()+_bufoff, _sbuffer.size()-_bufoff);
+    if (length == 0) {
+        CUAssertLog(false, "JSON is missing closing }");
+        _bufoff = (Sint32)_sbuffer.size();
+        return "";
     }
-    CUAssertLog(false, "JSON is missing closing }");
-    return "";
+    std::string data(_sbuffer, _bufoff, length);
+    _bufoff += (Sint32)length;
+    return data;
 }
 
 /**
  * Returns a newly allocated JsonValue for the next available JSON string.
  *
- * This method uses {@link readJsonString()} to extract the next available
- * JSON string and constructs a JsonValue from that.
+ * This method parses the JSON value directly from the read buffer, without
+ * extracting it as a string first.  The read head is left just after the
+ * value.
  *
  * If there is a parsing error, this  method will return nullptr.  Detailed
  * information about the parsing error will be passed to an assert.  Hence
@@ -110,9 +134,21 @@ std::string JsonReader::readJsonString() {
  * @return a newly allocated JsonValue for the next available JSON string.
  */
 std::shared_ptr<JsonValue> JsonReader::readJson() {
-    std::string data = readJsonString();
-    if (!data.empty()) {
-        return JsonValue::allocWithJson(data);
+    CUAssertLog(ready(), "Attempt to read a finished stream");
+    skip();
+    load();
+    
+    // Make sure first character a bracket
+    CUAssertLog(_sbuffer[_bufoff] == '{', "JSON is missing initial {");
+    
+    std::shared_ptr<JsonValue> result = JsonValue::allocNull();
+    JsonParser parser;
+    parser.init();
+    size_t length = parser.parse(result.get(), _sbuffer.data()+_bufoff, _sbuffer.size()-_bufoff);
+    if (length == 0) {
+        CUAssertLog(false, "%s", parser.getError().c_str());
+        return nullptr;
     }
-    return nullptr;
+    _bufoff += (Sint32)length;
+    return result;
 }
@@ -1039,13 +1039,13 @@ bool Poly2::containsCrossing(float x, float y) const {
     if (_geom == Geometry::IMPLICIT) {
         for (size_t ii = 0; ii < _vertices.size(); ii++) {
             Vec2 v1 = _vertices[ii];
-            Vec2 v2 = _vertices[ii+1];
+            Vec2 v2 = _vertices[(ii+1) % _vertices.size()];
             if (((v1.y <= y && y < v2.y) || (v2.y <= y && y < v1.y)) && x < ((v2.x - v1.x) / (v2.y - v1.y) * (y - v1.y) + v1.x)) {
                 intersects++;
             }
         }
     } else {
-        for (size_t ii = 0; ii < _indices.size()-2; ii += 2) {
+        for (size_t ii = 0; ii+1 < _indices.size(); ii += 2) {
             Vec2 v1 = _vertices[_indices[ii]  ];
             Vec2 v2 = _vertices[_indices[ii+1]];
             if (((v1.y <= y && y < v2.y) || (v2.y <= y && y < v1.y)) && x < ((v2.x - v1.x) / (v2.y - v1.y) * (y - v1.y) + v1.x)) {
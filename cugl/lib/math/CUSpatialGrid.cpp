@@ -0,0 +1,387 @@
+//
+//  CUSpatialGrid.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a uniform grid for proximity queries on moving
+//  points.  Scanning every entity to find those near a point is quadratic
+//  when every entity asks the question.  This class buckets the points by
+//  grid cell so that a radius or nearest neighbor query only visits the
+//  cells around it.  The cells are hashed into a fixed table, so the grid
+//  has no bounds, and it is stored in two flat arrays so that a rebuild is
+//  a single counting sort.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/math/CUSpatialGrid.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <cmath>
+
+/** The smallest number of hash buckets */
+#define MIN_BUCKETS     16
+/** The largest cell coordinate (so that rings never overflow) */
+#define MAX_CELL        (1 << 28)
+
+using namespace cugl;
+
+/** A candidate of a k-nearest query, ordered by distance and then index */
+typedef std::pair<float,Uint32> Candidate;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty grid with the given cell size
+ *
+ * @param size  The width and height of a cell
+ */
+SpatialGrid::SpatialGrid(float size) :
+_mask(0),
+_minX(0),
+_minY(0),
+_maxX(-1),
+_maxY(-1) {
+    setCellSize(size);
+}
+
+/**
+ * Sets the width and height of a cell
+ *
+ * Changing the cell size clears the grid.
+ *
+ * @param size  The width and height of a cell
+ */
+void SpatialGrid::setCellSize(float size) {
+    CUAssertLog(size > 0, "Cell size %f is not positive", size);
+    _cellSize = size;
+    _cellInverse = 1.0f/size;
+    clear();
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns the cell coordinate of the given position coordinate
+ *
+ * @param value The position coordinate
+ *
+ * @return the cell coordinate of the given position coordinate
+ */
+Sint32 SpatialGrid::cell(float value) const {
+    float result = floorf(value*_cellInverse);
+    if (result < -MAX_CELL) {
+        return -MAX_CELL;
+    } else if (result > MAX_CELL) {
+        return MAX_CELL;
+    }
+    return (Sint32)result;
+}
+
+/**
+ * Returns the number of rings around the given cell that hold points
+ *
+ * A query centered in this cell need never look past this ring.
+ *
+ * @param x The cell column
+ * @param y The cell row
+ *
+ * @return the number of rings around the given cell that hold points
+ */
+Sint32 SpatialGrid::extent(Sint32 x, Sint32 y) const {
+    Sint32 result = std::max(x-_minX,_maxX-x);
+    return std::max(result,std::max(y-_minY,_maxY-y));
+}
+
+#pragma mark -
+#pragma mark Construction
+/**
+ * Removes all points from this grid
+ */
+void SpatialGrid::clear() {
+    _items.clear();
+    _buckets.assign(MIN_BUCKETS+1,0);
+    _mask = MIN_BUCKETS-1;
+    _minX = _minY = 0;
+    _maxX = _maxY = -1;
+}
+
+/**
+ * Replaces the points of this grid with the given points
+ *
+ * Every later query refers to a point by its position in this vector.
+ *
+ * @param points    The points to store
+ */
+void SpatialGrid::build(const std::vector<Vec2>& points) {
+    if (points.empty()) {
+        clear();
+        return;
+    }
+
+    Uint32 count = MIN_BUCKETS;
+    while (count < 2*points.size()) {
+        count *= 2;
+    }
+    _mask = count-1;
+    _buckets.assign(count+1,0);
+    _items.resize(points.size());
+
+    // Count the points in each bucket, offset by one
+    _minX = _minY = MAX_CELL;
+    _maxX = _maxY = -MAX_CELL;
+    for(auto it = points.begin(); it != points.end(); ++it) {
+        Sint32 x = cell(it->x);
+        Sint32 y = cell(it->y);
+        _minX = std::min(_minX,x);
+        _maxX = std::max(_maxX,x);
+        _minY = std::min(_minY,y);
+        _maxY = std::max(_maxY,y);
+        _buckets[bucket(x,y)+1]++;
+    }
+    for(Uint32 ii = 1; ii <= count; ii++) {
+        _buckets[ii] += _buckets[ii-1];
+    }
+
+    // Place each point, advancing the bucket start to its end
+    for(Uint32 ii = 0; ii < points.size(); ii++) {
+        Item item;
+        item.point = points[ii];
+        item.x = cell(item.point.x);
+        item.y = cell(item.point.y);
+        item.index = ii;
+        _items[_buckets[bucket(item.x,item.y)]++] = item;
+    }
+    for(Uint32 ii = count; ii > 0; ii--) {
+        _buckets[ii] = _buckets[ii-1];
+    }
+    _buckets[0] = 0;
+}
+
+#pragma mark -
+#pragma mark Queries
+/**
+ * Appends the indices of all points within radius of center.
+ *
+ * A point is within radius if its distance to center is strictly less
+ * than radius. The indices are appended in no particular order.
+ *
+ * @param center    The query center
+ * @param radius    The query radius
+ * @param result    The vector to store the indices
+ *
+ * @return the number of indices appended
+ */
+size_t SpatialGrid::query(const Vec2 center, float radius, std::vector<Uint32>& result) const {
+    size_t start = result.size();
+    float limit = radius*radius;
+    Sint32 x0 = std::max(cell(center.x-radius),_minX);
+    Sint32 x1 = std::min(cell(center.x+radius),_maxX);
+    Sint32 y0 = std::max(cell(center.y-radius),_minY);
+    Sint32 y1 = std::min(cell(center.y+radius),_maxY);
+    if (x0 > x1 || y0 > y1) {
+        return 0;
+    }
+
+    if (scans(std::max(x1-x0,y1-y0)+1)) {
+        for(auto it = _items.begin(); it != _items.end(); ++it) {
+            if (center.distanceSquared(it->point) < limit) {
+                result.push_back(it->index);
+            }
+        }
+        return result.size()-start;
+    }
+
+    for(Sint32 y = y0; y <= y1; y++) {
+        for(Sint32 x = x0; x <= x1; x++) {
+            Uint32 b = bucket(x,y);
+            for(Uint32 ii = _buckets[b]; ii < _buckets[b+1]; ii++) {
+                const Item& item = _items[ii];
+                if (item.x == x && item.y == y && center.distanceSquared(item.point) < limit) {
+                    result.push_back(item.index);
+                }
+            }
+        }
+    }
+    return result.size()-start;
+}
+
+/**
+ * Offers every point that may be nearest to the given point to the visitor.
+ *
+ * The cells are visited in rings of increasing distance. The visitor has a
+ * method consider(dist,index), taking the squared distance and index of a
+ * point within radius, and a method done(bound), returning true if no point
+ * at squared distance bound or more can improve the result.
+ *
+ * @param point     The query point
+ * @param radius    The largest distance to consider
+ * @param visitor   The visitor collecting the result
+ */
+template <typename Visitor>
+void SpatialGrid::search(const Vec2 point, float radius, Visitor& visitor) const {
+    float limit = radius*radius;
+
+    // Points in ring r are at least (r-1) cells away
+    Sint32 cx = cell(point.x);
+    Sint32 cy = cell(point.y);
+    Sint32 rings = extent(cx,cy);
+    if (radius < (float)MAX_CELL*_cellSize) {
+        rings = std::min(rings,(Sint32)(radius*_cellInverse)+1);
+    }
+
+    if (scans(2*(Sint64)rings+1)) {
+        for(auto it = _items.begin(); it != _items.end(); ++it) {
+            float dist = point.distanceSquared(it->point);
+            if (dist < limit) {
+                visitor.consider(dist,it->index);
+            }
+        }
+        return;
+    }
+
+    auto visit = [&](Sint32 x, Sint32 y) {
+        if (x < _minX || x > _maxX || y < _minY || y > _maxY) {
+            return;
+        }
+
+        Uint32 b = bucket(x,y);
+        for(Uint32 ii = _buckets[b]; ii < _buckets[b+1]; ii++) {
+            const Item& item = _items[ii];
+            if (item.x == x && item.y == y) {
+                float dist = point.distanceSquared(item.point);
+                if (dist < limit) {
+                    visitor.consider(dist,item.index);
+                }
+            }
+        }
+    };
+
+    for(Sint32 r = 0; r <= rings; r++) {
+        if (r == 0) {
+            visit(cx,cy);
+        } else {
+            for(Sint32 dx = -r; dx <= r; dx++) {
+                visit(cx+dx,cy-r);
+                visit(cx+dx,cy+r);
+            }
+            for(Sint32 dy = 1-r; dy < r; dy++) {
+                visit(cx-r,cy+dy);
+                visit(cx+r,cy+dy);
+            }
+        }
+
+        // Every unvisited point is at least r cells away
+        float bound = r*_cellSize;
+        if (visitor.done(bound*bound)) {
+            return;
+        }
+    }
+}
+
+/**
+ * Returns the index of the point nearest to the given point.
+ *
+ * Only points strictly within radius are considered. Ties are broken
+ * by the lower index. If there is no such point, this method returns -1.
+ *
+ * @param point     The query point
+ * @param radius    The largest distance to consider
+ *
+ * @return the index of the point nearest to the given point.
+ */
+Sint32 SpatialGrid::nearest(const Vec2 point, float radius) const {
+    struct Best {
+        Candidate best;
+        bool found;
+
+        void consider(float dist, Uint32 index) {
+            Candidate next(dist,index);
+            if (!found || next < best) {
+                best = next;
+                found = true;
+            }
+        }
+        bool done(float bound) const {
+            return found && best.first < bound;
+        }
+    };
+
+    Best visitor;
+    visitor.found = false;
+    if (!_items.empty()) {
+        search(point,radius,visitor);
+    }
+    return visitor.found ? (Sint32)visitor.best.second : -1;
+}
+
+/**
+ * Appends the indices of the k points nearest to the given point.
+ *
+ * Only points strictly within radius are considered, so fewer than k
+ * indices may be appended. The indices are appended in order of
+ * increasing distance, with ties broken by the lower index.
+ *
+ * @param point     The query point
+ * @param k         The number of points to find
+ * @param result    The vector to store the indices
+ * @param radius    The largest distance to consider
+ *
+ * @return the number of indices appended
+ */
+size_t SpatialGrid::nearest(const Vec2 point, size_t k, std::vector<Uint32>& result, float radius) const {
+    // A max heap of the best candidates so far
+    struct Heap {
+        std::vector<Candidate> heap;
+        size_t k;
+
+        void consider(float dist, Uint32 index) {
+            Candidate next(dist,index);
+            if (heap.size() < k) {
+                heap.push_back(next);
+                std::push_heap(heap.begin(),heap.end());
+            } else if (next < heap.front()) {
+                std::pop_heap(heap.begin(),heap.end());
+                heap.back() = next;
+                std::push_heap(heap.begin(),heap.end());
+            }
+        }
+        bool done(float bound) const {
+            return heap.size() == k && heap.front().first < bound;
+        }
+    };
+
+    if (_items.empty() || k == 0) {
+        return 0;
+    }
+    Heap visitor;
+    visitor.k = k;
+    visitor.heap.reserve(std::min(k,_items.size()));
+    search(point,radius,visitor);
+
+    std::sort_heap(visitor.heap.begin(),visitor.heap.end());
+    for(auto it = visitor.heap.begin(); it != visitor.heap.end(); ++it) {
+        result.push_back(it->second);
+    }
+    return visitor.heap.size();
+}
@@ -40,6 +40,7 @@
 
 #include <cugl/math/CUSpline2.h>
 #include <cugl/math/CUPolynomial.h>
+#include <atomic>
 
 using namespace std;
 using namespace cugl;
@@ -67,6 +68,7 @@ using namespace cugl;
  * @param  end      The second bezier anchor point
  */
 Spline2::Spline2(const Vec2 start, const Vec2 end) {
+    _version = nextVersion();
     _points.push_back(start);
     _points.push_back(start);
     _points.push_back(end);
@@ -97,6 +99,7 @@ Spline2::Spline2(const Vec2 start, const Vec2 end) {
  * @param  size     The number of floats to use in the array
  */
 Spline2::Spline2(const float* points, int size) {
+    _version = nextVersion();
     CUAssertLog(size - 2 % 6 != 0, "Control point array is the wrong size");
     
     _size = (size - 2) / 6;
@@ -136,6 +139,7 @@ Spline2::Spline2(const float* points, int size) {
  * @param  points   The vector of control points as floats
  */
 Spline2::Spline2(const vector<float>& points) {
+    _version = nextVersion();
     CUAssertLog(points.size() % 6 != 2, "Control point array is the wrong size");
     
     _size = ((int)points.size() - 2) / 6;
@@ -175,6 +179,7 @@ Spline2::Spline2(const vector<float>& points) {
  * @param  points   The vector of control points
  */
 Spline2::Spline2(const vector<Vec2>& points) {
+    _version = nextVersion();
 //    std::cout << points.size() << endl;
     CUAssertLog(points.size() % 3 == 1, "Control point array is the wrong size");
     
@@ -203,6 +208,7 @@ Spline2::Spline2(const vector<Vec2>& points) {
  * @param  spline   The spline to copy
  */
 Spline2::Spline2(const Spline2& spline) {
+    _version = nextVersion();
     _size = spline._size;
     _closed = spline._closed;
     _points.assign(spline._points.begin(), spline._points.end());
@@ -229,6 +235,7 @@ Spline2::Spline2(const Spline2& spline) {
  * @return This spline, returned for chaining
  */
 Spline2& Spline2::set(const Vec2 start, const Vec2 end) {
+    _version = nextVersion();
     _points.clear();
     _smooth.clear();
     _points.push_back(start);
@@ -263,6 +270,7 @@ Spline2& Spline2::set(const Vec2 start, const Vec2 end) {
  * @return This spline, returned for chaining
  */
 Spline2& Spline2::set(const float* points, int size) {
+    _version = nextVersion();
     CUAssertLog(size - 2 % 6 != 0, "Constrol point array is the wrong size");
     _points.clear();
     _smooth.clear();
@@ -306,6 +314,7 @@ Spline2& Spline2::set(const float* points, int size) {
  * @return This spline, returned for chaining
  */
 Spline2& Spline2::set(const std::vector<float>& points) {
+    _version = nextVersion();
     CUAssertLog(points.size() % 6 != 2, "Control point array is the wrong size");
     _points.clear();
     _smooth.clear();
@@ -350,6 +359,7 @@ Spline2& Spline2::set(const std::vector<float>& points) {
  * @return This spline, returned for chaining
  */
 Spline2& Spline2::set(const std::vector<Vec2>& points) {
+    _version = nextVersion();
     CUAssertLog(points.size() % 3 != 1, "Control point array is the wrong size");
     _points.clear();
     _smooth.clear();
@@ -382,6 +392,7 @@ Spline2& Spline2::set(const std::vector<Vec2>& points) {
  * @return This spline, returned for chaining
  */
 Spline2& Spline2::set(const Spline2& spline) {
+    _version = nextVersion();
     _size = spline._size;
     _closed = spline._closed;
     _points.clear();
@@ -410,6 +421,7 @@ Spline2& Spline2::set(const Spline2& spline) {
  * @param flag whether the spline is closed
  */
 void Spline2::setClosed(bool flag) {
+    _version = nextVersion();
     if (flag && (_points[0] != _points[3 * _size])) {
         addAnchor(_points[0]);
     }
@@ -466,6 +478,7 @@ Vec2 Spline2::getPoint(int segment, float tp) const {
  * @param  point    the new value to assign
  */
 void Spline2::setPoint(float tp, const Vec2 point) {
+    _version = nextVersion();
     CUAssertLog(tp >= 0 && tp <= _size, "Parameter out of bounds");
     CUAssertLog(!_closed || tp < _size, "Parameter out of bounds for closed spline");
     
@@ -514,6 +527,7 @@ Vec2 Spline2::getAnchor(int index) const {
  * @param  point    the new value to assign
  */
 void Spline2::setAnchor(int index, const Vec2 point) {
+    _version = nextVersion();
     CUAssertLog(index >= 0 && index < _size, "Index out of bounds");
     CUAssertLog(!_closed || index < _size - 1, "Index out of bounds for closed spline");
     
@@ -583,6 +597,7 @@ bool Spline2::getSmooth(int index) const {
  * @return the smoothness for the anchor point at the given index.
  */
 void Spline2::setSmooth(int index, bool flag) {
+    _version = nextVersion();
     CUAssertLog(index >= 0 && index < _size, "Index out of bounds");
     CUAssertLog(!_closed || index < _size - 1, "Index out of bounds for closed spline");
     
@@ -663,6 +678,7 @@ Vec2 Spline2::getTangent(int index) const {
  * @param  symmetric whether to make the other tangent symmetric
  */
 void Spline2::setTangent(int index, const Vec2 tang, bool symmetric) {
+    _version = nextVersion();
     CUAssertLog(index >= 0 && index < 2 * _size, "Index out of bounds");
     
     int spline = (index + 1) / 2;
@@ -775,6 +791,7 @@ Polynomial Spline2::getPolynomialY(int segment) const {
  * @return the new number of segments in this spline
  */
 int Spline2::addAnchor(const Vec2 point, const Vec2 tang) {
+    _version = nextVersion();
     CUAssertLog(!_closed, "Cannot append to closed curve");
     
     _points.resize(_points.size() + 3, Vec2::ZERO);
@@ -810,6 +827,7 @@ int Spline2::addAnchor(const Vec2 point, const Vec2 tang) {
  * @param  index    the anchor index to delete
  */
 void Spline2::deleteAnchor(int index) {
+    _version = nextVersion();
     CUAssertLog(index >= 0 && index < _size, "Index out of bounds");
     CUAssertLog(!_closed || index < _size - 1, "Index out of bounds for closed spline");
     
@@ -839,6 +857,7 @@ void Spline2::deleteAnchor(int index) {
  * @param  tp       the parameterization value
  */
 void Spline2::insertAnchor(int segment, float param) {
+    _version = nextVersion();
     CUAssertLog(segment >= 0 && segment < _size, "Illegal spline segment");
     CUAssertLog(param > 0.0f && param < 1.0f, "Illegal insertion parameter");
     
@@ -948,6 +967,19 @@ int Spline2::nearestTangent(const Vec2 point, float threshold) const {
 }
 
 #pragma mark Internal Helpers
+/**
+ * Returns a version number never returned before.
+ *
+ * Versions are shared by all splines, so no two spline states ever have the
+ * same version, even across different splines. This method is thread safe.
+ *
+ * @return a version number never returned before.
+ */
+Uint64 Spline2::nextVersion() {
+    static std::atomic<Uint64> counter(0);
+    return ++counter;
+}
+
 /**
  * Applies de Castlejau's to a bezier, putting the result in left & right
  *
@@ -410,6 +410,350 @@ size_t DSPMath::slide_add(float* input1, float* input2, float start, float end,
 }
 
         
+#pragma mark -
+#pragma mark Ramp Methods
+/**
+ * Scales an interleaved input signal by a gain ramp, storing the result in output
+ *
+ * Unlike {@link slide}, the gain changes per frame, not per element, so
+ * every channel of a frame is scaled by the same amount.  The gain for
+ * frame k is start+k*step.  So a fade-in over n frames has step 1/n, and a
+ * fade-out has step -1/n.  The caller computes the increment once, and
+ * there is no division in the loop.
+ *
+ * The vectorized version requires that the number of channels divide 4
+ * (e.g. mono, stereo or quadraphonic).  Other layouts use the scalar loop.
+ *
+ * It is safe for output to be the same as the input buffer.
+ *
+ * @param input     The input buffer
+ * @param channels  The number of interleaved channels
+ * @param start     The gain for the first frame
+ * @param step      The gain increment per frame
+ * @param output    The output buffer
+ * @param frames    The number of frames to process
+ *
+ * @return the number of frames successfully processed
+ */
+size_t DSPMath::ramp(const float* input, Uint32 channels, float start, float step,
+                     float* output, size_t frames) {
+#if defined (CU_MATH_VECTOR_SSE)
+    if (VECTORIZE && channels && 4 % channels == 0) {
+        size_t size = frames*channels;
+        // Frame index of each lane, advanced a block at a time
+        __m128 index = _mm_setr_ps(0,(float)(1/channels),(float)(2/channels),(float)(3/channels));
+        const __m128 skip = _mm_set1_ps((float)(4/channels));
+        const __m128 base = _mm_set1_ps(start);
+        const __m128 incr = _mm_set1_ps(step);
+        size_t ii;
+        for(ii = 0; ii+3 < size; ii += 4) {
+            __m128 gain = _mm_add_ps(base,_mm_mul_ps(index,incr));
+            _mm_storeu_ps(output+ii, _mm_mul_ps(_mm_loadu_ps(input+ii),gain));
+            index = _mm_add_ps(index,skip);
+        }
+        for(; ii < size; ii++) {
+            output[ii] = input[ii]*(start+(float)(ii/channels)*step);
+        }
+    } else {
+#elif defined (CU_MATH_VECTOR_NEON64)
+#if defined (__ANDROID__)
+    if (VECTORIZE && channels && 4 % channels == 0 && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
+        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
+#else
+    if (VECTORIZE && channels && 4 % channels == 0) {
+#endif
+        size_t size = frames*channels;
+        float32x4_t index = {0,(float)(1/channels),(float)(2/channels),(float)(3/channels)};
+        const float32x4_t skip = vdupq_n_f32((float)(4/channels));
+        const float32x4_t base = vdupq_n_f32(start);
+        const float32x4_t incr = vdupq_n_f32(step);
+        size_t ii;
+        for(ii = 0; ii+3 < size; ii += 4) {
+            float32x4_t gain = vaddq_f32(base,vmulq_f32(index,incr));
+            vst1q_f32(output+ii, vmulq_f32(vld1q_f32(input+ii),gain));
+            index = vaddq_f32(index,skip);
+        }
+        for(; ii < size; ii++) {
+            output[ii] = input[ii]*(start+(float)(ii/channels)*step);
+        }
+    } else {
+#else
+    {
+#endif
+        for(size_t kk = 0; kk < frames; kk++) {
+            float gain = start+(float)kk*step;
+            for(Uint32 jj = 0; jj < channels; jj++) {
+                output[kk*channels+jj] = input[kk*channels+jj]*gain;
+            }
+        }
+    }
+    return frames;
+}
+
+/**
+ * Linearly crossfades two interleaved input signals, storing the result in output
+ *
+ * The gain g for frame k is start+k*step.  The first input is scaled by g
+ * and the second by 1-g.  So a fade from input1 to input2 over n frames
+ * has start 1 and step -1/n.  Every channel of a frame has the same gain.
+ *
+ * The vectorized version requires that the number of channels divide 4.
+ * Other layouts use the scalar loop.
+ *
+ * It is safe for output to be the same as one of the two input buffers.
+ *
+ * @param input1    The first input buffer
+ * @param input2    The second input buffer
+ * @param channels  The number of interleaved channels
+ * @param start     The gain of input1 for the first frame
+ * @param step      The gain increment per frame
+ * @param output    The output buffer
+ * @param frames    The number of frames to process
+ *
+ * @return the number of frames successfully processed
+ */
+size_t DSPMath::crossfade(const float* input1, const float* input2, Uint32 channels,
+                          float start, float step, float* output, size_t frames) {
+#if defined (CU_MATH_VECTOR_SSE)
+    if (VECTORIZE && channels && 4 % channels == 0) {
+        size_t size = frames*channels;
+        __m128 index = _mm_setr_ps(0,(float)(1/channels),(float)(2/channels),(float)(3/channels));
+        const __m128 skip = _mm_set1_ps((float)(4/channels));
+        const __m128 base = _mm_set1_ps(start);
+        const __m128 incr = _mm_set1_ps(step);
+        const __m128 ones = _mm_set1_ps(1.0f);
+        size_t ii;
+        for(ii = 0; ii+3 < size; ii += 4) {
+            __m128 gain = _mm_add_ps(base,_mm_mul_ps(index,incr));
+            __m128 left = _mm_mul_ps(_mm_loadu_ps(input1+ii),gain);
+            __m128 rght = _mm_mul_ps(_mm_loadu_ps(input2+ii),_mm_sub_ps(ones,gain));
+            _mm_storeu_ps(output+ii, _mm_add_ps(left,rght));
+            index = _mm_add_ps(index,skip);
+        }
+        for(; ii < size; ii++) {
+            float gain = start+(float)(ii/channels)*step;
+            output[ii] = input1[ii]*gain+input2[ii]*(1-gain);
+        }
+    } else {
+#elif defined (CU_MATH_VECTOR_NEON64)
+#if defined (__ANDROID__)
+    if (VECTORIZE && channels && 4 % channels == 0 && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
+        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
+#else
+    if (VECTORIZE && channels && 4 % channels == 0) {
+#endif
+        size_t size = frames*channels;
+        float32x4_t index = {0,(float)(1/channels),(float)(2/channels),(float)(3/channels)};
+        const float32x4_t skip = vdupq_n_f32((float)(4/channels));
+        const float32x4_t base = vdupq_n_f32(start);
+        const float32x4_t incr = vdupq_n_f32(step);
+        const float32x4_t ones = vdupq_n_f32(1.0f);
+        size_t ii;
+        for(ii = 0; ii+3 < size; ii += 4) {
+            float32x4_t gain = vaddq_f32(base,vmulq_f32(index,incr));
+            float32x4_t left = vmulq_f32(vld1q_f32(input1+ii),gain);
+            float32x4_t rght = vmulq_f32(vld1q_f32(input2+ii),vsubq_f32(ones,gain));
+            vst1q_f32(output+ii, vaddq_f32(left,rght));
+            index = vaddq_f32(index,skip);
+        }
+        for(; ii < size; ii++) {
+            float gain = start+(float)(ii/channels)*step;
+            output[ii] = input1[ii]*gain+input2[ii]*(1-gain);
+        }
+    } else {
+#else
+    {
+#endif
+        for(size_t kk = 0; kk < frames; kk++) {
+            float gain = start+(float)kk*step;
+            for(Uint32 jj = 0; jj < channels; jj++) {
+                size_t ii = kk*channels+jj;
+                output[ii] = input1[ii]*gain+input2[ii]*(1-gain);
+            }
+        }
+    }
+    return frames;
+}
+
+/**
+ * Crossfades two interleaved input signals at equal power, storing the result in output
+ *
+ * This is the same as {@link crossfade}, except that input1 is scaled by
+ * sqrt(g) and input2 by sqrt(1-g).  The squares of the gains sum to 1, so
+ * two uncorrelated signals keep a constant loudness through the fade.
+ * The value g is clamped to [0,1].
+ *
+ * The vectorized version requires that the number of channels divide 4.
+ * Other layouts use the scalar loop.
+ *
+ * It is safe for output to be the same as one of the two input buffers.
+ *
+ * @param input1    The first input buffer
+ * @param input2    The second input buffer
+ * @param channels  The number of interleaved channels
+ * @param start     The value g for the first frame
+ * @param step      The increment of g per frame
+ * @param output    The output buffer
+ * @param frames    The number of frames to process
+ *
+ * @return the number of frames successfully processed
+ */
+size_t DSPMath::crossfade_power(const float* input1, const float* input2, Uint32 channels,
+                                float start, float step, float* output, size_t frames) {
+#if defined (CU_MATH_VECTOR_SSE)
+    if (VECTORIZE && channels && 4 % channels == 0) {
+        size_t size = frames*channels;
+        __m128 index = _mm_setr_ps(0,(float)(1/channels),(float)(2/channels),(float)(3/channels));
+        const __m128 skip = _mm_set1_ps((float)(4/channels));
+        const __m128 base = _mm_set1_ps(start);
+        const __m128 incr = _mm_set1_ps(step);
+        const __m128 ones = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        size_t ii;
+        for(ii = 0; ii+3 < size; ii += 4) {
+            __m128 gain = _mm_add_ps(base,_mm_mul_ps(index,incr));
+            gain = _mm_min_ps(_mm_max_ps(gain,zero),ones);
+            __m128 left = _mm_mul_ps(_mm_loadu_ps(input1+ii),_mm_sqrt_ps(gain));
+            __m128 rght = _mm_mul_ps(_mm_loadu_ps(input2+ii),_mm_sqrt_ps(_mm_sub_ps(ones,gain)));
+            _mm_storeu_ps(output+ii, _mm_add_ps(left,rght));
+            index = _mm_add_ps(index,skip);
+        }
+        for(; ii < size; ii++) {
+            float gain = clampf(start+(float)(ii/channels)*step,0,1);
+            output[ii] = input1[ii]*sqrtf(gain)+input2[ii]*sqrtf(1-gain);
+        }
+    } else {
+#elif defined (CU_MATH_VECTOR_NEON64)
+#if defined (__ANDROID__)
+    if (VECTORIZE && channels && 4 % channels == 0 && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
+        (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
+#else
+    if (VECTORIZE && channels && 4 % channels == 0) {
+#endif
+        size_t size = frames*channels;
+        float32x4_t index = {0,(float)(1/channels),(float)(2/channels),(float)(3/channels)};
+        const float32x4_t skip = vdupq_n_f32((float)(4/channels));
+        const float32x4_t base = vdupq_n_f32(start);
+        const float32x4_t incr = vdupq_n_f32(step);
+        const float32x4_t ones = vdupq_n_f32(1.0f);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        size_t ii;
+        for(ii = 0; ii+3 < size; ii += 4) {
+            float32x4_t gain = vaddq_f32(base,vmulq_f32(index,incr));
+            gain = vminq_f32(vmaxq_f32(gain,zero),ones);
+            float32x4_t left = vmulq_f32(vld1q_f32(input1+ii),vsqrtq_f32(gain));
+            float32x4_t rght = vmulq_f32(vld1q_f32(input2+ii),vsqrtq_f32(vsubq_f32(ones,gain)));
+            vst1q_f32(output+ii, vaddq_f32(left,rght));
+            index = vaddq_f32(index,skip);
+        }
+        for(; ii < size; ii++) {
+            float gain = clampf(start+(float)(ii/channels)*step,0,1);
+            output[ii] = input1[ii]*sqrtf(gain)+input2[ii]*sqrtf(1-gain);
+        }
+    } else {
+#else
+    {
+#endif
+        for(size_t kk = 0; kk < frames; kk++) {
+            float gain = clampf(start+(float)kk*step,0,1);
+            float left = sqrtf(gain);
+            float rght = sqrtf(1-gain);
+            for(Uint32 jj = 0; jj < channels; jj++) {
+                size_t ii = kk*channels+jj;
+                output[ii] = input1[ii]*left+input2[ii]*rght;
+            }
+        }
+    }
+    return frames;
+}
+
+#pragma mark -
+#pragma mark Channel Methods
+/**
+ * Maps an interleaved input signal onto new channels, storing the result in output
+ *
+ * The matrix is field x channels, in row-major order.  Output channel j of
+ * a frame is the sum over input channels i of the input times the value
+ * matrix[i*channels+j].
+ *
+ * The vectorized version supports mono and stereo input to stereo output,
+ * the only layouts that the audio engine uses.  Other layouts use the
+ * scalar loop.
+ *
+ * It is NOT safe for output to be the same as the input buffer.
+ *
+ * @param input     The input buffer
+ * @param field     The number of input channels
+ * @param matrix    The field x channels pan matrix
+ * @param channels  The number of output channels
+ * @param output    The output buffer
+ * @param frames    The number of frames to process
+ *
+ * @return the number of frames successfully processed
+ */
+size_t DSPMath::pan(const float* input, Uint32 field, const float* matrix, Uint32 channels,
+                    float* output, size_t frames) {
+    size_t done = 0;
+#if defined (CU_MATH_VECTOR_SSE)
+    if (VECTORIZE && channels == 2 && field == 1) {
+        // Four mono frames become two blocks of two stereo frames
+        const __m128 gain = _mm_setr_ps(matrix[0],matrix[1],matrix[0],matrix[1]);
+        for(; done+3 < frames; done += 4) {
+            __m128 data = _mm_loadu_ps(input+done);
+            _mm_storeu_ps(output+2*done,   _mm_mul_ps(_mm_unpacklo_ps(data,data),gain));
+            _mm_storeu_ps(output+2*done+4, _mm_mul_ps(_mm_unpackhi_ps(data,data),gain));
+        }
+    } else if (VECTORIZE && channels == 2 && field == 2) {
+        // Each block is two frames (L0 R0 L1 R1)
+        const __m128 lgain = _mm_setr_ps(matrix[0],matrix[1],matrix[0],matrix[1]);
+        const __m128 rgain = _mm_setr_ps(matrix[2],matrix[3],matrix[2],matrix[3]);
+        for(; done+1 < frames; done += 2) {
+            __m128 data = _mm_loadu_ps(input+2*done);
+            __m128 left = _mm_shuffle_ps(data,data,_MM_SHUFFLE(2,2,0,0));
+            __m128 rght = _mm_shuffle_ps(data,data,_MM_SHUFFLE(3,3,1,1));
+            _mm_storeu_ps(output+2*done, _mm_add_ps(_mm_mul_ps(left,lgain),_mm_mul_ps(rght,rgain)));
+        }
+    }
+#elif defined (CU_MATH_VECTOR_NEON64)
+#if defined (__ANDROID__)
+    bool vectorize = VECTORIZE && android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
+                     (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+#else
+    bool vectorize = VECTORIZE;
+#endif
+    if (vectorize && channels == 2 && field == 1) {
+        const float32x4_t gain = {matrix[0],matrix[1],matrix[0],matrix[1]};
+        for(; done+3 < frames; done += 4) {
+            float32x4_t data = vld1q_f32(input+done);
+            vst1q_f32(output+2*done,   vmulq_f32(vzip1q_f32(data,data),gain));
+            vst1q_f32(output+2*done+4, vmulq_f32(vzip2q_f32(data,data),gain));
+        }
+    } else if (vectorize && channels == 2 && field == 2) {
+        const float32x4_t lgain = {matrix[0],matrix[1],matrix[0],matrix[1]};
+        const float32x4_t rgain = {matrix[2],matrix[3],matrix[2],matrix[3]};
+        for(; done+1 < frames; done += 2) {
+            float32x4_t data = vld1q_f32(input+2*done);
+            float32x4_t left = vtrn1q_f32(data,data);
+            float32x4_t rght = vtrn2q_f32(data,data);
+            vst1q_f32(output+2*done, vaddq_f32(vmulq_f32(left,lgain),vmulq_f32(rght,rgain)));
+        }
+    }
+#endif
+    // Frame-major, so each frame is read and written once
+    for(size_t kk = done; kk < frames; kk++) {
+        const float* src = input+kk*field;
+        float* dst = output+kk*channels;
+        for(Uint32 jj = 0; jj < channels; jj++) {
+            float sum = 0;
+            for(Uint32 ii = 0; ii < field; ii++) {
+                sum += src[ii]*matrix[ii*channels+jj];
+            }
+            dst[jj] = sum;
+        }
+    }
+    return frames;
+}
+
 #pragma mark -
 #pragma mark Clamp Methods
 /**
@@ -0,0 +1,555 @@
+//
+//  CUPolyHitTester.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a batch point-in-polygon tester.  Poly2::contains
+//  tests one point at a time, walking the polygon edges (or triangles) on
+//  every call.  This class flattens the edges of one or more polygons into a
+//  precomputed table, stored as structure-of-arrays so that the crossing test
+//  runs four edges (or four points) at a time with SSE or Neon.  Polygons with
+//  many edges are also split into horizontal slabs, so that a point is only
+//  tested against the edges that can cross its ray.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/math/polygon/CUPolyHitTester.h>
+#include <cugl/math/CUMathBase.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <limits>
+
+/** The average number of edges to aim for in a slab */
+#define SLAB_EDGES  4
+/** The maximum number of slabs in a single polygon */
+#define MAX_SLABS   256
+
+using namespace cugl;
+
+/** An empty lower bound (no value is below it) */
+static const float EMPTY_MIN = std::numeric_limits<float>::infinity();
+/** An empty upper bound (no value is above it) */
+static const float EMPTY_MAX = -std::numeric_limits<float>::infinity();
+
+/**
+ * Returns the slab containing height y
+ *
+ * Heights outside of the bounding box are clamped to the nearest slab. As
+ * this function is monotonic in y, an edge spanning heights [a,b] overlaps
+ * every slab from slabIndex(a) to slabIndex(b).
+ *
+ * @param bottom    The bottom of the bounding box
+ * @param density   The number of slabs per unit of height
+ * @param slabs     The number of slabs
+ * @param y         The height to locate
+ *
+ * @return the slab containing height y
+ */
+static Uint32 slabIndex(float bottom, float density, Uint32 slabs, float y) {
+    float pos = (y-bottom)*density;
+    if (pos <= 0) {
+        return 0;
+    }
+    return std::min((Uint32)pos,slabs-1);
+}
+
+/**
+ * Returns a bit mask of the four boxes containing the point
+ *
+ * Bit i is set if box i contains the point. Boxes are closed, so points on
+ * the edge are contained.
+ *
+ * @param minx  The minimum x-coordinates of the boxes
+ * @param miny  The minimum y-coordinates of the boxes
+ * @param maxx  The maximum x-coordinates of the boxes
+ * @param maxy  The maximum y-coordinates of the boxes
+ * @param x     The x-coordinate of the point
+ * @param y     The y-coordinate of the point
+ *
+ * @return a bit mask of the four boxes containing the point
+ */
+static int boxMask(const float* minx, const float* miny, const float* maxx, const float* maxy, float x, float y) {
+#if defined CU_MATH_VECTOR_SSE
+    __m128 px = _mm_set1_ps(x);
+    __m128 py = _mm_set1_ps(y);
+    __m128 inx = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minx),px),_mm_cmple_ps(px,_mm_loadu_ps(maxx)));
+    __m128 iny = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(miny),py),_mm_cmple_ps(py,_mm_loadu_ps(maxy)));
+    return _mm_movemask_ps(_mm_and_ps(inx,iny));
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4_t px = vdupq_n_f32(x);
+    float32x4_t py = vdupq_n_f32(y);
+    uint32x4_t inx = vandq_u32(vcleq_f32(vld1q_f32(minx),px),vcleq_f32(px,vld1q_f32(maxx)));
+    uint32x4_t iny = vandq_u32(vcleq_f32(vld1q_f32(miny),py),vcleq_f32(py,vld1q_f32(maxy)));
+    uint32x4_t in  = vandq_u32(inx,iny);
+    return ((vgetq_lane_u32(in,0) & 1) | (vgetq_lane_u32(in,1) & 2) |
+            (vgetq_lane_u32(in,2) & 4) | (vgetq_lane_u32(in,3) & 8));
+#else
+    int mask = 0;
+    for(int ii = 0; ii < 4; ii++) {
+        if (minx[ii] <= x && x <= maxx[ii] && miny[ii] <= y && y <= maxy[ii]) {
+            mask |= 1 << ii;
+        }
+    }
+    return mask;
+#endif
+}
+
+#pragma mark -
+#pragma mark Initialization
+/**
+ * Adds the given polygon to this tester, returning its index.
+ *
+ * Indices are assigned in the order that polygons are added, starting at
+ * 0. The edges are copied, and the tester does not retain any references
+ * to the original data. A polygon with POINTS geometry has no edges,
+ * and so never contains a point.
+ *
+ * @param poly  The polygon to test against
+ *
+ * @return the index of the polygon in this tester
+ */
+Uint32 PolyHitTester::add(const Poly2& poly) {
+    const std::vector<Vec2>& verts = poly.vertices();
+    const std::vector<Uint32>& indices = poly.indices();
+
+    Shape shape;
+    shape.start = (Uint32)_ymin.size();
+    shape.slab  = (Uint32)_slabs.size();
+    shape.slabs = 0;
+    shape.bottom  = 0;
+    shape.density = 0;
+
+    switch (poly.getGeometry()) {
+        case Geometry::POINTS:
+            break;
+        case Geometry::IMPLICIT:
+            for(size_t ii = 0; ii < verts.size(); ii++) {
+                pushEdge(verts[ii],verts[(ii+1) % verts.size()]);
+            }
+            break;
+        case Geometry::PATH:
+            for(size_t ii = 0; ii+1 < indices.size(); ii += 2) {
+                pushEdge(verts[indices[ii]],verts[indices[ii+1]]);
+            }
+            break;
+        case Geometry::SOLID:
+        {
+            // An edge shared by two triangles crosses twice and cancels out
+            std::vector<Uint64> edges;
+            edges.reserve(indices.size());
+            for(size_t ii = 0; ii+2 < indices.size(); ii += 3) {
+                for(int jj = 0; jj < 3; jj++) {
+                    Uint64 a = indices[ii+jj];
+                    Uint64 b = indices[ii+(jj+1) % 3];
+                    edges.push_back(a < b ? (a << 32 | b) : (b << 32 | a));
+                }
+            }
+            std::sort(edges.begin(),edges.end());
+            for(size_t ii = 0; ii < edges.size(); ) {
+                size_t jj = ii+1;
+                while (jj < edges.size() && edges[jj] == edges[ii]) {
+                    jj++;
+                }
+                if ((jj-ii) & 1) {
+                    pushEdge(verts[(Uint32)(edges[ii] >> 32)],verts[(Uint32)(edges[ii] & 0xffffffff)]);
+                }
+                ii = jj;
+            }
+        }
+            break;
+    }
+    Uint32 edges = (Uint32)_ymin.size()-shape.start;
+    padEdges();
+    shape.count = (Uint32)_ymin.size()-shape.start;
+
+    float minx = EMPTY_MIN, miny = EMPTY_MIN;
+    float maxx = EMPTY_MAX, maxy = EMPTY_MAX;
+    if (poly.getGeometry() != Geometry::POINTS) {
+        for(auto it = verts.begin(); it != verts.end(); ++it) {
+            minx = std::min(minx,it->x);
+            miny = std::min(miny,it->y);
+            maxx = std::max(maxx,it->x);
+            maxy = std::max(maxy,it->y);
+        }
+    }
+
+    if (_threshold > 0 && edges >= _threshold && miny < maxy) {
+        shape.bottom = miny;
+        makeSlabs(shape,maxy);
+    }
+
+    Uint32 index = (Uint32)_shapes.size();
+    _shapes.push_back(shape);
+
+    // Keep the boxes padded with empty boxes for the vector loads
+    size_t padded = (index+4) & ~(size_t)3;
+    _minx.resize(padded,EMPTY_MIN);
+    _miny.resize(padded,EMPTY_MIN);
+    _maxx.resize(padded,EMPTY_MAX);
+    _maxy.resize(padded,EMPTY_MAX);
+    _minx[index] = minx;
+    _miny[index] = miny;
+    _maxx[index] = maxx;
+    _maxy[index] = maxy;
+    return index;
+}
+
+/**
+ * Removes all polygons from this tester.
+ *
+ * The grid threshold is unchanged.
+ */
+void PolyHitTester::clear() {
+    _ymin.clear();
+    _ymax.clear();
+    _x1.clear();
+    _y1.clear();
+    _slope.clear();
+    _shapes.clear();
+    _slabs.clear();
+    _minx.clear();
+    _miny.clear();
+    _maxx.clear();
+    _maxy.clear();
+}
+
+/**
+ * Appends an edge to the edge table.
+ *
+ * Horizontal edges are skipped, as they can never cross a ray.
+ *
+ * @param v1    The first edge vertex
+ * @param v2    The second edge vertex
+ */
+void PolyHitTester::pushEdge(const Vec2 v1, const Vec2 v2) {
+    if (v1.y == v2.y) {
+        return;
+    }
+    // Same arithmetic as Poly2::containsCrossing, so the answers agree
+    _ymin.push_back(std::min(v1.y,v2.y));
+    _ymax.push_back(std::max(v1.y,v2.y));
+    _x1.push_back(v1.x);
+    _y1.push_back(v1.y);
+    _slope.push_back((v2.x - v1.x) / (v2.y - v1.y));
+}
+
+/**
+ * Pads the edge table with empty edges to a multiple of 4.
+ *
+ * Empty edges have an empty y-range, and so never cross a ray.
+ */
+void PolyHitTester::padEdges() {
+    while (_ymin.size() & 3) {
+        _ymin.push_back(EMPTY_MIN);
+        _ymax.push_back(EMPTY_MAX);
+        _x1.push_back(0);
+        _y1.push_back(0);
+        _slope.push_back(0);
+    }
+}
+
+/**
+ * Splits the edges of the given shape into slabs.
+ *
+ * The slab edges are copies appended to the end of the edge table.
+ *
+ * @param shape The shape to split
+ * @param top   The top of the shape bounding box
+ */
+void PolyHitTester::makeSlabs(Shape& shape, float top) {
+    Uint32 slabs = std::max(std::min(shape.count/SLAB_EDGES,(Uint32)MAX_SLABS),(Uint32)1);
+    shape.slab = (Uint32)_slabs.size();
+    shape.slabs = slabs;
+    shape.density = slabs/(top-shape.bottom);
+
+    std::vector<std::vector<Uint32>> buckets(slabs);
+    for(Uint32 ii = shape.start; ii < shape.start+shape.count; ii++) {
+        if (_ymin[ii] > _ymax[ii]) {
+            continue;
+        }
+        Uint32 first = slabIndex(shape.bottom,shape.density,slabs,_ymin[ii]);
+        Uint32 last  = slabIndex(shape.bottom,shape.density,slabs,_ymax[ii]);
+        for(Uint32 jj = first; jj <= last; jj++) {
+            buckets[jj].push_back(ii);
+        }
+    }
+
+    for(auto it = buckets.begin(); it != buckets.end(); ++it) {
+        Range range;
+        range.start = (Uint32)_ymin.size();
+        for(auto jt = it->begin(); jt != it->end(); ++jt) {
+            float ymin = _ymin[*jt], ymax = _ymax[*jt];
+            float x1 = _x1[*jt], y1 = _y1[*jt], slope = _slope[*jt];
+            _ymin.push_back(ymin);
+            _ymax.push_back(ymax);
+            _x1.push_back(x1);
+            _y1.push_back(y1);
+            _slope.push_back(slope);
+        }
+        padEdges();
+        range.count = (Uint32)_ymin.size()-range.start;
+        _slabs.push_back(range);
+    }
+}
+
+#pragma mark -
+#pragma mark Queries
+/**
+ * Returns true if the given polygon contains the point.
+ *
+ * @param index The polygon index
+ * @param point The point to test
+ *
+ * @return true if the given polygon contains the point.
+ */
+bool PolyHitTester::contains(Uint32 index, const Vec2 point) const {
+    CUAssertLog(index < _shapes.size(), "Polygon index %d is out of bounds", index);
+    if (point.x < _minx[index] || point.x > _maxx[index] ||
+        point.y < _miny[index] || point.y > _maxy[index]) {
+        return false;
+    }
+    return crosses(getEdges(_shapes[index],point.y),point.x,point.y);
+}
+
+/**
+ * Tests each point for containment in the given polygon.
+ *
+ * The results array must have room for count values. Each value is 1 if
+ * the point is in the polygon and 0 otherwise.
+ *
+ * @param index     The polygon index
+ * @param points    The points to test
+ * @param count     The number of points
+ * @param results   The array to store the results
+ *
+ * @return the number of points in the polygon
+ */
+size_t PolyHitTester::contains(Uint32 index, const Vec2* points, size_t count, Uint8* results) const {
+    CUAssertLog(index < _shapes.size(), "Polygon index %d is out of bounds", index);
+    const Shape& shape = _shapes[index];
+    if (shape.slabs > 0) {
+        // Points in different slabs share no edges, so go one at a time
+        for(size_t ii = 0; ii < count; ii++) {
+            results[ii] = contains(index,points[ii]) ? 1 : 0;
+        }
+    } else {
+        Range range;
+        range.start = shape.start;
+        range.count = shape.count;
+        size_t ii = 0;
+        for(; ii+4 <= count; ii += 4) {
+            crosses4(range,points+ii,results+ii);
+        }
+        if (ii < count) {
+            Vec2  rest[4];
+            Uint8 temp[4];
+            for(size_t jj = 0; jj < 4; jj++) {
+                rest[jj] = points[std::min(ii+jj,count-1)];
+            }
+            crosses4(range,rest,temp);
+            for(size_t jj = 0; ii+jj < count; jj++) {
+                results[ii+jj] = temp[jj];
+            }
+        }
+    }
+
+    size_t total = 0;
+    for(size_t ii = 0; ii < count; ii++) {
+        total += results[ii];
+    }
+    return total;
+}
+
+/**
+ * Returns the index of the first polygon containing the point.
+ *
+ * If no polygon contains the point, this method returns -1.
+ *
+ * @param point The point to test
+ *
+ * @return the index of the first polygon containing the point.
+ */
+Sint32 PolyHitTester::find(const Vec2 point) const {
+    for(size_t ii = 0; ii < _minx.size(); ii += 4) {
+        int mask = boxMask(_minx.data()+ii,_miny.data()+ii,_maxx.data()+ii,_maxy.data()+ii,point.x,point.y);
+        for(size_t jj = 0; mask; jj++, mask >>= 1) {
+            if ((mask & 1) && crosses(getEdges(_shapes[ii+jj],point.y),point.x,point.y)) {
+                return (Sint32)(ii+jj);
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * Appends the index of every polygon containing the point.
+ *
+ * The indices are appended in increasing order. The vector is not
+ * cleared first.
+ *
+ * @param point     The point to test
+ * @param indices   The vector to store the indices
+ *
+ * @return the number of polygons containing the point
+ */
+size_t PolyHitTester::findAll(const Vec2 point, std::vector<Uint32>& indices) const {
+    size_t total = 0;
+    for(size_t ii = 0; ii < _minx.size(); ii += 4) {
+        int mask = boxMask(_minx.data()+ii,_miny.data()+ii,_maxx.data()+ii,_maxy.data()+ii,point.x,point.y);
+        for(size_t jj = 0; mask; jj++, mask >>= 1) {
+            if ((mask & 1) && crosses(getEdges(_shapes[ii+jj],point.y),point.x,point.y)) {
+                indices.push_back((Uint32)(ii+jj));
+                total++;
+            }
+        }
+    }
+    return total;
+}
+
+#pragma mark -
+#pragma mark Kernels
+/**
+ * Returns the edges of the shape that can cross a ray at height y.
+ *
+ * @param shape The shape to test
+ * @param y     The ray height
+ *
+ * @return the edges of the shape that can cross a ray at height y.
+ */
+PolyHitTester::Range PolyHitTester::getEdges(const Shape& shape, float y) const {
+    if (shape.slabs == 0) {
+        Range range;
+        range.start = shape.start;
+        range.count = shape.count;
+        return range;
+    }
+    return _slabs[shape.slab+slabIndex(shape.bottom,shape.density,shape.slabs,y)];
+}
+
+/**
+ * Returns true if the point crosses an odd number of edges in the range.
+ *
+ * @param range The edges to test
+ * @param x     The x-coordinate of the point
+ * @param y     The y-coordinate of the point
+ *
+ * @return true if the point crosses an odd number of edges in the range.
+ */
+bool PolyHitTester::crosses(const Range& range, float x, float y) const {
+    const float* ymin  = _ymin.data()+range.start;
+    const float* ymax  = _ymax.data()+range.start;
+    const float* x1    = _x1.data()+range.start;
+    const float* y1    = _y1.data()+range.start;
+    const float* slope = _slope.data()+range.start;
+#if defined CU_MATH_VECTOR_SSE
+    __m128 px = _mm_set1_ps(x);
+    __m128 py = _mm_set1_ps(y);
+    __m128 odd = _mm_setzero_ps();
+    for(Uint32 ii = 0; ii < range.count; ii += 4) {
+        __m128 span = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(ymin+ii),py),_mm_cmplt_ps(py,_mm_loadu_ps(ymax+ii)));
+        __m128 cross = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(slope+ii),_mm_sub_ps(py,_mm_loadu_ps(y1+ii))),_mm_loadu_ps(x1+ii));
+        odd = _mm_xor_ps(odd,_mm_and_ps(span,_mm_cmplt_ps(px,cross)));
+    }
+    int mask = _mm_movemask_ps(odd);
+    return ((mask ^ (mask >> 1) ^ (mask >> 2) ^ (mask >> 3)) & 1) == 1;
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4_t px = vdupq_n_f32(x);
+    float32x4_t py = vdupq_n_f32(y);
+    uint32x4_t odd = vdupq_n_u32(0);
+    for(Uint32 ii = 0; ii < range.count; ii += 4) {
+        uint32x4_t span = vandq_u32(vcleq_f32(vld1q_f32(ymin+ii),py),vcltq_f32(py,vld1q_f32(ymax+ii)));
+        float32x4_t cross = vaddq_f32(vmulq_f32(vld1q_f32(slope+ii),vsubq_f32(py,vld1q_f32(y1+ii))),vld1q_f32(x1+ii));
+        odd = veorq_u32(odd,vandq_u32(span,vcltq_f32(px,cross)));
+    }
+    return (vgetq_lane_u32(odd,0) ^ vgetq_lane_u32(odd,1) ^ vgetq_lane_u32(odd,2) ^ vgetq_lane_u32(odd,3)) != 0;
+#else
+    bool odd = false;
+    for(Uint32 ii = 0; ii < range.count; ii++) {
+        if (ymin[ii] <= y && y < ymax[ii] && x < slope[ii] * (y - y1[ii]) + x1[ii]) {
+            odd = !odd;
+        }
+    }
+    return odd;
+#endif
+}
+
+/**
+ * Tests four points against all edges in the range.
+ *
+ * The results are stored in the first four values of results.
+ *
+ * @param range     The edges to test
+ * @param points    The four points to test
+ * @param results   The array to store the results
+ */
+void PolyHitTester::crosses4(const Range& range, const Vec2* points, Uint8* results) const {
+    const float* ymin  = _ymin.data()+range.start;
+    const float* ymax  = _ymax.data()+range.start;
+    const float* x1    = _x1.data()+range.start;
+    const float* y1    = _y1.data()+range.start;
+    const float* slope = _slope.data()+range.start;
+    const float* data  = reinterpret_cast<const float*>(points);
+#if defined CU_MATH_VECTOR_SSE
+    __m128 lo = _mm_loadu_ps(data);
+    __m128 hi = _mm_loadu_ps(data+4);
+    __m128 px = _mm_shuffle_ps(lo,hi,_MM_SHUFFLE(2,0,2,0));
+    __m128 py = _mm_shuffle_ps(lo,hi,_MM_SHUFFLE(3,1,3,1));
+    __m128 odd = _mm_setzero_ps();
+    for(Uint32 ii = 0; ii < range.count; ii++) {
+        __m128 span = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(ymin[ii]),py),_mm_cmplt_ps(py,_mm_set1_ps(ymax[ii])));
+        __m128 cross = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(slope[ii]),_mm_sub_ps(py,_mm_set1_ps(y1[ii]))),_mm_set1_ps(x1[ii]));
+        odd = _mm_xor_ps(odd,_mm_and_ps(span,_mm_cmplt_ps(px,cross)));
+    }
+    int mask = _mm_movemask_ps(odd);
+    for(int jj = 0; jj < 4; jj++) {
+        results[jj] = (mask >> jj) & 1;
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4x2_t pts = vld2q_f32(data);
+    float32x4_t px = pts.val[0];
+    float32x4_t py = pts.val[1];
+    uint32x4_t odd = vdupq_n_u32(0);
+    for(Uint32 ii = 0; ii < range.count; ii++) {
+        uint32x4_t span = vandq_u32(vcleq_f32(vdupq_n_f32(ymin[ii]),py),vcltq_f32(py,vdupq_n_f32(ymax[ii])));
+        float32x4_t cross = vaddq_f32(vmulq_f32(vdupq_n_f32(slope[ii]),vsubq_f32(py,vdupq_n_f32(y1[ii]))),vdupq_n_f32(x1[ii]));
+        odd = veorq_u32(odd,vandq_u32(span,vcltq_f32(px,cross)));
+    }
+    results[0] = vgetq_lane_u32(odd,0) & 1;
+    results[1] = vgetq_lane_u32(odd,1) & 1;
+    results[2] = vgetq_lane_u32(odd,2) & 1;
+    results[3] = vgetq_lane_u32(odd,3) & 1;
+#else
+    for(int jj = 0; jj < 4; jj++) {
+        float x = data[2*jj];
+        float y = data[2*jj+1];
+        bool odd = false;
+        for(Uint32 ii = 0; ii < range.count; ii++) {
+            if (ymin[ii] <= y && y < ymax[ii] && x < slope[ii] * (y - y1[ii]) + x1[ii]) {
+                odd = !odd;
+            }
+        }
+        results[jj] = odd ? 1 : 0;
+    }
+#endif
+}
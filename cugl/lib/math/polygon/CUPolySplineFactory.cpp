@@ -188,7 +188,7 @@ Poly2 PolySplineFactory::getPath() const {
         poly._indices.pop_back();
         poly._indices.push_back(0);
     } else {
-        poly._vertices.push_back(points->at(size));
+        poly._vertices.push_back(points->at(size-1));
     }
     
     poly.setGeometry(Geometry::PATH);
@@ -239,7 +239,7 @@ Poly2* PolySplineFactory::getPath(Poly2* buffer) const {
         buffer->_indices.pop_back();
         buffer->_indices.push_back(offs);
     } else {
-        buffer->_vertices.push_back(points->at(size));
+        buffer->_vertices.push_back(points->at(size-1));
     }
 
     buffer->setGeometry(Geometry::PATH);
@@ -0,0 +1,386 @@
+//
+//  CUSplineFlattener.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a lightweight alternative to PolySplineFactory for turning a
+//  spline into a polyline.  Instead of recursive subdivision, each bezier is
+//  sampled uniformly with forward differencing, and the number of samples is
+//  bounded in advance by Wang's formula.  All points are written into buffers
+//  that are reused between calculations, and the result is cached until the
+//  spline changes.  The flattened polyline also supports nearest point queries
+//  through a bounding volume hierarchy over its segments.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/math/polygon/CUSplineFlattener.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+/** The most steps for a single bezier (matches the PolySplineFactory depth) */
+#define MAX_STEPS       256
+/** The most segments in a leaf of the segment hierarchy */
+#define LEAF_SEGMENTS   4
+/** The deepest possible search stack (the hierarchy is balanced) */
+#define STACK_DEPTH     64
+
+using namespace cugl;
+
+/**
+ * Returns the squared distance from the point to the node bounds
+ *
+ * @param minx  The minimum x-coordinate of the bounds
+ * @param miny  The minimum y-coordinate of the bounds
+ * @param maxx  The maximum x-coordinate of the bounds
+ * @param maxy  The maximum y-coordinate of the bounds
+ * @param point The point to measure
+ *
+ * @return the squared distance from the point to the node bounds
+ */
+static float boxDistance(float minx, float miny, float maxx, float maxy, const Vec2 point) {
+    float dx = std::max(std::max(minx-point.x,point.x-maxx),0.0f);
+    float dy = std::max(std::max(miny-point.y,point.y-maxy),0.0f);
+    return dx*dx+dy*dy;
+}
+
+#pragma mark -
+#pragma mark Calculation
+/**
+ * Returns the number of steps needed to flatten a single bezier.
+ *
+ * This is Wang's formula for cubic beziers. If the bezier is divided into
+ * this many equal parameter steps, every point on the curve is within
+ * tolerance of the polyline. The result is at least 1.
+ *
+ * @param p         The four control points of the bezier
+ * @param tolerance The maximum distance from the polyline to the curve
+ *
+ * @return the number of steps needed to flatten a single bezier.
+ */
+Uint32 SplineFlattener::getSteps(const Vec2* p, float tolerance) {
+    // The second differences bound the second derivative of the curve
+    Vec2 d1 = p[0] - p[1]*2 + p[2];
+    Vec2 d2 = p[1] - p[2]*2 + p[3];
+    float m = sqrtf(std::max(d1.lengthSquared(),d2.lengthSquared()));
+    if (m == 0) {
+        return 1;
+    } else if (tolerance <= 0) {
+        return MAX_STEPS;
+    }
+    // n = sqrt(d(d-1)/8 * M / tolerance) for degree d = 3
+    float n = ceilf(sqrtf(0.75f*m/tolerance));
+    return (Uint32)std::min(std::max(n,1.0f),(float)MAX_STEPS);
+}
+
+/**
+ * Flattens the current spline into a polyline.
+ *
+ * Each bezier is sampled at the number of steps given by {@link getSteps}.
+ * If neither the spline nor the tolerance have changed since the last
+ * call, this method does nothing and returns false.
+ *
+ * The calculation uses a reference to the spline; it does not copy it.
+ * Hence this method is not thread-safe.
+ *
+ * @param tolerance The maximum distance from the polyline to the curve
+ *
+ * @return true if the polyline was recomputed
+ */
+bool SplineFlattener::calculate(float tolerance) {
+    if (!_spline) {
+        reset();
+        return false;
+    } else if (isCalculated() && _tolerance == tolerance) {
+        return false;
+    }
+
+    const std::vector<Vec2>& ctrl = _spline->_points;
+    int size = _spline->_size;
+    _points.clear();
+    _params.clear();
+    _nodes.clear();
+    if (ctrl.empty()) {
+        _version = _spline->getVersion();
+        _tolerance = tolerance;
+        _closed = _spline->_closed;
+        _calculated = true;
+        return true;
+    }
+
+    // Size the buffers exactly, so they are written without reallocation
+    _steps.resize(size);
+    size_t total = 1;
+    for(int ii = 0; ii < size; ii++) {
+        _steps[ii] = getSteps(&ctrl[3*ii],tolerance);
+        total += _steps[ii];
+    }
+    _points.resize(total);
+    _params.resize(total);
+
+    Vec2*  out = _points.data();
+    float* par = _params.data();
+    for(int ii = 0; ii < size; ii++) {
+        const Vec2* p = &ctrl[3*ii];
+        Uint32 n = _steps[ii];
+        *out++ = p[0];
+        *par++ = (float)ii;
+        if (n == 1) {
+            continue;
+        }
+
+        // Power basis coefficients, in double to limit the drift
+        double h  = 1.0/n;
+        double ax = p[3].x-p[0].x+3.0*(p[1].x-p[2].x);
+        double ay = p[3].y-p[0].y+3.0*(p[1].y-p[2].y);
+        double bx = 3.0*(p[0].x-2.0*p[1].x+p[2].x);
+        double by = 3.0*(p[0].y-2.0*p[1].y+p[2].y);
+        double cx = 3.0*(p[1].x-p[0].x);
+        double cy = 3.0*(p[1].y-p[0].y);
+
+        // Forward differences
+        double fx = p[0].x, fy = p[0].y;
+        double dfx = ((ax*h+bx)*h+cx)*h;
+        double dfy = ((ay*h+by)*h+cy)*h;
+        double ddfx = (6.0*ax*h+2.0*bx)*h*h;
+        double ddfy = (6.0*ay*h+2.0*by)*h*h;
+        double dddfx = 6.0*ax*h*h*h;
+        double dddfy = 6.0*ay*h*h*h;
+        for(Uint32 jj = 1; jj < n; jj++) {
+            fx += dfx;
+            fy += dfy;
+            dfx += ddfx;
+            dfy += ddfy;
+            ddfx += dddfx;
+            ddfy += dddfy;
+            out->x = (float)fx;
+            out->y = (float)fy;
+            out++;
+            *par++ = (float)(ii+jj*h);
+        }
+    }
+    *out = ctrl[3*size];
+    *par = (float)size;
+
+    if (total > 1) {
+        _nodes.reserve(2*(total/LEAF_SEGMENTS+1));
+        buildNodes(0,(Uint32)(total-1));
+    }
+
+    _version = _spline->getVersion();
+    _tolerance = tolerance;
+    _closed = _spline->_closed;
+    _calculated = true;
+    return true;
+}
+
+/**
+ * Builds the segment hierarchy for the given range of segments.
+ *
+ * The nodes are stored in depth-first order, so the left child of a node
+ * immediately follows it.
+ *
+ * @param start The first segment
+ * @param count The number of segments
+ *
+ * @return the index of the new node
+ */
+Uint32 SplineFlattener::buildNodes(Uint32 start, Uint32 count) {
+    Uint32 index = (Uint32)_nodes.size();
+    _nodes.push_back(Node());
+
+    Node node;
+    if (count <= LEAF_SEGMENTS) {
+        node.index = start;
+        node.count = count;
+        node.minx = node.maxx = _points[start].x;
+        node.miny = node.maxy = _points[start].y;
+        for(Uint32 ii = start+1; ii <= start+count; ii++) {
+            node.minx = std::min(node.minx,_points[ii].x);
+            node.miny = std::min(node.miny,_points[ii].y);
+            node.maxx = std::max(node.maxx,_points[ii].x);
+            node.maxy = std::max(node.maxy,_points[ii].y);
+        }
+    } else {
+        // Consecutive segments are close together, so halves make good boxes
+        Uint32 half = count/2;
+        Uint32 left  = buildNodes(start,half);
+        Uint32 right = buildNodes(start+half,count-half);
+        node.index = right;
+        node.count = 0;
+        node.minx = std::min(_nodes[left].minx,_nodes[right].minx);
+        node.miny = std::min(_nodes[left].miny,_nodes[right].miny);
+        node.maxx = std::max(_nodes[left].maxx,_nodes[right].maxx);
+        node.maxy = std::max(_nodes[left].maxy,_nodes[right].maxy);
+    }
+    _nodes[index] = node;
+    return index;
+}
+
+#pragma mark -
+#pragma mark Materialization
+/**
+ * Returns a new polygon approximating this spline.
+ *
+ * The Poly2 indices will define a path traversing the vertices of the
+ * polygon, exactly as {@link PolySplineFactory#getPath}. The indices
+ * will define a closed path if the spline is itself closed, and an
+ * open path otherwise.
+ *
+ * @return a new polygon approximating this spline.
+ */
+Poly2 SplineFlattener::getPath() const {
+    Poly2 poly;
+    getPath(&poly);
+    return poly;
+}
+
+/**
+ * Stores vertex information approximating this spline in the buffer.
+ *
+ * The Poly2 indices will define a path traversing the vertices of the
+ * polygon, exactly as {@link PolySplineFactory#getPath}.
+ *
+ * The vertices (and indices) will be appended to the the Poly2 if it is
+ * not empty. You should clear the Poly2 first if you do not want to
+ * preserve the original data.
+ *
+ * @param buffer    The buffer to store the vertex data
+ *
+ * @return a reference to the buffer for chaining.
+ */
+Poly2* SplineFlattener::getPath(Poly2* buffer) const {
+    CUAssertLog(buffer, "Destination buffer is null");
+    CUAssertLog(buffer->getGeometry() == Geometry::PATH || buffer->getGeometry() == Geometry::IMPLICIT,
+                "Buffer geometry is incompatible with this result.");
+    if (_points.empty()) {
+        return buffer;
+    }
+
+    std::vector<Vec2>& vertices = buffer->vertices();
+    std::vector<Uint32>& indices = buffer->indices();
+    Uint32 offs = (Uint32)vertices.size();
+    Uint32 count = (Uint32)_points.size();
+    if (_closed && count > 1) {
+        count--;
+    }
+
+    vertices.insert(vertices.end(),_points.begin(),_points.begin()+count);
+    indices.reserve(indices.size()+2*count);
+    for(Uint32 ii = 0; ii+1 < count; ii++) {
+        indices.push_back(offs+ii);
+        indices.push_back(offs+ii+1);
+    }
+    if (_closed && count > 1) {
+        indices.push_back(offs+count-1);
+        indices.push_back(offs);
+    }
+
+    buffer->setGeometry(Geometry::PATH);
+    return buffer;
+}
+
+#pragma mark -
+#pragma mark Nearest Point
+/**
+ * Returns the nearest point on the polyline to the given point.
+ *
+ * The result is within the calculation tolerance of the nearest point on
+ * the spline. If param is not null, it stores the spline parameter of the
+ * result, interpolated from the vertex parameters.
+ *
+ * The query uses the segment hierarchy, so it is logarithmic in the size
+ * of the polyline for most inputs.
+ *
+ * @param point The point to project
+ * @param param Pointer to store the spline parameter (may be null)
+ *
+ * @return the nearest point on the polyline to the given point.
+ */
+Vec2 SplineFlattener::nearestPoint(const Vec2 point, float* param) const {
+    if (_points.empty()) {
+        if (param) {
+            *param = -1;
+        }
+        return Vec2::ZERO;
+    } else if (_nodes.empty()) {
+        if (param) {
+            *param = _params[0];
+        }
+        return _points[0];
+    }
+
+    float best = std::numeric_limits<float>::infinity();
+    Vec2  result = _points[0];
+    float resultParam = _params[0];
+
+    Uint32 stack[STACK_DEPTH];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = _nodes[stack[--top]];
+        if (boxDistance(node.minx,node.miny,node.maxx,node.maxy,point) >= best) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for(Uint32 ii = node.index; ii < node.index+node.count; ii++) {
+                Vec2 a = _points[ii];
+                Vec2 d = _points[ii+1]-a;
+                float len2 = d.lengthSquared();
+                float u = (len2 > 0 ? (point-a).dot(d)/len2 : 0);
+                u = std::min(std::max(u,0.0f),1.0f);
+                Vec2 q = a+d*u;
+                float dist = (point-q).lengthSquared();
+                if (dist < best) {
+                    best = dist;
+                    result = q;
+                    resultParam = _params[ii]+u*(_params[ii+1]-_params[ii]);
+                }
+            }
+        } else {
+            // Push the farther child first, so the nearer one is searched first
+            Uint32 left  = (Uint32)(&node-_nodes.data())+1;
+            Uint32 right = node.index;
+            const Node& ln = _nodes[left];
+            const Node& rn = _nodes[right];
+            float ld = boxDistance(ln.minx,ln.miny,ln.maxx,ln.maxy,point);
+            float rd = boxDistance(rn.minx,rn.miny,rn.maxx,rn.maxy,point);
+            CUAssertLog(top+2 <= STACK_DEPTH, "Segment hierarchy is too deep");
+            if (ld < rd) {
+                stack[top++] = right;
+                stack[top++] = left;
+            } else {
+                stack[top++] = left;
+                stack[top++] = right;
+            }
+        }
+    }
+
+    if (param) {
+        *param = resultParam;
+    }
+    return result;
+}
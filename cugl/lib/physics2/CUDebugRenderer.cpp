@@ -0,0 +1,377 @@
+//
+//  CUDebugRenderer.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an immediate-mode wireframe renderer for a Box2D world.
+//  The debug wireframes of an Obstacle are scene graph nodes, one per obstacle
+//  (and more for obstacles with several fixtures). That is fine for a handful
+//  of obstacles, but on large levels the cost of traversing and drawing all of
+//  those nodes dominates the frame. This class instead reads the fixtures
+//  straight from the world each frame, culls them with the broadphase, and
+//  gathers every outline into a single mesh that is drawn with one call to
+//  SpriteBatch::outline.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/physics2/CUDebugRenderer.h>
+#include <cugl/render/CUTexture.h>
+#include <cugl/util/CUDebug.h>
+#include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <Box2D/Dynamics/b2ContactManager.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Collision/Shapes/b2EdgeShape.h>
+#include <Box2D/Collision/Shapes/b2ChainShape.h>
+#include <Box2D/Collision/Shapes/b2PolygonShape.h>
+
+using namespace cugl;
+using namespace cugl::physics2;
+
+#pragma mark -
+#pragma mark Broadphase Query
+/**
+ * The broadphase query callback
+ *
+ * The broadphase tree calls this for every proxy whose fat bounding box
+ * overlaps the view. This is the same traversal as b2World::QueryAABB, but
+ * it keeps the proxy id, so that we can also draw the fat bounding box.
+ */
+struct DebugRenderer::Query {
+    /** The renderer to append to */
+    DebugRenderer* renderer;
+    /** The broadphase being queried */
+    const b2BroadPhase* broadphase;
+
+    /**
+     * Appends the given proxy to the renderer mesh
+     *
+     * @param proxyId   The broadphase proxy
+     *
+     * @return true to continue the query
+     */
+    bool QueryCallback(int32 proxyId) {
+        const b2FixtureProxy* proxy = (const b2FixtureProxy*)broadphase->GetUserData(proxyId);
+        renderer->_proxyCount++;
+        if (renderer->_shapes) {
+            renderer->pushFixture(proxy->fixture, proxy->childIndex);
+        }
+        if (renderer->_aabbs) {
+            renderer->pushBox(proxy->aabb, renderer->_aabbColor);
+        }
+        if (renderer->_proxies) {
+            renderer->pushBox(broadphase->GetFatAABB(proxyId), renderer->_proxyColor);
+        }
+        return true;
+    }
+};
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a new debug renderer with the default values.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+DebugRenderer::DebugRenderer() :
+_shapes(true),
+_aabbs(false),
+_contacts(false),
+_proxies(false),
+_staticColor(Color4::YELLOW),
+_kinematicColor(Color4::CYAN),
+_dynamicColor(Color4::GREEN),
+_sleepColor(Color4::GRAY),
+_sensorColor(Color4::RED),
+_aabbColor(Color4::MAGENTA),
+_proxyColor(Color4::BLUE),
+_contactColor(Color4::WHITE),
+_proxyCount(0),
+_contactCount(0) {
+    _mesh.command = GL_LINES;
+}
+
+/**
+ * Disposes all of the resources used by this renderer.
+ *
+ * A disposed renderer can be safely reinitialized.
+ */
+void DebugRenderer::dispose() {
+    _mesh.clear();
+    _mesh.command = GL_LINES;
+    _circle.clear();
+    _proxyCount = 0;
+    _contactCount = 0;
+}
+
+/**
+ * Initializes a new debug renderer with the given circle segments.
+ *
+ * Every circle fixture is drawn with this many segments.
+ *
+ * @param segments  The number of segments in a circle
+ *
+ * @return true if the renderer is initialized properly, false otherwise.
+ */
+bool DebugRenderer::init(Uint32 segments) {
+    CUAssertLog(_circle.empty(), "Debug renderer is already initialized");
+    CUAssertLog(segments >= 3, "A debug circle needs at least 3 segments");
+    _circle.reserve(segments);
+    for(Uint32 ii = 0; ii < segments; ii++) {
+        float angle = (2.0f*M_PI*ii)/segments;
+        _circle.push_back(Vec2(cosf(angle),sinf(angle)));
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Mesh Internals
+/**
+ * Appends a line segment to the mesh
+ *
+ * @param a     The start of the segment
+ * @param b     The end of the segment
+ * @param color The segment color
+ */
+void DebugRenderer::pushLine(const b2Vec2& a, const b2Vec2& b, const Vec4& color) {
+    GLuint offset = (GLuint)_mesh.vertices.size();
+    SpriteVertex2 vert;
+    vert.color = color;
+    vert.position.set(a.x,a.y);
+    _mesh.vertices.push_back(vert);
+    vert.position.set(b.x,b.y);
+    _mesh.vertices.push_back(vert);
+    _mesh.indices.push_back(offset);
+    _mesh.indices.push_back(offset+1);
+}
+
+/**
+ * Appends a closed polyline to the mesh
+ *
+ * @param verts The polyline vertices
+ * @param count The number of vertices
+ * @param xf    The transform to apply to the vertices
+ * @param color The polyline color
+ */
+void DebugRenderer::pushLoop(const b2Vec2* verts, int32 count, const b2Transform& xf, const Vec4& color) {
+    GLuint offset = (GLuint)_mesh.vertices.size();
+    SpriteVertex2 vert;
+    vert.color = color;
+    for(int32 ii = 0; ii < count; ii++) {
+        b2Vec2 pos = b2Mul(xf,verts[ii]);
+        vert.position.set(pos.x,pos.y);
+        _mesh.vertices.push_back(vert);
+        _mesh.indices.push_back(offset+ii);
+        _mesh.indices.push_back(offset+(ii+1)%count);
+    }
+}
+
+/**
+ * Appends an instance of the unit circle to the mesh
+ *
+ * The circle includes a radius segment along the body x-axis, so that
+ * the rotation of the body is visible.
+ *
+ * @param center    The circle center
+ * @param radius    The circle radius
+ * @param axis      The body x-axis
+ * @param color     The circle color
+ */
+void DebugRenderer::pushCircle(const b2Vec2& center, float radius, const b2Vec2& axis, const Vec4& color) {
+    GLuint offset = (GLuint)_mesh.vertices.size();
+    GLuint count  = (GLuint)_circle.size();
+    Vec2 origin(center.x,center.y);
+    SpriteVertex2 vert;
+    vert.color = color;
+    for(GLuint ii = 0; ii < count; ii++) {
+        vert.position = origin+_circle[ii]*radius;
+        _mesh.vertices.push_back(vert);
+        _mesh.indices.push_back(offset+ii);
+        _mesh.indices.push_back(offset+(ii+1)%count);
+    }
+    pushLine(center,center+radius*axis,color);
+}
+
+/**
+ * Appends a bounding box to the mesh
+ *
+ * @param box   The bounding box
+ * @param color The box color
+ */
+void DebugRenderer::pushBox(const b2AABB& box, const Vec4& color) {
+    b2Vec2 corners[4];
+    corners[0] = box.lowerBound;
+    corners[1].Set(box.upperBound.x,box.lowerBound.y);
+    corners[2] = box.upperBound;
+    corners[3].Set(box.lowerBound.x,box.upperBound.y);
+    pushLoop(corners,4,b2Transform(b2Vec2_zero,b2Rot(0)),color);
+}
+
+/**
+ * Appends the outline of a single fixture child to the mesh
+ *
+ * Chains are drawn one child edge at a time, since each child has its
+ * own proxy in the broadphase.
+ *
+ * @param fixture   The fixture to outline
+ * @param child     The child index
+ */
+void DebugRenderer::pushFixture(const b2Fixture* fixture, int32 child) {
+    const b2Body* body = fixture->GetBody();
+    const b2Transform& xf = body->GetTransform();
+
+    Color4 color;
+    if (fixture->IsSensor()) {
+        color = _sensorColor;
+    } else if (body->GetType() == b2_staticBody) {
+        color = _staticColor;
+    } else if (!body->IsAwake()) {
+        color = _sleepColor;
+    } else if (body->GetType() == b2_kinematicBody) {
+        color = _kinematicColor;
+    } else {
+        color = _dynamicColor;
+    }
+    Vec4 tint = color;
+
+    switch (fixture->GetType()) {
+        case b2Shape::e_circle:
+        {
+            const b2CircleShape* circle = (const b2CircleShape*)fixture->GetShape();
+            pushCircle(b2Mul(xf,circle->m_p),circle->m_radius,xf.q.GetXAxis(),tint);
+        }
+            break;
+        case b2Shape::e_polygon:
+        {
+            const b2PolygonShape* poly = (const b2PolygonShape*)fixture->GetShape();
+            pushLoop(poly->m_vertices,poly->m_count,xf,tint);
+        }
+            break;
+        case b2Shape::e_edge:
+        {
+            const b2EdgeShape* edge = (const b2EdgeShape*)fixture->GetShape();
+            pushLine(b2Mul(xf,edge->m_vertex1),b2Mul(xf,edge->m_vertex2),tint);
+        }
+            break;
+        case b2Shape::e_chain:
+        {
+            const b2ChainShape* chain = (const b2ChainShape*)fixture->GetShape();
+            b2EdgeShape edge;
+            chain->GetChildEdge(&edge,child);
+            pushLine(b2Mul(xf,edge.m_vertex1),b2Mul(xf,edge.m_vertex2),tint);
+        }
+            break;
+        default:
+            break;
+    }
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Rebuilds the wireframe mesh for the given world.
+ *
+ * Only the proxies whose fat bounding boxes overlap the bounds are drawn.
+ * The bounds are in physics coordinates, and are typically the camera
+ * view mapped into the world.
+ *
+ * @param world     The Box2D world
+ * @param bounds    The visible region in physics coordinates
+ */
+void DebugRenderer::update(const b2World* world, const Rect& bounds) {
+    _mesh.vertices.clear();
+    _mesh.indices.clear();
+    _proxyCount = 0;
+    _contactCount = 0;
+    if (world == nullptr) {
+        return;
+    }
+
+    b2AABB view;
+    view.lowerBound.Set(bounds.getMinX(),bounds.getMinY());
+    view.upperBound.Set(bounds.getMaxX(),bounds.getMaxY());
+
+    if (_shapes || _aabbs || _proxies) {
+        Query query;
+        query.renderer = this;
+        query.broadphase = &(world->GetContactManager().m_broadPhase);
+        query.broadphase->Query(&query,view);
+    }
+
+    if (_contacts) {
+        Vec4 tint = _contactColor;
+        for(const b2Contact* c = world->GetContactList(); c; c = c->GetNext()) {
+            int32 count = c->GetManifold()->pointCount;
+            if (count == 0 || !c->IsTouching()) {
+                continue;
+            }
+
+            b2WorldManifold manifold;
+            c->GetWorldManifold(&manifold);
+            for(int32 ii = 0; ii < count; ii++) {
+                const b2Vec2& p = manifold.points[ii];
+                if (p.x < view.lowerBound.x || p.x > view.upperBound.x ||
+                    p.y < view.lowerBound.y || p.y > view.upperBound.y) {
+                    continue;
+                }
+                b2Vec2 dx(DEBUG_CONTACT_SIZE,0);
+                b2Vec2 dy(0,DEBUG_CONTACT_SIZE);
+                pushLine(p-dx,p+dx,tint);
+                pushLine(p-dy,p+dy,tint);
+                pushLine(p,p+(2*DEBUG_CONTACT_SIZE)*manifold.normal,tint);
+                _contactCount++;
+            }
+        }
+    }
+}
+
+/**
+ * Draws the wireframe mesh with the given sprite batch.
+ *
+ * The mesh is drawn with a single outline call, using the blank texture.
+ * The sprite batch must be active (e.g. between calls to begin and end).
+ * This method changes the texture, color and gradient of the batch.
+ *
+ * @param batch     The sprite batch
+ * @param transform The transform from physics to world coordinates
+ */
+void DebugRenderer::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform) {
+    if (_mesh.indices.empty()) {
+        return;
+    }
+    batch->setTexture(Texture::getBlank());
+    batch->setGradient(nullptr);
+    batch->setColor(Color4::WHITE);
+    batch->outline(_mesh,transform);
+}
@@ -48,7 +48,12 @@
 #include <Box2D/Collision/b2Collision.h>
 #include <cugl/physics2/CUObstacleWorld.h>
 #include <cugl/physics2/CUObstacle.h>
+#include <cugl/physics2/CUComplexObstacle.h>
+#include <cugl/util/CUArena.h>
+#include <cugl/util/CUThreadPool.h>
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
 using namespace cugl;
 using namespace cugl::physics2;
@@ -154,6 +159,39 @@ public:
 };
 
 
+/**
+ * Returns a page of memory for the Box2D small object allocator.
+ *
+ * This function is the page source registered with the Box2D world when the
+ * physics world is backed by an arena.
+ *
+ * @param size      The size of the page in bytes
+ * @param context   The arena to allocate from
+ *
+ * @return a page of memory for the Box2D small object allocator.
+ */
+static void* arenaChunkAlloc(int32 size, void* context) {
+    return ((Arena*)context)->malloc(size);
+}
+
+/**
+ * Runs a Box2D parallel loop on a thread pool.
+ *
+ * This function is the parallel loop registered with the Box2D world when
+ * the physics world has a solver pool.
+ *
+ * @param task          The loop body
+ * @param taskContext   The state of the loop body
+ * @param count         The number of loop indices
+ * @param context       The thread pool to run on
+ */
+static void poolParallelFor(b2TaskFcn* task, void* taskContext, int32 count, void* context) {
+    ((ThreadPool*)context)->parallelFor(count, [=](int index, int worker) {
+        task(index,worker,taskContext);
+    });
+}
+
+
 #pragma mark -
 #pragma mark Constructors
 
@@ -164,6 +202,13 @@ public:
  */
 ObstacleWorld::ObstacleWorld() :
 _world(nullptr),
+_telemetry(false),
+_historyStart(0),
+_historyCapacity(DEFAULT_WORLD_HISTORY),
+_historySteps(0),
+_hotlistLimit(DEFAULT_WORLD_HOTLIST),
+_sleepAware(true),
+_repartition(true),
 _collide(false),
 _filters(false),
 _destroy(false) {
@@ -191,6 +236,8 @@ void ObstacleWorld::dispose() {
         delete _world;
         _world  = nullptr;
     }
+    _arena = nullptr;
+    _solverpool = nullptr;
     onBeginContact = nullptr;
     onEndContact   = nullptr;
     beforeSolve    = nullptr;
@@ -236,6 +283,12 @@ bool ObstacleWorld::init(const Rect bounds, const Vec2 gravity) {
     _gravity = gravity;
     _world = new b2World(b2Vec2(gravity.x,gravity.y));
     if (_world) {
+        if (_arena != nullptr) {
+            _world->SetBlockAllocatorSource(arenaChunkAlloc, _arena.get());
+        }
+        if (_solverpool != nullptr) {
+            _world->SetParallelSolver(poolParallelFor, _solverpool.get(), _solverpool->getThreadCount()+1);
+        }
         return true;
     }
     return false;
@@ -268,6 +321,7 @@ void ObstacleWorld::addObstacle(const std::shared_ptr<Obstacle>& obj) {
 //    CUAssertLog(inBounds(obj.get()), "Obstacle is not in bounds");
     _objects.push_back(obj);
     obj->activatePhysics(*_world);
+    _repartition = true;
 }
 
 /**
@@ -289,6 +343,7 @@ void ObstacleWorld::removeObstacle(Obstacle* obj) {
         if (it->get() == obj) {
             obj->deactivatePhysics(*_world);
             _objects.erase(it);
+            _repartition = true;
             return;
         }
     }
@@ -319,6 +374,7 @@ void ObstacleWorld::garbageCollect() {
             count++;
         }
     }
+    _repartition = _repartition || count != _objects.size();
     _objects.resize(count);
 }
 
@@ -334,6 +390,102 @@ void ObstacleWorld::clear() {
         obj->deactivatePhysics(*_world);
     }
     _objects.clear();
+    _hotlist.clear();
+    _repartition = true;
+    
+    // Drop every Box2D page at once
+    if (_arena != nullptr && _world != nullptr) {
+        _world->ClearBlockAllocator();
+        _arena->reset();
+    }
+}
+
+
+#pragma mark -
+#pragma mark Memory Management
+/**
+ * Sets the arena backing this world.
+ *
+ * When a world has an arena, the Box2D small object allocator (bodies,
+ * fixtures, contacts and joints) draws its pages from the arena instead
+ * of the heap. A call to {@link clear()} then releases all of that memory
+ * at once by resetting the arena, invalidating anything else that was
+ * allocated from it.  Hence the arena should be dedicated to the objects
+ * in this world.
+ *
+ * This method may only be called when the world is empty. Setting the
+ * arena to nullptr restores the default heap allocation.
+ *
+ * @param arena The arena backing this world
+ */
+void ObstacleWorld::setArena(const std::shared_ptr<Arena>& arena) {
+    CUAssertLog(_objects.empty(), "Attempt to change the arena of a non-empty world");
+    if (_world != nullptr) {
+        if (arena != nullptr) {
+            _world->SetBlockAllocatorSource(arenaChunkAlloc, arena.get());
+        } else {
+            _world->SetBlockAllocatorSource(NULL, NULL);
+        }
+    }
+    _arena = arena;
+}
+
+
+#pragma mark -
+#pragma mark Parallel Solver
+/**
+ * Sets the thread pool used to solve islands in parallel.
+ *
+ * An island is a group of obstacles that touch (or are joined) to each
+ * other. Islands do not interact during a step, so they can be solved at
+ * the same time.  With a solver pool, each step still finds the islands on
+ * the calling thread, but then spreads the joint-free islands across the
+ * pool (plus the calling thread).  Islands with joints are solved on the
+ * calling thread.
+ *
+ * The results are identical to the serial solver, regardless of the
+ * number of threads.  In particular, all collision callbacks are still
+ * invoked on the calling thread, in the same order.
+ *
+ * The pool should be dedicated to physics, as every step waits on its
+ * workers.  Setting the pool to nullptr restores the serial solver. This
+ * method may not be called during a step.
+ *
+ * @param pool  The thread pool used to solve islands in parallel
+ */
+void ObstacleWorld::setSolverPool(const std::shared_ptr<ThreadPool>& pool) {
+    if (_world != nullptr) {
+        if (pool != nullptr) {
+            _world->SetParallelSolver(poolParallelFor, pool.get(), pool->getThreadCount()+1);
+        } else {
+            _world->SetParallelSolver(NULL, NULL, 0);
+        }
+    }
+    _solverpool = pool;
+}
+
+
+#pragma mark -
+#pragma mark Broadphase
+/**
+ * Rebuilds the broadphase tree of the static obstacles in bulk.
+ *
+ * The broadphase keeps static obstacles in their own tree, so that only
+ * moving obstacles are tested against them.  That tree is normally built
+ * one obstacle at a time, and its shape depends on the insertion order.
+ * This method rebuilds it top down with a surface area heuristic, which
+ * gives a much tighter tree.  It should be called once every static
+ * obstacle in a level has been added.  Static obstacles added later are
+ * inserted incrementally as before.
+ *
+ * The quality of the tree is available from {@link getWorld()}, through
+ * GetStaticTreeHeight and GetStaticTreeQuality. This method may not be
+ * called during a step.
+ */
+void ObstacleWorld::rebuildStaticTree() {
+    if (_world != nullptr) {
+        _world->RebuildStaticTree();
+    }
 }
 
 
@@ -366,16 +518,29 @@ void ObstacleWorld::setGravity(const Vec2 gravity) {
  * physics.  The primary method is the step() method in world.  This implementation
  * works for all applications and should not need to be overwritten.
  *
+ * After the step, only the obstacles that changed are updated, unless
+ * this world is not sleep-aware (see {@link setSleepAware}).
+ *
  * @param delta Number of seconds since last animation frame
  */
 void ObstacleWorld::update(float dt) {
     // Turn the physics engine crank.
-    _world->Step((_lockstep ? _stepssize : dt),_itvelocity,_itposition);
+    float step = (_lockstep ? _stepssize : dt);
+    _world->Step(step,_itvelocity,_itposition);
     
-    // Post process all objects after physics (this updates graphics)
-    for(auto it = _objects.begin() ; it != _objects.end(); ++it) {
-        Obstacle* obj = it->get();
-        obj->update(dt);
+    // Post process objects after physics (this updates graphics)
+    if (_sleepAware) {
+        updateChanged(dt);
+    } else {
+        _world->ClearMovedBodies();
+        for(auto it = _objects.begin() ; it != _objects.end(); ++it) {
+            Obstacle* obj = it->get();
+            obj->update(dt);
+        }
+    }
+    
+    if (_telemetry) {
+        recordTelemetry(step);
     }
 }
 
@@ -396,6 +561,251 @@ bool ObstacleWorld::inBounds(Obstacle* obj) {
     return horiz && vert;
 }
 
+/**
+ * Rebuilds the static, kinematic and dynamic partitions.
+ *
+ * Compound obstacles, whose bodies do not map back to them, are kept
+ * in a partition of their own.
+ */
+void ObstacleWorld::partitionObstacles() {
+    _statics.clear();
+    _kinematics.clear();
+    _dynamics.clear();
+    _compounds.clear();
+    _positions.clear();
+    _bodytypes.resize(_objects.size());
+    for(size_t ii = 0; ii < _objects.size(); ii++) {
+        Obstacle* obj = _objects[ii].get();
+        _bodytypes[ii] = obj->getBodyType();
+        if (dynamic_cast<ComplexObstacle*>(obj) != nullptr) {
+            _compounds.push_back(ii);
+            continue;
+        }
+        
+        _positions[obj] = ii;
+        switch (_bodytypes[ii]) {
+            case b2_staticBody:
+                _statics.push_back(ii);
+                break;
+            case b2_kinematicBody:
+                _kinematics.push_back(ii);
+                break;
+            case b2_dynamicBody:
+                _dynamics.push_back(ii);
+                break;
+        }
+    }
+    _repartition = false;
+}
+
+/**
+ * Updates the obstacles that changed in the step just taken.
+ *
+ * An obstacle changed if Box2D reports its body as moved, or if its
+ * fixtures must be rebuilt. Compound obstacles are always updated.
+ *
+ * @param dt    Number of seconds since last animation frame
+ */
+void ObstacleWorld::updateChanged(float dt) {
+    if (_repartition) {
+        partitionObstacles();
+    }
+    
+    // The body user data is the obstacle
+    _changed.clear();
+    b2Body* const* moved = _world->GetMovedBodies();
+    int32 count = _world->GetMovedBodyCount();
+    for(int32 ii = 0; ii < count; ii++) {
+        if (moved[ii] == nullptr) {
+            continue;
+        }
+        auto it = _positions.find((Obstacle*)moved[ii]->GetUserData());
+        if (it != _positions.end()) {
+            _changed.push_back(it->second);
+            _repartition = _repartition || moved[ii]->GetType() != _bodytypes[it->second];
+        }
+    }
+    _world->ClearMovedBodies();
+    
+    // A resized static body does not move, so check its flag too
+    for(auto it = _statics.begin(); it != _statics.end(); ++it) {
+        if (_objects[*it]->isDirty()) {
+            _changed.push_back(*it);
+        }
+    }
+    for(auto it = _kinematics.begin(); it != _kinematics.end(); ++it) {
+        if (_objects[*it]->isDirty()) {
+            _changed.push_back(*it);
+        }
+    }
+    for(auto it = _dynamics.begin(); it != _dynamics.end(); ++it) {
+        if (_objects[*it]->isDirty()) {
+            _changed.push_back(*it);
+        }
+    }
+    _changed.insert(_changed.end(), _compounds.begin(), _compounds.end());
+    
+    // Update in the order the obstacles were added
+    std::sort(_changed.begin(), _changed.end());
+    _changed.erase(std::unique(_changed.begin(), _changed.end()), _changed.end());
+    for(auto it = _changed.begin(); it != _changed.end(); ++it) {
+        _objects[*it]->update(dt);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Telemetry
+/**
+ * Sets the maximum number of steps in the telemetry history.
+ *
+ * Once the history is full, each step replaces the oldest one. Changing
+ * the capacity erases the history.
+ *
+ * @param capacity  The maximum number of steps in the telemetry history
+ */
+void ObstacleWorld::setTelemetryCapacity(size_t capacity) {
+    CUAssertLog(capacity > 0, "Telemetry capacity must be positive");
+    _historyCapacity = capacity;
+    _history.clear();
+    _history.shrink_to_fit();
+    _historyStart = 0;
+}
+
+/**
+ * Returns the telemetry of a step in the history.
+ *
+ * The steps are ordered from oldest (0) to newest. The reference is only
+ * valid until the next step.
+ *
+ * @param index The position of the step in the history
+ *
+ * @return the telemetry of a step in the history.
+ */
+const PhysicsStats& ObstacleWorld::getTelemetry(size_t index) const {
+    CUAssertLog(index < _history.size(), "Telemetry index %zu out of bounds", index);
+    return _history[(_historyStart+index) % _history.size()];
+}
+
+/**
+ * Erases the telemetry history and the hot list.
+ */
+void ObstacleWorld::clearTelemetry() {
+    _history.clear();
+    _historyStart = 0;
+    _historySteps = 0;
+    _hotlist.clear();
+}
+
+/**
+ * Returns the telemetry history as comma separated values.
+ *
+ * The first line is a header naming the columns, which are the fields of
+ * {@link PhysicsStats} in order. Each step in the history is a line after
+ * that, from oldest to newest.
+ *
+ * @return the telemetry history as comma separated values.
+ */
+std::string ObstacleWorld::getTelemetryCSV() const {
+    std::stringstream ss;
+    ss << "index,dt,step,collide,solve,solveInit,solveVelocity,solvePosition,";
+    ss << "broadphase,solveTOI,awake,sleeping,static,contacts,touching,";
+    ss << "proxies,islands,toi\n";
+    for(size_t ii = 0; ii < _history.size(); ii++) {
+        const PhysicsStats& stats = getTelemetry(ii);
+        ss << stats.index << "," << stats.dt << ",";
+        ss << stats.stepTime << "," << stats.collideTime << ",";
+        ss << stats.solveTime << "," << stats.solveInitTime << ",";
+        ss << stats.solveVelocityTime << "," << stats.solvePositionTime << ",";
+        ss << stats.broadphaseTime << "," << stats.solveTOITime << ",";
+        ss << stats.awakeBodies << "," << stats.sleepingBodies << ",";
+        ss << stats.staticBodies << "," << stats.contacts << ",";
+        ss << stats.touchingContacts << "," << stats.proxies << ",";
+        ss << stats.islands << "," << stats.toiEvents << "\n";
+    }
+    return ss.str();
+}
+
+/**
+ * Records the telemetry of the step just taken.
+ *
+ * This method adds a step to the history, replacing the oldest one if
+ * the history is full, and ranks the obstacles for the hot list.
+ *
+ * @param dt    The length of the step in seconds
+ */
+void ObstacleWorld::recordTelemetry(float dt) {
+    const b2Profile& profile = _world->GetProfile();
+    PhysicsStats stats;
+    stats.index = _historySteps++;
+    stats.dt = dt;
+    stats.stepTime = profile.step;
+    stats.collideTime = profile.collide;
+    stats.solveTime = profile.solve;
+    stats.solveInitTime = profile.solveInit;
+    stats.solveVelocityTime = profile.solveVelocity;
+    stats.solvePositionTime = profile.solvePosition;
+    stats.broadphaseTime = profile.broadphase;
+    stats.solveTOITime = profile.solveTOI;
+    
+    stats.awakeBodies = 0;
+    stats.sleepingBodies = 0;
+    stats.staticBodies = 0;
+    for(b2Body* body = _world->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() == b2_staticBody) {
+            stats.staticBodies++;
+        } else if (body->IsAwake()) {
+            stats.awakeBodies++;
+        } else {
+            stats.sleepingBodies++;
+        }
+    }
+    
+    stats.contacts = _world->GetContactCount();
+    stats.touchingContacts = 0;
+    for(b2Contact* contact = _world->GetContactList(); contact; contact = contact->GetNext()) {
+        if (contact->IsTouching()) {
+            stats.touchingContacts++;
+        }
+    }
+    stats.proxies = _world->GetProxyCount();
+    stats.islands = _world->GetIslandCount();
+    stats.toiEvents = _world->GetTOICount();
+    
+    if (_history.size() < _historyCapacity) {
+        _history.push_back(stats);
+    } else {
+        _history[_historyStart] = stats;
+        _historyStart = (_historyStart+1) % _historyCapacity;
+    }
+    
+    // Rank the obstacles by touching contacts
+    _hotranks.clear();
+    for(size_t ii = 0; ii < _objects.size(); ii++) {
+        b2Body* body = _objects[ii]->getBody();
+        if (body == nullptr) {
+            continue;
+        }
+        int count = 0;
+        for(b2ContactEdge* edge = body->GetContactList(); edge; edge = edge->next) {
+            if (edge->contact->IsTouching()) {
+                count++;
+            }
+        }
+        if (count > 0) {
+            _hotranks.push_back(std::make_pair(-count,ii));
+        }
+    }
+    
+    size_t limit = std::min(_hotlistLimit,_hotranks.size());
+    std::partial_sort(_hotranks.begin(), _hotranks.begin()+limit, _hotranks.end());
+    _hotlist.resize(limit);
+    for(size_t ii = 0; ii < limit; ii++) {
+        _hotlist[ii].obstacle = _objects[_hotranks[ii].second];
+        _hotlist[ii].contacts = -_hotranks[ii].first;
+    }
+}
+
 #pragma mark -
 #pragma mark Callback Activation
 
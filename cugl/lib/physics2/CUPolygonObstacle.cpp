@@ -45,6 +45,7 @@
 //
 #include <Box2D/Collision/Shapes/b2PolygonShape.h>
 #include <cugl/physics2/CUPolygonObstacle.h>
+#include <cugl/util/CUArena.h>
 
 using namespace cugl::physics2;
 
@@ -85,14 +86,7 @@ bool PolygonObstacle::init(const Poly2& poly, const Vec2 anchor) {
  */
 PolygonObstacle::~PolygonObstacle() {
     CUAssertLog(_body == nullptr, "You must deactive physics before deleting an object");
-    if (_shapes != nullptr) {
-        delete[] _shapes;
-        _shapes = nullptr;
-    }
-    if (_geoms != nullptr) {
-        delete[] _geoms;
-        _geoms = nullptr;
-    }
+    releaseShapes();
 }
 
 
@@ -124,12 +118,17 @@ void PolygonObstacle::resize(const Size size) {
  */
 void PolygonObstacle::resetShapes() {
     int ntris =  (int)_polygon.indices().size() / 3;
-    if (_shapes != nullptr) {
+    if (_shapes != nullptr && _arena == nullptr) {
         delete[] _shapes;
     }
     
     Vec2 pos = getPosition();
-    _shapes = new b2PolygonShape[ntris];
+    if (_arena != nullptr) {
+        _shapes = _arena->allocArray<b2PolygonShape>(ntris);
+        _generation = _arena->getGeneration();
+    } else {
+        _shapes = new b2PolygonShape[ntris];
+    }
     b2Vec2 triangle[3];
     for(int ii = 0; ii < ntris; ii++) {
         for(int jj = 0; jj < 3; jj++) {
@@ -142,7 +141,7 @@ void PolygonObstacle::resetShapes() {
     }
     
     if (_geoms == nullptr) {
-        _geoms = new b2Fixture*[ntris];
+        _geoms = (_arena != nullptr ? _arena->allocArray<b2Fixture*>(ntris) : new b2Fixture*[ntris]);
         for(int ii = 0; ii < ntris; ii++) { _geoms[ii] = nullptr; }
         _fixCount = ntris;
     } else {
@@ -150,6 +149,25 @@ void PolygonObstacle::resetShapes() {
     }
 }
 
+/**
+ * Releases the shape and fixture arrays of this polygon.
+ *
+ * Arrays allocated from an arena are simply dropped, as they are
+ * reclaimed when the arena is reset.
+ */
+void PolygonObstacle::releaseShapes() {
+    if (_arena == nullptr) {
+        if (_shapes != nullptr) {
+            delete[] _shapes;
+        }
+        if (_geoms != nullptr) {
+            delete[] _geoms;
+        }
+    }
+    _shapes = nullptr;
+    _geoms = nullptr;
+}
+
 
 #pragma mark -
 #pragma mark Dimensions
@@ -228,6 +246,9 @@ void PolygonObstacle::createFixtures() {
         return;
     }
     
+    CUAssertLog(_arena == nullptr || _generation == _arena->getGeneration(),
+                "Polygon shapes were released by an arena reset");
+
     // Create the fixtures
     releaseFixtures();
     for(int ii = 0; ii < _fixCount; ii++) {
@@ -250,8 +271,34 @@ void PolygonObstacle::releaseFixtures() {
         }
     }
     if (_geoms != nullptr && _fixCount != (int)_polygon.indices().size()/3) {
-        delete[] _geoms;
         _fixCount = (int)_polygon.indices().size()/3;
-        _geoms = new b2Fixture*[_fixCount];
+        if (_arena != nullptr) {
+            _geoms = _arena->allocArray<b2Fixture*>(_fixCount);
+        } else {
+            delete[] _geoms;
+            _geoms = new b2Fixture*[_fixCount];
+        }
     }
 }
+
+
+#pragma mark -
+#pragma mark Memory Management
+/**
+ * Sets the arena providing the shape arrays of this polygon.
+ *
+ * Polygons that share the lifetime of a level (e.g. level geometry)
+ * can take their triangle shapes and fixture caches from the level
+ * arena instead of the heap.  This avoids a pair of heap allocations
+ * per polygon every time the level is rebuilt.
+ *
+ * This method must be called before the polygon is initialized.  The
+ * arena must not be reset until this obstacle is removed from the world,
+ * as that invalidates the shapes.
+ *
+ * @param arena The arena providing the shape arrays of this polygon
+ */
+void PolygonObstacle::setArena(const std::shared_ptr<Arena>& arena) {
+    CUAssertLog(_shapes == nullptr && _body == nullptr, "Arena must be set before the polygon is initialized");
+    _arena = arena;
+}
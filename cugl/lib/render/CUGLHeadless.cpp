@@ -0,0 +1,1456 @@
+//
+//  CUGLHeadless.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a stub OpenGL backend for headless tests.  When the
+//  engine is built with CU_GL_HEADLESS defined, every OpenGL call made by the
+//  engine is routed to a function in this module instead of the driver.  The
+//  stub hands out fake object names and sync objects, keeps just enough state
+//  to answer the queries made by the render layer, and introspects shaders by
+//  reading their source.  Nothing is ever drawn.
+//
+//  When CU_GL_HEADLESS is not defined, this module compiles to nothing.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+// This module defines the OpenGL names, so it must not see the recording macros
+#define CU_GL_HEADLESS_SOURCE
+#include <cugl/render/CUGLHeadless.h>
+
+#ifdef CU_GL_HEADLESS
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+using namespace cugl;
+
+#pragma mark -
+#pragma mark Variable Types
+/** The GLSL types that may be declared in a shader */
+typedef struct {
+    /** The GLSL type name */
+    const char* name;
+    /** The OpenGL type enum */
+    GLenum type;
+    /** The number of columns (1 for scalars, vectors and samplers) */
+    GLint columns;
+    /** The number of rows (the vector width) */
+    GLint rows;
+} GLSLType;
+
+/** The supported GLSL types */
+static const GLSLType GLSL_TYPES[] = {
+    { "float",     GL_FLOAT,             1, 1 },
+    { "vec2",      GL_FLOAT_VEC2,        1, 2 },
+    { "vec3",      GL_FLOAT_VEC3,        1, 3 },
+    { "vec4",      GL_FLOAT_VEC4,        1, 4 },
+    { "int",       GL_INT,               1, 1 },
+    { "ivec2",     GL_INT_VEC2,          1, 2 },
+    { "ivec3",     GL_INT_VEC3,          1, 3 },
+    { "ivec4",     GL_INT_VEC4,          1, 4 },
+    { "uint",      GL_UNSIGNED_INT,      1, 1 },
+    { "uvec2",     GL_UNSIGNED_INT_VEC2, 1, 2 },
+    { "uvec3",     GL_UNSIGNED_INT_VEC3, 1, 3 },
+    { "uvec4",     GL_UNSIGNED_INT_VEC4, 1, 4 },
+    { "bool",      GL_BOOL,              1, 1 },
+    { "bvec2",     GL_BOOL_VEC2,         1, 2 },
+    { "bvec3",     GL_BOOL_VEC3,         1, 3 },
+    { "bvec4",     GL_BOOL_VEC4,         1, 4 },
+    { "mat2",      GL_FLOAT_MAT2,        2, 2 },
+    { "mat3",      GL_FLOAT_MAT3,        3, 3 },
+    { "mat4",      GL_FLOAT_MAT4,        4, 4 },
+    { "mat2x3",    GL_FLOAT_MAT2x3,      2, 3 },
+    { "mat2x4",    GL_FLOAT_MAT2x4,      2, 4 },
+    { "mat3x2",    GL_FLOAT_MAT3x2,      3, 2 },
+    { "mat3x4",    GL_FLOAT_MAT3x4,      3, 4 },
+    { "mat4x2",    GL_FLOAT_MAT4x2,      4, 2 },
+    { "mat4x3",    GL_FLOAT_MAT4x3,      4, 3 },
+    { "sampler2D", GL_SAMPLER_2D,        1, 1 },
+    { "sampler3D", GL_SAMPLER_3D,        1, 1 },
+    { "samplerCube", GL_SAMPLER_CUBE,    1, 1 },
+};
+
+/**
+ * Returns the GLSL type with the given name, or nullptr if it is not supported
+ *
+ * @param name  The GLSL type name
+ *
+ * @return the GLSL type with the given name, or nullptr if it is not supported
+ */
+static const GLSLType* find_type(const std::string& name) {
+    for(const GLSLType& type : GLSL_TYPES) {
+        if (name == type.name) {
+            return &type;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the std140 alignment of an element of the given type
+ *
+ * @param type  The GLSL type
+ *
+ * @return the std140 alignment of an element of the given type
+ */
+static GLint std140_align(const GLSLType* type) {
+    if (type->columns > 1 || type->rows > 2) {
+        return 16;
+    }
+    return 4*type->rows;
+}
+
+/**
+ * Returns the std140 size of an element of the given type
+ *
+ * Matrices are stored as arrays of column vectors, and so every column is
+ * padded to a vec4.
+ *
+ * @param type  The GLSL type
+ *
+ * @return the std140 size of an element of the given type
+ */
+static GLint std140_size(const GLSLType* type) {
+    if (type->columns > 1) {
+        return 16*type->columns;
+    }
+    return 4*type->rows;
+}
+
+/**
+ * Returns the value rounded up to the given alignment
+ *
+ * @param value The value to round
+ * @param align The alignment
+ *
+ * @return the value rounded up to the given alignment
+ */
+static GLint round_up(GLint value, GLint align) {
+    return ((value+align-1)/align)*align;
+}
+
+#pragma mark -
+#pragma mark Objects
+/** A variable declared in a shader */
+typedef struct {
+    /** The variable name (as reported by introspection) */
+    std::string name;
+    /** The variable type */
+    const GLSLType* type;
+    /** The array length (1 if the variable is not an array) */
+    GLint count;
+    /** The uniform block index (-1 if not in a block) */
+    GLint block;
+} Variable;
+
+/** A uniform block declared in a shader */
+typedef struct {
+    /** The block name */
+    std::string name;
+    /** The block fields */
+    std::vector<Variable> fields;
+    /** The std140 size of the block in bytes */
+    GLint size;
+} Block;
+
+/** A shader and the variables declared in its source */
+typedef struct {
+    /** The shader type */
+    GLenum type;
+    /** The shader source */
+    std::string source;
+    /** The input variables */
+    std::vector<Variable> inputs;
+    /** The output variables */
+    std::vector<Variable> outputs;
+    /** The uniforms outside of a block */
+    std::vector<Variable> uniforms;
+    /** The uniform blocks */
+    std::vector<Block> blocks;
+} ShaderState;
+
+/** A program and the results of linking it */
+typedef struct {
+    /** The attached shaders */
+    std::vector<GLuint> shaders;
+    /** The active attributes (the vertex shader inputs) */
+    std::vector<Variable> attributes;
+    /** The active uniforms (free uniforms first, then the block fields) */
+    std::vector<Variable> uniforms;
+    /** The active uniform blocks */
+    std::vector<Block> blocks;
+    /** The binding point of each uniform block */
+    std::vector<GLint> bindings;
+    /** The fragment shader outputs */
+    std::vector<std::string> outputs;
+    /** The uniform index for each location */
+    std::vector<GLint> locations;
+    /** The offset into values for each location */
+    std::vector<size_t> offsets;
+    /** The uniform values, as 32-bit words */
+    std::vector<Uint32> values;
+} ProgramState;
+
+/** The storage of a 2D texture */
+typedef struct {
+    /** The texture width */
+    GLsizei width;
+    /** The texture height */
+    GLsizei height;
+} Image;
+
+/** The last name given to an object (names are never reused) */
+static GLuint _names = 0;
+/** The allocated buffer objects and their storage */
+static std::unordered_map<GLuint,std::vector<Uint8>> _buffers;
+/** The buffer bound to each target */
+static std::unordered_map<GLenum,GLuint> _targets;
+/** The buffer bound to each indexed target (the target is the high word) */
+static std::unordered_map<Uint64,GLuint> _indexed;
+/** The texture images, as allocated by glTexImage2D */
+static std::unordered_map<GLuint,Image> _images;
+/** The texture bound to each texture unit */
+static std::unordered_map<GLenum,GLuint> _units;
+/** The active texture unit */
+static GLenum _activeUnit = GL_TEXTURE0;
+/** The compiled shaders */
+static std::unordered_map<GLuint,ShaderState> _shaders;
+/** The linked programs */
+static std::unordered_map<GLuint,ProgramState> _programs;
+/** The current program */
+static GLuint _program = 0;
+/** The current vertex array */
+static GLuint _vertexArray = 0;
+/** The current framebuffer */
+static GLuint _framebuffer = 0;
+/** The current renderbuffer */
+static GLuint _renderbuffer = 0;
+/** The current viewport */
+static GLint _viewport[4] = { 0, 0, 0, 0 };
+
+/**
+ * Assigns new names to the given array
+ *
+ * @param n     The number of names
+ * @param names The array to store the names
+ */
+static void gen_names(GLsizei n, GLuint* names) {
+    for(GLsizei ii = 0; ii < n; ii++) {
+        names[ii] = ++_names;
+    }
+}
+
+/**
+ * Copies a string to an OpenGL name buffer, truncating as necessary
+ *
+ * @param value     The string to copy
+ * @param bufSize   The buffer size (including the null terminator)
+ * @param length    The place to store the copied length (may be nullptr)
+ * @param name      The buffer to copy into
+ */
+static void copy_name(const std::string& value, GLsizei bufSize, GLsizei* length, GLchar* name) {
+    GLsizei amt = 0;
+    if (bufSize > 0) {
+        amt = std::min((GLsizei)value.size(),bufSize-1);
+        std::memcpy(name,value.data(),amt);
+        name[amt] = 0;
+    }
+    if (length) {
+        *length = amt;
+    }
+}
+
+#pragma mark -
+#pragma mark Shader Parsing
+/**
+ * Returns the shader source without comments or preprocessor directives
+ *
+ * @param source    The shader source
+ *
+ * @return the shader source without comments or preprocessor directives
+ */
+static std::string strip_source(const std::string& source) {
+    std::string result;
+    result.reserve(source.size());
+    bool linestart = true;
+    size_t pos = 0;
+    while (pos < source.size()) {
+        char c = source[pos];
+        if (c == '/' && pos+1 < source.size() && source[pos+1] == '/') {
+            pos = source.find('\n',pos);
+        } else if (c == '/' && pos+1 < source.size() && source[pos+1] == '*') {
+            pos = source.find("*/",pos+2);
+            pos = (pos == std::string::npos ? pos : pos+2);
+            result.push_back(' ');
+        } else if (c == '#' && linestart) {
+            pos = source.find('\n',pos);
+        } else {
+            if (c == '\n') {
+                linestart = true;
+            } else if (!isspace(c)) {
+                linestart = false;
+            }
+            result.push_back(c);
+            pos++;
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the tokens of a declaration
+ *
+ * Identifiers and numbers are single tokens, as is each punctuation mark.
+ *
+ * @param text  The declaration text
+ *
+ * @return the tokens of a declaration
+ */
+static std::vector<std::string> tokenize(const std::string& text) {
+    std::vector<std::string> result;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (isalnum(text[pos]) || text[pos] == '_') {
+            size_t end = pos;
+            while (end < text.size() && (isalnum(text[end]) || text[end] == '_')) {
+                end++;
+            }
+            result.push_back(text.substr(pos,end-pos));
+            pos = end;
+        } else {
+            if (!isspace(text[pos])) {
+                result.push_back(text.substr(pos,1));
+            }
+            pos++;
+        }
+    }
+    return result;
+}
+
+/**
+ * Appends the variables declared by the given tokens
+ *
+ * The tokens start with the type, and are followed by one or more names
+ * (separated by commas), each of which may be an array.  Array variables
+ * are named with the suffix "[0]", as required by introspection.
+ *
+ * @param tokens    The declaration tokens
+ * @param start     The position of the type
+ * @param block     The uniform block index (-1 if not in a block)
+ * @param prefix    The prefix for each name
+ * @param result    The list to append to
+ */
+static void parse_variables(const std::vector<std::string>& tokens, size_t start, GLint block,
+                            const std::string& prefix, std::vector<Variable>& result) {
+    static const char* QUALIFIERS[] = {
+        "highp", "mediump", "lowp", "flat", "smooth", "noperspective", "centroid", "invariant", "const"
+    };
+    while (start < tokens.size()) {
+        bool qualifier = false;
+        for(const char* word : QUALIFIERS) {
+            qualifier = qualifier || tokens[start] == word;
+        }
+        if (!qualifier) {
+            break;
+        }
+        start++;
+    }
+    if (start >= tokens.size()) {
+        return;
+    }
+
+    const GLSLType* type = find_type(tokens[start]);
+    if (type == nullptr) {
+        return;
+    }
+
+    size_t pos = start+1;
+    while (pos < tokens.size()) {
+        Variable var;
+        var.name = prefix+tokens[pos++];
+        var.type = type;
+        var.count = 1;
+        var.block = block;
+        if (pos+2 < tokens.size() && tokens[pos] == "[") {
+            var.count = std::max(1,atoi(tokens[pos+1].c_str()));
+            var.name += "[0]";
+            pos += 3;
+        }
+        result.push_back(var);
+        while (pos < tokens.size() && tokens[pos] != ",") {
+            pos++;
+        }
+        pos++;
+    }
+}
+
+/**
+ * Processes a single declaration at global scope
+ *
+ * @param shader    The shader to update
+ * @param text      The declaration text
+ */
+static void parse_declaration(ShaderState& shader, const std::string& text) {
+    std::vector<std::string> tokens = tokenize(text);
+    size_t pos = 0;
+    if (pos < tokens.size() && tokens[pos] == "layout") {
+        while (pos < tokens.size() && tokens[pos] != ")") {
+            pos++;
+        }
+        pos++;
+    }
+    if (pos >= tokens.size()) {
+        return;
+    }
+
+    const std::string& storage = tokens[pos];
+    if (storage == "in") {
+        parse_variables(tokens, pos+1, -1, "", shader.inputs);
+    } else if (storage == "out") {
+        parse_variables(tokens, pos+1, -1, "", shader.outputs);
+    } else if (storage == "uniform") {
+        parse_variables(tokens, pos+1, -1, "", shader.uniforms);
+    }
+}
+
+/**
+ * Processes a uniform block declaration
+ *
+ * The block fields are laid out with the std140 rules.  If the block has an
+ * instance name, the fields are prefixed by the block name.
+ *
+ * @param shader    The shader to update
+ * @param header    The text before the block body
+ * @param body      The block body
+ * @param instance  The text after the block body
+ */
+static void parse_block(ShaderState& shader, const std::string& header,
+                        const std::string& body, const std::string& instance) {
+    std::vector<std::string> tokens = tokenize(header);
+    if (tokens.empty()) {
+        return;
+    }
+
+    Block block;
+    block.name = tokens.back();
+    block.size = 0;
+    std::string prefix = tokenize(instance).empty() ? "" : block.name+".";
+
+    size_t start = 0;
+    size_t end = body.find(';');
+    while (end != std::string::npos) {
+        std::vector<std::string> field = tokenize(body.substr(start,end-start));
+        parse_variables(field, 0, (GLint)shader.blocks.size(), prefix, block.fields);
+        start = end+1;
+        end = body.find(';',start);
+    }
+
+    for(const Variable& var : block.fields) {
+        GLint align = std140_align(var.type);
+        GLint size  = std140_size(var.type);
+        if (var.count > 1) {
+            align = 16;
+            size = round_up(size,16)*var.count;
+        }
+        block.size = round_up(block.size,align)+size;
+    }
+    block.size = round_up(block.size,16);
+    shader.blocks.push_back(block);
+}
+
+/**
+ * Reads the variable declarations from the shader source
+ *
+ * Only declarations at global scope are considered.  Function bodies are
+ * skipped entirely.
+ *
+ * @param shader    The shader to update
+ */
+static void parse_shader(ShaderState& shader) {
+    shader.inputs.clear();
+    shader.outputs.clear();
+    shader.uniforms.clear();
+    shader.blocks.clear();
+
+    std::string source = strip_source(shader.source);
+    std::string text;
+    std::string header;
+    std::string body;
+    bool inblock = false;
+    int depth = 0;
+    for(char c : source) {
+        if (c == '{') {
+            if (depth == 0) {
+                std::vector<std::string> tokens = tokenize(text);
+                inblock = std::find(tokens.begin(), tokens.end(), "uniform") != tokens.end();
+                header = text;
+                text.clear();
+                body.clear();
+            } else if (inblock) {
+                body.push_back(c);
+            }
+            depth++;
+        } else if (c == '}') {
+            depth--;
+            if (depth == 0 && !inblock) {
+                text.clear();
+            } else if (depth > 0 && inblock) {
+                body.push_back(c);
+            }
+        } else if (depth > 0) {
+            if (inblock) {
+                body.push_back(c);
+            }
+        } else if (c == ';') {
+            if (inblock) {
+                parse_block(shader, header, body, text);
+                inblock = false;
+            } else {
+                parse_declaration(shader, text);
+            }
+            text.clear();
+        } else {
+            text.push_back(c);
+        }
+    }
+}
+
+/**
+ * Appends the variables of a shader to a list, skipping duplicate names
+ *
+ * @param vars      The variables to append
+ * @param result    The list to append to
+ */
+static void merge_variables(const std::vector<Variable>& vars, std::vector<Variable>& result) {
+    for(const Variable& var : vars) {
+        bool found = false;
+        for(const Variable& other : result) {
+            found = found || other.name == var.name;
+        }
+        if (!found) {
+            result.push_back(var);
+        }
+    }
+}
+
+/**
+ * Returns the base name and element of an array variable name
+ *
+ * @param name      The variable name, such as "uColor[2]"
+ * @param element   The place to store the array element
+ *
+ * @return the base name and element of an array variable name
+ */
+static std::string split_array(const std::string& name, GLint* element) {
+    *element = 0;
+    size_t pos = name.find('[');
+    if (pos == std::string::npos) {
+        return name;
+    }
+    *element = atoi(name.c_str()+pos+1);
+    return name.substr(0,pos);
+}
+
+/**
+ * Returns the index of the named variable, or -1 if there is none
+ *
+ * @param vars      The variables to search
+ * @param name      The variable name
+ * @param element   The place to store the array element
+ *
+ * @return the index of the named variable, or -1 if there is none
+ */
+static GLint find_variable(const std::vector<Variable>& vars, const std::string& name, GLint* element) {
+    std::string base = split_array(name, element);
+    for(size_t ii = 0; ii < vars.size(); ii++) {
+        GLint unused;
+        if (split_array(vars[ii].name,&unused) == base) {
+            return *element < vars[ii].count ? (GLint)ii : -1;
+        }
+    }
+    return -1;
+}
+
+#pragma mark -
+#pragma mark Uniform Values
+/**
+ * Stores the given words in the uniform at the location of the current program
+ *
+ * As in OpenGL, an array may be set starting at any of its elements, and the
+ * values that do not fit in the array are ignored.
+ *
+ * @param location  The uniform location
+ * @param words     The number of words to store
+ * @param value     The words to store
+ */
+static void set_uniform(GLint location, size_t words, const void* value) {
+    auto it = _programs.find(_program);
+    if (location < 0 || it == _programs.end() || location >= (GLint)it->second.locations.size()) {
+        return;
+    }
+
+    ProgramState& program = it->second;
+    GLint index = program.locations[location];
+    const Variable& var = program.uniforms[index];
+
+    // The uniform ends where the location of its first element says
+    GLint first = location;
+    while (first > 0 && program.locations[first-1] == index) {
+        first--;
+    }
+    size_t start = program.offsets[location];
+    size_t limit = program.offsets[first]+var.count*var.type->columns*var.type->rows;
+    words = std::min(words,limit-start);
+    std::memcpy(program.values.data()+start,value,words*sizeof(Uint32));
+}
+
+/**
+ * Copies the uniform at the given location to the given array
+ *
+ * @param program   The program name
+ * @param location  The uniform location
+ * @param value     The array to store the uniform value
+ */
+static void get_uniform(GLuint program, GLint location, void* value) {
+    auto it = _programs.find(program);
+    if (location < 0 || it == _programs.end() || location >= (GLint)it->second.locations.size()) {
+        return;
+    }
+
+    const ProgramState& prog = it->second;
+    const Variable& var = prog.uniforms[prog.locations[location]];
+    size_t words = var.type->columns*var.type->rows;
+    std::memcpy(value,prog.values.data()+prog.offsets[location],words*sizeof(Uint32));
+}
+
+#pragma mark -
+#pragma mark State
+void headless::glEnable(GLenum cap) { }
+void headless::glDisable(GLenum cap) { }
+void headless::glDepthFunc(GLenum func) { }
+void headless::glDepthMask(GLboolean flag) { }
+void headless::glBlendFunc(GLenum sfactor, GLenum dfactor) { }
+void headless::glBlendEquation(GLenum mode) { }
+
+void headless::glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    _viewport[0] = x;
+    _viewport[1] = y;
+    _viewport[2] = width;
+    _viewport[3] = height;
+}
+
+void headless::glClear(GLbitfield mask) { }
+void headless::glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) { }
+GLenum headless::glGetError() { return GL_NO_ERROR; }
+
+void headless::glGetIntegerv(GLenum pname, GLint* data) {
+    switch (pname) {
+        case GL_ACTIVE_TEXTURE:
+            *data = (GLint)_activeUnit;
+            break;
+        case GL_TEXTURE_BINDING_2D:
+            *data = (GLint)_units[_activeUnit];
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            *data = (GLint)_targets[GL_ARRAY_BUFFER];
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            *data = (GLint)_targets[GL_ELEMENT_ARRAY_BUFFER];
+            break;
+        case GL_UNIFORM_BUFFER_BINDING:
+            *data = (GLint)_targets[GL_UNIFORM_BUFFER];
+            break;
+        case GL_VERTEX_ARRAY_BINDING:
+            *data = (GLint)_vertexArray;
+            break;
+        case GL_CURRENT_PROGRAM:
+            *data = (GLint)_program;
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            *data = (GLint)_framebuffer;
+            break;
+        case GL_RENDERBUFFER_BINDING:
+            *data = (GLint)_renderbuffer;
+            break;
+        case GL_VIEWPORT:
+            std::memcpy(data,_viewport,sizeof(_viewport));
+            break;
+        case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+            *data = 256;
+            break;
+        case GL_MAX_UNIFORM_BLOCK_SIZE:
+            *data = 65536;
+            break;
+        case GL_MAX_TEXTURE_SIZE:
+            *data = 16384;
+            break;
+        case GL_MAX_COLOR_ATTACHMENTS:
+        case GL_MAX_DRAW_BUFFERS:
+            *data = 8;
+            break;
+        default:
+            *data = 0;
+            break;
+    }
+}
+
+void headless::glGetIntegeri_v(GLenum target, GLuint index, GLint* data) {
+    auto it = _indexed.find(((Uint64)target << 32) | index);
+    *data = (it == _indexed.end() ? 0 : (GLint)it->second);
+}
+
+const GLubyte* headless::glGetString(GLenum name) {
+    switch (name) {
+        case GL_VENDOR:
+            return (const GLubyte*)"CUGL";
+        case GL_RENDERER:
+            return (const GLubyte*)"CUGL Headless";
+        case GL_VERSION:
+            return (const GLubyte*)"4.1 Headless";
+        case GL_SHADING_LANGUAGE_VERSION:
+            return (const GLubyte*)"4.10";
+    }
+    return (const GLubyte*)"";
+}
+
+#pragma mark -
+#pragma mark Buffers
+void headless::glGenBuffers(GLsizei n, GLuint* buffers) {
+    gen_names(n, buffers);
+    for(GLsizei ii = 0; ii < n; ii++) {
+        _buffers[buffers[ii]];
+    }
+}
+
+void headless::glDeleteBuffers(GLsizei n, const GLuint* buffers) {
+    for(GLsizei ii = 0; ii < n; ii++) {
+        _buffers.erase(buffers[ii]);
+        for(auto it = _targets.begin(); it != _targets.end(); ++it) {
+            if (it->second == buffers[ii]) {
+                it->second = 0;
+            }
+        }
+        for(auto it = _indexed.begin(); it != _indexed.end(); ++it) {
+            if (it->second == buffers[ii]) {
+                it->second = 0;
+            }
+        }
+    }
+}
+
+void headless::glBindBuffer(GLenum target, GLuint buffer) {
+    _targets[target] = buffer;
+}
+
+void headless::glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    _targets[target] = buffer;
+    _indexed[((Uint64)target << 32) | index] = buffer;
+}
+
+void headless::glBindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                                 GLintptr offset, GLsizeiptr size) {
+    _targets[target] = buffer;
+    _indexed[((Uint64)target << 32) | index] = buffer;
+}
+
+void headless::glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    auto it = _buffers.find(_targets[target]);
+    if (it != _buffers.end()) {
+        it->second.assign(size,0);
+        if (data) {
+            std::memcpy(it->second.data(),data,size);
+        }
+    }
+}
+
+void headless::glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    auto it = _buffers.find(_targets[target]);
+    if (it != _buffers.end() && offset+size <= (GLintptr)it->second.size()) {
+        std::memcpy(it->second.data()+offset,data,size);
+    }
+}
+
+void* headless::glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    auto it = _buffers.find(_targets[target]);
+    if (it != _buffers.end() && offset+length <= (GLintptr)it->second.size()) {
+        return it->second.data()+offset;
+    }
+    return nullptr;
+}
+
+GLboolean headless::glUnmapBuffer(GLenum target) {
+    return GL_TRUE;
+}
+
+void headless::glGenVertexArrays(GLsizei n, GLuint* arrays) {
+    gen_names(n, arrays);
+}
+
+void headless::glDeleteVertexArrays(GLsizei n, const GLuint* arrays) {
+    for(GLsizei ii = 0; ii < n; ii++) {
+        if (arrays[ii] == _vertexArray) {
+            _vertexArray = 0;
+        }
+    }
+}
+
+void headless::glBindVertexArray(GLuint array) {
+    _vertexArray = array;
+}
+
+void headless::glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                     GLsizei stride, const void* pointer) { }
+void headless::glEnableVertexAttribArray(GLuint index) { }
+void headless::glDisableVertexAttribArray(GLuint index) { }
+
+#pragma mark -
+#pragma mark Drawing
+void headless::glDrawArrays(GLenum mode, GLint first, GLsizei count) { }
+void headless::glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) { }
+void headless::glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+                                       GLsizei instancecount) { }
+
+GLsync headless::glFenceSync(GLenum condition, GLbitfield flags) {
+    // Sync objects are never dereferenced, so any unique value will do
+    return reinterpret_cast<GLsync>((uintptr_t)(++_names));
+}
+
+GLenum headless::glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    return GL_ALREADY_SIGNALED;
+}
+
+void headless::glDeleteSync(GLsync sync) { }
+
+#pragma mark -
+#pragma mark Textures
+void headless::glGenTextures(GLsizei n, GLuint* textures) {
+    gen_names(n, textures);
+}
+
+void headless::glDeleteTextures(GLsizei n, const GLuint* textures) {
+    for(GLsizei ii = 0; ii < n; ii++) {
+        _images.erase(textures[ii]);
+        for(auto it = _units.begin(); it != _units.end(); ++it) {
+            if (it->second == textures[ii]) {
+                it->second = 0;
+            }
+        }
+    }
+}
+
+void headless::glActiveTexture(GLenum texture) {
+    _activeUnit = texture;
+}
+
+void headless::glBindTexture(GLenum target, GLuint texture) {
+    _units[_activeUnit] = texture;
+}
+
+void headless::glTexParameteri(GLenum target, GLenum pname, GLint param) { }
+
+void headless::glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                            GLint border, GLenum format, GLenum type, const void* pixels) {
+    if (level == 0) {
+        Image& image = _images[_units[_activeUnit]];
+        image.width  = width;
+        image.height = height;
+    }
+}
+
+void headless::glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels) {
+    auto it = _images.find(_units[_activeUnit]);
+    if (it == _images.end() || level != 0) {
+        return;
+    }
+
+    size_t channels = 4;
+    switch (format) {
+        case GL_RED:
+        case GL_RED_INTEGER:
+        case GL_DEPTH_COMPONENT:
+            channels = 1;
+            break;
+        case GL_RG:
+        case GL_RG_INTEGER:
+            channels = 2;
+            break;
+        case GL_RGB:
+        case GL_RGB_INTEGER:
+            channels = 3;
+            break;
+    }
+
+    size_t bytes = 4;
+    switch (type) {
+        case GL_UNSIGNED_BYTE:
+        case GL_BYTE:
+            bytes = 1;
+            break;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT:
+            bytes = 2;
+            break;
+        case GL_UNSIGNED_INT_24_8:
+            channels = 1;
+            break;
+    }
+    std::memset(pixels,0,it->second.width*it->second.height*channels*bytes);
+}
+
+void headless::glGenerateMipmap(GLenum target) { }
+
+#pragma mark -
+#pragma mark Framebuffers
+void headless::glGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+    gen_names(n, framebuffers);
+}
+
+void headless::glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+    for(GLsizei ii = 0; ii < n; ii++) {
+        if (framebuffers[ii] == _framebuffer) {
+            _framebuffer = 0;
+        }
+    }
+}
+
+void headless::glBindFramebuffer(GLenum target, GLuint framebuffer) {
+    _framebuffer = framebuffer;
+}
+
+void headless::glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget,
+                                      GLuint texture, GLint level) { }
+void headless::glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget,
+                                         GLuint renderbuffer) { }
+
+GLenum headless::glCheckFramebufferStatus(GLenum target) {
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void headless::glDrawBuffers(GLsizei n, const GLenum* bufs) { }
+
+void headless::glGenRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+    gen_names(n, renderbuffers);
+}
+
+void headless::glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
+    for(GLsizei ii = 0; ii < n; ii++) {
+        if (renderbuffers[ii] == _renderbuffer) {
+            _renderbuffer = 0;
+        }
+    }
+}
+
+void headless::glBindRenderbuffer(GLenum target, GLuint renderbuffer) {
+    _renderbuffer = renderbuffer;
+}
+
+void headless::glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) { }
+
+#pragma mark -
+#pragma mark Shaders
+GLuint headless::glCreateShader(GLenum type) {
+    GLuint name = ++_names;
+    _shaders[name].type = type;
+    return name;
+}
+
+void headless::glDeleteShader(GLuint shader) {
+    _shaders.erase(shader);
+}
+
+GLboolean headless::glIsShader(GLuint shader) {
+    return _shaders.find(shader) != _shaders.end();
+}
+
+void headless::glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+    auto it = _shaders.find(shader);
+    if (it == _shaders.end()) {
+        return;
+    }
+    it->second.source.clear();
+    for(GLsizei ii = 0; ii < count; ii++) {
+        if (length && length[ii] >= 0) {
+            it->second.source.append(string[ii],length[ii]);
+        } else {
+            it->second.source.append(string[ii]);
+        }
+    }
+}
+
+void headless::glCompileShader(GLuint shader) {
+    auto it = _shaders.find(shader);
+    if (it != _shaders.end()) {
+        parse_shader(it->second);
+    }
+}
+
+void headless::glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    auto it = _shaders.find(shader);
+    switch (pname) {
+        case GL_COMPILE_STATUS:
+            *params = (it != _shaders.end() ? GL_TRUE : GL_FALSE);
+            break;
+        case GL_SHADER_TYPE:
+            *params = (it != _shaders.end() ? (GLint)it->second.type : 0);
+            break;
+        case GL_SHADER_SOURCE_LENGTH:
+            *params = (it != _shaders.end() ? (GLint)it->second.source.size()+1 : 0);
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void headless::glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    copy_name("", bufSize, length, infoLog);
+}
+
+GLuint headless::glCreateProgram() {
+    GLuint name = ++_names;
+    _programs[name];
+    return name;
+}
+
+GLboolean headless::glIsProgram(GLuint program) {
+    return _programs.find(program) != _programs.end();
+}
+
+void headless::glAttachShader(GLuint program, GLuint shader) {
+    auto it = _programs.find(program);
+    if (it != _programs.end()) {
+        it->second.shaders.push_back(shader);
+    }
+}
+
+void headless::glLinkProgram(GLuint program) {
+    auto it = _programs.find(program);
+    if (it == _programs.end()) {
+        return;
+    }
+
+    ProgramState& prog = it->second;
+    prog.attributes.clear();
+    prog.uniforms.clear();
+    prog.blocks.clear();
+    prog.outputs.clear();
+    for(GLuint name : prog.shaders) {
+        auto jt = _shaders.find(name);
+        if (jt == _shaders.end()) {
+            continue;
+        }
+        const ShaderState& shader = jt->second;
+        if (shader.type == GL_VERTEX_SHADER) {
+            merge_variables(shader.inputs, prog.attributes);
+        } else if (shader.type == GL_FRAGMENT_SHADER) {
+            for(const Variable& var : shader.outputs) {
+                prog.outputs.push_back(var.name);
+            }
+        }
+        merge_variables(shader.uniforms, prog.uniforms);
+        for(const Block& block : shader.blocks) {
+            bool found = false;
+            for(const Block& other : prog.blocks) {
+                found = found || other.name == block.name;
+            }
+            if (!found) {
+                prog.blocks.push_back(block);
+            }
+        }
+    }
+
+    // Only the free uniforms have locations (one per array element)
+    prog.locations.clear();
+    prog.offsets.clear();
+    size_t words = 0;
+    for(size_t ii = 0; ii < prog.uniforms.size(); ii++) {
+        const Variable& var = prog.uniforms[ii];
+        size_t width = var.type->columns*var.type->rows;
+        for(GLint jj = 0; jj < var.count; jj++) {
+            prog.locations.push_back((GLint)ii);
+            prog.offsets.push_back(words);
+            words += width;
+        }
+    }
+    prog.values.assign(words,0);
+
+    // The block fields come after the free uniforms
+    for(size_t ii = 0; ii < prog.blocks.size(); ii++) {
+        for(Variable var : prog.blocks[ii].fields) {
+            var.block = (GLint)ii;
+            prog.uniforms.push_back(var);
+        }
+    }
+    prog.bindings.assign(prog.blocks.size(),0);
+}
+
+void headless::glUseProgram(GLuint program) {
+    _program = program;
+}
+
+void headless::glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    auto it = _programs.find(program);
+    if (it == _programs.end()) {
+        *params = 0;
+        return;
+    }
+
+    const ProgramState& prog = it->second;
+    GLint length = 0;
+    switch (pname) {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            *params = GL_TRUE;
+            break;
+        case GL_ATTACHED_SHADERS:
+            *params = (GLint)prog.shaders.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            *params = (GLint)prog.attributes.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+            for(const Variable& var : prog.attributes) {
+                length = std::max(length,(GLint)var.name.size()+1);
+            }
+            *params = length;
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            *params = (GLint)prog.uniforms.size();
+            break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+            for(const Variable& var : prog.uniforms) {
+                length = std::max(length,(GLint)var.name.size()+1);
+            }
+            *params = length;
+            break;
+        case GL_ACTIVE_UNIFORM_BLOCKS:
+            *params = (GLint)prog.blocks.size();
+            break;
+        case GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH:
+            for(const Block& block : prog.blocks) {
+                length = std::max(length,(GLint)block.name.size()+1);
+            }
+            *params = length;
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void headless::glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    copy_name("", bufSize, length, infoLog);
+}
+
+void headless::glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length,
+                                 GLint* size, GLenum* type, GLchar* name) {
+    auto it = _programs.find(program);
+    if (it == _programs.end() || index >= it->second.attributes.size()) {
+        copy_name("", bufSize, length, name);
+        return;
+    }
+    const Variable& var = it->second.attributes[index];
+    copy_name(var.name, bufSize, length, name);
+    *size = var.count;
+    *type = var.type->type;
+}
+
+void headless::glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length,
+                                  GLint* size, GLenum* type, GLchar* name) {
+    auto it = _programs.find(program);
+    if (it == _programs.end() || index >= it->second.uniforms.size()) {
+        copy_name("", bufSize, length, name);
+        return;
+    }
+    const Variable& var = it->second.uniforms[index];
+    copy_name(var.name, bufSize, length, name);
+    *size = var.count;
+    *type = var.type->type;
+}
+
+void headless::glGetActiveUniformBlockName(GLuint program, GLuint index, GLsizei bufSize,
+                                           GLsizei* length, GLchar* name) {
+    auto it = _programs.find(program);
+    if (it == _programs.end() || index >= it->second.blocks.size()) {
+        copy_name("", bufSize, length, name);
+        return;
+    }
+    copy_name(it->second.blocks[index].name, bufSize, length, name);
+}
+
+void headless::glGetActiveUniformBlockiv(GLuint program, GLuint index, GLenum pname, GLint* params) {
+    auto it = _programs.find(program);
+    if (it == _programs.end() || index >= it->second.blocks.size()) {
+        return;
+    }
+
+    const ProgramState& prog = it->second;
+    const Block& block = prog.blocks[index];
+    switch (pname) {
+        case GL_UNIFORM_BLOCK_BINDING:
+            *params = prog.bindings[index];
+            break;
+        case GL_UNIFORM_BLOCK_DATA_SIZE:
+            *params = block.size;
+            break;
+        case GL_UNIFORM_BLOCK_NAME_LENGTH:
+            *params = (GLint)block.name.size()+1;
+            break;
+        case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS:
+            *params = (GLint)block.fields.size();
+            break;
+        case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES:
+        {
+            GLint pos = 0;
+            for(size_t ii = 0; ii < prog.uniforms.size(); ii++) {
+                if (prog.uniforms[ii].block == (GLint)index) {
+                    params[pos++] = (GLint)ii;
+                }
+            }
+        }
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+GLint headless::glGetAttribLocation(GLuint program, const GLchar* name) {
+    auto it = _programs.find(program);
+    if (it == _programs.end()) {
+        return -1;
+    }
+    GLint element;
+    return find_variable(it->second.attributes, name, &element);
+}
+
+GLint headless::glGetUniformLocation(GLuint program, const GLchar* name) {
+    auto it = _programs.find(program);
+    if (it == _programs.end()) {
+        return -1;
+    }
+
+    const ProgramState& prog = it->second;
+    GLint element;
+    GLint index = find_variable(prog.uniforms, name, &element);
+    if (index < 0 || prog.uniforms[index].block >= 0) {
+        return -1;
+    }
+    for(size_t ii = 0; ii < prog.locations.size(); ii++) {
+        if (prog.locations[ii] == index) {
+            return (GLint)ii+element;
+        }
+    }
+    return -1;
+}
+
+GLuint headless::glGetUniformBlockIndex(GLuint program, const GLchar* name) {
+    auto it = _programs.find(program);
+    if (it != _programs.end()) {
+        for(size_t ii = 0; ii < it->second.blocks.size(); ii++) {
+            if (it->second.blocks[ii].name == name) {
+                return (GLuint)ii;
+            }
+        }
+    }
+    return GL_INVALID_INDEX;
+}
+
+GLint headless::glGetFragDataLocation(GLuint program, const GLchar* name) {
+    auto it = _programs.find(program);
+    if (it != _programs.end()) {
+        for(size_t ii = 0; ii < it->second.outputs.size(); ii++) {
+            if (it->second.outputs[ii] == name) {
+                return (GLint)ii;
+            }
+        }
+    }
+    return -1;
+}
+
+void headless::glUniformBlockBinding(GLuint program, GLuint index, GLuint binding) {
+    auto it = _programs.find(program);
+    if (it != _programs.end() && index < it->second.bindings.size()) {
+        it->second.bindings[index] = binding;
+    }
+}
+
+#pragma mark -
+#pragma mark Uniforms
+void headless::glUniform1i(GLint location, GLint v0) {
+    set_uniform(location, 1, &v0);
+}
+
+void headless::glUniform1iv(GLint location, GLsizei count, const GLint* value) {
+    set_uniform(location, count, value);
+}
+
+void headless::glUniform1ui(GLint location, GLuint v0) {
+    set_uniform(location, 1, &v0);
+}
+
+void headless::glUniform1uiv(GLint location, GLsizei count, const GLuint* value) {
+    set_uniform(location, count, value);
+}
+
+void headless::glUniform1f(GLint location, GLfloat v0) {
+    set_uniform(location, 1, &v0);
+}
+
+void headless::glUniform1fv(GLint location, GLsizei count, const GLfloat* value) {
+    set_uniform(location, count, value);
+}
+
+void headless::glUniform2i(GLint location, GLint v0, GLint v1) {
+    GLint value[] = { v0, v1 };
+    set_uniform(location, 2, value);
+}
+
+void headless::glUniform2iv(GLint location, GLsizei count, const GLint* value) {
+    set_uniform(location, 2*count, value);
+}
+
+void headless::glUniform2ui(GLint location, GLuint v0, GLuint v1) {
+    GLuint value[] = { v0, v1 };
+    set_uniform(location, 2, value);
+}
+
+void headless::glUniform2uiv(GLint location, GLsizei count, const GLuint* value) {
+    set_uniform(location, 2*count, value);
+}
+
+void headless::glUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+    GLfloat value[] = { v0, v1 };
+    set_uniform(location, 2, value);
+}
+
+void headless::glUniform2fv(GLint location, GLsizei count, const GLfloat* value) {
+    set_uniform(location, 2*count, value);
+}
+
+void headless::glUniform3i(GLint location, GLint v0, GLint v1, GLint v2) {
+    GLint value[] = { v0, v1, v2 };
+    set_uniform(location, 3, value);
+}
+
+void headless::glUniform3iv(GLint location, GLsizei count, const GLint* value) {
+    set_uniform(location, 3*count, value);
+}
+
+void headless::glUniform3ui(GLint location, GLuint v0, GLuint v1, GLuint v2) {
+    GLuint value[] = { v0, v1, v2 };
+    set_uniform(location, 3, value);
+}
+
+void headless::glUniform3uiv(GLint location, GLsizei count, const GLuint* value) {
+    set_uniform(location, 3*count, value);
+}
+
+void headless::glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
+    GLfloat value[] = { v0, v1, v2 };
+    set_uniform(location, 3, value);
+}
+
+void headless::glUniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+    set_uniform(location, 3*count, value);
+}
+
+void headless::glUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3) {
+    GLint value[] = { v0, v1, v2, v3 };
+    set_uniform(location, 4, value);
+}
+
+void headless::glUniform4iv(GLint location, GLsizei count, const GLint* value) {
+    set_uniform(location, 4*count, value);
+}
+
+void headless::glUniform4ui(GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3) {
+    GLuint value[] = { v0, v1, v2, v3 };
+    set_uniform(location, 4, value);
+}
+
+void headless::glUniform4uiv(GLint location, GLsizei count, const GLuint* value) {
+    set_uniform(location, 4*count, value);
+}
+
+void headless::glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
+    GLfloat value[] = { v0, v1, v2, v3 };
+    set_uniform(location, 4, value);
+}
+
+void headless::glUniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+    set_uniform(location, 4*count, value);
+}
+
+// Transposed matrices are stored as given, since nothing is ever drawn
+void headless::glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 4*count, value);
+}
+
+void headless::glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 9*count, value);
+}
+
+void headless::glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 16*count, value);
+}
+
+void headless::glUniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 6*count, value);
+}
+
+void headless::glUniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 6*count, value);
+}
+
+void headless::glUniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 8*count, value);
+}
+
+void headless::glUniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 8*count, value);
+}
+
+void headless::glUniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 12*count, value);
+}
+
+void headless::glUniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    set_uniform(location, 12*count, value);
+}
+
+void headless::glGetUniformfv(GLuint program, GLint location, GLfloat* params) {
+    get_uniform(program, location, params);
+}
+
+void headless::glGetUniformiv(GLuint program, GLint location, GLint* params) {
+    get_uniform(program, location, params);
+}
+
+void headless::glGetUniformuiv(GLuint program, GLint location, GLuint* params) {
+    get_uniform(program, location, params);
+}
+
+#endif
@@ -0,0 +1,123 @@
+//
+//  CUGLRecorder.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a recording shim for OpenGL.  When the engine is
+//  built with CU_GL_RECORD defined, the OpenGL calls made by the render layer
+//  are routed through counting macros before they reach the driver.  This
+//  allows tests and profiling builds to measure exactly how many state
+//  changes, uniform updates, buffer uploads and draw calls a frame issues.
+//  When CU_GL_RECORD is not defined, this module adds no cost whatsoever.
+//
+//  The recorder is only a counter.  Every call is still forwarded to the
+//  active OpenGL context, so it must be used with a valid context (such as
+//  the one created by the test harness).  The exception is a build with
+//  CU_GL_HEADLESS defined, which forwards every call to the stub backend in
+//  CUGLHeadless.cpp instead.
+//
+//  This class is a static singleton, and has no constructors.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/render/CUGLRecorder.h>
+#include <sstream>
+
+using namespace cugl;
+
+/** The number of calls in each category since the last reset */
+Uint32 GLRecorder::_counts[(int)Call::COUNT] = { 0 };
+
+/** The names of the call categories */
+static const char* CALL_NAMES[(int)GLRecorder::Call::COUNT] = {
+    "use-program",
+    "bind-vertex-array",
+    "bind-buffer",
+    "buffer-data",
+    "draw",
+    "active-texture",
+    "bind-texture",
+    "blend",
+    "capability",
+    "uniform",
+    "uniform-block",
+    "attribute",
+    "lookup",
+    "query",
+    "get-error",
+    "framebuffer",
+    "sync"
+};
+
+#pragma mark -
+#pragma mark Recording
+/**
+ * Resets all of the counts to zero.
+ *
+ * This is typically called at the start of a frame.
+ */
+void GLRecorder::reset() {
+    for(int ii = 0; ii < (int)Call::COUNT; ii++) {
+        _counts[ii] = 0;
+    }
+}
+
+#pragma mark -
+#pragma mark Counts
+/**
+ * Returns the number of recorded calls since the last reset.
+ *
+ * @return the number of recorded calls since the last reset.
+ */
+Uint32 GLRecorder::getTotal() {
+    Uint32 total = 0;
+    for(int ii = 0; ii < (int)Call::COUNT; ii++) {
+        total += _counts[ii];
+    }
+    return total;
+}
+
+/**
+ * Returns a short name for the given call category.
+ *
+ * @param call  The call category
+ *
+ * @return a short name for the given call category.
+ */
+const char* GLRecorder::getName(Call call) {
+    return CALL_NAMES[(int)call];
+}
+
+/**
+ * Returns a summary of the nonzero counts for logging.
+ *
+ * @return a summary of the nonzero counts for logging.
+ */
+std::string GLRecorder::toString() {
+    std::stringstream ss;
+    ss << getTotal() << " calls";
+    for(int ii = 0; ii < (int)Call::COUNT; ii++) {
+        if (_counts[ii]) {
+            ss << ", " << CALL_NAMES[ii] << " " << _counts[ii];
+        }
+    }
+    return ss.str();
+}
@@ -33,6 +33,7 @@
 #include <cugl/util/CUStrings.h>
 #include <cugl/render/CUShader.h>
 #include <cugl/render/CUTexture.h>
+#include <algorithm>
 
 using namespace cugl;
 
@@ -131,11 +132,14 @@ void Shader::dispose() {
     _attribtypes.clear();
     _attribnames.clear();
     _attribsizes.clear();
+    _attriblocs.clear();
     _uniformtypes.clear();
     _uniformnames.clear();
     _uniformsizes.clear();
+    _uniformlocs.clear();
     _uniblocknames.clear();
     _uniblocksizes.clear();
+    _uniblockindices.clear();
     _uniblockfields.clear();
 }
 
@@ -224,8 +228,29 @@ void Shader::logProgramError( GLuint program ) {
     delete[] infoLog;
 }
 
+/**
+ * Returns the name of an array variable without its trailing [0]
+ *
+ * OpenGL reports array variables with a [0] suffix, but they are usually
+ * referred to without it.  If name is not an array, this returns name.
+ *
+ * @param name  The variable name reported by OpenGL
+ *
+ * @return the name of an array variable without its trailing [0]
+ */
+static std::string strip_array(const std::string& name) {
+    size_t len = name.size();
+    if (len > 3 && name.compare(len-3,3,"[0]") == 0) {
+        return name.substr(0,len-3);
+    }
+    return name;
+}
+
 /**
  * Querys all of the shader attributes and caches them for fast look-ups
+ *
+ * This resolves the attribute locations, so that they never need to be
+ * looked up by name again.
  */
 void Shader::cacheAttributes() {
     GLint count;
@@ -233,19 +258,21 @@ void Shader::cacheAttributes() {
     GLint size;     // size of the variable
     GLenum type;    // type of the variable (float, vec3 or mat4, etc)
 
-    const GLsizei bufSize = 16; // maximum name length
-    GLchar name[bufSize];       // variable name in GLSL
-    GLsizei length;             // name length
+    GLint bufSize;  // maximum name length
+    GLsizei length; // name length
     
+    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &bufSize);
+    std::vector<GLchar> name(bufSize > 0 ? bufSize : 1,0);
     glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveAttrib(_program, ii, bufSize, &length, &size, &type, name);
+        glGetActiveAttrib(_program, ii, (GLsizei)name.size(), &length, &size, &type, name.data());
         GLenum error = glGetError();
         if (!error) {
-            std::string key(name);
+            std::string key(name.data(),length);
             _attribtypes[key] = type;
             _attribsizes[key] = size;
             _attribnames[ii] = key;
+            _attriblocs[key] = glGetAttribLocation(_program, key.c_str());
         }
     }
 }
@@ -253,7 +280,9 @@ void Shader::cacheAttributes() {
 /**
  * Querys all of the shader uniforms and caches them for fast look-ups
  *
- * This includes uniform buffer blocks as well.
+ * This includes uniform buffer blocks as well.  This resolves the uniform
+ * locations and block indices, so that they never need to be looked up by
+ * name again.
  */
 void Shader::cacheUniforms() {
     GLint count;
@@ -261,31 +290,45 @@ void Shader::cacheUniforms() {
     GLint size;     // size of the variable
     GLenum type;    // type of the variable (float, vec3 or mat4, etc)
 
-    const GLsizei bufSize = 16; // maximum name length
-    GLchar name[bufSize];       // variable name in GLSL
-    GLsizei length;             // name length
+    GLint bufSize;  // maximum name length
+    GLint blockSize;
+    GLsizei length; // name length
+    
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &bufSize);
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &blockSize);
+    bufSize = std::max(std::max(bufSize,blockSize),1);
+    std::vector<GLchar> name(bufSize,0);
     
     glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveUniform(_program, ii, bufSize, &length, &size, &type, name);
+        glGetActiveUniform(_program, ii, bufSize, &length, &size, &type, name.data());
         GLenum error = glGetError();
         if (!error) {
-            std::string key(name);
+            std::string key(name.data(),length);
             _uniformtypes[key] = type;
             _uniformsizes[key] = size;
             _uniformnames[ii]  = key;
+            
+            // Uniforms in a block have no location
+            GLint locale = glGetUniformLocation(_program, key.c_str());
+            _uniformlocs[key] = locale;
+            std::string base = strip_array(key);
+            if (base != key) {
+                _uniformlocs[base] = locale;
+            }
         }
     }
     
     glGetProgramiv(_program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveUniformBlockName(_program, ii, bufSize, &length, name);
+        glGetActiveUniformBlockName(_program, ii, bufSize, &length, name.data());
         GLenum error = glGetError();
         if (!error) {
-            std::string key(name);
+            std::string key(name.data(),length);
             glGetActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
             _uniblocksizes[key] = size;
             _uniblocknames[ii]  = key;
+            _uniblockindices[key] = ii;
             
             // Link the block to uniforms
             glGetActiveUniformBlockiv(_program, ii, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &size);
@@ -299,6 +342,23 @@ void Shader::cacheUniforms() {
     }
 }
 
+/**
+ * Returns the index of the given uniform block
+ *
+ * If name is not a valid uniform block, this method returns GL_INVALID_INDEX.
+ *
+ * @param name  The uniform block name
+ *
+ * @return the index of the given uniform block
+ */
+GLuint Shader::getUniformBlockIndex(const std::string& name) const {
+    auto search = _uniblockindices.find(name);
+    if (search == _uniblockindices.end()) {
+        return GL_INVALID_INDEX;
+    }
+    return search->second;
+}
+
 
 #pragma mark -
 #pragma mark Binding
@@ -390,7 +450,33 @@ std::vector<std::string> Shader::getAttributes() const {
  * @return the program offset of the given attribute
  */
 GLint Shader::getAttributeLocation(const std::string name) const {
-    return glGetAttribLocation(_program,name.c_str());
+    auto search = _attriblocs.find(name);
+    if (search == _attriblocs.end()) {
+        return -1;
+    }
+    return search->second;
+}
+
+/**
+ * Returns a handle to the given attribute
+ *
+ * The handle is resolved when the shader is linked, and remains valid
+ * for the lifetime of this shader. If name is not a valid attribute, the
+ * handle has location -1.
+ *
+ * @param name  The attribute variable name
+ *
+ * @return a handle to the given attribute
+ */
+Shader::Attribute Shader::getAttributeHandle(const std::string name) const {
+    Attribute result;
+    auto search = _attriblocs.find(name);
+    if (search != _attriblocs.end()) {
+        result.location = search->second;
+        result.type = _attribtypes.at(name);
+        result.size = _attribsizes.at(name);
+    }
+    return result;
 }
 
 /**
@@ -476,7 +562,40 @@ std::vector<std::string> Shader::getUniforms() const {
  * @return the program offset of the given uniform
  */
 GLint Shader::getUniformLocation(const std::string name) const {
-    return glGetUniformLocation(_program,name.c_str());
+    auto search = _uniformlocs.find(name);
+    if (search != _uniformlocs.end()) {
+        return search->second;
+    } else if (name.find('[') != std::string::npos) {
+        // Later array elements are not cached
+        return glGetUniformLocation(_program,name.c_str());
+    }
+    return -1;
+}
+
+/**
+ * Returns a handle to the given uniform
+ *
+ * The handle is resolved when the shader is linked, and remains valid
+ * for the lifetime of this shader.  Classes that set the same uniform
+ * every frame should acquire a handle once and pass it to the setters
+ * instead of the name. If name is not a valid uniform, the handle has
+ * location -1.
+ *
+ * @param name  The uniform variable name
+ *
+ * @return a handle to the given uniform
+ */
+Shader::Uniform Shader::getUniformHandle(const std::string name) const {
+    Uniform result;
+    auto search = _uniformlocs.find(name);
+    if (search != _uniformlocs.end()) {
+        // Array uniforms are recorded under their [0] name
+        std::string key = (_uniformtypes.find(name) == _uniformtypes.end() ? name+"[0]" : name);
+        result.location = search->second;
+        result.type = _uniformtypes.at(key);
+        result.size = _uniformsizes.at(key);
+    }
+    return result;
 }
 
 /**
@@ -549,11 +668,11 @@ std::vector<std::string> Shader::getSamplers() const {
  * @return the program offset of the given sampler variable
  */
 GLint Shader::getSamplerLocation(const std::string name) const {
-    GLint result =  glGetUniformLocation(_program,name.c_str());
-    if (result != -1 && _uniformtypes.at(name) != GL_SAMPLER_2D) {
-        result = -1;
+    auto search = _uniformtypes.find(name);
+    if (search == _uniformtypes.end() || search->second != GL_SAMPLER_2D) {
+        return -1;
     }
-    return result;
+    return getUniformLocation(name);
 }
 
 /**
@@ -731,7 +850,7 @@ std::vector<std::string> Shader::getUniformsForBlock(GLint pos) const {
  */
 std::vector<std::string> Shader::getUniformsForBlock(std::string name) const {
     std::vector<std::string> result;
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = getUniformBlockIndex(name);
     if (index == GL_INVALID_INDEX) {
         return result;
     }
@@ -774,7 +893,7 @@ void Shader::setUniformBlock(GLint pos, GLuint bindpoint) {
  * @param bpoint   The bindpoint for the uniform block
  */
 void Shader::setUniformBlock(const std::string name, GLuint bindpoint) {
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = getUniformBlockIndex(name);
     if (index != GL_INVALID_INDEX) {
         glUniformBlockBinding(_program, index, bindpoint);
     }
@@ -852,7 +971,7 @@ void Shader::setUniformBlock(GLint pos, const std::shared_ptr<UniformBuffer>& bu
  */
 void Shader::setUniformBlock(const std::string name,
                              const std::shared_ptr<UniformBuffer>& buffer) {
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = getUniformBlockIndex(name);
     if (index != GL_INVALID_INDEX) {
         setUniformBlock(index, buffer);
     }
@@ -887,7 +1006,7 @@ GLuint Shader::getUniformBlock(GLint pos) const {
  * @return the buffer bindpoint associated with the given uniform block.
  */
 GLuint Shader::getUniformBlock(const std::string name) const {
-    GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+    GLuint index = getUniformBlockIndex(name);
     if (index == GL_INVALID_INDEX) {
         return 0;
     }
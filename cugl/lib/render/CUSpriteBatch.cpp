@@ -313,7 +313,8 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
     
     _shader = shader;
     
-    _vertbuff = VertexBuffer::alloc(sizeof(SpriteVertex3));
+    // Stream into a ring with room for several batches in flight
+    _vertbuff = VertexBuffer::allocWithStream(sizeof(SpriteVertex3),capacity,capacity*3);
     _vertbuff->setupAttribute("aPosition", 3, GL_FLOAT, GL_FALSE, 0);
     _vertbuff->setupAttribute("aColor",    4, GL_FLOAT, GL_TRUE,
                             offsetof(cugl::SpriteVertex3,color));
@@ -342,6 +343,9 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
     _unifbuff->setOffset("gdFeathr", 156);
 
     _shader->setUniformBlock("uContext",_unifbuff);
+    _uType = _shader->getUniformHandle("uType");
+    _uPerspective = _shader->getUniformHandle("uPerspective");
+    _uBlur = _shader->getUniformHandle("uBlur");
     
     _context = new Context();
     _context->dirty = DIRTY_ALL_VALS;
@@ -385,6 +389,9 @@ void SpriteBatch::setShader(const std::shared_ptr<Shader>& shader) {
     _shader = shader;
     _vertbuff->attach(_shader);
     _shader->setUniformBlock("uContext", _unifbuff);
+    _uType = _shader->getUniformHandle("uType");
+    _uPerspective = _shader->getUniformHandle("uPerspective");
+    _uBlur = _shader->getUniformHandle("uBlur");
 }
 
 
@@ -724,6 +731,7 @@ void SpriteBatch::begin() {
     _active = true;
     _callTotal = 0;
     _vertTotal = 0;
+    _vertbuff->resetStats();
 }
 
 /**
@@ -754,9 +762,9 @@ void SpriteBatch::flush() {
         record();
     }
     
-    // Load all the vertex data at once
-    _vertbuff->loadVertexData(_vertData, _vertSize);
-    _vertbuff->loadIndexData(_indxData, _indxSize);
+    // Stream all the vertex data at once
+    GLuint base = _vertbuff->streamVertexData(_vertData, _vertSize);
+    GLuint offset = _vertbuff->streamIndexData(_indxData, _indxSize, base);
     _unifbuff->activate();
     _unifbuff->flush();
     
@@ -782,10 +790,10 @@ void SpriteBatch::flush() {
             }
         }
         if (next->dirty & DIRTY_DRAWTYPE) {
-             _shader->setUniform1i("uType", next->type);
+             _shader->setUniform1i(_uType, next->type);
         }
         if (next->dirty & DIRTY_PERSPECTIVE) {
-            _shader->setUniformMat4("uPerspective",*(next->perspective.get()));
+            _shader->setUniformMat4(_uPerspective,*(next->perspective.get()));
         }
         if (next->dirty & DIRTY_TEXTURE) {
             previous = next->texture;
@@ -800,7 +808,7 @@ void SpriteBatch::flush() {
             blurTexture(next->texture,next->blurstep);
         }
         GLuint amt = next->last-next->first;
-        _vertbuff->draw(next->command, amt, next->first);
+        _vertbuff->draw(next->command, amt, next->first+offset);
         _callTotal++;
     }
     
@@ -817,6 +825,32 @@ void SpriteBatch::flush() {
 }
 
 
+/**
+ * Returns the number of bytes of vertex data uploaded in the latest pass (so far).
+ *
+ * This includes both vertices and indices.  This value will be reset to 0
+ * whenever begin() is called.
+ *
+ * @return the number of bytes of vertex data uploaded in the latest pass (so far).
+ */
+Uint64 SpriteBatch::getBytesUploaded() const {
+    return _vertbuff->getBytesUploaded();
+}
+
+/**
+ * Returns the number of vertex buffer allocations in the latest pass (so far).
+ *
+ * A sprite batch streams its vertices into a ring that is allocated once,
+ * so this value should always be 0.  It will be reset to 0 whenever
+ * begin() is called.
+ *
+ * @return the number of vertex buffer allocations in the latest pass (so far).
+ */
+Uint32 SpriteBatch::getBufferReallocations() const {
+    return _vertbuff->getReallocations();
+}
+
+
 #pragma mark -
 #pragma mark Solid Shapes
 /**
@@ -1100,6 +1134,93 @@ void SpriteBatch::fill(const Mesh<SpriteVertex2>& mesh, const Mat4& transform, b
     prepare(mesh,transform,tint);
 }
 
+/**
+ * Fills the given mesh with the current texture, offsetting its texture coordinates.
+ *
+ * This method is identical to {@link fill(const Mesh<SpriteVertex2>&, const Mat4&, bool)}
+ * except that texoffset is added to the texture coordinates of every vertex
+ * as it is copied into the vertex buffer. The mesh itself is not modified.
+ * This allows a sprite sheet to select its frame per draw, without any
+ * changes to its geometry. As the offset is baked into the vertices, it
+ * does not break the batch the way a uniform would.
+ *
+ * @param mesh      The sprite mesh
+ * @param transform The coordinate transform
+ * @param texoffset The offset to add to each texture coordinate
+ * @param tint      Whether to tint with the active color
+ */
+void SpriteBatch::fill(const Mesh<SpriteVertex2>& mesh, const Mat4& transform, const Vec2 texoffset, bool tint) {
+    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not triangulated properly.");
+    setCommand(GL_TRIANGLES);
+    prepare(mesh,transform,tint,texoffset);
+}
+
+/**
+ * Fills the given mesh with the current texture and/or gradient.
+ *
+ * This method is identical to {@link fill(const Mesh<SpriteVertex2>&, const Mat4&, bool)}
+ * except that the transform is a 2d affine map. Each vertex is then
+ * transformed with 4 multiplies instead of a full matrix product, and
+ * given the current depth. This is the fast path for a planar scene graph.
+ *
+ * @param mesh      The sprite mesh
+ * @param transform The coordinate transform
+ * @param tint      Whether to tint with the active color
+ */
+void SpriteBatch::fill(const Mesh<SpriteVertex2>& mesh, const Affine2& transform, bool tint) {
+    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not triangulated properly.");
+    setCommand(GL_TRIANGLES);
+    prepare(mesh,transform,tint);
+}
+
+/**
+ * Fills the given mesh with the current texture, offsetting its texture coordinates.
+ *
+ * This method is identical to {@link fill(const Mesh<SpriteVertex2>&, const Mat4&, const Vec2, bool)}
+ * except that the transform is a 2d affine map. Each vertex is then
+ * transformed with 4 multiplies instead of a full matrix product, and
+ * given the current depth. This is the fast path for a planar scene graph.
+ *
+ * @param mesh      The sprite mesh
+ * @param transform The coordinate transform
+ * @param texoffset The offset to add to each texture coordinate
+ * @param tint      Whether to tint with the active color
+ */
+void SpriteBatch::fill(const Mesh<SpriteVertex2>& mesh, const Affine2& transform, const Vec2 texoffset, bool tint) {
+    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not triangulated properly.");
+    setCommand(GL_TRIANGLES);
+    prepare(mesh,transform,tint,texoffset);
+}
+
+/**
+ * Fills a copy of the given mesh for each instance with the current texture.
+ *
+ * Each copy is scaled and rotated about the pivot, and then moved so that
+ * the pivot is at the instance position (as if the mesh were a child node
+ * with the pivot as its anchor). The copies are then transformed by the
+ * given transform. The mesh vertices use their own color values, multiplied
+ * by the instance color. If tint is true, these values are also tinted by
+ * the current active color.
+ *
+ * All of the copies are expanded into the vertex buffer in one pass, with
+ * the transform folded into a 2d affine map per instance. This is much
+ * cheaper than filling the mesh once per instance. The mesh must fit in
+ * the vertex buffer.
+ *
+ * @param mesh      The sprite mesh
+ * @param instances The instance placements
+ * @param count     The number of instances
+ * @param pivot     The point of the mesh placed at each instance position
+ * @param transform The coordinate transform
+ * @param tint      Whether to tint with the active color
+ */
+void SpriteBatch::fill(const Mesh<SpriteVertex2>& mesh, const SpriteInstance* instances, size_t count,
+                       const Vec2 pivot, const Mat4& transform, bool tint) {
+    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not triangulated properly.");
+    setCommand(GL_TRIANGLES);
+    prepare(mesh,instances,count,pivot,transform,tint);
+}
+
 /**
  * Fills the given mesh with the current texture and/or gradient.
  *
@@ -1412,6 +1533,23 @@ void SpriteBatch::outline(const Mesh<SpriteVertex2>& mesh, const Mat4& transform
     prepare(mesh,transform,tint);
 }
 
+/**
+ * Outlines the given mesh with the current texture and/or gradient.
+ *
+ * This method is identical to {@link outline(const Mesh<SpriteVertex2>&, const Mat4&, bool)}
+ * except that the transform is a 2d affine map. Each vertex is then
+ * transformed with 4 multiplies instead of a full matrix product, and
+ * given the current depth. This is the fast path for a planar scene graph.
+ *
+ * @param mesh      The sprite mesh
+ * @param transform The coordinate transform
+ * @param tint      Whether to tint with the active color
+ */
+void SpriteBatch::outline(const Mesh<SpriteVertex2>& mesh, const Affine2& transform, bool tint) {
+    setCommand(GL_LINES);
+    prepare(mesh,transform,tint);
+}
+
 /**
  * Outlines the given mesh with the current texture and/or gradient.
  *
@@ -2085,13 +2223,13 @@ void SpriteBatch::setUniformBlock(Context* context, bool tint) {
  */
 void SpriteBatch::blurTexture(const std::shared_ptr<Texture>& texture, GLuint step) {
     if (texture == nullptr) {
-        _shader->setUniform2f("uBlur", 0, 0);
+        _shader->setUniform2f(_uBlur, 0, 0);
         return;
     }
     Size size = texture->getSize();
     size.width  = step/size.width;
     size.height = step/size.height;
-    _shader->setUniform2f("uBlur",size.width,size.height);
+    _shader->setUniform2f(_uBlur,size.width,size.height);
 }
 
 /**
@@ -2543,16 +2681,18 @@ unsigned int SpriteBatch::chunkify(const Poly2& poly, const Mat4& mat) {
  * If depth testing is on, all vertices will use the current sprite
  * batch depth.
  *
- * @param mesh  The mesh to add to the buffer
- * @param mat   The transform to apply to the vertices
- * @param tint  Whether to tint with the active color
+ * @param mesh      The mesh to add to the buffer
+ * @param mat       The transform to apply to the vertices
+ * @param tint      Whether to tint with the active color
+ * @param texoffset The offset to add to each texture coordinate
  *
  * @return the number of vertices added to the drawing buffer.
  */
-unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint) {
+unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint,
+                                  const Vec2 texoffset) {
     CUAssertLog(mesh.isSliceable(), "Sprite batches only support sliceable meshes");
     if (mesh.vertices.size() >= _vertMax || mesh.indices.size() >= _indxMax) {
-        return chunkify(mesh, mat, tint);
+        return chunkify(mesh, mat, tint, texoffset);
     } else if(_vertSize+mesh.vertices.size() > _vertMax || _indxSize+mesh.indices.size() > _indxMax) {
         flush();
     }
@@ -2562,7 +2702,7 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& m
     for(auto it = mesh.vertices.begin(); it != mesh.vertices.end(); ++it) {
         _vertData[_vertSize+ii].position = Vec3(it->position,_depth);
         _vertData[_vertSize+ii].color = it->color;
-        _vertData[_vertSize+ii].texcoord = it->texcoord;
+        _vertData[_vertSize+ii].texcoord = it->texcoord+texoffset;
         _vertData[_vertSize+ii].position *= mat;
         if (tint && _gradient == nullptr) {
             _vertData[_vertSize+ii].color *= _color;
@@ -2582,6 +2722,153 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& m
     return ii;
 }
 
+/**
+ * Returns the number of vertices added to the drawing buffer.
+ *
+ * This method adds the given mesh (both vertices and indices) to the
+ * vertex buffer, but does not draw it.  It is the 2d fast path of the
+ * matrix version, transforming each vertex by an affine map. All
+ * vertices use the current sprite batch depth.
+ *
+ * If the mesh is too large to fit in the buffer, it is drawn in chunks
+ * with the matrix version.
+ *
+ * @param mesh      The mesh to add to the buffer
+ * @param mat       The transform to apply to the vertices
+ * @param tint      Whether to tint with the active color
+ * @param texoffset The offset to add to each texture coordinate
+ *
+ * @return the number of vertices added to the drawing buffer.
+ */
+unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Affine2& mat, bool tint,
+                                  const Vec2 texoffset) {
+    CUAssertLog(mesh.isSliceable(), "Sprite batches only support sliceable meshes");
+    size_t vsize = mesh.vertices.size();
+    size_t isize = mesh.indices.size();
+    if (vsize >= _vertMax || isize >= _indxMax) {
+        return chunkify(mesh, Mat4(mat), tint, texoffset);
+    } else if(_vertSize+vsize > _vertMax || _indxSize+isize > _indxMax) {
+        flush();
+    }
+    
+    setUniformBlock(_context,tint);
+    bool shade = tint && _gradient == nullptr;
+    Vec4 active = Vec4(_color);
+    const float* m = mat.m;
+
+    SpriteVertex3* dst = _vertData+_vertSize;
+    const SpriteVertex2* src = mesh.vertices.data();
+    for(size_t ii = 0; ii < vsize; ii++) {
+        float x = src[ii].position.x;
+        float y = src[ii].position.y;
+        dst[ii].position.x = m[0]*x+m[2]*y+m[4];
+        dst[ii].position.y = m[1]*x+m[3]*y+m[5];
+        dst[ii].position.z = _depth;
+        dst[ii].color = shade ? src[ii].color*active : src[ii].color;
+        dst[ii].texcoord = src[ii].texcoord+texoffset;
+    }
+    
+    GLuint* indx = _indxData+_indxSize;
+    for(size_t ii = 0; ii < isize; ii++) {
+        indx[ii] = _vertSize+mesh.indices[ii];
+    }
+    
+    _vertSize += (unsigned int)vsize;
+    _indxSize += (unsigned int)isize;
+    _inflight = true;
+    return (unsigned int)vsize;
+}
+
+/**
+ * Returns the number of vertices added to the drawing buffer.
+ *
+ * This method adds a copy of the given mesh (both vertices and indices)
+ * for each instance to the vertex buffer, but does not draw it. It will
+ * automatically flush between copies if the buffer is full.
+ *
+ * If depth testing is on, all vertices will use the current sprite
+ * batch depth.
+ *
+ * @param mesh      The mesh to add to the buffer
+ * @param instances The instance placements
+ * @param count     The number of instances
+ * @param pivot     The point of the mesh placed at each instance position
+ * @param mat       The transform to apply to the vertices
+ * @param tint      Whether to tint with the active color
+ *
+ * @return the number of vertices added to the drawing buffer.
+ */
+unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const SpriteInstance* instances, size_t count,
+                                  const Vec2 pivot, const Mat4& mat, bool tint) {
+    CUAssertLog(mesh.isSliceable(), "Sprite batches only support sliceable meshes");
+    size_t vsize = mesh.vertices.size();
+    size_t isize = mesh.indices.size();
+    CUAssertLog(vsize < _vertMax && isize < _indxMax, "Instanced mesh does not fit in the vertex buffer");
+    if (count == 0 || vsize == 0) {
+        return 0;
+    }
+
+    setUniformBlock(_context,tint);
+    bool shade = _gradient == nullptr;
+    Vec4 active = (tint && shade) ? Vec4(_color) : Vec4::ONE;
+
+    // The transform restricted to the plane at the current depth
+    const float* m = mat.m;
+    float zx = m[8]*_depth+m[12];
+    float zy = m[9]*_depth+m[13];
+    float zz = m[10]*_depth+m[14];
+
+    unsigned int total = 0;
+    for(size_t ii = 0; ii < count; ii++) {
+        if (_vertSize+vsize > _vertMax || _indxSize+isize > _indxMax) {
+            flush();
+            setUniformBlock(_context,tint);
+        }
+        
+        // Fold pivot, rotation, scale and position into one affine map
+        const SpriteInstance& inst = instances[ii];
+        float c = inst.scale*cosf(inst.angle);
+        float s = inst.scale*sinf(inst.angle);
+        float ox = inst.position.x-(c*pivot.x-s*pivot.y);
+        float oy = inst.position.y-(s*pivot.x+c*pivot.y);
+        float a00 = m[0]*c+m[4]*s;
+        float a01 = m[4]*c-m[0]*s;
+        float a10 = m[1]*c+m[5]*s;
+        float a11 = m[5]*c-m[1]*s;
+        float a20 = m[2]*c+m[6]*s;
+        float a21 = m[6]*c-m[2]*s;
+        float tx = m[0]*ox+m[4]*oy+zx;
+        float ty = m[1]*ox+m[5]*oy+zy;
+        float tz = m[2]*ox+m[6]*oy+zz;
+        Vec4 color = inst.color*active;
+
+        // This loop stays scalar on purpose. It is bound by the 36 byte vertex
+        // writes, and an SSE version (one lane per coordinate) was no faster.
+        SpriteVertex3* dst = _vertData+_vertSize;
+        const SpriteVertex2* src = mesh.vertices.data();
+        for(size_t jj = 0; jj < vsize; jj++) {
+            float x = src[jj].position.x;
+            float y = src[jj].position.y;
+            dst[jj].position.x = a00*x+a01*y+tx;
+            dst[jj].position.y = a10*x+a11*y+ty;
+            dst[jj].position.z = a20*x+a21*y+tz;
+            dst[jj].color = shade ? src[jj].color*color : src[jj].color;
+            dst[jj].texcoord = src[jj].texcoord;
+        }
+
+        GLuint* indx = _indxData+_indxSize;
+        for(size_t jj = 0; jj < isize; jj++) {
+            indx[jj] = _vertSize+mesh.indices[jj];
+        }
+        
+        _vertSize += (unsigned int)vsize;
+        _indxSize += (unsigned int)isize;
+        total += (unsigned int)vsize;
+    }
+    _inflight = true;
+    return total;
+}
+
 /**
  * Returns the number of vertices added to the drawing buffer.
  *
@@ -2591,13 +2878,15 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& m
  * is important for avoiding memory corruption.  Unlike the perpare methods,
  * this method is guaranteed to flush, draining the vertex buffer.
  *
- * @param mesh  The mesh to add to the buffer
- * @param mat   The transform to apply to the vertices
- * @param tint  Whether to tint with the active color
+ * @param mesh      The mesh to add to the buffer
+ * @param mat       The transform to apply to the vertices
+ * @param tint      Whether to tint with the active color
+ * @param texoffset The offset to add to each texture coordinate
  *
  * @return the number of vertices added to the drawing buffer.
  */
-unsigned int SpriteBatch::chunkify(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint) {
+unsigned int SpriteBatch::chunkify(const Mesh<SpriteVertex2>& mesh, const Mat4& mat, bool tint,
+                                   const Vec2 texoffset) {
     std::unordered_map<Uint32, Uint32> offsets;
     
     setUniformBlock(_context,tint);
@@ -2618,7 +2907,7 @@ unsigned int SpriteBatch::chunkify(const Mesh<SpriteVertex2>& mesh, const Mat4&
                 _indxData[_indxSize] = _vertSize;
                 _vertData[_vertSize].position = Vec3(mesh.vertices[ii+jj].position,_depth);
                 _vertData[_vertSize].color = mesh.vertices[ii+jj].color;
-                _vertData[_vertSize].texcoord = mesh.vertices[ii+jj].texcoord;
+                _vertData[_vertSize].texcoord = mesh.vertices[ii+jj].texcoord+texoffset;
                 _vertData[_vertSize].position *= mat;
                 if (tint && _gradient == nullptr) {
                     _vertData[_vertSize].color *= _color;
@@ -606,8 +606,7 @@ void Texture::setBindPoint(GLuint point) {
     if (orig != _bindpoint+GL_TEXTURE0) {
         glActiveTexture(orig);
     }
-    GLenum error = glGetError();
-    CUAssertLog(error == GL_NO_ERROR, "Texture: %s", gl_error_name(error).c_str());
+    CUAssertGLError("Texture");
     _bindpoint = point;
 }
 
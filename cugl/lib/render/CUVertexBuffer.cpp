@@ -33,9 +33,14 @@
 #include <cugl/render/CUVertexBuffer.h>
 #include <cugl/render/CUShader.h>
 #include <cugl/render/CUTexture.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace cugl;
 
+/** The nanoseconds to wait on a fence before checking it again */
+#define FENCE_TIMEOUT   1000000
+
 #pragma mark Constructors
 /**
  * Creates an uninitialized vertex buffer.
@@ -46,7 +51,13 @@ VertexBuffer::VertexBuffer() :
 _vertArray(0),
 _vertBuffer(0),
 _indxBuffer(0),
-_stride(0) {
+_stride(0),
+_regions(0),
+_mapping(true),
+_bytesUploaded(0),
+_reallocations(0),
+_wraps(0),
+_stalls(0) {
     _shader = nullptr;
 }
 
@@ -113,6 +124,10 @@ void VertexBuffer::dispose() {
     }
     _enabled.clear();
     _attributes.clear();
+    clear(_vertRing);
+    clear(_indxRing);
+    _regions = 0;
+    _scratch.clear();
     glDeleteBuffers(1,&_indxBuffer);
     glDeleteBuffers(1,&_vertBuffer);
     glDeleteVertexArrays(1,&_vertArray);
@@ -124,6 +139,58 @@ void VertexBuffer::dispose() {
 }
 
 
+/**
+ * Initializes this vertex buffer as a streaming ring with the given stride.
+ *
+ * A streaming vertex buffer allocates its vertex and index buffers once,
+ * with room for the given number of regions.  Each region holds the given
+ * number of vertices and indices.  Data is then added with the methods
+ * {@link streamVertexData} and {@link streamIndexData}, which write each
+ * block after the last one and return its offset.  Nothing is ever
+ * reallocated, and a region is only overwritten once the GPU has finished
+ * drawing from it.  Regions are typically sized to a single batch, so
+ * that several batches (or frames) may be in flight at once.
+ *
+ * A streaming buffer must not be used with {@link loadVertexData} or
+ * {@link loadIndexData}.
+ *
+ * @param stride    The size of a single piece of vertex data.
+ * @param vertices  The number of vertices in each region
+ * @param indices   The number of indices in each region
+ * @param regions   The number of regions
+ *
+ * @return true if initialization was successful.
+ */
+bool VertexBuffer::initWithStream(GLsizei stride, GLsizei vertices, GLsizei indices, Uint32 regions) {
+    CUAssertLog(stride > 0, "Streaming requires a positive stride");
+    CUAssertLog(regions > 1, "Streaming requires at least two regions");
+    if (!init(stride)) {
+        return false;
+    }
+    
+    _vertRing.target = GL_ARRAY_BUFFER;
+    _vertRing.capacity = (GLsizeiptr)stride*vertices*regions;
+    _indxRing.target = GL_ELEMENT_ARRAY_BUFFER;
+    _indxRing.capacity = (GLsizeiptr)sizeof(GLuint)*indices*regions;
+    for(RingData* ring : { &_vertRing, &_indxRing }) {
+        ring->head = 0;
+        ring->pending = 0;
+        ring->fences.assign(regions,nullptr);
+    }
+    _regions = regions;
+    
+    // The only allocations this buffer will ever make
+    glBindVertexArray(_vertArray);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertBuffer);
+    glBufferData(GL_ARRAY_BUFFER, _vertRing.capacity, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indxBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indxRing.capacity, NULL, GL_STREAM_DRAW);
+    CUAssertGLError("VertexBuffer");
+    resetStats();
+    return true;
+}
+
+
 #pragma mark -
 #pragma mark Binding
 /**
@@ -185,7 +252,7 @@ void VertexBuffer::attach(const std::shared_ptr<Shader>& shader) {
         // Link up attributes on the first time
         for(auto it = _attributes.begin(); it != _attributes.end(); ++it) {
             std::string name = it->first;
-			GLint pos = glGetAttribLocation(_shader->getProgram(), name.c_str());
+			GLint pos = _shader->getAttributeLocation(name);
 			if (pos == -1) {
 				CUWarn("Active shader has no attribute %s", name.c_str());
 			} else if (_enabled[name]) {
@@ -198,8 +265,7 @@ void VertexBuffer::attach(const std::shared_ptr<Shader>& shader) {
 			}
         }
 
-        GLenum error = glGetError();
-        CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+        CUAssertGLError("VertexBuffer");
     } else {
         bind();
     }
@@ -260,10 +326,12 @@ bool VertexBuffer::isBound() const {
  */
 void VertexBuffer::loadVertexData(const void * data, GLsizei size, GLenum usage) {
     //CUAssertLog(isBound(), "Vertex buffer is not bound"); // Problems on android emulator for now
+    CUAssertLog(!isStreaming(), "Streaming buffers cannot be reloaded");
     glBufferData( GL_ARRAY_BUFFER, _stride * size, data, usage );
+    _bytesUploaded += (Uint64)_stride * size;
+    _reallocations++;
     
-    GLenum error = glGetError();
-    CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+    CUAssertGLError("VertexBuffer");
 }
 
 /**
@@ -294,9 +362,216 @@ void VertexBuffer::loadVertexData(const void * data, GLsizei size, GLenum usage)
  */
 void VertexBuffer::loadIndexData(const void * data, GLsizei size, GLenum usage) {
     //CUAssertLog(isBound(), "Vertex buffer is not bound"); // Problems on android emulator for now
+    CUAssertLog(!isStreaming(), "Streaming buffers cannot be reloaded");
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, size * sizeof(GLuint), data, usage );
-    GLenum error = glGetError();
-    CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+    _bytesUploaded += (Uint64)size * sizeof(GLuint);
+    _reallocations++;
+    CUAssertGLError("VertexBuffer");
+}
+
+
+#pragma mark -
+#pragma mark Streaming
+/**
+ * Returns the byte offset of a new block in the given ring.
+ *
+ * This method places fences on every region behind the new block, and
+ * waits for the GPU to release any region that the block overlaps.
+ * If the block does not fit at the end of the ring, it wraps around to
+ * the start.
+ *
+ * @param ring  The streaming ring
+ * @param size  The size of the block in bytes
+ * @param align The alignment of the block in bytes
+ *
+ * @return the byte offset of a new block in the given ring.
+ */
+GLsizeiptr VertexBuffer::reserve(RingData& ring, GLsizeiptr size, GLsizeiptr align) {
+    CUAssertLog(size <= ring.capacity, "Block of %ld bytes exceeds the ring", (long)size);
+    GLsizeiptr region = ring.capacity/_regions;
+    GLsizeiptr start = ((ring.head+align-1)/align)*align;
+    if (start+size > ring.capacity) {
+        // Everything written this lap has been drawn
+        fence(ring, ring.pending, _regions);
+        ring.pending = 0;
+        start = 0;
+        _wraps++;
+    }
+    
+    Uint32 first = (Uint32)(start/region);
+    Uint32 last  = (Uint32)std::min((start+size-1)/region,(GLsizeiptr)_regions-1);
+    fence(ring, ring.pending, first);
+    ring.pending = first;
+    
+    // Wait for the GPU to finish with any region we overwrite
+    for(Uint32 ii = first; ii <= last; ii++) {
+        GLsync sync = ring.fences[ii];
+        if (sync == nullptr) {
+            continue;
+        }
+        GLenum status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            _stalls++;
+            do {
+                status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(sync);
+        ring.fences[ii] = nullptr;
+    }
+    
+    ring.head = start+size;
+    return start;
+}
+
+/**
+ * Places a fence on the given regions of the ring
+ *
+ * @param ring  The streaming ring
+ * @param start The first region to fence
+ * @param end   The region after the last one to fence
+ */
+void VertexBuffer::fence(RingData& ring, Uint32 start, Uint32 end) {
+    if (start >= end) {
+        return;
+    }
+    // Regions skipped at a wrap may still hold an older fence
+    for(Uint32 ii = start; ii < end; ii++) {
+        if (ring.fences[ii] != nullptr) {
+            glDeleteSync(ring.fences[ii]);
+            ring.fences[ii] = nullptr;
+        }
+    }
+    // One fence covers every command issued so far.  The regions are reused
+    // in order, so it suffices to attach it to the first of them.
+    ring.fences[start] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/**
+ * Deletes all fences of the given ring
+ *
+ * @param ring  The streaming ring
+ */
+void VertexBuffer::clear(RingData& ring) {
+    for(auto it = ring.fences.begin(); it != ring.fences.end(); ++it) {
+        if (*it != nullptr) {
+            glDeleteSync(*it);
+        }
+    }
+    ring.fences.clear();
+    ring.capacity = 0;
+    ring.head = 0;
+    ring.pending = 0;
+}
+
+/**
+ * Returns the index of the first vertex after streaming the given data.
+ *
+ * The vertices are written after those of the previous call, wrapping
+ * around to the start of the ring when necessary.  The result is the
+ * position of the first vertex in the ring, which must be added to the
+ * indices that refer to these vertices (see {@link streamIndexData}).
+ *
+ * The number of vertices may not exceed the size of the ring.  This
+ * method will only succeed if this buffer is actively bound.
+ *
+ * @param data  The data to stream
+ * @param size  The number of vertices to stream
+ *
+ * @return the index of the first vertex after streaming the given data.
+ */
+GLsizei VertexBuffer::streamVertexData(const void * data, GLsizei size) {
+    CUAssertLog(isStreaming(), "Vertex buffer is not streaming");
+    GLsizeiptr bytes = (GLsizeiptr)_stride*size;
+    GLsizeiptr start = reserve(_vertRing, bytes, _stride);
+    if (_mapping) {
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, start, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst != nullptr) {
+            std::memcpy(dst, data, bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            CUWarn("VertexBuffer: buffer mapping failed, falling back to glBufferSubData");
+            _mapping = false;
+            // Clear the error from the failed map so the check below does not report it
+            glGetError();
+        }
+    }
+    if (!_mapping) {
+        glBufferSubData(GL_ARRAY_BUFFER, start, bytes, data);
+    }
+    _bytesUploaded += bytes;
+    CUAssertGLError("VertexBuffer");
+    return (GLsizei)(start/_stride);
+}
+
+/**
+ * Returns the position of the first index after streaming the given data.
+ *
+ * The indices are written after those of the previous call, wrapping
+ * around to the start of the ring when necessary.  Each index is offset
+ * by base as it is written, so that it refers to vertices streamed by
+ * {@link streamVertexData}.  The result should be added to the offset
+ * of any draw call using these indices.
+ *
+ * The number of indices may not exceed the size of the ring.  This
+ * method will only succeed if this buffer is actively bound.
+ *
+ * @param data  The indices to stream
+ * @param size  The number of indices to stream
+ * @param base  The position of the first vertex
+ *
+ * @return the position of the first index after streaming the given data.
+ */
+GLsizei VertexBuffer::streamIndexData(const GLuint * data, GLsizei size, GLuint base) {
+    CUAssertLog(isStreaming(), "Vertex buffer is not streaming");
+    GLsizeiptr bytes = (GLsizeiptr)sizeof(GLuint)*size;
+    GLsizeiptr start = reserve(_indxRing, bytes, sizeof(GLuint));
+    if (_mapping) {
+        void* dst = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, start, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst != nullptr) {
+            // Offset the indices as they are copied
+            GLuint* indices = (GLuint*)dst;
+            for(GLsizei ii = 0; ii < size; ii++) {
+                indices[ii] = data[ii]+base;
+            }
+            glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+        } else {
+            CUWarn("VertexBuffer: buffer mapping failed, falling back to glBufferSubData");
+            _mapping = false;
+            // Clear the error from the failed map so the check below does not report it
+            glGetError();
+        }
+    }
+    if (!_mapping) {
+        if (base) {
+            _scratch.resize(size);
+            for(GLsizei ii = 0; ii < size; ii++) {
+                _scratch[ii] = data[ii]+base;
+            }
+            data = _scratch.data();
+        }
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, start, bytes, data);
+    }
+    _bytesUploaded += bytes;
+    CUAssertGLError("VertexBuffer");
+    return (GLsizei)(start/sizeof(GLuint));
+}
+
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Resets all of the statistics to zero.
+ *
+ * This is typically called at the start of a frame.
+ */
+void VertexBuffer::resetStats() {
+    _bytesUploaded = 0;
+    _reallocations = 0;
+    _wraps  = 0;
+    _stalls = 0;
 }
 
 /**
@@ -392,7 +667,7 @@ void VertexBuffer::setupAttribute(const std::string name, GLint size, GLenum typ
     
     if (_shader != nullptr) {
         _shader->bind();
-        GLint pos = glGetAttribLocation(_shader->getProgram(), name.c_str());
+        GLint pos = _shader->getAttributeLocation(name);
         if (pos == -1) {
             CUWarn("Active shader has no attribute %s", name.c_str());
         } else {
@@ -401,8 +676,7 @@ void VertexBuffer::setupAttribute(const std::string name, GLint size, GLenum typ
                                   reinterpret_cast<void*>(data.offset));
         }
         
-        GLenum error = glGetError();
-        CUAssertLog(error == GL_NO_ERROR, "VertexBuffer: %s", gl_error_name(error).c_str());
+        CUAssertGLError("VertexBuffer");
     }
 }
 
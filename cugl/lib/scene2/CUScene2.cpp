@@ -61,7 +61,8 @@ _color(Color4::WHITE),
 _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
-_active(false)
+_active(false),
+_planar(false)
 {}
 
 /**
@@ -76,6 +77,7 @@ void Scene2::dispose() {
     _name = "";
     _color = Color4::WHITE;
     _active = false;
+    _planar = false;
 }
 
 /**
@@ -418,8 +420,14 @@ void Scene2::render(const std::shared_ptr<SpriteBatch>& batch) {
     batch->setBlendFunc(_srcFactor, _dstFactor);
     batch->setBlendEquation(_blendEquation);
 
-    for(auto it = _children.begin(); it != _children.end(); ++it) {
-        (*it)->render(batch, Mat4::IDENTITY, _color);
+    if (_planar) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->render(batch, Affine2::IDENTITY, _color);
+        }
+    } else {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->render(batch, Mat4::IDENTITY, _color);
+        }
     }
 
     batch->end();
@@ -0,0 +1,281 @@
+//
+//  CUAnimationClock.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a central clock for sprite sheet animation.  Rather
+//  than having every AnimationNode count frames in its own draw method, the
+//  nodes register a track with a shared clock.  The clock stores the tracks
+//  contiguously and advances all of them in a single pass once per frame.
+//  Because an AnimationNode picks its frame with a texture offset at draw
+//  time, advancing a track never touches any geometry.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/scene2/graph/CUAnimationClock.h>
+#include <cugl/scene2/graph/CUAnimationNode.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+
+using namespace cugl;
+using namespace cugl::scene2;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a clock with no tracks.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a clock on
+ * the heap, use one of the static constructors instead.
+ */
+AnimationClock::AnimationClock() :
+_ticks(0) {
+}
+
+/**
+ * Disposes this clock, releasing all resources.
+ *
+ * All of the tracks are removed.  You should detach every node from the
+ * clock before disposing it.
+ */
+void AnimationClock::dispose() {
+    _tracks.clear();
+    _slots.clear();
+    _freekeys.clear();
+    _ticks = 0;
+}
+
+/**
+ * Initializes a clock with room for the given number of tracks.
+ *
+ * The clock will grow beyond this capacity if necessary.
+ *
+ * @param capacity  The number of tracks to reserve
+ *
+ * @return true if initialization was successful.
+ */
+bool AnimationClock::init(size_t capacity) {
+    _tracks.reserve(capacity);
+    _slots.reserve(capacity);
+    _ticks = 0;
+    return true;
+}
+
+
+#pragma mark -
+#pragma mark Tracks
+/**
+ * Returns the track for the given key.
+ *
+ * @param key   The track key
+ *
+ * @return the track for the given key.
+ */
+AnimationClock::Track& AnimationClock::getTrack(Uint32 key) {
+    CUAssertLog(key < _slots.size() && _slots[key] != INVALID_KEY, "Track %u is not on this clock", key);
+    return _tracks[_slots[key]];
+}
+
+/**
+ * Returns the track for the given key.
+ *
+ * @param key   The track key
+ *
+ * @return the track for the given key.
+ */
+const AnimationClock::Track& AnimationClock::getTrack(Uint32 key) const {
+    CUAssertLog(key < _slots.size() && _slots[key] != INVALID_KEY, "Track %u is not on this clock", key);
+    return _tracks[_slots[key]];
+}
+
+/**
+ * Returns the key of a new (stopped) track for the given node.
+ *
+ * This method is called by {@link AnimationNode#setClock}, and should not
+ * be called directly.
+ *
+ * @param node  The node to animate
+ *
+ * @return the key of a new (stopped) track for the given node.
+ */
+Uint32 AnimationClock::add(AnimationNode* node) {
+    CUAssertLog(node != nullptr, "Cannot animate a null node");
+    Uint32 key;
+    if (_freekeys.empty()) {
+        key = (Uint32)_slots.size();
+        _slots.push_back(INVALID_KEY);
+    } else {
+        key = _freekeys.back();
+        _freekeys.pop_back();
+    }
+
+    Track track;
+    track.node = node;
+    track.key  = key;
+    track.first = 0;
+    track.last  = 0;
+    track.step  = 1;
+    track.interval = 1;
+    track.counter  = 0;
+    track.mode = Mode::LOOP;
+    track.playing  = false;
+    track.finished = false;
+
+    _slots[key] = (Uint32)_tracks.size();
+    _tracks.push_back(track);
+    return key;
+}
+
+/**
+ * Removes the track with the given key.
+ *
+ * This method is called when an {@link AnimationNode} is disposed, and
+ * should not be called directly.
+ *
+ * @param key   The track key
+ */
+void AnimationClock::remove(Uint32 key) {
+    CUAssertLog(key < _slots.size() && _slots[key] != INVALID_KEY, "Track %u is not on this clock", key);
+    Uint32 index = _slots[key];
+    Uint32 back  = (Uint32)_tracks.size()-1;
+    if (index != back) {
+        _tracks[index] = _tracks[back];
+        _slots[_tracks[index].key] = index;
+    }
+    _tracks.pop_back();
+    _slots[key] = INVALID_KEY;
+    _freekeys.push_back(key);
+}
+
+/**
+ * Starts playing the given track.
+ *
+ * The track starts from the current frame of its node, clamped to the
+ * range.  A BOUNCE track starting at the last frame plays backwards.
+ *
+ * @param key       The track key
+ * @param first     The first frame of the range
+ * @param last      The last frame of the range (inclusive)
+ * @param interval  The number of ticks between frames
+ * @param mode      The playback mode
+ */
+void AnimationClock::play(Uint32 key, int first, int last, Uint32 interval, Mode mode) {
+    CUAssertLog(first <= last, "Frame range [%d,%d] is empty", first, last);
+    Track& track = getTrack(key);
+    CUAssertLog(first >= 0 && last < track.node->getSize(), "Frame range [%d,%d] is out of bounds", first, last);
+    track.first = first;
+    track.last  = last;
+    track.interval = std::max(interval,(Uint32)1);
+    track.counter  = 0;
+    track.mode = mode;
+    track.playing  = true;
+    track.finished = false;
+
+    int frame = track.node->getFrame();
+    int clamp = std::min(std::max(frame,first),last);
+    track.step = (mode == Mode::BOUNCE && clamp >= last) ? -1 : 1;
+    if (clamp != frame) {
+        track.node->setFrame(clamp);
+    }
+}
+
+/**
+ * Stops the given track, leaving its node at the current frame.
+ *
+ * @param key   The track key
+ */
+void AnimationClock::stop(Uint32 key) {
+    Track& track = getTrack(key);
+    track.playing  = false;
+    track.finished = false;
+}
+
+
+#pragma mark -
+#pragma mark Animation
+/**
+ * Advances every playing track by the given number of ticks.
+ *
+ * This is a single pass over the track array.  A node is only told to
+ * change frame if its frame actually changes.
+ *
+ * @param ticks The number of ticks to advance
+ */
+void AnimationClock::update(Uint32 ticks) {
+    _ticks += ticks;
+    for(auto it = _tracks.begin(); it != _tracks.end(); ++it) {
+        if (!it->playing) {
+            continue;
+        }
+
+        // Count the frames that advance during these ticks
+        // A frame advances on every tick that starts with the counter at 0
+        Uint32 steps = 0;
+        if (ticks > 0) {
+            Uint32 lead = (it->counter == 0 ? 0 : it->interval-it->counter);
+            steps = (lead < ticks ? 1+(ticks-1-lead)/it->interval : 0);
+        }
+        it->counter = (Uint32)((it->counter+(Uint64)ticks) % it->interval);
+        if (steps == 0) {
+            continue;
+        }
+
+        int frame = it->node->getFrame();
+        int start = frame;
+        for(Uint32 ii = 0; ii < steps && it->playing; ii++) {
+            switch (it->mode) {
+                case Mode::LOOP:
+                    frame = (frame >= it->last ? it->first : frame+1);
+                    break;
+                case Mode::ONCE:
+                    if (frame >= it->last) {
+                        it->playing  = false;
+                        it->finished = true;
+                    } else {
+                        frame++;
+                    }
+                    break;
+                case Mode::BOUNCE:
+                    if (it->first == it->last) {
+                        break;
+                    } else if (frame+it->step > it->last || frame+it->step < it->first) {
+                        it->step = -it->step;
+                    }
+                    frame += it->step;
+                    break;
+            }
+        }
+        if (frame != start) {
+            it->node->setFrame(frame);
+        }
+    }
+}
@@ -42,6 +42,8 @@
 //  Version: 12/1/16
 //
 #include <cugl/scene2/graph/CUAnimationNode.h>
+#include <cugl/render/CUSpriteBatch.h>
+#include <cugl/render/CUGradient.h>
 
 
 using namespace cugl::scene2;
@@ -62,10 +64,29 @@ AnimationNode::AnimationNode() :
 _cols(0),
 _size(0),
 _frame(0),
-_bounds(Rect::ZERO) {
+_bounds(Rect::ZERO),
+_track(AnimationClock::INVALID_KEY) {
     _name = "AnimationNode";
 }
 
+/**
+ * Disposes all of the resources used by this node.
+ *
+ * A disposed Node can be safely reinitialized. Any children owned by this
+ * node will be released.  They will be deleted if no other object owns them.
+ *
+ * This method also removes this node from its animation clock.
+ */
+void AnimationNode::dispose() {
+    if (_clock != nullptr) {
+        _clock->remove(_track);
+        _clock = nullptr;
+        _track = AnimationClock::INVALID_KEY;
+    }
+    _base.setZero();
+    PolygonNode::dispose();
+}
+
 /**
  * Initializes the film strip with the given texture.
  *
@@ -91,6 +112,7 @@ bool AnimationNode::initWithFilmstrip(const std::shared_ptr<Texture>& texture,
     _bounds.size = texture->getSize();
     _bounds.size.width /= cols;
     _bounds.size.height /= rows;
+    _base = _bounds.origin;
     return this->initWithTexture(texture, _bounds);
 }
 
@@ -139,6 +161,7 @@ bool AnimationNode::initWithData(const Scene2Loader* loader, const std::shared_p
     _bounds.size.height /= rows;
     _bounds.origin.x = (_frame % _cols)*_bounds.size.width;
     _bounds.origin.y = _texture->getSize().height - (1+_frame/_cols)*_bounds.size.height;
+    _base = _bounds.origin;
 
     // And position it correctly
     Vec2 coord = getPosition();
@@ -156,15 +179,142 @@ bool AnimationNode::initWithData(const Scene2Loader* loader, const std::shared_p
  *
  * If the frame index is invalid, an error is raised.
  *
+ * This method does not change the polygon or the mesh.  The new frame is
+ * selected with a texture offset when the node is drawn.
+ *
  * @param frame the index to make the active frame
  */
 void AnimationNode::setFrame(int frame) {
     CUAssertLog(frame >= 0 && frame < _size, "Invalid animation frame %d", frame);
     
     _frame = frame;
-    float x = (frame % _cols)*_bounds.size.width;
-    float y = _texture->getSize().height - (1+frame/_cols)*_bounds.size.height;
-    shiftPolygon(x-_bounds.origin.x, y-_bounds.origin.y);
-    _bounds.origin.set(x,y);
+    _bounds.origin.x = (frame % _cols)*_bounds.size.width;
+    _bounds.origin.y = _texture->getSize().height - (1+frame/_cols)*_bounds.size.height;
+}
+
+
+#pragma mark -
+#pragma mark Animation Clock
+/**
+ * Sets the clock advancing this animation.
+ *
+ * The node is removed from any previous clock.  Its track on the new
+ * clock is stopped until {@link play} is called.  Subclasses may
+ * override this method to attach child nodes or to start a default
+ * animation.
+ *
+ * @param clock The clock advancing this animation (may be null)
+ */
+void AnimationNode::setClock(const std::shared_ptr<AnimationClock>& clock) {
+    if (_clock == clock) {
+        return;
+    } else if (_clock != nullptr) {
+        _clock->remove(_track);
+        _track = AnimationClock::INVALID_KEY;
+    }
+    _clock = clock;
+    if (_clock != nullptr) {
+        _track = _clock->add(this);
+    }
+}
+
+/**
+ * Plays the given range of frames on the animation clock.
+ *
+ * The animation starts at the current frame, clamped to the range.  The
+ * node must have a clock.
+ *
+ * @param first     The first frame of the range
+ * @param last      The last frame of the range (inclusive)
+ * @param interval  The number of clock ticks between frames
+ * @param mode      The playback mode
+ */
+void AnimationNode::play(int first, int last, Uint32 interval, AnimationClock::Mode mode) {
+    CUAssertLog(_clock != nullptr, "Animation node has no clock");
+    _clock->play(_track, first, last, interval, mode);
+}
+
+/**
+ * Stops this animation, leaving it at the current frame.
+ *
+ * This method does nothing if the node has no clock.
+ */
+void AnimationNode::stop() {
+    if (_clock != nullptr) {
+        _clock->stop(_track);
+    }
+}
+
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws this Node via the given SpriteBatch.
+ *
+ * This method only worries about drawing the current node.  It does not
+ * attempt to render the children.
+ *
+ * This method draws the mesh built for the original frame, and selects
+ * the active frame with a texture offset.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void AnimationNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+
+    // The same offset that shifting the polygon used to apply to the mesh
+    Vec2 offset = _bounds.origin-_base;
+    offset.x /= (float)_texture->getWidth();
+    offset.y /= -(float)_texture->getHeight();
+
+    batch->setColor(tint);
+    batch->setTexture(_texture);
+
+    if (_gradient) {
+        auto local = Gradient::alloc(_gradient);
+        batch->setGradient(local);
+    }
+    batch->setBlendEquation(_blendEquation);
+    batch->setBlendFunc(_srcFactor, _dstFactor);
+    batch->fill(_mesh, transform, offset);
+    batch->setGradient(nullptr);
+}
+
+/**
+ * Draws this Node via the given SpriteBatch with a 2d transform.
+ *
+ * This is the fast path used by a planar scene graph. It is identical
+ * to the matrix version, except that the vertices are transformed by
+ * the affine map directly.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void AnimationNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+
+    // The same offset that shifting the polygon used to apply to the mesh
+    Vec2 offset = _bounds.origin-_base;
+    offset.x /= (float)_texture->getWidth();
+    offset.y /= -(float)_texture->getHeight();
+
+    batch->setColor(tint);
+    batch->setTexture(_texture);
+
+    if (_gradient) {
+        auto local = Gradient::alloc(_gradient);
+        batch->setGradient(local);
+    }
+    batch->setBlendEquation(_blendEquation);
+    batch->setBlendFunc(_srcFactor, _dstFactor);
+    batch->fill(_mesh, transform, offset);
+    batch->setGradient(nullptr);
 }
 
@@ -0,0 +1,204 @@
+//
+//  CUInstanceNode.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a scene graph node that draws many copies of a single
+//  sprite.  Drawing a PolygonNode once per copy, with a fresh transform and
+//  color each time, sends every copy through the full sprite batch prepare
+//  path.  This node instead keeps an array of instance records (position,
+//  scale, rotation and color) and hands them to the sprite batch in a single
+//  call, which expands them into the vertex buffer in one pass.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/scene2/graph/CUInstanceNode.h>
+#include <cugl/render/CUSpriteBatch.h>
+#include <cugl/util/CUDebug.h>
+
+using namespace cugl;
+using namespace cugl::scene2;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty node with no instances.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a node on
+ * the heap, use one of the static constructors instead.
+ */
+InstanceNode::InstanceNode() : SceneNode(),
+_texture(nullptr),
+_pivot(Vec2::ANCHOR_CENTER),
+_blendEquation(GL_FUNC_ADD),
+_srcFactor(GL_SRC_ALPHA),
+_dstFactor(GL_ONE_MINUS_SRC_ALPHA) {
+    _name = "InstanceNode";
+}
+
+/**
+ * Disposes all of the resources used by this node.
+ *
+ * A disposed node can be safely reinitialized. Any children owned by
+ * this node will be released. They will be deleted if no other object
+ * owns them.
+ */
+void InstanceNode::dispose() {
+    _texture = nullptr;
+    _region = Rect::ZERO;
+    _pivot = Vec2::ANCHOR_CENTER;
+    _mesh.clear();
+    _instances.clear();
+    _blendEquation = GL_FUNC_ADD;
+    _srcFactor = GL_SRC_ALPHA;
+    _dstFactor = GL_ONE_MINUS_SRC_ALPHA;
+    SceneNode::dispose();
+}
+
+/**
+ * Initializes a node drawing copies of the given texture region.
+ *
+ * The region is in texture pixels, with the origin at the bottom left
+ * corner of the texture. The pivot is the center of the region.
+ *
+ * @param texture   The texture of the copies
+ * @param region    The texture region of the copies
+ *
+ * @return true if initialization was successful.
+ */
+bool InstanceNode::initWithTexture(const std::shared_ptr<Texture>& texture, const Rect region) {
+    if (!SceneNode::init()) {
+        return false;
+    }
+    _texture = texture;
+    setRegion(region);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Sets the texture of the copies.
+ *
+ * The region is reset to the entire texture.
+ *
+ * @param texture   The texture of the copies
+ */
+void InstanceNode::setTexture(const std::shared_ptr<Texture>& texture) {
+    _texture = texture;
+    setRegion(texture == nullptr ? Rect::ZERO : Rect(Vec2::ZERO,texture->getSize()));
+}
+
+/**
+ * Sets the texture region of the copies, in texture pixels.
+ *
+ * The origin is at the bottom left corner of the texture.
+ *
+ * @param region    The texture region of the copies
+ */
+void InstanceNode::setRegion(const Rect region) {
+    _region = region;
+    updateMesh();
+}
+
+/**
+ * Adds a copy to draw at the given position.
+ *
+ * @param position  The position of the copy pivot
+ * @param scale     The uniform scale of the copy
+ * @param angle     The counter-clockwise rotation of the copy in radians
+ * @param color     The color of the copy
+ */
+void InstanceNode::addInstance(const Vec2 position, float scale, float angle, const Color4f color) {
+    SpriteInstance instance;
+    instance.position = position;
+    instance.scale = scale;
+    instance.angle = angle;
+    instance.color = Vec4(color);
+    _instances.push_back(instance);
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws this node via the given SpriteBatch.
+ *
+ * All of the copies are drawn with a single call to the sprite batch.
+ * This method only worries about drawing the current node. It does not
+ * attempt to render the children.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void InstanceNode::draw(const std::shared_ptr<SpriteBatch>& batch,
+                        const Mat4& transform, Color4 tint) {
+    if (_texture == nullptr || _instances.empty() || _mesh.vertices.empty()) {
+        return;
+    }
+
+    batch->setColor(tint);
+    batch->setTexture(_texture);
+    batch->setBlendEquation(_blendEquation);
+    batch->setBlendFunc(_srcFactor, _dstFactor);
+    Vec2 pivot(_pivot.x*_region.size.width,_pivot.y*_region.size.height);
+    batch->fill(_mesh, _instances.data(), _instances.size(), pivot, transform);
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Builds the region quad from the texture and region.
+ */
+void InstanceNode::updateMesh() {
+    _mesh.clear();
+    if (_texture == nullptr || _region.size.width <= 0 || _region.size.height <= 0) {
+        return;
+    }
+
+    Size tsize = _texture->getSize();
+    for(int ii = 0; ii < 4; ii++) {
+        float dx = (ii == 1 || ii == 2) ? _region.size.width  : 0;
+        float dy = (ii >= 2) ? _region.size.height : 0;
+        float s = (_region.origin.x+dx)/tsize.width;
+        float t = 1-(_region.origin.y+dy)/tsize.height;
+
+        SpriteVertex2 vert;
+        vert.position = Vec2(dx,dy);
+        vert.color = Vec4::ONE;
+        vert.texcoord.x = s*_texture->getMaxS()+(1-s)*_texture->getMinS();
+        vert.texcoord.y = t*_texture->getMaxT()+(1-t)*_texture->getMinT();
+        _mesh.vertices.push_back(vert);
+    }
+    _mesh.indices = { 0, 1, 2, 0, 2, 3 };
+    _mesh.command = GL_TRIANGLES;
+}
@@ -68,6 +68,8 @@ _angle(0),
 _useTransform(false),
 _parent(nullptr),
 _graph(nullptr),
+_layoutDirty(false),
+_layoutPending(false),
 _zOrder(0),
 _zDirty(false),
 _childOffset(-2) {}
@@ -270,6 +272,8 @@ void SceneNode::dispose() {
     _zOrder = 0;
     _zDirty = false;
     _json = nullptr;
+    _layoutDirty = false;
+    _layoutPending = false;
 }
 
 /**
@@ -338,11 +342,19 @@ void SceneNode::setPosition(float x, float y) {
  * @param size  The untransformed size of the node.
  */
 void SceneNode::setContentSize(const Size size) {
-    _position += _anchor*(size-_contentSize);
-    _contentSize.set(size);
-    if (!_useTransform) updateTransform();
+    if (size != _contentSize) {
+        _position += _anchor*(size-_contentSize);
+        _contentSize.set(size);
+        if (!_useTransform) updateTransform();
+        if (_parent != nullptr && _parent->_layout) {
+            _parent->setLayoutDirty();
+        }
+        if (_layout) {
+            setLayoutDirty();
+        }
+    }
     if (_layout) {
-        doLayout();
+        updateLayout();
     }
 }
 
@@ -610,7 +622,7 @@ void SceneNode::addChild(const std::shared_ptr<SceneNode>& child, int zval) {
     _children.push_back(child);
     child->setParent(this);
     child->pushScene(_graph);
-    
+    invalidateLayout();
 }
 
 /**
@@ -646,6 +658,7 @@ void SceneNode::swapChild(const std::shared_ptr<SceneNode>& child1,
         childdirty = child2->isZDirty();
     }
     setZDirty(_zDirty || child1->_zOrder != child2->_zOrder || childdirty);
+    invalidateLayout();
 }
 
 /**
@@ -667,6 +680,7 @@ void SceneNode::removeChild(unsigned int pos) {
         _children[ii]->_childOffset = ii;
     }
     _children.resize(_children.size()-1);
+    invalidateLayout();
 }
 
 /**
@@ -731,6 +745,7 @@ void SceneNode::removeAllChildren() {
     }
     _children.clear();
     _zDirty = false;
+    invalidateLayout();
 }
 
 /**
@@ -762,6 +777,86 @@ void SceneNode::doLayout() {
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->doLayout();
     }
+    _layoutDirty = false;
+    _layoutPending = false;
+}
+
+/**
+ * Arranges the dirty parts of the subtree rooted at this node.
+ *
+ * This is an incremental version of {@link doLayout()}.  A node is only
+ * laid out again if it is dirty, and the method only descends into those
+ * children that are dirty or have dirty descendants.  A node is marked
+ * dirty when its content size changes, when its children are added,
+ * removed or renamed, and when its layout manager changes.
+ *
+ * The method {@link setContentSize} calls this method automatically on
+ * nodes with a layout manager, so it is rarely necessary to call it
+ * directly.  However, a changed child size only marks the parent dirty;
+ * it does not lay out the parent.
+ */
+void SceneNode::updateLayout() {
+    if (_layoutDirty && _layout) {
+        _layout->layout(this);
+    }
+    if (_layoutDirty || _layoutPending) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            if ((*it)->_layoutDirty || (*it)->_layoutPending) {
+                (*it)->updateLayout();
+            }
+        }
+    }
+    // Resizing the children marks this node again, but its layout is current
+    _layoutDirty = false;
+    _layoutPending = false;
+}
+
+/**
+ * Marks the layout of this node as dirty.
+ *
+ * The next call to {@link updateLayout()} on this node or any of its
+ * ancestors will rearrange the children of this node.  You should call
+ * this method if you change the layout information of the layout manager
+ * after it has been attached.
+ */
+void SceneNode::setLayoutDirty() {
+    _layoutDirty = true;
+    for(SceneNode* node = _parent; node != nullptr && !node->_layoutPending; node = node->_parent) {
+        node->_layoutPending = true;
+    }
+}
+
+/**
+ * Sets the layout manager for this node
+ *
+ * We had originally intended to completely decouple layout managers from
+ * nodes.  However, nodes (including layout assignemnts) are typically
+ * built bottom-up, while layout must happen top down to correctly resize
+ * elements.  Therefore, we do allow the addition of an optional layout
+ * manager.
+ *
+ * Changing the layout manager does not reperform layout.  It only marks
+ * the layout as dirty.  You must call {@link doLayout()} or
+ * {@link updateLayout()} to do this.
+ *
+ * @param layout	The layout manager for this node
+ */
+void SceneNode::setLayout(const std::shared_ptr<Layout>& layout) {
+    _layout = layout;
+    invalidateLayout();
+}
+
+/**
+ * Records that the children of this node have changed.
+ *
+ * This forces the layout manager to resolve the children again, and
+ * marks the layout as dirty.
+ */
+void SceneNode::invalidateLayout() {
+    if (_layout) {
+        _layout->invalidate();
+        setLayoutDirty();
+    }
 }
 
 #pragma mark -
@@ -922,6 +1017,64 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tr
     }
 }
 
+/**
+ * Draws this Node and all of its children with the given SpriteBatch.
+ *
+ * This is the 2d fast path of render(shared_ptr<SpriteBatch>,const Mat4&,Color4).
+ * Because a scene graph is planar, the node transforms are combined as
+ * {@link Affine2} maps (6 floats) instead of full 4x4 matrices, and are
+ * passed to draw(shared_ptr<SpriteBatch>,const Affine2&,Color4). The only
+ * 4x4 matrix left is the camera, which is applied by the sprite batch.
+ *
+ * If this node has an alternate transform that is not planar (e.g. it
+ * tilts the node out of the plane), this node and its children are drawn
+ * with the matrix path instead.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) {
+    if (!_isVisible) { return; }
+
+    // Only an alternate transform can leave the plane
+    const float* m = _combined.m;
+    if (_useTransform && (m[2] != 0 || m[3] != 0 || m[6] != 0 || m[7] != 0 || m[8] != 0 ||
+                          m[9] != 0 || m[10] != 1 || m[11] != 0 || m[14] != 0 || m[15] != 1)) {
+        render(batch,Mat4(transform),tint);
+        return;
+    }
+
+    // The node transform followed by the parent one, as in Affine2::multiply
+    const float* t = transform.m;
+    Affine2 matrix(t[0]*m[0] +t[2]*m[1], t[0]*m[4] +t[2]*m[5],
+                   t[1]*m[0] +t[3]*m[1], t[1]*m[4] +t[3]*m[5],
+                   t[0]*m[12]+t[2]*m[13]+t[4], t[1]*m[12]+t[3]*m[13]+t[5]);
+    Color4 color = _tintColor;
+    if (_hasParentColor) {
+        color *= tint;
+    }
+
+    std::shared_ptr<Scissor> active = batch->getScissor();
+    if (_scissor) {
+        std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
+        local->setTransform(matrix);
+        if (active) {
+            local = active->getIntersection(local, false);
+        }
+        batch->setScissor(local);
+    }
+
+    draw(batch,matrix,color);
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->render(batch, matrix, color);
+    }
+
+    if (_scissor) {
+        batch->setScissor(active);
+    }
+}
+
 /**
  * Returns the absolute color tinting this node.
  *
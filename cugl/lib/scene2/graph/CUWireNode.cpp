@@ -391,3 +391,34 @@ void WireNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& trans
     batch->setGradient(nullptr);
 
 }
+
+/**
+ * Draws this Node via the given SpriteBatch with a 2d transform.
+ *
+ * This is the fast path used by a planar scene graph. It is identical
+ * to the matrix version, except that the vertices are transformed by
+ * the affine map directly.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void WireNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Affine2& transform, Color4 tint) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+    
+    batch->setColor(tint);
+    batch->setTexture(_texture);
+    if (_gradient) {
+        auto local = Gradient::alloc(_gradient);
+        local->setTintColor(tint);
+        local->setTintStatus(true);
+        batch->setGradient(local);
+    }
+    batch->setBlendEquation(_blendEquation);
+    batch->setBlendFunc(_srcFactor, _dstFactor);
+    batch->outline(_mesh, transform);
+    batch->setGradient(nullptr);
+
+}
@@ -120,6 +120,7 @@ bool AnchoredLayout::addAbsolute(const std::string key, Anchor anchor, const Vec
     entry.y_offset = offset.y;
     entry.absolute = true;
     _entries[key] = entry;
+    invalidate();
     return true;
 }
 
@@ -153,6 +154,7 @@ bool AnchoredLayout::addRelative(const std::string key, Anchor anchor, const Vec
     entry.y_offset = offset.y;
     entry.absolute = false;
     _entries[key] = entry;
+    invalidate();
     return true;
 }
 
@@ -174,6 +176,7 @@ bool AnchoredLayout::remove(const std::string key) {
     auto entry = _entries.find(key);
     if (entry != _entries.end()) {
         _entries.erase(entry);
+        invalidate();
         return true;
     }
     return false;
@@ -204,16 +207,36 @@ bool AnchoredLayout::remove(const std::string key) {
  * @param node  The scene graph node to rearrange
  */
 void AnchoredLayout::layout(scene2::SceneNode* node) {
-    auto kids = node->getChildren();
+    if (_bound != node) {
+        resolve(node);
+    }
     Size size = node->getContentSize();
+    for(auto it = _resolved.begin(); it != _resolved.end(); ++it) {
+        const Entry& entry = it->second;
+        Vec2 offset;
+        offset.x = entry.absolute ? entry.x_offset : entry.x_offset*size.width;
+        offset.y = entry.absolute ? entry.y_offset : entry.y_offset*size.height;
+        placeNode(it->first, entry.anchor, Rect(Vec2::ZERO,size), offset);
+    }
+}
+
+/**
+ * Resolves the registered children of the given node.
+ *
+ * This method looks up the children by name and caches references to
+ * them along with their layout information.  Subsequent layouts of the
+ * same node use these references until the layout is invalidated.
+ *
+ * @param node  The scene graph node to resolve
+ */
+void AnchoredLayout::resolve(SceneNode* node) {
+    _resolved.clear();
+    auto kids = node->getChildren();
     for(auto it = kids.begin(); it != kids.end(); ++it) {
         auto jt = _entries.find((*it)->getName());
         if (jt != _entries.end()) {
-            Entry entry = jt->second;
-            Vec2 offset;
-            offset.x = entry.absolute ? entry.x_offset : entry.x_offset*size.width;
-            offset.y = entry.absolute ? entry.y_offset : entry.y_offset*size.height;
-            placeNode(it->get(), entry.anchor, Rect(Vec2::ZERO,size), offset);
+            _resolved.push_back(std::make_pair(it->get(),jt->second));
         }
     }
+    _bound = node;
 }
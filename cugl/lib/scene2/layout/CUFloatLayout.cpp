@@ -122,6 +122,8 @@ bool FloatLayout::initWithData(const std::shared_ptr<JsonValue>& data) {
 void FloatLayout::dispose() {
     _entries.clear();
     _priority.clear();
+    _resolved.clear();
+    _bound = nullptr;
 }
 
 
@@ -176,6 +178,7 @@ bool FloatLayout::add(const std::string key, const std::shared_ptr<JsonValue>& d
     }
     _entries[key] = entry;
     _priority.push_back(key);
+    invalidate();
     return true;
 }
 
@@ -203,6 +206,7 @@ bool FloatLayout::remove(const std::string key) {
     if (position != _priority.end()) {
         _priority.erase(position);
     }
+    invalidate();
     return true;
 }
 
@@ -231,6 +235,9 @@ bool FloatLayout::remove(const std::string key) {
  * @param node  The scene graph node to rearrange
  */
 void FloatLayout::layout(SceneNode* node) {
+    if (_bound != node) {
+        resolve(node);
+    }
     if (_horizontal) {
         layoutHorizontal(node);
     } else {
@@ -250,7 +257,6 @@ void FloatLayout::layout(SceneNode* node) {
  * @param node  The scene graph node to rearrange
  */
 void FloatLayout::layoutHorizontal(SceneNode* node) {
-    prioritize();
     Size size = node->getContentSize();
     Vec2 pos;
     Rect bounds;
@@ -266,15 +272,12 @@ void FloatLayout::layoutHorizontal(SceneNode* node) {
     // Get the bounding box for the contents (ignoring alignment for now)
     bool stop = false;
 
-    for(auto it = _priority.begin(); !stop && it != _priority.end(); ++it) {
-        std::shared_ptr<SceneNode> child= node->getChildByName(*it);
+    for(auto it = _resolved.begin(); !stop && it != _resolved.end(); ++it) {
+        SceneNode* child = it->first;
         if (child) {
             Size extra = child->getSize();
-            auto en = _entries.find(*it);
-            if (en != _entries.end()) {
-                extra.width  += en->second.pad_left + en->second.pad_right;
-                extra.height += en->second.pad_top + en->second.pad_bottom;
-            }
+            extra.width  += it->second.pad_left + it->second.pad_right;
+            extra.height += it->second.pad_top + it->second.pad_bottom;
             if (extra.width > size.width) {
                 stop = true;
             } else if (width.back()+extra.width > size.width) {
@@ -353,7 +356,7 @@ void FloatLayout::layoutHorizontal(SceneNode* node) {
             break;
     }
     
-    auto jt = _priority.begin();
+    auto jt = _resolved.begin();
     for(size_t row = 0; row < count.size(); row++) {
         Vec2 pos; // Top LEFT corner of float.
         float xpos;
@@ -376,20 +379,13 @@ void FloatLayout::layoutHorizontal(SceneNode* node) {
                 break;
         }
         for(size_t col = 0; col < count[row]; col++) {
-            std::shared_ptr<SceneNode> child = node->getChildByName(*jt);
+            SceneNode* child = jt->first;
             if (child) {
                 Size tmp = child->getSize();
-                float padl = 0;
-                float padr = 0;
-                float padb = 0;
-                float padt = 0;
-                auto en = _entries.find(*jt);
-                if (en != _entries.end()) {
-                    padl = en->second.pad_left;
-                    padr = en->second.pad_right;
-                    padb = en->second.pad_bottom;
-                    padt = en->second.pad_top;
-                }
+                float padl = jt->second.pad_left;
+                float padr = jt->second.pad_right;
+                float padb = jt->second.pad_bottom;
+                float padt = jt->second.pad_top;
                 switch(_alignment) {
                     case Alignment::BOTTOM_LEFT:
                     case Alignment::BOTTOM_CENTER:
@@ -429,7 +425,6 @@ void FloatLayout::layoutHorizontal(SceneNode* node) {
  * @param node  The scene graph node to rearrange
  */
 void FloatLayout::layoutVertical(SceneNode* node) {
-    prioritize();
     Size size = node->getContentSize();
     Vec2 pos;
     Rect bounds;
@@ -445,15 +440,12 @@ void FloatLayout::layoutVertical(SceneNode* node) {
     
     // Get the bounding box for the contents (ignoring alignment for now)
     bool stop = false;
-    for(auto it = _priority.begin(); !stop && it != _priority.end(); ++it) {
-        std::shared_ptr<SceneNode> child = node->getChildByName(*it);
+    for(auto it = _resolved.begin(); !stop && it != _resolved.end(); ++it) {
+        SceneNode* child = it->first;
         if (child) {
             Size extra = child->getSize();
-            auto en = _entries.find(*it);
-            if (en != _entries.end()) {
-                extra.width  += en->second.pad_left + en->second.pad_right;
-                extra.height += en->second.pad_top + en->second.pad_bottom;
-            }
+            extra.width  += it->second.pad_left + it->second.pad_right;
+            extra.height += it->second.pad_top + it->second.pad_bottom;
             if (extra.height > size.height) {
                 stop = true;
             } else if (height.back()+extra.height > size.height) {
@@ -532,7 +524,7 @@ void FloatLayout::layoutVertical(SceneNode* node) {
             break;
     }
     
-    auto jt = _priority.begin();
+    auto jt = _resolved.begin();
     for(size_t col = 0; col < count.size(); col++) {
         Vec2 pos; // Top LEFT corner of float.
         float ypos;
@@ -556,20 +548,13 @@ void FloatLayout::layoutVertical(SceneNode* node) {
         }
         
         for(size_t row = 0; row < count[col]; row++) {
-            std::shared_ptr<SceneNode> child = node->getChildByName(*jt);
+            SceneNode* child = jt->first;
             if (child) {
                 Size tmp = child->getSize();
-                float padl = 0;
-                float padr = 0;
-                float padb = 0;
-                float padt = 0;
-                auto en = _entries.find(*jt);
-                if (en != _entries.end()) {
-                    padl = en->second.pad_left;
-                    padr = en->second.pad_right;
-                    padb = en->second.pad_bottom;
-                    padt = en->second.pad_top;
-                }
+                float padl = jt->second.pad_left;
+                float padr = jt->second.pad_right;
+                float padb = jt->second.pad_bottom;
+                float padt = jt->second.pad_top;
                 switch(_alignment) {
                     case Alignment::BOTTOM_LEFT:
                     case Alignment::MIDDLE_LEFT:
@@ -627,3 +612,27 @@ void FloatLayout::prioritize() {
     
     std::sort(_priority.begin(),_priority.end(),sortrule);
 }
+
+/**
+ * Resolves the registered children of the given node.
+ *
+ * This method looks up the children by name, in priority order, and caches
+ * references to them along with their layout information.  Subsequent
+ * layouts of the same node use these references until the layout is
+ * invalidated.
+ *
+ * @param node  The scene graph node to resolve
+ */
+void FloatLayout::resolve(SceneNode* node) {
+    prioritize();
+    _resolved.clear();
+    _resolved.reserve(_priority.size());
+    for(auto it = _priority.begin(); it != _priority.end(); ++it) {
+        std::shared_ptr<SceneNode> child = node->getChildByName(*it);
+        auto jt = _entries.find(*it);
+        if (child != nullptr && jt != _entries.end()) {
+            _resolved.push_back(std::make_pair(child.get(),jt->second));
+        }
+    }
+    _bound = node;
+}
@@ -148,6 +148,7 @@ bool GridLayout::addPosition(const std::string key, unsigned int x, unsigned int
     entry.x = x;
     entry.y = y;
     _entries[key] = entry;
+    invalidate();
     return true;
 }
 
@@ -169,6 +170,7 @@ bool GridLayout::remove(const std::string key) {
     auto entry = _entries.find(key);
     if (entry != _entries.end()) {
         _entries.erase(entry);
+        invalidate();
         return true;
     }
     return false;
@@ -193,18 +195,38 @@ bool GridLayout::remove(const std::string key) {
  * @param node  The scene graph node to rearrange
  */
 void GridLayout::layout(SceneNode* node) {
-    auto kids = node->getChildren();
+    if (_bound != node) {
+        resolve(node);
+    }
     Size size = node->getContentSize();
     Size grid = Size(size.width/_gwidth,size.height/_gheight);
+    for(auto it = _resolved.begin(); it != _resolved.end(); ++it) {
+        const Entry& entry = it->second;
+        Rect bounds(Vec2(entry.x*grid.width,entry.y*grid.height),grid);
+        reanchor(it->first, entry.anchor);
+        placeNode(it->first, entry.anchor, bounds, Vec2::ZERO);
+    }
+}
+
+/**
+ * Resolves the registered children of the given node.
+ *
+ * This method looks up the children by name and caches references to
+ * them along with their layout information.  Subsequent layouts of the
+ * same node use these references until the layout is invalidated.
+ *
+ * @param node  The scene graph node to resolve
+ */
+void GridLayout::resolve(SceneNode* node) {
+    _resolved.clear();
+    auto kids = node->getChildren();
     for(auto it = kids.begin(); it != kids.end(); ++it) {
         auto jt = _entries.find((*it)->getName());
         if (jt != _entries.end()) {
-            Entry entry = jt->second;
-            Rect bounds(Vec2(entry.x*grid.width,entry.y*grid.height),grid);
-            reanchor(it->get(), entry.anchor);
-            placeNode(it->get(), entry.anchor, bounds, Vec2::ZERO);
+            _resolved.push_back(std::make_pair(it->get(),jt->second));
         }
     }
+    _bound = node;
 }
 
 
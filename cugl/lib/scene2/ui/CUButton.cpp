@@ -256,6 +256,7 @@ void Button::dispose() {
     _upcolor = Color4::WHITE;
     _downcolor = Color4::WHITE;
     _bounds.clear();
+    _hitTester.clear();
     _listeners.clear();
     _nextKey = 1;
     _inputkey = 0;
@@ -518,6 +519,7 @@ void Button::setColor(Color4 color) {
 void Button::setPushable(const Poly2& bounds) {
     CUAssertLog(bounds.getGeometry() == Geometry::SOLID, "Polygon is not solid");
     _bounds = bounds;
+    _hitTester.set(_bounds);
 }
 
 /**
@@ -540,6 +542,7 @@ void Button::setPushable(const std::vector<Vec2>& vertices) {
     triangulator.getTriangulation(_bounds.indices());
     
     _bounds.setGeometry(Geometry::SOLID);
+    _hitTester.set(_bounds);
 }
 
 #pragma mark -
@@ -594,7 +597,7 @@ void Button::setDown(bool down) {
 bool Button::containsScreen(const Vec2 point) {
     Vec2 local = screenToNodeCoords(point);
     if (_bounds.getGeometry() == Geometry::SOLID) {
-        return _bounds.contains(local);
+        return _hitTester.contains(0,local);
     }
     return Rect(Vec2::ZERO, getContentSize()).contains(local);
 }
@@ -698,6 +701,7 @@ void Button::doLayout() {
             scale.x = (osize.width > 0 ? size.width/osize.width : 0);
             scale.y = (osize.height > 0 ? size.height/osize.height : 0);
             _bounds *= scale;
+            _hitTester.set(_bounds);
         }
         
         // Now redo the position
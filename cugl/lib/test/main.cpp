@@ -10,7 +10,12 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
 #include <cugl/cugl.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
 
 #include "TCUMathTest.h"
 #include "TCU2DTest.h"
@@ -170,6 +175,1800 @@ void testThread() {
     pool = nullptr;
 }
 
+void testArena() {
+    std::shared_ptr<cugl::Arena> arena = cugl::Arena::alloc(1024);
+    
+    int* p = arena->allocArray<int>(16);
+    double* q = arena->allocArray<double>(200);
+    CUAssertAlwaysLog(((uintptr_t)q % alignof(double)) == 0, "Arena alignment failed");
+    CUAssertAlwaysLog(arena->owns(p) && arena->owns(q), "Arena ownership failed");
+    CUAssertAlwaysLog(arena->getPageCount() == 2, "Arena did not allocate oversized page");
+    
+    size_t heap = arena->getHeapAllocations();
+    Uint32 generation = arena->getGeneration();
+    arena->reset();
+    CUAssertAlwaysLog(arena->getGeneration() == generation+1, "Arena generation not advanced");
+    CUAssertAlwaysLog(arena->getUsage() == 0, "Arena reset failed");
+    
+    arena->allocArray<int>(16);
+    arena->allocArray<double>(200);
+    CUAssertAlwaysLog(arena->getHeapAllocations() == heap, "Arena reset did not reuse pages");
+    
+    arena->trim();
+    CUAssertAlwaysLog(arena->getPageCount() == 1, "Arena trim failed");
+    CULog("Arena test passed");
+}
+
+/**
+ * Builds and restarts a level-sized world, with or without an arena.
+ *
+ * Each round mirrors a level restart: a new world is built from static
+ * polygon tiles and falling balls, played for two seconds, then cleared and
+ * dropped.  The first round is a warm-up and is not timed.  The average
+ * build time is stored in build, and the arena and Box2D page counts of
+ * the last round in heap and chunks.  The function returns the average
+ * restart (clear and drop) time in microseconds.
+ */
+double simulateRestart(bool useArena, double& build, size_t& heap, int& chunks) {
+    const int ROUNDS = 20;
+    const int TILES  = 400;
+    const int BALLS  = 100;
+    const int STEPS  = 120;
+
+    cugl::PolyFactory factory;
+    factory.setSegments(6);
+    cugl::Poly2 hexagon = factory.makeCircle(cugl::Vec2::ZERO,0.5f);
+
+    Sint64 building = 0;
+    Sint64 restarting = 0;
+    for(int round = 0; round <= ROUNDS; round++) {
+        std::minstd_rand random(round);
+        std::uniform_real_distribution<float> xdist(1,99);
+        std::uniform_real_distribution<float> ydist(1,39);
+
+        cugl::Timestamp start;
+        std::shared_ptr<cugl::physics2::ObstacleWorld> world;
+        world = cugl::physics2::ObstacleWorld::alloc(cugl::Rect(0,0,100,60),cugl::Vec2(0,-9.8f));
+        if (useArena) {
+            world->setArena(cugl::Arena::alloc());
+        }
+        world->activateCollisionCallbacks(true);
+
+        std::vector<std::shared_ptr<cugl::physics2::Obstacle>> obstacles;
+        for(int ii = 0; ii < TILES; ii++) {
+            auto tile = std::make_shared<cugl::physics2::PolygonObstacle>();
+            tile->setArena(world->getArena());
+            tile->init(hexagon);
+            tile->setPosition(xdist(random),ydist(random));
+            tile->setBodyType(b2_staticBody);
+            world->addObstacle(tile);
+            obstacles.push_back(tile);
+        }
+        for(int ii = 0; ii < BALLS; ii++) {
+            auto ball = cugl::physics2::WheelObstacle::alloc(cugl::Vec2(xdist(random),ydist(random)+20),0.5f);
+            ball->setDensity(1.0f);
+            world->addObstacle(ball);
+            obstacles.push_back(ball);
+        }
+        cugl::Timestamp built;
+
+        for(int ii = 0; ii < STEPS; ii++) {
+            world->update(1/60.0f);
+        }
+        if (world->getArena() != nullptr) {
+            heap = world->getArena()->getHeapAllocations();
+        }
+        chunks = world->getWorld()->GetBlockAllocator().GetChunkCount();
+
+        // The restart itself, as in GameScene::reset
+        cugl::Timestamp middle;
+        world->clear();
+        obstacles.clear();
+        world = nullptr;
+        cugl::Timestamp end;
+
+        if (round > 0) {
+            building += cugl::Timestamp::ellapsedMicros(start,built);
+            restarting += cugl::Timestamp::ellapsedMicros(middle,end);
+        }
+    }
+    build = (double)building/ROUNDS;
+    return (double)restarting/ROUNDS;
+}
+
+void testArenaRestart() {
+    double build, arenabuild;
+    size_t heap = 0;
+    size_t arenaheap = 0;
+    int chunks, arenachunks;
+    double restart = simulateRestart(false,build,heap,chunks);
+    double arenarestart = simulateRestart(true,arenabuild,arenaheap,arenachunks);
+    CULog("Restart: heap  build %8.1f us, restart %8.1f us, %d Box2D chunks",
+          build,restart,chunks);
+    CULog("Restart: arena build %8.1f us, restart %8.1f us, %d Box2D chunks, %zu heap allocations",
+          arenabuild,arenarestart,arenachunks,arenaheap);
+    CUAssertAlwaysLog(chunks == arenachunks, "Arena changed the Box2D chunk count");
+    CUAssertAlwaysLog(arenaheap > 0, "Arena world did not use its arena");
+    CULog("Arena restart test passed");
+}
+
+/**
+ * Simulates 1000 independent boxes resting on a shared ground.
+ *
+ * Every box is its own island. The final positions and angles are stored
+ * in state, and the function returns the average step time in microseconds.
+ */
+double simulateIslands(int threads, std::vector<float>& state) {
+    const int BOXES = 1000;
+    const int STEPS = 240;
+    
+    std::shared_ptr<cugl::physics2::ObstacleWorld> world;
+    world = cugl::physics2::ObstacleWorld::alloc(cugl::Rect(0,0,2*BOXES+2,20),cugl::Vec2(0,-9.8f));
+    std::shared_ptr<cugl::ThreadPool> pool = nullptr;
+    if (threads > 1) {
+        pool = cugl::ThreadPool::alloc(threads-1);
+        world->setSolverPool(pool);
+    }
+    
+    auto ground = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(BOXES+1,0.5f),cugl::Size(2*BOXES+2,1));
+    ground->setBodyType(b2_staticBody);
+    world->addObstacle(ground);
+    
+    std::vector<std::shared_ptr<cugl::physics2::BoxObstacle>> boxes;
+    for(int ii = 0; ii < BOXES; ii++) {
+        auto box = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(2*ii+1.5f,2.0f+(ii % 7)*0.25f),cugl::Size(1,1));
+        box->setDensity(1.0f);
+        box->setAngle(0.05f*(ii % 5));
+        world->addObstacle(box);
+        boxes.push_back(box);
+    }
+    
+    cugl::Timestamp start;
+    for(int ii = 0; ii < STEPS; ii++) {
+        world->update(1/60.0f);
+    }
+    cugl::Timestamp end;
+    
+    state.clear();
+    for(auto it = boxes.begin(); it != boxes.end(); ++it) {
+        state.push_back((*it)->getX());
+        state.push_back((*it)->getY());
+        state.push_back((*it)->getAngle());
+    }
+    world->clear();
+    world = nullptr;
+    pool = nullptr;
+    return (double)cugl::Timestamp::ellapsedMicros(start,end)/STEPS;
+}
+
+void testIslands() {
+    std::vector<float> serial;
+    double base = simulateIslands(1,serial);
+    CULog("Islands: 1 thread  %8.1f us/step",base);
+    
+    int counts[] = { 2, 4, 8 };
+    for(int ii = 0; ii < 3; ii++) {
+        std::vector<float> state;
+        double time = simulateIslands(counts[ii],state);
+        CULog("Islands: %d threads %8.1f us/step (%.2fx)",counts[ii],time,base/time);
+        CUAssertAlwaysLog(state.size() == serial.size() &&
+                          std::memcmp(state.data(),serial.data(),state.size()*sizeof(float)) == 0,
+                          "Parallel solve with %d threads is not deterministic",counts[ii]);
+    }
+    CULog("Island test passed");
+}
+
+/**
+ * Animates 10000 sprite sheet nodes sharing one texture.
+ *
+ * Every node is on a single clock.  Changing frames must not touch the
+ * geometry, and all of the nodes should still draw in a single batch.
+ */
+void testAnimation() {
+    const int SPRITES = 10000;
+    const int FRAMES  = 240;
+    
+    std::vector<Uint32> pixels(256*256,0xffffffff);
+    auto texture = cugl::Texture::allocWithData(pixels.data(),256,256);
+    auto batch = cugl::SpriteBatch::alloc();
+    batch->setPerspective(cugl::Mat4::createOrthographic(1024,576,0.1f,10));
+    
+    auto clock = cugl::scene2::AnimationClock::alloc(SPRITES);
+    auto root  = cugl::scene2::SceneNode::alloc();
+    for(int ii = 0; ii < SPRITES; ii++) {
+        auto node = cugl::scene2::AnimationNode::alloc(texture,4,4,16);
+        node->setPosition((ii % 100)*10.0f,(ii / 100)*5.0f);
+        node->setClock(clock);
+        node->play(0,15,1+(ii % 3),(cugl::scene2::AnimationClock::Mode)(ii % 3));
+        root->addChild(node);
+    }
+    
+    auto first = std::dynamic_pointer_cast<cugl::scene2::AnimationNode>(root->getChild(0));
+    cugl::Poly2 shape = first->getPolygon();
+    
+    Uint64 ticking = 0;
+    Uint64 drawing = 0;
+    for(int ii = 0; ii < FRAMES; ii++) {
+        cugl::Timestamp start;
+        clock->update();
+        cugl::Timestamp middle;
+        batch->begin();
+        root->render(batch);
+        batch->end();
+        cugl::Timestamp end;
+        ticking += cugl::Timestamp::ellapsedMicros(start,middle);
+        drawing += cugl::Timestamp::ellapsedMicros(middle,end);
+    }
+    
+    CUAssertAlwaysLog(first->getPolygon().vertices() == shape.vertices(), "Animation changed the polygon");
+    CUAssertAlwaysLog(batch->getCallsMade() <= 2*((SPRITES*6)/DEFAULT_CAPACITY+1),
+                      "Animation frames broke the batch");
+    CULog("Animation: clock %8.1f us/frame, draw %8.1f us/frame (%u calls)",
+          (double)ticking/FRAMES,(double)drawing/FRAMES,batch->getCallsMade());
+    
+    root->removeAllChildren();
+    root = nullptr;
+    CUAssertAlwaysLog(clock->size() == 0, "Disposed nodes did not leave the clock");
+    CULog("Animation test passed");
+}
+
+/**
+ * Parses the Lumia JSON assets with both the old and new JSON pipelines.
+ *
+ * The old pipeline parses with cJSON and then converts the cJSON tree.  The
+ * files must be copied to a json folder in the test assets.  Missing files
+ * are skipped.
+ */
+void testJson() {
+    const int REPEATS = 100;
+    std::vector<std::string> files;
+    files.push_back("json/assets.json");
+    files.push_back("json/tiles.json");
+    for(int ii = 1; ii <= 17; ii++) {
+        files.push_back("json/level"+cugl::strtool::to_string(ii)+".json");
+    }
+    
+    double oldtotal = 0;
+    double newtotal = 0;
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        std::shared_ptr<cugl::TextReader> reader = cugl::TextReader::allocWithAsset(*it);
+        if (reader == nullptr) {
+            CULog("JSON: skipping missing %s",it->c_str());
+            continue;
+        }
+        std::string text = reader->readAll();
+        reader->close();
+        
+        std::shared_ptr<cugl::JsonValue> before;
+        cugl::Timestamp start;
+        for(int ii = 0; ii < REPEATS; ii++) {
+            cJSON* node = cJSON_ParseWithOpts(text.c_str(), nullptr, 0);
+            before = cugl::JsonValue::toJsonValue(node);
+            cJSON_Delete(node);
+        }
+        cugl::Timestamp middle;
+        std::shared_ptr<cugl::JsonValue> after;
+        for(int ii = 0; ii < REPEATS; ii++) {
+            after = cugl::JsonValue::allocWithJson(text);
+        }
+        cugl::Timestamp end;
+        
+        CUAssertAlwaysLog(before->toString() == after->toString(), "Parsers disagree on %s",it->c_str());
+        double oldtime = (double)cugl::Timestamp::ellapsedMicros(start,middle)/REPEATS;
+        double newtime = (double)cugl::Timestamp::ellapsedMicros(middle,end)/REPEATS;
+        CULog("JSON: %-20s cJSON %8.1f us, native %8.1f us (%.2fx)",it->c_str(),oldtime,newtime,oldtime/newtime);
+        oldtotal += oldtime;
+        newtotal += newtime;
+    }
+    
+    // Strings may contain braces, and trailing text is left alone
+    auto value = cugl::JsonValue::allocWithJson("{\"a\":\"}\\\"\",\"b\":[1,-2,3.5e2]} trailing");
+    CUAssertAlwaysLog(value->getString("a") == "}\"" && value->get("b")->get(2)->asInt() == 350,
+                      "JSON parse is incorrect");
+    CULog("JSON: total cJSON %8.1f us, native %8.1f us",oldtotal,newtotal);
+    CULog("JSON test passed");
+}
+
+/**
+ * Counts the OpenGL calls made to draw a frame like those of the Lumia levels.
+ *
+ * The frame interleaves three textures (tiles, avatars and plants) with wire
+ * outlines, which forces the sprite batch to change state.  No uniform or
+ * attribute may be looked up by name during the frame, and errors may only
+ * be polled in validation builds.  The engine must be built with CU_GL_RECORD,
+ * or else this test is skipped.  The recorder forwards every call to OpenGL,
+ * so this test also needs the context of the application window.  The
+ * exception is a build with CU_GL_HEADLESS, which needs no GPU or context,
+ * and so may run on a build server with SDL_VIDEODRIVER=dummy.
+ */
+void testGLCalls() {
+    if (!cugl::GLRecorder::isRecording()) {
+        CULog("GL calls: skipped (build with CU_GL_RECORD)");
+        return;
+    } else if (!cugl::GLRecorder::isHeadless() && SDL_GL_GetCurrentContext() == nullptr) {
+        CULog("GL calls: skipped (no OpenGL context)");
+        return;
+    }
+    
+    const int SPRITES = 600;
+    const int FRAMES  = 60;
+    typedef cugl::GLRecorder::Call Call;
+    
+    std::vector<Uint32> pixels(64*64,0xffffffff);
+    std::shared_ptr<cugl::Texture> textures[3];
+    for(int ii = 0; ii < 3; ii++) {
+        textures[ii] = cugl::Texture::allocWithData(pixels.data(),64,64);
+    }
+    auto batch = cugl::SpriteBatch::alloc();
+    batch->setPerspective(cugl::Mat4::createOrthographic(1024,576,0.1f,10));
+    
+    auto root = cugl::scene2::SceneNode::alloc();
+    for(int ii = 0; ii < SPRITES; ii++) {
+        auto node = cugl::scene2::PolygonNode::allocWithTexture(textures[(ii/20) % 3]);
+        node->setPosition((ii % 40)*25.0f,(ii / 40)*35.0f);
+        root->addChild(node);
+        if (ii % 50 == 0) {
+            auto wire = cugl::scene2::WireNode::alloc(cugl::Rect(0,0,25,35));
+            wire->setPosition(node->getPosition());
+            root->addChild(wire);
+        }
+    }
+    
+    Uint32 total = 0;
+    for(int ii = 0; ii < FRAMES; ii++) {
+        cugl::GLRecorder::reset();
+        batch->begin();
+        root->render(batch);
+        batch->end();
+        total += cugl::GLRecorder::getTotal();
+        
+        CUAssertAlwaysLog(cugl::GLRecorder::getCount(Call::LOOKUP) == 0, "Frame looked up variables by name");
+        CUAssertAlwaysLog(CU_GL_VALIDATE || cugl::GLRecorder::getCount(Call::GET_ERROR) == 0,
+                          "Frame polled for errors in a release build");
+        CUAssertAlwaysLog(cugl::GLRecorder::getCount(Call::DRAW) == batch->getCallsMade(),
+                          "Recorder missed draw calls");
+    }
+    
+    CULog("GL calls: %s",cugl::GLRecorder::toString().c_str());
+    CULog("GL calls: %.1f per frame",(double)total/FRAMES);
+    CULog("GL calls test passed");
+}
+
+/**
+ * Streams many small batches through the sprite batch vertex ring.
+ *
+ * The batch is deliberately small, so that every frame flushes several
+ * times and the ring wraps many times over the test.  The ring must never
+ * reallocate, and every byte recorded must match the vertices drawn.  If
+ * the engine is built with CU_GL_RECORD, this also checks that a flush
+ * makes no more than two vertex uploads (or four map calls), plus the one
+ * upload of the uniform buffer.
+ */
+void testStreaming() {
+    const int CAPACITY = 512;
+    const int SPRITES  = 1000;
+    const int FRAMES   = 120;
+    typedef cugl::GLRecorder::Call Call;
+    
+    std::vector<Uint32> pixels(64*64,0xffffffff);
+    auto texture = cugl::Texture::allocWithData(pixels.data(),64,64);
+    auto batch = cugl::SpriteBatch::alloc(CAPACITY);
+    batch->setPerspective(cugl::Mat4::createOrthographic(1024,576,0.1f,10));
+    batch->setTexture(texture);
+    
+    Uint64 bytes = 0;
+    Uint32 flushes = 0;
+    cugl::Timestamp start;
+    for(int ii = 0; ii < FRAMES; ii++) {
+        cugl::GLRecorder::reset();
+        batch->begin();
+        for(int jj = 0; jj < SPRITES; jj++) {
+            batch->fill(cugl::Rect((jj % 40)*25.0f,(jj / 40)*20.0f,20,16));
+        }
+        batch->end();
+        
+        CUAssertAlwaysLog(batch->getBufferReallocations() == 0, "Sprite batch reallocated its buffers");
+        // Each quad is 4 vertices and 6 indices
+        Uint64 expected = (Uint64)SPRITES*(4*sizeof(cugl::SpriteVertex3)+6*sizeof(GLuint));
+        CUAssertAlwaysLog(batch->getBytesUploaded() == expected, "Sprite batch uploaded %llu bytes, not %llu",
+                          (unsigned long long)batch->getBytesUploaded(), (unsigned long long)expected);
+        if (cugl::GLRecorder::isRecording()) {
+            CUAssertAlwaysLog(cugl::GLRecorder::getCount(Call::BUFFER_DATA) <= 5*cugl::GLRecorder::getCount(Call::DRAW),
+                              "Sprite batch uploaded too often");
+        }
+        bytes += batch->getBytesUploaded();
+        flushes += batch->getCallsMade();
+    }
+    cugl::Timestamp end;
+    
+    CULog("Streaming: %.1f KB/frame over %.1f flushes/frame, %8.1f us/frame",
+          bytes/(1024.0*FRAMES),(double)flushes/FRAMES,
+          (double)cugl::Timestamp::ellapsedMicros(start,end)/FRAMES);
+    CULog("Streaming test passed");
+}
+
+/** A trivial asset for testing asset lookups */
+class TestAsset : public cugl::Asset {
+public:
+    using cugl::Asset::preload;
+    bool preload(const std::string&) override { return true; }
+};
+
+void testAssetHandles() {
+    const int ASSETS = 400;
+    const int LOOKUPS = 24;
+    const int FRAMES = 10000;
+    
+    auto assets = cugl::AssetManager::alloc();
+    assets->attach<TestAsset>(cugl::GenericLoader<TestAsset>::alloc()->getHook());
+    for(int ii = 0; ii < ASSETS; ii++) {
+        assets->load<TestAsset>("pausedUI_asset-"+std::to_string(ii),"unused");
+    }
+    
+    // A key per lookup, as in GameScene::updatePaused
+    std::vector<std::string> keys;
+    std::vector<cugl::AssetHandle<TestAsset>> handles;
+    for(int ii = 0; ii < LOOKUPS; ii++) {
+        keys.push_back("pausedUI_asset-"+std::to_string((ii*37) % ASSETS));
+        handles.push_back(assets->getHandle<TestAsset>(keys.back()));
+    }
+    
+    size_t found = 0;
+    cugl::Timestamp start;
+    for(int ii = 0; ii < FRAMES; ii++) {
+        for(int jj = 0; jj < LOOKUPS; jj++) {
+            found += (assets->get<TestAsset>(keys[jj]) != nullptr);
+        }
+    }
+    cugl::Timestamp middle;
+    for(int ii = 0; ii < FRAMES; ii++) {
+        for(int jj = 0; jj < LOOKUPS; jj++) {
+            found += (handles[jj].get() != nullptr);
+        }
+    }
+    cugl::Timestamp end;
+    CUAssertAlwaysLog(found == 2*FRAMES*LOOKUPS, "Asset lookups failed");
+    
+    double lookup = (double)cugl::Timestamp::ellapsedNanos(start,middle)/(FRAMES*LOOKUPS);
+    double handle = (double)cugl::Timestamp::ellapsedNanos(middle,end)/(FRAMES*LOOKUPS);
+    CULog("Asset lookup: %6.1f ns, handle: %6.1f ns", lookup, handle);
+    CULog("Per frame (%d assets): %6.2f us vs %6.2f us", LOOKUPS, lookup*LOOKUPS/1000, handle*LOOKUPS/1000);
+    
+    // Handles must follow their keys across reloads
+    std::shared_ptr<TestAsset> before = handles[0].get();
+    assets->unload<TestAsset>(keys[0]);
+    CUAssertAlwaysLog(handles[0].isValid() && !handles[0].isLoaded(), "Handle was not cleared on unload");
+    assets->load<TestAsset>(keys[0],"unused");
+    CUAssertAlwaysLog(handles[0].isLoaded() && handles[0].get() != before, "Handle did not follow reload");
+    CUAssertAlwaysLog(handles[0].get() == assets->get<TestAsset>(keys[0]), "Handle disagrees with lookup");
+    
+    assets->unloadAll();
+    CUAssertAlwaysLog(!handles[1].isLoaded(), "Handle was not cleared on unload all");
+    auto missing = assets->getHandle<TestAsset>("missing");
+    CUAssertAlwaysLog(missing.isValid() && !missing, "Missing handle is loaded");
+    CULog("Asset handle test passed");
+}
+
+/** Returns the positions of every grandchild of root (the layout leaves) */
+static std::vector<cugl::Vec2> layoutLeaves(const std::shared_ptr<cugl::scene2::SceneNode>& root) {
+    std::vector<cugl::Vec2> result;
+    for(auto& panel : root->getChildren()) {
+        result.push_back(panel->getPosition());
+        for(auto& cell : panel->getChildren()) {
+            result.push_back(cell->getPosition());
+        }
+    }
+    return result;
+}
+
+void testLayout() {
+    const int PANELS = 50;
+    const int CELLS  = 100;
+    const int PASSES = 200;
+    typedef cugl::scene2::Layout::Anchor Anchor;
+    
+    // A synthetic UI of 5000 widgets: anchored panels, each a 10x10 grid
+    auto root = cugl::scene2::SceneNode::allocWithBounds(cugl::Size(1024,576));
+    auto anchored = cugl::scene2::AnchoredLayout::alloc();
+    root->setLayout(anchored);
+    std::vector<std::shared_ptr<cugl::scene2::SceneNode>> panels;
+    for(int ii = 0; ii < PANELS; ii++) {
+        std::string name = "panel"+std::to_string(ii);
+        auto panel = cugl::scene2::SceneNode::allocWithBounds(cugl::Size(200,200));
+        auto grid = cugl::scene2::GridLayout::alloc();
+        grid->setGridSize(10,10);
+        panel->setLayout(grid);
+        for(int jj = 0; jj < CELLS; jj++) {
+            std::string key = name+"_cell"+std::to_string(jj);
+            panel->addChildWithName(cugl::scene2::SceneNode::allocWithBounds(cugl::Size(16,16)),key);
+            grid->addPosition(key,jj % 10,jj / 10,Anchor::CENTER);
+        }
+        root->addChildWithName(panel,name);
+        anchored->addRelative(name,Anchor::CENTER,cugl::Vec2((ii % 10)/10.0f-0.45f,(ii / 10)/5.0f-0.4f));
+        panels.push_back(panel);
+    }
+    root->doLayout();
+    
+    // Resize a single panel, then lay out everything
+    cugl::Timestamp start;
+    for(int ii = 0; ii < PASSES; ii++) {
+        panels[ii % PANELS]->setContentSize(ii % 2 ? 200 : 220, 200);
+        root->doLayout();
+    }
+    cugl::Timestamp middle;
+    for(int ii = 0; ii < PASSES; ii++) {
+        panels[ii % PANELS]->setContentSize(ii % 2 ? 220 : 200, 200);
+        root->updateLayout();
+    }
+    cugl::Timestamp end;
+    CULog("Layout (one panel): full %8.1f us, incremental %8.1f us",
+          (double)cugl::Timestamp::ellapsedMicros(start,middle)/PASSES,
+          (double)cugl::Timestamp::ellapsedMicros(middle,end)/PASSES);
+    
+    // Resize the root, which moves (but does not resize) the panels
+    start.mark();
+    for(int ii = 0; ii < PASSES; ii++) {
+        root->setContentSize(ii % 2 ? 1024 : 1280, 576);
+        root->doLayout();
+    }
+    middle.mark();
+    for(int ii = 0; ii < PASSES; ii++) {
+        root->setContentSize(ii % 2 ? 1280 : 1024, 576);
+        root->updateLayout();
+    }
+    end.mark();
+    CULog("Layout (root):      full %8.1f us, incremental %8.1f us",
+          (double)cugl::Timestamp::ellapsedMicros(start,middle)/PASSES,
+          (double)cugl::Timestamp::ellapsedMicros(middle,end)/PASSES);
+    
+    // Incremental layout must agree with a full layout
+    for(int ii = 0; ii < PANELS; ii += 7) {
+        panels[ii]->setContentSize(150+ii, 180);
+    }
+    root->setContentSize(1100, 600);
+    root->updateLayout();
+    std::vector<cugl::Vec2> incremental = layoutLeaves(root);
+    root->doLayout();
+    std::vector<cugl::Vec2> full = layoutLeaves(root);
+    CUAssertAlwaysLog(incremental.size() == (size_t)PANELS*(CELLS+1), "Layout tree has the wrong size");
+    for(size_t ii = 0; ii < full.size(); ii++) {
+        CUAssertAlwaysLog(incremental[ii].equals(full[ii]), "Incremental layout differs at widget %zu", ii);
+    }
+    
+    // Renaming a child must be picked up by the resolved layout
+    auto cell = panels[0]->getChildByName("panel0_cell0");
+    cell->setName("unmanaged");
+    cell->setPosition(-1,-1);
+    panels[0]->setContentSize(300, 300);
+    CUAssertAlwaysLog(cell->getPosition() == cugl::Vec2(-1,-1), "Layout moved an unregistered child");
+    CUAssertAlwaysLog(!panels[0]->isLayoutDirty(), "Layout left the panel dirty");
+    CULog("Layout test passed");
+}
+
+
+/** Returns a closed tile outline, flattened from a random Catmull-Rom blob */
+static cugl::Poly2 splineOutline(std::minstd_rand& rand, int anchors, float cx, float cy) {
+    std::uniform_real_distribution<float> radius(0.5f,1.5f);
+    std::vector<cugl::Vec2> ring;
+    for(int ii = 0; ii < anchors; ii++) {
+        float angle = 2*M_PI*ii/anchors;
+        float r = radius(rand);
+        ring.push_back(cugl::Vec2(cx+r*cosf(angle),cy+r*sinf(angle)));
+    }
+    std::vector<cugl::Vec2> control;
+    for(int ii = 0; ii < anchors; ii++) {
+        cugl::Vec2 prev = ring[(ii+anchors-1) % anchors];
+        cugl::Vec2 next = ring[(ii+1) % anchors];
+        cugl::Vec2 after = ring[(ii+2) % anchors];
+        control.push_back(ring[ii]);
+        control.push_back(ring[ii]+(next-prev)/6.0f);
+        control.push_back(next-(after-ring[ii])/6.0f);
+    }
+    control.push_back(ring[0]);
+    
+    // The same flattening as the irregular tiles in GameScene
+    cugl::Spline2 spline(control);
+    spline.setClosed(true);
+    cugl::PolySplineFactory factory(&spline);
+    factory.calculate(cugl::PolySplineFactory::Criterion::DISTANCE, 0.07f);
+    cugl::Poly2 result = factory.getPath();
+    cugl::SimpleTriangulator triangulator;
+    triangulator.set(result);
+    triangulator.calculate();
+    result.setIndices(triangulator.getTriangulation());
+    result.setGeometry(cugl::Geometry::SOLID);
+    return result;
+}
+
+/** Returns a random star-shaped polygon with the given number of vertices */
+static cugl::Poly2 randomPolygon(std::minstd_rand& rand, int vertices, float cx, float cy) {
+    std::uniform_real_distribution<float> radius(0.2f,1.5f);
+    std::vector<cugl::Vec2> verts;
+    for(int ii = 0; ii < vertices; ii++) {
+        float angle = 2*M_PI*ii/vertices;
+        float r = radius(rand);
+        verts.push_back(cugl::Vec2(cx+r*cosf(angle),cy+r*sinf(angle)));
+    }
+    cugl::Poly2 result(verts);
+    result.setGeometry(cugl::Geometry::IMPLICIT);
+    return result;
+}
+
+void testPolyHitTester() {
+    const int POINTS = 4096;
+    const int PASSES = 20;
+    const int SHAPES = 64;
+    std::minstd_rand rand(4152);
+    std::uniform_real_distribution<float> coord(-2.0f,2.0f);
+    std::vector<cugl::Vec2> points;
+    for(int ii = 0; ii < POINTS; ii++) {
+        points.push_back(cugl::Vec2(coord(rand),coord(rand)));
+    }
+    
+    // Many points against one polygon
+    std::vector<std::pair<std::string,cugl::Poly2>> cases;
+    cases.push_back(std::make_pair("tile (6 anchors)",splineOutline(rand,6,0,0)));
+    cases.push_back(std::make_pair("tile (12 anchors)",splineOutline(rand,12,0,0)));
+    cases.push_back(std::make_pair("random (8 verts)",randomPolygon(rand,8,0,0)));
+    cases.push_back(std::make_pair("random (64 verts)",randomPolygon(rand,64,0,0)));
+    cases.push_back(std::make_pair("random (1024 verts)",randomPolygon(rand,1024,0,0)));
+    for(auto it = cases.begin(); it != cases.end(); ++it) {
+        const cugl::Poly2& poly = it->second;
+        cugl::PolyHitTester tester(poly);
+        cugl::PolyHitTester flat;
+        flat.setGridThreshold(0);
+        flat.add(poly);
+        
+        std::vector<Uint8> batch, grid;
+        flat.contains(0,points,batch);
+        tester.contains(0,points,grid);
+        size_t inside = 0;
+        for(int ii = 0; ii < POINTS; ii++) {
+            bool expected = poly.contains(points[ii]);
+            CUAssertAlwaysLog(tester.contains(0,points[ii]) == expected, "Hit test differs for %s at %d",it->first.c_str(),ii);
+            CUAssertAlwaysLog((batch[ii] == 1) == expected, "Batch hit test differs for %s at %d",it->first.c_str(),ii);
+            CUAssertAlwaysLog((grid[ii] == 1) == expected, "Grid hit test differs for %s at %d",it->first.c_str(),ii);
+            inside += expected;
+        }
+        
+        size_t total = 0;
+        cugl::Timestamp start;
+        for(int ii = 0; ii < PASSES; ii++) {
+            for(int jj = 0; jj < POINTS; jj++) {
+                total += poly.contains(points[jj]);
+            }
+        }
+        cugl::Timestamp middle;
+        for(int ii = 0; ii < PASSES; ii++) {
+            total += flat.contains(0,points,batch);
+        }
+        cugl::Timestamp end;
+        for(int ii = 0; ii < PASSES; ii++) {
+            total += tester.contains(0,points,grid);
+        }
+        cugl::Timestamp last;
+        CUAssertAlwaysLog(total == 3*PASSES*inside, "Hit counts differ for %s",it->first.c_str());
+        CULog("Hit test %-20s %5zu verts: Poly2 %8.1f us, batch %8.1f us, grid %8.1f us",
+              it->first.c_str(),poly.vertices().size(),
+              (double)cugl::Timestamp::ellapsedMicros(start,middle)/PASSES,
+              (double)cugl::Timestamp::ellapsedMicros(middle,end)/PASSES,
+              (double)cugl::Timestamp::ellapsedMicros(end,last)/PASSES);
+    }
+    
+    // One point against many polygons
+    std::uniform_real_distribution<float> center(-16.0f,16.0f);
+    std::vector<cugl::Poly2> shapes;
+    cugl::PolyHitTester tester;
+    for(int ii = 0; ii < SHAPES; ii++) {
+        float cx = center(rand);
+        float cy = center(rand);
+        shapes.push_back(ii % 2 ? splineOutline(rand,8,cx,cy) : randomPolygon(rand,16,cx,cy));
+        tester.add(shapes.back());
+    }
+    for(int ii = 0; ii < POINTS; ii++) {
+        points[ii] = cugl::Vec2(center(rand),center(rand));
+    }
+    
+    std::vector<Uint32> found;
+    Sint64 total = 0;
+    cugl::Timestamp start;
+    for(int ii = 0; ii < POINTS; ii++) {
+        for(int jj = 0; jj < SHAPES; jj++) {
+            if (shapes[jj].contains(points[ii])) {
+                total += jj;
+                break;
+            }
+        }
+    }
+    cugl::Timestamp middle;
+    for(int ii = 0; ii < POINTS; ii++) {
+        total -= std::max(tester.find(points[ii]),0);
+    }
+    cugl::Timestamp end;
+    CUAssertAlwaysLog(total == 0, "Polygon search differs");
+    for(int ii = 0; ii < POINTS; ii++) {
+        found.clear();
+        tester.findAll(points[ii],found);
+        size_t count = 0;
+        for(int jj = 0; jj < SHAPES; jj++) {
+            count += shapes[jj].contains(points[ii]);
+        }
+        CUAssertAlwaysLog(found.size() == count, "Polygon search missed a polygon at %d",ii);
+    }
+    CULog("Hit test %d polygons: Poly2 %8.1f us, find %8.1f us",SHAPES,
+          (double)cugl::Timestamp::ellapsedMicros(start,middle),
+          (double)cugl::Timestamp::ellapsedMicros(middle,end));
+    CULog("Hit test passed");
+}
+
+
+/** Returns a random open spline with the given number of segments */
+static cugl::Spline2 randomSpline(std::minstd_rand& rand, int segments) {
+    std::uniform_real_distribution<float> jitter(-1.0f,1.0f);
+    std::vector<cugl::Vec2> control;
+    cugl::Vec2 anchor;
+    for(int ii = 0; ii < segments; ii++) {
+        control.push_back(anchor);
+        control.push_back(anchor+cugl::Vec2(jitter(rand),jitter(rand)));
+        anchor += cugl::Vec2(2+jitter(rand),2*jitter(rand));
+        control.push_back(anchor+cugl::Vec2(jitter(rand),jitter(rand)));
+    }
+    control.push_back(anchor);
+    return cugl::Spline2(control);
+}
+
+void testSplineFlattener() {
+    const float TOLERANCE = 0.07f;
+    const int QUERIES = 20;
+    std::minstd_rand rand(4152);
+    std::uniform_real_distribution<float> offset(-3.0f,3.0f);
+    
+    int sizes[] = {5, 100, 10000};
+    for(int size : sizes) {
+        cugl::Spline2 spline = randomSpline(rand,size);
+        
+        cugl::Timestamp start;
+        cugl::PolySplineFactory factory(&spline);
+        factory.calculate(cugl::PolySplineFactory::Criterion::DISTANCE, TOLERANCE);
+        cugl::Poly2 baseline = factory.getPath();
+        cugl::Timestamp middle;
+        cugl::SplineFlattener flattener(&spline);
+        flattener.calculate(TOLERANCE);
+        cugl::Poly2 flattened = flattener.getPath();
+        cugl::Timestamp end;
+        CUAssertAlwaysLog(!flattener.calculate(TOLERANCE), "Flattener did not cache the polyline");
+        CULog("Flatten %5d segments: factory %6zu verts %8.1f us, flattener %6zu verts %8.1f us",
+              size,baseline.vertices().size(),(double)cugl::Timestamp::ellapsedMicros(start,middle),
+              flattened.vertices().size(),(double)cugl::Timestamp::ellapsedMicros(middle,end));
+        
+        // Every curve point must be within tolerance of the polyline
+        for(int ii = 0; ii < std::min(size,1000); ii++) {
+            for(int jj = 0; jj < 10; jj++) {
+                cugl::Vec2 point = spline.getPoint(ii+jj/10.0f);
+                float error = point.distance(flattener.nearestPoint(point));
+                CUAssertAlwaysLog(error <= TOLERANCE, "Flattened segment %d is %f from the curve",ii,error);
+            }
+        }
+        
+        // Nearest point queries against the projection polynomial
+        std::vector<cugl::Vec2> queries;
+        for(int ii = 0; ii < QUERIES; ii++) {
+            cugl::Vec2 anchor = spline.getAnchor((ii*size)/QUERIES);
+            queries.push_back(anchor+cugl::Vec2(offset(rand),offset(rand)));
+        }
+        std::vector<float> exact, approx;
+        start.mark();
+        for(auto it = queries.begin(); it != queries.end(); ++it) {
+            exact.push_back(spline.nearestParameter(*it));
+        }
+        middle.mark();
+        for(auto it = queries.begin(); it != queries.end(); ++it) {
+            approx.push_back(flattener.nearestParameter(*it));
+        }
+        end.mark();
+        for(int ii = 0; ii < QUERIES; ii++) {
+            float d1 = queries[ii].distance(spline.getPoint(exact[ii]));
+            float d2 = queries[ii].distance(spline.getPoint(approx[ii]));
+            CUAssertAlwaysLog(d2 <= d1+2*TOLERANCE, "Nearest point %d is too far (%f vs %f)",ii,d2,d1);
+        }
+        CULog("Nearest %5d segments: spline %10.2f us, flattener %6.2f us",size,
+              (double)cugl::Timestamp::ellapsedMicros(start,middle)/QUERIES,
+              (double)cugl::Timestamp::ellapsedMicros(middle,end)/QUERIES);
+        
+        // Editing the spline invalidates the cache
+        spline.setAnchor(0,spline.getAnchor(0)+cugl::Vec2(0.5f,0.5f));
+        CUAssertAlwaysLog(!flattener.isCalculated() && flattener.calculate(TOLERANCE), "Flattener missed a spline edit");
+    }
+    CULog("Spline flattener test passed");
+}
+
+
+void testSpatialGrid() {
+    const float MERGE = 10.0f;
+    const float CHASE = 8.944272f;
+    const int PASSES = 10;
+    std::minstd_rand rand(4152);
+    
+    // Lumias and enemies spread over a level that grows with their number
+    int sizes[] = {10, 100, 1000, 10000};
+    for(int size : sizes) {
+        float width = 8.0f*sqrtf((float)size);
+        std::uniform_real_distribution<float> coord(0.0f,width);
+        std::vector<cugl::Vec2> lumias, enemies;
+        for(int ii = 0; ii < size; ii++) {
+            lumias.push_back(cugl::Vec2(coord(rand),coord(rand)));
+            enemies.push_back(cugl::Vec2(coord(rand),coord(rand)));
+        }
+        cugl::Vec2 avatar = lumias[0];
+        
+        // Merge pull, avatar switch and enemy targeting as linear scans
+        std::vector<Uint32> merged;
+        std::vector<Sint32> chased(size);
+        Sint32 switched = -1;
+        cugl::Timestamp start;
+        for(int pass = 0; pass < PASSES; pass++) {
+            merged.clear();
+            for(int ii = 0; ii < size; ii++) {
+                if (avatar.distanceSquared(lumias[ii]) < MERGE*MERGE) {
+                    merged.push_back(ii);
+                }
+            }
+            float best = FLT_MAX;
+            for(int ii = 1; ii < size; ii++) {
+                float dist = avatar.distanceSquared(lumias[ii]);
+                if (dist < best) {
+                    best = dist;
+                    switched = ii;
+                }
+            }
+            for(int jj = 0; jj < size; jj++) {
+                best = FLT_MAX;
+                chased[jj] = -1;
+                for(int ii = 0; ii < size; ii++) {
+                    float dist = enemies[jj].distanceSquared(lumias[ii]);
+                    if (dist < best) {
+                        best = dist;
+                        chased[jj] = ii;
+                    }
+                }
+                if (best >= CHASE*CHASE) {
+                    chased[jj] = -1;
+                }
+            }
+        }
+        cugl::Timestamp middle;
+        
+        // The same queries against a grid, built once per pass
+        cugl::SpatialGrid grid;
+        std::vector<Uint32> nearby, pair;
+        std::vector<Sint32> targets(size);
+        for(int pass = 0; pass < PASSES; pass++) {
+            grid.build(lumias);
+            nearby.clear();
+            grid.query(avatar,MERGE,nearby);
+            pair.clear();
+            grid.nearest(avatar,2,pair);
+            for(int jj = 0; jj < size; jj++) {
+                targets[jj] = grid.nearest(enemies[jj],CHASE);
+            }
+        }
+        cugl::Timestamp end;
+        
+        std::sort(nearby.begin(),nearby.end());
+        CUAssertAlwaysLog(nearby == merged, "Merge query differs for %d Lumias",size);
+        CUAssertAlwaysLog(size == 1 || pair[pair[0] == 0 ? 1 : 0] == (Uint32)switched, "Switch query differs for %d Lumias",size);
+        CUAssertAlwaysLog(targets == chased, "Enemy targets differ for %d enemies",size);
+        CULog("Proximity %5d Lumias and enemies: scan %10.1f us, grid %8.1f us",size,
+              (double)cugl::Timestamp::ellapsedMicros(start,middle)/PASSES,
+              (double)cugl::Timestamp::ellapsedMicros(middle,end)/PASSES);
+    }
+    CULog("Spatial grid test passed");
+}
+
+/**
+ * Compares drawing many copies of a sprite one at a time and as instances.
+ *
+ * The first pass draws a PolygonNode once per copy with its own transform
+ * and tint, as the trajectory preview used to. The second draws the same
+ * copies from a single InstanceNode. This measures the CPU cost of
+ * submitting the copies to the sprite batch, including the flushes.
+ */
+void testInstanceNode() {
+    const int FRAMES = 10;
+    std::minstd_rand rand(4152);
+    std::uniform_real_distribution<float> coord(0.0f,1024.0f);
+    
+    std::vector<Uint32> pixels(16*16,0xffffffff);
+    auto texture = cugl::Texture::allocWithData(pixels.data(),16,16);
+    auto batch = cugl::SpriteBatch::alloc();
+    batch->setPerspective(cugl::Mat4::createOrthographic(1024,576,0.1f,10));
+    
+    int sizes[] = {100, 10000, 100000};
+    for(int size : sizes) {
+        std::vector<cugl::Vec2> points;
+        for(int ii = 0; ii < size; ii++) {
+            points.push_back(cugl::Vec2(coord(rand),coord(rand)));
+        }
+        
+        // One PolygonNode, drawn once per copy
+        auto dot = cugl::scene2::PolygonNode::allocWithTexture(texture);
+        cugl::Mat4 transform = dot->getNodeToWorldTransform();
+        cugl::Timestamp start;
+        for(int frame = 0; frame < FRAMES; frame++) {
+            batch->begin();
+            for(int ii = 0; ii < size; ii++) {
+                float alpha = 1-(ii/(float)size)*0.6f;
+                dot->draw(batch,transform*cugl::Mat4::createTranslation(points[ii].x,points[ii].y,0),
+                          cugl::Color4f(1,1,1,alpha));
+            }
+            batch->end();
+        }
+        cugl::Timestamp middle;
+        unsigned int single = batch->getCallsMade();
+        
+        // One InstanceNode, drawn once
+        auto dots = cugl::scene2::InstanceNode::allocWithTexture(texture);
+        for(int ii = 0; ii < size; ii++) {
+            float alpha = 1-(ii/(float)size)*0.6f;
+            dots->addInstance(points[ii],1.0f,0.0f,cugl::Color4f(1,1,1,alpha));
+        }
+        cugl::Timestamp middle2;
+        for(int frame = 0; frame < FRAMES; frame++) {
+            batch->begin();
+            dots->render(batch);
+            batch->end();
+        }
+        cugl::Timestamp end;
+        unsigned int instanced = batch->getCallsMade();
+        
+        CUAssertAlwaysLog(instanced <= single, "Instances took more draw calls for %d copies",size);
+        CULog("Sprites %6d copies: per node %10.1f us (%u draws), instanced %10.1f us (%u draws)",size,
+              (double)cugl::Timestamp::ellapsedMicros(start,middle)/FRAMES,single,
+              (double)cugl::Timestamp::ellapsedMicros(middle2,end)/FRAMES,instanced);
+    }
+    CULog("Instance node test passed");
+}
+
+
+/**
+ * Compares rendering a scene graph with matrices and with affine maps.
+ *
+ * This builds a wide tree (one root with 10k children) and a deep tree (a
+ * chain of 10k nodes), and renders each through a sprite batch with both
+ * paths. It also times the vertex transforms alone, as the sprite batch
+ * does them, to separate traversal cost from submission cost.
+ */
+void testAffineScene() {
+    const int NODES  = 10000;
+    const int FRAMES = 20;
+    
+    std::vector<Uint32> pixels(16*16,0xffffffff);
+    auto texture = cugl::Texture::allocWithData(pixels.data(),16,16);
+    auto batch = cugl::SpriteBatch::alloc();
+    batch->setPerspective(cugl::Mat4::createOrthographic(1024,576,0.1f,10));
+    
+    for(int deep = 0; deep < 2; deep++) {
+        auto root = cugl::scene2::SceneNode::alloc();
+        std::shared_ptr<cugl::scene2::SceneNode> parent = root;
+        for(int ii = 0; ii < NODES; ii++) {
+            auto node = cugl::scene2::PolygonNode::allocWithTexture(texture);
+            node->setPosition((ii % 100)*0.1f,(ii / 100)*0.1f);
+            node->setAngle(0.001f*ii);
+            parent->addChild(node);
+            if (deep) {
+                parent = node;
+            }
+        }
+        
+        cugl::Timestamp start;
+        for(int frame = 0; frame < FRAMES; frame++) {
+            batch->begin();
+            root->render(batch,cugl::Mat4::IDENTITY,cugl::Color4::WHITE);
+            batch->end();
+        }
+        cugl::Timestamp middle;
+        for(int frame = 0; frame < FRAMES; frame++) {
+            batch->begin();
+            root->render(batch,cugl::Affine2::IDENTITY,cugl::Color4::WHITE);
+            batch->end();
+        }
+        cugl::Timestamp end;
+        CULog("Scene %s %d nodes: matrix %10.1f us, affine %10.1f us",(deep ? "deep" : "wide"),NODES,
+              (double)cugl::Timestamp::ellapsedMicros(start,middle)/FRAMES,
+              (double)cugl::Timestamp::ellapsedMicros(middle,end)/FRAMES);
+        
+        // Unlink the chain so that it is not released recursively
+        parent = root;
+        while (parent->getChildCount() > 0) {
+            auto child = parent->getChild(0);
+            parent->removeAllChildren();
+            parent = child;
+        }
+    }
+    
+    // The vertex transforms alone, four vertices per node
+    std::vector<cugl::Vec2> verts;
+    for(int ii = 0; ii < 4*NODES; ii++) {
+        verts.push_back(cugl::Vec2((float)(ii % 37),(float)(ii % 91)));
+    }
+    cugl::Mat4 matrix = cugl::Mat4::createRotationZ(0.3f);
+    matrix.translate(3,4,0);
+    cugl::Affine2 affine(matrix);
+    std::vector<cugl::Vec3> result(verts.size());
+    
+    cugl::Timestamp start;
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(size_t ii = 0; ii < verts.size(); ii++) {
+            result[ii] = cugl::Vec3(verts[ii],0.5f);
+            result[ii] *= matrix;
+        }
+    }
+    cugl::Timestamp middle;
+    for(int frame = 0; frame < FRAMES; frame++) {
+        for(size_t ii = 0; ii < verts.size(); ii++) {
+            const float* m = affine.m;
+            result[ii].x = m[0]*verts[ii].x+m[2]*verts[ii].y+m[4];
+            result[ii].y = m[1]*verts[ii].x+m[3]*verts[ii].y+m[5];
+            result[ii].z = 0.5f;
+        }
+    }
+    cugl::Timestamp end;
+    CULog("Vertices %d: matrix %10.1f us, affine %10.1f us",(int)verts.size(),
+          (double)cugl::Timestamp::ellapsedMicros(start,middle)/FRAMES,
+          (double)cugl::Timestamp::ellapsedMicros(middle,end)/FRAMES);
+    CULog("Affine scene test passed");
+}
+
+/**
+ * Simulates 200 balls falling on 5000 static tiles.
+ *
+ * If rebuild is true, the static tree is bulk loaded before the balls are
+ * added. The contacts after the first (empty) step are stored in pairs, as
+ * obstacle indices, and the function returns the average step time in
+ * microseconds.
+ */
+double simulateStaticTree(bool rebuild, std::vector<std::pair<int,int>>& pairs) {
+    const int TILES = 5000;
+    const int BALLS = 200;
+    const int STEPS = 240;
+
+    std::shared_ptr<cugl::physics2::ObstacleWorld> world;
+    world = cugl::physics2::ObstacleWorld::alloc(cugl::Rect(0,0,400,100),cugl::Vec2(0,-9.8f));
+    std::minstd_rand random(7);
+    std::uniform_real_distribution<float> xdist(0,400);
+    std::uniform_real_distribution<float> ydist(0,60);
+
+    std::vector<std::shared_ptr<cugl::physics2::Obstacle>> obstacles;
+    for(int ii = 0; ii < TILES; ii++) {
+        auto tile = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(xdist(random),ydist(random)),cugl::Size(1,1));
+        tile->setBodyType(b2_staticBody);
+        world->addObstacle(tile);
+        obstacles.push_back(tile);
+    }
+
+    b2World* physics = world->getWorld();
+    if (rebuild) {
+        int height = physics->GetStaticTreeHeight();
+        float quality = physics->GetStaticTreeQuality();
+        cugl::Timestamp start;
+        world->rebuildStaticTree();
+        cugl::Timestamp end;
+        CULog("Static tree: height %d -> %d, quality %.2f -> %.2f in %lld us",
+              height, physics->GetStaticTreeHeight(), quality, physics->GetStaticTreeQuality(),
+              (long long)cugl::Timestamp::ellapsedMicros(start,end));
+        CUAssertAlwaysLog(physics->GetStaticTreeQuality() <= quality, "Static tree rebuild made the tree worse");
+    }
+
+    for(int ii = 0; ii < BALLS; ii++) {
+        auto ball = cugl::physics2::WheelObstacle::alloc(cugl::Vec2(xdist(random),ydist(random)+20),0.5f);
+        ball->setDensity(1.0f);
+        world->addObstacle(ball);
+        obstacles.push_back(ball);
+    }
+    std::unordered_map<void*,int> indices;
+    for(int ii = 0; ii < (int)obstacles.size(); ii++) {
+        indices[obstacles[ii]->getBody()->GetUserData()] = ii;
+    }
+
+    world->update(0);
+    pairs.clear();
+    for(b2Contact* c = physics->GetContactList(); c; c = c->GetNext()) {
+        int a = indices[c->GetFixtureA()->GetBody()->GetUserData()];
+        int b = indices[c->GetFixtureB()->GetBody()->GetUserData()];
+        pairs.push_back(std::make_pair(std::min(a,b),std::max(a,b)));
+    }
+    std::sort(pairs.begin(),pairs.end());
+
+    cugl::Timestamp start;
+    for(int ii = 0; ii < STEPS; ii++) {
+        world->update(1/60.0f);
+    }
+    cugl::Timestamp end;
+    world->clear();
+    return (double)cugl::Timestamp::ellapsedMicros(start,end)/STEPS;
+}
+
+void testStaticTree() {
+    std::vector<std::pair<int,int>> incremental;
+    std::vector<std::pair<int,int>> bulk;
+    double base = simulateStaticTree(false,incremental);
+    double time = simulateStaticTree(true,bulk);
+    CULog("Static tree: incremental %8.1f us/step, bulk %8.1f us/step",base,time);
+    CUAssertAlwaysLog(incremental == bulk, "Static tree rebuild changed the contacts");
+    CULog("Static tree test passed");
+}
+
+/**
+ * Records the telemetry of 200 boxes settling on a shared ground.
+ *
+ * The history is smaller than the number of steps, so it must wrap. The
+ * ground touches every box, so it must lead the hot list. Nothing may be
+ * recorded once telemetry is disabled.
+ */
+void testTelemetry() {
+    const int BOXES = 200;
+    const int STEPS = 240;
+    const int HISTORY = 100;
+    
+    std::shared_ptr<cugl::physics2::ObstacleWorld> world;
+    world = cugl::physics2::ObstacleWorld::alloc(cugl::Rect(0,0,2*BOXES+2,20),cugl::Vec2(0,-9.8f));
+    auto ground = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(BOXES+1,0.5f),cugl::Size(2*BOXES+2,1));
+    ground->setBodyType(b2_staticBody);
+    ground->setName("ground");
+    world->addObstacle(ground);
+    for(int ii = 0; ii < BOXES; ii++) {
+        auto box = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(2*ii+1.5f,2.0f),cugl::Size(1,1));
+        box->setDensity(1.0f);
+        world->addObstacle(box);
+    }
+    
+    CUAssertAlwaysLog(!world->isTelemetryEnabled(), "Telemetry is enabled by default");
+    world->setTelemetryEnabled(true);
+    world->setTelemetryCapacity(HISTORY);
+    cugl::Timestamp start;
+    for(int ii = 0; ii < STEPS; ii++) {
+        world->update(1/60.0f);
+    }
+    cugl::Timestamp end;
+    CULog("Telemetry: %8.1f us/step",(double)cugl::Timestamp::ellapsedMicros(start,end)/STEPS);
+    
+    CUAssertAlwaysLog(world->getTelemetryCount() == HISTORY, "Telemetry history did not wrap");
+    CUAssertAlwaysLog(world->getTelemetry(0).index == STEPS-HISTORY, "Telemetry history is out of order");
+    const cugl::physics2::PhysicsStats& last = world->getTelemetry(HISTORY-1);
+    CUAssertAlwaysLog(last.index == STEPS-1, "Telemetry history is missing the last step");
+    CUAssertAlwaysLog(last.staticBodies == 1, "Telemetry counted %d static bodies",last.staticBodies);
+    CUAssertAlwaysLog(last.awakeBodies+last.sleepingBodies == BOXES, "Telemetry lost bodies");
+    CUAssertAlwaysLog(last.touchingContacts == BOXES, "Telemetry counted %d touching contacts",
+                      last.touchingContacts);
+    
+    const std::vector<cugl::physics2::ObstacleContacts>& hot = world->getHotObstacles();
+    CUAssertAlwaysLog(hot.size() == DEFAULT_WORLD_HOTLIST, "Hot list has %zu obstacles",hot.size());
+    CUAssertAlwaysLog(hot[0].obstacle.lock() == ground && hot[0].contacts == BOXES,
+                      "Ground is not the hottest obstacle");
+    for(size_t ii = 1; ii < hot.size(); ii++) {
+        CUAssertAlwaysLog(hot[ii].contacts <= hot[ii-1].contacts, "Hot list is not ranked");
+    }
+    
+    std::string csv = world->getTelemetryCSV();
+    CUAssertAlwaysLog(std::count(csv.begin(),csv.end(),'\n') == HISTORY+1, "Telemetry CSV has the wrong length");
+    
+    world->setTelemetryEnabled(false);
+    for(int ii = 0; ii < 10; ii++) {
+        world->update(1/60.0f);
+    }
+    CUAssertAlwaysLog(world->getTelemetry(HISTORY-1).index == STEPS-1, "Disabled telemetry was recorded");
+    world->clearTelemetry();
+    CUAssertAlwaysLog(world->getTelemetryCount() == 0, "Telemetry was not cleared");
+    world->clear();
+    CULog("Telemetry test passed");
+}
+
+/**
+ * Simulates 50 boxes falling onto a level of 5000 static tiles.
+ *
+ * Every obstacle moves a scene node from its listener, and counts how often
+ * it is updated. The final box positions are stored in state, and the
+ * function returns the average step time in microseconds.
+ */
+double simulateSleepAware(bool aware, std::vector<float>& state, size_t& updates) {
+    const int TILES = 5000;
+    const int BOXES = 50;
+    const int STEPS = 600;
+    
+    std::shared_ptr<cugl::physics2::ObstacleWorld> world;
+    world = cugl::physics2::ObstacleWorld::alloc(cugl::Rect(0,0,500,100),cugl::Vec2(0,-9.8f));
+    world->setSleepAware(aware);
+    
+    updates = 0;
+    auto root = cugl::scene2::SceneNode::alloc();
+    auto track = [&](const std::shared_ptr<cugl::physics2::Obstacle>& obj) {
+        auto node = cugl::scene2::SceneNode::alloc();
+        root->addChild(node);
+        obj->setListener([&updates,node](cugl::physics2::Obstacle* obs) {
+            node->setPosition(obs->getPosition());
+            node->setAngle(obs->getAngle());
+            updates++;
+        });
+    };
+    
+    for(int ii = 0; ii < TILES; ii++) {
+        auto tile = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(0.1f*ii,0.5f+(ii % 3)*0.1f),cugl::Size(1,1));
+        tile->setBodyType(b2_staticBody);
+        world->addObstacle(tile);
+        track(tile);
+    }
+    std::vector<std::shared_ptr<cugl::physics2::BoxObstacle>> boxes;
+    for(int ii = 0; ii < BOXES; ii++) {
+        auto box = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(10.0f*ii+2,4.0f+(ii % 5)),cugl::Size(1,1));
+        box->setDensity(1.0f);
+        world->addObstacle(box);
+        track(box);
+        boxes.push_back(box);
+    }
+    world->rebuildStaticTree();
+    
+    // The first step places everything
+    world->update(1/60.0f);
+    cugl::Timestamp start;
+    for(int ii = 1; ii < STEPS; ii++) {
+        world->update(1/60.0f);
+    }
+    cugl::Timestamp end;
+    
+    state.clear();
+    for(auto it = boxes.begin(); it != boxes.end(); ++it) {
+        state.push_back((*it)->getX());
+        state.push_back((*it)->getY());
+        state.push_back((*it)->getAngle());
+    }
+    world->clear();
+    return (double)cugl::Timestamp::ellapsedMicros(start,end)/(STEPS-1);
+}
+
+void testSleepAware() {
+    std::vector<float> every;
+    std::vector<float> changed;
+    size_t base = 0;
+    size_t count = 0;
+    double full = simulateSleepAware(false,every,base);
+    double aware = simulateSleepAware(true,changed,count);
+    CULog("Sleep aware: every obstacle %8.1f us/step (%zu updates), changed only %8.1f us/step (%zu updates)",
+          full,base,aware,count);
+    CUAssertAlwaysLog(every == changed, "Sleep aware updates changed the simulation");
+    CUAssertAlwaysLog(count < base/10, "Sleep aware updates visited static obstacles");
+    
+    // Moving a sleeping or static obstacle by hand must still update it
+    auto world = cugl::physics2::ObstacleWorld::alloc(cugl::Rect(0,0,100,100),cugl::Vec2::ZERO);
+    auto wall = cugl::physics2::BoxObstacle::alloc(cugl::Vec2(10,10),cugl::Size(1,1));
+    wall->setBodyType(b2_staticBody);
+    world->addObstacle(wall);
+    int moves = 0;
+    wall->setListener([&moves](cugl::physics2::Obstacle*) { moves++; });
+    world->update(1/60.0f);
+    world->update(1/60.0f);
+    CUAssertAlwaysLog(moves == 1, "Static obstacle updated %d times",moves);
+    wall->setPosition(cugl::Vec2(20,20));
+    world->update(1/60.0f);
+    world->update(1/60.0f);
+    CUAssertAlwaysLog(moves == 2, "Moved static obstacle was not updated");
+    
+    // Resizing a static obstacle (like a button) must rebuild its fixture
+    auto bounds = [&wall]() {
+        b2AABB box;
+        b2Transform ident;
+        ident.SetIdentity();
+        wall->getBody()->GetFixtureList()->GetShape()->ComputeAABB(&box,ident,0);
+        return box.upperBound.y-box.lowerBound.y;
+    };
+    float before = bounds();
+    wall->setHeight(0.25f);
+    world->update(1/60.0f);
+    float after = bounds();
+    CUAssertAlwaysLog(std::abs(before-1) < 0.1f && std::abs(after-0.25f) < 0.1f,
+                      "Resized static obstacle has height %f, not 0.25",after);
+    world->clear();
+    CULog("Sleep aware test passed");
+}
+
+/** A test sound that plays a constant value for a fixed number of frames */
+class ConstantNode : public cugl::audio::AudioNode {
+private:
+    float _value;
+    Uint32 _length;
+    Uint32 _position;
+public:
+    ConstantNode() : _value(0), _length(0), _position(0) {}
+    
+    bool init(Uint8 channels, Uint32 rate, float value, Uint32 length) {
+        _value = value;
+        _length = length;
+        _position = 0;
+        return cugl::audio::AudioNode::init(channels,rate);
+    }
+    
+    static std::shared_ptr<ConstantNode> alloc(Uint8 channels, Uint32 rate, float value, Uint32 length) {
+        std::shared_ptr<ConstantNode> result = std::make_shared<ConstantNode>();
+        return (result->init(channels,rate,value,length) ? result : nullptr);
+    }
+    
+    virtual Uint32 read(float* buffer, Uint32 frames) override {
+        Uint32 amt = std::min(frames,_length-_position);
+        std::fill(buffer,buffer+amt*_channels,_value);
+        _position += amt;
+        return amt;
+    }
+    
+    virtual bool completed() override { return _position >= _length; }
+    
+    virtual bool reset() override {
+        _position = 0;
+        return true;
+    }
+};
+
+/** The state of one burst of sound effects for testAudioCommands */
+struct AudioBurst {
+    /** The main thread cost of starting the burst */
+    double cost;
+    /** The mean callback time */
+    double mean;
+    /** The standard deviation of the callback time */
+    double jitter;
+    /** The longest callback time */
+    double worst;
+    /** The mean distance from the intended start frame */
+    double error;
+};
+
+/**
+ * Fires a burst of effects each callback, either directly or through a dispatcher
+ */
+AudioBurst burstAudio(bool batched, Uint32 effects, Uint32 frames, Uint32 rounds) {
+    const Uint32 RATE = 48000;
+    const Uint32 GROUP = 16;
+    
+    // Mixers are limited in width, so we use a two level mix
+    auto root = cugl::audio::AudioMixer::alloc(GROUP,2,RATE);
+    auto dispatch = cugl::audio::AudioDispatcher::alloc(root,2*effects);
+    std::vector<std::shared_ptr<cugl::audio::AudioScheduler>> slots;
+    for(Uint32 ii = 0; ii < GROUP; ii++) {
+        auto group = cugl::audio::AudioMixer::alloc(GROUP,2,RATE);
+        root->attach(ii,group);
+        for(Uint32 jj = 0; jj < GROUP && slots.size() < effects; jj++) {
+            auto slot = cugl::audio::AudioScheduler::alloc(2,RATE);
+            group->attach(jj,slot);
+            slots.push_back(slot);
+        }
+    }
+    
+    // Each effect is intended to start at its own frame of the callback,
+    // and it lasts until the end of that callback so the rounds are independent
+    std::vector<std::shared_ptr<ConstantNode>> nodes;
+    std::vector<Uint32> offsets;
+    for(Uint32 ii = 0; ii < effects; ii++) {
+        offsets.push_back((ii*frames)/effects);
+        nodes.push_back(ConstantNode::alloc(2,RATE,1.0f/effects,frames-offsets.back()));
+    }
+    
+    std::vector<float> buffer(2*frames);
+    std::vector<double> times;
+    AudioBurst result;
+    result.cost = 0;
+    result.error = 0;
+    for(Uint32 round = 0; round < rounds; round++) {
+        cugl::Timestamp start;
+        if (batched) {
+            // Record in reverse to exercise the sort on the audio thread
+            for(Uint32 ii = effects; ii > 0; ii--) {
+                nodes[ii-1]->reset();
+                dispatch->recordPlay(slots[ii-1],nodes[ii-1],0,offsets[ii-1]);
+            }
+            dispatch->submit();
+        } else {
+            for(Uint32 ii = effects; ii > 0; ii--) {
+                nodes[ii-1]->reset();
+                slots[ii-1]->play(nodes[ii-1]);
+            }
+        }
+        cugl::Timestamp middle;
+        dispatch->read(buffer.data(),frames);
+        cugl::Timestamp end;
+        result.cost += cugl::Timestamp::ellapsedNanos(start,middle)/1000.0;
+        times.push_back(cugl::Timestamp::ellapsedNanos(middle,end)/1000.0);
+        
+        // Find where each effect actually started from the mix
+        for(Uint32 ii = 0; ii < effects; ii++) {
+            Uint32 frame = 0;
+            float goal = (ii+1.0f)/effects;
+            while (frame < frames-1 && buffer[2*frame] < goal-0.25f/effects) {
+                frame++;
+            }
+            result.error += std::abs((double)frame-(double)offsets[ii]);
+        }
+        
+        // Sample accuracy is exact for the dispatcher
+        if (batched) {
+            for(Uint32 frame = 0; frame < frames; frame++) {
+                Uint32 started = 0;
+                while (started < effects && offsets[started] <= frame) {
+                    started++;
+                }
+                float expect = started*(1.0f/effects);
+                CUAssertAlwaysLog(std::abs(buffer[2*frame]-expect) < 1e-4f &&
+                                  std::abs(buffer[2*frame+1]-expect) < 1e-4f,
+                                  "Frame %u is %f, not %f",frame,buffer[2*frame],expect);
+            }
+        }
+    }
+    
+    result.cost /= rounds;
+    result.error /= rounds*effects;
+    result.mean = 0;
+    result.worst = 0;
+    for(auto it = times.begin(); it != times.end(); ++it) {
+        result.mean += *it;
+        result.worst = std::max(result.worst,*it);
+    }
+    result.mean /= times.size();
+    result.jitter = 0;
+    for(auto it = times.begin(); it != times.end(); ++it) {
+        result.jitter += (*it-result.mean)*(*it-result.mean);
+    }
+    result.jitter = std::sqrt(result.jitter/times.size());
+    return result;
+}
+
+/**
+ * Fires a burst of effects each callback through the audio engine
+ *
+ * The burst has more effects than the engine has slots, so the trailing
+ * effects must fail to play.  No slot is playing until the batch is applied
+ * (or, for direct plays, until the next callback), so this asserts that the
+ * engine never hands out a slot that an earlier play in the burst was given.
+ *
+ * Completion callbacks go through the application scheduler, which does not
+ * run here, so each round starts a fresh engine on the given (inactive)
+ * output instead of waiting for the keys to be collected.
+ */
+AudioBurst burstEngine(const std::shared_ptr<cugl::audio::AudioOutput>& output, bool batched,
+                       Uint32 slots, Uint32 effects, Uint32 frames, Uint32 rounds) {
+    Uint8  channels = output->getChannels();
+    Uint32 rate = output->getRate();
+    std::vector<std::string> keys;
+    std::vector<std::shared_ptr<ConstantNode>> nodes;
+    std::vector<Uint32> offsets;
+    double expect = 0;
+    for(Uint32 ii = 0; ii < effects; ii++) {
+        keys.push_back("effect"+std::to_string(ii));
+        offsets.push_back((ii*frames)/effects);
+        nodes.push_back(ConstantNode::alloc(channels,rate,1.0f/effects,frames-offsets.back()));
+        if (ii < slots) {
+            expect += (frames-offsets.back())*channels*(1.0/effects);
+        }
+    }
+    
+    std::vector<float> buffer(channels*frames);
+    std::vector<bool> started(effects);
+    std::vector<double> times;
+    AudioBurst result;
+    result.cost = 0;
+    result.error = 0;
+    for(Uint32 round = 0; round < rounds; round++) {
+        cugl::AudioEngine::start(output,slots);
+        cugl::AudioEngine* engine = cugl::AudioEngine::get();
+        std::shared_ptr<cugl::audio::AudioNode> root = output->getInput();
+        for(auto it = nodes.begin(); it != nodes.end(); ++it) {
+            (*it)->reset();
+        }
+        
+        cugl::Timestamp start;
+        if (batched) {
+            for(Uint32 ii = 0; ii < effects; ii++) {
+                started[ii] = engine->recordPlay(keys[ii],nodes[ii],false,1.0f,false,offsets[ii]);
+            }
+            engine->submit();
+        } else {
+            for(Uint32 ii = 0; ii < effects; ii++) {
+                started[ii] = engine->play(keys[ii],nodes[ii]);
+            }
+        }
+        cugl::Timestamp middle;
+        root->read(buffer.data(),frames);
+        cugl::Timestamp end;
+        result.cost += cugl::Timestamp::ellapsedNanos(start,middle)/1000.0;
+        times.push_back(cugl::Timestamp::ellapsedNanos(middle,end)/1000.0);
+        
+        for(Uint32 ii = 0; ii < effects; ii++) {
+            CUAssertAlwaysLog(started[ii] == (ii < slots), "Effect %u was %s a slot",
+                              ii, started[ii] ? "given" : "denied");
+        }
+        
+        // A slot given out twice would cut one effect off
+        double total = 0;
+        for(auto it = buffer.begin(); it != buffer.end(); ++it) {
+            total += *it;
+        }
+        CUAssertAlwaysLog(std::abs(total-expect) < 1e-2, "Mix total is %f, not %f",total,expect);
+        for(Uint32 ii = 0; ii < slots; ii++) {
+            Uint32 frame = 0;
+            float goal = (ii+1.0f)/effects;
+            while (frame < frames-1 && buffer[channels*frame] < goal-0.25f/effects) {
+                frame++;
+            }
+            result.error += std::abs((double)frame-(double)offsets[ii]);
+        }
+        cugl::AudioEngine::stop();
+    }
+    
+    result.cost /= rounds;
+    result.error /= rounds*slots;
+    result.mean = 0;
+    result.worst = 0;
+    for(auto it = times.begin(); it != times.end(); ++it) {
+        result.mean += *it;
+        result.worst = std::max(result.worst,*it);
+    }
+    result.mean /= times.size();
+    result.jitter = 0;
+    for(auto it = times.begin(); it != times.end(); ++it) {
+        result.jitter += (*it-result.mean)*(*it-result.mean);
+    }
+    result.jitter = std::sqrt(result.jitter/times.size());
+    return result;
+}
+
+/**
+ * Checks the forced replacement, volume and pan commands of the audio engine
+ */
+void checkEngineCommands(const std::shared_ptr<cugl::audio::AudioOutput>& output) {
+    const Uint32 FRAMES = 512;
+    Uint32 rate = output->getRate();
+    cugl::AudioEngine::start(output,4);
+    cugl::AudioEngine* engine = cugl::AudioEngine::get();
+    std::shared_ptr<cugl::audio::AudioNode> root = output->getInput();
+    
+    // One stereo effect per slot, each with its own level
+    for(Uint32 ii = 0; ii < 4; ii++) {
+        auto node = ConstantNode::alloc(2,rate,(float)(1 << ii),8*FRAMES);
+        engine->recordPlay("effect"+std::to_string(ii),node);
+    }
+    CUAssertAlwaysLog(engine->submit() == 4, "Effects were not submitted");
+    std::vector<float> buffer(2*FRAMES);
+    root->read(buffer.data(),FRAMES);
+    CUAssertAlwaysLog(buffer[2*FRAMES-2] == 15 && buffer[2*FRAMES-1] == 15, "Effects did not all start");
+    
+    // Forcing a fifth effect evicts the oldest one
+    auto node = ConstantNode::alloc(2,rate,16.0f,8*FRAMES);
+    CUAssertAlwaysLog(engine->recordPlay("effect4",node,false,1.0f,true), "Forced play failed");
+    CUAssertAlwaysLog(engine->isActive("effect4"), "Forced play is not active");
+    engine->recordVolume("effect1",0.5f);
+    engine->recordPanFactor("effect2",1.0f);
+    engine->submit();
+    root->read(buffer.data(),FRAMES);
+    
+    // Effect 2 is panned fully right, effect 1 is at half volume
+    float left  = buffer[2*FRAMES-2];
+    float right = buffer[2*FRAMES-1];
+    CUAssertAlwaysLog(left == 1+8+16 && right == 1+8+8+16, "Commands gave (%f,%f), not (25,33)",left,right);
+    cugl::AudioEngine::stop();
+}
+
+void testAudioCommands() {
+    const Uint32 EFFECTS = 256;
+    const Uint32 FRAMES  = 512;
+    const Uint32 ROUNDS  = 200;
+    
+    // Audio nodes need the device manager, but no device needs to be active
+    bool owner = (cugl::AudioDevices::get() == nullptr);
+    if (owner) {
+        cugl::AudioDevices::start();
+    }
+    AudioBurst direct  = burstAudio(false,EFFECTS,FRAMES,ROUNDS);
+    AudioBurst batched = burstAudio(true,EFFECTS,FRAMES,ROUNDS);
+    CULog("Audio burst of %u effects, %u frame callbacks",EFFECTS,FRAMES);
+    CULog("  direct:  main %7.1f us, callback %7.1f us (jitter %6.1f us, worst %7.1f us), start error %6.1f frames",
+          direct.cost,direct.mean,direct.jitter,direct.worst,direct.error);
+    CULog("  batched: main %7.1f us, callback %7.1f us (jitter %6.1f us, worst %7.1f us), start error %6.1f frames",
+          batched.cost,batched.mean,batched.jitter,batched.worst,batched.error);
+    CUAssertAlwaysLog(batched.error == 0, "Batched effects did not start on their frames");
+    
+    // Gain, pan and stop commands land on their frames too
+    auto slot = cugl::audio::AudioScheduler::alloc(2,48000);
+    auto fader = cugl::audio::AudioFader::alloc(2,48000);
+    auto panner = cugl::audio::AudioPanner::alloc(2,1,48000);
+    auto dispatch = cugl::audio::AudioDispatcher::alloc(slot);
+    panner->attach(ConstantNode::alloc(1,48000,1.0f,4*FRAMES));
+    panner->setPan(0,0,1);
+    panner->setPan(0,1,1);
+    fader->attach(panner);
+    dispatch->recordPlay(slot,fader,0,0);
+    dispatch->recordGain(fader,0.5f,100);
+    dispatch->recordPan(panner,0,1,0.0f,200);
+    dispatch->recordStop(slot,fader,0,300);
+    CUAssertAlwaysLog(dispatch->getPending() == 4, "Commands were not recorded");
+    CUAssertAlwaysLog(dispatch->submit() == 4, "Commands were not submitted");
+    std::vector<float> buffer(2*FRAMES);
+    dispatch->read(buffer.data(),FRAMES);
+    for(Uint32 frame = 0; frame < FRAMES; frame++) {
+        float left  = (frame < 100 ? 1.0f : (frame < 300 ? 0.5f : 0.0f));
+        float right = (frame < 200 ? left : 0.0f);
+        // The stop ramps down over its first frame
+        CUAssertAlwaysLog(frame == 300 || (buffer[2*frame] == left && buffer[2*frame+1] == right),
+                          "Frame %u is (%f,%f), not (%f,%f)",frame,buffer[2*frame],buffer[2*frame+1],left,right);
+    }
+    CUAssertAlwaysLog(dispatch->getAvailable() == DEFAULT_DISPATCH_SIZE, "Commands were not applied");
+    
+    // The same burst through AudioEngine, with its slot search and node pools
+    if (cugl::AudioEngine::get() != nullptr) {
+        CULog("Audio engine is running; skipping the engine burst");
+    } else {
+        // The output is never activated, so only this test reads it
+        auto output = cugl::AudioDevices::get()->openOutput();
+        // The engine mixer is at most 255 wide, and one input is for music
+        const Uint32 SLOTS = 254;
+        AudioBurst plays   = burstEngine(output,false,SLOTS,EFFECTS,FRAMES,ROUNDS/4);
+        AudioBurst records = burstEngine(output,true,SLOTS,EFFECTS,FRAMES,ROUNDS/4);
+        CULog("Audio engine burst of %u effects, %u slots",EFFECTS,SLOTS);
+        CULog("  play:        main %7.1f us, callback %7.1f us (jitter %6.1f us, worst %7.1f us), start error %6.1f frames",
+              plays.cost,plays.mean,plays.jitter,plays.worst,plays.error);
+        CULog("  recordPlay:  main %7.1f us, callback %7.1f us (jitter %6.1f us, worst %7.1f us), start error %6.1f frames",
+              records.cost,records.mean,records.jitter,records.worst,records.error);
+        CUAssertAlwaysLog(records.error == 0, "Recorded effects did not start on their frames");
+        checkEngineCommands(output);
+        cugl::AudioDevices::get()->closeOutput(output);
+    }
+    if (owner) {
+        cugl::AudioDevices::stop();
+    }
+    CULog("Audio command test passed");
+}
+
+/**
+ * Returns the largest difference between the vector and scalar versions of a kernel
+ *
+ * The kernel is called once with each setting of DSPMath::VECTORIZE, and
+ * the difference is relative to the magnitude of the scalar result.
+ */
+float kernelError(std::function<void(float*)> kernel, size_t size) {
+    std::vector<float> scalar(size+1);
+    std::vector<float> vector(size+1);
+    bool vectorize = cugl::dsp::DSPMath::VECTORIZE;
+    cugl::dsp::DSPMath::VECTORIZE = false;
+    kernel(scalar.data()+1);
+    cugl::dsp::DSPMath::VECTORIZE = true;
+    kernel(vector.data()+1);
+    cugl::dsp::DSPMath::VECTORIZE = vectorize;
+    
+    float error = 0;
+    for(size_t ii = 1; ii <= size; ii++) {
+        float diff = std::abs(scalar[ii]-vector[ii])/std::max(1.0f,std::abs(scalar[ii]));
+        error = std::max(error,diff);
+    }
+    return error;
+}
+
+/**
+ * Returns the average and worst callback time for a mix of fading voices
+ */
+std::pair<double,double> fadeVoices(Uint32 voices, Uint32 frames, Uint32 rounds) {
+    const Uint32 RATE = 48000;
+    auto mixer = cugl::audio::AudioMixer::alloc(voices,2,RATE);
+    for(Uint32 ii = 0; ii < voices; ii++) {
+        auto panner = cugl::audio::AudioPanner::alloc(2,1,RATE);
+        panner->attach(ConstantNode::alloc(1,RATE,1.0f/voices,frames*(rounds+1)));
+        panner->setPan(0,0,(ii+0.5f)/voices);
+        panner->setPan(0,1,1-(ii+0.5f)/voices);
+        auto fader = cugl::audio::AudioFader::alloc(panner);
+        // Long enough that every voice is fading in every callback
+        if (ii % 2) {
+            fader->fadeOut(2.0*frames*rounds/RATE);
+        } else {
+            fader->fadeIn(2.0*frames*rounds/RATE);
+        }
+        mixer->attach(ii,fader);
+    }
+    
+    std::vector<float> buffer(2*frames);
+    double total = 0;
+    double worst = 0;
+    for(Uint32 round = 0; round < rounds; round++) {
+        cugl::Timestamp start;
+        mixer->read(buffer.data(),frames);
+        cugl::Timestamp end;
+        double time = cugl::Timestamp::ellapsedNanos(start,end)/1000.0;
+        total += time;
+        worst = std::max(worst,time);
+    }
+    return std::make_pair(total/rounds,worst);
+}
+
+void testAudioRamps() {
+    std::mt19937 rng(4152);
+    std::uniform_real_distribution<float> dist(-1.0f,1.0f);
+    const float TOLERANCE = 1e-6f;
+    
+    // Compare each kernel to its scalar reference, including the tails
+    Uint32 sizes[] = { 1, 3, 7, 128, 509, 512 };
+    for(Uint32 channels = 1; channels <= 4; channels++) {
+        for(Uint32 frames : sizes) {
+            size_t size = frames*channels;
+            std::vector<float> input1(size+1);
+            std::vector<float> input2(size+1);
+            for(size_t ii = 0; ii <= size; ii++) {
+                input1[ii] = dist(rng);
+                input2[ii] = dist(rng);
+            }
+            
+            // Offset by one to test unaligned buffers
+            float* in1 = input1.data()+1;
+            float* in2 = input2.data()+1;
+            float step = 1.0f/frames;
+            float error = kernelError([=](float* out) {
+                cugl::dsp::DSPMath::ramp(in1,channels,0.25f,step,out,frames);
+            },size);
+            CUAssertAlwaysLog(error <= TOLERANCE, "Ramp error %g for %u channels, %u frames",error,channels,frames);
+            error = kernelError([=](float* out) {
+                cugl::dsp::DSPMath::crossfade(in1,in2,channels,1.0f,-step,out,frames);
+            },size);
+            CUAssertAlwaysLog(error <= TOLERANCE, "Crossfade error %g for %u channels, %u frames",error,channels,frames);
+            error = kernelError([=](float* out) {
+                cugl::dsp::DSPMath::crossfade_power(in1,in2,channels,-0.1f,1.2f*step,out,frames);
+            },size);
+            CUAssertAlwaysLog(error <= TOLERANCE, "Power fade error %g for %u channels, %u frames",error,channels,frames);
+            
+            float matrix[8];
+            for(Uint32 ii = 0; ii < 8; ii++) {
+                matrix[ii] = (dist(rng)+1)/2;
+            }
+            error = kernelError([=](float* out) {
+                cugl::dsp::DSPMath::pan(in1,channels,matrix,2,out,frames);
+            },2*frames);
+            CUAssertAlwaysLog(error <= TOLERANCE, "Pan error %g for %u channels, %u frames",error,channels,frames);
+        }
+    }
+    
+    // A ramp scales both channels of a frame by the same gain
+    std::vector<float> stereo(2*509,0.5f);
+    cugl::dsp::DSPMath::ramp(stereo.data(),2,1.0f,-1.0f/509,stereo.data(),509);
+    for(Uint32 ii = 0; ii < 509; ii++) {
+        CUAssertAlwaysLog(stereo[2*ii] == stereo[2*ii+1], "Channels differ at frame %u",ii);
+    }
+    
+    // Equal power keeps the sum of the squared gains at 1
+    std::vector<float> ones(64,1.0f);
+    std::vector<float> zero(64,0.0f);
+    std::vector<float> left(64);
+    std::vector<float> rght(64);
+    cugl::dsp::DSPMath::crossfade_power(ones.data(),zero.data(),1,0,1.0f/64,left.data(),64);
+    cugl::dsp::DSPMath::crossfade_power(zero.data(),ones.data(),1,0,1.0f/64,rght.data(),64);
+    for(Uint32 ii = 0; ii < 64; ii++) {
+        float power = left[ii]*left[ii]+rght[ii]*rght[ii];
+        CUAssertAlwaysLog(std::abs(power-1) < 1e-5f, "Power is %f at frame %u",power,ii);
+    }
+    CULog("Audio ramp kernels match the scalar reference");
+    
+    // Callback cost for 32 voices fading at once
+    const Uint32 VOICES = 32;
+    const Uint32 FRAMES = 512;
+    const Uint32 ROUNDS = 500;
+    bool owner = (cugl::AudioDevices::get() == nullptr);
+    if (owner) {
+        cugl::AudioDevices::start();
+    }
+    bool vectorize = cugl::dsp::DSPMath::VECTORIZE;
+    cugl::dsp::DSPMath::VECTORIZE = false;
+    std::pair<double,double> scalar = fadeVoices(VOICES,FRAMES,ROUNDS);
+    cugl::dsp::DSPMath::VECTORIZE = true;
+    std::pair<double,double> vector = fadeVoices(VOICES,FRAMES,ROUNDS);
+    cugl::dsp::DSPMath::VECTORIZE = vectorize;
+    if (owner) {
+        cugl::AudioDevices::stop();
+    }
+    double budget = FRAMES*1000000.0/48000;
+    CULog("%u fading voices, %u frame callbacks (%.0f us budget)",VOICES,FRAMES,budget);
+    CULog("  scalar: %7.1f us (%4.1f%%), worst %7.1f us",scalar.first,100*scalar.first/budget,scalar.second);
+    CULog("  vector: %7.1f us (%4.1f%%), worst %7.1f us",vector.first,100*vector.first/budget,vector.second);
+}
 
 int main(int argc, char * argv[]) {
     cugl::Application app;
@@ -201,6 +2000,25 @@ int main(int argc, char * argv[]) {
     //testBinary();
     //testFree();
     //testThread();
+    //testArena();
+    //testArenaRestart();
+    //testIslands();
+    //testAnimation();
+    //testJson();
+    //testGLCalls();
+    //testStreaming();
+    //testAssetHandles();
+    //testLayout();
+    //testPolyHitTester();
+    //testSplineFlattener();
+    //testSpatialGrid();
+    //testInstanceNode();
+    //testAffineScene();
+    //testStaticTree();
+    //testTelemetry();
+    //testSleepAware();
+    //testAudioCommands();
+    //testAudioRamps();
     
     app.quit();
     app.onShutdown();
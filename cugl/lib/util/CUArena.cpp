@@ -0,0 +1,250 @@
+//
+//  CUArena.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a region (arena) allocator.  An arena hands out memory
+//  by bumping a pointer through a list of large pages.  Individual allocations
+//  are never freed.  Instead, the entire arena is rewound at once, which makes
+//  it ideal for data that shares a single lifetime, such as the contents of a
+//  game level.  Rewinding the arena keeps the pages, so a level that is reset
+//  or reloaded does not touch the system heap at all.
+//
+//  Because the arena never runs destructors, it should only be used for plain
+//  data, or for objects whose destructors have no side effects.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/util/CUArena.h>
+#include <cugl/util/CUDebug.h>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+using namespace cugl;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a new arena with no pages.
+ *
+ * You must initialize this arena before use.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an arena on
+ * the heap, use one of the static constructors instead.
+ */
+Arena::Arena() :
+_current(0),
+_offset(0),
+_pagesize(0),
+_generation(0),
+_allocations(0),
+_heapcalls(0),
+_usage(0),
+_peaksize(0) {
+}
+
+/**
+ * Disposes this arena, releasing all memory.
+ *
+ * A disposed arena can be safely reinitialized. However, an arena is the
+ * owner of all memory it allocates. Any object allocated by this arena
+ * will be unsafe to access.
+ */
+void Arena::dispose() {
+    for(auto it = _pages.begin(); it != _pages.end(); ++it) {
+        std::free(it->data);
+    }
+    _pages.clear();
+    _current  = 0;
+    _offset   = 0;
+    _pagesize = 0;
+    _allocations = 0;
+    _usage = 0;
+    _generation++;
+}
+
+/**
+ * Initializes an arena with the given page size.
+ *
+ * The first page is allocated immediately.
+ *
+ * @param pagesize  The default page size in bytes
+ *
+ * @return true if initialization was successful.
+ */
+bool Arena::init(size_t pagesize) {
+    CUAssertLog(_pages.empty(), "Arena is already initialized");
+    CUAssertLog(pagesize > 0, "Arena page size must be non-zero");
+    _pagesize = pagesize;
+    Page page;
+    page.data = (Uint8*)std::malloc(pagesize);
+    page.size = pagesize;
+    if (page.data == nullptr) {
+        return false;
+    }
+    _heapcalls++;
+    _pages.push_back(page);
+    _current = 0;
+    _offset  = 0;
+    return true;
+}
+
+
+#pragma mark -
+#pragma mark Accessors
+/**
+ * Returns true if the given pointer lies in a page of this arena.
+ *
+ * This is a debugging method, and is linear in the number of pages.
+ *
+ * @param ptr   The pointer to test
+ *
+ * @return true if the given pointer lies in a page of this arena.
+ */
+bool Arena::owns(const void* ptr) const {
+    const Uint8* addr = (const Uint8*)ptr;
+    for(auto it = _pages.begin(); it != _pages.end(); ++it) {
+        if (it->data <= addr && addr < it->data+it->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+#pragma mark -
+#pragma mark Memory Management
+/**
+ * Returns true if the current page can fit the request.
+ *
+ * If this method returns true, then _offset is advanced to the aligned
+ * address for the request.
+ *
+ * @param size  The number of bytes requested
+ * @param align The alignment of the request
+ *
+ * @return true if the current page can fit the request.
+ */
+bool Arena::fits(size_t size, size_t align) {
+    if (_current >= _pages.size()) {
+        return false;
+    }
+    const Page& page = _pages[_current];
+    uintptr_t base = (uintptr_t)page.data;
+    uintptr_t addr = (base+_offset+(align-1)) & ~((uintptr_t)align-1);
+    if (addr+size > base+page.size) {
+        return false;
+    }
+    _offset = (size_t)(addr-base);
+    return true;
+}
+
+/**
+ * Returns a pointer to size bytes of memory with the given alignment.
+ *
+ * The memory is uninitialized.  It remains valid until the next call to
+ * {@link reset()} or {@link dispose()}.  This method only returns nullptr
+ * if the system heap is exhausted.
+ *
+ * @param size  The number of bytes requested
+ * @param align The alignment of the request (a power of two)
+ *
+ * @return a pointer to size bytes of memory with the given alignment.
+ */
+void* Arena::malloc(size_t size, size_t align) {
+    CUAssertLog(_pagesize > 0, "Arena is not initialized");
+    CUAssertLog(align && !(align & (align-1)), "Alignment %zu is not a power of two", align);
+    bool found = fits(size,align);
+
+    // Look for a recycled page that fits
+    while (!found && _current+1 < _pages.size()) {
+        _current++;
+        _offset = 0;
+        found = fits(size,align);
+    }
+
+    // Allocate a new page
+    if (!found) {
+        Page page;
+        page.size = std::max(_pagesize,size+align);
+        page.data = (Uint8*)std::malloc(page.size);
+        if (page.data == nullptr) {
+            return nullptr;
+        }
+        _heapcalls++;
+        _pages.push_back(page);
+        _current = _pages.size()-1;
+        _offset  = 0;
+        found = fits(size,align);
+        CUAssertLog(found, "Arena page allocation failed");
+    }
+
+    void* result = _pages[_current].data+_offset;
+    _offset += size;
+    _allocations++;
+    _usage += size;
+    _peaksize = std::max(_peaksize,_usage);
+    return result;
+}
+
+/**
+ * Releases every allocation in constant time.
+ *
+ * This method rewinds the arena to the start of its first page.  The pages
+ * are kept so that later allocations do not need the system heap. It also
+ * increments the generation of this arena.
+ */
+void Arena::reset() {
+    _current = 0;
+    _offset  = 0;
+    _allocations = 0;
+    _usage = 0;
+    _generation++;
+}
+
+/**
+ * Releases every allocation and returns all but the first page to the heap.
+ *
+ * This is the method to use when the arena has grown much larger than its
+ * typical working set (e.g. after a very large level).  Like {@link reset()},
+ * it increments the generation of this arena.
+ */
+void Arena::trim() {
+    for(size_t ii = 1; ii < _pages.size(); ii++) {
+        std::free(_pages[ii].data);
+    }
+    if (_pages.size() > 1) {
+        _pages.resize(1);
+    }
+    reset();
+}
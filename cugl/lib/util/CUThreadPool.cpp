@@ -33,9 +33,44 @@
 //  Version: 11/29/16
 //
 #include <cugl/util/CUThreadPool.h>
+#include <algorithm>
+#include <atomic>
 
 using namespace cugl;
 
+/**
+ * The state shared by the participants of a parallel loop.
+ *
+ * This state is reference counted, as a worker may pick up its task after
+ * the loop is complete.  Such a worker must never touch the loop body.
+ */
+class ParallelLoop {
+public:
+    /** The loop body (only valid while the loop is running) */
+    const std::function<void(int,int)>* body;
+    /** The number of loop indices */
+    int count;
+    /** The next unclaimed index */
+    std::atomic<int> next;
+    /** The number of participants (used to number them) */
+    std::atomic<int> joined;
+    /** The number of worker threads currently in the loop */
+    std::atomic<int> active;
+    
+    /**
+     * Runs loop indices until there are none left.
+     *
+     * @param worker    The participant number
+     */
+    void run(int worker) {
+        int index = next++;
+        while (index < count) {
+            (*body)(index,worker);
+            index = next++;
+        }
+    }
+};
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -160,6 +195,57 @@ void ThreadPool::addTask(const std::function<void()> &task){
     _taskCondition.notify_one();
 }
 
+/**
+ * Runs the given function once for every index in [0,count).
+ *
+ * Unlike {@link addTask}, this method blocks until every index has been
+ * processed.  The calling thread takes part in the loop, and each worker
+ * thread joins it as soon as it is free.  Participants claim one index at
+ * a time, so a thread that finishes early simply picks up the remaining
+ * work.  For the best balance, order the work from largest to smallest.
+ *
+ * The function is passed the loop index and the participant number. The
+ * participant number is in the range [0,getThreadCount()], with 0 always
+ * the calling thread.  It can be used to index per-thread scratch data.
+ *
+ * As the calling thread takes part, this method never deadlocks, even if
+ * the workers are busy with other tasks.  In that case, the loop simply
+ * runs on the calling thread.  This method must not be called from a task
+ * of this pool.
+ *
+ * @param count     The number of loop indices
+ * @param body      The loop body, taking the index and participant number
+ */
+void ThreadPool::parallelFor(int count, const std::function<void(int index, int worker)>& body) {
+    if (count <= 0) {
+        return;
+    }
+    
+    std::shared_ptr<ParallelLoop> loop = std::make_shared<ParallelLoop>();
+    loop->body  = &body;
+    loop->count = count;
+    loop->next  = 0;
+    loop->joined = 1;
+    loop->active = 0;
+    
+    int helpers = std::min((int)_workers.size(),count-1);
+    for(int ii = 0; ii < helpers; ii++) {
+        addTask([=] {
+            // Mark as active BEFORE claiming, so the caller waits on us
+            loop->active++;
+            loop->run(loop->joined++);
+            loop->active--;
+        });
+    }
+    
+    loop->run(0);
+    
+    // Every index is claimed; wait for those still in progress
+    while (loop->active > 0) {
+        std::this_thread::yield();
+    }
+}
+
 /**
  * Stop the thread pool, marking it for shut down.
  *
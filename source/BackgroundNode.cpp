@@ -28,3 +28,16 @@ void BackgroundNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
     PolygonNode::draw(batch,transform * translation_mat_right4,tint);
     
 }
+
+void BackgroundNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    // The same copies as the matrix version, shifted after the transform
+    auto dim = Application::get()->getDisplaySize();
+    auto scale = dim.height/getTexture()->getHeight();
+    auto width = getTexture()->getWidth() * scale;
+    for (int i = -1; i <= 4; i++){
+        cugl::Affine2 shifted = transform;
+        shifted.m[4] += i * width;
+        PolygonNode::draw(batch,shifted,tint);
+    }
+}
@@ -9,8 +9,7 @@
 #include <stdio.h>
 
 #include "ButtonNode.h"
-void ButtonNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
+void ButtonNode::advanceFrame() {
     switch (_state){
         case Pressed:{
             setFrame(ANIMATION_SIZE - 1);
@@ -50,7 +49,17 @@ void ButtonNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
         }
     }
     _frameCount ++;
+}
+
+void ButtonNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Mat4& transform, cugl::Color4 tint) {
+    advanceFrame();
+    AnimationNode::draw(batch,transform,tint);
+}
+
+void ButtonNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    advanceFrame();
     AnimationNode::draw(batch,transform,tint);
-    
 }
 
@@ -38,11 +38,11 @@ void CollisionController::processPlantLumiaCollision(int newSize, const std::sha
             lumia->getAngularVelocity()
         };
 
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
-        _lumiasToCreate.push_back(lumiaNew);
+        _lumiasToCreate.push(lumiaNew);
     } else {
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
         lumia->setDying(true);
     }
@@ -61,11 +61,11 @@ void CollisionController::processSpikeLumiaCollision(int newSize, const std::sha
             lumia->getAngularVelocity()
         };
 
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
-        _lumiasToCreate.push_back(lumiaNew);
+        _lumiasToCreate.push(lumiaNew);
     } else {
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
         lumia->setDying(true);
     }
@@ -77,7 +77,7 @@ void CollisionController::processEnemyLumiaCollision(const std::shared_ptr<Enemy
     enemy->setVelocity(Vec2::ZERO);
 
     if (destroyEnemy) {
-        _enemiesToRemove.push_back(enemy);
+        _enemiesToRemove.push(enemy->getEventHandle());
         enemy->setRemoved(true);
     }
 
@@ -95,11 +95,11 @@ void CollisionController::processEnemyLumiaCollision(const std::shared_ptr<Enemy
             lumia->getAngularVelocity()
         };
 
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
-        _lumiasToCreate.push_back(lumiaNew);
+        _lumiasToCreate.push(lumiaNew);
     } else if (lumia->getSizeLevel() == 0 && newSize == 0) {
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
         lumia->setDying(true);
     }
@@ -109,7 +109,7 @@ void CollisionController::processEnergyLumiaCollision(const std::shared_ptr<Ener
     _didAbsorbEnergy = true;
     CULog("here");
     if (lumia->getSizeLevel() < LumiaModel::sizeLevels.size() - 1) {
-        _energiesToRemove.push_back(energy);
+        _energiesToRemove.push(energy->getEventHandle());
         energy->setRemoved(true);
 
         int newSize = lumia->getBiggerSizeLevel();
@@ -123,9 +123,9 @@ void CollisionController::processEnergyLumiaCollision(const std::shared_ptr<Ener
             lumia->getAngularVelocity()
         };
 
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
-        _lumiasToCreate.push_back(lumiaNew);
+        _lumiasToCreate.push(lumiaNew);
     }
 }
 
@@ -150,7 +150,7 @@ void CollisionController::processLumiaLumiaCollision(const std::shared_ptr<Lumia
                 lumia->getAngularVelocity()
             };
 
-            _lumiasToCreate.push_back(lumiaNew2);
+            _lumiasToCreate.push(lumiaNew2);
             _didmerging = true;
         }
 
@@ -165,12 +165,12 @@ void CollisionController::processLumiaLumiaCollision(const std::shared_ptr<Lumia
             lumia->getAngularVelocity()
         };
         
-        _lumiasToRemove.push_back(lumia);
+        _lumiasToRemove.push(lumia->getEventHandle());
         lumia->setRemoved(true);
-        _lumiasToRemove.push_back(lumia2);
+        _lumiasToRemove.push(lumia2->getEventHandle());
         lumia2->setRemoved(true);
 
-        _lumiasToCreate.push_back(lumiaNew);
+        _lumiasToCreate.push(lumiaNew);
     } 
 }
 
@@ -198,21 +198,47 @@ void CollisionController::processButtonLumiaEnding(const std::shared_ptr<LumiaMo
 void CollisionController::processStickyWallLumiaCollision(const std::shared_ptr<LumiaModel> lumia, const StickyWallModel* stickyWall){
     if (!lumia->getRemoved() && !lumia->isOnStickyWall()){
         lumia->setStickDirection(-stickyWall->getSurfaceNorm());
-        _lumiasToStick.push_back(lumia);
+        _lumiasToStick.push(lumia->getEventHandle());
     }
 }
 
 
 void CollisionController::processStickyWallLumiaEnding(const std::shared_ptr<LumiaModel> lumia){
     if (!lumia->getRemoved() && lumia->isOnStickyWall()){
-        _lumiasToUnstick.push_back(lumia);
+        _lumiasToUnstick.push(lumia->getEventHandle());
     }
 }
 
 void CollisionController::dispose(){
+    releaseAll();
+}
+
+void CollisionController::releaseAll(){
+    _lumiaHandles.clear();
+    _energyHandles.clear();
+    _enemyHandles.clear();
     clearStates();
 }
 
 bool CollisionController::init(){
+    // Preallocate so that a typical frame never allocates an event
+    _lumiaHandles.reserve(32);
+    _energyHandles.reserve(32);
+    _enemyHandles.reserve(16);
+    _lumiasToRemove.reserve(32);
+    _lumiasToCreate.reserve(32);
+    _lumiasToStick.reserve(16);
+    _lumiasToUnstick.reserve(16);
+    _energiesToRemove.reserve(16);
+    _enemiesToRemove.reserve(16);
+    _doorsToOpen.reserve(8);
+    clearStates();
     return true;
 }
+
+size_t CollisionController::getGrowthCount() const {
+    return (_lumiasToRemove.getGrowthCount() + _lumiasToCreate.getGrowthCount() +
+            _lumiasToStick.getGrowthCount() + _lumiasToUnstick.getGrowthCount() +
+            _energiesToRemove.getGrowthCount() + _enemiesToRemove.getGrowthCount() +
+            _doorsToOpen.getGrowthCount());
+}
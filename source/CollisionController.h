@@ -15,6 +15,7 @@
 #include "Button.h"
 #include "SlidingDoor.h"
 #include "StickyWallModel.h"
+#include "EventQueue.h"
 
 class CollisionController {
 public:
@@ -35,23 +36,42 @@ public:
         float angularVel;
     };
 
+    /**
+     * The event queues hold handles, which do not keep the models alive. A
+     * model is owned by the game scene (and the physics world) until it is
+     * removed, and the scene must release its handle when it does so. The
+     * spans skip any model whose handle was released after it was queued.
+     */
+    typedef HandleSpan<LumiaModel> LumiaSpan;
+    typedef EventQueue<LumiaBody>::Span LumiaBodySpan;
+    typedef HandleSpan<EnergyModel> EnergySpan;
+    typedef HandleSpan<EnemyModel> EnemySpan;
+    /** Doors are never removed during a level, so they are queued by pointer */
+    typedef EventQueue<SlidingDoor*>::Span DoorSpan;
+
 protected:
+    /** The handles of the Lumia bodies in the level */
+    HandleTable<LumiaModel> _lumiaHandles;
+    /** The handles of the energy items in the level */
+    HandleTable<EnergyModel> _energyHandles;
+    /** The handles of the enemies in the level */
+    HandleTable<EnemyModel> _enemyHandles;
 
-    /** List of Lumia bodies to remove in next update step */
-    std::list<std::shared_ptr<LumiaModel>> _lumiasToRemove;
-    /** List of Lumia bodies to create in next update step */
-    std::list<LumiaBody> _lumiasToCreate;
-    /** List of Lumia bodies to stick in next update step */
-    std::list<std::shared_ptr<LumiaModel>> _lumiasToStick;
-    /** List of Lumia bodies to Unstick in next update step */
-    std::list<std::shared_ptr<LumiaModel>> _lumiasToUnstick;
-    /** List of energy item sto remove in next update step */
-    std::list<std::shared_ptr<EnergyModel>> _energiesToRemove;
-    
-    std::list<std::shared_ptr<SlidingDoor>> _doorsToOpen;
+    /** Queue of Lumia bodies to remove in next update step */
+    EventQueue<EventHandle> _lumiasToRemove;
+    /** Queue of Lumia bodies to create in next update step */
+    EventQueue<LumiaBody> _lumiasToCreate;
+    /** Queue of Lumia bodies to stick in next update step */
+    EventQueue<EventHandle> _lumiasToStick;
+    /** Queue of Lumia bodies to Unstick in next update step */
+    EventQueue<EventHandle> _lumiasToUnstick;
+    /** Queue of energy items to remove in next update step */
+    EventQueue<EventHandle> _energiesToRemove;
+    
+    EventQueue<SlidingDoor*> _doorsToOpen;
 
-    /** List of Lumia bodies to remove in next update step */
-    std::list<std::shared_ptr<EnemyModel>> _enemiesToRemove;
+    /** Queue of enemies to remove in next update step */
+    EventQueue<EventHandle> _enemiesToRemove;
     
     bool _didLightup;
     
@@ -116,38 +136,89 @@ public:
     
     void clearStates();
     
-    void addLumiaToRemove(std::shared_ptr<LumiaModel> lumia){
-        _lumiasToRemove.push_back(lumia);
+    void addLumiaToRemove(const std::shared_ptr<LumiaModel>& lumia){
+        _lumiasToRemove.push(lumia->getEventHandle());
     }
 
+#pragma mark -
+#pragma mark Handles
+    /**
+     * Registers a model so that collision events may refer to it.
+     *
+     * A model must be registered when it is added to the level, and released
+     * when it is removed. Events queued for a released model are skipped.
+     */
+    void registerLumia(const std::shared_ptr<LumiaModel>& lumia) {
+        lumia->setEventHandle(_lumiaHandles.acquire(lumia.get()));
+    }
+
+    void releaseLumia(const std::shared_ptr<LumiaModel>& lumia) {
+        _lumiaHandles.release(lumia->getEventHandle());
+    }
+
+    void registerEnergy(const std::shared_ptr<EnergyModel>& energy) {
+        energy->setEventHandle(_energyHandles.acquire(energy.get()));
+    }
+
+    void releaseEnergy(const std::shared_ptr<EnergyModel>& energy) {
+        _energyHandles.release(energy->getEventHandle());
+    }
+
+    void registerEnemy(const std::shared_ptr<EnemyModel>& enemy) {
+        enemy->setEventHandle(_enemyHandles.acquire(enemy.get()));
+    }
+
+    void releaseEnemy(const std::shared_ptr<EnemyModel>& enemy) {
+        _enemyHandles.release(enemy->getEventHandle());
+    }
+
+    /**
+     * Releases every registered model and clears the event queues.
+     *
+     * This is called when the level is reset or unloaded.
+     */
+    void releaseAll();
+
+    /**
+     * Returns the number of times an event queue had to grow.
+     *
+     * After the first few frames, this should stop changing. If it does
+     * not, the initial capacities in init() are too small.
+     */
+    size_t getGrowthCount() const;
+
 #pragma mark -
 #pragma mark Attributes
-    std::list<std::shared_ptr<LumiaModel>> getLumiasToRemove(){
-        return _lumiasToRemove;
+    /*
+     * The spans below are views into the event queues. They are only valid
+     * until the next call to clearStates().
+     */
+    LumiaSpan getLumiasToRemove() const {
+        return LumiaSpan(_lumiasToRemove.items(), &_lumiaHandles);
     }
     
-    std::list<LumiaBody> getLumiasToCreate(){
-        return _lumiasToCreate;
+    LumiaBodySpan getLumiasToCreate() const {
+        return _lumiasToCreate.items();
     }
     
-    std::list<std::shared_ptr<LumiaModel>> getLumiasToStick(){
-        return _lumiasToStick;
+    LumiaSpan getLumiasToStick() const {
+        return LumiaSpan(_lumiasToStick.items(), &_lumiaHandles);
     }
 
-    std::list<std::shared_ptr<LumiaModel>> getLumiasToUnstick(){
-        return _lumiasToUnstick;
+    LumiaSpan getLumiasToUnstick() const {
+        return LumiaSpan(_lumiasToUnstick.items(), &_lumiaHandles);
     }
     
-    std::list<std::shared_ptr<EnergyModel>> getEnergiesToRemove(){
-        return _energiesToRemove;
+    EnergySpan getEnergiesToRemove() const {
+        return EnergySpan(_energiesToRemove.items(), &_energyHandles);
     }
     
-    std::list<std::shared_ptr<EnemyModel>> getEnemiesToRemove(){
-        return _enemiesToRemove;
+    EnemySpan getEnemiesToRemove() const {
+        return EnemySpan(_enemiesToRemove.items(), &_enemyHandles);
     }
     
-    std::list<std::shared_ptr<SlidingDoor>> getDoorsToOpen(){
-        return _doorsToOpen;
+    DoorSpan getDoorsToOpen() const {
+        return _doorsToOpen.items();
     }
     
     bool didLightup(){
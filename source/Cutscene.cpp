@@ -44,7 +44,7 @@ bool Cutscene::init(const std::shared_ptr<AssetManager>& assets, string sceneTyp
     _assets = assets;
     auto layer = assets->get<scene2::SceneNode>("cutscene");
     layer->setContentSize(dimen);
-    layer->doLayout(); // This rearranges the children to fit the screen
+    layer->updateLayout(); // This rearranges the children to fit the screen
     addChild(layer);
     
     shared_ptr<Texture> prologueTex11 = assets->get<Texture>("prologue1.1");
@@ -23,7 +23,7 @@
 * experience, using a rectangular shape for a character will regularly snag
 * on a platform.  The round shapes on the end caps lead to smoother movement.
 */
-class EnemyModel : public cugl::physics2::WheelObstacle {
+class EnemyModel : public cugl::physics2::WheelObstacle, public std::enable_shared_from_this<EnemyModel> {
 #pragma mark Constants and Enums
 protected:
 #define SIGNUM(x)  ((x > 0) - (x < 0))
@@ -91,6 +91,9 @@ protected:
     
     bool _inCoolDown;
 
+    /** The handle of this enemy in the collision event queues */
+    EventHandle _eventHandle;
+
 public:
     
 #pragma mark Hidden Constructors
@@ -331,9 +334,17 @@ public:
     /**
      * Sets velocity of enemy.
      *
+     * The velocity is applied after each physics step. A sleeping enemy is
+     * not updated after a step, so it is woken up to start moving.
+     *
      * @param value velocity of enemy.
      */
-    void setVelocity(cugl::Vec2 value) { _velocity = value; }
+    void setVelocity(cugl::Vec2 value) {
+        _velocity = value;
+        if (value != cugl::Vec2::ZERO && !isAwake()) {
+            setAwake(true);
+        }
+    }
 
     /**
      * Returns how hard the brakes are applied to get an enemy to stop moving
@@ -364,6 +375,12 @@ public:
     bool getRemoved(){
         return _removed;
     }
+
+    /** Returns the handle of this enemy in the collision event queues */
+    EventHandle getEventHandle() const { return _eventHandle; }
+
+    /** Sets the handle of this enemy in the collision event queues */
+    void setEventHandle(EventHandle handle) { _eventHandle = handle; }
     
     void update(float dt) override;
 };
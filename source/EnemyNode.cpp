@@ -39,6 +39,12 @@ bool EnemyNode::setTextures(const std::shared_ptr<cugl::Texture> &chasingAnimati
     return true;
 }
 
+void EnemyNode::setClock(const std::shared_ptr<cugl::scene2::AnimationClock>& clock){
+    _chasingAnimation->setClock(clock);
+    _escapingAnimation->setClock(clock);
+    applyAnimState();
+}
+
 void EnemyNode::setAnimState(EnemyAnimState state){
     switch (state){
         case Idle:
@@ -53,35 +59,28 @@ void EnemyNode::setAnimState(EnemyAnimState state){
             break;
         }
     }
-    _state = state;
-
+    if (_state != state){
+        _state = state;
+        applyAnimState();
+    }
 }
 
-void EnemyNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
+void EnemyNode::applyAnimState(){
+    if (_chasingAnimation == nullptr || _chasingAnimation->getClock() == nullptr){
+        return;
+    }
     
     switch (_state){
         case Chasing:{
-            _frameCount %= ANIMATION_INTERVAL;
-            
-            if (_frameCount == 0){
-                int frame = _chasingAnimation->getFrame() + 1 >= 12 ? 0 : _chasingAnimation->getFrame() + 1 ;
-                _chasingAnimation->setFrame(frame);
-            }
+            _escapingAnimation->stop();
+            _chasingAnimation->play(0, 11, ANIMATION_INTERVAL);
             break;
         }
         case Idle:
         case Escaping:{
-            _frameCount %= ANIMATION_INTERVAL;
-            
-            if (_frameCount == 0){
-                int frame = _escapingAnimation->getFrame() + 1 >= 12 ? 0 : _escapingAnimation->getFrame() + 1 ;
-                _escapingAnimation->setFrame(frame);
-            }
+            _chasingAnimation->stop();
+            _escapingAnimation->play(0, 11, ANIMATION_INTERVAL);
             break;
         }
     }
-    _frameCount++;
-    
-    SceneNode::draw(batch, transform, tint);
 }
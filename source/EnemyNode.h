@@ -29,8 +29,6 @@ public:
 protected:
     EnemyAnimState _state;
     
-    int _frameCount;
-    
     const int ANIMATION_INTERVAL = 8;
     
     std::shared_ptr<cugl::scene2::AnimationNode> _idleAnimation;
@@ -38,10 +36,13 @@ protected:
     std::shared_ptr<cugl::scene2::AnimationNode> _chasingAnimation;
     
     std::shared_ptr<cugl::scene2::AnimationNode> _escapingAnimation;
+    
+    /** Configures the animation clock for the current state */
+    void applyAnimState();
 
 public:
     
-    EnemyNode() : _state(Idle), _frameCount(0), SceneNode() {}
+    EnemyNode() : _state(Idle), SceneNode() {}
 
     ~EnemyNode() { dispose(); }
     
@@ -56,6 +57,15 @@ public:
     
     void setAnimState(EnemyAnimState state);
     
+    /**
+     * Sets the clock advancing the animations of this node.
+     *
+     * This must be called after {@link setTextures}.
+     *
+     * @param clock The clock advancing the animations (may be null)
+     */
+    void setClock(const std::shared_ptr<cugl::scene2::AnimationClock>& clock);
+    
     EnemyAnimState getAnimState(){
         return _state;
     }
@@ -70,9 +80,6 @@ public:
         _escapingAnimation->setRelativeColor(r);
     }
 
-    void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-              const cugl::Mat4& transform, cugl::Color4 tint) override;
-
     
 };
 
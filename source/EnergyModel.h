@@ -10,8 +10,9 @@
 #include <cugl/cugl.h>
 #include <cugl/physics2/CUBoxObstacle.h>
 #include "EnergyNode.h"
+#include "EventQueue.h"
 
-class EnergyModel : public cugl::physics2::BoxObstacle {
+class EnergyModel : public cugl::physics2::BoxObstacle, public std::enable_shared_from_this<EnergyModel> {
 private:
     /** This macro disables the copy constructor (not allowed on physics objects) */
     CU_DISALLOW_COPY_AND_ASSIGN(EnergyModel);
@@ -19,6 +20,8 @@ protected:
     float _drawScale;
     /* Whether or not this energy item is due to be or has been removed */
     bool _removed;
+    /** The handle of this energy item in the collision event queues */
+    EventHandle _eventHandle;
     std::shared_ptr<EnergyNode> _energyNode;
     std::shared_ptr<cugl::scene2::SceneNode> _node;
 public:
@@ -53,6 +56,8 @@ public:
         return _node;
     }
 
+    const std::shared_ptr<EnergyNode>& getEnergyNode() const { return _energyNode; }
+
     void setTextures(const std::shared_ptr<Texture>& texture);
     
     void setDrawScale(float scale) {
@@ -63,6 +68,12 @@ public:
 
     /* Returns whether or not this energy item is due to be or has been removed */
     bool getRemoved() { return _removed; }
+
+    /** Returns the handle of this energy item in the collision event queues */
+    EventHandle getEventHandle() const { return _eventHandle; }
+
+    /** Sets the handle of this energy item in the collision event queues */
+    void setEventHandle(EventHandle handle) { _eventHandle = handle; }
 };
 
 #endif /* __LM_ENERGY_MODEL_H__ */
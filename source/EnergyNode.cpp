@@ -10,16 +10,14 @@
 
 #include "EnergyNode.h"
 
-void EnergyNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
-    
-    _frameCount %= ANIMATION_INTERVAL;
-    if (_frameCount == 0){
-        int frame = getFrame() + 1 >= ANIMATION_COLS ? 0 : getFrame() + 1 ;
-        setFrame(frame);
+/**
+ * Sets the clock advancing this animation, and starts the idle loop.
+ *
+ * @param clock The clock advancing this animation (may be null)
+ */
+void EnergyNode::setClock(const std::shared_ptr<scene2::AnimationClock>& clock) {
+    AnimationNode::setClock(clock);
+    if (clock != nullptr) {
+        play(0, ANIMATION_COLS-1, ANIMATION_INTERVAL);
     }
-    _frameCount++;
-    AnimationNode::draw(batch,transform,tint);
-    
 }
-
@@ -14,8 +14,6 @@ using namespace cugl;
 
 class EnergyNode : public cugl::scene2::AnimationNode {
 protected:
-    int _frameCount;
-    
     const int ANIMATION_INTERVAL = 8;
     
     const int ANIMATION_ROWS = 1;
@@ -25,7 +23,7 @@ protected:
 public:
         
         
-    EnergyNode() : _frameCount(0), AnimationNode() {}
+    EnergyNode() : AnimationNode() {}
 
     ~EnergyNode() { dispose(); }
 
@@ -35,8 +33,12 @@ public:
         return (node->initWithFilmstrip(texture,rows,cols,size) ? node : nullptr);
     }
     
-    void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-              const cugl::Mat4& transform, cugl::Color4 tint) override;
+    /**
+     * Sets the clock advancing this animation, and starts the idle loop.
+     *
+     * @param clock The clock advancing this animation (may be null)
+     */
+    void setClock(const std::shared_ptr<scene2::AnimationClock>& clock) override;
 
 };
 
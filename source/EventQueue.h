@@ -0,0 +1,316 @@
+//
+//  EventQueue.h
+//  Lumia
+//
+//  A reusable, contiguous queue for per-frame events. The collision callbacks
+//  push events (raw handles to the models involved, or small value structs)
+//  while the physics world steps, and the game scene drains them once per
+//  frame. The buffer is never shrunk, so after the first few frames pushing
+//  an event never touches the heap, and clearing the queue is O(1).
+//
+//  Models are queued by handle rather than by pointer. A handle is a slot
+//  index and a generation in a HandleTable. Removing a model releases its
+//  slot, which bumps the generation, so any event still naming that model
+//  resolves to nullptr instead of a dangling pointer.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#ifndef EventQueue_h
+#define EventQueue_h
+#include <cugl/cugl.h>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class EventQueue {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "EventQueue only holds plain data and raw handles");
+public:
+    /**
+     * A read-only view of the events in a queue.
+     *
+     * A span is only valid until the queue is next cleared or pushed to. It
+     * records the generation of the queue when it was created, so that stale
+     * spans are caught in debug builds.
+     */
+    class Span {
+    private:
+        /** The queue this span views */
+        const EventQueue* _queue;
+        /** The first event */
+        const T* _data;
+        /** The number of events */
+        size_t _size;
+        /** The queue generation when this span was created */
+        Uint32 _generation;
+
+    public:
+        Span(const EventQueue* queue, const T* data, size_t size, Uint32 generation) :
+        _queue(queue), _data(data), _size(size), _generation(generation) {}
+
+        /** Returns true if the queue has not been cleared since this span was made */
+        bool isValid() const { return _generation == _queue->getGeneration(); }
+
+        const T* begin() const {
+            CUAssertLog(isValid(), "Event span used after the queue was cleared");
+            return _data;
+        }
+        const T* end() const { return _data+_size; }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        const T& operator[](size_t index) const {
+            CUAssertLog(isValid() && index < _size, "Event index %zu out of range", index);
+            return _data[index];
+        }
+    };
+
+private:
+    /** The event storage (its size is the capacity) */
+    std::vector<T> _buffer;
+    /** The number of events in the queue */
+    size_t _size;
+    /** The number of times this queue has been cleared */
+    Uint32 _generation;
+    /** The number of times the storage had to grow */
+    size_t _growth;
+
+public:
+    /**
+     * Creates an empty queue with the given capacity.
+     *
+     * @param capacity  The initial capacity
+     */
+    EventQueue(size_t capacity = 0) : _buffer(capacity), _size(0), _generation(0), _growth(0) {}
+
+    /**
+     * Ensures the queue can hold capacity events without allocating.
+     *
+     * @param capacity  The minimum capacity
+     */
+    void reserve(size_t capacity) {
+        if (capacity > _buffer.size()) {
+            _buffer.resize(capacity);
+        }
+    }
+
+    /**
+     * Adds an event to the end of the queue.
+     *
+     * This only allocates if the queue is at capacity. You should not push to
+     * a queue while iterating over one of its spans.
+     *
+     * @param value The event to add
+     */
+    void push(const T& value) {
+        if (_size == _buffer.size()) {
+            _buffer.resize(_buffer.empty() ? 16 : 2*_buffer.size());
+            _growth++;
+        }
+        _buffer[_size++] = value;
+    }
+
+    /**
+     * Removes all events in constant time.
+     *
+     * This invalidates every span of this queue.
+     */
+    void clear() {
+        _size = 0;
+        _generation++;
+    }
+
+    /** Returns a read-only view of the events in this queue */
+    Span items() const { return Span(this, _buffer.data(), _size, _generation); }
+
+    /** Returns the number of events in this queue */
+    size_t size() const { return _size; }
+
+    /** Returns true if this queue has no events */
+    bool empty() const { return _size == 0; }
+
+    /** Returns the number of events this queue can hold without allocating */
+    size_t capacity() const { return _buffer.size(); }
+
+    /** Returns the number of times this queue has been cleared */
+    Uint32 getGeneration() const { return _generation; }
+
+    /** Returns the number of times this queue had to allocate more storage */
+    size_t getGrowthCount() const { return _growth; }
+};
+
+/**
+ * A handle to a model registered in a HandleTable.
+ *
+ * The default handle is never valid, since slot generations start at 1.
+ */
+struct EventHandle {
+    /** The slot of the model in its table */
+    Uint32 index = 0;
+    /** The generation of the slot when the model was registered */
+    Uint32 generation = 0;
+};
+
+/**
+ * A table of slots mapping event handles to models.
+ *
+ * The table does not own its models. A model must be released from the table
+ * before it is disposed, so that stale handles stop resolving. Released slots
+ * are reused from a free list, so registering a model only allocates if the
+ * table is at capacity.
+ */
+template <typename T>
+class HandleTable {
+private:
+    /** A single table entry */
+    struct Slot {
+        /** The model in this slot (nullptr if free) */
+        T* object;
+        /** The current generation of this slot */
+        Uint32 generation;
+    };
+
+    /** The slots, indexed by handle */
+    std::vector<Slot> _slots;
+    /** The indices of the free slots */
+    std::vector<Uint32> _free;
+
+public:
+    /**
+     * Ensures the table can hold capacity models without allocating.
+     *
+     * @param capacity  The minimum capacity
+     */
+    void reserve(size_t capacity) {
+        _slots.reserve(capacity);
+        _free.reserve(capacity);
+    }
+
+    /**
+     * Returns a new handle for the given model.
+     *
+     * @param object    The model to register
+     *
+     * @return a new handle for the given model
+     */
+    EventHandle acquire(T* object) {
+        Uint32 index;
+        if (_free.empty()) {
+            index = (Uint32)_slots.size();
+            _slots.push_back({nullptr, 1});
+        } else {
+            index = _free.back();
+            _free.pop_back();
+        }
+        _slots[index].object = object;
+        return {index, _slots[index].generation};
+    }
+
+    /**
+     * Releases the slot of the given handle.
+     *
+     * Every copy of the handle is invalid afterwards. Releasing a handle that
+     * is already invalid does nothing.
+     *
+     * @param handle    The handle to release
+     */
+    void release(EventHandle handle) {
+        if (get(handle) == nullptr) {
+            return;
+        }
+        Slot& slot = _slots[handle.index];
+        slot.object = nullptr;
+        slot.generation++;
+        _free.push_back(handle.index);
+    }
+
+    /**
+     * Releases every slot in this table.
+     *
+     * The capacity is kept, so the table can be refilled without allocating.
+     */
+    void clear() {
+        _free.clear();
+        for (Uint32 ii = (Uint32)_slots.size(); ii > 0; ii--) {
+            Slot& slot = _slots[ii-1];
+            if (slot.object != nullptr) {
+                slot.object = nullptr;
+                slot.generation++;
+            }
+            _free.push_back(ii-1);
+        }
+    }
+
+    /**
+     * Returns the model for the given handle.
+     *
+     * @param handle    The handle to resolve
+     *
+     * @return the model for the given handle, or nullptr if it was released
+     */
+    T* get(EventHandle handle) const {
+        if (handle.index >= _slots.size() || _slots[handle.index].generation != handle.generation) {
+            return nullptr;
+        }
+        return _slots[handle.index].object;
+    }
+};
+
+/**
+ * A read-only view of a queue of handles, resolved through a table.
+ *
+ * Iterating over the span yields the models of the handles that are still
+ * valid, skipping any model released since its event was queued (including
+ * models released while iterating). Like EventQueue::Span, it is only valid
+ * until the queue is next cleared or pushed to.
+ */
+template <typename T>
+class HandleSpan {
+public:
+    /** A forward iterator over the live models of a span */
+    class Iterator {
+    private:
+        /** The current handle */
+        const EventHandle* _pos;
+        /** The end of the handles */
+        const EventHandle* _end;
+        /** The table to resolve handles with */
+        const HandleTable<T>* _table;
+
+        /** Advances past any handles that no longer resolve */
+        void skip() {
+            while (_pos != _end && _table->get(*_pos) == nullptr) {
+                _pos++;
+            }
+        }
+
+    public:
+        Iterator(const EventHandle* pos, const EventHandle* end, const HandleTable<T>* table) :
+        _pos(pos), _end(end), _table(table) { skip(); }
+
+        T* operator*() const { return _table->get(*_pos); }
+        Iterator& operator++() { _pos++; skip(); return *this; }
+        bool operator!=(const Iterator& other) const { return _pos != other._pos; }
+    };
+
+private:
+    /** The handles in the queue */
+    typename EventQueue<EventHandle>::Span _events;
+    /** The table to resolve handles with */
+    const HandleTable<T>* _table;
+
+public:
+    HandleSpan(const typename EventQueue<EventHandle>::Span& events, const HandleTable<T>* table) :
+    _events(events), _table(table) {}
+
+    Iterator begin() const { return Iterator(_events.begin(), _events.end(), _table); }
+    Iterator end() const { return Iterator(_events.end(), _events.end(), _table); }
+
+    /** Returns the number of events, including any that no longer resolve */
+    size_t size() const { return _events.size(); }
+    bool empty() const { return _events.empty(); }
+};
+
+#endif /* EventQueue_h */
@@ -46,6 +46,10 @@ using namespace cugl;
 #define BASIC_RESTITUTION   0.1f
 /** The number of frame to wait before reinitializing the game */
 #define EXIT_COUNT      119
+/** The number of animation frames between frames of the lose animation */
+#define LOSE_ANIMATION_INTERVAL 6
+/** The number of animation tracks to reserve for a level */
+#define ANIMATION_CAPACITY 128
 /** The size of an energy item */
 #define ENERGY_RADIUS  3.0f
 
@@ -122,6 +126,30 @@ using namespace cugl;
 
 #define SHRINK_SOUND "shrink"
 
+/** The shortest partial step when splitting the step at a launch */
+#define LAUNCH_MIN_STEP 0.002f
+
+/** The number of physics steps in the launch preview */
+#define TRAJECTORY_STEPS 40
+/** The number of physics steps between dots of the launch preview */
+#define TRAJECTORY_INTERVAL 5
+/** The width and height of a cell in the Lumia grid */
+#define LUMIA_GRID_CELL 4.0f
+/** The distance at which Lumias are pulled in by a merge */
+#define MERGE_RANGE 10.0f
+/** The distance at which enemies notice a Lumia */
+#define ENEMY_RANGE 8.944272f
+/** The extra room around a Lumia for a switch tap (in screen points) */
+#define SWITCH_SLOP 8.0f
+/** Set to 1 to outline the fixture bounding boxes in debug mode */
+#define DEBUG_DRAW_AABBS 0
+/** Set to 1 to mark the touching contacts in debug mode */
+#define DEBUG_DRAW_CONTACTS 1
+/** Set to 1 to outline the broadphase proxies in debug mode */
+#define DEBUG_DRAW_PROXIES 0
+/** The number of tile textures (named tile1, tile2, ...) */
+#define TILE_TEXTURES 9
+
 
 #pragma mark -
 #pragma mark Constructors
@@ -134,6 +162,7 @@ using namespace cugl;
 GameScene::GameScene() : Scene2(),
 	_worldnode(nullptr),
 	_debugnode(nullptr),
+	_debugRenderer(nullptr),
 	_world(nullptr),
 	_avatar(nullptr),
 	_debug(false),
@@ -152,57 +181,21 @@ GameScene::GameScene() : Scene2(),
  * The game world is scaled so that the screen coordinates do not agree
  * with the Box2d coordinates.  This initializer uses the default scale.
  *
+ * The level is taken from the streamer. If it was prefetched, the world
+ * and the scene graph are already built and only need to be attached.
+ *
  * @param assets    The (loaded) assets for this game mode
+ * @param streamer  The service building the levels
+ * @param level     The level to be loaded into the game world
  *
  * @return true if the controller is initialized properly, false otherwise.
  */
-bool GameScene::init(const std::shared_ptr<AssetManager>& assets, string level) {
+bool GameScene::init(const std::shared_ptr<AssetManager>& assets,
+                     const std::shared_ptr<LevelStreamer>& streamer, string level) {
     setName("game");
     _currentLevel = level;
-    _level = assets->get<LevelModel>(level);
-    _tileManager = assets->get<TileDataModel>("json/tiles.json");
+    _streamer = streamer;
     
-    return init(assets,Rect(0,0,DEFAULT_WIDTH,DEFAULT_HEIGHT),Vec2(0,DEFAULT_GRAVITY));
-}
-
-/**
- * Initializes the controller contents, and starts the game
- *
- * The constructor does not allocate any objects or memory.  This allows
- * us to have a non-pointer reference to this controller, reducing our
- * memory allocation.  Instead, allocation happens in this method.
- *
- * The game world is scaled so that the screen coordinates do not agree
- * with the Box2d coordinates.  The bounds are in terms of the Box2d
- * world, not the screen.
- *
- * @param assets    The (loaded) assets for this game mode
- * @param rect      The game bounds in Box2d coordinates
- *
- * @return  true if the controller is initialized properly, false otherwise.
- */
-bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& rect) {
-    return init(assets,rect,Vec2(0,DEFAULT_GRAVITY));
-}
-
-/**
- * Initializes the controller contents, and starts the game
- *
- * The constructor does not allocate any objects or memory.  This allows
- * us to have a non-pointer reference to this controller, reducing our
- * memory allocation.  Instead, allocation happens in this method.
- *
- * The game world is scaled so that the screen coordinates do not agree
- * with the Box2d coordinates.  The bounds are in terms of the Box2d
- * world, not the screen.
- *
- * @param assets    The (loaded) assets for this game mode
- * @param rect      The game bounds in Box2d coordinates
- * @param gravity   The gravitational force on this Box2d world
- *
- * @return  true if the controller is initialized properly, false otherwise.
- */
-bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& rect, const Vec2& gravity) {
     // Initialize the scene to a locked height (iPhone X is narrow, but wide)
     Size dimen = Application::get()->getDisplaySize();
     if (assets == nullptr) {
@@ -211,9 +204,18 @@ bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& re
         return false;
     }
     
+    // The level is flat, so combine node transforms as 2d affine maps
+    setPlanar(true);
     _assets = assets;
+    resolveAssets();
     _input = InputController::getInstance();
     _collisionController.init();
+    _debugRenderer = physics2::DebugRenderer::alloc();
+    _debugRenderer->setAABBsVisible(DEBUG_DRAW_AABBS);
+    _debugRenderer->setContactsVisible(DEBUG_DRAW_CONTACTS);
+    _debugRenderer->setProxiesVisible(DEBUG_DRAW_PROXIES);
+    _trajectory = TrajectoryPredictor::alloc(TRAJECTORY_STEPS, TRAJECTORY_INTERVAL);
+    _aimSerial = 0;
     
     std::shared_ptr<Texture> bkgTexture = assets->get<Texture>("background");
     std::shared_ptr<BackgroundNode> bkgNode = BackgroundNode::alloc(bkgTexture);
@@ -221,25 +223,20 @@ bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& re
     bkgNode->setPosition(0, 0);
     bkgNode->setScale(dimen.height/bkgTexture->getHeight());
    
-    // Create the world and attach the listeners.
-    _world = physics2::ObstacleWorld::alloc(rect,gravity);
-    _world->activateCollisionCallbacks(true);
-    _world->onBeginContact = [this](b2Contact* contact) {
-        beginContact(contact);
-    };
-    _world->onEndContact = [this](b2Contact* contact) {
-        endContact(contact);
-    };
+    // The world is built by the streamer (now, if it was not prefetched)
+    std::shared_ptr<PreparedLevel> prepared = _streamer->acquire(level);
+    _streamer->cancelAll();
+    _level = prepared->model;
     
     // IMPORTANT: SCALING MUST BE UNIFORM
     // This means that we cannot change the aspect ratio of the physics world
     // Shift to center if a bad fit
-    _scale = dimen.height/_level->getYBound();
+    _scale = prepared->scale;
 //    Vec2 offset((dimen.width-SCENE_WIDTH)/2.0f,(dimen.height-SCENE_HEIGHT)/2.0f);
     
     _UIscene = assets->get<scene2::SceneNode>("gameUI");
     _UIscene->setContentSize(dimen.width, dimen.height);
-    _UIscene->doLayout(); // Repositions the HUD;
+    _UIscene->updateLayout(); // Repositions the HUD;
     
     for (auto it : _UIscene->getChildren()) {
         std::shared_ptr<scene2::Button> button = std::dynamic_pointer_cast<scene2::Button>(it);
@@ -321,31 +318,21 @@ bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& re
     _scrollNode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
     //_scrollNode->setPosition(0, 0);
     
-    // Create the scene graph
-    _worldnode = scene2::SceneNode::alloc();
-    _worldnode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
-//    _worldnode->setPosition(offset);
-
-    _debugnode = scene2::SceneNode::alloc();
-    _debugnode->setScale(_scale); // Debug node draws in PHYSICS coordinates
-    _debugnode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
-//    _debugnode->setPosition(offset);
-
     _losenode = scene2::Label::alloc(LOSE_MESSAGE, _assets->get<Font>(MESSAGE_FONT));
     _losenode->setAnchor(Vec2::ANCHOR_CENTER);
     _losenode->setPosition(dimen.width/2.0f,dimen.height* 2/3.0f);
     _losenode->setForeground(Color4::WHITE);
     _losenode->setName("losenode");
+    _animations = scene2::AnimationClock::alloc(ANIMATION_CAPACITY);
     _loseAnimation = cugl::scene2::AnimationNode::alloc(assets->get<Texture>("death"), 4, 5, 20);
     _loseAnimation->setAnchor(Vec2::ANCHOR_CENTER);
     _loseAnimation->setPosition(dimen.width/2.0f,dimen.height/3.0f);
     _loseAnimation->setFrame(0);
+    _loseAnimation->setClock(_animations);
     _loseAnimation->setName("loseanimation");
     setFailure(false);
     
     _scrollNode->addChild(bkgNode);
-    _scrollNode->addChild(_worldnode, 1);
-    _scrollNode->addChild(_debugnode, 2);
     _UIscene->addChild(_losenode, 3);
     _UIscene->addChild(_loseAnimation, 4);
     
@@ -355,7 +342,8 @@ bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& re
     
     _musicVolume = 1.0f;
     _effectVolume = 1.0f;
-    populate();
+    populate(prepared);
+    _streamer->request(level, LevelStreamer::RESTART);
     _progressLabel = std::dynamic_pointer_cast<scene2::Label>(assets->get<scene2::SceneNode>("gameUI_progress_progresslabel"));
     _progressLabel->setText("0/" + to_string(_plantList.size()));
     float scrollpos = -1 * _avatar->getAvatarPos().x + getCamera()->getViewport().size.width * CAMERA_SHIFT;
@@ -365,6 +353,8 @@ bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& re
     _scrollNode->setPosition(scrollpos, 0);
 
     _ticks = 0;
+    _lumiaGrid.setCellSize(LUMIA_GRID_CELL);
+    _lumiaGridStale = true;
     _flashRedCooldown = 0;
     _lastSpikeCollision = NULL;
     setDebug(false);
@@ -375,6 +365,35 @@ bool GameScene::init(const std::shared_ptr<AssetManager>& assets, const Rect& re
     return true;
 }
 
+/**
+ * Resolves the handles for the assets used every frame.
+ *
+ * The handles remain valid if the assets are reloaded, so this only
+ * needs to be called once.
+ */
+void GameScene::resolveAssets() {
+    _pausedLumiaPlantLeft  = _assets->getHandle<scene2::SceneNode>("pausedUI_lumia-plant-left");
+    _pausedPlantLeft       = _assets->getHandle<scene2::SceneNode>("pausedUI_plant-left");
+    _pausedLumiaLeft       = _assets->getHandle<scene2::SceneNode>("pausedUI_lumia-left");
+    _pausedLumiaPlantRight = _assets->getHandle<scene2::SceneNode>("pausedUI_lumia-plant-right");
+    _pausedPlantRight      = _assets->getHandle<scene2::SceneNode>("pausedUI_plant-right");
+    _pausedLumiaRight      = _assets->getHandle<scene2::SceneNode>("pausedUI_lumia-right");
+
+    _loseMusic   = _assets->getHandle<Sound>(LOSE_MUSIC);
+    _winMusic    = _assets->getHandle<Sound>(WIN_MUSIC);
+    _splitSound1 = _assets->getHandle<Sound>(SPLIT_SOUND1);
+    _splitSound2 = _assets->getHandle<Sound>(SPLIT_SOUND2);
+    _lightSound  = _assets->getHandle<Sound>(LIGHT_SOUND);
+    _dieSound    = _assets->getHandle<Sound>(DIE_SOUND);
+    _growSound   = _assets->getHandle<Sound>(GROW_SOUND);
+    _shrinkSound = _assets->getHandle<Sound>(SHRINK_SOUND);
+
+    _lumiaTexture     = _assets->getHandle<Texture>(LUMIA_TEXTURE);
+    _splitTexture     = _assets->getHandle<Texture>(SPLIT_NAME);
+    _deathTexture     = _assets->getHandle<Texture>(DEATH_NAME);
+    _indicatorTexture = _assets->getHandle<Texture>(SIZE_INDICATOR);
+}
+
 /**
  * Disposes of all (non-static) resources allocated to this mode.
  */
@@ -385,9 +404,6 @@ void GameScene::dispose() {
     _collisionController.dispose();
     _trajectoryNode->dispose();
     _avatarIndicatorNode->dispose();
-    _level->resetLevel();
-    _sensorFixtureMap.clear();
-    _sensorFixtureMap2.clear();
     _graph.clear();
     if (_UIscene->getChildByName("losenode")) {
         _UIscene->removeChild(_losenode);
@@ -401,6 +417,7 @@ void GameScene::dispose() {
         l->dispose();
     }
     _lumiaList.clear();
+    _lumiaGrid.clear();
     _avatar = nullptr;
 
     for (const std::shared_ptr<Plant> &p : _plantList) {
@@ -442,8 +459,12 @@ void GameScene::dispose() {
 //    _tutorialList.clear();
 
     _world = nullptr;
+    _level = nullptr;
+    _streamer = nullptr;
+    _trajectory = nullptr;
     _worldnode = nullptr;
     _debugnode = nullptr;
+    _debugRenderer = nullptr;
     _losenode = nullptr;
     _progressLabel = nullptr;
     _failed = false;
@@ -467,13 +488,14 @@ void GameScene::reset() {
     _world->clear();
     _worldnode->removeAllChildren();
     _debugnode->removeAllChildren();
-    _sensorFixtureMap.clear();
-    _sensorFixtureMap2.clear();
+    _scrollNode->removeChild(_worldnode);
+    _scrollNode->removeChild(_debugnode);
     _graph.clear();
     for (const std::shared_ptr<LumiaModel> &l : _lumiaList) {
         l->dispose();
     }
     _lumiaList.clear();
+    _lumiaGrid.clear();
     _avatar = nullptr;
 
     for (const std::shared_ptr<Plant> &p : _plantList) {
@@ -506,13 +528,14 @@ void GameScene::reset() {
     }
     _enemyList.clear();
     std::queue<std::shared_ptr<LumiaModel>>().swap(_dyingLumiaQueue);
-    _collisionController.clearStates();
+    _collisionController.releaseAll();
     _trajectoryNode->dispose();
     _ticks = 0;
+    _lumiaGridStale = true;
     _lastSpikeCollision = NULL;
-    _level->resetLevel();
     setFailure(false);
-    populate();
+    populate(_streamer->acquire(_currentLevel));
+    _streamer->request(_currentLevel, LevelStreamer::RESTART);
     float scrollpos = -1 * _avatar->getAvatarPos().x + getCamera()->getViewport().size.width * CAMERA_SHIFT;
     if (scrollpos > 0){
         scrollpos = 0;
@@ -522,125 +545,273 @@ void GameScene::reset() {
 }
 
 /**
- * Lays out the game geography.
+ * Returns a level builder for the level streamer.
  *
- * Pay close attention to how we attach physics objects to a scene graph.
- * The simplest way is to make a subclass, like we do for the Dude.  However,
- * for simple objects you can just use a callback function to lightly couple
- * them.  This is what we do with the crates.
+ * Every asset the builder needs is resolved here, on the main thread, so
+ * that the builder may run on the streamer's workers.
+ *
+ * @param assets    The (loaded) assets for this game mode
  *
- * This method is really, really long.  In practice, you would replace this
- * with your serialization loader, which would process a level file.
+ * @return a level builder for the level streamer.
  */
-void GameScene::populate() {
-    
-    std::shared_ptr<Texture> image;
-    std::shared_ptr<scene2::PolygonNode> sprite;
-    std::vector<std::shared_ptr<Tile>> irregular_tiles = _level->getIrregularTile();
-   
+LevelStreamer::Builder GameScene::getLevelBuilder(const std::shared_ptr<AssetManager>& assets) {
+    auto textures = std::make_shared<std::unordered_map<std::string, std::shared_ptr<Texture>>>();
+    const char* keys[] = { "energy", "lamp", "spike", SLIDING_DOOR_NAME, SHRINKING_DOOR_NAME,
+                           BUTTON_NAME, STICKY_TEXTURE, LUMIA_TEXTURE, SPLIT_NAME, DEATH_NAME,
+                           SIZE_INDICATOR, ENEMY_CHASE, ENEMY_ESCAPE };
+    for (const char* key : keys) {
+        (*textures)[key] = assets->get<Texture>(key);
+    }
+    for (int ii = 1; ii <= TILE_TEXTURES; ii++) {
+        std::string key = "tile" + std::to_string(ii);
+        (*textures)[key] = assets->get<Texture>(key);
+    }
+
+    // Debug wireframes use the blank texture, which is created lazily with OpenGL
+    Texture::getBlank();
+
+    std::shared_ptr<TileDataModel> tiles = assets->get<TileDataModel>("json/tiles.json");
+    float height = Application::get()->getDisplaySize().height;
+    return [=](const std::string& path, const std::atomic<bool>& cancelled) {
+        return buildLevel(path, *textures, tiles, height, cancelled);
+    };
+}
+
+/**
+ * Returns the level with the given path, built from scratch.
+ *
+ * This method is safe to call from any thread. Every texture must be
+ * resolved beforehand, as the asset manager may only be used on the
+ * main thread. The build is abandoned if the cancel flag is set.
+ *
+ * @param path      The asset path of the level file
+ * @param textures  The textures used by the level, by asset key
+ * @param tiles     The tile geometry
+ * @param height    The height of the display
+ * @param cancelled The flag to abandon the build
+ *
+ * @return the level with the given path, built from scratch.
+ */
+std::shared_ptr<PreparedLevel> GameScene::buildLevel(const std::string& path,
+                                                     const std::unordered_map<std::string, std::shared_ptr<Texture>>& textures,
+                                                     const std::shared_ptr<TileDataModel>& tiles,
+                                                     float height, const std::atomic<bool>& cancelled) {
+    auto texture = [&](const std::string& key) {
+        auto it = textures.find(key);
+        CUAssertLog(it != textures.end(), "Level texture '%s' was not resolved", key.c_str());
+        return (it == textures.end() ? nullptr : it->second);
+    };
+
+    std::shared_ptr<PreparedLevel> level = std::make_shared<PreparedLevel>();
+    level->path  = path;
+    level->model = LevelModel::alloc(path);
+    if (level->model == nullptr || cancelled) {
+        return nullptr;
+    }
+    level->scale = height/level->model->getYBound();
+    level->buildTime = 0;
+
+    level->world = physics2::ObstacleWorld::alloc(Rect(0,0,DEFAULT_WIDTH,DEFAULT_HEIGHT),Vec2(0,DEFAULT_GRAVITY));
+    level->world->setArena(Arena::alloc());
+    level->world->activateCollisionCallbacks(true);
+
+    level->worldnode = scene2::SceneNode::alloc();
+    level->worldnode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
+    level->debugnode = scene2::SceneNode::alloc();
+    level->debugnode->setScale(level->scale); // Debug node draws in PHYSICS coordinates
+    level->debugnode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
+
+    const std::shared_ptr<LevelModel>& model = level->model;
+    float scale = level->scale;
+    std::vector<std::shared_ptr<Tile>> irregular_tiles = model->getIrregularTile();
     for (int i=0; i< irregular_tiles.size(); i++){
+        if (cancelled) {
+            return nullptr;
+        }
         std::shared_ptr<Tile> t = irregular_tiles[i];
-        vector<Vec2> tile_data = _tileManager->getTileData(t->getType()-1);
-        Spline2 sp = Spline2(tile_data);
-        sp.setClosed(true);
-        PolySplineFactory ft(&sp);
-        ft.calculate(PolySplineFactory::Criterion::DISTANCE, 0.07f);
-        std::shared_ptr<physics2::PolygonObstacle> platobj;
-        SimpleTriangulator triangulator;
-        Poly2 platform = ft.getPath();
-        triangulator.set(platform);
-        triangulator.calculate();
-        platform.setIndices(triangulator.getTriangulation());
-        platform.setGeometry(Geometry::SOLID);
-        
+        Poly2 platform = tiles->getTileOutline(t->getType()-1);
         platform += Vec2(t->getX(), t->getY());
-        std::shared_ptr<TileModel> tileobj = TileModel::alloc(platform);
+        std::shared_ptr<TileModel> tileobj = TileModel::alloc(platform, level->world->getArena());
         tileobj->setAngle(t->getAngle());
         tileobj->setName(PLATFORM_NAME);
-        tileobj->setDrawScale(_scale);;
+        tileobj->setDrawScale(scale);
         tileobj->setPosition(t->getX(), t->getY());
-        image = _assets->get<Texture>(t->getFile());
-        tileobj->setTextures(image);
+        tileobj->setTextures(texture(t->getFile()));
         tileobj->setType(t->getType());
-        addObstacle(tileobj, tileobj->getSceneNode(), 1);
+        addObstacle(level, tileobj, tileobj->getSceneNode(), 1);
+    }
+    if (cancelled) {
+        return nullptr;
     }
  
 #pragma mark : Energy
-    vector<std::shared_ptr<EnergyModel>> energies = _level->getEnergies();
-    image = _assets->get<Texture>("energy");
+    vector<std::shared_ptr<EnergyModel>> energies = model->getEnergies();
+    std::shared_ptr<Texture> image = texture("energy");
     for (int i = 0; i < energies.size(); i++) {
         auto energy = energies[i];
         energy->setVX(0);
-        energy->setDrawScale(_scale);
+        energy->setDrawScale(scale);
         energy->setTextures(image);
-        addObstacle(energy, energy->getNode(), 0);
-        _energyList.push_front(energy);
+        addObstacle(level, energy, energy->getNode(), 0);
     }
 
 #pragma mark : Plants
-    vector<std::shared_ptr<Plant>> plants = _level->getPlants();
-    image = _assets->get<Texture>("lamp");
+    vector<std::shared_ptr<Plant>> plants = model->getPlants();
+    image = texture("lamp");
     for (int i = 0; i < plants.size(); i++) {
         auto plant = plants[i];
-        plant->setDrawScale(_scale);
+        plant->setDrawScale(scale);
         plant->setTextures(image, plant->getAngle());
         plant->setVX(0);
-        addObstacle(plant, plant->getNode(), 0);
-        _plantList.push_front(plant);
+        addObstacle(level, plant, plant->getNode(), 0);
     }
 
 #pragma mark : Spikes
-    vector<std::shared_ptr<SpikeModel>> spikes = _level->getSpikes();
-    image = _assets->get<Texture>("spike");
+    vector<std::shared_ptr<SpikeModel>> spikes = model->getSpikes();
+    image = texture("spike");
     for (int i = 0; i < spikes.size(); i++) {
         auto spike = spikes[i];
-        spike->setDrawScale(_scale);
+        spike->setDrawScale(scale);
         spike->setTextures(image, spike->getAngle());
         spike->setVX(0);
-        addObstacle(spike, spike->getNode(), 0);
-        _spikeList.push_front(spike);
+        addObstacle(level, spike, spike->getNode(), 0);
+    }
+    if (cancelled) {
+        return nullptr;
     }
     
 #pragma mark : Buttons & Doors
-    std::vector<std::shared_ptr<Button>> buttons = _level->getButtons();
+    std::vector<std::shared_ptr<Button>> buttons = model->getButtons();
     for (int i = 0; i < buttons.size(); i++) {
         std::shared_ptr<Button> b = buttons[i];
         if (b->getIsSlidingDoor()){
             std::shared_ptr<SlidingDoor> d = b->getSlidingDoor();
-            d->setName("door " + toString(i));
-            image = _assets->get<Texture>(SLIDING_DOOR_NAME);
-            d->setDrawScale(_scale);
-            d->setTextures(image);
-            addObstacle(d,d->getSceneNode(),1);
-            _slidingDoorList.push_front(d);
+            d->setName("door " + std::to_string(i));
+            d->setDrawScale(scale);
+            d->setTextures(texture(SLIDING_DOOR_NAME));
+            addObstacle(level, d, d->getSceneNode(), 1);
         }else{
             std::shared_ptr<ShrinkingDoor> d2 = b->getShrinkingDoor();
-            d2->setName("door " + toString(i));
-            image = _assets->get<Texture>(SHRINKING_DOOR_NAME);
-            d2->setDrawScale(_scale);
-            d2->setTextures(image);
-            addObstacle(d2,d2->getSceneNode(),1, false);
-            _shrinkingDoorList.push_front(d2);
+            d2->setName("door " + std::to_string(i));
+            d2->setDrawScale(scale);
+            d2->setTextures(texture(SHRINKING_DOOR_NAME));
+            addObstacle(level, d2, d2->getSceneNode(), 1, false);
         }
         b->setName(BUTTON_NAME);
-        image = _assets->get<Texture>(BUTTON_NAME);
-        b->setDrawScale(_scale);
-        b->setTextures(image);
-        addObstacle(b,b->getSceneNode(),1);
-        _buttonList.push_front(b);
+        b->setDrawScale(scale);
+        b->setTextures(texture(BUTTON_NAME));
+        addObstacle(level, b, b->getSceneNode(), 1);
     }
     
 #pragma mark : Sticky Walls
-    std::vector<std::shared_ptr<StickyWallModel>> stickyWalls = _level->getStickyWalls();
-    image = _assets->get<Texture>(STICKY_TEXTURE);
+    std::vector<std::shared_ptr<StickyWallModel>> stickyWalls = model->getStickyWalls();
+    image = texture(STICKY_TEXTURE);
     for (int i = 0; i < stickyWalls.size(); i++) {
         std::shared_ptr<StickyWallModel> s = stickyWalls[i];
-        s->setDrawScale(_scale);
+        s->setDrawScale(scale);
         s->setTextures(image);
         s->setDebugColor(DEBUG_COLOR);
-        addObstacle(s, s->getSceneNode(), 1);
+        addObstacle(level, s, s->getSceneNode(), 1);
+    }
+    if (cancelled) {
+        return nullptr;
+    }
+
+#pragma mark : Lumia
+    std::shared_ptr<LumiaModel> avatar = model->getLumia();
+    avatar->setDrawScale(scale);
+    avatar->setTextures(texture(LUMIA_TEXTURE), texture(SPLIT_NAME), texture(DEATH_NAME), texture(SIZE_INDICATOR));
+    avatar->setName(LUMIA_NAME);
+    avatar->setDebugColor(DEBUG_COLOR);
+    addObstacle(level, avatar, avatar->getSceneNode(), 4); // Put this at the very front
+    
+#pragma mark : Enemies
+    vector<std::shared_ptr<EnemyModel>> enemies = model->getEnemies();
+    image = texture(ENEMY_ESCAPE);
+    std::shared_ptr<Texture> chasing = texture(ENEMY_CHASE);
+    for (int i = 0; i < enemies.size(); i++) {
+        std::shared_ptr<EnemyModel> enemy = enemies[i];
+        enemy->setDrawScale(scale);
+        enemy->setTextures(chasing, image);
+        enemy->setName(ENEMY_TEXTURE);
+        enemy->setDebugColor(DEBUG_COLOR);
+        addObstacle(level, enemy, enemy->getSceneNode(), 3);
+    }
+    if (cancelled) {
+        return nullptr;
+    }
+
+    // Every static obstacle is in place, so bulk load the static tree
+    level->world->rebuildStaticTree();
+    return level;
+}
+
+/**
+ * Lays out the game geography.
+ *
+ * The obstacles of a prepared level are already in its world, and their
+ * scene nodes are already in its world node. This method attaches the
+ * world and the scene graph to this scene, and then does the work that
+ * must happen on the main thread: animation clocks, contact listeners,
+ * tutorials and the trajectory.
+ *
+ * @param level The level prepared by the level streamer
+ */
+void GameScene::populate(const std::shared_ptr<PreparedLevel>& level) {
+    _level = level->model;
+    _world = level->world;
+    _world->onBeginContact = [this](b2Contact* contact) {
+        beginContact(contact);
+    };
+    _world->onEndContact = [this](b2Contact* contact) {
+        endContact(contact);
+    };
+
+    _worldnode = level->worldnode;
+    _debugnode = level->debugnode;
+    _scrollNode->addChild(_worldnode, 1);
+    _scrollNode->addChild(_debugnode, 2);
+
+    std::shared_ptr<Texture> image;
+ 
+    // Fill these lists back to front, which keeps the iteration order they
+    // had as linked lists filled with push_front
+#pragma mark : Energy
+    vector<std::shared_ptr<EnergyModel>> energies = _level->getEnergies();
+    for (int i = (int)energies.size()-1; i >= 0; i--) {
+        auto energy = energies[i];
+        energy->getEnergyNode()->setClock(_animations);
+        _collisionController.registerEnergy(energy);
+        _energyList.push_back(energy);
+    }
+
+#pragma mark : Plants
+    vector<std::shared_ptr<Plant>> plants = _level->getPlants();
+    for (int i = (int)plants.size()-1; i >= 0; i--) {
+        auto plant = plants[i];
+        plant->getPlantNode()->setClock(_animations);
+        _plantList.push_back(plant);
     }
 
+#pragma mark : Spikes
+    vector<std::shared_ptr<SpikeModel>> spikes = _level->getSpikes();
+    for (int i = (int)spikes.size()-1; i >= 0; i--) {
+        _spikeList.push_back(spikes[i]);
+    }
+    
+#pragma mark : Buttons & Doors
+    std::vector<std::shared_ptr<Button>> buttons = _level->getButtons();
+    for (int i = (int)buttons.size()-1; i >= 0; i--) {
+        std::shared_ptr<Button> b = buttons[i];
+        if (b->getIsSlidingDoor()){
+            _slidingDoorList.push_back(b->getSlidingDoor());
+        }else{
+            _shrinkingDoorList.push_back(b->getShrinkingDoor());
+        }
+        _buttonList.push_back(b);
+    }
+    updateTrajectoryGeometry();
+
 #pragma mark : Tutorials
     _tutorialList = _level->getTutorials();
     for (int i = 0; i < _tutorialList.size(); i++) {
@@ -663,34 +834,17 @@ void GameScene::populate() {
     }
 
 #pragma mark : Lumia
-    image = _assets->get<Texture>(LUMIA_TEXTURE);
-    std::shared_ptr<Texture> split = _assets->get<Texture>(SPLIT_NAME);
-    std::shared_ptr<Texture> death = _assets->get<Texture>(DEATH_NAME);
-    std::shared_ptr<Texture> indicator = _assets->get<Texture>(SIZE_INDICATOR);
     _avatar = _level->getLumia();
-    _avatar->setDrawScale(_scale);
-    _avatar->setTextures(image, split, death, indicator);
-    _avatar->setName(LUMIA_NAME);
-	_avatar->setDebugColor(DEBUG_COLOR);
+    _avatar->getSceneNode()->setClock(_animations);
+    _collisionController.registerLumia(_avatar);
     _lumiaList.push_back(_avatar);
-    std::unordered_set<b2Fixture*> fixtures;
-    _sensorFixtureMap[_avatar.get()] = fixtures;
-    std::unordered_set<b2Fixture*> fixtures2;
-    _sensorFixtureMap2[_avatar.get()] = fixtures2;
-	addObstacle(_avatar,_avatar->getSceneNode(), 4); // Put this at the very front
     
 #pragma mark : Enemies
     vector<std::shared_ptr<EnemyModel>> enemies = _level->getEnemies();
-    
-    image = _assets->get<Texture>(ENEMY_ESCAPE);
-    std::shared_ptr<Texture> chasing = _assets->get<Texture>(ENEMY_CHASE);
     for (int i = 0; i < enemies.size(); i++) {
         std::shared_ptr<EnemyModel> enemy = enemies[i];
-        enemy->setDrawScale(_scale);
-        enemy->setTextures(chasing, image);
-        enemy->setName(ENEMY_TEXTURE);
-        enemy->setDebugColor(DEBUG_COLOR);
-        addObstacle(enemy, enemy->getSceneNode(), 3);
+        enemy->getSceneNode()->setClock(_animations);
+        _collisionController.registerEnemy(enemy);
         _enemyList.push_back(enemy);
     }
     
@@ -737,21 +891,46 @@ void GameScene::addObstacle(const std::shared_ptr<cugl::physics2::Obstacle>& obj
     const std::shared_ptr<cugl::scene2::SceneNode>& node,
     int zOrder,
     bool useObjPosition) {
-    _world->addObstacle(obj);
-    obj->setDebugScene(_debugnode);
+    std::shared_ptr<PreparedLevel> level = std::make_shared<PreparedLevel>();
+    level->world = _world;
+    level->worldnode = _worldnode;
+    level->debugnode = _debugnode;
+    level->scale = _scale;
+    addObstacle(level, obj, node, zOrder, useObjPosition);
+}
+
+/**
+ * Adds the physics object to the given level and loosely couples it to its scene graph
+ *
+ * This is the version of {@link addObstacle} used while a level is built,
+ * possibly off the main thread.
+ *
+ * @param level           The level being built
+ * @param obj             The physics object to add
+ * @param node            The scene graph node to attach it to
+ * @param zOrder          The drawing order
+ * @param useObjPosition  Whether to update the node's position to be at the object's position
+ */
+void GameScene::addObstacle(const std::shared_ptr<PreparedLevel>& level,
+    const std::shared_ptr<cugl::physics2::Obstacle>& obj,
+    const std::shared_ptr<cugl::scene2::SceneNode>& node,
+    int zOrder,
+    bool useObjPosition) {
+    float scale = level->scale;
+    level->world->addObstacle(obj);
 
     // Position the scene graph node (enough for static objects)
     if (useObjPosition) {
-        node->setPosition(obj->getPosition() * _scale);
+        node->setPosition(obj->getPosition() * scale);
     }
-    _worldnode->addChild(node, zOrder);
+    level->worldnode->addChild(node, zOrder);
 
     // Dynamic objects need constant updating
     if (obj->getBodyType() == b2_dynamicBody) {
         scene2::SceneNode* weak = node.get(); // No need for smart pointer in callback
         obj->setListener([=](physics2::Obstacle* obs) {
             if (!obs->isRemoved()) {
-                weak->setPosition(obs->getPosition() * _scale);
+                weak->setPosition(obs->getPosition() * scale);
                 weak->setAngle(obs->getAngle());
             }
             });
@@ -773,7 +952,9 @@ void GameScene::update(float dt) {
         default:
             break;
     }
-    
+
+    // Sound effects are recorded as they happen and start together
+    AudioEngine::get()->submit();
 }
 
 
@@ -808,39 +989,39 @@ void GameScene::updatePaused(float dt, float startX) {
     }
 
     if (hasPlantLeft && hasLumiaLeft) {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-left"))->setVisible(true);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-left"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-left"))->setVisible(false);
+        _pausedLumiaPlantLeft->setVisible(true);
+        _pausedPlantLeft->setVisible(false);
+        _pausedLumiaLeft->setVisible(false);
     } else if (hasPlantLeft) {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-left"))->setVisible(true);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-left"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-left"))->setVisible(false);
+        _pausedPlantLeft->setVisible(true);
+        _pausedLumiaLeft->setVisible(false);
+        _pausedLumiaPlantLeft->setVisible(false);
     } else if (hasLumiaLeft) {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-left"))->setVisible(true);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-left"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-left"))->setVisible(false);
+        _pausedLumiaLeft->setVisible(true);
+        _pausedPlantLeft->setVisible(false);
+        _pausedLumiaPlantLeft->setVisible(false);
     } else {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-left"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-left"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-left"))->setVisible(false);
+        _pausedLumiaLeft->setVisible(false);
+        _pausedPlantLeft->setVisible(false);
+        _pausedLumiaPlantLeft->setVisible(false);
     }
 
     if (hasPlantRight && hasLumiaRight) {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-right"))->setVisible(true);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-right"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-right"))->setVisible(false);
+        _pausedLumiaPlantRight->setVisible(true);
+        _pausedPlantRight->setVisible(false);
+        _pausedLumiaRight->setVisible(false);
     } else if (hasPlantRight) {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-right"))->setVisible(true);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-right"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-right"))->setVisible(false);
+        _pausedPlantRight->setVisible(true);
+        _pausedLumiaRight->setVisible(false);
+        _pausedLumiaPlantRight->setVisible(false);
     } else if (hasLumiaRight) {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-right"))->setVisible(true);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-right"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-right"))->setVisible(false);
+        _pausedLumiaRight->setVisible(true);
+        _pausedPlantRight->setVisible(false);
+        _pausedLumiaPlantRight->setVisible(false);
     } else {
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-right"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_plant-right"))->setVisible(false);
-        std::dynamic_pointer_cast<scene2::TexturedNode>(_assets->get<cugl::scene2::SceneNode>("pausedUI_lumia-plant-right"))->setVisible(false);
+        _pausedLumiaRight->setVisible(false);
+        _pausedPlantRight->setVisible(false);
+        _pausedLumiaPlantRight->setVisible(false);
     }
 
 
@@ -866,13 +1047,19 @@ void GameScene::updatePaused(float dt, float startX) {
     
     if(!_input->isDragging() && _input->didSwitch()){
         cugl::Vec2 tapLocation = _input->getSwitch(); // screen coordinates
-
-        for (const std::shared_ptr<LumiaModel>& lumia : _lumiaList) {
+        cugl::Vec3 tapLocationWorld = getCamera()->screenToWorldCoords(tapLocation) - _scrollNode->getPosition();
+
+        // Only Lumias within the largest tap box of the tap can match
+        float reach = (LumiaModel::sizeLevels[LumiaModel::sizeLevels.size()-1].radius+SWITCH_SLOP/_scale)*M_SQRT2;
+        _nearby.clear();
+        getLumiaGrid().query(Vec2(tapLocationWorld.x, tapLocationWorld.y)/_scale, reach, _nearby);
+        std::sort(_nearby.begin(), _nearby.end());
+        for (Uint32 index : _nearby) {
+            const std::shared_ptr<LumiaModel>& lumia = _lumiaList[index];
             cugl::Vec2 lumiaPosition = lumia->getPosition() * _scale; // world coordinates
-            cugl::Vec3 tapLocationWorld = getCamera()->screenToWorldCoords(tapLocation) - _scrollNode->getPosition();
             float radius = lumia->getRadius() * _scale; // world coordinates
-            if (IN_RANGE(tapLocationWorld.x, (lumiaPosition.x - radius) - 8, (lumiaPosition.x + radius) + 8) &&
-                IN_RANGE(tapLocationWorld.y, (lumiaPosition.y - radius) - 8, (lumiaPosition.y + radius) + 8)) {
+            if (IN_RANGE(tapLocationWorld.x, (lumiaPosition.x - radius) - SWITCH_SLOP, (lumiaPosition.x + radius) + SWITCH_SLOP) &&
+                IN_RANGE(tapLocationWorld.y, (lumiaPosition.y - radius) - SWITCH_SLOP, (lumiaPosition.y + radius) + SWITCH_SLOP)) {
                 _avatar = lumia;
                 _state = GameState::Playing;
                 _UIscene->setVisible(true);
@@ -924,24 +1111,27 @@ void GameScene::updateGame(float dt) {
 	}
     
 
-    for (const std::shared_ptr<LumiaModel>& lumia : _collisionController.getLumiasToRemove()) {
+    // The spans skip models removed since their event was queued, so a model
+    // named by two events is only removed once. Take ownership only where needed
+    for (LumiaModel* lumia : _collisionController.getLumiasToRemove()) {
         if (lumia->isDying()){
-            deactivateLumiaPhysics(lumia);
-            _dyingLumiaQueue.push(lumia);
+            std::shared_ptr<LumiaModel> dying = lumia->shared_from_this();
+            deactivateLumiaPhysics(dying);
+            _dyingLumiaQueue.push(dying);
         }else{
-            removeLumia(lumia);
+            removeLumia(lumia->shared_from_this());
         }
     }
 
-    for (const std::shared_ptr<EnemyModel>& enemy : _collisionController.getEnemiesToRemove()) {
-        removeEnemy(enemy);
+    for (EnemyModel* enemy : _collisionController.getEnemiesToRemove()) {
+        removeEnemy(enemy->shared_from_this());
     }
 
-    for (const std::shared_ptr<LumiaModel>& lumia : _collisionController.getLumiasToStick()) {
+    for (LumiaModel* lumia : _collisionController.getLumiasToStick()) {
         lumia->setOnStickyWall(true);
     }
 
-    for (const std::shared_ptr<LumiaModel>& lumia : _collisionController.getLumiasToUnstick()) {
+    for (LumiaModel* lumia : _collisionController.getLumiasToUnstick()) {
         lumia->unStick();
     }
 
@@ -949,9 +1139,9 @@ void GameScene::updateGame(float dt) {
         createLumia(lumia.sizeLevel, lumia.position, lumia.isAvatar, lumia.vel, lumia.angularVel);
     }
 
-    for (const std::shared_ptr<EnergyModel>& energy : _collisionController.getEnergiesToRemove()) {
+    for (EnergyModel* energy : _collisionController.getEnergiesToRemove()) {
         playGrowSound();
-        removeEnergy(energy);
+        removeEnergy(energy->shared_from_this());
     }
     
     int visible_tutorial = 0;
@@ -1152,13 +1342,19 @@ void GameScene::updateGame(float dt) {
 
     if(_input->didSwitch()){
         cugl::Vec2 tapLocation = _input->getSwitch(); // screen coordinates
-
-        for (const std::shared_ptr<LumiaModel>& lumia : _lumiaList) {
+        cugl::Vec3 tapLocationWorld = getCamera()->screenToWorldCoords(tapLocation) - _scrollNode->getPosition();
+
+        // Only Lumias within the largest tap box of the tap can match
+        float reach = (LumiaModel::sizeLevels[LumiaModel::sizeLevels.size()-1].radius+SWITCH_SLOP/_scale)*M_SQRT2;
+        _nearby.clear();
+        getLumiaGrid().query(Vec2(tapLocationWorld.x, tapLocationWorld.y)/_scale, reach, _nearby);
+        std::sort(_nearby.begin(), _nearby.end());
+        for (Uint32 index : _nearby) {
+            const std::shared_ptr<LumiaModel>& lumia = _lumiaList[index];
             cugl::Vec2 lumiaPosition = lumia->getPosition() * _scale; // world coordinates
-            cugl::Vec3 tapLocationWorld = getCamera()->screenToWorldCoords(tapLocation) - _scrollNode->getPosition();
             float radius = lumia->getRadius() * _scale; // world coordinates
-            if (IN_RANGE(tapLocationWorld.x, (lumiaPosition.x - radius) - 8, (lumiaPosition.x + radius) + 8) &&
-                IN_RANGE(tapLocationWorld.y, (lumiaPosition.y - radius) - 8, (lumiaPosition.y + radius) + 8)) {
+            if (IN_RANGE(tapLocationWorld.x, (lumiaPosition.x - radius) - SWITCH_SLOP, (lumiaPosition.x + radius) + SWITCH_SLOP) &&
+                IN_RANGE(tapLocationWorld.y, (lumiaPosition.y - radius) - SWITCH_SLOP, (lumiaPosition.y + radius) + SWITCH_SLOP)) {
                 _avatar = lumia;
                 for (const std::shared_ptr<Tutorial> &t : _tutorialList) {
                     if (t->_textureNode->isVisible() && t->_condition == Tutorial::tap){t->_textureNode->setVisible(false);
@@ -1179,23 +1375,37 @@ void GameScene::updateGame(float dt) {
     }
 
 	// if Lumia is on ground, player can launch Lumia so we should show the projected
-    // trajectory if player is dragging
-    if (! (_avatar->isGrounded() && _input->isDragging()) || _ticks % 3 == 0){
-        _trajectoryNode->clearPoints();
-    }
-    
-	if (!_avatar->isRemoved()&&_avatar->isGrounded() && _input->isDragging() && _ticks % 3 == 0) {
-        Vec2 startPos = _avatar->getPosition();
-        float m = _avatar->getMass();
+    // trajectory if player is dragging. The path is predicted on a worker thread,
+    // and shown as soon as it is published.
+    bool aiming = !_avatar->isRemoved() && _avatar->isGrounded() && _input->isDragging();
+    if (aiming) {
         Vec2 plannedImpulse = _input->getPlannedLaunch();
-        Vec2 initialVelocity = plannedImpulse / m;
-		for (int i = 1; i < 40; i+=5) {
-			Vec2 trajectoryPosition = getTrajectoryPoint(startPos, initialVelocity, i);
-            _trajectoryNode->addPoint(trajectoryPosition * _scale);
-		}
+        TrajectoryPredictor::Launch launch;
+        launch.position = _avatar->getPosition();
+        launch.velocity = plannedImpulse / _avatar->getMass();
+        launch.gravity = _world->getGravity();
+        launch.radius = _avatar->getRadius();
+        launch.restitution = _avatar->getRestitution();
+        launch.friction = _avatar->getFriction();
+        appendDoorSegments(launch.movers);
+        Uint64 serial = _trajectory->post(launch);
+        if (_aimSerial == 0) {
+            _aimSerial = serial;
+        }
+
         float endAlpha = (0.9f*plannedImpulse.lengthSquared()) / pow(_input->getMaximumLaunchVelocity(), 2);
         _trajectoryNode->setEndAlpha(endAlpha);
-	}
+    } else {
+        _trajectoryNode->clearPoints();
+        _aimSerial = 0;
+    }
+    // Paths from an earlier drag are dropped
+    if (_trajectory->acquire(_aimSerial) && aiming) {
+        _trajectoryNode->clearPoints();
+        for (const Vec2& point : _trajectory->getResult().points) {
+            _trajectoryNode->addPoint(point * _scale);
+        }
+    }
       
 
     float scrollpos = -1 * _avatar->getAvatarPos().x + getCamera()->getViewport().size.width * CAMERA_SHIFT;
@@ -1357,19 +1567,12 @@ void GameScene::updateGame(float dt) {
         }
     }
     if (_ticks % 100 == 0){
+        const SpatialGrid& grid = getLumiaGrid();
         for (auto & enemy : _enemyList){
-            std::shared_ptr<LumiaModel> closestLumia;
             Vec2 enemyPos = enemy->getPosition();
-            float dist = numeric_limits<float>::infinity();
-            for (auto & lumia : _lumiaList){
-                Vec2 lumiaPos = lumia->getPosition();
-                if (enemyPos.distanceSquared(lumiaPos) < dist){
-                    dist = enemyPos.distanceSquared(lumiaPos);
-                    closestLumia = lumia;
-                }
-            }
-
-            if (dist < 80.0f) {
+            Sint32 closest = grid.nearest(enemyPos, ENEMY_RANGE);
+            if (closest >= 0) {
+                const std::shared_ptr<LumiaModel>& closestLumia = _lumiaList[closest];
                 //set enemy velocity to move away or towards closest Lumia
                 Vec2 distance = closestLumia->getPosition() - enemyPos;
                 if (closestLumia->getSizeLevel() > enemy->getSizeLevel()) {
@@ -1402,7 +1605,7 @@ void GameScene::updateGame(float dt) {
 //        _graph[{Vec2(floor(curPos.x), floor(curPos.y))}] = NodeState::Enemy;
 //    }
 	// Turn the physics engine crank.
-	_world->update(dt);
+	stepWorld(dt);
 
 	// Since items may be deleted, garbage collect
 	_world->garbageCollect();
@@ -1418,19 +1621,83 @@ void GameScene::updateGame(float dt) {
 
 	// Reset the game if we win or lose.
 	if (_countdown > 0) {
-        if (_failed){
-            if (_countdown % 6 == 0){
-                int frame = _loseAnimation->getFrame() + 1 < 20 ? _loseAnimation->getFrame() + 1 : 19;
-                _loseAnimation->setFrame(frame);
-            }
-        }
         _countdown--;
 	} else if (_countdown == 0) {
+        _loseAnimation->stop();
         _loseAnimation->setFrame(0);
 		reset();
 	}
 }
 
+/**
+ * Steps the physics world, launching Lumia at the right point in the step
+ *
+ * The pointer is latched one last time before the step, so a release that
+ * arrived during this update still launches this frame. The step is then
+ * split where the release happened in the last frame, and the launch
+ * impulse is applied in between.
+ *
+ * @param dt    The amount of time to step the world
+ */
+void GameScene::stepWorld(float dt) {
+    if (_input->latch() && !_avatar->isRemoved()) {
+        _avatar->setVelocity(_input->getLaunch());
+        _avatar->setLaunching(true);
+    }
+
+    // Lockstep worlds cannot take a partial step
+    float lead = (_input->didLaunch() ? dt*_input->getLaunchOffset() : 0.0f);
+    if (!_world->isLockStep() && lead > LAUNCH_MIN_STEP && dt-lead > LAUNCH_MIN_STEP) {
+        _world->update(lead);
+        updateGrounding();
+        _lumiaGridStale = true;
+        for (auto& lumia : _lumiaList) {
+            lumia->applyLaunch();
+        }
+        _world->update(dt-lead);
+    } else {
+        for (auto& lumia : _lumiaList) {
+            lumia->applyLaunch();
+        }
+        _world->update(dt);
+    }
+    updateGrounding();
+    _lumiaGridStale = true;
+}
+
+/**
+ * Updates whether each Lumia is grounded and rolling after a physics step
+ *
+ * Both states come from the contact list of each Lumia body, as do the
+ * buttons that each Lumia presses or releases. If the avatar is not on
+ * the ground while the player is aiming or launching, the launch margin
+ * around it is tested with a single query.
+ */
+void GameScene::updateGrounding() {
+    for (auto& lumia : _lumiaList) {
+        lumia->updateContacts();
+        for (physics2::Obstacle* obj : lumia->getButtonsPressed()) {
+            for (const std::shared_ptr<Button>& button : _buttonList) {
+                if (button.get() == obj) {
+                    _collisionController.processButtonLumiaCollision(lumia, button);
+                    break;
+                }
+            }
+        }
+        for (physics2::Obstacle* obj : lumia->getButtonsReleased()) {
+            for (const std::shared_ptr<Button>& button : _buttonList) {
+                if (button.get() == obj) {
+                    _collisionController.processButtonLumiaEnding(lumia, button);
+                    break;
+                }
+            }
+        }
+    }
+    if (!_avatar->isGrounded() && (_input->isDragging() || _avatar->isLaunching())) {
+        _avatar->setGrounded(_avatar->isInLaunchMargin());
+    }
+}
+
 
 
 /**
@@ -1443,10 +1710,11 @@ void GameScene::updateGame(float dt) {
 void GameScene::setFailure(bool value) {
 	_failed = value;
 	if (value) {
-        std::shared_ptr<Sound> source = _assets->get<Sound>(LOSE_MUSIC);
+        std::shared_ptr<Sound> source = _loseMusic.get();
         AudioEngine::get()->getMusicQueue()->play(source, false, _musicVolume);
 		_losenode->setVisible(true);
         _loseAnimation->setVisible(true);
+        _loseAnimation->play(0, 19, LOSE_ANIMATION_INTERVAL, scene2::AnimationClock::Mode::ONCE);
         _scrollNode->setColor(Color4f(0.35f, 0.35f, 0.35f, 1.0f));
 		_countdown = EXIT_COUNT;
 	} else {
@@ -1477,7 +1745,7 @@ void GameScene::checkWin() {
     } else {
         _stars = 0;
     }
-    std::shared_ptr<Sound> source = _assets->get<Sound>(WIN_MUSIC);
+    std::shared_ptr<Sound> source = _winMusic.get();
     AudioEngine::get()->getMusicQueue()->play(source, false, _musicVolume);
     _state = GameState::Paused;
     setActive(false);
@@ -1486,44 +1754,40 @@ void GameScene::checkWin() {
 
 void GameScene::playSplitSound() {
     if (_changeSplitSound) {
-    std::shared_ptr<Sound> source = _assets->get<Sound>(SPLIT_SOUND2);
-    AudioEngine::get()->play(SPLIT_SOUND2, source, false, _effectVolume, true);
+    std::shared_ptr<Sound> source = _splitSound2.get();
+    AudioEngine::get()->recordPlay(SPLIT_SOUND2, source, false, _effectVolume, true);
     }
     else {
-        std::shared_ptr<Sound> source = _assets->get<Sound>(SPLIT_SOUND1);
-        AudioEngine::get()->play(SPLIT_SOUND1, source, false, _effectVolume, true);
+        std::shared_ptr<Sound> source = _splitSound1.get();
+        AudioEngine::get()->recordPlay(SPLIT_SOUND1, source, false, _effectVolume, true);
     }
     _changeSplitSound =  !_changeSplitSound;
 }
 
 void GameScene::playLightSound() {
-    std::shared_ptr<Sound> source = _assets->get<Sound>(LIGHT_SOUND);
-    AudioEngine::get()->play(LIGHT_SOUND, source, false, _effectVolume, true);
+    std::shared_ptr<Sound> source = _lightSound.get();
+    AudioEngine::get()->recordPlay(LIGHT_SOUND, source, false, _effectVolume, true);
 }
 
 void GameScene::playDieSound() {
-    std::shared_ptr<Sound> source = _assets->get<Sound>(DIE_SOUND);
-    AudioEngine::get()->play(DIE_SOUND, source, false, _effectVolume, true);
+    std::shared_ptr<Sound> source = _dieSound.get();
+    AudioEngine::get()->recordPlay(DIE_SOUND, source, false, _effectVolume, true);
 }
 
 void GameScene::playGrowSound() {
-    std::shared_ptr<Sound> source = _assets->get<Sound>(GROW_SOUND);
-    AudioEngine::get()->play(GROW_SOUND, source, false, _effectVolume, true);
+    std::shared_ptr<Sound> source = _growSound.get();
+    AudioEngine::get()->recordPlay(GROW_SOUND, source, false, _effectVolume, true);
 }
 
 void GameScene::playShrinkSound() {
-    std::shared_ptr<Sound> source = _assets->get<Sound>(SHRINK_SOUND);
-    AudioEngine::get()->play(SHRINK_SOUND, source, false, _effectVolume, true);
+    std::shared_ptr<Sound> source = _shrinkSound.get();
+    AudioEngine::get()->recordPlay(SHRINK_SOUND, source, false, _effectVolume, true);
 }
 
 /**
  * Add a new Lumia to the world.
  */
 std::shared_ptr<LumiaModel> GameScene::createLumia(int sizeLevel, Vec2 pos, bool isAvatar, Vec2 vel, float angularVel) {
-    std::shared_ptr<Texture> image = _assets->get<Texture>(LUMIA_TEXTURE);
-    std::shared_ptr<Texture> splitting = _assets->get<Texture>(SPLIT_NAME);
-    std::shared_ptr<Texture> death = _assets->get<Texture>(DEATH_NAME);
-    std::shared_ptr<Texture> indicator = _assets->get<Texture>(SIZE_INDICATOR);
     std::shared_ptr<LumiaModel> lumia = LumiaModel::alloc(pos, LumiaModel::sizeLevels[sizeLevel].radius, _scale);
     lumia->setDebugColor(DEBUG_COLOR);
     lumia->setName(LUMIA_NAME);
@@ -1532,15 +1796,14 @@ std::shared_ptr<LumiaModel> GameScene::createLumia(int sizeLevel, Vec2 pos, bool
     lumia->setLinearVelocity(vel);
     lumia->setAngularVelocity(angularVel);
     lumia->setSizeLevel(sizeLevel);
-    lumia->setTextures(image, splitting, death, indicator);
+    lumia->setTextures(_lumiaTexture.get(), _splitTexture.get(), _deathTexture.get(), _indicatorTexture.get());
+    lumia->getSceneNode()->setClock(_animations);
 
     addObstacle(lumia, lumia->getSceneNode(), 5);
     
+    _collisionController.registerLumia(lumia);
     _lumiaList.push_back(lumia);
-    std::unordered_set<b2Fixture*> fixtures;
-    _sensorFixtureMap[lumia.get()] = fixtures;
-    std::unordered_set<b2Fixture*> fixtures2;
-    _sensorFixtureMap2[lumia.get()] = fixtures2;
+    _lumiaGridStale = true;
 
     if (isAvatar) {
         _avatar = lumia;
@@ -1550,19 +1813,20 @@ std::shared_ptr<LumiaModel> GameScene::createLumia(int sizeLevel, Vec2 pos, bool
 }
 
 void GameScene::deactivateLumiaPhysics(shared_ptr<LumiaModel> lumia) {
+    // a dying Lumia takes no further collision events
+    _collisionController.releaseLumia(lumia);
     // do not attempt to remove a Lumia that has already been removed
     if (_avatar->isRemoved()) {
         return;
     }
-    _sensorFixtureMap.erase(lumia.get());
-    _sensorFixtureMap2.erase(lumia.get());
     lumia->markRemoved(true);
 }
 
 void GameScene::removeLumiaNode(shared_ptr<LumiaModel> lumia) {
-    std::list<shared_ptr<LumiaModel>>::iterator position = std::find(_lumiaList.begin(), _lumiaList.end(), lumia);
+    auto position = std::find(_lumiaList.begin(), _lumiaList.end(), lumia);
     if (position != _lumiaList.end())
         _lumiaList.erase(position);
+    _lumiaGridStale = true;
     
     _worldnode->removeChild(lumia->getSceneNode());
     lumia->dispose();
@@ -1574,13 +1838,13 @@ void GameScene::removeLumia(shared_ptr<LumiaModel> lumia) {
     if (lumia->isRemoved()) {
         return;
     }
-    _sensorFixtureMap.erase(lumia.get());
-    _sensorFixtureMap2.erase(lumia.get());
+    _collisionController.releaseLumia(lumia);
     _worldnode->removeChild(lumia->getSceneNode());
 
-    std::list<shared_ptr<LumiaModel>>::iterator position = std::find(_lumiaList.begin(), _lumiaList.end(), lumia);
+    auto position = std::find(_lumiaList.begin(), _lumiaList.end(), lumia);
     if (position != _lumiaList.end())
         _lumiaList.erase(position);
+    _lumiaGridStale = true;
 
     lumia->dispose();
     lumia->setDebugScene(nullptr);
@@ -1593,9 +1857,10 @@ void GameScene::removeEnemy(shared_ptr<EnemyModel> enemy) {
         return;
     }
     playGrowSound();
+    _collisionController.releaseEnemy(enemy);
     _worldnode->removeChild(enemy->getSceneNode());
 
-    std::list<shared_ptr<EnemyModel>>::iterator position = std::find(_enemyList.begin(), _enemyList.end(), enemy);
+    auto position = std::find(_enemyList.begin(), _enemyList.end(), enemy);
     if (position != _enemyList.end())
         _enemyList.erase(position);
 
@@ -1609,9 +1874,10 @@ void GameScene::removeEnergy(shared_ptr<EnergyModel> energy) {
     if (energy->isRemoved()) {
         return;
     }
+    _collisionController.releaseEnergy(energy);
     _worldnode->removeChild(energy->getNode());
 
-    std::list<shared_ptr<EnergyModel>>::iterator position = std::find(_energyList.begin(), _energyList.end(), energy);
+    auto position = std::find(_energyList.begin(), _energyList.end(), energy);
     if (position != _energyList.end())
         _energyList.erase(position);
 
@@ -1620,37 +1886,52 @@ void GameScene::removeEnergy(shared_ptr<EnergyModel> energy) {
     energy->markRemoved(true);
 }
 
+/**
+ * Returns the grid of Lumia positions, indexed as in _lumiaList
+ *
+ * The grid is built again on the first query after a physics step, or
+ * after a Lumia is added or removed.
+ *
+ * @return the grid of Lumia positions
+ */
+const SpatialGrid& GameScene::getLumiaGrid() {
+    if (_lumiaGridStale) {
+        _lumiaPoints.clear();
+        for (const std::shared_ptr<LumiaModel>& lumia : _lumiaList) {
+            _lumiaPoints.push_back(lumia->getPosition());
+        }
+        _lumiaGrid.build(_lumiaPoints);
+        _lumiaGridStale = false;
+    }
+    return _lumiaGrid;
+}
+
 void GameScene::mergeLumiasNearby() {
     Vec2 avatarPos = _avatar->getPosition();
 
-    for (const std::shared_ptr<LumiaModel> &lumia : _lumiaList) {
+    _nearby.clear();
+    getLumiaGrid().query(avatarPos, MERGE_RANGE, _nearby);
+    for (Uint32 index : _nearby) {
+        const std::shared_ptr<LumiaModel>& lumia = _lumiaList[index];
         if (lumia == _avatar){
             continue;
         }
-        
-        Vec2 lumiaPos = lumia->getPosition();
-        float dist = avatarPos.distanceSquared(lumiaPos);
 
-        if (dist < 100.0f){
-            //set lumia velocity to move toward avatar
-            Vec2 distance = avatarPos-lumiaPos;
-            lumia->setLinearVelocity(distance.normalize().scale(5.0f));
-        }
+        //set lumia velocity to move toward avatar
+        Vec2 distance = avatarPos-lumia->getPosition();
+        lumia->setLinearVelocity(distance.normalize().scale(5.0f));
     }
 }
 
 void GameScene::switchToNearestLumia(const std::shared_ptr<LumiaModel> lumia) {
-    float minDistance = FLT_MAX;
+    // The nearest is usually lumia itself, so look at the two nearest
     std::shared_ptr<LumiaModel> closestLumia = NULL;
-    for (const std::shared_ptr<LumiaModel>& lumiaOther : _lumiaList) {
-        if (lumiaOther == lumia) {
-            continue;
-        }
-
-        float distance = lumia->getPosition().distanceSquared(lumiaOther->getPosition());
-        if (distance < minDistance) {
-            minDistance = distance;
-            closestLumia = lumiaOther;
+    _nearby.clear();
+    getLumiaGrid().nearest(lumia->getPosition(), 2, _nearby);
+    for (Uint32 index : _nearby) {
+        if (_lumiaList[index] != lumia) {
+            closestLumia = _lumiaList[index];
+            break;
         }
     }
     _switched = true;
@@ -1660,27 +1941,85 @@ void GameScene::switchToNearestLumia(const std::shared_ptr<LumiaModel> lumia) {
 }
 
 /**
-* Calculates trajectory point one timestep into future
-*
-* @param startingPosition the position model is located before launching
-* @param startingVelocity the velocity model will be launched at during aiming
-* @param n timestep
-*/
-Vec2 GameScene::getTrajectoryPoint(Vec2& startingPosition, Vec2& startingVelocity, float n) {
-	//velocity and gravity are given per second but we want time step values here
-    float t = 1.0f / 60.0f;
-	Vec2 stepVelocity = t * startingVelocity; // m/s
-	Vec2 stepGravity = t * t * _world->getGravity(); // m/s/s
-    Vec2 estmPos = startingPosition + n * stepVelocity + 0.5f * (n * n + n) * stepGravity;
-    return estmPos;
+ * Copies the static geometry of the level into the trajectory predictor
+ *
+ * Doors are left out, since they move during play. They are added to
+ * each launch by {@link appendDoorSegments} instead.
+ */
+void GameScene::updateTrajectoryGeometry() {
+    std::unordered_set<const b2Body*> doors;
+    for (const std::shared_ptr<SlidingDoor>& d : _slidingDoorList) {
+        doors.insert(d->getBody());
+    }
+    for (const std::shared_ptr<ShrinkingDoor>& d : _shrinkingDoorList) {
+        doors.insert(d->getBody());
+        for (const std::shared_ptr<physics2::Obstacle>& part : d->getBodies()) {
+            doors.insert(part->getBody());
+        }
+    }
+
+    std::vector<TrajectoryPredictor::Segment> segments;
+    for (const b2Body* body = _world->getWorld()->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() != b2_staticBody || doors.find(body) != doors.end()) {
+            continue;
+        }
+
+        // Lumia sticks to sticky walls (which are sensors) and dies on spikes
+        physics2::Obstacle* obj = (physics2::Obstacle*)body->GetUserData();
+        bool sticky = obj != nullptr && obj->getName() == "STICKY_WALL";
+        bool spike  = obj != nullptr && obj->getName().substr(0, 5) == SPIKE_NAME;
+        for (const b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext()) {
+            if (f->IsSensor() && !sticky) {
+                continue;
+            }
+            TrajectoryPredictor::Surface surface;
+            surface.restitution = f->GetRestitution();
+            surface.friction = f->GetFriction();
+            surface.stops = sticky || spike;
+            TrajectoryPredictor::appendFixture(segments, f, surface);
+        }
+    }
+    _trajectory->setGeometry(segments);
+}
+
+/**
+ * Appends the current outline of every closed door as segments
+ *
+ * @param segments  The vector to store the segments
+ */
+void GameScene::appendDoorSegments(std::vector<TrajectoryPredictor::Segment>& segments) const {
+    std::vector<const b2Body*> bodies;
+    for (const std::shared_ptr<SlidingDoor>& d : _slidingDoorList) {
+        bodies.push_back(d->getBody());
+    }
+    for (const std::shared_ptr<ShrinkingDoor>& d : _shrinkingDoorList) {
+        for (const std::shared_ptr<physics2::Obstacle>& part : d->getBodies()) {
+            bodies.push_back(part->getBody());
+        }
+    }
+
+    for (const b2Body* body : bodies) {
+        if (body == nullptr) {
+            continue;
+        }
+        for (const b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext()) {
+            if (!f->IsSensor()) {
+                TrajectoryPredictor::Surface surface;
+                surface.restitution = f->GetRestitution();
+                surface.friction = f->GetFriction();
+                surface.stops = false;
+                TrajectoryPredictor::appendFixture(segments, f, surface);
+            }
+        }
+    }
 }
 
 
 #pragma mark -
 #pragma mark Collision Handling
 
-bool GameScene::didCollideWithLumiaBody(std::shared_ptr<LumiaModel> lumia, physics2::Obstacle* bd, void* fd){
-    return bd == lumia.get() && lumia->getLaunchSensorName() != fd && lumia->getFrictionSensorName() != fd;
+bool GameScene::didCollideWithLumiaBody(const std::shared_ptr<LumiaModel>& lumia, physics2::Obstacle* bd){
+    return bd == lumia.get();
 }
 
 /**
@@ -1699,9 +2038,6 @@ void GameScene::beginContact(b2Contact* contact) {
 	b2Body* body1 = fix1->GetBody();
 	b2Body* body2 = fix2->GetBody();
 
-	void* fd1 = fix1->GetUserData();
-    void* fd2 = fix2->GetUserData();
-
 	physics2::Obstacle* bd1 = (physics2::Obstacle*)body1->GetUserData();
     physics2::Obstacle* bd2 = (physics2::Obstacle*)body2->GetUserData();
 
@@ -1712,7 +2048,7 @@ void GameScene::beginContact(b2Contact* contact) {
         }
 
         // handle collision between magical plant and Lumia
-        if (bd1->getName().substr(0,5) == PLANT_NAME && didCollideWithLumiaBody(lumia, bd2, fd2)) {
+        if (bd1->getName().substr(0,5) == PLANT_NAME && didCollideWithLumiaBody(lumia, bd2)) {
             // plant must not already be lit
             if (!((Plant*)bd1)->getIsLit()) {
                 ((Plant*)bd1)->lightUp();
@@ -1727,7 +2063,7 @@ void GameScene::beginContact(b2Contact* contact) {
                 }
                 _progressLabel->setText(to_string(numPlantsLit) + "/" + to_string(_plantList.size()));
             }
-        } else if (bd2->getName().substr(0, 5) == PLANT_NAME && didCollideWithLumiaBody(lumia, bd1, fd1)) {
+        } else if (bd2->getName().substr(0, 5) == PLANT_NAME && didCollideWithLumiaBody(lumia, bd1)) {
             if (!((Plant*)bd2)->getIsLit()) {
                 ((Plant*)bd2)->lightUp();
                 playLightSound();
@@ -1742,8 +2078,8 @@ void GameScene::beginContact(b2Contact* contact) {
                 _progressLabel->setText(to_string(numPlantsLit) + "/" + to_string(_plantList.size()));
             }
         // handle collision between spike and Lumia
-        } else if((bd1->getName().substr(0, 5) == SPIKE_NAME && didCollideWithLumiaBody(lumia, bd2, fd2)) ||
-            (bd2->getName().substr(0, 5) == SPIKE_NAME && didCollideWithLumiaBody(lumia, bd1, fd1))){
+        } else if((bd1->getName().substr(0, 5) == SPIKE_NAME && didCollideWithLumiaBody(lumia, bd2)) ||
+            (bd2->getName().substr(0, 5) == SPIKE_NAME && didCollideWithLumiaBody(lumia, bd1))){
             if (_lastSpikeCollision == NULL) {
                 _lastSpikeCollision = _ticks;
                 _collisionController.processSpikeLumiaCollision(lumia->getSmallerSizeLevel(), lumia, lumia == _avatar);
@@ -1753,7 +2089,7 @@ void GameScene::beginContact(b2Contact* contact) {
             }
         }
         // handle collision between enemy and Lumia
-        else if (bd1->getName() == ENEMY_TEXTURE && didCollideWithLumiaBody(lumia, bd2, fd2)) {
+        else if (bd1->getName() == ENEMY_TEXTURE && didCollideWithLumiaBody(lumia, bd2)) {
             for (const std::shared_ptr<EnemyModel>& enemy : _enemyList) {
                 if (enemy.get() == bd1 && !enemy->getRemoved() && !enemy->getInCoolDown()) {
                     _collisionController.processEnemyLumiaCollision(enemy, lumia, lumia == _avatar);
@@ -1763,7 +2099,7 @@ void GameScene::beginContact(b2Contact* contact) {
                     break;
                 }
             }
-        } else if (bd2->getName() == ENEMY_TEXTURE && didCollideWithLumiaBody(lumia, bd1, fd1)) {
+        } else if (bd2->getName() == ENEMY_TEXTURE && didCollideWithLumiaBody(lumia, bd1)) {
             for (const std::shared_ptr<EnemyModel>& enemy : _enemyList) {
                 if (enemy.get() == bd2 && !enemy->getRemoved() && !enemy->getInCoolDown()) {
                     _collisionController.processEnemyLumiaCollision(enemy, lumia, lumia == _avatar);
@@ -1775,14 +2111,14 @@ void GameScene::beginContact(b2Contact* contact) {
             }
         }
         // handle collision between energy item and Lumia
-        else if (bd1->getName() == ENERGY_NAME && didCollideWithLumiaBody(lumia, bd2, fd2)) {
+        else if (bd1->getName() == ENERGY_NAME && didCollideWithLumiaBody(lumia, bd2)) {
             for (const std::shared_ptr<EnergyModel>& energy : _energyList) {
                 if (energy.get() == bd1 && !energy->getRemoved()) {
                     _collisionController.processEnergyLumiaCollision(energy, lumia, lumia == _avatar);
                     break;
                 }
             }
-        } else if (bd2->getName() == ENERGY_NAME && didCollideWithLumiaBody(lumia, bd1, fd1)) {
+        } else if (bd2->getName() == ENERGY_NAME && didCollideWithLumiaBody(lumia, bd1)) {
             for (const std::shared_ptr<EnergyModel>& energy : _energyList) {
                 if (energy.get() == bd2 && !energy->getRemoved()) {
                     _collisionController.processEnergyLumiaCollision(energy, lumia, lumia == _avatar);
@@ -1790,24 +2126,8 @@ void GameScene::beginContact(b2Contact* contact) {
                 }
             }
         }
-        else if (bd1->getName() == BUTTON_NAME && lumia->getFrictionSensorName()==fd2) {
-            for (const std::shared_ptr<Button>& button : _buttonList) {
-                if (button.get() == bd1) {
-                    _collisionController.processButtonLumiaCollision(lumia, button);
-                    break;
-                }
-            }
-        }
-        else if (bd2->getName() == BUTTON_NAME && lumia->getFrictionSensorName()==fd1) {
-            for (const std::shared_ptr<Button>& button : _buttonList) {
-                if (button.get() == bd2) {
-                    _collisionController.processButtonLumiaCollision(lumia, button);
-                    break;
-                }
-            }
-        }
         // handle collision between two Lumias
-        else if (bd1->getName() == LUMIA_NAME && didCollideWithLumiaBody(lumia, bd2, fd2)) {
+        else if (bd1->getName() == LUMIA_NAME && didCollideWithLumiaBody(lumia, bd2)) {
             for (const std::shared_ptr<LumiaModel>& lumia2 : _lumiaList) {
                 if (lumia2.get() == bd1 && !lumia2->getRemoved() && _avatar->getState() == LumiaModel::LumiaState::Merging) {
                     _collisionController.processLumiaLumiaCollision(lumia, lumia2, lumia == _avatar || lumia2 == _avatar);
@@ -1815,7 +2135,7 @@ void GameScene::beginContact(b2Contact* contact) {
                 }
             }
             break;
-        } else if (bd2->getName() == LUMIA_NAME && didCollideWithLumiaBody(lumia, bd1, fd1)) {
+        } else if (bd2->getName() == LUMIA_NAME && didCollideWithLumiaBody(lumia, bd1)) {
             for (const std::shared_ptr<LumiaModel>& lumia2 : _lumiaList) {
                 if (lumia2.get() == bd2 && !lumia2->getRemoved() && _avatar->getState() == LumiaModel::LumiaState::Merging) {
                     _collisionController.processLumiaLumiaCollision(lumia, lumia2, lumia == _avatar || lumia2 == _avatar);
@@ -1823,30 +2143,14 @@ void GameScene::beginContact(b2Contact* contact) {
                 }
             }
         }
-        else if (bd2->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd1, fd1)){
+        else if (bd2->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd1)){
             _collisionController.processStickyWallLumiaCollision(lumia, (StickyWallModel*)bd2);
             
         }
-        else if (bd1->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd2, fd2)){
+        else if (bd1->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd2)){
             _collisionController.processStickyWallLumiaCollision(lumia, (StickyWallModel*)bd1);
             
         }
-        // detect if lumia can launch
-        if (((lumia->getLaunchSensorName() == fd2 && lumia.get() != bd1) ||
-            (lumia->getLaunchSensorName() == fd1 && lumia.get() != bd2))) {
-            lumia->setGrounded(true);
-            // Could have more than one ground
-            std::unordered_set<b2Fixture*> & sensorFixtures = _sensorFixtureMap[lumia.get()];
-            sensorFixtures.emplace(lumia.get() == bd1 ? fix2 : fix1);
-        }
-        // detect if use friction on lumia
-        else if (((lumia->getFrictionSensorName() == fd2 && lumia.get() != bd1 && bd1 ->getName().substr(0,4)!= "door") ||
-            (lumia->getFrictionSensorName() == fd1 && lumia.get() != bd2 && bd2 ->getName().substr(0,4)!="door"))) {
-                lumia->setRolling(true);
-                // Could have more than one ground
-                std::unordered_set<b2Fixture*> & sensorFixtures = _sensorFixtureMap2[lumia.get()];
-                sensorFixtures.emplace(lumia.get() == bd1 ? fix2 : fix1);
-        }
     }
 }
 
@@ -1864,48 +2168,13 @@ void GameScene::endContact(b2Contact* contact) {
 	b2Body* body1 = fix1->GetBody();
 	b2Body* body2 = fix2->GetBody();
 
-	void* fd1 = fix1->GetUserData();
-	void* fd2 = fix2->GetUserData();
-
     physics2::Obstacle* bd1 = (physics2::Obstacle*)body1->GetUserData();
     physics2::Obstacle* bd2 = (physics2::Obstacle*)body2->GetUserData();
 
     
     for (const std::shared_ptr<LumiaModel> &lumia : _lumiaList){
-        if ((lumia->getLaunchSensorName() == fd2 && lumia.get() != bd1) ||
-            (lumia->getLaunchSensorName() == fd1 && lumia.get() != bd2)) {
-            std::unordered_set<b2Fixture*> & sensorFixtures = _sensorFixtureMap[lumia.get()];
-            sensorFixtures.erase(lumia.get() == bd1 ? fix2 : fix1);
-            if (sensorFixtures.empty()) {
-                lumia->setGrounded(false);
-            }
-        }
-        if (((lumia->getFrictionSensorName() == fd2 && lumia.get() != bd1 && bd1 ->getName().substr(0,4)!= "door") ||
-             (lumia->getFrictionSensorName() == fd1 && lumia.get() != bd2 && bd2 ->getName().substr(0,4)!="door"))) {
-            std::unordered_set<b2Fixture*> & sensorFixtures = _sensorFixtureMap2[lumia.get()];
-            sensorFixtures.erase(lumia.get() == bd1 ? fix2 : fix1);
-            if (sensorFixtures.empty()) {
-                lumia->setRolling(false);
-            }
-        }
-        if (bd1->getName() == BUTTON_NAME && lumia->getFrictionSensorName()==fd2) {
-            for (const std::shared_ptr<Button>& button : _buttonList) {
-                if (button.get() == bd1) {
-                    _collisionController.processButtonLumiaEnding(lumia, button);
-                    break;
-                }
-            }
-        }
-        else if (bd2->getName() == BUTTON_NAME && lumia->getFrictionSensorName()==fd1) {
-            for (const std::shared_ptr<Button>& button : _buttonList) {
-                if (button.get() == bd2) {
-                    _collisionController.processButtonLumiaEnding(lumia, button);
-                    break;
-                }
-            }
-        }
-        else if ((bd2->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd1, fd1)) ||
-                 (bd1->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd2, fd2))){
+        if ((bd2->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd1)) ||
+                 (bd1->getName()=="STICKY_WALL" && didCollideWithLumiaBody(lumia, bd2))){
             _collisionController.processStickyWallLumiaEnding(lumia);
         }
     }
@@ -1932,8 +2201,41 @@ Size GameScene::computeActiveSize() const {
 
 
 void GameScene::render_game(const std::shared_ptr<SpriteBatch>& batch, const std::shared_ptr<SpriteBatch>& UIbatch){
+    // Advance every sprite sheet in one pass before drawing
+    _animations->update();
     Scene2::render(batch);
+    if (_debug) {
+        render_debug(batch);
+    }
     
     
 
 }
+
+/**
+ * Draws the physics wireframe over the game scene.
+ *
+ * The fixtures are read straight from the physics world, culled against
+ * the camera view, and drawn with a single outline call. The debug node
+ * is only used for its transform, which maps physics coordinates to the
+ * scrolled scene.
+ *
+ * @param batch     The sprite batch to draw with
+ */
+void GameScene::render_debug(const std::shared_ptr<SpriteBatch>& batch) {
+    if (_world == nullptr || _debugnode == nullptr) {
+        return;
+    }
+
+    // Map the screen corners into physics coordinates to cull
+    Size dimen = Application::get()->getDisplaySize();
+    Vec2 corner1 = _debugnode->worldToNodeCoords(Vec2(getCamera()->screenToWorldCoords(Vec2::ZERO)));
+    Vec2 corner2 = _debugnode->worldToNodeCoords(Vec2(getCamera()->screenToWorldCoords(Vec2(dimen.width,dimen.height))));
+    Vec2 origin(std::min(corner1.x,corner2.x),std::min(corner1.y,corner2.y));
+    Vec2 extent(std::max(corner1.x,corner2.x),std::max(corner1.y,corner2.y));
+    _debugRenderer->update(_world->getWorld(),Rect(origin,extent-origin));
+
+    batch->begin(getCamera()->getCombined());
+    _debugRenderer->draw(batch,_debugnode->getNodeToWorldTransform());
+    batch->end();
+}
@@ -22,6 +22,8 @@
 #include "TileModel.h"
 //#include "PathFindingController.h"
 #include "TrajectoryNode.h"
+#include "LevelStreamer.h"
+#include "TrajectoryPredictor.h"
 /**
  * This class is the primary gameplay constroller for the demo.
  *
@@ -34,9 +36,32 @@ protected:
     /** The asset manager for this game mode. */
     std::shared_ptr<cugl::AssetManager> _assets;
     
-    std::shared_ptr<LevelModel> _level;
+    // ASSET HANDLES (resolved once so hot paths avoid string lookups)
+    /** The paused minimap markers for offscreen Lumia and plants */
+    cugl::AssetHandle<cugl::scene2::SceneNode> _pausedLumiaPlantLeft;
+    cugl::AssetHandle<cugl::scene2::SceneNode> _pausedPlantLeft;
+    cugl::AssetHandle<cugl::scene2::SceneNode> _pausedLumiaLeft;
+    cugl::AssetHandle<cugl::scene2::SceneNode> _pausedLumiaPlantRight;
+    cugl::AssetHandle<cugl::scene2::SceneNode> _pausedPlantRight;
+    cugl::AssetHandle<cugl::scene2::SceneNode> _pausedLumiaRight;
+    /** The music and sound effects played during gameplay */
+    cugl::AssetHandle<cugl::Sound> _loseMusic;
+    cugl::AssetHandle<cugl::Sound> _winMusic;
+    cugl::AssetHandle<cugl::Sound> _splitSound1;
+    cugl::AssetHandle<cugl::Sound> _splitSound2;
+    cugl::AssetHandle<cugl::Sound> _lightSound;
+    cugl::AssetHandle<cugl::Sound> _dieSound;
+    cugl::AssetHandle<cugl::Sound> _growSound;
+    cugl::AssetHandle<cugl::Sound> _shrinkSound;
+    /** The textures for every new Lumia */
+    cugl::AssetHandle<cugl::Texture> _lumiaTexture;
+    cugl::AssetHandle<cugl::Texture> _splitTexture;
+    cugl::AssetHandle<cugl::Texture> _deathTexture;
+    cugl::AssetHandle<cugl::Texture> _indicatorTexture;
     
-    std::shared_ptr<TileDataModel> _tileManager;
+    std::shared_ptr<LevelModel> _level;
+    /** The service building levels before they are played */
+    std::shared_ptr<LevelStreamer> _streamer;
     
     
     // CONTROLLERS
@@ -51,8 +76,10 @@ protected:
     // VIEW
     /** Reference to the physics root of the scene graph */
     std::shared_ptr<cugl::scene2::SceneNode> _worldnode;
-    /** Reference to the debug root of the scene graph */
+    /** Reference to the debug root of the scene graph (in physics coordinates) */
     std::shared_ptr<cugl::scene2::SceneNode> _debugnode;
+    /** The wireframe renderer for the physics world in debug mode */
+    std::shared_ptr<cugl::physics2::DebugRenderer> _debugRenderer;
     
     std::shared_ptr<cugl::scene2::SceneNode> _backbuttonNode;
     
@@ -67,6 +94,8 @@ protected:
     std::shared_ptr<cugl::scene2::Label> _losenode;
     
     std::shared_ptr<cugl::scene2::AnimationNode> _loseAnimation;
+    /** The clock advancing every sprite sheet animation in the level */
+    std::shared_ptr<cugl::scene2::AnimationClock> _animations;
 
     /** The Box2D world */
     std::shared_ptr<cugl::physics2::ObstacleWorld> _world;
@@ -75,27 +104,39 @@ protected:
 
     // Physics objects for the game
     /** References to the magical plants */
-    std::list<std::shared_ptr<Plant>> _plantList;
+    std::vector<std::shared_ptr<Plant>> _plantList;
     /** References to the spikes */
-    std::list<std::shared_ptr<SpikeModel>> _spikeList;
+    std::vector<std::shared_ptr<SpikeModel>> _spikeList;
     /** References to the energy items */
-    std::list<std::shared_ptr<EnergyModel>> _energyList;
+    std::vector<std::shared_ptr<EnergyModel>> _energyList;
     /** References to the Lumia bodies */
-    std::list<std::shared_ptr<LumiaModel>> _lumiaList;
+    std::vector<std::shared_ptr<LumiaModel>> _lumiaList;
     
-    std::list<std::shared_ptr<Button>> _buttonList;
+    std::vector<std::shared_ptr<Button>> _buttonList;
     
     /** References to the Lumias */
     std::queue<std::shared_ptr<LumiaModel>> _dyingLumiaQueue;
     
-    std::list<std::shared_ptr<SlidingDoor>> _slidingDoorList;
-    std::list<std::shared_ptr<ShrinkingDoor>> _shrinkingDoorList;
+    std::vector<std::shared_ptr<SlidingDoor>> _slidingDoorList;
+    std::vector<std::shared_ptr<ShrinkingDoor>> _shrinkingDoorList;
     /** References to the Lumia bodies */
-    std::list<std::shared_ptr<EnemyModel>> _enemyList;
+    std::vector<std::shared_ptr<EnemyModel>> _enemyList;
     /** Reference to the player avatar */
     std::shared_ptr<LumiaModel> _avatar;
+    /** The Lumia positions, indexed as in _lumiaList */
+    cugl::SpatialGrid _lumiaGrid;
+    /** Whether the Lumias moved or changed since the grid was built */
+    bool _lumiaGridStale;
+    /** The Lumia positions copied into the grid */
+    std::vector<Vec2> _lumiaPoints;
+    /** The results of the last grid query */
+    std::vector<Uint32> _nearby;
     
     std::shared_ptr<TrajectoryNode> _trajectoryNode;
+    /** The service predicting the launch path while the player drags */
+    std::shared_ptr<TrajectoryPredictor> _trajectory;
+    /** The serial number of the first launch posted in the current drag */
+    Uint64 _aimSerial;
     
     std::shared_ptr<scene2::PolygonNode> _avatarIndicatorNode;
     
@@ -127,10 +168,6 @@ protected:
 
     bool _changeSplitSound;
     string _currentLevel;
-    /** Mark set to handle more sophisticated collision callbacks */
-    std::unordered_map<LumiaModel*, std::unordered_set<b2Fixture*>> _sensorFixtureMap;
-    /** Mark set to handle more sophisticated collision callbacks */
-    std::unordered_map<LumiaModel*, std::unordered_set<b2Fixture*>> _sensorFixtureMap2;
     
     std::unordered_map<Node, NodeState> _graph;
 
@@ -149,18 +186,46 @@ protected:
     
 #pragma mark Internal Object Management
     
+    /**
+     * Resolves the handles for the assets used every frame.
+     *
+     * The handles remain valid if the assets are reloaded, so this only
+     * needs to be called once.
+     */
+    void resolveAssets();
+    
     /**
      * Lays out the game geography.
      *
-     * Pay close attention to how we attach physics objects to a scene graph.
-     * The simplest way is to make a subclass, like we do for the dude.  However,
-     * for simple objects you can just use a callback function to lightly couple
-     * them.  This is what we do with the crates.
+     * The obstacles of a prepared level are already in its world, and their
+     * scene nodes are already in its world node. This method attaches the
+     * world and the scene graph to this scene, and then does the work that
+     * must happen on the main thread: animation clocks, contact listeners,
+     * tutorials and the trajectory.
+     *
+     * @param level The level prepared by the level streamer
+     */
+    void populate(const std::shared_ptr<PreparedLevel>& level);
+
+    /**
+     * Returns the level with the given path, built from scratch.
+     *
+     * This method is safe to call from any thread. Every texture must be
+     * resolved beforehand, as the asset manager may only be used on the
+     * main thread. The build is abandoned if the cancel flag is set.
+     *
+     * @param path      The asset path of the level file
+     * @param textures  The textures used by the level, by asset key
+     * @param tiles     The tile geometry
+     * @param height    The height of the display
+     * @param cancelled The flag to abandon the build
      *
-     * This method is really, really long.  In practice, you would replace this
-     * with your serialization loader, which would process a level file.
+     * @return the level with the given path, built from scratch.
      */
-    void populate();
+    static std::shared_ptr<PreparedLevel> buildLevel(const std::string& path,
+                                                     const std::unordered_map<std::string, std::shared_ptr<cugl::Texture>>& textures,
+                                                     const std::shared_ptr<TileDataModel>& tiles,
+                                                     float height, const std::atomic<bool>& cancelled);
 
     /**
      * Adds the physics object to the physics world and loosely couples it to the scene graph
@@ -184,6 +249,23 @@ protected:
                      const std::shared_ptr<cugl::scene2::SceneNode>& node,
                      int zOrder, bool useObjPosition=true);
 
+    /**
+     * Adds the physics object to the given level and loosely couples it to its scene graph
+     *
+     * This is the version of {@link addObstacle} used while a level is built,
+     * possibly off the main thread.
+     *
+     * @param level  The level being built
+     * @param obj    The physics object to add
+     * @param node   The scene graph node to attach it to
+     * @param zOrder The drawing order
+     * @param useObjPosition  Whether to update the node's position to be at the object's position
+     */
+    static void addObstacle(const std::shared_ptr<PreparedLevel>& level,
+                            const std::shared_ptr<cugl::physics2::Obstacle>& obj,
+                            const std::shared_ptr<cugl::scene2::SceneNode>& node,
+                            int zOrder, bool useObjPosition=true);
+
     /**
      * Returns the active screen size of this scene.
      *
@@ -241,49 +323,29 @@ public:
      * The game world is scaled so that the screen coordinates do not agree
      * with the Box2d coordinates.  This initializer uses the default scale.
      *
+     * The level is taken from the streamer. If it was prefetched, the world
+     * and the scene graph are already built and only need to be attached.
+     *
      * @param assets    The (loaded) assets for this game mode
+     * @param streamer  The service building the levels
      * @param level     The level to be loaded into the game world
      *
      * @return true if the controller is initialized properly, false otherwise.
      */
-    bool init(const std::shared_ptr<cugl::AssetManager>& assets, string level);
+    bool init(const std::shared_ptr<cugl::AssetManager>& assets,
+              const std::shared_ptr<LevelStreamer>& streamer, string level);
 
     /**
-     * Initializes the controller contents, and starts the game
-     *
-     * The constructor does not allocate any objects or memory.  This allows
-     * us to have a non-pointer reference to this controller, reducing our
-     * memory allocation.  Instead, allocation happens in this method.
-     *
-     * The game world is scaled so that the screen coordinates do not agree
-     * with the Box2d coordinates.  The bounds are in terms of the Box2d
-     * world, not the screen.
-     *
-     * @param assets    The (loaded) assets for this game mode
-     * @param rect      The game bounds in Box2d coordinates
-     *
-     * @return  true if the controller is initialized properly, false otherwise.
-     */
-    bool init(const std::shared_ptr<cugl::AssetManager>& assets, const cugl::Rect& rect);
-    
-    /**
-     * Initializes the controller contents, and starts the game
-     *
-     * The constructor does not allocate any objects or memory.  This allows
-     * us to have a non-pointer reference to this controller, reducing our
-     * memory allocation.  Instead, allocation happens in this method.
+     * Returns a level builder for the level streamer.
      *
-     * The game world is scaled so that the screen coordinates do not agree
-     * with the Box2d coordinates.  The bounds are in terms of the Box2d
-     * world, not the screen.
+     * Every asset the builder needs is resolved here, on the main thread, so
+     * that the builder may run on the streamer's workers.
      *
      * @param assets    The (loaded) assets for this game mode
-     * @param rect      The game bounds in Box2d coordinates
-     * @param gravity   The gravitational force on this Box2d world
      *
-     * @return  true if the controller is initialized properly, false otherwise.
+     * @return a level builder for the level streamer.
      */
-    bool init(const std::shared_ptr<cugl::AssetManager>& assets, const cugl::Rect& rect, const cugl::Vec2& gravity);
+    static LevelStreamer::Builder getLevelBuilder(const std::shared_ptr<cugl::AssetManager>& assets);
     
     
     float touchstart;
@@ -296,6 +358,16 @@ public:
     std::vector<std::shared_ptr<cugl::scene2::SceneNode>> _UIelements;
     void render_game(const std::shared_ptr<SpriteBatch>& batch, const std::shared_ptr<SpriteBatch>& UIbatch);
 
+    /**
+     * Draws the physics wireframe over the game scene.
+     *
+     * The fixtures are read straight from the physics world, culled against
+     * the camera view, and drawn with a single outline call.
+     *
+     * @param batch     The sprite batch to draw with
+     */
+    void render_debug(const std::shared_ptr<SpriteBatch>& batch);
+
     /**
      * Returns true if debug mode is active.
      *
@@ -312,7 +384,7 @@ public:
      *
      * @param value whether debug mode is active.
      */
-    void setDebug(bool value) { _debug = value; _debugnode->setVisible(value); }
+    void setDebug(bool value) { _debug = value; }
 
 	/**
 	* Returns true if the level is failed.
@@ -357,7 +429,7 @@ public:
 #pragma mark -
 #pragma mark Collision Handling
     
-    bool didCollideWithLumiaBody(std::shared_ptr<LumiaModel> lumia, physics2::Obstacle* bd, void* fd);
+    bool didCollideWithLumiaBody(const std::shared_ptr<LumiaModel>& lumia, physics2::Obstacle* bd);
 	/**
 	* Processes the start of a collision
 	*
@@ -430,6 +502,37 @@ public:
     
     
     void updateGame(float dt);
+
+    /**
+     * Steps the physics world, launching Lumia at the right point in the step
+     *
+     * The pointer is latched one last time before the step, so a release that
+     * arrived during this update still launches this frame. The step is then
+     * split where the release happened in the last frame, and the launch
+     * impulse is applied in between.
+     *
+     * @param dt    The amount of time to step the world
+     */
+    void stepWorld(float dt);
+
+    /**
+     * Updates whether each Lumia is grounded and rolling after a physics step
+     *
+     * Both states come from the contact list of each Lumia body. If the
+     * avatar touches nothing while the player is aiming or launching, the
+     * launch margin around it is tested with a single overlap query.
+     */
+    void updateGrounding();
+
+    /**
+     * Returns the grid of Lumia positions, indexed as in _lumiaList
+     *
+     * The grid is built again on the first query after a physics step, or
+     * after a Lumia is added or removed.
+     *
+     * @return the grid of Lumia positions
+     */
+    const cugl::SpatialGrid& getLumiaGrid();
     
     void updatePaused(float dt, float startX);
     
@@ -449,15 +552,19 @@ public:
     
     void playShrinkSound();
     /**
-     * Calculates trajectory point one timestep into future
+     * Copies the static geometry of the level into the trajectory predictor
+     *
+     * Doors are left out, since they move during play. They are added to
+     * each launch by {@link appendDoorSegments} instead.
+     */
+    void updateTrajectoryGeometry();
+
+    /**
+     * Appends the current outline of every closed door as segments
      *
-     * @param startingPosition the position model is located before launching
-     * @param startingVelocity the velocity model will be launched at during aiming
-     * @param n timestep
-     * @param dt time in seconds since last update frame
+     * @param segments  The vector to store the segments
      */
-    Vec2 getTrajectoryPoint(Vec2& startingPosition, Vec2& startingVelocity, 
-                            float n);
+    void appendDoorSegments(std::vector<TrajectoryPredictor::Segment>& segments) const;
 
   };
 
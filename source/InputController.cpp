@@ -47,22 +47,25 @@ std::shared_ptr<InputController> InputController::instance;
  */
 InputController::InputController() :
 _active(false),
-_resetPressed(false),
-_debugPressed(false),
-_exitPressed(false),
-_splitPressed(false),
-_mergePressed(false),
 _keyReset(false),
 _keyDebug(false),
 _keyExit(false),
 _keySplit(false),
 _keyMerge(false),
-_switched(false),
 _switchInputted(false),
-_launched(false),
 _launchInputted(false),
+_lateLatch(true),
+_latchSequence(0),
+_resetPressed(false),
+_debugPressed(false),
+_exitPressed(false),
+_splitPressed(false),
+_mergePressed(false),
+_switched(false),
+_launched(false),
+_dragging(false),
 _dragged(false),
-_dragging(false)
+_launchOffset(0.0f)
 {
 }
 
@@ -183,6 +186,62 @@ void InputController::update(float dt) {
 #endif
 }
 
+/**
+ * Samples the pointer one last time before the physics step.
+ *
+ * This pumps any pointer events that arrived since {@link update} (unless
+ * late latching is disabled). A drag-and-release that shows up here is
+ * reported by {@link didLaunch()} this frame instead of the next one.
+ *
+ * It also works out where in the last frame the launch happened (see
+ * {@link getLaunchOffset()}), and reports any latency probe events in the
+ * pointer history. It should be called exactly once per physics step.
+ *
+ * @return true if a launch arrived after {@link update} this frame
+ */
+bool InputController::latch() {
+    if (!_active) {
+        return false;
+    }
+
+    bool late = false;
+    if (_lateLatch) {
+        Input::latch();
+        if (_launchInputted) {
+            _launched = true;
+            _launchInputted = false;
+            late = true;
+        }
+    }
+
+    // Place the release within the window since the last latch
+    Timestamp now;
+    _launchOffset = 0.0f;
+    if (_launched && _latchTime < _launchTime && _launchTime < now) {
+        Uint64 window = Timestamp::ellapsedMicros(_latchTime,now);
+        Uint64 offset = Timestamp::ellapsedMicros(_latchTime,_launchTime);
+        _launchOffset = (float)offset/(float)window;
+    }
+
+#ifndef CU_TOUCH_SCREEN
+    const InputHistory& history = Input::get<Mouse>()->history();
+#else
+    const InputHistory& history = Input::get<Touchscreen>()->history();
+#endif
+    if (_probe != nullptr) {
+        size_t fresh = history.since(_latchSequence);
+        for(size_t ii = 0; ii < fresh; ii++) {
+            const InputSample& sample = history.get(ii);
+            if (LatencyProbe::isProbe(sample.id)) {
+                _probe->record(sample.stamp,now);
+            }
+        }
+    }
+    _latchSequence = history.getSequence();
+    _latchTime = now;
+    return late;
+}
+
 /**
  * Clears any buffered inputs so that we may start fresh.
  */
@@ -202,6 +261,8 @@ void InputController::clear() {
     _dclick = Vec2::ZERO;
     _plannedLaunch = Vec2::ZERO;
     _touchids.clear();
+    _launchOffset = 0.0f;
+    _latchTime.mark();
 }
 
 void InputController::clearAvatarStates() {
@@ -265,6 +326,7 @@ void InputController::mouseReleasedCB(const MouseEvent& event, Uint8 clicks, boo
 
         _inputLaunch = _plannedLaunch;
         _launchInputted = true;
+        _launchTime = event.timestamp;
     }
 }
 
@@ -295,6 +357,9 @@ void InputController::mouseDraggedCB(const MouseEvent& event, const Vec2& previo
  * @param focus	Whether the listener currently has focus
  */
 void InputController::touchBeganCB(const TouchEvent& event, bool focus) {
+    if (LatencyProbe::isProbe(event.touch)) {
+        return;
+    }
     _touchids.insert(event.touch);
 
     if (event.timestamp.ellapsedMillis(_clickTime) <= 250.0f) {
@@ -327,6 +392,9 @@ void InputController::touchBeganCB(const TouchEvent& event, bool focus) {
  * @param focus	Whether the listener currently has focus
  */
 void InputController::touchEndedCB(const TouchEvent& event, bool focus) {
+    if (LatencyProbe::isProbe(event.touch)) {
+        return;
+    }
     Vec2 finishDrag = event.position - _dclick;
 
     if (finishDrag.lengthSquared() < 625.0f) {
@@ -340,6 +408,7 @@ void InputController::touchEndedCB(const TouchEvent& event, bool focus) {
 
         _inputLaunch = finishDrag;
         _launchInputted = true;
+        _launchTime = event.timestamp;
     }
 
     // finger lifted off screen, remove from set of touch IDs
@@ -361,6 +430,9 @@ void InputController::touchEndedCB(const TouchEvent& event, bool focus) {
  * @param focus	Whether the listener currently has focus
  */
 void InputController::touchesDraggedCB(const TouchEvent& event, const Vec2& previous, bool focus) {
+    if (LatencyProbe::isProbe(event.touch)) {
+        return;
+    }
     if (_touchids.size() == 1) {
         Vec2 currentDrag = event.position - _dclick;
         
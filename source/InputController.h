@@ -8,6 +8,7 @@
 #define __INPUT_H__
 #include <cugl/cugl.h>
 #include <unordered_set>
+#include "LatencyProbe.h"
 template <typename T> int sgn(T val) {
     return (T(0) < val) - (val < T(0));
 }
@@ -58,6 +59,18 @@ private:
     cugl::Timestamp _clickTime;
     /** The touch id(s) of fingers on the screen */
     std::unordered_set<Uint64> _touchids;
+    /** The time the current launch was released */
+    cugl::Timestamp _launchTime;
+
+    // LATE LATCHING
+    /** Whether to process pointer events again right before the physics step */
+    bool _lateLatch;
+    /** The time of the last latch */
+    cugl::Timestamp _latchTime;
+    /** The pointer history sequence at the last latch */
+    Uint64 _latchSequence;
+    /** The latency probe to report probe events to (may be null) */
+    std::shared_ptr<LatencyProbe> _probe;
   
     /** Maximum allowed Lumia launch velocity */
     float MAXIMUM_LAUNCH_VELOCITY = 20.5f;
@@ -91,6 +104,8 @@ protected:
     /** The planned launch velocity produced by player input drag */
     cugl::Vec2 _plannedLaunch;
     float _dragDistance;
+    /** How far into the last frame the launch was released (0 to 1) */
+    float _launchOffset;
   
 public:
 #pragma mark -
@@ -158,6 +173,21 @@ public:
      */
     void  update(float dt);
 
+    /**
+     * Samples the pointer one last time before the physics step.
+     *
+     * This pumps any pointer events that arrived since {@link update} (unless
+     * late latching is disabled). A drag-and-release that shows up here is
+     * reported by {@link didLaunch()} this frame instead of the next one.
+     *
+     * It also works out where in the last frame the launch happened (see
+     * {@link getLaunchOffset()}), and reports any latency probe events in the
+     * pointer history. It should be called exactly once per physics step.
+     *
+     * @return true if a launch arrived after {@link update} this frame
+     */
+    bool latch();
+
     /**
      * Clears any buffered inputs so that we may start fresh.
      */
@@ -230,6 +260,45 @@ public:
      */
     float didLaunch() const { return _launched; }
 
+    /**
+     * Returns how far into the last frame the launch was released.
+     *
+     * The value is between 0 (at the previous latch) and 1 (at this latch),
+     * and is only meaningful after {@link latch()} in a frame with a launch.
+     * The physics step uses it to apply the launch impulse part way through
+     * the step.
+     *
+     * @return how far into the last frame the launch was released.
+     */
+    float getLaunchOffset() const { return _launchOffset; }
+
+    /**
+     * Returns true if pointer events are processed again before the physics step
+     *
+     * @return true if pointer events are processed again before the physics step
+     */
+    bool isLateLatch() const { return _lateLatch; }
+
+    /**
+     * Sets whether pointer events are processed again before the physics step
+     *
+     * This is on by default. Turning it off is only useful to measure the
+     * latency it saves.
+     *
+     * @param value Whether to late latch the pointer
+     */
+    void setLateLatch(bool value) { _lateLatch = value; }
+
+    /**
+     * Sets the latency probe to report probe events to.
+     *
+     * Probe events are found in the pointer history when latching. They are
+     * ignored by all of the gameplay callbacks.
+     *
+     * @param probe The latency probe (or nullptr to stop reporting)
+     */
+    void setLatencyProbe(const std::shared_ptr<LatencyProbe>& probe) { _probe = probe; }
+
     /**
      * Returns true if the reset button was pressed.
      *
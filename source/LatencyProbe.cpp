@@ -0,0 +1,154 @@
+//
+//  LatencyProbe.cpp
+//  Lumia
+//
+//  A tool for measuring input-to-physics latency. A background thread pushes
+//  synthetic pointer events into the SDL queue at irregular intervals, so that
+//  they land at every phase of the animation frame. The input controller finds
+//  them in the device history when it latches input just before the physics
+//  step, and reports how long each one waited.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#include "LatencyProbe.h"
+#include <chrono>
+#include <random>
+#include <sstream>
+
+using namespace cugl;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an inactive latency probe.
+ *
+ * This constructor does not start the probe thread.
+ */
+LatencyProbe::LatencyProbe() :
+_running(false),
+_period(0),
+_count(0),
+_total(0),
+_minimum(0),
+_maximum(0) {
+}
+
+/**
+ * Disposes of this probe, stopping the probe thread.
+ */
+void LatencyProbe::dispose() {
+    stop();
+    reset();
+}
+
+/**
+ * Initializes a probe with the given event period.
+ *
+ * The actual interval between events is jittered around the period so
+ * that the events do not lock to the frame rate.
+ *
+ * @param period    The average milliseconds between probe events
+ *
+ * @return true if the probe was initialized successfully
+ */
+bool LatencyProbe::init(Uint32 period) {
+    CUAssertLog(period > 0, "Probe period must be positive");
+    _period = period;
+    reset();
+    return true;
+}
+
+#pragma mark -
+#pragma mark Probing
+/**
+ * Starts pushing probe events from a background thread.
+ */
+void LatencyProbe::start() {
+    if (_running.load()) {
+        return;
+    }
+    _running.store(true);
+    _thread = std::thread([this] { run(); });
+}
+
+/**
+ * Stops pushing probe events, joining the background thread.
+ */
+void LatencyProbe::stop() {
+    _running.store(false);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+/**
+ * Pushes probe events until the probe is stopped
+ */
+void LatencyProbe::run() {
+    std::minstd_rand random(_period);
+    std::uniform_int_distribution<Uint32> jitter(_period/2, _period+_period/2);
+    while (_running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(jitter(random)));
+
+        // Off screen, so no widget can ever claim it
+        SDL_Event event;
+        SDL_zero(event);
+#ifndef CU_TOUCH_SCREEN
+        event.type = SDL_MOUSEMOTION;
+        event.motion.which = PROBE_ID;
+        event.motion.state = 0;
+        event.motion.x = -1;
+        event.motion.y = -1;
+#else
+        event.type = SDL_FINGERUP;
+        event.tfinger.fingerId = PROBE_ID;
+        event.tfinger.x = -1.0f;
+        event.tfinger.y = -1.0f;
+#endif
+        // SDL stamps the event as it is pushed
+        SDL_PushEvent(&event);
+    }
+}
+
+#pragma mark -
+#pragma mark Measurements
+/**
+ * Records that a probe event reached the physics step.
+ *
+ * The event time comes from SDL, and so has millisecond resolution.
+ *
+ * @param event The time the probe event was pushed
+ * @param step  The time the input was latched for the physics step
+ */
+void LatencyProbe::record(const Timestamp& event, const Timestamp& step) {
+    Uint64 latency = (event < step ? Timestamp::ellapsedMicros(event,step) : 0);
+    _minimum = (_count == 0 || latency < _minimum ? latency : _minimum);
+    _maximum = (latency > _maximum ? latency : _maximum);
+    _total += latency;
+    _count++;
+}
+
+/**
+ * Clears all measurements.
+ */
+void LatencyProbe::reset() {
+    _count = 0;
+    _total = 0;
+    _minimum = 0;
+    _maximum = 0;
+}
+
+/**
+ * Returns a summary of the measurements for logging.
+ *
+ * @return a summary of the measurements for logging.
+ */
+std::string LatencyProbe::toString() const {
+    std::stringstream ss;
+    ss << _count << " events, ";
+    ss << "avg " << getAverage() << " ms, ";
+    ss << "min " << getMinimum() << " ms, ";
+    ss << "max " << getMaximum() << " ms";
+    return ss.str();
+}
@@ -0,0 +1,154 @@
+//
+//  LatencyProbe.h
+//  Lumia
+//
+//  A tool for measuring input-to-physics latency. A background thread pushes
+//  synthetic pointer events into the SDL queue at irregular intervals, so that
+//  they land at every phase of the animation frame. The input controller finds
+//  them in the device history when it latches input just before the physics
+//  step, and reports how long each one waited.
+//
+//  The probe events are chosen so that they never reach gameplay. On desktop
+//  they are mouse motion with no button held (ignored with DRAG awareness),
+//  and on mobile they are finger releases with a reserved touch id.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#ifndef LatencyProbe_h
+#define LatencyProbe_h
+#include <cugl/cugl.h>
+#include <atomic>
+#include <thread>
+
+class LatencyProbe {
+public:
+    /** The pointer id of every synthetic probe event */
+    static const Uint32 PROBE_ID = 0xC0DE;
+
+private:
+    /** The thread pushing the synthetic events */
+    std::thread _thread;
+    /** Whether the probe thread should keep running */
+    std::atomic<bool> _running;
+    /** The average number of milliseconds between probe events */
+    Uint32 _period;
+
+    /** The number of probe events measured */
+    Uint64 _count;
+    /** The total latency of all probe events in microseconds */
+    Uint64 _total;
+    /** The smallest latency measured in microseconds */
+    Uint64 _minimum;
+    /** The largest latency measured in microseconds */
+    Uint64 _maximum;
+
+    /** Pushes probe events until the probe is stopped */
+    void run();
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an inactive latency probe.
+     *
+     * This constructor does not start the probe thread.
+     */
+    LatencyProbe();
+
+    /**
+     * Disposes of this probe, stopping the probe thread.
+     */
+    ~LatencyProbe() { dispose(); }
+
+    /**
+     * Disposes of this probe, stopping the probe thread.
+     */
+    void dispose();
+
+    /**
+     * Initializes a probe with the given event period.
+     *
+     * The actual interval between events is jittered around the period so
+     * that the events do not lock to the frame rate.
+     *
+     * @param period    The average milliseconds between probe events
+     *
+     * @return true if the probe was initialized successfully
+     */
+    bool init(Uint32 period);
+
+    /**
+     * Returns a newly allocated probe with the given event period.
+     *
+     * @param period    The average milliseconds between probe events
+     *
+     * @return a newly allocated probe with the given event period.
+     */
+    static std::shared_ptr<LatencyProbe> alloc(Uint32 period) {
+        std::shared_ptr<LatencyProbe> result = std::make_shared<LatencyProbe>();
+        return (result->init(period) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Probing
+    /**
+     * Starts pushing probe events from a background thread.
+     */
+    void start();
+
+    /**
+     * Stops pushing probe events, joining the background thread.
+     */
+    void stop();
+
+    /** Returns true if the probe thread is running */
+    bool isRunning() const { return _running.load(); }
+
+    /**
+     * Returns true if the given pointer id belongs to a probe event
+     *
+     * @param id    The pointer id from a touch, mouse event or input sample
+     *
+     * @return true if the given pointer id belongs to a probe event
+     */
+    static bool isProbe(Uint64 id) { return id == PROBE_ID; }
+
+#pragma mark -
+#pragma mark Measurements
+    /**
+     * Records that a probe event reached the physics step.
+     *
+     * The event time comes from SDL, and so has millisecond resolution.
+     *
+     * @param event The time the probe event was pushed
+     * @param step  The time the input was latched for the physics step
+     */
+    void record(const cugl::Timestamp& event, const cugl::Timestamp& step);
+
+    /**
+     * Clears all measurements.
+     */
+    void reset();
+
+    /** Returns the number of probe events measured */
+    Uint64 getCount() const { return _count; }
+
+    /** Returns the average latency in milliseconds */
+    float getAverage() const { return _count ? (float)_total/(1000.0f*_count) : 0.0f; }
+
+    /** Returns the smallest latency in milliseconds */
+    float getMinimum() const { return _count ? _minimum/1000.0f : 0.0f; }
+
+    /** Returns the largest latency in milliseconds */
+    float getMaximum() const { return _count ? _maximum/1000.0f : 0.0f; }
+
+    /**
+     * Returns a summary of the measurements for logging.
+     *
+     * @return a summary of the measurements for logging.
+     */
+    std::string toString() const;
+};
+
+#endif /* LatencyProbe_h */
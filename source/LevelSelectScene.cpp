@@ -23,11 +23,15 @@ using namespace cugl;
  * memory allocation.  Instead, allocation happens in this method.
  *
  * @param assets    The (loaded) assets for this game mode
+ * @param saveFile  The save state
+ * @param streamer  The service building the levels
  *
  * @return true if the controller is initialized properly, false otherwise.
  */
-bool LevelSelectScene::init(const std::shared_ptr<AssetManager>& assets, std::shared_ptr<cugl::JsonValue> saveFile) {
+bool LevelSelectScene::init(const std::shared_ptr<AssetManager>& assets, const std::shared_ptr<SaveController>& saveFile,
+                            const std::shared_ptr<LevelStreamer>& streamer) {
     setName("levelselect");
+    _streamer = streamer;
 
     _input = InputController::getInstance();
     _input->init();
@@ -53,9 +57,9 @@ bool LevelSelectScene::init(const std::shared_ptr<AssetManager>& assets, std::sh
 
     
     _UINode->setContentSize(dimen);
-    _UINode->doLayout(); // This rearranges the children to fit the screen
+    _UINode->updateLayout(); // This rearranges the children to fit the screen
     layer->setContentSize(dimen);
-    layer->doLayout(); // This rearranges the children to fit the screen
+    layer->updateLayout(); // This rearranges the children to fit the screen
     
     std::shared_ptr<Texture> bkgTexture = assets->get<Texture>("background");
     std::shared_ptr<BackgroundNode> bkgNode = BackgroundNode::alloc(bkgTexture);
@@ -113,6 +117,10 @@ bool LevelSelectScene::init(const std::shared_ptr<AssetManager>& assets, std::sh
                    this->_active = down;
                    _nextScene = "game";
                    _selectedLevel = "json/level" + std::to_string(count) + ".json";
+                   if (down) {
+                       // Start building before the button is released
+                       prefetch(count-1, LevelStreamer::SELECTED);
+                   }
                }
            });
      
@@ -134,6 +142,8 @@ bool LevelSelectScene::init(const std::shared_ptr<AssetManager>& assets, std::sh
 void LevelSelectScene::dispose() {
     _buttons.clear();
     _assets = nullptr;
+    _streamer = nullptr;
+    _save = nullptr;
     Scene2::dispose();
 }
 
@@ -142,7 +152,7 @@ void LevelSelectScene::dispose() {
  *
  * @param value whether the scene is currently active
  */
-void LevelSelectScene::setActive(bool value, std::shared_ptr<cugl::JsonValue> saveFile) {
+void LevelSelectScene::setActive(bool value, const std::shared_ptr<SaveController>& saveFile) {
     _active = value;
     if (!value){
         _setStart = false;
@@ -158,13 +168,13 @@ void LevelSelectScene::setActive(bool value, std::shared_ptr<cugl::JsonValue> sa
         auto layer = _assets->get<scene2::SceneNode>("levelselect");
         auto levelbuttons = layer->getChildren();
 
-        std::shared_ptr<cugl::JsonValue> levelSaves = saveFile->get("level_saves");
         // order of levelbuttons in assets.json must be in same order as in save.json
+        _save = saveFile;
         for (int i = 0; i < levelbuttons.size(); i++) {
             std::shared_ptr<scene2::Button> button = std::dynamic_pointer_cast<scene2::Button>(levelbuttons[i]);
-            std::shared_ptr<cugl::JsonValue> level = levelSaves->get(i);
+            const SaveController::LevelSave& level = saveFile->getLevel(i);
 
-            if (level->getBool("completed")) {
+            if (level.completed) {
                 std::dynamic_pointer_cast<scene2::TexturedNode>(button->getChildByName("up"))->setTexture(_assets->get<Texture>("level_complete"));
                 std::dynamic_pointer_cast<scene2::Label>(button->getChildByName("up")->getChildByName("label"))->setForeground(Color4::WHITE);
             } else {
@@ -172,13 +182,13 @@ void LevelSelectScene::setActive(bool value, std::shared_ptr<cugl::JsonValue> sa
                 std::dynamic_pointer_cast<scene2::Label>(button->getChildByName("up")->getChildByName("label"))->setForeground(Color4::BLACK);
             }
 
-            if (level->getBool("unlocked")) {
+            if (level.unlocked) {
                 if (!button->isActive()) {
                     button->activate();
                 }
                 button->setColor(Color4::WHITE);
 
-                int stars = level->getInt("stars");
+                int stars = level.stars;
                 if (stars == 3) {
                     std::dynamic_pointer_cast<scene2::TexturedNode>(button->getChildByName("up")->getChildByName("star1empty"))->setVisible(false);
                     std::dynamic_pointer_cast<scene2::TexturedNode>(button->getChildByName("up")->getChildByName("star2empty"))->setVisible(false);
@@ -222,6 +232,32 @@ void LevelSelectScene::setActive(bool value, std::shared_ptr<cugl::JsonValue> sa
                 std::dynamic_pointer_cast<scene2::TexturedNode>(button->getChildByName("up")->getChildByName("star3filled"))->setVisible(false);
             }
         }
+
+        // The first unfinished level is the most likely pick
+        size_t likely = 0;
+        while (likely+1 < saveFile->getLevelCount() && saveFile->getLevel(likely).completed && saveFile->getLevel(likely+1).unlocked) {
+            likely++;
+        }
+        prefetch(likely, LevelStreamer::LIKELY);
+    }
+}
+
+/**
+ * Requests that the given level and its unlocked neighbours be built.
+ *
+ * @param index     The level index (in level select order)
+ * @param priority  The priority of the level itself
+ */
+void LevelSelectScene::prefetch(size_t index, int priority) {
+    if (_streamer == nullptr || _save == nullptr || index >= _save->getLevelCount()) {
+        return;
+    }
+    _streamer->request(_save->getLevel(index).path, priority);
+    if (index+1 < _save->getLevelCount() && _save->getLevel(index+1).unlocked) {
+        _streamer->request(_save->getLevel(index+1).path, LevelStreamer::NEIGHBOR);
+    }
+    if (index > 0) {
+        _streamer->request(_save->getLevel(index-1).path, LevelStreamer::NEIGHBOR);
     }
 }
 
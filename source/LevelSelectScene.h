@@ -15,6 +15,8 @@
 #include "BackgroundNode.h"
 
 #include "LevelSelectTile.h"
+#include "SaveController.h"
+#include "LevelStreamer.h"
 
 /**
  * A scene for demoing a simple button
@@ -30,6 +32,11 @@ protected:
     /** The identifier for the level selected by the player */
     string _selectedLevel;
     
+    /** The service building levels before they are played */
+    std::shared_ptr<LevelStreamer> _streamer;
+    /** The save state (to skip locked levels when prefetching) */
+    std::shared_ptr<SaveController> _save;
+    
     std::shared_ptr<cugl::scene2::SceneNode> _scrollNode;
     std::shared_ptr<cugl::scene2::SceneNode> _UINode;
     
@@ -60,6 +67,14 @@ protected:
     
     void addTileGroup(float offset, std::shared_ptr<Texture> tile3, std::shared_ptr<Texture> tile4);
     
+    /**
+     * Requests that the given level and its unlocked neighbours be built.
+     *
+     * @param index     The level index (in level select order)
+     * @param priority  The priority of the level itself
+     */
+    void prefetch(size_t index, int priority);
+    
 public:
 #pragma mark -
 #pragma mark Constructors
@@ -97,14 +112,18 @@ public:
      * memory allocation.  Instead, allocation happens in this method.
      *
      * @param assets    The (loaded) assets for this game mode
+     * @param saveFile  The save state
+     * @param streamer  The service building the levels
      *
      * @return true if the controller is initialized properly, false otherwise.
      */
-    bool init(const std::shared_ptr<cugl::AssetManager>& assets, std::shared_ptr<cugl::JsonValue> saveFile);
+    bool init(const std::shared_ptr<cugl::AssetManager>& assets, const std::shared_ptr<SaveController>& saveFile,
+              const std::shared_ptr<LevelStreamer>& streamer);
     
-    static std::shared_ptr<LevelSelectScene> alloc(const std::shared_ptr<cugl::AssetManager>& assets, std::shared_ptr<cugl::JsonValue> saveFile) {
+    static std::shared_ptr<LevelSelectScene> alloc(const std::shared_ptr<cugl::AssetManager>& assets, const std::shared_ptr<SaveController>& saveFile,
+                                                    const std::shared_ptr<LevelStreamer>& streamer) {
         std::shared_ptr<LevelSelectScene> result = std::make_shared<LevelSelectScene>();
-        return (result->init(assets, saveFile) ? result : nullptr);
+        return (result->init(assets, saveFile, streamer) ? result : nullptr);
     }
     
     /**
@@ -112,7 +131,7 @@ public:
      *
      * @param value whether the scene is currently active
      */
-    virtual void setActive(bool value, std::shared_ptr<cugl::JsonValue> saveFile);
+    virtual void setActive(bool value, const std::shared_ptr<SaveController>& saveFile);
 
     /** Returns the string representing the next scene to transition to */
     string getNextScene() { return _nextScene; }
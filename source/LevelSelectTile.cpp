@@ -11,3 +11,8 @@ void LevelSelectTile::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
                       const cugl::Mat4& transform, cugl::Color4 tint) {
     scene2::PolygonNode::draw(batch, transform, tint);
 }
+
+void LevelSelectTile::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    scene2::PolygonNode::draw(batch, transform, tint);
+}
@@ -33,6 +33,9 @@ public:
 
     void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
               const cugl::Mat4& transform, cugl::Color4 tint) override;
+
+    void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+              const cugl::Affine2& transform, cugl::Color4 tint) override;
     
 };
   
@@ -0,0 +1,361 @@
+//
+//  LevelStreamer.cpp
+//  Lumia
+//
+//  Builds levels on worker threads before the player asks for them. A built
+//  level has its physics world, tile geometry and scene graph ready, so that
+//  starting a level only has to attach them to the game scene. Requests have
+//  priorities, so the level the player picked is built before its neighbours,
+//  and they may be cancelled when the player moves on.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#include "LevelStreamer.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace cugl;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized streamer.
+ *
+ * This constructor does not start the workers.
+ */
+LevelStreamer::LevelStreamer() :
+_capacity(0),
+_order(0),
+_running(false),
+_enabled(true),
+_hits(0),
+_waits(0),
+_misses(0),
+_builds(0),
+_cancels(0),
+_acquireTime(0),
+_acquireMax(0),
+_buildTime(0) {
+}
+
+/**
+ * Disposes of this streamer, abandoning any unfinished builds.
+ *
+ * The workers are joined before this method returns.
+ */
+void LevelStreamer::dispose() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _running = false;
+        _queue.clear();
+        for (auto it = _building.begin(); it != _building.end(); ++it) {
+            it->second.cancelled->store(true);
+        }
+    }
+    _request.notify_all();
+    for (auto it = _threads.begin(); it != _threads.end(); ++it) {
+        if (it->joinable()) {
+            it->join();
+        }
+    }
+    _threads.clear();
+    _ready.clear();
+    _builder = nullptr;
+}
+
+/**
+ * Initializes the streamer with the given builder.
+ *
+ * @param builder   The function building the levels
+ * @param workers   The number of worker threads
+ * @param capacity  The most levels to keep built or building at once
+ *
+ * @return true if the streamer was initialized successfully
+ */
+bool LevelStreamer::init(const Builder& builder, size_t workers, size_t capacity) {
+    CUAssertLog(!_running, "Level streamer is already initialized");
+    CUAssertLog(builder != nullptr, "Level streamer requires a builder");
+    _builder = builder;
+    _capacity = std::max(capacity,(size_t)1);
+    _running = true;
+    for (size_t ii = 0; ii < std::max(workers,(size_t)1); ii++) {
+        _threads.push_back(std::thread([this] { run(); }));
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Requests
+/**
+ * Requests that the given level be built.
+ *
+ * If the level is already waiting, it keeps the more urgent of the two
+ * priorities. If it is built or building, this method does nothing.
+ *
+ * @param path      The asset path of the level file
+ * @param priority  The request priority
+ */
+void LevelStreamer::request(const std::string& path, int priority) {
+    if (!_enabled) {
+        return;
+    }
+
+    std::shared_ptr<PreparedLevel> dropped;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto ready = _ready.find(path);
+        if (ready != _ready.end()) {
+            ready->second.priority = std::min(ready->second.priority,priority);
+            return;
+        } else if (_building.find(path) != _building.end()) {
+            return;
+        }
+
+        auto it = std::find_if(_queue.begin(), _queue.end(), [&](const Request& r) { return r.path == path; });
+        if (it != _queue.end()) {
+            it->priority = std::min(it->priority,priority);
+        } else {
+            Request entry;
+            entry.path = path;
+            entry.priority = priority;
+            entry.order = _order++;
+            _queue.push_back(entry);
+        }
+        dropped = evict(priority);
+    }
+    _request.notify_one();
+}
+
+/**
+ * Cancels the given level.
+ *
+ * The level is removed from the queue, a build in progress is abandoned,
+ * and a built level is released.
+ *
+ * @param path      The asset path of the level file
+ */
+void LevelStreamer::cancel(const std::string& path) {
+    std::shared_ptr<PreparedLevel> dropped;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _queue.erase(std::remove_if(_queue.begin(), _queue.end(), [&](const Request& r) { return r.path == path; }), _queue.end());
+        auto building = _building.find(path);
+        if (building != _building.end()) {
+            building->second.cancelled->store(true);
+        }
+        auto ready = _ready.find(path);
+        if (ready != _ready.end()) {
+            dropped = ready->second.level;
+            _ready.erase(ready);
+            _cancels++;
+        }
+    }
+    _request.notify_all();
+}
+
+/**
+ * Cancels every level, as in {@link cancel}.
+ */
+void LevelStreamer::cancelAll() {
+    std::unordered_map<std::string, Entry> dropped;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _queue.clear();
+        for (auto it = _building.begin(); it != _building.end(); ++it) {
+            it->second.cancelled->store(true);
+        }
+        _cancels += _ready.size();
+        dropped.swap(_ready);
+    }
+    _request.notify_all();
+}
+
+/**
+ * Returns the given level, ready to attach to a game scene.
+ *
+ * If the level is built, it is returned immediately. If a worker is
+ * building it, this method waits for the build. Otherwise, the level is
+ * built on the calling thread. A level can only be acquired once, so it
+ * must be requested again to be prepared for a restart.
+ *
+ * @param path      The asset path of the level file
+ *
+ * @return the given level, ready to attach to a game scene.
+ */
+std::shared_ptr<PreparedLevel> LevelStreamer::acquire(const std::string& path) {
+    Timestamp start;
+    std::shared_ptr<PreparedLevel> result;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        bool waited = false;
+        auto building = _building.find(path);
+        if (building != _building.end()) {
+            // Reclaim a build that was cancelled but has not stopped yet
+            building->second.cancelled->store(false);
+            _built.wait(lock, [&] { return _building.find(path) == _building.end(); });
+            waited = true;
+        }
+
+        auto ready = _ready.find(path);
+        if (ready != _ready.end()) {
+            result = ready->second.level;
+            _ready.erase(ready);
+            if (waited) {
+                _waits++;
+            } else {
+                _hits++;
+            }
+        } else {
+            _queue.erase(std::remove_if(_queue.begin(), _queue.end(), [&](const Request& r) { return r.path == path; }), _queue.end());
+            _misses++;
+        }
+    }
+    _request.notify_all();
+
+    if (result == nullptr) {
+        std::atomic<bool> never(false);
+        Timestamp begin;
+        result = _builder(path,never);
+        if (result != nullptr) {
+            result->buildTime = Timestamp::ellapsedMicros(begin,Timestamp());
+        }
+    }
+
+    Uint64 stall = Timestamp::ellapsedMicros(start,Timestamp());
+    std::unique_lock<std::mutex> lock(_mutex);
+    _acquireTime += stall;
+    _acquireMax = (stall > _acquireMax ? stall : _acquireMax);
+    return result;
+}
+
+/**
+ * Sets whether requests are honored.
+ *
+ * A disabled streamer cancels everything and ignores requests, so every
+ * level is built when it is acquired. This is the baseline for profiling.
+ *
+ * @param value Whether requests are honored
+ */
+void LevelStreamer::setEnabled(bool value) {
+    _enabled = value;
+    if (!value) {
+        cancelAll();
+    }
+}
+
+#pragma mark -
+#pragma mark Workers
+/**
+ * Returns true if a worker may start the next request
+ *
+ * The mutex must be held.
+ *
+ * @return true if a worker may start the next request
+ */
+bool LevelStreamer::hasWork() const {
+    return !_queue.empty() && _ready.size()+_building.size() < _capacity;
+}
+
+/**
+ * Drops the least urgent built level if the streamer is at capacity
+ *
+ * The level is only dropped if it is less urgent than the given priority.
+ * The mutex must be held. The dropped level is returned so that it may be
+ * released after the mutex.
+ *
+ * @param priority  The priority of the level that needs a slot
+ *
+ * @return the dropped level (or nullptr if none)
+ */
+std::shared_ptr<PreparedLevel> LevelStreamer::evict(int priority) {
+    if (_ready.size()+_building.size() < _capacity) {
+        return nullptr;
+    }
+
+    auto worst = _ready.end();
+    for (auto it = _ready.begin(); it != _ready.end(); ++it) {
+        if (it->second.priority > priority && (worst == _ready.end() || it->second.priority > worst->second.priority)) {
+            worst = it;
+        }
+    }
+    if (worst == _ready.end()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<PreparedLevel> result = worst->second.level;
+    _ready.erase(worst);
+    _cancels++;
+    return result;
+}
+
+/**
+ * Builds requested levels until the streamer is disposed
+ */
+void LevelStreamer::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _request.wait(lock, [this] { return !_running || hasWork(); });
+        if (!_running) {
+            break;
+        }
+
+        auto next = std::min_element(_queue.begin(), _queue.end(), [](const Request& a, const Request& b) {
+            return a.priority < b.priority || (a.priority == b.priority && a.order < b.order);
+        });
+        Request request = *next;
+        _queue.erase(next);
+
+        Build build;
+        build.cancelled = std::make_shared<std::atomic<bool>>(false);
+        build.priority = request.priority;
+        _building[request.path] = build;
+        lock.unlock();
+
+        Timestamp start;
+        std::shared_ptr<PreparedLevel> level = _builder(request.path,*build.cancelled);
+        Timestamp end;
+        if (level != nullptr) {
+            level->buildTime = Timestamp::ellapsedMicros(start,end);
+        }
+
+        lock.lock();
+        _building.erase(request.path);
+        _buildTime += Timestamp::ellapsedMicros(start,end);
+        _builds++;
+        if (level != nullptr && !build.cancelled->load()) {
+            Entry entry;
+            entry.level = level;
+            entry.priority = request.priority;
+            _ready[request.path] = entry;
+            level = nullptr;
+        } else {
+            _cancels++;
+        }
+        _built.notify_all();
+
+        // An abandoned level is released outside of the lock
+        if (level != nullptr) {
+            lock.unlock();
+            level = nullptr;
+            lock.lock();
+        }
+    }
+}
+
+/**
+ * Returns a summary of the streaming statistics for logging.
+ *
+ * @return a summary of the streaming statistics for logging.
+ */
+std::string LevelStreamer::toString() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    Uint64 acquires = _hits+_waits+_misses;
+    std::stringstream ss;
+    ss << acquires << " acquires (" << _hits << " ready, " << _waits << " waited, " << _misses << " built on demand), ";
+    ss << _builds << " builds, " << _cancels << " cancelled, ";
+    ss << "acquire avg " << (acquires ? (float)_acquireTime/(1000.0f*acquires) : 0.0f) << " ms, ";
+    ss << "acquire max " << _acquireMax/1000.0f << " ms, ";
+    ss << "build avg " << (_builds ? (float)_buildTime/(1000.0f*_builds) : 0.0f) << " ms";
+    return ss.str();
+}
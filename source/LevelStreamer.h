@@ -0,0 +1,278 @@
+//
+//  LevelStreamer.h
+//  Lumia
+//
+//  Builds levels on worker threads before the player asks for them. A built
+//  level has its physics world, tile geometry and scene graph ready, so that
+//  starting a level only has to attach them to the game scene. Requests have
+//  priorities, so the level the player picked is built before its neighbours,
+//  and they may be cancelled when the player moves on.
+//
+//  Only CPU work happens on the workers. Textures must be resolved on the main
+//  thread beforehand, and nothing may touch OpenGL.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#ifndef LevelStreamer_h
+#define LevelStreamer_h
+#include <cugl/cugl.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "LevelModel.h"
+
+/**
+ * A level that is built, but not yet attached to a game scene
+ *
+ * The obstacles of the level are already in the world, and their scene nodes
+ * are already in the world node. Animation clocks, contact listeners and
+ * anything else that belongs to the game scene are left to the main thread.
+ */
+struct PreparedLevel {
+    /** The asset path of the level file */
+    std::string path;
+    /** The level model (not shared with any other prepared level) */
+    std::shared_ptr<LevelModel> model;
+    /** The physics world with every obstacle of the level */
+    std::shared_ptr<cugl::physics2::ObstacleWorld> world;
+    /** The physics root of the scene graph */
+    std::shared_ptr<cugl::scene2::SceneNode> worldnode;
+    /** The debug root of the scene graph */
+    std::shared_ptr<cugl::scene2::SceneNode> debugnode;
+    /** The scale between the physics world and the screen */
+    float scale;
+    /** The time to build the level in microseconds */
+    Uint64 buildTime;
+};
+
+class LevelStreamer {
+public:
+    /**
+     * A function to build the level with the given path
+     *
+     * The function is called on a worker thread. It should check the cancel
+     * flag between steps, and return nullptr as soon as it is set.
+     */
+    typedef std::function<std::shared_ptr<PreparedLevel>(const std::string& path, const std::atomic<bool>& cancelled)> Builder;
+
+    /** The request priorities, from most to least urgent */
+    enum Priority {
+        /** A level the player has picked */
+        SELECTED = 0,
+        /** The level the player is most likely to pick */
+        LIKELY = 1,
+        /** A level next to a selected or likely level */
+        NEIGHBOR = 2,
+        /** The level being played, in case it is restarted */
+        RESTART = 3
+    };
+
+private:
+    /** A level waiting for a worker */
+    struct Request {
+        /** The asset path of the level file */
+        std::string path;
+        /** The request priority (smaller is sooner) */
+        int priority;
+        /** The request order, to break priority ties */
+        Uint64 order;
+    };
+
+    /** A level being built by a worker */
+    struct Build {
+        /** The flag telling the worker to abandon the build */
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        /** The request priority */
+        int priority;
+    };
+
+    /** A level that is built and waiting to be acquired */
+    struct Entry {
+        /** The built level */
+        std::shared_ptr<PreparedLevel> level;
+        /** The request priority */
+        int priority;
+    };
+
+    /** The function building the levels */
+    Builder _builder;
+    /** The worker threads */
+    std::vector<std::thread> _threads;
+    /** Protects every field shared with the workers */
+    std::mutex _mutex;
+    /** Signals the workers (new request, free slot or shutdown) */
+    std::condition_variable _request;
+    /** Signals waiting threads that a build finished */
+    std::condition_variable _built;
+    /** The levels waiting for a worker */
+    std::vector<Request> _queue;
+    /** The levels being built */
+    std::unordered_map<std::string, Build> _building;
+    /** The levels built and not yet acquired */
+    std::unordered_map<std::string, Entry> _ready;
+    /** The most levels to keep built or building at once */
+    size_t _capacity;
+    /** The order of the next request */
+    Uint64 _order;
+    /** Whether the workers should keep running */
+    bool _running;
+    /** Whether requests are honored (acquire always builds if not) */
+    bool _enabled;
+
+    /** The number of levels acquired already built */
+    Uint64 _hits;
+    /** The number of levels acquired while building */
+    Uint64 _waits;
+    /** The number of levels built on acquire */
+    Uint64 _misses;
+    /** The number of levels built by the workers */
+    Uint64 _builds;
+    /** The number of builds cancelled or evicted */
+    Uint64 _cancels;
+    /** The total main thread time spent acquiring levels in microseconds */
+    Uint64 _acquireTime;
+    /** The largest main thread time for a single acquire in microseconds */
+    Uint64 _acquireMax;
+    /** The total worker time spent building levels in microseconds */
+    Uint64 _buildTime;
+
+    /** Builds requested levels until the streamer is disposed */
+    void run();
+
+    /**
+     * Returns true if a worker may start the next request
+     *
+     * The mutex must be held.
+     *
+     * @return true if a worker may start the next request
+     */
+    bool hasWork() const;
+
+    /**
+     * Drops the least urgent built level if the streamer is at capacity
+     *
+     * The level is only dropped if it is less urgent than the given priority.
+     * The mutex must be held. The dropped level is returned so that it may be
+     * released after the mutex.
+     *
+     * @param priority  The priority of the level that needs a slot
+     *
+     * @return the dropped level (or nullptr if none)
+     */
+    std::shared_ptr<PreparedLevel> evict(int priority);
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized streamer.
+     *
+     * This constructor does not start the workers.
+     */
+    LevelStreamer();
+
+    /**
+     * Disposes of this streamer, abandoning any unfinished builds.
+     */
+    ~LevelStreamer() { dispose(); }
+
+    /**
+     * Disposes of this streamer, abandoning any unfinished builds.
+     *
+     * The workers are joined before this method returns.
+     */
+    void dispose();
+
+    /**
+     * Initializes the streamer with the given builder.
+     *
+     * @param builder   The function building the levels
+     * @param workers   The number of worker threads
+     * @param capacity  The most levels to keep built or building at once
+     *
+     * @return true if the streamer was initialized successfully
+     */
+    bool init(const Builder& builder, size_t workers, size_t capacity);
+
+    /**
+     * Returns a newly allocated streamer with the given builder.
+     *
+     * @param builder   The function building the levels
+     * @param workers   The number of worker threads
+     * @param capacity  The most levels to keep built or building at once
+     *
+     * @return a newly allocated streamer with the given builder.
+     */
+    static std::shared_ptr<LevelStreamer> alloc(const Builder& builder, size_t workers, size_t capacity) {
+        std::shared_ptr<LevelStreamer> result = std::make_shared<LevelStreamer>();
+        return (result->init(builder,workers,capacity) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Requests
+    /**
+     * Requests that the given level be built.
+     *
+     * If the level is already waiting, it keeps the more urgent of the two
+     * priorities. If it is built or building, this method does nothing.
+     *
+     * @param path      The asset path of the level file
+     * @param priority  The request priority
+     */
+    void request(const std::string& path, int priority);
+
+    /**
+     * Cancels the given level.
+     *
+     * The level is removed from the queue, a build in progress is abandoned,
+     * and a built level is released.
+     *
+     * @param path      The asset path of the level file
+     */
+    void cancel(const std::string& path);
+
+    /**
+     * Cancels every level, as in {@link cancel}.
+     */
+    void cancelAll();
+
+    /**
+     * Returns the given level, ready to attach to a game scene.
+     *
+     * If the level is built, it is returned immediately. If a worker is
+     * building it, this method waits for the build. Otherwise, the level is
+     * built on the calling thread. A level can only be acquired once, so it
+     * must be requested again to be prepared for a restart.
+     *
+     * @param path      The asset path of the level file
+     *
+     * @return the given level, ready to attach to a game scene.
+     */
+    std::shared_ptr<PreparedLevel> acquire(const std::string& path);
+
+    /**
+     * Sets whether requests are honored.
+     *
+     * A disabled streamer cancels everything and ignores requests, so every
+     * level is built when it is acquired. This is the baseline for profiling.
+     *
+     * @param value Whether requests are honored
+     */
+    void setEnabled(bool value);
+
+    /** Returns true if requests are honored */
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Returns a summary of the streaming statistics for logging.
+     *
+     * @return a summary of the streaming statistics for logging.
+     */
+    std::string toString();
+};
+
+#endif /* LevelStreamer_h */
@@ -46,7 +46,7 @@ bool LoadingScene::init(const std::shared_ptr<cugl::AssetManager>& assets) {
     _assets->loadDirectory("json/loading.json");
     auto layer = assets->get<scene2::SceneNode>("load");
     layer->setContentSize(dimen);
-    layer->doLayout(); // This rearranges the children to fit the screen
+    layer->updateLayout(); // This rearranges the children to fit the screen
     
     _bar = std::dynamic_pointer_cast<scene2::ProgressBar>(assets->get<scene2::SceneNode>("load_bar"));
     _brand = assets->get<scene2::SceneNode>("load_name");
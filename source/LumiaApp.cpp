@@ -8,12 +8,15 @@
 
 using namespace cugl;
 
+/** The number of threads building levels in the background */
+#define LEVEL_STREAM_WORKERS 2
+/** The most levels to keep built in the background */
+#define LEVEL_STREAM_CAPACITY 4
+
 
 #pragma mark -
 #pragma mark Application State
 
-#define DEFAULT_SAVE "{\"level_saves\":[{\"name\":\"Level 1\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level1.json\"},{\"name\":\"Level 2\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level2.json\"},{\"name\":\"Level 3\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level3.json\"},{\"name\":\"Level 4\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level4.json\"},{\"name\":\"Level 5\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level5.json\"},{\"name\":\"Level 6\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level6.json\"},{\"name\":\"Level 7\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level7.json\"},{\"name\":\"Level 8\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level8.json\"},{\"name\":\"Level 9\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level9.json\"},{\"name\":\"Level 10\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level10.json\"},{\"name\":\"Level 11\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level11.json\"},{\"name\":\"Level 12\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level12.json\"},{\"name\":\"Level 13\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level13.json\"},{\"name\":\"Level 14\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level14.json\"},{\"name\":\"Level 15\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level15.json\"},{\"name\":\"Level 16\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level16.json\"},{\"name\":\"Level 17\",\"unlocked\":true,\"completed\":false,\"stars\":-1,\"score\":-1,\"path\":\"json/level17.json\"}],\"musicVolume\":1,\"effectVolume\":1}"
-
 /**
  * The method called after OpenGL is initialized, but before running the application.
  *
@@ -42,7 +45,6 @@ void LumiaApp::onStartup() {
     _assets->attach<Sound>(SoundLoader::alloc()->getHook());
     _assets->attach<WidgetValue>(WidgetLoader::alloc()->getHook());
     _assets->attach<scene2::SceneNode>(Scene2Loader::alloc()->getHook());
-    _assets->attach<LevelModel>(GenericLoader<LevelModel>::alloc()->getHook());
     _assets->attach<TileDataModel>(GenericLoader<TileDataModel>::alloc()->getHook());
     // Create a "loading" screen
     _loading.init(_assets);
@@ -53,24 +55,9 @@ void LumiaApp::onStartup() {
     // load in the tiles json file
     _assets->loadAsync<TileDataModel>("json/tiles.json", "json/tiles.json", nullptr);
     
-    if (!cugl::filetool::file_exists(Application::getSaveDirectory() + "save.json")) {
-        // no save file exists yet, so create it
-        std::shared_ptr<cugl::JsonValue> saveJson = cugl::JsonValue::allocWithJson(DEFAULT_SAVE);
-        _saveFile = saveJson;
-        std::shared_ptr<cugl::JsonWriter> writer = cugl::JsonWriter::alloc(Application::getSaveDirectory() + "save.json");
-        writer->writeJson(_saveFile);
-    } else {
-        // save file already exists, so read from it
-        std::shared_ptr<cugl::JsonReader> reader = cugl::JsonReader::alloc(Application::getSaveDirectory() + "save.json");
-        _saveFile = reader->readJson();
-    }
-
-    // load level json files
-    std::shared_ptr<cugl::JsonValue> levels = _saveFile->get("level_saves");
-    for (int i = 0; i < levels->size(); i++) {
-        string levelPath = levels->get(i)->getString("path");
-        _assets->loadAsync<LevelModel>(levelPath, levelPath, nullptr);
-    }
+    // creates the save file if it does not exist yet
+    // (the levels are read by the level streamer when they are needed)
+    _save = SaveController::alloc(Application::getSaveDirectory() + "save.json");
 
     Application::onStartup(); // YOU MUST END with call to parent
 }
@@ -94,6 +81,10 @@ void LumiaApp::onShutdown() {
     _mainMenu.dispose();
     _pause.dispose();
     _win.dispose();
+    if (_streamer != nullptr) {
+        _streamer->dispose();
+        _streamer = nullptr;
+    }
     _assets = nullptr;
     _batch = nullptr;
     _UIbatch = nullptr;
@@ -105,10 +96,10 @@ void LumiaApp::onShutdown() {
     Input::deactivate<Mouse>();
 #endif
     
-    std::shared_ptr<cugl::JsonWriter> writer = cugl::JsonWriter::alloc(Application::getSaveDirectory() + "save.json");
-    _saveFile->get("musicVolume")->set(_settings.getMusicVolume());
-    _saveFile->get("effectVolume")->set(_settings.getEffectVolume());
-    writer->writeJson(_saveFile);
+    // disposing the save controller writes any pending changes
+    _save->setVolumes(_settings.getMusicVolume(), _settings.getEffectVolume());
+    _save->dispose();
+    _save = nullptr;
     AudioEngine::stop();
     Application::onShutdown();  // YOU MUST END with call to parent
 }
@@ -125,10 +116,9 @@ void LumiaApp::onShutdown() {
  * the background.
  */
 void LumiaApp::onSuspend() {
-    std::shared_ptr<cugl::JsonWriter> writer = cugl::JsonWriter::alloc(Application::getSaveDirectory() + "save.json");
-    _saveFile->get("musicVolume")->set(_settings.getMusicVolume());
-    _saveFile->get("effectVolume")->set(_settings.getEffectVolume());
-    writer->writeJson(_saveFile);
+    // changes are saved as they happen, so this rarely has to wait
+    _save->setVolumes(_settings.getMusicVolume(), _settings.getEffectVolume());
+    _save->flush();
     AudioEngine::get()->pause();
 }
 
@@ -143,8 +133,7 @@ void LumiaApp::onSuspend() {
  * paused before app suspension.
  */
 void LumiaApp::onResume() {
-    std::shared_ptr<cugl::JsonReader> reader = cugl::JsonReader::alloc(Application::getSaveDirectory() + "save.json");
-    _saveFile = reader->readJson();
+    // the save state never left memory, so there is nothing to reload
     AudioEngine::get()->resume();
 }
 
@@ -180,10 +169,12 @@ void LumiaApp::update(float timestep) {
                 _pause.setActive(false);
                 _win.init(_assets);
                 _win.setActive(false);
-                _gameplay.init(_assets, "json/level1.json");
+                _streamer = LevelStreamer::alloc(GameScene::getLevelBuilder(_assets),
+                                                 LEVEL_STREAM_WORKERS, LEVEL_STREAM_CAPACITY);
+                _gameplay.init(_assets, _streamer, "json/level1.json");
                 _gameplay.dispose();
-                _settings.setMusicVolume(_saveFile->getFloat("musicVolume"));
-                _settings.setEffectVolume(_saveFile->getFloat("effectVolume"));
+                _settings.setMusicVolume(_save->getMusicVolume());
+                _settings.setEffectVolume(_save->getEffectVolume());
                 std::shared_ptr<Sound> source = _assets->get<Sound>("ui");
                 AudioEngine::get()->getMusicQueue()->play(source, true, _settings.getMusicVolume());
             }
@@ -197,14 +188,14 @@ void LumiaApp::update(float timestep) {
                 _mainMenu.dispose();
                 string nextScene = _mainMenu.getNextScene();
                 // if tutorial is not completed, show cutscene
-                if (!_saveFile->get("level_saves")->get(0)->getBool("completed")) {
+                if (!_save->getLevel(0).completed) {
                     _scene = Prologue;
                     _cutscene.init(_assets, "prologue");
                     _cutscene.setActive(true);
                 } else if (nextScene ==  "levelselect"){
                     _scene = LevelSelect;
-                    _levelSelect.init(_assets, _saveFile);
-                    _levelSelect.setActive(true, _saveFile);
+                    _levelSelect.init(_assets, _save, _streamer);
+                    _levelSelect.setActive(true, _save);
                 }
             }
             return;
@@ -218,8 +209,8 @@ void LumiaApp::update(float timestep) {
                 string nextScene = _cutscene.getNextScene();
                 if (nextScene == "levelselect") {
                     _scene = LevelSelect;
-                    _levelSelect.init(_assets, _saveFile);
-                    _levelSelect.setActive(true, _saveFile);
+                    _levelSelect.init(_assets, _save, _streamer);
+                    _levelSelect.setActive(true, _save);
                 }
             }
             return;
@@ -242,11 +233,11 @@ void LumiaApp::update(float timestep) {
             if (_levelSelect.isActive()){
                 _levelSelect.update(timestep);
             } else {
-                _levelSelect.setActive(false, _saveFile);
+                _levelSelect.setActive(false, _save);
                 string nextScene = _levelSelect.getNextScene();
                 if (nextScene == "game"){
                     _scene = Game;
-                    _gameplay.init(_assets, _levelSelect.getSelectedLevel());
+                    _gameplay.init(_assets, _streamer, _levelSelect.getSelectedLevel());
                     _gameplay.setMusicVolume(_settings.getMusicVolume());
                     _gameplay.setEffectVolume(_settings.getEffectVolume());
                     _gameplay.setActive(true);
@@ -254,8 +245,8 @@ void LumiaApp::update(float timestep) {
                     _scene = Settings;
                     _settings.setNextScene("levelselect");
                     _settings.setActive(true);
-                    _settings.setMusicVolume(_saveFile->getFloat("musicVolume"));
-                    _settings.setEffectVolume(_saveFile->getFloat("effectVolume"));
+                    _settings.setMusicVolume(_save->getMusicVolume());
+                    _settings.setEffectVolume(_save->getEffectVolume());
                 }
             }
             return;
@@ -284,25 +275,7 @@ void LumiaApp::update(float timestep) {
                     string levelFile = _gameplay.getCurrentLevel();
 
                     // update save file after completing a level
-                    std::shared_ptr<cugl::JsonValue> levels = _saveFile->get("level_saves");
-                    for (int i = 0; i < levels->size(); i++) {
-                        std::shared_ptr<cugl::JsonValue> level = levels->get(i);
-                        if (level->getString("path") == levelFile) {
-                            level->get("unlocked")->set(true);
-                            level->get("completed")->set(true);
-                            // only save highscores
-                            if (level->getInt("score") < _gameplay.getRemainingSize()) {
-                                level->get("stars")->set((double)_gameplay.getStars());
-                                level->get("score")->set((double)_gameplay.getRemainingSize());
-                            }
-                            
-                            if (i < levels->size() - 1) {
-                                std::shared_ptr<cugl::JsonValue> nextLevel = levels->get(i + 1);
-                                nextLevel->get("unlocked")->set(true);
-                            }
-                            break;
-                        }
-                    }
+                    _save->completeLevel(levelFile, _gameplay.getStars(), _gameplay.getRemainingSize());
 
                     if (levelFile.find("level") != string::npos) {
                         int startIdx = levelFile.find("level") + 5;
@@ -323,6 +296,12 @@ void LumiaApp::update(float timestep) {
                             _win.setActive(true);
                         }*/
                         _win.setActive(true);
+
+                        // continuing is the most likely choice, so build the next level now
+                        size_t next = stoi(levelNumber);
+                        if (next < _save->getLevelCount()) {
+                            _streamer->request(_save->getLevel(next).path, LevelStreamer::LIKELY);
+                        }
                     }
                 }
             }
@@ -346,7 +325,7 @@ void LumiaApp::update(float timestep) {
                 } else if (nextScene == "levelselect") {
                     _gameplay.dispose();
                     _scene = LevelSelect;
-                    _levelSelect.setActive(true, _saveFile);
+                    _levelSelect.setActive(true, _save);
                     std::shared_ptr<Sound> source = _assets->get<Sound>("ui");
                     AudioEngine::get()->getMusicQueue()->play(source, true, _settings.getMusicVolume());
                 } else if (nextScene == "settings") {
@@ -375,11 +354,11 @@ void LumiaApp::update(float timestep) {
                         // TODO: update this with eventual number of levels in the game
                         if (levelNumber == "18") {
                             _scene = LevelSelect;
-                            _levelSelect.setActive(true, _saveFile);
+                            _levelSelect.setActive(true, _save);
                             std::shared_ptr<Sound> source = _assets->get<Sound>("ui");
                             AudioEngine::get()->getMusicQueue()->play(source, true, _settings.getMusicVolume());
                         } else {
-                            _gameplay.init(_assets, "json/level" + levelNumber + ".json");
+                            _gameplay.init(_assets, _streamer, "json/level" + levelNumber + ".json");
                         }
                     }
                     _gameplay.setMusicVolume(_settings.getMusicVolume());
@@ -393,7 +372,7 @@ void LumiaApp::update(float timestep) {
                 } else if (nextScene == "levelselect") {
                     _gameplay.dispose();
                     _scene = LevelSelect;
-                    _levelSelect.setActive(true, _saveFile);
+                    _levelSelect.setActive(true, _save);
                     std::shared_ptr<Sound> source = _assets->get<Sound>("ui");
                     AudioEngine::get()->getMusicQueue()->play(source, true, _settings.getMusicVolume());
                 } else if (nextScene == "settings") {
@@ -408,8 +387,7 @@ void LumiaApp::update(float timestep) {
             if (_settings.isActive()){
                 _settings.update(timestep);
             } else {
-                _saveFile->get("musicVolume")->set(_settings.getMusicVolume());
-                _saveFile->get("effectVolume")->set(_settings.getEffectVolume());
+                _save->setVolumes(_settings.getMusicVolume(), _settings.getEffectVolume());
                 _settings.setActive(false);
                 _gameplay.setMusicVolume(_settings.getMusicVolume());
                 _gameplay.setEffectVolume(_settings.getEffectVolume());
@@ -418,7 +396,7 @@ void LumiaApp::update(float timestep) {
                     std::shared_ptr<Sound> source = _assets->get<Sound>("ui");
                     AudioEngine::get()->getMusicQueue()->play(source, true, _settings.getMusicVolume());
                     _scene = LevelSelect;
-                    _levelSelect.setActive(true, _saveFile);
+                    _levelSelect.setActive(true, _save);
                 } else if (nextScene == "pause") {
                     std::shared_ptr<Sound> source = _assets->get<Sound>("game");
                     AudioEngine::get()->getMusicQueue()->play(source, true, _settings.getMusicVolume());
@@ -16,6 +16,8 @@
 #include "WinScene.h"
 #include "Cutscene.h"
 #include "InputController.h"
+#include "SaveController.h"
+#include "LevelStreamer.h"
 
 /**
  * This class represents the application root for the platform demo.
@@ -61,7 +63,10 @@ protected:
     /** The current scene of the game*/
     CurrentScene _scene;
 
-    std::shared_ptr<cugl::JsonValue> _saveFile;
+    /** The save state, written to disk in the background */
+    std::shared_ptr<SaveController> _save;
+    /** The service building levels before they are played */
+    std::shared_ptr<LevelStreamer> _streamer;
     
 public:
 #pragma mark Constructors
@@ -9,6 +9,10 @@
 #include <cugl/scene2/graph/CUPolygonNode.h>
 #include <cugl/scene2/graph/CUTexturedNode.h>
 #include <cugl/assets/CUAssetManager.h>
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Collision/b2Collision.h>
+#include <Box2D/Collision/b2Distance.h>
 
 
 using namespace cugl;
@@ -88,52 +92,50 @@ bool LumiaModel::init(const cugl::Vec2& pos, float radius, float scale) {
 /**
  * Create new fixtures for this body, defining the shape
  *
- * This is the primary method to override for custom physics objects
+ * Lumia used to carry a launch sensor of radius+LUMIA_LAUNCH_MARGIN, at a
+ * fraction of the body density. The body keeps the mass and rotational
+ * inertia of that sensor, so that launches and rolling are tuned as before.
  */
 void LumiaModel::createFixtures() {
     if (_body == nullptr) {
         return;
     }
-    
-    WheelObstacle::createFixtures();
-    b2FixtureDef sensorDef;
-    sensorDef.density = LumiaModel::sizeLevels[_sizeLevel].density * 0.40f;
-    sensorDef.isSensor = true;
-
-    b2CircleShape sensorShape;
-    sensorShape.m_radius = _radius + 0.6f;
-
-    sensorDef.shape = &sensorShape;
-    _sensorFixture = _body->CreateFixture(&sensorDef);
-    _sensorFixture->SetUserData(getLaunchSensorName());
-    
-    b2FixtureDef sensorDef2;
-    sensorDef2.density = 0;
-    sensorDef2.isSensor = true;
 
-    b2CircleShape sensorShape2;
-    sensorShape2.m_radius = _radius + 0.08f;
+    WheelObstacle::createFixtures();
+    resetLaunchMass();
+}
 
-    sensorDef2.shape = &sensorShape2;
-    _sensorFixture2 = _body->CreateFixture(&sensorDef2);
-    _sensorFixture2->SetUserData(getFrictionSensorName());
+/**
+ * Sets the density of this body
+ *
+ * The mass and rotational inertia still include the old launch sensor.
+ *
+ * @param value  the density of this body
+ */
+void LumiaModel::setDensity(float value) {
+    WheelObstacle::setDensity(value);
+    resetLaunchMass();
 }
 
 /**
- * Release the fixtures for this body, reseting the shape
+ * Sets the mass data of the body to include the old launch sensor
  *
- * This is the primary method to override for custom physics objects.
+ * The sensor was a disk of radius+LUMIA_LAUNCH_MARGIN at LUMIA_MARGIN_DENSITY
+ * times the body density. Both disks are centered on the body.
  */
-void LumiaModel::releaseFixtures() {
-    if (_body != nullptr) {
-        WheelObstacle::releaseFixtures();
+void LumiaModel::resetLaunchMass() {
+    if (_body == nullptr) {
         return;
     }
-    WheelObstacle::releaseFixtures();
-    if (_sensorFixture != nullptr) {
-        _body->DestroyFixture(_sensorFixture);
-        _sensorFixture = nullptr;
-    }
+
+    float outer = _radius+LUMIA_LAUNCH_MARGIN;
+    float inner = _fixture.density*M_PI*_radius*_radius;
+    float shell = _fixture.density*LUMIA_MARGIN_DENSITY*M_PI*outer*outer;
+    b2MassData mass;
+    mass.mass = inner+shell;
+    mass.center.SetZero();
+    mass.I = 0.5f*inner*_radius*_radius+0.5f*shell*outer*outer;
+    _body->SetMassData(&mass);
 }
 
 /**
@@ -144,8 +146,6 @@ void LumiaModel::releaseFixtures() {
  */
 void LumiaModel::dispose() {
     _sceneNode = nullptr;
-    _sensorNode = nullptr;
-    _sensorNode2 = nullptr;
 }
 
 /**
@@ -163,14 +163,8 @@ void LumiaModel::applyForce() {
         setAngularVelocity(0.0f);
         b2Vec2 force(_stickDirection.x, _stickDirection.y);
         _body->ApplyLinearImpulse(force, _body->GetPosition(), true);
-    } else if ((isOnStickyWall() || isOnButton()) && isLaunching()){
-        unStick();
-    }
-    // If Lumia is on the ground, and Lumia is being launched, apply velocity impulse to body
-    if (isLaunching() && isGrounded()) {
-        b2Vec2 force(getVelocity().x, getVelocity().y);
-        _body->ApplyLinearImpulse(force, _body->GetPosition(), true);
     }
+    // The launch impulse itself is applied by applyLaunch
     if (!isLaunching() && isRolling()) {
         // When Lumia is not being launched (i.e. has landed), want to apply friction to slow X velocity
         b2Vec2 forceX(-getDamping() * getVX(), 0);
@@ -201,39 +195,233 @@ void LumiaModel::update(float dt) {
 }
 
 
-#pragma mark -
-#pragma mark Scene Graph Methods
 /**
- * Redraws the outline of the physics fixtures to the debug node
+ * Returns the distance between the surfaces of two shapes
+ *
+ * The normal is set to the direction from the second shape to the first.
+ * If the center of the first shape is inside the second, the normal is zero.
  *
- * The debug node is use to outline the fixtures attached to this object.
- * This is very useful when the fixtures have a very different shape than
- * the texture (e.g. a circular shape attached to a square texture).
+ * @param shapeA    The first shape
+ * @param childA    The child index of the first shape
+ * @param xfA       The transform of the first shape
+ * @param shapeB    The second shape
+ * @param childB    The child index of the second shape
+ * @param xfB       The transform of the second shape
+ * @param normal    The vector to store the normal
+ *
+ * @return the distance between the surfaces of two shapes
  */
-void LumiaModel::resetDebug() {
-    WheelObstacle::resetDebug();
-
-    PolyFactory factory;
-    factory.setSegments(12);
-    factory.setGeometry(Geometry::PATH);
-    Poly2 poly = factory.makeCircle(Vec2::ZERO,0.6f+getRadius());
-
-    _sensorNode = scene2::WireNode::allocWithTraversal(poly, poly2::Traversal::CLOSED);
-    _sensorNode->setColor(Color4f::RED);
-    auto size = _debug->getContentSize();
-    _sensorNode->setPosition(Vec2(size.width/2.0f, size.height/2.0f));
-    _debug->addChild(_sensorNode);
-    
-    Poly2 poly2 = factory.makeCircle(Vec2::ZERO,0.08f+getRadius());
-    _sensorNode2 = scene2::WireNode::allocWithTraversal(poly, poly2::Traversal::CLOSED);
-    _sensorNode2->setColor(Color4f::RED);
-    size = _debug->getContentSize();
-    _sensorNode2->setPosition(Vec2(size.width/2.0f, size.height/2.0f));
-    _debug->addChild(_sensorNode2);
+static float surfaceDistance(const b2Shape* shapeA, int32 childA, const b2Transform& xfA,
+                             const b2Shape* shapeB, int32 childB, const b2Transform& xfB,
+                             b2Vec2& normal) {
+    b2DistanceInput input;
+    input.proxyA.Set(shapeA, childA);
+    input.proxyB.Set(shapeB, childB);
+    input.transformA = xfA;
+    input.transformB = xfB;
+    input.useRadii = false;
+
+    b2SimplexCache cache;
+    cache.count = 0;
+    b2DistanceOutput output;
+    b2Distance(&output, &cache, &input);
+
+    normal.SetZero();
+    if (output.distance > b2_epsilon) {
+        normal = output.pointA-output.pointB;
+        normal *= 1.0f/output.distance;
+    }
+    return output.distance-input.proxyA.m_radius-input.proxyB.m_radius;
+}
+
+/**
+ * Updates the grounded, rolling and button state from the body contacts.
+ *
+ * This should be called after every physics step. Lumia is rolling if it
+ * touches anything but a door. It is grounded if it touches a sticky wall,
+ * or a solid surface whose normal (pointing away from that surface, toward
+ * Lumia) is within the ground slope of straight up. Walls and ceilings do
+ * not ground Lumia.
+ *
+ * A button is held down while Lumia is within LUMIA_BUTTON_MARGIN of it.
+ * The broadphase pads each body by more than this margin, so every button
+ * that close is already in the contact list, even if it is not touching.
+ */
+void LumiaModel::updateContacts() {
+    _isGrounded = false;
+    _isRolling = false;
+    _buttonsPressed.clear();
+    _buttonsReleased.clear();
+    _buttonsNearby.clear();
+
+    if (_body != nullptr && !isRemoved()) {
+        b2Vec2 up = -_body->GetWorld()->GetGravity();
+        up.Normalize();
+
+        for (b2ContactEdge* edge = _body->GetContactList(); edge; edge = edge->next) {
+            b2Contact* contact = edge->contact;
+            bool first = (contact->GetFixtureA()->GetBody() == _body);
+            const b2Fixture* mine  = (first ? contact->GetFixtureA() : contact->GetFixtureB());
+            const b2Fixture* other = (first ? contact->GetFixtureB() : contact->GetFixtureA());
+            physics2::Obstacle* obj = (physics2::Obstacle*)edge->other->GetUserData();
+
+            if (obj != nullptr && obj->getName() == "button") {
+                b2Vec2 normal;
+                int32 child = (first ? contact->GetChildIndexB() : contact->GetChildIndexA());
+                float gap = surfaceDistance(mine->GetShape(), 0, _body->GetTransform(),
+                                            other->GetShape(), child, edge->other->GetTransform(),
+                                            normal);
+                if (gap <= LUMIA_BUTTON_MARGIN) {
+                    _buttonsNearby.push_back(obj);
+                }
+            }
+
+            if (!contact->IsTouching()) {
+                continue;
+            }
+            if (obj == nullptr || obj->getName().compare(0, 4, "door") != 0) {
+                _isRolling = true;
+            }
+            if (other->IsSensor() || mine->IsSensor()) {
+                // Sensors have no manifold; Lumia clings to sticky walls
+                if (obj != nullptr && obj->getName() == "STICKY_WALL") {
+                    _isGrounded = true;
+                }
+            } else if (contact->GetManifold()->pointCount > 0) {
+                // The manifold normal points from fixture A to fixture B
+                b2WorldManifold manifold;
+                contact->GetWorldManifold(&manifold);
+                b2Vec2 normal = (first ? -manifold.normal : manifold.normal);
+                if (b2Dot(normal, up) >= LUMIA_GROUND_SLOPE) {
+                    _isGrounded = true;
+                }
+            }
+        }
+    }
+
+    for (physics2::Obstacle* button : _buttonsNearby) {
+        if (std::find(_buttons.begin(), _buttons.end(), button) == _buttons.end()) {
+            _buttonsPressed.push_back(button);
+        }
+    }
+    for (physics2::Obstacle* button : _buttons) {
+        if (std::find(_buttonsNearby.begin(), _buttonsNearby.end(), button) == _buttonsNearby.end()) {
+            _buttonsReleased.push_back(button);
+        }
+    }
+    std::swap(_buttons, _buttonsNearby);
 }
 
+/**
+ * Callback to find the first ground fixture within the launch margin
+ */
+class LaunchMarginQuery : public b2QueryCallback {
+public:
+    /** The circle of the Lumia body */
+    b2CircleShape circle;
+    /** The transform of the circle */
+    b2Transform transform;
+    /** The direction opposite gravity */
+    b2Vec2 up;
+    /** The distance from the circle to search */
+    float margin;
+    /** The smallest dot product of a ground normal with up */
+    float slope;
+    /** The body to ignore */
+    const b2Body* self;
+    /** Whether a ground fixture is within the margin */
+    bool found;
 
+    /**
+     * Returns false (ending the query) if the fixture is ground within the margin
+     *
+     * Sensors are skipped, as are surfaces that face sideways or down.
+     *
+     * @param fixture   The fixture with a bounding box overlapping the query
+     *
+     * @return false if the fixture is ground within the margin
+     */
+    bool ReportFixture(b2Fixture* fixture) override {
+        if (fixture->GetBody() == self || fixture->IsSensor()) {
+            return true;
+        }
+        const b2Shape* shape = fixture->GetShape();
+        const b2Transform& xf = fixture->GetBody()->GetTransform();
+        for (int32 ii = 0; ii < shape->GetChildCount(); ii++) {
+            b2Vec2 normal;
+            float gap = surfaceDistance(&circle, 0, transform, shape, ii, xf, normal);
+            if (gap <= margin && b2Dot(normal, up) >= slope) {
+                found = true;
+                return false;
+            }
+        }
+        return true;
+    }
+};
 
+/**
+ * Returns true if there is ground within the launch margin.
+ *
+ * This is a one-shot query of a circle of radius+LUMIA_LAUNCH_MARGIN
+ * against the world. Only surfaces within the ground slope count, as in
+ * {@link updateContacts}. It is more expensive than updateContacts, so it
+ * should only be called when a launch is possible.
+ *
+ * @return true if there is ground within the launch margin.
+ */
+bool LumiaModel::isInLaunchMargin() const {
+    if (_body == nullptr || isRemoved()) {
+        return false;
+    }
+
+    LaunchMarginQuery query;
+    query.circle.m_radius = _radius;
+    query.transform = _body->GetTransform();
+    query.up = -_body->GetWorld()->GetGravity();
+    query.up.Normalize();
+    query.margin = LUMIA_LAUNCH_MARGIN;
+    query.slope = LUMIA_GROUND_SLOPE;
+    query.self = _body;
+    query.found = false;
+
+    b2CircleShape probe;
+    probe.m_radius = _radius+LUMIA_LAUNCH_MARGIN;
+    b2AABB box;
+    probe.ComputeAABB(&box, query.transform, 0);
+    _body->GetWorld()->QueryAABB(&query, box);
+    return query.found;
+}
+
+#pragma mark -
+#pragma mark Scene Graph Methods
 void LumiaModel::setDrawScale(float scale){
     _drawScale = scale;
 }
+
+/**
+ * Applies the launch impulse to the body of this Lumia
+ *
+ * This is separate from {@link applyForce()} so that the impulse can be
+ * applied part way through a physics step, at the moment the player
+ * actually released. It does nothing if this Lumia is not launching.
+ */
+void LumiaModel::applyLaunch() {
+    if (!isActive() || !isLaunching()) {
+        return;
+    }
+
+    if (isOnStickyWall() || isOnButton()) {
+        unStick();
+    }
+    // If Lumia is on the ground, and Lumia is being launched, apply velocity impulse to body
+    if (isGrounded()) {
+        b2Vec2 force(getVelocity().x, getVelocity().y);
+        _body->ApplyLinearImpulse(force, _body->GetPosition(), true);
+    }
+
+    // put a cap on maximum velocity Lumia can have
+    if (getLinearVelocity().lengthSquared() >= pow(getMaxVelocity(), 2)) {
+        Vec2 vel = getLinearVelocity().normalize().scale(getMaxVelocity());
+        setLinearVelocity(vel);
+    }
+}
@@ -13,6 +13,7 @@
 #include <cugl/physics2/CUCapsuleObstacle.h>
 #include <cugl/scene2/graph/CUWireNode.h>
 #include "LumiaNode.h"
+#include "EventQueue.h"
 
 #pragma mark Lumia Model
 /**
@@ -22,7 +23,7 @@
 * experience, using a rectangular shape for a character will regularly snag
 * on a platform.  The round shapes on the end caps lead to smoother movement.
 */
-class LumiaModel : public cugl::physics2::WheelObstacle {
+class LumiaModel : public cugl::physics2::WheelObstacle, public std::enable_shared_from_this<LumiaModel> {
 #pragma mark Constants and Enums
 protected:
     #define SIGNUM(x)  ((x > 0) - (x < 0))
@@ -40,6 +41,14 @@ protected:
     static constexpr float LUMIA_DAMPING = 3.0f;
     /** The maximum character speed */
     static constexpr float LUMIA_MAXVELOCITY = 20.0f;
+    /** How far Lumia may be from a surface and still launch */
+    static constexpr float LUMIA_LAUNCH_MARGIN = 0.6f;
+    /** How far Lumia may be from a button and still hold it down */
+    static constexpr float LUMIA_BUTTON_MARGIN = 0.08f;
+    /** The smallest upward component of a ground normal (slopes up to 60 degrees) */
+    static constexpr float LUMIA_GROUND_SLOPE = 0.5f;
+    /** The relative density of the disk of radius+LUMIA_LAUNCH_MARGIN included in the mass */
+    static constexpr float LUMIA_MARGIN_DENSITY = 0.40f;
 
 public:
     enum LumiaState {
@@ -80,23 +89,12 @@ protected:
     bool _inCoolDown;
     /* Whether or not the Lumia body is due to be or has been removed */
     bool _removed;
+    /** The handle of this Lumia in the collision event queues */
+    EventHandle _eventHandle;
     
     bool _dying;
     /** Radius of Lumia's body */
     float _radius;
-	/** Ground sensor to represent our feet */
-	b2Fixture*  _sensorFixture;
-    /** Ground sensor to represent our feet */
-    b2Fixture*  _sensorFixture2;
-	/** Reference to the sensor name (since a constant cannot have a pointer) */
-	std::string _launchSensorName;
-    /** Reference to the sensor name (since a constant cannot have a pointer) */
-    std::string _frictionSensorName;
-	/** The node for debugging the sensor */
-	std::shared_ptr<cugl::scene2::WireNode> _sensorNode;
-    
-    /** The node for debugging the sensor */
-    std::shared_ptr<cugl::scene2::WireNode> _sensorNode2;
 	/** The scene graph node for Lumia. */
 	std::shared_ptr<LumiaNode> _sceneNode;
     
@@ -111,15 +109,6 @@ protected:
     /** The current size level of this Lumia body */
     int _sizeLevel;
 
-	/**
-	* Redraws the outline of the physics fixtures to the debug node
-	*
-	* The debug node is use to outline the fixtures attached to this object.
-	* This is very useful when the fixtures have a very different shape than
-	* the texture (e.g. a circular shape attached to a square texture).
-	*/
-	virtual void resetDebug() override;
-    
     bool _isOnStickyWall;
     
     bool _isRolling;
@@ -128,6 +117,15 @@ protected:
     
     bool _isOnButton;
 
+    /** The buttons within the button margin after the last physics step */
+    std::vector<cugl::physics2::Obstacle*> _buttons;
+    /** The buttons that came within the margin in the last physics step */
+    std::vector<cugl::physics2::Obstacle*> _buttonsPressed;
+    /** The buttons that left the margin in the last physics step */
+    std::vector<cugl::physics2::Obstacle*> _buttonsReleased;
+    /** Scratch space for the buttons within the margin */
+    std::vector<cugl::physics2::Obstacle*> _buttonsNearby;
+
 public:
     
 #pragma mark Hidden Constructors
@@ -544,41 +542,88 @@ public:
     float getMaxVelocity() const { return LUMIA_MAXVELOCITY; }
     
     /**
-     * Returns the name of the ground sensor
+     * Updates the grounded, rolling and button state from the body contacts.
+     *
+     * This should be called after every physics step. Lumia is rolling if it
+     * touches anything but a door. It is grounded if it touches a sticky wall,
+     * or a solid surface whose normal is within LUMIA_GROUND_SLOPE of straight
+     * up. A button is held down while Lumia is within LUMIA_BUTTON_MARGIN of
+     * it. All of these come from the body contact list, so Lumia needs no
+     * sensor fixtures.
+     */
+    void updateContacts();
+
+    /**
+     * Returns true if there is ground within the launch margin.
      *
-     * This is used by ContactListener
+     * This is a one-shot query of a circle of radius+LUMIA_LAUNCH_MARGIN
+     * against the world. Only surfaces within the ground slope count. It is
+     * more expensive than {@link updateContacts}, so it should only be called
+     * when a launch is possible.
      *
-     * @return the name of the ground sensor
+     * @return true if there is ground within the launch margin.
      */
-    std::string* getLaunchSensorName() { return &_launchSensorName; }
-    
-    std::string* getFrictionSensorName() { return &_frictionSensorName; }
-    
+    bool isInLaunchMargin() const;
+
+    /**
+     * Returns the buttons that came within the button margin in the last step
+     *
+     * @return the buttons that came within the button margin in the last step
+     */
+    const std::vector<cugl::physics2::Obstacle*>& getButtonsPressed() const {
+        return _buttonsPressed;
+    }
+
+    /**
+     * Returns the buttons that left the button margin in the last step
+     *
+     * A Lumia that has been removed leaves every button.
+     *
+     * @return the buttons that left the button margin in the last step
+     */
+    const std::vector<cugl::physics2::Obstacle*>& getButtonsReleased() const {
+        return _buttonsReleased;
+    }
+
     void setRemoved(bool value) { _removed = value; }
 
     /* Returns whether or not this energy item is due to be or has been removed */
     bool getRemoved() { return _removed; }
 
+    /** Returns the handle of this Lumia in the collision event queues */
+    EventHandle getEventHandle() const { return _eventHandle; }
+
+    /** Sets the handle of this Lumia in the collision event queues */
+    void setEventHandle(EventHandle handle) { _eventHandle = handle; }
+
     
 #pragma mark -
 #pragma mark Physics Methods
     /**
-     * Creates the physics Body(s) for this object, adding them to the world.
+     * Create new fixtures for this body, defining the shape
      *
-     * This method overrides the base method to keep your ship from spinning.
+     * Lumia used to carry a launch sensor of radius+LUMIA_LAUNCH_MARGIN, at a
+     * fraction of the body density. The body keeps the mass and rotational
+     * inertia of that sensor, so that launches and rolling are tuned as before.
+     */
+    void createFixtures() override;
+    
+    /**
+     * Sets the density of this body
      *
-     * @param world Box2D world to store body
+     * The mass and rotational inertia still include the old launch sensor.
      *
-     * @return true if object allocation succeeded
+     * @param value  the density of this body
      */
-    void createFixtures() override;
+    void setDensity(float value) override;
     
     /**
-     * Release the fixtures for this body, reseting the shape
+     * Sets the mass data of the body to include the old launch sensor
      *
-     * This is the primary method to override for custom physics objects.
+     * The sensor was a disk of radius+LUMIA_LAUNCH_MARGIN at LUMIA_MARGIN_DENSITY
+     * times the body density. Both disks are centered on the body.
      */
-    void releaseFixtures() override;
+    void resetLaunchMass();
     
     /**
      * Updates the object's physics state (NOT GAME LOGIC).
@@ -595,6 +640,15 @@ public:
      * This method should be called after the force attribute is set.
      */
     void applyForce();
+
+    /**
+     * Applies the launch impulse to the body of this Lumia
+     *
+     * This is separate from {@link applyForce()} so that the impulse can be
+     * applied part way through a physics step, at the moment the player
+     * actually released. It does nothing if this Lumia is not launching.
+     */
+    void applyLaunch();
 };
 
 #endif /* __LUMIA_MODEL_H__ */
@@ -14,6 +14,7 @@ void LumiaNode::dispose(){
     _idleAnimation = nullptr;
     _splittingAnimation = nullptr;
     _deathAnimation = nullptr;
+    _indicatorNode = nullptr;
 }
 
 bool LumiaNode::setTextures(const std::shared_ptr<cugl::Texture> &idleAnimation,
@@ -37,19 +38,12 @@ bool LumiaNode::setTextures(const std::shared_ptr<cugl::Texture> &idleAnimation,
     Vec2 center = Vec2(splittingAnimation->getWidth()/5.0f/2.0f,splittingAnimation->getHeight()/4.0f/2.0f);
     float r = idleAnimation->getHeight()/4.0f/2.0f * 0.9f;
     
+    _indicatorNode = cugl::scene2::InstanceNode::allocWithTexture(indicator);
     for (int i=0; i<= _level; i++){
-        std::shared_ptr<cugl::scene2::PolygonNode> ind = cugl::scene2::PolygonNode::allocWithTexture(indicator);
-        ind->setAnchor(Vec2::ANCHOR_CENTER);
         float ang = angle * i;
-        ind->setPosition(center.x + r*cos(1.57 - ang), center.y + r*sin(1.57 - ang));
-        
-        _indicatorNode.push_back(ind);
-    }
-    
-    for (auto node : _indicatorNode){
-        node->setScale(0.4f);
-        addChild(node);
+        _indicatorNode->addInstance(Vec2(center.x + r*cos(1.57 - ang), center.y + r*sin(1.57 - ang)), 0.4f);
     }
+    addChild(_indicatorNode);
     
     _splittingAnimation = cugl::scene2::AnimationNode::alloc(splittingAnimation, ANIMATION_ROWS, ANIMATION_COLS, ANIMATION_SIZE);
     _splittingAnimation->setAnchor(Vec2::ANCHOR_CENTER);
@@ -73,6 +67,13 @@ void LumiaNode::setLevel(int level){
     _level = level;
 }
 
+void LumiaNode::setClock(const std::shared_ptr<cugl::scene2::AnimationClock>& clock){
+    _idleAnimation->setClock(clock);
+    _splittingAnimation->setClock(clock);
+    _deathAnimation->setClock(clock);
+    applyAnimState();
+}
+
 void LumiaNode::setAnimState(LumiaAnimState state){
     switch (state){
         case Splitting:
@@ -80,9 +81,7 @@ void LumiaNode::setAnimState(LumiaAnimState state){
             _splittingAnimation->setVisible(true);
             _idleAnimation->setVisible(false);
             _deathAnimation->setVisible(false);
-            for (auto node : _indicatorNode){
-                node->setVisible(false);
-            }
+            _indicatorNode->setVisible(false);
             break;
         }
         case Dead:
@@ -90,67 +89,62 @@ void LumiaNode::setAnimState(LumiaAnimState state){
             _splittingAnimation->setVisible(false);
             _idleAnimation->setVisible(false);
             _deathAnimation->setVisible(true);
-            for (auto node : _indicatorNode){
-                node->setVisible(false);
-            }
+            _indicatorNode->setVisible(false);
             break;
         }
         default:{
             _splittingAnimation->setVisible(false);
             _idleAnimation->setVisible(true);
             _deathAnimation->setVisible(false);
-            for (auto node : _indicatorNode){
-                node->setVisible(true);
-            }
+            _indicatorNode->setVisible(true);
             break;
         }
     }
-    _state = state;
-
+    if (_state != state){
+        _state = state;
+        applyAnimState();
+    }
 }
 
-void LumiaNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
+void LumiaNode::applyAnimState(){
+    if (_idleAnimation == nullptr || _idleAnimation->getClock() == nullptr){
+        return;
+    }
     
+    _idleAnimation->stop();
+    _splittingAnimation->stop();
+    _deathAnimation->stop();
     switch (_state){
         case Idle:{
-            _frameCount %= IDLE_ANIMATION_INTERVAL;
-            if (_frameCount == 0){
-                int frame = _idleAnimation->getFrame() + 1 >= ANIMATION_SIZE ? 0 : _idleAnimation->getFrame() + 1 ;
-                _idleAnimation->setFrame(frame);
-            }
-            
+            _idleAnimation->play(0, ANIMATION_SIZE - 1, IDLE_ANIMATION_INTERVAL);
             break;
         }
         case Splitting:{
-            _frameCount %= SPLIT_ANIMATION_INTERVAL;
-            
-            if (_frameCount == 0){
-                int frame = _splittingAnimation->getFrame() + 1;
-                _splittingAnimation->setFrame(frame);
-                if (frame == ANIMATION_SIZE - 1){
-                    setAnimState(LumiaAnimState::SplitFinished);
-                }
-            }
+            _splittingAnimation->play(0, ANIMATION_SIZE - 1, SPLIT_ANIMATION_INTERVAL,
+                                      cugl::scene2::AnimationClock::Mode::ONCE);
             break;
         }
         case Dying:{
-            _frameCount %= DEATH_ANIMATION_INTERVAL;
-            
-            if (_frameCount == 0){
-                int frame = _deathAnimation->getFrame() + 1;
-                _deathAnimation->setFrame(frame);
-                if (frame == ANIMATION_SIZE - 1){
-                    setAnimState(LumiaAnimState::Dead);
-                }
-            }
+            _deathAnimation->play(0, ANIMATION_SIZE - 1, DEATH_ANIMATION_INTERVAL,
+                                  cugl::scene2::AnimationClock::Mode::ONCE);
             break;
         }
         default:{
             break;
         }
     }
-    _frameCount++;
+}
+
+void LumiaNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Mat4& transform, cugl::Color4) {
+    
+    // The one-shot animations hand over on their last frame
+    int frame = (_state == Splitting ? _splittingAnimation->getFrame() : _deathAnimation->getFrame());
+    if (_state == Splitting && frame == ANIMATION_SIZE - 1){
+        setAnimState(LumiaAnimState::SplitFinished);
+    } else if (_state == Dying && frame == ANIMATION_SIZE - 1){
+        setAnimState(LumiaAnimState::Dead);
+    }
     SceneNode::draw(batch, transform, Color4f::WHITE);
 //    if (useParentTint){
 //    SceneNode::draw(batch, transform, tint);
@@ -36,8 +36,6 @@ protected:
     bool useParentTint = true;
     LumiaAnimState _state;
     
-    int _frameCount;
-    
     int _level;
     
     const int IDLE_ANIMATION_INTERVAL = 10;
@@ -58,13 +56,16 @@ protected:
     
     std::shared_ptr<cugl::scene2::AnimationNode> _deathAnimation;
     
-    std::vector<std::shared_ptr<cugl::scene2::PolygonNode>> _indicatorNode;
+    std::shared_ptr<cugl::scene2::InstanceNode> _indicatorNode;
+    
+    /** Configures the animation clock for the current state */
+    void applyAnimState();
 
 public:
     
     cugl::Color4 _stint;
     
-    LumiaNode() : _state(Idle), _frameCount(0), SceneNode() {}
+    LumiaNode() : _state(Idle), SceneNode() {}
 
     ~LumiaNode() { dispose(); }
     
@@ -85,6 +86,15 @@ public:
     
     void setLevel(int level);
     
+    /**
+     * Sets the clock advancing the animations of this node.
+     *
+     * This must be called after {@link setTextures}.
+     *
+     * @param clock The clock advancing the animations (may be null)
+     */
+    void setClock(const std::shared_ptr<cugl::scene2::AnimationClock>& clock);
+    
     void setAnimState(LumiaAnimState state);
     
     LumiaAnimState getAnimState(){
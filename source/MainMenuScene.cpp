@@ -41,7 +41,7 @@ bool MainMenuScene::init(const std::shared_ptr<AssetManager>& assets) {
     _assets = assets;
     auto layer = assets->get<scene2::SceneNode>("mainmenu");
     layer->setContentSize(dimen);
-    layer->doLayout(); // This rearranges the children to fit the screen
+    layer->updateLayout(); // This rearranges the children to fit the screen
     addChild(layer);
     
     _button = std::dynamic_pointer_cast<scene2::Button>(assets->get<scene2::SceneNode>("mainmenu_play"));
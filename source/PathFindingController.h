@@ -65,7 +65,7 @@ public:
     
     void  changeStateIfApplicable(EnemyModel* e);
     
-    void  update(float dt, std::list<std::shared_ptr<EnemyModel>>& _enemyList, std::list<std::shared_ptr<LumiaModel>>& _lumiaList);
+    void  update(float dt, std::vector<std::shared_ptr<EnemyModel>>& _enemyList, std::vector<std::shared_ptr<LumiaModel>>& _lumiaList);
 
     /**
      * Clears any buffered inputs so that we may start fresh.
@@ -87,6 +87,8 @@ public:
      */
     const std::shared_ptr<cugl::scene2::SceneNode>& getNode() const { return _node; }
     
+    const std::shared_ptr<PlantNode>& getPlantNode() const { return _plantNode; }
+    
     void setPlantNode(const std::shared_ptr<PlantNode>& node) {
         _plantNode = node;
         _node->addChild(_plantNode);
@@ -9,38 +9,57 @@
 #include <stdio.h>
 
 #include "PlantNode.h"
-void PlantNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
+/**
+ * Sets the clock advancing this animation, and resumes the current state.
+ *
+ * @param clock The clock advancing this animation (may be null)
+ */
+void PlantNode::setClock(const std::shared_ptr<scene2::AnimationClock>& clock) {
+    AnimationNode::setClock(clock);
+    applyAnimState();
+}
+
+/**
+ * Configures the animation clock for the current state
+ */
+void PlantNode::applyAnimState() {
     switch (_state){
         case Dark:{
+            stop();
             setFrame(0);
             break;
         }
         case LightingUp:{
-            _frameCount %= LIGHT_UP_ANIMATION_INTERVAL;
-            if (_frameCount == 0){
-                int frame = getFrame() + 1;
-                setFrame(frame);
-                if (frame == LIT_ANIMATION_END){
-                    setAnimState(PlantAnimState::Lit);
-                }
+            if (getClock() != nullptr) {
+                play(0, LIT_ANIMATION_END, LIGHT_UP_ANIMATION_INTERVAL, scene2::AnimationClock::Mode::ONCE);
             }
             break;
         }
         case Lit:{
-            _frameCount %= LIT_ANIMATION_INTERVAL;
-            if (_frameCount == 0){
-                int frame = getFrame() + (_frameIncreasing ? 1 : -1);
-                setFrame(frame);
-                if (frame == LIT_ANIMATION_END || frame == LIT_ANIMATION_START){
-                    _frameIncreasing = !_frameIncreasing;
-                }
+            if (getClock() != nullptr) {
+                play(LIT_ANIMATION_START, LIT_ANIMATION_END, LIT_ANIMATION_INTERVAL, scene2::AnimationClock::Mode::BOUNCE);
             }
             break;
         }
     }
-    _frameCount ++;
+}
+
+void PlantNode::advanceFrame() {
+    // The light up animation hands over to the lit loop on its last frame
+    int frame = getFrame();
+    if (_state == LightingUp && frame == LIT_ANIMATION_END){
+        setAnimState(PlantAnimState::Lit);
+    }
+}
+
+void PlantNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Mat4& transform, cugl::Color4 tint) {
+    advanceFrame();
     AnimationNode::draw(batch,transform,tint);
-    
 }
 
+void PlantNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    advanceFrame();
+    AnimationNode::draw(batch,transform,tint);
+}
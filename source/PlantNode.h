@@ -25,8 +25,6 @@ public:
 protected:
     PlantAnimState _state;
     
-    int _frameCount;
-    
     const int LIGHT_UP_ANIMATION_INTERVAL = 3;
     
     const int LIT_ANIMATION_INTERVAL = 17;
@@ -35,17 +33,21 @@ protected:
     
     const int LIT_ANIMATION_END = 9;
     
-    bool _frameIncreasing;
+    /** Configures the animation clock for the current state */
+    void applyAnimState();
     
 public:
     
     
-    PlantNode() : _state(Dark), _frameCount(0), _frameIncreasing(false), AnimationNode() {}
+    PlantNode() : _state(Dark), AnimationNode() {}
 
     ~PlantNode() { dispose(); }
     
     void setAnimState(PlantAnimState state){
-        _state = state;
+        if (_state != state) {
+            _state = state;
+            applyAnimState();
+        }
     }
     
     PlantAnimState getAnimState(){
@@ -58,9 +60,22 @@ public:
         return (node->initWithFilmstrip(texture,rows,cols,size) ? node : nullptr);
     }
 
+    /**
+     * Sets the clock advancing this animation, and resumes the current state.
+     *
+     * @param clock The clock advancing this animation (may be null)
+     */
+    void setClock(const std::shared_ptr<scene2::AnimationClock>& clock) override;
+
     void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
               const cugl::Mat4& transform, cugl::Color4 tint) override;
 
+    void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+              const cugl::Affine2& transform, cugl::Color4 tint) override;
+
+    /** Advances the animation frame (called once per draw) */
+    void advanceFrame();
+
 };
 
 #endif /* __PLANT_NODE_H__ */
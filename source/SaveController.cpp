@@ -0,0 +1,356 @@
+//
+//  SaveController.cpp
+//  Lumia
+//
+//  The save state of the game. The state is kept in memory as typed records,
+//  so the scenes never parse or search the save file. When the state changes,
+//  a snapshot is handed to a background thread, which writes it to a temporary
+//  file and then renames it over the save file. A process killed mid-write
+//  leaves the previous save intact. Bursts of changes are coalesced, so that
+//  only the newest snapshot is written.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#include "SaveController.h"
+#include <cstdio>
+#include <sstream>
+#if defined (_WIN32)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace cugl;
+
+/** The number of levels in a new save */
+#define DEFAULT_LEVELS 17
+/** The milliseconds to wait for more changes before writing a snapshot */
+#define COALESCE_DELAY 250
+/** The suffix of the temporary file for a snapshot */
+#define TEMP_SUFFIX ".tmp"
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized save controller.
+ *
+ * This constructor does not start the writer thread.
+ */
+SaveController::SaveController() :
+_generation(0),
+_committed(0),
+_running(false),
+_urgent(false),
+_saves(0),
+_writes(0),
+_stallTime(0),
+_stallMax(0),
+_writeTime(0) {
+    _state.musicVolume = 1;
+    _state.effectVolume = 1;
+}
+
+/**
+ * Disposes of this controller, writing any pending snapshot.
+ *
+ * The writer thread is joined before this method returns.
+ */
+void SaveController::dispose() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _request.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+/**
+ * Initializes the controller for the given save file.
+ *
+ * If the file exists, the save state is read from it. Otherwise the
+ * state is set to the defaults and written out. This method starts the
+ * writer thread.
+ *
+ * @param path  The path of the save file
+ *
+ * @return true if the controller was initialized successfully
+ */
+bool SaveController::init(const std::string& path) {
+    CUAssertLog(!_running, "Save controller is already initialized");
+    _path = path;
+
+    bool loaded = false;
+    if (filetool::file_exists(_path)) {
+        std::shared_ptr<JsonReader> reader = JsonReader::alloc(_path);
+        loaded = (reader != nullptr && parse(reader->readJson()));
+        if (!loaded) {
+            CULogError("Save file '%s' is unreadable; starting a new save", _path.c_str());
+        }
+    }
+
+    if (!loaded) {
+        _state.levels.clear();
+        for (int ii = 1; ii <= DEFAULT_LEVELS; ii++) {
+            LevelSave level;
+            level.name = "Level " + std::to_string(ii);
+            level.path = "json/level" + std::to_string(ii) + ".json";
+            level.unlocked = true;
+            level.completed = false;
+            level.stars = -1;
+            level.score = -1;
+            _state.levels.push_back(level);
+        }
+        _state.musicVolume = 1;
+        _state.effectVolume = 1;
+    }
+
+    _running = true;
+    _thread = std::thread([this] { run(); });
+    if (!loaded) {
+        save();
+    }
+    return true;
+}
+
+/**
+ * Returns true if the save state was read from the given JSON
+ *
+ * @param json  The save file contents
+ *
+ * @return true if the save state was read from the given JSON
+ */
+bool SaveController::parse(const std::shared_ptr<JsonValue>& json) {
+    if (json == nullptr || !json->has("level_saves")) {
+        return false;
+    }
+
+    std::shared_ptr<JsonValue> levels = json->get("level_saves");
+    _state.levels.clear();
+    _state.levels.reserve(levels->size());
+    for (size_t ii = 0; ii < levels->size(); ii++) {
+        std::shared_ptr<JsonValue> entry = levels->get(ii);
+        LevelSave level;
+        level.name = entry->getString("name");
+        level.path = entry->getString("path");
+        level.unlocked = entry->getBool("unlocked");
+        level.completed = entry->getBool("completed");
+        level.stars = entry->getInt("stars",-1);
+        level.score = entry->getInt("score",-1);
+        _state.levels.push_back(level);
+    }
+    _state.musicVolume = json->getFloat("musicVolume",1);
+    _state.effectVolume = json->getFloat("effectVolume",1);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Save State
+/**
+ * Sets the music and sound effect volumes
+ *
+ * The state is only saved if the volumes change.
+ *
+ * @param music     The volume of the music
+ * @param effects   The volume of the sound effects
+ */
+void SaveController::setVolumes(float music, float effects) {
+    if (_state.musicVolume == music && _state.effectVolume == effects) {
+        return;
+    }
+    _state.musicVolume = music;
+    _state.effectVolume = effects;
+    save();
+}
+
+/**
+ * Records that the level with the given path was completed.
+ *
+ * The level and its successor are unlocked. The stars and score are only
+ * kept if the score beats the previous best. The state is saved if it
+ * changes.
+ *
+ * @param path  The asset path of the level file
+ * @param stars The star rating earned
+ * @param score The score earned
+ */
+void SaveController::completeLevel(const std::string& path, int stars, int score) {
+    for (size_t ii = 0; ii < _state.levels.size(); ii++) {
+        LevelSave& level = _state.levels[ii];
+        if (level.path != path) {
+            continue;
+        }
+
+        bool changed = !level.unlocked || !level.completed;
+        level.unlocked = true;
+        level.completed = true;
+        // only save highscores
+        if (level.score < score) {
+            level.stars = stars;
+            level.score = score;
+            changed = true;
+        }
+        if (ii+1 < _state.levels.size() && !_state.levels[ii+1].unlocked) {
+            _state.levels[ii+1].unlocked = true;
+            changed = true;
+        }
+        if (changed) {
+            save();
+        }
+        return;
+    }
+}
+
+#pragma mark -
+#pragma mark Saving
+/**
+ * Hands a snapshot of the save state to the writer thread.
+ *
+ * This method returns immediately. If an earlier snapshot has not been
+ * written yet, it is replaced by this one.
+ */
+void SaveController::save() {
+    Timestamp start;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _pending = _state;
+        _generation++;
+    }
+    _request.notify_one();
+    Timestamp end;
+
+    Uint64 stall = Timestamp::ellapsedMicros(start,end);
+    _stallTime += stall;
+    _stallMax = (stall > _stallMax ? stall : _stallMax);
+    _saves++;
+}
+
+/**
+ * Blocks until every requested snapshot has been written.
+ *
+ * This should only be called when the application may be terminated,
+ * as it waits on the file system.
+ */
+void SaveController::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_running || _committed == _generation) {
+        return;
+    }
+    _urgent = true;
+    _request.notify_one();
+    _written.wait(lock, [this] { return _committed == _generation; });
+    _urgent = false;
+}
+
+/**
+ * Writes snapshots until the controller is disposed
+ */
+void SaveController::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _request.wait(lock, [this] { return !_running || _generation != _committed; });
+        if (_generation == _committed) {
+            break;
+        }
+
+        // Give a burst of changes time to settle
+        Uint64 seen = _generation;
+        while (_running && !_urgent) {
+            _request.wait_for(lock, std::chrono::milliseconds(COALESCE_DELAY));
+            if (_generation == seen) {
+                break;
+            }
+            seen = _generation;
+        }
+
+        SaveState snapshot = _pending;
+        Uint64 generation = _generation;
+        lock.unlock();
+
+        Timestamp start;
+        bool success = write(snapshot);
+        Timestamp end;
+        if (!success) {
+            CULogError("Could not write save file '%s'", _path.c_str());
+        }
+
+        lock.lock();
+        _writeTime += Timestamp::ellapsedMicros(start,end);
+        _writes++;
+        _committed = generation;
+        _written.notify_all();
+    }
+}
+
+/**
+ * Returns true if the snapshot was written to the save file
+ *
+ * The snapshot is written to a temporary file, which replaces the save
+ * file only once it is complete.
+ *
+ * @param state The snapshot to write
+ *
+ * @return true if the snapshot was written to the save file
+ */
+bool SaveController::write(const SaveState& state) {
+    std::shared_ptr<JsonValue> json = JsonValue::allocObject();
+    std::shared_ptr<JsonValue> levels = JsonValue::allocArray();
+    for (auto it = state.levels.begin(); it != state.levels.end(); ++it) {
+        std::shared_ptr<JsonValue> level = JsonValue::allocObject();
+        level->appendValue("name", it->name);
+        level->appendValue("unlocked", it->unlocked);
+        level->appendValue("completed", it->completed);
+        level->appendValue("stars", (double)it->stars);
+        level->appendValue("score", (double)it->score);
+        level->appendValue("path", it->path);
+        levels->appendChild(level);
+    }
+    json->appendChild("level_saves", levels);
+    json->appendValue("musicVolume", (double)state.musicVolume);
+    json->appendValue("effectVolume", (double)state.effectVolume);
+    std::string data = json->toString(false);
+
+    std::string temp = _path+TEMP_SUFFIX;
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool success = (fwrite(data.data(), 1, data.size(), file) == data.size());
+    success = (fflush(file) == 0) && success;
+#if !defined (_WIN32)
+    // The rename must not reach the disk before the contents do
+    success = (fsync(fileno(file)) == 0) && success;
+#endif
+    success = (fclose(file) == 0) && success;
+    if (!success) {
+        remove(temp.c_str());
+        return false;
+    }
+
+#if defined (_WIN32)
+    return MoveFileExA(temp.c_str(), _path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(temp.c_str(), _path.c_str()) == 0;
+#endif
+}
+
+/**
+ * Returns a summary of the save timings for logging.
+ *
+ * The stall is the time the main thread spends in {@link save}. The write
+ * is the time the writer thread spends serializing and writing a snapshot,
+ * which is what the main thread used to pay for every save.
+ *
+ * @return a summary of the save timings for logging.
+ */
+std::string SaveController::toString() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::stringstream ss;
+    ss << _saves << " saves, " << _writes << " writes, ";
+    ss << "stall avg " << (_saves ? (float)_stallTime/_saves : 0.0f) << " us, ";
+    ss << "stall max " << _stallMax << " us, ";
+    ss << "write avg " << (_writes ? (float)_writeTime/(1000.0f*_writes) : 0.0f) << " ms";
+    return ss.str();
+}
@@ -0,0 +1,233 @@
+//
+//  SaveController.h
+//  Lumia
+//
+//  The save state of the game. The state is kept in memory as typed records,
+//  so the scenes never parse or search the save file. When the state changes,
+//  a snapshot is handed to a background thread, which writes it to a temporary
+//  file and then renames it over the save file. A process killed mid-write
+//  leaves the previous save intact. Bursts of changes are coalesced, so that
+//  only the newest snapshot is written.
+//
+//  The save file keeps the JSON format of the original save.json, so existing
+//  saves load unchanged.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#ifndef SaveController_h
+#define SaveController_h
+#include <cugl/cugl.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class SaveController {
+public:
+    /** The save state of a single level */
+    struct LevelSave {
+        /** The display name of the level */
+        std::string name;
+        /** The asset path of the level file */
+        std::string path;
+        /** Whether the level may be played */
+        bool unlocked;
+        /** Whether the level has been beaten */
+        bool completed;
+        /** The best star rating (-1 if never completed) */
+        int stars;
+        /** The best score (-1 if never completed) */
+        int score;
+    };
+
+    /** The complete save state */
+    struct SaveState {
+        /** The levels, in level select order */
+        std::vector<LevelSave> levels;
+        /** The volume of the music */
+        float musicVolume;
+        /** The volume of the sound effects */
+        float effectVolume;
+    };
+
+private:
+    /** The path of the save file */
+    std::string _path;
+    /** The current save state (main thread only) */
+    SaveState _state;
+
+    /** The thread writing the save file */
+    std::thread _thread;
+    /** Protects the fields shared with the writer thread */
+    std::mutex _mutex;
+    /** Signals the writer thread (new snapshot or shutdown) */
+    std::condition_variable _request;
+    /** Signals waiting threads that a snapshot was written */
+    std::condition_variable _written;
+    /** The newest snapshot not yet written */
+    SaveState _pending;
+    /** The generation of the newest snapshot */
+    Uint64 _generation;
+    /** The generation of the last snapshot written */
+    Uint64 _committed;
+    /** Whether the writer thread should keep running */
+    bool _running;
+    /** Whether a thread is waiting for the pending snapshot */
+    bool _urgent;
+
+    /** The number of saves requested */
+    Uint64 _saves;
+    /** The number of snapshots written */
+    Uint64 _writes;
+    /** The total main thread time spent requesting saves in microseconds */
+    Uint64 _stallTime;
+    /** The largest main thread time for a single save in microseconds */
+    Uint64 _stallMax;
+    /** The total writer thread time to serialize and write in microseconds */
+    Uint64 _writeTime;
+
+    /** Writes snapshots until the controller is disposed */
+    void run();
+
+    /**
+     * Returns true if the snapshot was written to the save file
+     *
+     * The snapshot is written to a temporary file, which replaces the save
+     * file only once it is complete.
+     *
+     * @param state The snapshot to write
+     *
+     * @return true if the snapshot was written to the save file
+     */
+    bool write(const SaveState& state);
+
+    /**
+     * Returns true if the save state was read from the given JSON
+     *
+     * @param json  The save file contents
+     *
+     * @return true if the save state was read from the given JSON
+     */
+    bool parse(const std::shared_ptr<cugl::JsonValue>& json);
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized save controller.
+     *
+     * This constructor does not start the writer thread.
+     */
+    SaveController();
+
+    /**
+     * Disposes of this controller, writing any pending snapshot.
+     */
+    ~SaveController() { dispose(); }
+
+    /**
+     * Disposes of this controller, writing any pending snapshot.
+     *
+     * The writer thread is joined before this method returns.
+     */
+    void dispose();
+
+    /**
+     * Initializes the controller for the given save file.
+     *
+     * If the file exists, the save state is read from it. Otherwise the
+     * state is set to the defaults and written out. This method starts the
+     * writer thread.
+     *
+     * @param path  The path of the save file
+     *
+     * @return true if the controller was initialized successfully
+     */
+    bool init(const std::string& path);
+
+    /**
+     * Returns a newly allocated controller for the given save file.
+     *
+     * @param path  The path of the save file
+     *
+     * @return a newly allocated controller for the given save file.
+     */
+    static std::shared_ptr<SaveController> alloc(const std::string& path) {
+        std::shared_ptr<SaveController> result = std::make_shared<SaveController>();
+        return (result->init(path) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Save State
+    /** Returns the number of levels */
+    size_t getLevelCount() const { return _state.levels.size(); }
+
+    /**
+     * Returns the save state of the given level
+     *
+     * @param index The level index (in level select order)
+     *
+     * @return the save state of the given level
+     */
+    const LevelSave& getLevel(size_t index) const { return _state.levels[index]; }
+
+    /** Returns the volume of the music */
+    float getMusicVolume() const { return _state.musicVolume; }
+
+    /** Returns the volume of the sound effects */
+    float getEffectVolume() const { return _state.effectVolume; }
+
+    /**
+     * Sets the music and sound effect volumes
+     *
+     * The state is only saved if the volumes change.
+     *
+     * @param music     The volume of the music
+     * @param effects   The volume of the sound effects
+     */
+    void setVolumes(float music, float effects);
+
+    /**
+     * Records that the level with the given path was completed.
+     *
+     * The level and its successor are unlocked. The stars and score are only
+     * kept if the score beats the previous best. The state is saved if it
+     * changes.
+     *
+     * @param path  The asset path of the level file
+     * @param stars The star rating earned
+     * @param score The score earned
+     */
+    void completeLevel(const std::string& path, int stars, int score);
+
+#pragma mark -
+#pragma mark Saving
+    /**
+     * Hands a snapshot of the save state to the writer thread.
+     *
+     * This method returns immediately. If an earlier snapshot has not been
+     * written yet, it is replaced by this one.
+     */
+    void save();
+
+    /**
+     * Blocks until every requested snapshot has been written.
+     *
+     * This should only be called when the application may be terminated,
+     * as it waits on the file system.
+     */
+    void flush();
+
+    /**
+     * Returns a summary of the save timings for logging.
+     *
+     * The stall is the time the main thread spends in {@link save}. The write
+     * is the time the writer thread spends serializing and writing a snapshot,
+     * which is what the main thread used to pay for every save.
+     *
+     * @return a summary of the save timings for logging.
+     */
+    std::string toString();
+};
+
+#endif /* SaveController_h */
@@ -43,7 +43,7 @@ bool SettingsScene::init(const std::shared_ptr<AssetManager>& assets) {
     _assets = assets;
     auto layer = assets->get<scene2::SceneNode>("settings");
     layer->setContentSize(dimen);
-    layer->doLayout(); // This rearranges the children to fit the screen
+    layer->updateLayout(); // This rearranges the children to fit the screen
     addChild(layer);
     
     _musicSlider = std::dynamic_pointer_cast<scene2::Slider>(assets->get<scene2::SceneNode>("settings_musicslider"));
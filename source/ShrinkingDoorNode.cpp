@@ -8,8 +8,7 @@
 
 #include <stdio.h>
 #include "ShrinkingDoorNode.h"
-void ShrinkingDoorNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
+void ShrinkingDoorNode::advanceFrame() {
     switch (_state){
         case Open:{
             setFrame(ANIMATION_SIZE - 1);
@@ -45,8 +44,18 @@ void ShrinkingDoorNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
         }
     }
     _frameCount ++;
+}
+
+void ShrinkingDoorNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Mat4& transform, cugl::Color4 tint) {
+    advanceFrame();
+    AnimationNode::draw(batch,transform,tint);
+}
+
+void ShrinkingDoorNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    advanceFrame();
     AnimationNode::draw(batch,transform,tint);
-    
 }
 
 
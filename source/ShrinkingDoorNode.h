@@ -57,6 +57,12 @@ public:
     void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
               const cugl::Mat4& transform, cugl::Color4 tint) override;
 
+    void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+              const cugl::Affine2& transform, cugl::Color4 tint) override;
+
+    /** Advances the animation frame (called once per draw) */
+    void advanceFrame();
+
 };
 
 
@@ -18,3 +18,7 @@ void SpikeNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
     
 }
 
+void SpikeNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    AnimationNode::draw(batch,transform,tint);
+}
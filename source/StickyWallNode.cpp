@@ -9,9 +9,7 @@
 #include "StickyWallNode.h"
 
 
-void StickyWallNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
-                      const cugl::Mat4& transform, cugl::Color4 tint) {
-    
+void StickyWallNode::advanceFrame() {
     _frameCount %= ANIMATION_INTERVAL;
     
     if (_frameCount == 0){
@@ -20,5 +18,16 @@ void StickyWallNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
     }
     
     _frameCount ++;
+}
+
+void StickyWallNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Mat4& transform, cugl::Color4 tint) {
+    advanceFrame();
+    AnimationNode::draw(batch,transform,tint);
+}
+
+void StickyWallNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
+                      const cugl::Affine2& transform, cugl::Color4 tint) {
+    advanceFrame();
     AnimationNode::draw(batch,transform,tint);
 }
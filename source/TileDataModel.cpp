@@ -8,6 +8,61 @@
 
 #include "TileDataModel.h"
 
+/** The largest distance between a tile outline and its spline */
+#define TILE_TOLERANCE 0.07f
+/** The largest cross product of two outline edges that are collinear */
+#define TILE_COLLINEAR 0.0001f
+
+/**
+ * Removes the vertices of a closed path that lie on a line with their neighbors
+ *
+ * Some tile splines fold back on themselves, such as a bezier whose anchors
+ * meet but whose handle does not. The fold has no area, and would only be
+ * triangulated into degenerate triangles (which Box2D replaces with a box).
+ *
+ * @param path  The closed path to simplify
+ */
+static void removeCollinear(vector<Vec2>& path) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t ii = 0; ii < path.size() && path.size() > 3; ) {
+            const Vec2& prev = path[(ii+path.size()-1) % path.size()];
+            const Vec2& next = path[(ii+1) % path.size()];
+            if (fabsf((path[ii]-prev).cross(next-path[ii])) <= TILE_COLLINEAR) {
+                path.erase(path.begin()+ii);
+                changed = true;
+            } else {
+                ii++;
+            }
+        }
+    }
+}
+
+/**
+ * Returns the solid outline of the given tile spline
+ *
+ * @param points    The tile spline control points
+ *
+ * @return the solid outline of the given tile spline
+ */
+static Poly2 buildOutline(const vector<Vec2>& points) {
+    Spline2 spline(points);
+    spline.setClosed(true);
+    SplineFlattener flattener(&spline);
+    flattener.calculate(TILE_TOLERANCE);
+    vector<Vec2> path = flattener.getPath().vertices();
+    removeCollinear(path);
+    Poly2 outline(path);
+
+    SimpleTriangulator triangulator;
+    triangulator.set(outline);
+    triangulator.calculate();
+    outline.setIndices(triangulator.getTriangulation());
+    outline.setGeometry(Geometry::SOLID);
+    return outline;
+}
+
 bool TileDataModel::preload(const std::shared_ptr<cugl::JsonValue>& json){
     if (json == nullptr) {
         // NOLINTNEXTLINE idk why but clang-tidy is complaining
@@ -23,6 +78,7 @@ bool TileDataModel::preload(const std::shared_ptr<cugl::JsonValue>& json){
             tile.push_back(Vec2(point[0], point[1]));
         }
         _tiles.push_back(tile);
+        _outlines.push_back(buildOutline(tile));
         vector<Vec2> grid;
         for (int j = 0; j< tile_json->get("grid_data")->get("0")->size(); j++){
             vector<float> point = tile_json->get("grid_data")->get("0")->get(j)->asFloatArray();
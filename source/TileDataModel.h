@@ -24,6 +24,8 @@ private:
     vector<vector<Vec2>> _griddata90;
     vector<vector<Vec2>> _griddata180;
     vector<vector<Vec2>> _griddata270;
+    /** The flattened and triangulated outline of each tile type */
+    vector<Poly2> _outlines;
   
 public:
     
@@ -60,6 +62,21 @@ public:
         return _tiles[type];
     }
     
+    /**
+     * Returns the solid outline of the given tile type.
+     *
+     * The outline is flattened and triangulated once, when the tiles are
+     * loaded, so levels only need to copy and translate it. It is safe to
+     * call this from the level streaming workers.
+     *
+     * @param type  The tile type (starting at 0)
+     *
+     * @return the solid outline of the given tile type.
+     */
+    const Poly2& getTileOutline(int type) const {
+        return _outlines[type];
+    }
+    
     vector<Vec2> getTileGridData(int type){
         return _griddata0[type];
     }
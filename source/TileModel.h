@@ -39,11 +39,27 @@ private:
 
     bool init(Poly2 p);
     
+    /**
+     * Initializes a tile whose shapes are allocated from the level arena.
+     *
+     * Tiles are rebuilt on every level reset, so taking their shapes from
+     * the arena keeps a reset off the system heap.
+     */
+    bool init(Poly2 p, const std::shared_ptr<Arena>& arena) {
+        setArena(arena);
+        return init(p);
+    }
+    
     static std::shared_ptr<TileModel> alloc(Poly2 p) {
         std::shared_ptr<TileModel> result = std::make_shared<TileModel>();
         return (result->init(p) ? result : nullptr);
     }
     
+    static std::shared_ptr<TileModel> alloc(Poly2 p, const std::shared_ptr<Arena>& arena) {
+        std::shared_ptr<TileModel> result = std::make_shared<TileModel>();
+        return (result->init(p,arena) ? result : nullptr);
+    }
+    
     std::shared_ptr<cugl::scene2::SceneNode> getSceneNode() {
         return _node;
     }
@@ -11,22 +11,19 @@
 
 void TrajectoryNode::dispose(){
     clearPoints();
-    PolygonNode::dispose();
+    _fade = false;
+    InstanceNode::dispose();
 }
 
 void TrajectoryNode::draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
                       const cugl::Mat4& transform, cugl::Color4 tint) {
-    float num_points = _points.size() * 1.0f;
-    for (int i= 0; i< num_points; i++){
-
-        cugl::Mat4 translation_mat = Mat4::createTranslation(_points[i].x, _points[i].y, 0.0f);
-        
-
-        float alpha = 1 - (i/num_points) * (1.0f - _endAlpha);
-
-        cugl::Color4 n_tint = cugl::Color4f(1, 1, 1, alpha );
-        scene2::PolygonNode::draw(batch, transform * translation_mat, n_tint);
+    if (_fade) {
+        float num_points = getInstanceCount() * 1.0f;
+        for (int i= 0; i< num_points; i++){
+            float alpha = 1 - (i/num_points) * (1.0f - _endAlpha);
+            getInstance(i).color = Vec4(1, 1, 1, alpha);
+        }
+        _fade = false;
     }
-    
+    scene2::InstanceNode::draw(batch, transform, tint);
 }
-
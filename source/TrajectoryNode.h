@@ -14,19 +14,27 @@
 
 using namespace cugl;
 
-class TrajectoryNode : public scene2::PolygonNode {
+/**
+ * The dotted launch preview.
+ *
+ * Every point is a copy of the dot texture centered at that point, fading
+ * from opaque at the start to the end alpha at the tail. The dots are drawn
+ * as instances, so the whole path is a single sprite batch call.
+ */
+class TrajectoryNode : public scene2::InstanceNode {
     
     
 protected:
    
-    std::vector<Vec2> _points;
     float _endAlpha = 0.4f;
+    /** Whether the dot alphas must be recomputed before drawing */
+    bool _fade = false;
     
 
 public:
     ~TrajectoryNode() { dispose(); }
     
-    TrajectoryNode(): scene2::PolygonNode(){}
+    TrajectoryNode(): scene2::InstanceNode(){}
     
     void dispose() override;
     
@@ -44,12 +52,17 @@ public:
     void draw(const std::shared_ptr<cugl::SpriteBatch>& batch,
               const cugl::Mat4& transform, cugl::Color4 tint) override;
     
-    void setPoints(std::vector<Vec2> points){
-        _points = points;
+    void setPoints(const std::vector<Vec2>& points){
+        clearInstances();
+        for (auto it = points.begin(); it != points.end(); ++it){
+            addInstance(*it);
+        }
+        _fade = true;
     }
     
     void addPoint(Vec2 point){
-        _points.push_back(point);
+        addInstance(point);
+        _fade = true;
     }
     
     void setEndAlpha(float f){
@@ -58,10 +71,11 @@ public:
         }else{
             _endAlpha = f;
         }
+        _fade = true;
     }
     
     void clearPoints(){
-        _points.clear();
+        clearInstances();
     }
 
 };
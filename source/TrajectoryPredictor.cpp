@@ -0,0 +1,565 @@
+//
+//  TrajectoryPredictor.cpp
+//  Lumia
+//
+//  Predicts the path of a launched Lumia on a worker thread. The predictor
+//  keeps a read-only copy of the static level geometry as line segments, and
+//  sweeps a circle through it one physics step at a time, bouncing with the
+//  same restitution and friction mixing as Box2D. The scene posts a launch
+//  whenever the drag changes, and picks up the newest path without locking.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#include "TrajectoryPredictor.h"
+#include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Collision/Shapes/b2EdgeShape.h>
+#include <Box2D/Collision/Shapes/b2ChainShape.h>
+#include <Box2D/Collision/Shapes/b2PolygonShape.h>
+#include <algorithm>
+#include <sstream>
+
+using namespace cugl;
+
+/** The length of a physics step (the fixed step of the game world) */
+#define TRAJECTORY_STEP     (1.0f/60.0f)
+/** The size of a grid cell in physics units */
+#define TRAJECTORY_CELL     2.0f
+/** The most surfaces to hit in a single step */
+#define TRAJECTORY_HITS     4
+/** The distance to back away from a surface after a hit */
+#define TRAJECTORY_SKIN     0.005f
+/** The approach speed below which Box2D ignores restitution */
+#define TRAJECTORY_INELASTIC    1.0f
+/** The speed below which a path resting on the ground stops */
+#define TRAJECTORY_REST     0.5f
+/** The number of segments approximating a circle fixture */
+#define TRAJECTORY_CIRCLE   12
+/** The flag marking an unread path in the middle slot */
+#define NEW_RESULT          4
+
+#pragma mark -
+#pragma mark Sweeps
+/**
+ * Returns true if a moving circle hits a fixed circle before the time limit
+ *
+ * @param p         The start of the circle center
+ * @param d         The displacement of the circle center
+ * @param r         The sum of the radii
+ * @param c         The fixed circle center
+ * @param time      The time limit (updated on a hit)
+ * @param normal    The normal of the hit
+ *
+ * @return true if a moving circle hits a fixed circle before the time limit
+ */
+static bool sweepPoint(const Vec2 p, const Vec2 d, float r, const Vec2 c, float& time, Vec2& normal) {
+    Vec2 m = p-c;
+    float b = m.dot(d);
+    if (b >= 0) {
+        return false;   // Moving away
+    }
+    float k = m.lengthSquared()-r*r;
+    float t = 0;
+    if (k > 0) {
+        float a = d.lengthSquared();
+        float disc = b*b-a*k;
+        if (disc < 0) {
+            return false;
+        }
+        t = (-b-sqrtf(disc))/a;
+    }
+    if (t > time) {
+        return false;
+    }
+    time = t;
+    normal = m+d*t;
+    normal.normalize();
+    return true;
+}
+
+/**
+ * Returns true if a moving circle hits a segment before the time limit
+ *
+ * This is a ray cast against the segment inflated by the radius. Segments
+ * are two-sided, so a circle may hit either face.
+ *
+ * @param p         The start of the circle center
+ * @param d         The displacement of the circle center
+ * @param r         The circle radius
+ * @param seg       The segment
+ * @param time      The time limit (updated on a hit)
+ * @param normal    The normal of the hit
+ *
+ * @return true if a moving circle hits a segment before the time limit
+ */
+static bool sweepSegment(const Vec2 p, const Vec2 d, float r, const TrajectoryPredictor::Segment& seg,
+                         float& time, Vec2& normal) {
+    Vec2 e = seg.b-seg.a;
+    float len2 = e.lengthSquared();
+    if (len2 > 0) {
+        Vec2 m = e.getPerp()/sqrtf(len2);
+        float dist = (p-seg.a).dot(m);
+        if (dist < 0) {
+            m = -m;
+            dist = -dist;
+        }
+        float speed = d.dot(m);
+        if (speed < 0) {
+            float t = std::max((r-dist)/speed,0.0f);
+            float u = (p+d*t-seg.a).dot(e)/len2;
+            if (u >= 0 && u <= 1) {
+                if (t > time) {
+                    return false;
+                }
+                time = t;
+                normal = m;
+                return true;
+            }
+        }
+    }
+
+    // The face missed, so try the endpoints
+    bool hit = sweepPoint(p,d,r,seg.a,time,normal);
+    hit = sweepPoint(p,d,r,seg.b,time,normal) || hit;
+    return hit;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized predictor.
+ *
+ * This constructor does not start the worker.
+ */
+TrajectoryPredictor::TrajectoryPredictor() :
+_pending(false),
+_serial(0),
+_steps(0),
+_interval(1),
+_running(false),
+_front(0),
+_back(1),
+_middle(2),
+_query(0),
+_predictions(0),
+_dropped(0),
+_latencyTime(0),
+_latencyMax(0),
+_computeTime(0) {
+}
+
+/**
+ * Disposes of this predictor, abandoning any unfinished prediction.
+ *
+ * The worker is joined before this method returns.
+ */
+void TrajectoryPredictor::dispose() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _running = false;
+        _pending = false;
+    }
+    _signal.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _geometry = nullptr;
+    _launch.movers.clear();
+    for(int ii = 0; ii < 3; ii++) {
+        _results[ii].points.clear();
+    }
+}
+
+/**
+ * Initializes the predictor and starts its worker.
+ *
+ * A path is sampled every interval steps, so it has steps/interval points
+ * unless it stops early.
+ *
+ * @param steps     The number of physics steps to simulate
+ * @param interval  The number of physics steps between path points
+ *
+ * @return true if the predictor was initialized successfully
+ */
+bool TrajectoryPredictor::init(Uint32 steps, Uint32 interval) {
+    CUAssertLog(!_running, "Trajectory predictor is already initialized");
+    _steps = steps;
+    _interval = std::max(interval,(Uint32)1);
+    for(int ii = 0; ii < 3; ii++) {
+        _results[ii].points.reserve(_steps/_interval+1);
+        _results[ii].hits = 0;
+        _results[ii].stopped = false;
+        _results[ii].serial = 0;
+    }
+    _running = true;
+    _thread = std::thread([this] { run(); });
+    return true;
+}
+
+#pragma mark -
+#pragma mark Geometry
+/**
+ * Appends the outline of the given fixture as segments.
+ *
+ * The outline is in physics coordinates, using the current transform of
+ * the fixture body. Circles are approximated by polygons.
+ *
+ * @param segments  The vector to store the segments
+ * @param fixture   The fixture to outline
+ * @param surface   The surface of the fixture
+ */
+void TrajectoryPredictor::appendFixture(std::vector<Segment>& segments, const b2Fixture* fixture, const Surface& surface) {
+    const b2Transform& xf = fixture->GetBody()->GetTransform();
+    Segment seg;
+    seg.surface = surface;
+    switch (fixture->GetType()) {
+        case b2Shape::e_circle:
+        {
+            const b2CircleShape* circle = (const b2CircleShape*)fixture->GetShape();
+            b2Vec2 center = b2Mul(xf,circle->m_p);
+            for(int ii = 0; ii < TRAJECTORY_CIRCLE; ii++) {
+                float a1 = (2.0f*M_PI*ii)/TRAJECTORY_CIRCLE;
+                float a2 = (2.0f*M_PI*(ii+1))/TRAJECTORY_CIRCLE;
+                seg.a.set(center.x+circle->m_radius*cosf(a1),center.y+circle->m_radius*sinf(a1));
+                seg.b.set(center.x+circle->m_radius*cosf(a2),center.y+circle->m_radius*sinf(a2));
+                segments.push_back(seg);
+            }
+        }
+            break;
+        case b2Shape::e_polygon:
+        {
+            const b2PolygonShape* poly = (const b2PolygonShape*)fixture->GetShape();
+            for(int32 ii = 0; ii < poly->m_count; ii++) {
+                b2Vec2 v1 = b2Mul(xf,poly->m_vertices[ii]);
+                b2Vec2 v2 = b2Mul(xf,poly->m_vertices[(ii+1)%poly->m_count]);
+                seg.a.set(v1.x,v1.y);
+                seg.b.set(v2.x,v2.y);
+                segments.push_back(seg);
+            }
+        }
+            break;
+        case b2Shape::e_edge:
+        {
+            const b2EdgeShape* edge = (const b2EdgeShape*)fixture->GetShape();
+            b2Vec2 v1 = b2Mul(xf,edge->m_vertex1);
+            b2Vec2 v2 = b2Mul(xf,edge->m_vertex2);
+            seg.a.set(v1.x,v1.y);
+            seg.b.set(v2.x,v2.y);
+            segments.push_back(seg);
+        }
+            break;
+        case b2Shape::e_chain:
+        {
+            const b2ChainShape* chain = (const b2ChainShape*)fixture->GetShape();
+            b2EdgeShape edge;
+            for(int32 ii = 0; ii < chain->GetChildCount(); ii++) {
+                chain->GetChildEdge(&edge,ii);
+                b2Vec2 v1 = b2Mul(xf,edge.m_vertex1);
+                b2Vec2 v2 = b2Mul(xf,edge.m_vertex2);
+                seg.a.set(v1.x,v1.y);
+                seg.b.set(v2.x,v2.y);
+                segments.push_back(seg);
+            }
+        }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Sets the static geometry of the level.
+ *
+ * The geometry is copied and bucketed in a grid on the calling thread.
+ * Launches posted before this call may still finish with the previous
+ * geometry.
+ *
+ * @param segments  The segments of the level
+ */
+void TrajectoryPredictor::setGeometry(const std::vector<Segment>& segments) {
+    std::shared_ptr<Geometry> geometry = std::make_shared<Geometry>();
+    geometry->segments = segments;
+    geometry->cols = 0;
+    geometry->rows = 0;
+    if (!segments.empty()) {
+        Vec2 min = segments[0].a;
+        Vec2 max = min;
+        for(auto it = segments.begin(); it != segments.end(); ++it) {
+            min.x = std::min(min.x,std::min(it->a.x,it->b.x));
+            min.y = std::min(min.y,std::min(it->a.y,it->b.y));
+            max.x = std::max(max.x,std::max(it->a.x,it->b.x));
+            max.y = std::max(max.y,std::max(it->a.y,it->b.y));
+        }
+        geometry->origin = min;
+        geometry->cols = (int)((max.x-min.x)/TRAJECTORY_CELL)+1;
+        geometry->rows = (int)((max.y-min.y)/TRAJECTORY_CELL)+1;
+    }
+
+    // Count the segments of each cell, then fill the cells in place
+    size_t total = (size_t)(geometry->cols*geometry->rows);
+    geometry->cells.assign(total+1,0);
+    for(int pass = 0; pass < 2; pass++) {
+        std::vector<Uint32> fill;
+        if (pass == 1) {
+            for(size_t ii = 0; ii < total; ii++) {
+                geometry->cells[ii+1] += geometry->cells[ii];
+            }
+            geometry->items.resize(geometry->cells[total]);
+            fill.assign(geometry->cells.begin(),geometry->cells.end()-1);
+        }
+        for(Uint32 ii = 0; ii < segments.size(); ii++) {
+            const Segment& seg = segments[ii];
+            int x1 = (int)((std::min(seg.a.x,seg.b.x)-geometry->origin.x)/TRAJECTORY_CELL);
+            int x2 = (int)((std::max(seg.a.x,seg.b.x)-geometry->origin.x)/TRAJECTORY_CELL);
+            int y1 = (int)((std::min(seg.a.y,seg.b.y)-geometry->origin.y)/TRAJECTORY_CELL);
+            int y2 = (int)((std::max(seg.a.y,seg.b.y)-geometry->origin.y)/TRAJECTORY_CELL);
+            for(int yy = y1; yy <= y2; yy++) {
+                for(int xx = x1; xx <= x2; xx++) {
+                    size_t cell = (size_t)(yy*geometry->cols+xx);
+                    if (pass == 0) {
+                        geometry->cells[cell+1]++;
+                    } else {
+                        geometry->items[fill[cell]++] = ii;
+                    }
+                }
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _geometry = geometry;
+}
+
+#pragma mark -
+#pragma mark Prediction
+/**
+ * Posts a launch for the worker to predict.
+ *
+ * Only the newest launch is kept, so a launch that the worker has not
+ * started yet is replaced.
+ *
+ * @param launch    The launch to predict
+ */
+Uint64 TrajectoryPredictor::post(const Launch& launch) {
+    Uint64 serial;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_pending) {
+            _dropped++;
+        }
+        _launch = launch;
+        _posted.mark();
+        _pending = true;
+        serial = ++_serial;
+    }
+    _signal.notify_one();
+    return serial;
+}
+
+/**
+ * Picks up the newest published path, if there is one.
+ *
+ * A path predicted for a launch posted before the given serial number is
+ * stale (such as one left over from an earlier drag), and it is dropped.
+ * This method never blocks. If it returns false, {@link getResult} is
+ * unchanged. It must only be called from one thread.
+ *
+ * @param oldest    The serial number of the oldest launch to accept
+ *
+ * @return true if a new path was picked up
+ */
+bool TrajectoryPredictor::acquire(Uint64 oldest) {
+    while (_middle.load(std::memory_order_relaxed) & NEW_RESULT) {
+        // The serial can only be read safely once the path is ours
+        int prior = _front;
+        int taken = _middle.exchange(prior,std::memory_order_acq_rel) & ~NEW_RESULT;
+        if (_results[taken].serial >= oldest) {
+            _front = taken;
+            return true;
+        }
+        
+        // Hand the stale path back, unless the worker has already taken
+        // the prior path to publish a newer one
+        int expected = prior;
+        if (_middle.compare_exchange_strong(expected,taken,std::memory_order_acq_rel)) {
+            return false;
+        }
+        _front = taken;
+    }
+    return false;
+}
+
+/**
+ * Predicts posted launches until the predictor is disposed
+ */
+void TrajectoryPredictor::run() {
+    Launch launch;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _signal.wait(lock, [this] { return !_running || _pending; });
+        if (!_running) {
+            break;
+        }
+
+        std::swap(launch,_launch);
+        std::shared_ptr<const Geometry> geometry = _geometry;
+        Timestamp posted = _posted;
+        Uint64 serial = _serial;
+        _pending = false;
+        lock.unlock();
+
+        Timestamp start;
+        Result& result = _results[_back];
+        predict(geometry.get(),launch,result);
+        result.serial = serial;
+        _back = _middle.exchange(_back | NEW_RESULT,std::memory_order_acq_rel) & ~NEW_RESULT;
+        Timestamp end;
+
+        lock.lock();
+        Uint64 latency = Timestamp::ellapsedMicros(posted,end);
+        _predictions++;
+        _computeTime += Timestamp::ellapsedMicros(start,end);
+        _latencyTime += latency;
+        _latencyMax = std::max(_latencyMax,latency);
+    }
+}
+
+/**
+ * Stores the segments that may touch the given box in the candidates
+ *
+ * @param geometry  The static level geometry
+ * @param min       The bottom left corner of the box
+ * @param max       The top right corner of the box
+ */
+void TrajectoryPredictor::gather(const Geometry* geometry, const Vec2 min, const Vec2 max) {
+    _candidates.clear();
+    if (geometry == nullptr || geometry->cols == 0) {
+        return;
+    }
+    if (_stamps.size() != geometry->segments.size()) {
+        _stamps.assign(geometry->segments.size(),0);
+    }
+    _query++;
+
+    int x1 = std::max((int)floorf((min.x-geometry->origin.x)/TRAJECTORY_CELL),0);
+    int x2 = std::min((int)floorf((max.x-geometry->origin.x)/TRAJECTORY_CELL),geometry->cols-1);
+    int y1 = std::max((int)floorf((min.y-geometry->origin.y)/TRAJECTORY_CELL),0);
+    int y2 = std::min((int)floorf((max.y-geometry->origin.y)/TRAJECTORY_CELL),geometry->rows-1);
+    for(int yy = y1; yy <= y2; yy++) {
+        for(int xx = x1; xx <= x2; xx++) {
+            size_t cell = (size_t)(yy*geometry->cols+xx);
+            for(Uint32 ii = geometry->cells[cell]; ii < geometry->cells[cell+1]; ii++) {
+                Uint32 item = geometry->items[ii];
+                if (_stamps[item] != _query) {
+                    _stamps[item] = _query;
+                    _candidates.push_back(item);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Predicts the path of the given launch
+ *
+ * Each step matches a Box2D step: gravity is applied to the velocity, and
+ * then the circle moves with the new velocity. The move is swept against
+ * the segments, and a hit splits the step. Restitution and friction are
+ * mixed as in Box2D (the larger restitution, and the geometric mean of the
+ * frictions), and restitution is ignored for slow impacts.
+ *
+ * @param geometry  The static level geometry
+ * @param launch    The launch to predict
+ * @param result    The result to store the path
+ */
+void TrajectoryPredictor::predict(const Geometry* geometry, const Launch& launch, Result& result) {
+    result.points.clear();
+    result.hits = 0;
+    result.stopped = false;
+
+    Vec2 pos = launch.position;
+    Vec2 vel = launch.velocity;
+    float r = launch.radius;
+    float bottom = (geometry && geometry->cols ? geometry->origin.y : pos.y)-2*r;
+
+    for(Uint32 step = 1; step <= _steps && !result.stopped; step++) {
+        vel += launch.gravity*TRAJECTORY_STEP;
+        float remain = 1.0f;
+        for(int hits = 0; hits < TRAJECTORY_HITS && remain > 0; hits++) {
+            Vec2 d = vel*(TRAJECTORY_STEP*remain);
+            Vec2 end = pos+d;
+            Vec2 min(std::min(pos.x,end.x)-r,std::min(pos.y,end.y)-r);
+            Vec2 max(std::max(pos.x,end.x)+r,std::max(pos.y,end.y)+r);
+            gather(geometry,min,max);
+
+            float time = 1.0f;
+            Vec2 normal;
+            const Segment* hit = nullptr;
+            for(auto it = _candidates.begin(); it != _candidates.end(); ++it) {
+                const Segment& seg = geometry->segments[*it];
+                if (sweepSegment(pos,d,r,seg,time,normal)) {
+                    hit = &seg;
+                }
+            }
+            for(auto it = launch.movers.begin(); it != launch.movers.end(); ++it) {
+                if (sweepSegment(pos,d,r,*it,time,normal)) {
+                    hit = &(*it);
+                }
+            }
+
+            if (hit == nullptr) {
+                pos = end;
+                break;
+            }
+
+            pos += d*time+normal*TRAJECTORY_SKIN;
+            remain *= (1.0f-time);
+            result.hits++;
+            if (hit->surface.stops) {
+                result.stopped = true;
+                break;
+            }
+
+            float vn = vel.dot(normal);
+            Vec2 vt = vel-normal*vn;
+            float e = std::max(launch.restitution,hit->surface.restitution);
+            if (-vn < TRAJECTORY_INELASTIC) {
+                e = 0;
+            }
+            float mu = sqrtf(launch.friction*hit->surface.friction);
+            float slip = vt.length();
+            if (slip > 0) {
+                vt *= std::max(slip-mu*(1+e)*(-vn),0.0f)/slip;
+            }
+            vel = vt-normal*(e*vn);
+            if (e == 0 && normal.y > 0.7f && vel.length() < TRAJECTORY_REST) {
+                result.stopped = true;
+                break;
+            }
+        }
+
+        if (step % _interval == 0 || result.stopped) {
+            result.points.push_back(pos);
+        }
+        if (pos.y < bottom) {
+            break;
+        }
+    }
+}
+
+/**
+ * Returns a summary of the prediction statistics for logging.
+ *
+ * @return a summary of the prediction statistics for logging.
+ */
+std::string TrajectoryPredictor::toString() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::stringstream ss;
+    ss << _predictions << " predictions (" << _dropped << " replaced before start), ";
+    ss << (_geometry ? _geometry->segments.size() : 0) << " segments, ";
+    ss << "latency avg " << (_predictions ? (float)_latencyTime/(1000.0f*_predictions) : 0.0f) << " ms, ";
+    ss << "latency max " << _latencyMax/1000.0f << " ms, ";
+    ss << "compute avg " << (_predictions ? (float)_computeTime/(1000.0f*_predictions) : 0.0f) << " ms";
+    return ss.str();
+}
@@ -0,0 +1,280 @@
+//
+//  TrajectoryPredictor.h
+//  Lumia
+//
+//  Predicts the path of a launched Lumia on a worker thread. The predictor
+//  keeps a read-only copy of the static level geometry as line segments, and
+//  sweeps a circle through it one physics step at a time, bouncing with the
+//  same restitution and friction mixing as Box2D. The scene posts a launch
+//  whenever the drag changes, and picks up the newest path without locking.
+//
+//  Copyright © 2021 Cornell Game Design Initiative. All rights reserved.
+//
+
+#ifndef TrajectoryPredictor_h
+#define TrajectoryPredictor_h
+#include <cugl/cugl.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class TrajectoryPredictor {
+public:
+    /** How a launched Lumia reacts to a surface */
+    struct Surface {
+        /** The surface restitution */
+        float restitution;
+        /** The surface friction */
+        float friction;
+        /** Whether Lumia stops on contact (e.g. a sticky wall) */
+        bool stops;
+    };
+
+    /** A line segment of the level geometry */
+    struct Segment {
+        /** The first endpoint (in physics coordinates) */
+        cugl::Vec2 a;
+        /** The second endpoint (in physics coordinates) */
+        cugl::Vec2 b;
+        /** The surface of the segment */
+        Surface surface;
+    };
+
+    /** A launch to predict */
+    struct Launch {
+        /** The launch position */
+        cugl::Vec2 position;
+        /** The launch velocity */
+        cugl::Vec2 velocity;
+        /** The world gravity */
+        cugl::Vec2 gravity;
+        /** The Lumia radius */
+        float radius;
+        /** The Lumia restitution */
+        float restitution;
+        /** The Lumia friction */
+        float friction;
+        /** Geometry that may move during play, such as doors */
+        std::vector<Segment> movers;
+    };
+
+    /** A predicted path */
+    struct Result {
+        /** The path points, one every sample interval (in physics coordinates) */
+        std::vector<cugl::Vec2> points;
+        /** The number of surfaces hit along the path */
+        Uint32 hits;
+        /** Whether the path ended early on a surface */
+        bool stopped;
+        /** The launch number, in the order posted */
+        Uint64 serial;
+    };
+
+private:
+    /** The static geometry, bucketed in a uniform grid (immutable once built) */
+    struct Geometry {
+        /** The segments of the level */
+        std::vector<Segment> segments;
+        /** The first item of each cell (one extra at the end) */
+        std::vector<Uint32> cells;
+        /** The segment indices of every cell, in cell order */
+        std::vector<Uint32> items;
+        /** The bottom left corner of the grid */
+        cugl::Vec2 origin;
+        /** The number of grid columns */
+        int cols;
+        /** The number of grid rows */
+        int rows;
+    };
+
+    /** The latest static geometry */
+    std::shared_ptr<const Geometry> _geometry;
+    /** The next launch to predict */
+    Launch _launch;
+    /** The time the next launch was posted */
+    cugl::Timestamp _posted;
+    /** Whether a launch is waiting for the worker */
+    bool _pending;
+    /** The number of launches posted */
+    Uint64 _serial;
+    /** The number of physics steps to simulate */
+    Uint32 _steps;
+    /** The number of physics steps between path points */
+    Uint32 _interval;
+
+    /** The worker thread */
+    std::thread _thread;
+    /** Protects the launch, the geometry and the statistics */
+    std::mutex _mutex;
+    /** Signals the worker (new launch or shutdown) */
+    std::condition_variable _signal;
+    /** Whether the worker should keep running */
+    bool _running;
+
+    /** The published paths (front, back and the one in between) */
+    Result _results[3];
+    /** The path being read by the scene */
+    int _front;
+    /** The path being written by the worker */
+    int _back;
+    /** The path in between, with NEW_RESULT set when it is unread */
+    std::atomic<int> _middle;
+
+    /** The last segment query that visited each segment (worker only) */
+    std::vector<Uint64> _stamps;
+    /** The number of segment queries (worker only) */
+    Uint64 _query;
+    /** The segments visited by the current query (worker only) */
+    std::vector<Uint32> _candidates;
+
+    /** The number of launches predicted */
+    Uint64 _predictions;
+    /** The number of launches replaced before the worker took them */
+    Uint64 _dropped;
+    /** The total time from post to publish in microseconds */
+    Uint64 _latencyTime;
+    /** The largest time from post to publish in microseconds */
+    Uint64 _latencyMax;
+    /** The total worker time spent predicting in microseconds */
+    Uint64 _computeTime;
+
+    /** Predicts posted launches until the predictor is disposed */
+    void run();
+
+    /**
+     * Predicts the path of the given launch
+     *
+     * @param geometry  The static level geometry
+     * @param launch    The launch to predict
+     * @param result    The result to store the path
+     */
+    void predict(const Geometry* geometry, const Launch& launch, Result& result);
+
+    /**
+     * Stores the segments that may touch the given box in the candidates
+     *
+     * @param geometry  The static level geometry
+     * @param min       The bottom left corner of the box
+     * @param max       The top right corner of the box
+     */
+    void gather(const Geometry* geometry, const cugl::Vec2 min, const cugl::Vec2 max);
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized predictor.
+     *
+     * This constructor does not start the worker.
+     */
+    TrajectoryPredictor();
+
+    /**
+     * Disposes of this predictor, abandoning any unfinished prediction.
+     */
+    ~TrajectoryPredictor() { dispose(); }
+
+    /**
+     * Disposes of this predictor, abandoning any unfinished prediction.
+     *
+     * The worker is joined before this method returns.
+     */
+    void dispose();
+
+    /**
+     * Initializes the predictor and starts its worker.
+     *
+     * A path is sampled every interval steps, so it has steps/interval points
+     * unless it stops early.
+     *
+     * @param steps     The number of physics steps to simulate
+     * @param interval  The number of physics steps between path points
+     *
+     * @return true if the predictor was initialized successfully
+     */
+    bool init(Uint32 steps, Uint32 interval);
+
+    /**
+     * Returns a newly allocated predictor with its worker started.
+     *
+     * @param steps     The number of physics steps to simulate
+     * @param interval  The number of physics steps between path points
+     *
+     * @return a newly allocated predictor with its worker started.
+     */
+    static std::shared_ptr<TrajectoryPredictor> alloc(Uint32 steps, Uint32 interval) {
+        std::shared_ptr<TrajectoryPredictor> result = std::make_shared<TrajectoryPredictor>();
+        return (result->init(steps,interval) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Geometry
+    /**
+     * Appends the outline of the given fixture as segments.
+     *
+     * The outline is in physics coordinates, using the current transform of
+     * the fixture body. Circles are approximated by polygons.
+     *
+     * @param segments  The vector to store the segments
+     * @param fixture   The fixture to outline
+     * @param surface   The surface of the fixture
+     */
+    static void appendFixture(std::vector<Segment>& segments, const b2Fixture* fixture, const Surface& surface);
+
+    /**
+     * Sets the static geometry of the level.
+     *
+     * The geometry is copied and bucketed in a grid on the calling thread.
+     * Launches posted before this call may still finish with the previous
+     * geometry.
+     *
+     * @param segments  The segments of the level
+     */
+    void setGeometry(const std::vector<Segment>& segments);
+
+#pragma mark -
+#pragma mark Prediction
+    /**
+     * Posts a launch for the worker to predict.
+     *
+     * Only the newest launch is kept, so a launch that the worker has not
+     * started yet is replaced.
+     *
+     * @param launch    The launch to predict
+     *
+     * @return the serial number of the launch
+     */
+    Uint64 post(const Launch& launch);
+
+    /**
+     * Picks up the newest published path, if there is one.
+     *
+     * A path predicted for a launch posted before the given serial number is
+     * stale (such as one left over from an earlier drag), and it is dropped.
+     * This method never blocks. If it returns false, {@link getResult} is
+     * unchanged. It must only be called from one thread.
+     *
+     * @param oldest    The serial number of the oldest launch to accept
+     *
+     * @return true if a new path was picked up
+     */
+    bool acquire(Uint64 oldest=0);
+
+    /**
+     * Returns the path picked up by the last call to {@link acquire}.
+     *
+     * @return the path picked up by the last call to {@link acquire}.
+     */
+    const Result& getResult() const { return _results[_front]; }
+
+    /**
+     * Returns a summary of the prediction statistics for logging.
+     *
+     * @return a summary of the prediction statistics for logging.
+     */
+    std::string toString();
+};
+
+#endif /* TrajectoryPredictor_h */
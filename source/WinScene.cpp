@@ -51,7 +51,7 @@ bool WinScene::init(const std::shared_ptr<AssetManager>& assets) {
     addChild(bkgNode);
     auto layer = assets->get<scene2::SceneNode>("winscreen");
     layer->setContentSize(1200, 700);
-    layer->doLayout(); // This rearranges the children to fit the screen
+    layer->updateLayout(); // This rearranges the children to fit the screen
     layer->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
     layer->setPosition(0, 0);
     _wrapperNode->addChild(layer);